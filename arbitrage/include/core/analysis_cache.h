@@ -0,0 +1,101 @@
+#pragma once
+
+#include "stock_data.h"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Identifies one pair analysis: both legs' symbols and data, and the settings
+// the result depends on. A leg whose bars change gets a new content hash, so
+// stale entries are never matched.
+struct AnalysisCacheKey {
+    uint64_t symbol1;       // AnalysisCache::symbolId of each leg, in order
+    uint64_t symbol2;
+    uint64_t content;       // both legs' StockData::content_hash
+    uint64_t parameters;    // caller's hash of the analysis settings
+    
+    bool operator==(const AnalysisCacheKey& other) const {
+        return symbol1 == other.symbol1 && symbol2 == other.symbol2 &&
+               content == other.content && parameters == other.parameters;
+    }
+    bool operator<(const AnalysisCacheKey& other) const {
+        if (symbol1 != other.symbol1) return symbol1 < other.symbol1;
+        if (symbol2 != other.symbol2) return symbol2 < other.symbol2;
+        if (content != other.content) return content < other.content;
+        return parameters < other.parameters;
+    }
+};
+
+// Pair results kept across runs, keyed by AnalysisCacheKey. Entries loaded
+// from disk stay in the mapped file as sorted records and are found by
+// binary search without taking a lock; entries added during the run go to
+// one of kShards hash tables, each behind its own reader-writer lock, so
+// parallel workers only contend when they hit the same shard. Symbols and
+// sectors are not stored: a hit takes them from the stocks it is asked about.
+//
+// Lookups and stores are thread-safe; loadCacheFromFile, clearCache and
+// saveCacheToFile must not run concurrently with them.
+class AnalysisCache {
+public:
+    static constexpr size_t kShards = 64;
+    
+    static uint64_t symbolId(const std::string& symbol);
+    static AnalysisCacheKey makeKey(const StockData& stock1, const StockData& stock2, uint64_t parameters);
+    // Stable hash of a list of settings, for the parameters part of a key
+    static uint64_t hashParameters(const std::vector<double>& values);
+    
+    // Cache cointegration results
+    static void cacheCointegrationResult(
+        const StockData& stock1,
+        const StockData& stock2,
+        uint64_t parameters,
+        const CointegrationResult& result
+    );
+    
+    static bool getCachedCointegrationResult(
+        const StockData& stock1,
+        const StockData& stock2,
+        uint64_t parameters,
+        CointegrationResult& result
+    );
+    
+    // Cache correlation results
+    static void cacheCorrelationResult(
+        const StockData& stock1,
+        const StockData& stock2,
+        uint64_t parameters,
+        const CorrelationResult& result
+    );
+    
+    static bool getCachedCorrelationResult(
+        const StockData& stock1,
+        const StockData& stock2,
+        uint64_t parameters,
+        CorrelationResult& result
+    );
+    
+    // Cache management
+    static void clearCache();
+    static size_t getCacheSize();
+    // Loaded and new entries, sorted, in one file written to a temporary
+    // name and renamed into place; throws std::runtime_error on failure
+    static void saveCacheToFile(const std::string& cache_file);
+    // Maps the file in place of the current loaded entries. A missing file
+    // leaves the cache empty; a malformed one or one of another version is
+    // ignored, so a format change only costs one recomputation.
+    static void loadCacheFromFile(const std::string& cache_file);
+    
+    // Cache statistics
+    struct CacheStats {
+        size_t cointegration_cache_hits = 0;
+        size_t cointegration_cache_misses = 0;
+        size_t correlation_cache_hits = 0;
+        size_t correlation_cache_misses = 0;
+        double cache_hit_rate = 0.0;
+        size_t memory_used_mb = 0;
+        size_t entries_loaded = 0;      // records mapped from the cache file
+    };
+    
+    static CacheStats getCacheStats();
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "analysis_cache.h"
+#include <cstdint>
+
+// Analysis cache file (.mfta), version 1, host (little-endian) byte order.
+//
+//   offset 0                    AnalysisCacheHeader (64 bytes)
+//   cointegration_offset        cointegration_count CachedCointegration records
+//   correlation_offset          correlation_count CachedCorrelation records
+//
+// Each section is sorted by key, so a mapped file is searched in place.
+// The record sizes are stored too: a build whose layout differs rejects the
+// file instead of misreading it.
+constexpr char kAnalysisCacheMagic[8] = {'M', 'F', 'T', 'C', 'A', 'C', 'H', '\0'};
+constexpr uint32_t kAnalysisCacheVersion = 1;
+constexpr const char* kAnalysisCacheExtension = ".mfta";
+
+struct AnalysisCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint16_t cointegration_record_size;
+    uint16_t correlation_record_size;
+    uint64_t cointegration_count;
+    uint64_t cointegration_offset;
+    uint64_t correlation_count;
+    uint64_t correlation_offset;
+    uint8_t reserved[16];
+};
+static_assert(sizeof(AnalysisCacheHeader) == 64, "AnalysisCacheHeader layout is part of the file format");
+
+// CointegrationResult without its symbols
+struct CachedCointegration {
+    AnalysisCacheKey key;
+    double adf_statistic;
+    double p_value;
+    double critical_value_1pct;
+    double critical_value_5pct;
+    double critical_value_10pct;
+    double half_life;
+    double hedge_ratio;
+    double spread_mean;
+    double spread_std;
+    double max_spread;
+    double min_spread;
+    double current_spread;
+    double z_score;
+    double entry_threshold;
+    double exit_threshold;
+    double expected_return;
+    double sharpe_ratio;
+    double win_rate;
+    int32_t num_trades_historical;
+    uint32_t is_cointegrated;
+    char grade[8];          // NUL-padded
+};
+static_assert(sizeof(CachedCointegration) == 192, "CachedCointegration layout is part of the file format");
+
+// CorrelationResult without its symbols and sectors
+struct CachedCorrelation {
+    AnalysisCacheKey key;
+    double pearson_correlation;
+    double spearman_correlation;
+    double kendall_tau;
+    double rolling_correlation_30d;
+    double rolling_correlation_60d;
+    double correlation_stability;
+    double correlation_breakdown_count;
+    double min_correlation;
+    double max_correlation;
+    double price1;
+    double price2;
+    uint32_t same_sector;
+    uint32_t affordable_pair;
+    char grade[8];          // NUL-padded
+};
+static_assert(sizeof(CachedCorrelation) == 136, "CachedCorrelation layout is part of the file format");
+
+// Result fields <-> record payload; the key, symbols and sectors are left to
+// the caller
+void toRecord(const CointegrationResult& result, CachedCointegration& record);
+void fromRecord(const CachedCointegration& record, CointegrationResult& result);
+void toRecord(const CorrelationResult& result, CachedCorrelation& record);
+void fromRecord(const CachedCorrelation& record, CorrelationResult& result);
@@ -2,7 +2,14 @@
 
 #include "stock_data.h"
 #include "fast_csv_loader.h"
+#include "trading_calendar.h"
+#include "pair_universe.h"
+#include "analysis_cache.h"
+#include "incremental_state.h"
+#include "shard_results.h"
 #include "../statistics/simd_statistics.h"
+#include "../statistics/bootstrap_cointegration.h"
+#include "../statistics/pairs_backtest.h"
 #include "../export/excel_exporter.h"
 #include <vector>
 #include <memory>
@@ -12,6 +19,7 @@
 #include <mutex>
 #include <functional>
 #include <chrono>
+#include <deque>
 
 // Main arbitrage analysis engine
 class ArbitrageAnalyzer {
@@ -30,20 +38,117 @@ public:
         double max_cointegration_pvalue = 0.05;
         int min_data_points = 100;
         bool require_same_sector = false;
+        // Spearman and Kendall for every pair past min_correlation_threshold,
+        // from per-stock return ranks computed at load
+        bool rank_correlations = true;
+        
+        // Pre-screen: a pair reaches the ADF test only if its return
+        // correlation is at least the minimum and its hedge regression's
+        // spread variance, as a share of the price variance, is at most the
+        // maximum; both come from blocked correlation matrices
+        bool enable_prescreen = true;
+        double prescreen_min_return_correlation = 0.3;
+        double prescreen_max_spread_variance_ratio = 0.5;
+        
+        // Empirical p-values: the pairs that pass are retested against
+        // resampled null distributions of the ADF statistic instead of the
+        // fixed critical values, and dropped if no longer significant. Costs
+        // bootstrap_replicates ADF tests per surviving pair.
+        bool empirical_pvalues = false;
+        BootstrapCointegrationEngine::Method pvalue_method = BootstrapCointegrationEngine::Method::BlockBootstrap;
+        int bootstrap_replicates = 2000;
+        
+        // Threshold-rule grid search: every exported cointegrated pair is
+        // backtested under each rule of backtest_grid in one pass over its
+        // spread, and each rule's trades pooled over the pairs are written
+        // to <output_directory>backtest_grid.csv; unsharded runs only
+        bool backtest = false;
+        PairsBacktestEngine::Grid backtest_grid;
+        
+        // Pair stocks with different histories (listings, delistings, missing
+        // bars) on the bars both hold, via one master trading calendar; off,
+        // only equal-length stocks pair, bar by bar
+        bool align_calendar = true;
+        
+        // Clustered pair universe: only pairs inside a cluster of co-moving
+        // stocks or between neighbouring clusters are screened and tested
+        // (see PairUniverse), which is what keeps runs of thousands of
+        // stocks from enumerating every pair. The clusters are rebuilt each
+        // run, so an incremental run sees a pair that joins the universe
+        // between unchanged stocks at its next full screen.
+        bool cluster_universe = false;
+        PairUniverse::Options universe;
+        
+        // Incremental re-analysis: each run keeps per-stock fingerprints and
+        // the screen's running moments for every pair within the watch
+        // margin of the pre-screen bounds, so a run on appended bars extends
+        // only those pairs (and rescreens the pairs of new or rewritten
+        // stocks) before the ADF test. Every pair is rescreened once a
+        // stock's appended bars pass the refresh fraction of the history it
+        // was last screened on. Screens even with enable_prescreen off.
+        bool incremental = false;
+        std::string state_file;                     // empty = <output_directory>incremental_state.mfts
+        double incremental_watch_margin = 0.1;      // correlation below the screen bounds
+        double incremental_refresh_fraction = 0.05;
+        
+        // Sharded run, one shard per node: shard shard_index of shard_count
+        // tests its share of the pairs and writes its results to shard_file
+        // instead of exporting; mergeShards() ranks and exports the union.
+        // The correlation screens split by Gram tile, so each shard computes
+        // only its share of the product; an unscreened run takes a balanced
+        // slice in (i, j) order over the sorted stock list, and an
+        // incremental one slices the pairs that pass its screen.
+        unsigned int shard_index = 0;
+        unsigned int shard_count = 1;
+        std::string shard_file;     // empty = <output_directory>shard_<index>_of_<count>.mfsr
         
         // Performance settings
-        unsigned int num_threads = 0; // 0 = auto-detect
+        unsigned int num_threads = 0; // 0 = the machine profile's, else every hardware thread
+        // Machine profile of this host (autotune_machine(), --autotune),
+        // applied at startup: SIMD tier, threads and pair tile edge.
+        // Empty = MachineProfile::default_path(); "off" = built-in defaults
+        std::string machine_profile;
         bool enable_simd = true;
+        // Correlation screens on the CUDA device when the build and host
+        // have one (see GpuCorrelation); the CPU kernels otherwise
+        bool enable_gpu = true;
+        // On multi-socket hosts, pin pool and loader threads to NUMA nodes
+        // so each stock's data is first touched on the node that parses it;
+        // numa_replicate_returns also gives every node its own copy of the
+        // packed series the correlation screens read
+        bool numa_placement = true;
+        bool numa_replicate_returns = false;
+        // Cycles, instructions, cache and branch misses and vector
+        // instructions per stage and kernel (perf_event, Linux only)
+        bool hardware_counters = false;
+        // Chrome trace JSON of the run's stage, task and lock-wait spans
+        // (chrome://tracing, ui.perfetto.dev); empty = tracing off
+        std::string trace_file;
         bool enable_caching = true;
+        // Pair results reused across runs while both legs' data and the
+        // analysis settings are unchanged; empty = <output_directory>analysis_cache.mfta
+        std::string cache_file;
+        // Parsed stocks reused across runs while their feature files are
+        // unchanged (see StockSnapshot); empty = <output_directory>stock_snapshot.mfss
+        bool use_snapshot = true;
+        std::string snapshot_file;
         
         // Output settings
         bool export_excel = true;
         bool export_csv = true;
         bool export_json = false;
         std::string output_filename = "statistical_arbitrage_opportunities";
+        // Return correlation of every pair and cointegration p-value of every
+        // cointegrated pair as one tiled .mftm matrix for the pairs
+        // visualizer's heatmap; unsharded runs only
+        bool export_matrix = false;
+        std::string matrix_file;    // empty = <output_directory>pair_matrix.mftm
         
         // Analysis scope
         int max_pairs_to_analyze = 0; // 0 = analyze all pairs
+        // Best-scoring opportunities kept, highest combined score first. Every
+        // matched pair by default, so the portfolio step sees all alternatives
+        int max_opportunities = 0; // 0 = keep every matched pair
         std::vector<std::string> focus_sectors; // empty = all sectors
         std::vector<std::string> excluded_symbols;
     };
@@ -52,21 +157,44 @@ public:
     static bool runFullAnalysis(const AnalysisConfig& config);
     static bool runFullAnalysis(); // Overload with default config
     
+    // Combines the partial results of every shard of one sharded run into
+    // the exports of an unsharded run: one global ranking and one set of
+    // opportunities. Fails if a file cannot be read or the files are not
+    // each shard exactly once.
+    static bool mergeShards(const std::vector<std::string>& shard_files, const AnalysisConfig& config);
+    
     // Individual analysis components
     static std::vector<std::unique_ptr<StockData>> loadStockData(
         const AnalysisConfig& config
     );
     
+    // With config.align_calendar set and no calendar given, each call
+    // builds its own from `stocks`; likewise the universe with
+    // config.cluster_universe
     static std::vector<CointegrationResult> analyzeCointegration(
         const std::vector<std::unique_ptr<StockData>>& stocks,
-        const AnalysisConfig& config
+        const AnalysisConfig& config,
+        const TradingCalendar* calendar = nullptr,
+        const PairUniverse* universe = nullptr
     );
     
     static std::vector<CorrelationResult> analyzeCorrelation(
         const std::vector<std::unique_ptr<StockData>>& stocks,
-        const AnalysisConfig& config
+        const AnalysisConfig& config,
+        const TradingCalendar* calendar = nullptr,
+        const PairUniverse* universe = nullptr
     );
     
+    // The config.universe clusters of the stocks that pass the per-stock
+    // checks, with the universe metrics filled in
+    static PairUniverse clusterUniverse(
+        const std::vector<std::unique_ptr<StockData>>& stocks,
+        const AnalysisConfig& config,
+        const TradingCalendar* calendar
+    );
+    
+    // Joins the two result lists on their pair and keeps the
+    // max_opportunities best by combined score (ties by symbol)
     static std::vector<ArbitrageOpportunity> generateOpportunities(
         const std::vector<CointegrationResult>& cointegration_results,
         const std::vector<CorrelationResult>& correlation_results,
@@ -80,12 +208,24 @@ public:
         const AnalysisConfig& config
     );
     
+    // Writes the config.export_matrix matrix: the blocked correlation
+    // product streamed into the file's tiles (unequal histories correlated
+    // on their common bars when a calendar is given), then the p-values of
+    // `cointegration_results`
+    static bool exportMatrix(
+        const std::vector<std::unique_ptr<StockData>>& stocks,
+        const std::vector<CointegrationResult>& cointegration_results,
+        const AnalysisConfig& config,
+        const TradingCalendar* calendar
+    );
+    
     // Performance and progress tracking
     struct AnalysisMetrics {
         // Data loading metrics
         size_t stocks_loaded = 0;
         size_t stocks_filtered = 0;
         double loading_time_seconds = 0.0;
+        size_t stocks_from_snapshot = 0;        // copied from the stock snapshot, not parsed
         
         // Analysis metrics
         size_t total_pairs_analyzed = 0;
@@ -94,6 +234,41 @@ public:
         size_t arbitrage_opportunities_found = 0;
         double analysis_time_seconds = 0.0;
         
+        // Pre-screen metrics
+        size_t pairs_screened = 0;          // valid pairs entering the screen
+        size_t pairs_passed_screen = 0;     // pairs handed to the ADF test
+        double prescreen_prune_ratio = 0.0; // share of screened pairs dropped
+        double prescreen_time_seconds = 0.0;
+        
+        // Empirical p-value metrics
+        size_t pairs_resampled = 0;         // surviving pairs retested
+        size_t pairs_dropped_by_resampling = 0;
+        double resampling_time_seconds = 0.0;
+        
+        // Backtest grid metrics
+        size_t backtest_rules = 0;
+        size_t backtest_pairs = 0;          // pairs with a spread to trade
+        double backtest_time_seconds = 0.0;
+        std::string backtest_file;
+        
+        // Calendar metrics
+        size_t calendar_bars = 0;           // bars of the master calendar
+        size_t aligned_pairs = 0;           // pairs analyzed on common bars
+        
+        // Clustered universe metrics
+        size_t universe_clusters = 0;
+        size_t universe_largest_cluster = 0;
+        size_t universe_pairs = 0;          // pairs within a cluster or between neighbours
+        size_t universe_full_pairs = 0;     // pairs of the same stocks under full enumeration
+        double universe_coverage = 0.0;     // universe_pairs / universe_full_pairs
+        double universe_time_seconds = 0.0;
+        
+        // Incremental metrics
+        bool incremental_full_screen = false;   // every pair was rescreened
+        size_t incremental_stocks_changed = 0;  // stocks new or rewritten since the last run
+        size_t incremental_pairs_updated = 0;   // watched pairs extended with appended bars
+        size_t incremental_pairs_watched = 0;   // pairs kept in the state for the next run
+        
         // Performance metrics
         double pairs_per_second = 0.0;
         double gflops_achieved = 0.0;
@@ -102,6 +277,9 @@ public:
         // Export metrics
         double export_time_seconds = 0.0;
         bool export_successful = false;
+        std::string shard_file;             // partial results written by a shard
+        std::string matrix_file;            // tiled pair matrix written by the run
+        std::string trace_file;             // Chrome trace written by the run
         
         // Overall metrics
         double total_time_seconds = 0.0;
@@ -118,7 +296,9 @@ private:
     // Parallel analysis coordination
     static std::vector<CointegrationResult> analyzeCointegrationParallel(
         const std::vector<std::unique_ptr<StockData>>& stocks,
-        const AnalysisConfig& config
+        const AnalysisConfig& config,
+        const TradingCalendar* calendar,
+        const PairUniverse* universe
     );
     
     static std::vector<CorrelationResult> analyzeCorrelationParallel(
@@ -145,6 +325,113 @@ private:
         const AnalysisConfig& config
     );
     
+    // Both legs of each result, looked up by symbol and cut to their common
+    // bars when the calendar says they need it (the cut legs live in
+    // `aligned_legs`); null legs for symbols not in `stocks`
+    static std::vector<std::pair<const StockData*, const StockData*>> resultLegs(
+        const std::vector<std::unique_ptr<StockData>>& stocks,
+        const std::vector<CointegrationResult>& results,
+        const TradingCalendar* calendar,
+        std::deque<StockData>& aligned_legs
+    );
+    
+    // Runs config.backtest_grid over `results` and writes the pooled
+    // metrics of each rule
+    static bool backtestGrid(
+        const std::vector<std::unique_ptr<StockData>>& stocks,
+        const std::vector<CointegrationResult>& results,
+        const AnalysisConfig& config,
+        const TradingCalendar* calendar
+    );
+    
+    // Retests `results` with empirical p-values (config.empirical_pvalues)
+    // and keeps those still meeting the criteria
+    static std::vector<CointegrationResult> resamplePValues(
+        const std::vector<std::unique_ptr<StockData>>& stocks,
+        const AnalysisConfig& config,
+        const TradingCalendar* calendar,
+        std::vector<CointegrationResult> results
+    );
+    
+    // Valid pairs of a stock list and the max_pairs_to_analyze prefix of
+    // them, or this shard's slice of that prefix
+    struct PairScope {
+        std::vector<unsigned char> eligible;    // eligibleStocks()
+        const PairUniverse* universe = nullptr; // pairs outside it are not valid
+        size_t total = 0;                       // valid pairs in scope
+        size_t first_i = 0;                     // first pair in scope
+        size_t first_j = 0;
+        size_t last_i = 0;                      // last pair still in scope
+        size_t last_j = 0;
+        bool inScope(size_t i, size_t j) const {
+            return (i > first_i || (i == first_i && j >= first_j)) &&
+                   (i < last_i || (i == last_i && j <= last_j));
+        }
+    };
+    static PairScope pairScope(
+        const std::vector<std::unique_ptr<StockData>>& stocks,
+        const AnalysisConfig& config,
+        const TradingCalendar* calendar,
+        const PairUniverse* universe,
+        bool sharded
+    );
+    
+    // ADF test, through the result cache, of the pairs each task passes to
+    // its sink; returns the cointegrated ones that meet the criteria
+    using PairSink = std::function<void(size_t i, size_t j)>;
+    using PairTask = std::function<void(size_t task, const PairSink& add_pair)>;
+    static std::vector<CointegrationResult> testPairs(
+        const std::vector<std::unique_ptr<StockData>>& stocks,
+        const AnalysisConfig& config,
+        const TradingCalendar* calendar,
+        unsigned int num_threads,
+        const std::vector<size_t>& costs,
+        const PairTask& enumerate
+    );
+    
+    // Pairs (i, j), i < j, accepted by include_pair that pass the pre-screen
+    // bounds of `config`, in (i, j) order. With a universe, the correlation
+    // passes compute only its pairs; include_pair must not accept others
+    static std::vector<std::pair<size_t, size_t>> prescreenPairs(
+        const std::vector<std::unique_ptr<StockData>>& stocks,
+        const AnalysisConfig& config,
+        const TradingCalendar* calendar,
+        unsigned int num_threads,
+        const PairUniverse* universe,
+        const SIMDCorrelationAnalyzer::PairFilter& include_pair
+    );
+    
+    // Pairs (i, j), i < j, accepted by include_pair that need calendar
+    // alignment and pass `test` on their common bars' closes and returns, in
+    // (i, j) order with the score `test` set. The blocked correlation passes
+    // cover stocks on the same bars; these go pairwise, in parallel tiles,
+    // through per-worker scratch.
+    using AlignedPairTest = std::function<bool(const CommonBarSeries& legs, double& score)>;
+    static std::vector<SIMDCorrelationAnalyzer::PairCorrelation> scanAlignedPairs(
+        const std::vector<std::unique_ptr<StockData>>& stocks,
+        const TradingCalendar& calendar,
+        unsigned int num_threads,
+        const SIMDCorrelationAnalyzer::PairFilter& include_pair,
+        const AlignedPairTest& test
+    );
+    
+    // The pre-screen of config.incremental: pairs in `scope` that pass the
+    // bounds on their running moments, in (i, j) order; loads the previous
+    // state and saves the next one
+    static std::vector<std::pair<size_t, size_t>> screenIncremental(
+        const std::vector<std::unique_ptr<StockData>>& stocks,
+        const AnalysisConfig& config,
+        const TradingCalendar* calendar,
+        unsigned int num_threads,
+        const PairScope& scope
+    );
+    
+    // Per-stock checks of isValidPair, one flag per stock
+    static std::vector<unsigned char> eligibleStocks(
+        const std::vector<std::unique_ptr<StockData>>& stocks,
+        const AnalysisConfig& config
+    );
+    
     // Opportunity scoring and ranking
     static double calculateCombinedScore(
         const CointegrationResult& coint_result,
@@ -178,66 +465,6 @@ private:
     static std::atomic<size_t> total_pairs_;
 };
 
-// Intelligent caching system for analysis results
-class AnalysisCache {
-public:
-    // Cache cointegration results
-    static void cacheCointegrationResult(
-        const std::string& symbol1,
-        const std::string& symbol2,
-        const CointegrationResult& result
-    );
-    
-    static bool getCachedCointegrationResult(
-        const std::string& symbol1,
-        const std::string& symbol2,
-        CointegrationResult& result
-    );
-    
-    // Cache correlation results
-    static void cacheCorrelationResult(
-        const std::string& symbol1,
-        const std::string& symbol2,
-        const CorrelationResult& result
-    );
-    
-    static bool getCachedCorrelationResult(
-        const std::string& symbol1,
-        const std::string& symbol2,
-        CorrelationResult& result
-    );
-    
-    // Cache management
-    static void clearCache();
-    static size_t getCacheSize();
-    static void saveCacheToFile(const std::string& cache_file);
-    static void loadCacheFromFile(const std::string& cache_file);
-    
-    // Cache statistics
-    struct CacheStats {
-        size_t cointegration_cache_hits = 0;
-        size_t cointegration_cache_misses = 0;
-        size_t correlation_cache_hits = 0;
-        size_t correlation_cache_misses = 0;
-        double cache_hit_rate = 0.0;
-        size_t memory_used_mb = 0;
-    };
-    
-    static CacheStats getCacheStats() { return cache_stats_; }
-
-private:
-    // Cache storage
-    static std::unordered_map<std::string, CointegrationResult> cointegration_cache_;
-    static std::unordered_map<std::string, CorrelationResult> correlation_cache_;
-    
-    // Cache key generation
-    static std::string makePairKey(const std::string& symbol1, const std::string& symbol2);
-    
-    // Cache statistics
-    static CacheStats cache_stats_;
-    static std::mutex cache_mutex_;
-};
-
 // Configuration management
 class ConfigManager {
 public:
@@ -274,6 +501,10 @@ public:
     // Parse command-line arguments
     static ArbitrageAnalyzer::AnalysisConfig parseCommandLine(int argc, char* argv[]);
     
+    // Shard files of `arbitrage_analyzer merge FILE... [OPTIONS]`: the
+    // arguments after the subcommand that are neither options nor values
+    static std::vector<std::string> parseMergeFiles(int argc, char* argv[]);
+    
     // Print usage information
     static void printUsage();
     
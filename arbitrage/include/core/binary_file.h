@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include "mapped_file.h"
+
+// The binary files kept between runs (analysis cache, stock snapshot,
+// incremental state, shard results) share one frame: a header that starts
+// with an 8-byte magic and a uint32 version, written to path + ".tmp" and
+// renamed over the old file only once complete.
+
+template <class Header>
+void stampHeader(Header& header, const char (&magic)[8], uint32_t version) {
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+}
+
+template <class Header>
+bool headerMatches(const Header& header, const char (&magic)[8], uint32_t version) {
+    return std::memcmp(header.magic, magic, sizeof(magic)) == 0 && header.version == version;
+}
+
+// Writes a file under a temporary name; commit() renames it into place, so
+// readers see the old file or the whole new one (a mapped copy of the old
+// file stays readable after the rename). Throws std::runtime_error naming
+// `what` on failure; an uncommitted file is left at the temporary path.
+class AtomicFileWriter {
+public:
+    AtomicFileWriter(const std::string& path, const char* what);
+
+    void write(const void* data, size_t bytes) {
+        file_.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        written_ += bytes;
+    }
+    // Zeros up to the next multiple of `alignment` bytes
+    void pad(size_t alignment);
+    uint64_t written() const { return written_; }
+
+    void commit();
+
+private:
+    std::string path_;
+    std::string temporary_;
+    const char* what_;
+    std::ofstream file_;
+    uint64_t written_ = 0;
+};
+
+// Sequential reader of a whole file whose header has been checked
+class BinaryFileReader {
+public:
+    // False if the file is missing, shorter than the header or its magic or
+    // version differ
+    template <class Header>
+    bool open(const std::string& path, Header& header, const char (&magic)[8], uint32_t version) {
+        if (!openFile(path)) return false;
+        return read(&header, sizeof(header)) && headerMatches(header, magic, version);
+    }
+
+    bool read(void* data, size_t bytes) {
+        return static_cast<bool>(file_.read(static_cast<char*>(data), static_cast<std::streamsize>(bytes)));
+    }
+    // Whole file, for checking the header's counts before allocating
+    uint64_t size() const { return size_; }
+
+private:
+    bool openFile(const std::string& path);
+
+    std::ifstream file_;
+    uint64_t size_ = 0;
+};
+
+// `path` mapped when it is a regular file of at least min_size bytes; null
+// if it is missing, unreadable or shorter
+std::unique_ptr<MappedFile> mapFileAtLeast(const std::string& path, size_t min_size);
+
+// The same for a file that starts with a Header of this magic and version
+
+template <class Header>
+std::unique_ptr<MappedFile> mapBinaryFile(const std::string& path, const char (&magic)[8], uint32_t version) {
+    auto file = mapFileAtLeast(path, sizeof(Header));
+    if (file && !headerMatches(*reinterpret_cast<const Header*>(file->data()), magic, version)) file.reset();
+    return file;
+}
@@ -13,18 +13,30 @@
 
 class FastCSVLoader {
 public:
-    // Load all stock CSV files from a directory in parallel
+    // Load all stock CSV files from a directory in parallel. With a
+    // snapshot_file, stocks whose files are unchanged since it was written
+    // are copied out of that StockSnapshot instead of parsed, and the
+    // snapshot is rewritten when any file had to be parsed.
     static std::vector<std::unique_ptr<StockData>> loadAllStocks(
         const std::string& data_directory,
-        const PortfolioConstraints& constraints = PortfolioConstraints{}
+        const PortfolioConstraints& constraints = PortfolioConstraints{},
+        const std::string& snapshot_file = ""
     );
     
     // Load a single stock CSV file using memory-mapped I/O
+    // (.mftc columnar files are read in place instead of parsed)
     static std::unique_ptr<StockData> loadSingleStock(
         const std::string& csv_path
     );
     
-    // Get list of all CSV files in directory
+    // Parse a feature CSV already read into memory; the symbol comes from
+    // csv_path as in loadSingleStock
+    static std::unique_ptr<StockData> parseStock(
+        const std::string& csv_path, const char* data, size_t size
+    );
+    
+    // Get list of all feature files in directory; a .csv is skipped when a
+    // .mftc file for the same stock sits next to it
     static std::vector<std::string> getCSVFiles(const std::string& directory);
     
     // Performance metrics
@@ -35,6 +47,8 @@ public:
         double files_per_second = 0.0;
         size_t total_data_points = 0;
         size_t memory_used_mb = 0;
+        size_t snapshot_hits = 0;   // stocks reused from the snapshot
+        size_t files_parsed = 0;
     };
     
     static LoadingMetrics getLastLoadingMetrics() { return last_metrics_; }
@@ -65,6 +79,16 @@ private:
         int fd_ = -1;
     };
     
+    // Every file as a StockData, from the snapshot where the file is
+    // unchanged and parsed otherwise; failed files are dropped
+    static std::vector<std::unique_ptr<StockData>> loadWithSnapshot(
+        const std::vector<std::string>& files,
+        const std::string& snapshot_file
+    );
+    
+    // Copy OHLCV columns out of a mapped .mftc feature file
+    static std::unique_ptr<StockData> loadColumnarStock(const std::string& path);
+    
     // Parse timestamp from string
     static std::chrono::system_clock::time_point parseTimestamp(
         const char* timestamp_str, const char** endptr
@@ -107,6 +131,12 @@ public:
         unsigned int num_threads = 0  // 0 = auto-detect
     );
     
+    // One result per file, in file order; nullptr where a file failed
+    static std::vector<std::unique_ptr<StockData>> loadIndexed(
+        const std::vector<std::string>& files,
+        unsigned int num_threads = 0  // 0 = auto-detect
+    );
+    
 private:
     struct LoadingTask {
         std::vector<std::string> files;
@@ -144,19 +174,30 @@ enum class CSVColumn {
 // Fast CSV parser optimized for your specific format
 class OptimizedCSVParser {
 public:
-    // Parse your specific CSV format efficiently
+    // Parse your specific CSV format efficiently. The datetime and OHLCV
+    // columns are resolved by name from the header once; each line then
+    // locates only the delimiters up to the last of them with SIMD scans,
+    // so the wide feature columns are skipped without being parsed.
     static std::unique_ptr<StockData> parseFeatureCSV(
         const char* csv_data, size_t data_size,
         const std::string& symbol
     );
     
 private:
-    // Skip to specific column in CSV line
-    static const char* skipToColumn(const char* line_start, int column_index);
+    // Column indices of the fields the arbitrage stage reads
+    struct ColumnProjection {
+        int datetime = 0;
+        int open = 1;
+        int high = 2;
+        int low = 3;
+        int close = 4;
+        int volume = 5;
+        int last_column = 5;    // highest of the above
+    };
     
-    // Parse CSV header to get column indices
-    static std::unordered_map<std::string, int> parseHeader(const char* header_line);
+    // Projection for a parsed header; unnamed columns fall back to CSVColumn
+    static ColumnProjection resolveProjection(const std::unordered_map<std::string, int>& header);
     
-    // Fast line counting for memory pre-allocation
-    static size_t countLines(const char* data, size_t size);
+    // Parse CSV header to get column indices (lower-cased names)
+    static std::unordered_map<std::string, int> parseHeader(const char* header_start, const char* header_end);
 };
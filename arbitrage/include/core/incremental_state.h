@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Running co-moments of two series (Welford), so a pair's correlation can be
+// extended bar by bar
+struct PairMoments {
+    double count = 0.0;
+    double mean1 = 0.0;
+    double mean2 = 0.0;
+    double m2_1 = 0.0;      // sums of squared deviations
+    double m2_2 = 0.0;
+    double c12 = 0.0;       // sum of cross deviations
+    
+    void add(double value1, double value2) {
+        count += 1.0;
+        const double d1 = value1 - mean1;
+        const double d2 = value2 - mean2;
+        mean1 += d1 / count;
+        mean2 += d2 / count;
+        m2_1 += d1 * (value1 - mean1);
+        m2_2 += d2 * (value2 - mean2);
+        c12 += d1 * (value2 - mean2);
+    }
+    
+    // 0 when either series is constant
+    double correlation() const;
+};
+
+// What the last run saw of one stock
+struct StockFingerprint {
+    uint64_t symbol_id;         // AnalysisCache::symbolId
+    uint64_t bars;
+    uint64_t content_hash;      // StockData::contentHash over those bars
+    uint64_t bars_at_screen;    // bars when the stock was last fully screened
+};
+
+// A pair on the watch list: its screening correlations as running moments
+// over its common bars, extendable with bars appended since
+struct PairState {
+    uint64_t symbol1;
+    uint64_t symbol2;
+    uint64_t common_bars;
+    int64_t last_timestamp;     // ticks of the last common bar; unused for positional pairs
+    uint32_t on_calendar;       // 1 if common bars come from the master calendar, 0 if by position
+    uint32_t passed;            // 1 if the pair passed the screen at its last update
+    double last_close1;         // closes at that bar, for the next return
+    double last_close2;
+    PairMoments returns;
+    PairMoments closes;
+};
+
+// State kept between incremental runs in one binary file (.mfts, version 1):
+// a 64-byte header, then the stock fingerprints, then the pair states, all
+// fixed-size host-order records
+class IncrementalState {
+public:
+    std::vector<StockFingerprint> stocks;
+    std::vector<PairState> pairs;
+    
+    // False, leaving the state empty, when the file is missing, malformed
+    // or of another version
+    bool load(const std::string& path);
+    // Writes a temporary file and renames it into place; throws
+    // std::runtime_error on failure
+    void save(const std::string& path) const;
+    
+    // Lookups over the loaded records; nullptr when absent
+    const StockFingerprint* findStock(uint64_t symbol_id) const;
+    const PairState* findPair(uint64_t symbol1, uint64_t symbol2) const;
+    
+private:
+    void index();
+    
+    struct PairIdHash {
+        size_t operator()(const std::pair<uint64_t, uint64_t>& id) const {
+            return static_cast<size_t>(id.first * 0x9e3779b97f4a7c15ULL ^ id.second);
+        }
+    };
+    std::unordered_map<uint64_t, size_t> stock_index_;
+    std::unordered_map<std::pair<uint64_t, uint64_t>, size_t, PairIdHash> pair_index_;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "stock_data.h"
+#include "trading_calendar.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// Partition of the stocks into clusters of co-moving stocks, built once per
+// analysis, so a run tests only the pairs inside a cluster or between a
+// cluster and its nearest clusters: roughly the sum of the squared cluster
+// sizes instead of N^2 / 2 pairs.
+//
+// Each stock is described by its last `window` returns, centered and scaled
+// to unit length so that a dot product is their correlation (placed on the
+// master calendar's bars when there is one, else by position from the last
+// bar). Stocks are first blocked by sector, then each block is bisected by
+// spherical 2-means on those profiles until no cluster is larger than
+// max_cluster_size. Every cluster is linked to the `neighbors` clusters
+// whose mean profiles correlate best with its own, across sectors too, so
+// pairs split by a sector boundary or a bisection can still be found.
+class PairUniverse {
+public:
+    struct Options {
+        size_t max_cluster_size = 64;
+        size_t neighbors = 2;           // nearest clusters linked to each cluster
+        size_t window = 250;            // returns per profile
+        bool sector_blocks = true;      // clusters never span sectors
+    };
+
+    // Clusters the stocks with include[s] set; the others are in no cluster
+    // and pair with nothing
+    PairUniverse(const std::vector<std::unique_ptr<StockData>>& stocks,
+                 const std::vector<unsigned char>& include,
+                 const TradingCalendar* calendar,
+                 const Options& options);
+
+    static constexpr uint32_t kNoCluster = UINT32_MAX;
+
+    // Cluster of stock s, or kNoCluster
+    uint32_t clusterOf(size_t s) const { return cluster_of_[s]; }
+
+    // Clusters a and b are the same or linked
+    bool pairsClusters(uint32_t a, uint32_t b) const {
+        return a != kNoCluster && b != kNoCluster && (a == b || linked_[a * sizes_.size() + b]);
+    }
+
+    // Stocks i and j share a cluster or sit in linked clusters
+    bool contains(size_t i, size_t j) const { return pairsClusters(cluster_of_[i], cluster_of_[j]); }
+
+    size_t clusterCount() const { return sizes_.size(); }
+    size_t largestCluster() const;
+
+    // Pairs of clustered stocks contains() accepts, and all pairs of them
+    size_t pairCount() const;
+    size_t fullPairCount() const;
+
+private:
+    std::vector<uint32_t> cluster_of_;     // per stock
+    std::vector<size_t> sizes_;            // per cluster
+    std::vector<unsigned char> linked_;    // clusters x clusters, symmetric
+};
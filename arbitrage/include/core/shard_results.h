@@ -0,0 +1,26 @@
+#pragma once
+
+#include "stock_data.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Partial results of one shard of a sharded run (.mfsr, version 1): a 64-byte
+// header, the cointegration records, the correlation records, then a string
+// table of the NUL-terminated symbols and sectors the records point into.
+// Records carry the analysis cache's payloads, in host byte order.
+class ShardResults {
+public:
+    uint32_t shard_index = 0;
+    uint32_t shard_count = 1;
+    uint64_t pairs_analyzed = 0;    // pairs this shard tested for cointegration
+    std::vector<CointegrationResult> cointegration;
+    std::vector<CorrelationResult> correlation;
+
+    // False, leaving the results empty, when the file is missing, malformed
+    // or of another version
+    bool load(const std::string& path);
+    // Writes a temporary file and renames it into place; throws
+    // std::runtime_error on failure
+    void save(const std::string& path) const;
+};
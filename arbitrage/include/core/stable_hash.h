@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// FNV-1a: stable across builds and runs, unlike std::hash, so its values can
+// be stored in files and compared on the next run. Chain calls by passing
+// the previous hash.
+constexpr uint64_t kFnv1aBasis = 0xcbf29ce484222325ULL;
+
+inline uint64_t fnv1a(const void* data, size_t size, uint64_t hash = kFnv1aBasis) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
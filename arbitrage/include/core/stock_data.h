@@ -1,13 +1,16 @@
 #pragma once
 
+#include "memory_accounting.h"
 #include <vector>
 #include <string>
 #include <chrono>
 #include <memory>
 #include <unordered_map>
+#include <cstdint>
 
-// Aligned allocator for SIMD operations
-template<typename T, size_t Alignment>
+// Aligned allocator for SIMD operations; its blocks count towards a
+// subsystem of memory_accounting.h (the loaded series by default)
+template<typename T, size_t Alignment, MemorySubsystem Subsystem = MemorySubsystem::Loader>
 class aligned_allocator {
 public:
     using value_type = T;
@@ -20,23 +23,25 @@ public:
 
     template<typename U>
     struct rebind {
-        using other = aligned_allocator<U, Alignment>;
+        using other = aligned_allocator<U, Alignment, Subsystem>;
     };
 
     aligned_allocator() = default;
     
     template<typename U>
-    aligned_allocator(const aligned_allocator<U, Alignment>&) {}
+    aligned_allocator(const aligned_allocator<U, Alignment, Subsystem>&) {}
 
     pointer allocate(size_type n) {
         void* ptr = nullptr;
         if (posix_memalign(&ptr, Alignment, n * sizeof(T)) != 0) {
             throw std::bad_alloc();
         }
+        memory_allocated(Subsystem, n * sizeof(T));
         return static_cast<pointer>(ptr);
     }
 
-    void deallocate(pointer p, size_type) {
+    void deallocate(pointer p, size_type n) {
+        memory_released(Subsystem, n * sizeof(T));
         free(p);
     }
 
@@ -57,12 +62,26 @@ struct alignas(32) StockData {
     std::vector<double, aligned_allocator<double, 32>> volume;
     std::vector<double, aligned_allocator<double, 32>> returns;
     
+    // close - mean_price, kept for pair regressions: with each leg centered
+    // once per stock, a pair's hedge ratio and spread moments only need the
+    // cross-product sum (filled by calculateStatistics)
+    std::vector<double, aligned_allocator<double, 32>> centered_close;
+    
+    // Ranks of the returns, 1-based with ties averaged (filled on demand by
+    // calculateReturnRanks, only for stocks in pairs that need rank
+    // correlations): a stock's ranks never change between pairs, so
+    // Spearman's rho is a Pearson correlation of two stocks' ranks and
+    // Kendall's tau needs no per-pair sort of the values
+    std::vector<double, aligned_allocator<double, 32>> return_ranks;
+    
     // Pre-calculated statistics for faster analysis
     double mean_price = 0.0;
     double mean_return = 0.0;
     double volatility = 0.0;
     double min_price = 0.0;
     double max_price = 0.0;
+    double close_centered_sum_sq = 0.0; // sum of centered_close^2
+    uint64_t content_hash = 0;          // contentHash(), set by calculateStatistics
     
     // Market classification
     std::string sector;
@@ -91,8 +110,22 @@ struct alignas(32) StockData {
     
     // Calculate returns from prices
     void calculateReturns();
+    
+    // Fills return_ranks unless they already match the returns
+    void calculateReturnRanks();
+    bool hasReturnRanks() const { return return_ranks.size() == returns.size(); }
+    
+    // Stable hash of the timestamps and closes, so cached pair results can
+    // tell when a stock's data has changed
+    uint64_t contentHash() const { return contentHash(close.size()); }
+    // The same hash over the first `bars` bars only, so a stock that has
+    // since grown can be checked against what an earlier run saw
+    uint64_t contentHash(size_t bars) const;
 };
 
+// 1-based ranks of values[0, n), ties given their average rank
+void averageRanks(const double* values, size_t n, double* ranks);
+
 // Cointegration analysis result
 struct CointegrationResult {
     std::string stock1;
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "stock_data.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class MappedFile;
+
+// Parsed stocks kept between runs in one mapped binary file (.mfss, version
+// 1): a 64-byte header, one fixed-size record per stock, a string table of
+// the NUL-terminated symbols, sectors and cap buckets, then each stock's
+// columns (timestamps as clock ticks, OHLCV, returns, centered closes and
+// return ranks), every column 64-byte aligned, in host byte order.
+//
+// Each record carries the fingerprint of the source file it was parsed from
+// (path and a hash of its contents), so a stock is reused only while its
+// feature file is unchanged; records hold the stocks before filtering, so
+// changed constraints still apply to a reused snapshot.
+class StockSnapshot {
+public:
+    // Fingerprint of a source file, read whole; 0 if it is empty or cannot
+    // be read
+    static uint64_t sourceFingerprint(const std::string& path);
+
+    // Maps `path`; false, leaving the snapshot empty, when the file is
+    // missing, malformed or of another version
+    bool load(const std::string& path);
+
+    // The stock parsed from a source with this fingerprint, its columns and
+    // statistics copied straight out of the mapping; nullptr when absent
+    std::unique_ptr<StockData> find(uint64_t source_fingerprint) const;
+
+    size_t size() const { return index_.size(); }
+
+    // Writes `stocks` (null entries skipped) with their sources'
+    // fingerprints to a temporary file and renames it into place; throws
+    // std::runtime_error on failure
+    static void save(const std::string& path,
+                     const std::vector<const StockData*>& stocks,
+                     const std::vector<uint64_t>& source_fingerprints);
+
+private:
+    std::shared_ptr<MappedFile> file_;
+    std::unordered_map<uint64_t, size_t> index_;    // fingerprint -> record
+};
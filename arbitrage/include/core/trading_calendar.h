@@ -0,0 +1,90 @@
+#pragma once
+
+#include "stock_data.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <chrono>
+
+// Where one stock's bars sit on the master calendar
+struct CalendarAlignment {
+    bool aligned = false;       // false when the stock has no usable timestamps
+    size_t offset = 0;          // calendar index of the stock's first bar
+    size_t span = 0;            // calendar bars from its first to its last bar
+    bool gap_free = false;      // every calendar bar of the span is present
+    // Presence bits indexed by absolute calendar bar, so two stocks' words
+    // line up: word w covers bars [64 (first_word + w), 64 (first_word + w + 1))
+    size_t first_word = 0;
+    std::vector<uint64_t> presence;
+    std::vector<uint32_t> rank;  // bars present before each word
+    uint32_t bar_set = 0;        // equal for exactly the stocks holding the same bars
+};
+
+// A pair's closes and simple returns on its common bars, gathered by
+// TradingCalendar::gatherCommonBars(). The buffers are kept from pair to
+// pair, so a worker's scratch stops allocating once it has grown.
+struct CommonBarSeries {
+    std::vector<uint32_t> index_a, index_b;
+    std::vector<double> close_a, close_b;
+    std::vector<double> returns_a, returns_b;  // one fewer than the closes
+};
+
+// Master trading calendar: the sorted union of every stock's bar timestamps,
+// built once per analysis. Each stock is mapped onto it with a presence
+// bitmap and offset, so a pair's common bars come from a word-wise AND of two
+// bitmaps (or a plain range when both stocks are gap-free) instead of a
+// timestamp merge per pair.
+class TradingCalendar {
+public:
+    using time_point = std::chrono::system_clock::time_point;
+    
+    // Stocks whose timestamps are missing, fewer than their closes or out of
+    // order stay unaligned and only pair by position
+    explicit TradingCalendar(const std::vector<std::unique_ptr<StockData>>& stocks);
+    
+    size_t size() const { return bars_.size(); }
+    const std::vector<time_point>& bars() const { return bars_; }
+    const CalendarAlignment& alignment(size_t stock) const { return alignments_[stock]; }
+    
+    // Both stocks are aligned and hold exactly the same bars, so their arrays
+    // already line up index for index and the pair stays on the Gram tiles
+    bool sameBars(size_t a, size_t b) const {
+        return alignments_[a].aligned && alignments_[b].aligned &&
+               alignments_[a].bar_set == alignments_[b].bar_set;
+    }
+    
+    // Both stocks are aligned but hold different bars, so they pair only
+    // through their common bars
+    bool needsAlignment(size_t a, size_t b) const {
+        return alignments_[a].aligned && alignments_[b].aligned && !sameBars(a, b);
+    }
+    
+    // Number of bars both aligned stocks hold; 0 if either is unaligned
+    size_t commonBarCount(size_t a, size_t b) const;
+    
+    // Positions in each stock's own arrays of their common bars, in time
+    // order, from calendar bar from_bar on
+    void commonBars(size_t a, size_t b, std::vector<uint32_t>& index_a, std::vector<uint32_t>& index_b,
+                    size_t from_bar = 0) const;
+    
+    // First calendar bar later than `time`; size() if there is none
+    size_t barAfter(time_point time) const;
+    
+    // The closes of stocks a and b on their common bars and the returns
+    // between them, as StockData::calculateReturns has them, into `out`
+    void gatherCommonBars(const StockData& stock_a, size_t a, const StockData& stock_b, size_t b,
+                          CommonBarSeries& out) const;
+    
+    // Copies of stocks a and b cut down to their common bars: symbol, sector,
+    // timestamps and close, with returns and statistics recalculated. For
+    // consumers that need whole StockData legs; screens use gatherCommonBars()
+    void alignPair(const StockData& stock_a, size_t a, const StockData& stock_b, size_t b,
+                   StockData& out_a, StockData& out_b) const;
+
+private:
+    // Position in the stock's arrays of a calendar bar it holds
+    static size_t barIndex(const CalendarAlignment& alignment, size_t bar);
+    
+    std::vector<time_point> bars_;
+    std::vector<CalendarAlignment> alignments_;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../core/stock_data.h"
+#include "../statistics/pairs_backtest.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -158,6 +159,13 @@ public:
         const std::string& output_path
     );
     
+    // One row per backtested rule with its trades pooled over the pairs
+    static bool exportBacktestGridCSV(
+        const std::vector<PairsBacktestEngine::Rule>& rules,
+        const std::vector<PairsBacktestEngine::Metrics>& metrics,
+        const std::string& output_path
+    );
+    
     // Export all results to separate CSV files
     static bool exportAllToCSV(
         const std::vector<CointegrationResult>& cointegration_results,
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "tiled_matrix_format.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Writes a .mftm tiled matrix (tiled_matrix_format.h) through a shared
+// mapping of the file: cells are set from any thread, in any order,
+// straight into their level-0 tiles; finish() reduces the coarser levels
+// and renames the file into place. Nothing matrix-sized is allocated.
+class TiledMatrixWriter {
+public:
+    struct Layer {
+        std::string name;
+        MatrixReduction reduction;
+        float display_min;
+        float display_max;
+    };
+
+    // Creates <path>.tmp with every cell NaN; throws std::runtime_error if
+    // it cannot be created or mapped
+    TiledMatrixWriter(const std::string& path, const std::vector<std::string>& symbols,
+                      const std::vector<Layer>& layers);
+    // Deletes the temporary file unless finish() ran
+    ~TiledMatrixWriter();
+    TiledMatrixWriter(const TiledMatrixWriter&) = delete;
+    TiledMatrixWriter& operator=(const TiledMatrixWriter&) = delete;
+
+    // Sets cells (i, j) and (j, i); distinct pairs may be set concurrently
+    void set(size_t layer, size_t i, size_t j, float value) {
+        *cell(layer, i, j) = value;
+        *cell(layer, j, i) = value;
+    }
+
+    // Builds every coarser level from the one below and moves the file to
+    // `path`; throws std::runtime_error on failure
+    void finish();
+
+private:
+    float* cell(size_t layer, size_t row, size_t col) const {
+        float* tile = level_data(layer, 0) + ((row / kTiledMatrixTile) * tiles0_ + col / kTiledMatrixTile) *
+                                                 kTiledMatrixTile * kTiledMatrixTile;
+        return tile + (row % kTiledMatrixTile) * kTiledMatrixTile + col % kTiledMatrixTile;
+    }
+    float* level_data(size_t layer, uint32_t level) const {
+        return reinterpret_cast<float*>(base_ + layer_offsets_[layer] + level_offsets_[level]);
+    }
+    void reduceLevel(size_t layer, uint32_t level);
+    void unmap();
+
+    std::string path_;
+    std::string temporary_;
+    int fd_ = -1;
+    uint8_t* base_ = nullptr;
+    size_t bytes_ = 0;
+    size_t size_ = 0;
+    size_t tiles0_ = 0;                     // tiles per side of level 0
+    uint32_t levels_ = 0;
+    std::vector<MatrixReduction> reductions_;
+    std::vector<size_t> layer_offsets_;
+    std::vector<size_t> level_offsets_;     // from a layer's offset
+    bool finished_ = false;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+// Augmented Dickey-Fuller tests for many series at once. Series of equal
+// length are packed `lanes` to a register and run through one pass that
+// builds the lagged regression for every lag order together; the lag order
+// is then picked per series by AIC or BIC from the same factorization.
+// The regression is dy_t = a + b y_{t-1} + sum c_i dy_{t-i} + e_t and the
+// statistic is the t-ratio of b.
+class BatchADFEngine {
+public:
+    enum class LagSelection {
+        Fixed,  // always max_lags
+        AIC,
+        BIC
+    };
+    
+    struct Options {
+        int max_lags = 10;      // capped at length / 4 and the kernel maximum
+        LagSelection selection = LagSelection::AIC;
+    };
+    
+    struct Result {
+        double statistic = 0.0;
+        int lags = 0;
+        bool valid = false;     // false for series shorter than kMinLength or degenerate fits
+    };
+    
+    static constexpr size_t kMinLength = 20;
+    
+    // One result per series, in input order; null entries are left invalid
+    static std::vector<Result> run(
+        const std::vector<const std::vector<double>*>& series,
+        const Options& options
+    );
+    
+    static Result run(const std::vector<double>& series, const Options& options);
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "stock_data.h"
+#include "adf_engine.h"
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+// Empirical p-values for the Engle-Granger test, instead of the fixed
+// asymptotic critical values. Under the null of no cointegration both legs
+// are random walks, so each replicate rebuilds the two price paths from
+// resampled joint bar-to-bar changes (keeping their cross-correlation),
+// re-estimates the hedge regression and runs the same ADF test on the new
+// spread. The p-value is the share of replicates whose statistic is at or
+// below the observed one.
+//
+// Replicate r of a pair draws from the Philox stream keyed by the seed and
+// the pair's symbols with counter r, so results do not depend on the thread
+// count, the order of the pairs or how the replicates are split. Replicates
+// run in runs on a work-stealing pool, each run's spreads going through the
+// batched ADF engine together.
+class BootstrapCointegrationEngine {
+public:
+    enum class Method {
+        BlockBootstrap,     // moving blocks of consecutive changes
+        Permutation         // changes shuffled one by one
+    };
+    
+    struct Options {
+        Method method = Method::BlockBootstrap;
+        size_t replicates = 2000;
+        size_t block_length = 0;        // 0 = cube root of the bar count
+        uint64_t seed = 0x4d46542d45474250ULL;
+        unsigned int num_threads = 0;   // 0 = hardware_concurrency()
+        BatchADFEngine::Options adf;    // as in the tested pairs
+    };
+    
+    struct Result {
+        bool valid = false;             // false for null legs, unequal or too short series
+        double statistic = 0.0;         // ADF statistic of the observed spread
+        double p_value = 1.0;
+        // Quantiles of the replicate statistics
+        double critical_value_1pct = 0.0;
+        double critical_value_5pct = 0.0;
+        double critical_value_10pct = 0.0;
+    };
+    
+    // One result per pair, in input order; legs must be of equal length
+    // (align them with TradingCalendar::alignPair first)
+    static std::vector<Result> run(
+        const std::vector<std::pair<const StockData*, const StockData*>>& pairs,
+        const Options& options
+    );
+    
+    static Result run(const StockData& stock1, const StockData& stock2, const Options& options);
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2,
+// 3"): a keyed bijection of a 128-bit counter, so draw c of stream k is a
+// pure function of (k, c). Workers can take any slice of a stream, in any
+// order, and produce the same numbers as a single thread would.
+class Philox4x32 {
+public:
+    using Block = std::array<uint32_t, 4>;
+    
+    explicit Philox4x32(uint64_t key)
+        : key0_(static_cast<uint32_t>(key)), key1_(static_cast<uint32_t>(key >> 32)) {}
+    
+    // Four 32-bit draws for counter (high, low)
+    Block operator()(uint64_t high, uint64_t low) const {
+        Block counter{static_cast<uint32_t>(low), static_cast<uint32_t>(low >> 32),
+                      static_cast<uint32_t>(high), static_cast<uint32_t>(high >> 32)};
+        uint32_t k0 = key0_, k1 = key1_;
+        for (int round = 0; round < 10; ++round) {
+            const uint64_t product0 = static_cast<uint64_t>(kMultiplier0) * counter[0];
+            const uint64_t product1 = static_cast<uint64_t>(kMultiplier1) * counter[2];
+            counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ k0,
+                       static_cast<uint32_t>(product1),
+                       static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ k1,
+                       static_cast<uint32_t>(product0)};
+            k0 += kWeyl0;
+            k1 += kWeyl1;
+        }
+        return counter;
+    }
+    
+    // Uniform integer in [0, range) from one 32-bit draw (multiply-shift)
+    static uint32_t below(uint32_t draw, uint32_t range) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(draw) * range) >> 32);
+    }
+
+private:
+    static constexpr uint32_t kMultiplier0 = 0xD2511F53;
+    static constexpr uint32_t kMultiplier1 = 0xCD9E8D57;
+    static constexpr uint32_t kWeyl0 = 0x9E3779B9;
+    static constexpr uint32_t kWeyl1 = 0xBB67AE85;
+    
+    uint32_t key0_;
+    uint32_t key1_;
+};
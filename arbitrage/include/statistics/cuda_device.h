@@ -0,0 +1,27 @@
+#pragma once
+
+#include "gpu_correlation.h"
+#include <cstddef>
+#include <string>
+
+// Thin CUDA runtime wrappers behind GpuCorrelation, implemented in
+// cuda_device.cu; only built with MFT_ENABLE_CUDA. Every call returns false
+// (or nullptr) on a CUDA error instead of throwing.
+class CudaDevice {
+public:
+    // First device's name; false if there is none
+    static bool firstDevice(std::string& name);
+
+    static void* allocate(size_t bytes);
+    static void free(void* device);
+    static bool upload(void* device, const void* host, size_t bytes);
+
+    // Thresholded Gram product of a resident panel-packed matrix (see
+    // GpuCorrelation::upload): writes up to `capacity` passing pairs to the
+    // device buffer `pairs`, copies them back to `host_pairs` and sets
+    // `found` to the number that passed, which may exceed `capacity`
+    static bool correlatedPairs(const double* panels, const unsigned char* has_variance,
+                                size_t depth, size_t count, size_t width, double min_correlation,
+                                GpuCorrelation::Pair* pairs, size_t capacity,
+                                GpuCorrelation::Pair* host_pairs, size_t& found);
+};
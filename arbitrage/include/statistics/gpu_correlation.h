@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// CUDA offload of the all-pairs correlation screen (correlatedPairs_SIMD).
+// A group's standardized, panel-packed series are uploaded once and stay
+// resident on the device under a caller's key, so the later screens of a run
+// over the same series skip the upload; each screen runs the thresholded
+// Gram product on the device and streams back only the pairs that pass.
+//
+// Builds without MFT_ENABLE_CUDA, or hosts without a device, report
+// available() false and every caller keeps the CPU path.
+class GpuCorrelation {
+public:
+    struct Pair {
+        uint32_t a;             // column indices, a < b
+        uint32_t b;
+        double correlation;
+    };
+
+    // A CUDA device is present and the build has the backend
+    static bool available();
+    static std::string deviceName();    // empty when unavailable
+
+    // Runtime switch, on by default; offload runs only when enabled and available
+    static void setEnabled(bool enabled);
+    static bool enabled();
+
+    // Whether `key` still names an uploaded matrix
+    static bool resident(uint64_t key);
+    // Uploads `count` series of `depth` rows in the gram_panel layout of
+    // correlatedPairs_SIMD (series k, row t at
+    // panels[(k / width) * depth * width + t * width + k % width]) with one
+    // has-variance flag per series; evicts the oldest matrices when the
+    // device runs out of memory. False if the device cannot hold it.
+    static bool upload(uint64_t key, const double* panels, size_t depth, size_t count, size_t width,
+                       const unsigned char* has_variance);
+    // Pairs a < b of the resident matrix, both with variance, whose
+    // correlation is at least min_correlation, in unspecified order; false
+    // on a device error
+    static bool correlatedPairs(uint64_t key, double min_correlation, std::vector<Pair>& pairs);
+
+    // Frees every resident matrix
+    static void release();
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "stock_data.h"
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+// Grid search over the threshold rule the analyzer scores each pair with
+// (EnhancedCointegrationAnalyzer: short above z = 2, long below -2, out at
+// 0.5 or on a 3-sigma stop), instead of one analyzer run per setting. Each
+// pair's spread z-scores are computed once and every rule of the grid runs
+// over them in the same pass, `lanes` rules to a register
+// (SimdKernels::threshold_backtest_lanes); pairs run in parallel on a
+// work-stealing pool.
+class PairsBacktestEngine {
+public:
+    struct Rule {
+        double entry_z = 2.0;
+        double exit_z = 0.5;
+        double stop_z = 3.0;
+        size_t max_holding = 0;         // bars in a position, 0 = no limit
+    };
+
+    // Every combination of the lists, entry-major then exit, stop, holding
+    struct Grid {
+        std::vector<double> entry_z = {1.5, 2.0, 2.5};
+        std::vector<double> exit_z = {0.0, 0.5, 1.0};
+        std::vector<double> stop_z = {3.0, 4.0};
+        std::vector<size_t> max_holding = {0};
+
+        std::vector<Rule> rules() const;
+    };
+
+    struct Options {
+        unsigned int num_threads = 0;   // 0 = hardware_concurrency()
+    };
+
+    // Closed trades of one rule; trade returns are 0.01 per unit of z
+    // gained, as in CointegrationResult::expected_return
+    struct Metrics {
+        size_t bars = 0;
+        size_t trades = 0;
+        size_t winning_trades = 0;
+        size_t entries = 0;             // trades plus a position still open
+        double return_sum = 0.0;
+        double return_sum_sq = 0.0;
+
+        double pnl() const { return return_sum; }
+        double expectedReturn() const { return trades > 0 ? return_sum / trades : 0.0; }
+        double winRate() const { return trades > 0 ? static_cast<double>(winning_trades) / trades : 0.0; }
+        // Mean over sample standard deviation of the trade returns
+        double sharpeRatio() const;
+        // Entries and exits per bar
+        double turnover() const { return bars > 0 ? static_cast<double>(entries + trades) / bars : 0.0; }
+
+        void merge(const Metrics& other);
+    };
+
+    // metrics[p][r] for pair p under rules[r]. Pairs with a null leg, legs
+    // of different lengths (align them with TradingCalendar::alignPair
+    // first), fewer than 20 bars or a flat spread get empty metrics.
+    static std::vector<std::vector<Metrics>> run(
+        const std::vector<std::pair<const StockData*, const StockData*>>& pairs,
+        const std::vector<Rule>& rules,
+        const Options& options
+    );
+
+    static std::vector<Metrics> run(const StockData& stock1, const StockData& stock2,
+                                    const std::vector<Rule>& rules);
+
+    // Each rule's trades pooled over every pair
+    static std::vector<Metrics> pool(const std::vector<std::vector<Metrics>>& metrics);
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "stock_data.h"
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+// Walk-forward cointegration of pairs in one pass over their bars, instead
+// of a full Engle-Granger fit per rolling window. The hedge regression
+// close2 = intercept + hedge_ratio * close1 (as in regressPair_SIMD) is
+// tracked online, and every bar's spread is tested with a Dickey-Fuller
+// regression over exponentially weighted moments, so a pair costs O(n)
+// whatever the window. Pairs of equal length run `lanes` to a register.
+class RollingCointegrationEngine {
+public:
+    enum class Estimator {
+        RLS,        // recursive least squares with exponential forgetting
+        Kalman      // intercept and hedge ratio as a random walk
+    };
+    
+    struct Options {
+        Estimator estimator = Estimator::RLS;
+        // Per-bar weight decay of the RLS fit and, for both estimators, of
+        // the noise and spread moments: an effective window of
+        // 1 / (1 - forgetting) bars
+        double forgetting = 0.98;
+        // Kalman: per-bar variance of the random walk, relative to the
+        // observation noise
+        double state_noise = 1e-4;
+        // Bars before the noise and spread moments start to accumulate
+        size_t warmup = 20;
+    };
+    
+    // One value per bar. spread is the one-step prediction error
+    // close2 - (intercept + hedge_ratio * close1) from the previous bar's
+    // estimates, so no bar sees its own data; z_score is that error over
+    // its predicted standard deviation. half_life and adf_statistic come
+    // from the spread close2 - hedge_ratio * close1 at the bar's hedge
+    // ratio. Values that are not defined yet (warm-up, no mean reversion)
+    // are 0.
+    struct Series {
+        std::vector<double> hedge_ratio;
+        std::vector<double> intercept;
+        std::vector<double> spread;
+        std::vector<double> z_score;
+        std::vector<double> half_life;
+        std::vector<double> adf_statistic;
+    };
+    
+    // One series per pair, in input order; pairs with a null leg or legs of
+    // different lengths (align them with TradingCalendar::alignPair first)
+    // are left empty
+    static std::vector<Series> run(
+        const std::vector<std::pair<const StockData*, const StockData*>>& pairs,
+        const Options& options
+    );
+    
+    static Series run(const StockData& stock1, const StockData& stock2, const Options& options);
+};
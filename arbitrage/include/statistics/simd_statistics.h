@@ -1,9 +1,11 @@
 #pragma once
 
 #include "../core/stock_data.h"
+#include "hardware_counters.h"
 #include <vector>
 #include <chrono>
 #include <cmath>
+#include <functional>
 
 // Only include SIMD headers for appropriate architectures
 #if defined(__x86_64__) || defined(_M_X64) || defined(__i386) || defined(_M_IX86)
@@ -14,9 +16,13 @@
 #include <arm_neon.h>   // NEON for ARM
 #endif
 
+struct SimdKernels;
+class PairUniverse;
+
+// Statistics on the kernels picked at runtime by simd_dispatch.h
 class SIMDStatistics {
 public:
-    // Check SIMD availability
+    // Check SIMD availability (the tier selected at runtime)
     static bool isAVX2Available();
     static bool isNEONAvailable();
     
@@ -45,7 +51,9 @@ public:
         const std::vector<double>& x
     );
     
-    // SIMD-optimized rolling statistics
+    // Rolling statistics over each full window (RollingStatistics, shared
+    // with the feature columns): size - window + 1 values, sample standard
+    // deviation, correlation 0 over a flat window
     static std::vector<double> rollingMean_SIMD(
         const std::vector<double>& data,
         int window_size
@@ -86,6 +94,9 @@ public:
         size_t operations_performed = 0;
         double gflops = 0.0;
         std::string simd_type_used; // "AVX2", "NEON", or "Scalar"
+        // Measured on this thread when hardware counters are enabled,
+        // otherwise zero
+        CounterValues counters;
     };
     
     static SIMDMetrics getLastMetrics() { return last_metrics_; }
@@ -96,46 +107,21 @@ public:
     );
 
 private:
-    // AVX2 implementations
-    static double calculateCorrelation_AVX2(
-        const double* data1, const double* data2, size_t size
-    );
-    
-    static std::pair<double, double> linearRegression_AVX2(
-        const double* y, const double* x, size_t size
-    );
-    
-    static void rollingMean_AVX2(
-        const double* input, double* output, size_t size, int window
-    );
-    
-    static double variance_AVX2(const double* data, size_t size);
-    
-    // NEON implementations
-#ifdef __ARM_NEON
-    static double calculateCorrelation_NEON(
-        const double* data1, const double* data2, size_t size
-    );
-    
-    static std::pair<double, double> linearRegression_NEON(
-        const double* y, const double* x, size_t size
+    // Vector implementations on the active tier's kernels
+    static double calculateCorrelation_Vector(
+        const SimdKernels& kernels, const double* data1, const double* data2, size_t size
     );
     
-    static void rollingMean_NEON(
-        const double* input, double* output, size_t size, int window
+    static std::pair<double, double> linearRegression_Vector(
+        const SimdKernels& kernels, const double* y, const double* x, size_t size
     );
     
-    static double variance_NEON(const double* data, size_t size);
-#endif
+    static double variance_Vector(const SimdKernels& kernels, const double* data, size_t size);
     
     static std::pair<double, double> linearRegression_Scalar(
         const double* y, const double* x, size_t size
     );
     
-    static void rollingMean_Scalar(
-        const double* input, double* output, size_t size, int window
-    );
-    
     static double variance_Scalar(const double* data, size_t size);
     
     // Utility functions
@@ -164,6 +150,35 @@ public:
         const std::vector<std::pair<const StockData*, const StockData*>>& stock_pairs
     );
     
+    // Replaces a tested pair's table p-value and critical values with
+    // empirical ones (BootstrapCointegrationEngine) and re-derives its
+    // verdict and grade from them
+    static void applyEmpiricalPValue(
+        CointegrationResult& result,
+        double p_value,
+        double critical_1pct,
+        double critical_5pct,
+        double critical_10pct,
+        double significance_level = 0.05
+    );
+    
+    // Hedge regression of stock2's close on stock1's,
+    //   close2 = intercept + hedge_ratio * close1 + residual,
+    // and the moments of the spread close2 - hedge_ratio * close1. Uses each
+    // stock's centered_close and close_centered_sum_sq, so a pair costs one
+    // cross-product pass; a stock without them is centered here instead.
+    struct HedgeRegression {
+        double hedge_ratio = 0.0;
+        double intercept = 0.0;
+        double spread_mean = 0.0;
+        double spread_std = 0.0;        // population standard deviation
+        double current_spread = 0.0;
+    };
+    static HedgeRegression regressPair_SIMD(
+        const StockData& stock1,
+        const StockData& stock2
+    );
+    
     // Calculate optimal hedge ratio using SIMD
     static double calculateHedgeRatio_SIMD(
         const std::vector<double>& prices1,
@@ -208,22 +223,110 @@ public:
         const StockData& stock2
     );
     
+    // Pearson correlation of every pair i < j of stocks whose `series` have
+    // the same length, as one product Z^T Z of the standardized series
+    // computed in cache-blocked tiles on the active kernels and a
+    // work-stealing pool. Only pairs at or above min_correlation that
+    // include_pair accepts are returned, so the N x N matrix is never held in
+    // memory. Null entries are skipped; order is unspecified. With the
+    // GpuCorrelation backend enabled and available, each equal-length group
+    // is screened on the device instead, from a copy kept resident across
+    // screens of the same series; a group the device cannot take falls back
+    // to the tiles.
+    //
+    // With a TileShard, only that shard's tiles are computed. Tiles are dealt
+    // to the shards round-robin in their fixed walk (groups by length, then
+    // row and column), so shards of one run agree on the split without
+    // talking to each other, as long as they screen the same stocks.
+    //
+    // With a PairUniverse, only its pairs are returned and only its
+    // clustered stocks are packed, ordered by cluster: the tiles and panel
+    // pairs that hold no pair within a cluster or between linked clusters
+    // are not computed, so the product costs about the universe's pair count
+    // rather than N^2 / 2. The device still screens whole groups.
+    using PairFilter = std::function<bool(size_t i, size_t j)>;
+    using Series = std::vector<double, aligned_allocator<double, 32>> StockData::*;
+    struct PairCorrelation {
+        size_t i;
+        size_t j;
+        double correlation;
+    };
+    struct TileShard {
+        unsigned index;
+        unsigned count;
+    };
+    static std::vector<PairCorrelation> correlatedPairs_SIMD(
+        const std::vector<const StockData*>& stocks,
+        Series series,
+        double min_correlation,
+        unsigned int num_threads,
+        const PairFilter& include_pair,
+        const TileShard& shard = TileShard{0, 1},
+        const PairUniverse* universe = nullptr
+    );
+    
+    // Every correlation of the same product, unthresholded, handed to `sink`
+    // from the pool's threads as each tile finishes (concurrently, in no
+    // particular order); the device path does not apply
+    using CorrelationSink = std::function<void(size_t i, size_t j, double correlation)>;
+    static void allCorrelations_SIMD(
+        const std::vector<const StockData*>& stocks,
+        Series series,
+        unsigned int num_threads,
+        const CorrelationSink& sink
+    );
+    
+    // correlatedPairs_SIMD on returns as correlation results; rank
+    // correlations are left at zero (see fillRankCorrelations)
+    static std::vector<CorrelationResult> analyzeAllPairs_SIMD(
+        const std::vector<const StockData*>& stocks,
+        double min_correlation,
+        unsigned int num_threads,
+        const PairFilter& include_pair
+    );
+    
+    // Result for a pair with a known Pearson correlation: grade, sectors and
+    // the latest prices
+    static CorrelationResult correlationResult(
+        const StockData& stock1,
+        const StockData& stock2,
+        double correlation
+    );
+    
     // Batch correlation analysis for multiple pairs
     static std::vector<CorrelationResult> batchAnalyzeCorrelation_SIMD(
         const std::vector<std::pair<const StockData*, const StockData*>>& stock_pairs
     );
     
-    // Calculate Spearman rank correlation using SIMD
+    // Spearman's rho: Pearson correlation of the average ranks
     static double calculateSpearmanCorrelation_SIMD(
         const std::vector<double>& series1,
         const std::vector<double>& series2
     );
+    // Of two stocks' returns, over their cached return_ranks
+    static double calculateSpearmanCorrelation_SIMD(
+        const StockData& stock1,
+        const StockData& stock2
+    );
     
-    // Calculate Kendall's tau correlation
+    // Kendall's tau-b by Knight's merge-sort algorithm, O(n log n)
     static double calculateKendallTau_SIMD(
         const std::vector<double>& series1,
         const std::vector<double>& series2
     );
+    // Of two stocks' returns, over their cached return_ranks
+    static double calculateKendallTau_SIMD(
+        const StockData& stock1,
+        const StockData& stock2
+    );
+    
+    // Sets the Spearman and Kendall fields of a pair's result from the two
+    // stocks' returns (equal lengths; align the legs first)
+    static void fillRankCorrelations(
+        const StockData& stock1,
+        const StockData& stock2,
+        CorrelationResult& result
+    );
     
     // Calculate correlation stability metric
     static double calculateCorrelationStability_SIMD(
@@ -231,7 +334,7 @@ public:
     );
 
 private:
-    // Rank transformation for Spearman correlation
+    // Average ranks of one series, as averageRanks
     static std::vector<double> rankTransform_SIMD(
         const std::vector<double>& data
     );
@@ -1,4 +1,11 @@
 #include "include/core/arbitrage_analyzer.h"
+#include "simd_dispatch.h"
+#include "machine_profile.h"
+#include "gpu_correlation.h"
+#include "numa_topology.h"
+#include "hardware_counters.h"
+#include "memory_accounting.h"
+#include "trace.h"
 #include <iostream>
 #include <iomanip>
 #include <chrono>
@@ -16,9 +23,13 @@ void printBanner() {
 void printSystemInfo() {
     std::cout << "=== SYSTEM INFORMATION ===" << std::endl;
     std::cout << "CPU Cores: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "NUMA Nodes: " << NumaTopology::system().nodes() << std::endl;
+    std::cout << "SIMD Tier: " << simd_tier_name(active_simd_tier())
+              << " (detected " << simd_tier_name(detect_simd_tier()) << ")" << std::endl;
     std::cout << "SIMD Support:" << std::endl;
     std::cout << "  - AVX2: " << (SIMDStatistics::isAVX2Available() ? "ENABLED" : "DISABLED") << std::endl;
     std::cout << "  - NEON: " << (SIMDStatistics::isNEONAvailable() ? "ENABLED" : "DISABLED") << std::endl;
+    std::cout << "GPU: " << (GpuCorrelation::available() ? GpuCorrelation::deviceName() : "none") << std::endl;
     std::cout << "==========================" << std::endl;
     std::cout << std::endl;
 }
@@ -54,6 +65,9 @@ void printAnalysisResults(const ArbitrageAnalyzer::AnalysisMetrics& metrics) {
     std::cout << "  - Stocks filtered: " << metrics.stocks_filtered << std::endl;
     std::cout << "  - Loading time: " << std::fixed << std::setprecision(3) 
               << metrics.loading_time_seconds << " seconds" << std::endl;
+    if (metrics.stocks_from_snapshot > 0) {
+        std::cout << "  - From snapshot: " << metrics.stocks_from_snapshot << " stocks" << std::endl;
+    }
     
     // Analysis results
     std::cout << "Pair Analysis:" << std::endl;
@@ -63,6 +77,34 @@ void printAnalysisResults(const ArbitrageAnalyzer::AnalysisMetrics& metrics) {
     std::cout << "  - Arbitrage opportunities found: " << metrics.arbitrage_opportunities_found << std::endl;
     std::cout << "  - Analysis time: " << std::fixed << std::setprecision(3) 
               << metrics.analysis_time_seconds << " seconds" << std::endl;
+    if (metrics.universe_clusters > 0) {
+        std::cout << "  - Pair universe: " << metrics.universe_clusters << " clusters (largest "
+                  << metrics.universe_largest_cluster << "), " << metrics.universe_pairs << " of "
+                  << metrics.universe_full_pairs << " pairs (" << std::fixed << std::setprecision(1)
+                  << metrics.universe_coverage * 100.0 << "% coverage, " << std::setprecision(3)
+                  << metrics.universe_time_seconds << " seconds)" << std::endl;
+    }
+    if (metrics.pairs_screened > 0) {
+        std::cout << "  - Pre-screen: " << metrics.pairs_passed_screen << " of " << metrics.pairs_screened
+                  << " pairs passed (" << std::fixed << std::setprecision(1)
+                  << metrics.prescreen_prune_ratio * 100.0 << "% pruned, " << std::setprecision(3)
+                  << metrics.prescreen_time_seconds << " seconds)" << std::endl;
+    }
+    if (metrics.pairs_resampled > 0) {
+        std::cout << "  - Empirical p-values: " << metrics.pairs_resampled << " pairs resampled, "
+                  << metrics.pairs_dropped_by_resampling << " dropped (" << std::fixed << std::setprecision(3)
+                  << metrics.resampling_time_seconds << " seconds)" << std::endl;
+    }
+    if (metrics.calendar_bars > 0) {
+        std::cout << "  - Trading calendar: " << metrics.calendar_bars << " bars, "
+                  << metrics.aligned_pairs << " pairs analyzed on common bars" << std::endl;
+    }
+    if (metrics.incremental_full_screen || metrics.incremental_pairs_watched > 0) {
+        std::cout << "  - Incremental: " << (metrics.incremental_full_screen ? "full screen, " : "")
+                  << metrics.incremental_stocks_changed << " stocks changed, "
+                  << metrics.incremental_pairs_updated << " pairs extended, "
+                  << metrics.incremental_pairs_watched << " pairs watched" << std::endl;
+    }
     
     // Performance metrics
     std::cout << "Performance:" << std::endl;
@@ -71,12 +113,31 @@ void printAnalysisResults(const ArbitrageAnalyzer::AnalysisMetrics& metrics) {
     std::cout << "  - GFLOPS achieved: " << std::fixed << std::setprecision(3) 
               << metrics.gflops_achieved << std::endl;
     std::cout << "  - SIMD type used: " << metrics.simd_type_used << std::endl;
+    if (hardware_counters_enabled()) {
+        print_counter_report("Analysis");
+    }
+    print_memory_report("Analysis");
+    if (!metrics.trace_file.empty()) {
+        print_trace_latencies("Analysis");
+        std::cout << "  - Trace: " << metrics.trace_file << std::endl;
+    }
     
     // Export results
     std::cout << "Export:" << std::endl;
     std::cout << "  - Export time: " << std::fixed << std::setprecision(3) 
               << metrics.export_time_seconds << " seconds" << std::endl;
     std::cout << "  - Export successful: " << (metrics.export_successful ? "YES" : "NO") << std::endl;
+    if (!metrics.shard_file.empty()) {
+        std::cout << "  - Shard results: " << metrics.shard_file << std::endl;
+    }
+    if (!metrics.backtest_file.empty()) {
+        std::cout << "  - Backtest grid: " << metrics.backtest_rules << " rules over "
+                  << metrics.backtest_pairs << " pairs in " << std::fixed << std::setprecision(3)
+                  << metrics.backtest_time_seconds << " seconds -> " << metrics.backtest_file << std::endl;
+    }
+    if (!metrics.matrix_file.empty()) {
+        std::cout << "  - Pair matrix: " << metrics.matrix_file << std::endl;
+    }
     
     // Overall metrics
     std::cout << "Overall:" << std::endl;
@@ -101,6 +162,11 @@ void printUsageExamples() {
     std::cout << "  # Adjust correlation threshold" << std::endl;
     std::cout << "  ./arbitrage_analyzer --min-correlation 0.8" << std::endl;
     std::cout << std::endl;
+    std::cout << "  # Split the pairs over two nodes, then merge their results" << std::endl;
+    std::cout << "  ./arbitrage_analyzer --shard 0/2 --output-dir node0/" << std::endl;
+    std::cout << "  ./arbitrage_analyzer --shard 1/2 --output-dir node1/" << std::endl;
+    std::cout << "  ./arbitrage_analyzer merge node0/shard_0_of_2.mfsr node1/shard_1_of_2.mfsr" << std::endl;
+    std::cout << std::endl;
     std::cout << "  # Run performance benchmark" << std::endl;
     std::cout << "  ./arbitrage_analyzer --benchmark" << std::endl;
     std::cout << std::endl;
@@ -155,6 +221,52 @@ int main(int argc, char* argv[]) {
         return 0;
     }
     
+    // Measure this host and save its machine profile
+    if (argc > 1 && std::string(argv[1]) == "--autotune") {
+        try {
+            const auto config = ArbitrageCLI::parseCommandLine(argc, argv);
+            const std::string path = config.machine_profile.empty() || config.machine_profile == "off"
+                ? MachineProfile::default_path() : config.machine_profile;
+            std::cout << "=== AUTOTUNING THIS HOST ===" << std::endl;
+            const MachineProfile profile = autotune_machine(&std::cout);
+            profile.save(path);
+            std::cout << "SIMD tier " << simd_tier_name(profile.simd_tier) << ", " << profile.threads
+                      << " threads, " << profile.pair_tile << "-stock pair tiles -> " << path << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    
+    // Merge the partial results of a sharded run
+    if (argc > 1 && std::string(argv[1]) == "merge") {
+        try {
+            auto config = ArbitrageCLI::parseCommandLine(argc, argv);
+            const auto shard_files = ArbitrageCLI::parseMergeFiles(argc, argv);
+            if (shard_files.empty() || !ConfigManager::validateConfig(config)) {
+                std::cerr << "Error: merge needs the shard result files and a valid configuration" << std::endl;
+                return 1;
+            }
+            ArbitrageAnalyzer::setProgressCallback(printProgressCallback);
+            std::filesystem::create_directories(config.output_directory);
+            
+            std::cout << "Merging " << shard_files.size() << " shard result files" << std::endl;
+            const bool success = ArbitrageAnalyzer::mergeShards(shard_files, config);
+            std::cout << std::endl; // Clear progress line
+            if (!success) {
+                std::cerr << "Merge failed. Check error messages above." << std::endl;
+                return 1;
+            }
+            printAnalysisResults(ArbitrageAnalyzer::getLastAnalysisMetrics());
+            std::cout << "Results exported to: " << config.output_directory << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    
     try {
         printSystemInfo();
         
@@ -173,6 +285,12 @@ int main(int argc, char* argv[]) {
             return 1;
         }
         
+        // Tuned settings of this host, before anything sizes a pool
+        const char* profile_status = "off";
+        if (config.machine_profile != "off") {
+            profile_status = profile_status_name(apply_machine_profile(config.machine_profile));
+        }
+        
         // Set up progress callback
         ArbitrageAnalyzer::setProgressCallback(printProgressCallback);
         
@@ -191,7 +309,9 @@ int main(int argc, char* argv[]) {
         std::cout << "  - Output directory: " << config.output_directory << std::endl;
         std::cout << "  - Min correlation threshold: " << config.min_correlation_threshold << std::endl;
         std::cout << "  - Max cointegration p-value: " << config.max_cointegration_pvalue << std::endl;
-        std::cout << "  - Number of threads: " << (config.num_threads == 0 ? "auto-detect" : std::to_string(config.num_threads)) << std::endl;
+        std::cout << "  - Number of threads: " << (config.num_threads == 0 ? std::to_string(tuned_threads()) + " (auto)" : std::to_string(config.num_threads)) << std::endl;
+        std::cout << "  - Machine profile: " << profile_status << " (SIMD tier " << simd_tier_name(active_simd_tier())
+                  << ", " << tuned_pair_tile() << "-stock pair tiles)" << std::endl;
         std::cout << "  - SIMD enabled: " << (config.enable_simd ? "YES" : "NO") << std::endl;
         std::cout << "  - Caching enabled: " << (config.enable_caching ? "YES" : "NO") << std::endl;
         std::cout << std::endl;
@@ -222,6 +342,7 @@ int main(int argc, char* argv[]) {
                 std::cout << "  - Cache hit rate: " << std::fixed << std::setprecision(1) 
                           << cache_stats.cache_hit_rate * 100 << "%" << std::endl;
                 std::cout << "  - Memory used: " << cache_stats.memory_used_mb << " MB" << std::endl;
+                std::cout << "  - Entries loaded: " << cache_stats.entries_loaded << std::endl;
             }
             
         } else {
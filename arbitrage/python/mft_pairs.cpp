@@ -0,0 +1,227 @@
+// mft_pairs: the pair statistics engine as a Python extension module.
+//
+//   import numpy as np, mft_pairs
+//   hits = mft_pairs.correlations(closes, min_correlation=0.8)
+//   tests = mft_pairs.cointegration(closes, pairs=zip(hits["i"], hits["j"]))
+//
+// `closes` is a sequence of close-price series, each any float64 buffer or
+// Arrow array (see mft_python.h); series are identified by their position.
+// The screens run with the GIL released, on the same tiled kernels and
+// work-stealing pool as arbitrage_analyzer, and every result column comes
+// back as a NumPy view (a memoryview without NumPy) over C++ vectors.
+#include "mft_python.h"
+#include "machine_profile.h"
+#include "simd_statistics.h"
+#include "stock_data.h"
+#include <algorithm>
+#include <string>
+
+namespace {
+
+// Stocks as the loader leaves them: returns, centered closes and ranks filled
+bool read_stocks(PyObject* closes, std::vector<StockData>& stocks) {
+    std::vector<std::vector<double, aligned_allocator<double, 32>>> series;
+    if (!py_read_series_list(closes, "closes", series)) return false;
+    stocks.resize(series.size());
+    for (size_t s = 0; s < series.size(); ++s) {
+        stocks[s].symbol = std::to_string(s);
+        stocks[s].close = std::move(series[s]);
+    }
+    return true;
+}
+
+void prepare_stocks(std::vector<StockData>& stocks, bool ranks = false) {
+    for (StockData& stock : stocks) {
+        stock.calculateReturns();
+        stock.calculateStatistics();
+        if (ranks) stock.calculateReturnRanks();
+    }
+}
+
+struct CorrelationColumns {
+    std::vector<long long> i, j;
+    std::vector<double> correlation;
+};
+
+PyObject* correlations(PyObject*, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"closes", "min_correlation", "on", "threads", nullptr};
+    PyObject* closes;
+    double min_correlation = -1.0;
+    const char* on = "returns";
+    unsigned threads = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$dsI:correlations", const_cast<char**>(keywords),
+                                     &closes, &min_correlation, &on, &threads)) {
+        return nullptr;
+    }
+    SIMDCorrelationAnalyzer::Series series;
+    const std::string on_name = on;
+    if (on_name == "returns") {
+        series = &StockData::returns;
+    } else if (on_name == "prices") {
+        series = &StockData::close;
+    } else if (on_name == "ranks") {
+        series = &StockData::return_ranks;
+    } else {
+        PyErr_Format(PyExc_ValueError, "on: expected 'returns', 'prices' or 'ranks', got '%s'", on);
+        return nullptr;
+    }
+    std::vector<StockData> stocks;
+    if (!read_stocks(closes, stocks)) return nullptr;
+
+    auto columns = std::make_unique<CorrelationColumns>();
+    CorrelationColumns& out = *columns;
+    const bool ok = py_without_gil([&] {
+        // The ranks are the screened series here, so every stock needs them
+        prepare_stocks(stocks, series == &StockData::return_ranks);
+        std::vector<const StockData*> pointers;
+        for (const StockData& stock : stocks) pointers.push_back(&stock);
+        auto pairs = SIMDCorrelationAnalyzer::correlatedPairs_SIMD(
+            pointers, series, min_correlation, threads ? threads : tuned_threads(), {});
+        std::sort(pairs.begin(), pairs.end(), [](const auto& a, const auto& b) {
+            return a.i != b.i ? a.i < b.i : a.j < b.j;
+        });
+        out.i.reserve(pairs.size());
+        out.j.reserve(pairs.size());
+        out.correlation.reserve(pairs.size());
+        for (const auto& pair : pairs) {
+            out.i.push_back(static_cast<long long>(pair.i));
+            out.j.push_back(static_cast<long long>(pair.j));
+            out.correlation.push_back(pair.correlation);
+        }
+    });
+    if (!ok) return nullptr;
+
+    PyObject* owner = py_owner(std::move(columns));
+    if (!owner) return nullptr;
+    PyObject* result = PyDict_New();
+    if (result && (!py_set_item(result, "i", py_column(owner, out.i)) ||
+                   !py_set_item(result, "j", py_column(owner, out.j)) ||
+                   !py_set_item(result, "correlation", py_column(owner, out.correlation)))) {
+        Py_CLEAR(result);
+    }
+    Py_DECREF(owner);
+    return result;
+}
+
+// One column per CointegrationResult field a notebook filters on
+#define COINTEGRATION_COLUMNS(X) \
+    X(adf_statistic) \
+    X(p_value) \
+    X(half_life) \
+    X(hedge_ratio) \
+    X(spread_mean) \
+    X(spread_std) \
+    X(current_spread) \
+    X(z_score) \
+    X(expected_return) \
+    X(sharpe_ratio) \
+    X(win_rate)
+
+struct CointegrationColumns {
+    std::vector<long long> i, j;
+#define COINTEGRATION_MEMBER(name) std::vector<double> name;
+    COINTEGRATION_COLUMNS(COINTEGRATION_MEMBER)
+#undef COINTEGRATION_MEMBER
+    std::vector<double> is_cointegrated;   // 1.0 / 0.0
+};
+
+// None = every pair i < j; else a sequence of (i, j) index pairs
+bool read_pairs(PyObject* object, size_t stocks, std::vector<std::pair<size_t, size_t>>& pairs) {
+    if (!object || object == Py_None) {
+        for (size_t i = 0; i < stocks; ++i) {
+            for (size_t j = i + 1; j < stocks; ++j) pairs.emplace_back(i, j);
+        }
+        return true;
+    }
+    PyObject* items = PySequence_Fast(object, "pairs: expected a sequence of (i, j)");
+    if (!items) return false;
+    bool ok = true;
+    for (Py_ssize_t k = 0; ok && k < PySequence_Fast_GET_SIZE(items); ++k) {
+        Py_ssize_t i = -1, j = -1;
+        PyObject* item = PySequence_Fast_GET_ITEM(items, k);
+        if (!PyTuple_Check(item)) {
+            PyErr_Format(PyExc_TypeError, "pairs[%zd]: expected an (i, j) tuple, got %s", k, Py_TYPE(item)->tp_name);
+            ok = false;
+            break;
+        }
+        ok = PyArg_ParseTuple(item, "nn;pairs: expected (i, j) index pairs", &i, &j);
+        if (ok && (i < 0 || j < 0 || static_cast<size_t>(i) >= stocks || static_cast<size_t>(j) >= stocks)) {
+            PyErr_Format(PyExc_IndexError, "pairs[%zd]: (%zd, %zd) is out of range for %zu series", k, i, j, stocks);
+            ok = false;
+        }
+        if (ok) pairs.emplace_back(static_cast<size_t>(i), static_cast<size_t>(j));
+    }
+    Py_DECREF(items);
+    return ok;
+}
+
+PyObject* cointegration(PyObject*, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"closes", "pairs", nullptr};
+    PyObject* closes;
+    PyObject* pairs_arg = nullptr;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O:cointegration", const_cast<char**>(keywords),
+                                     &closes, &pairs_arg)) {
+        return nullptr;
+    }
+    std::vector<StockData> stocks;
+    std::vector<std::pair<size_t, size_t>> pairs;
+    if (!read_stocks(closes, stocks) || !read_pairs(pairs_arg, stocks.size(), pairs)) return nullptr;
+
+    auto columns = std::make_unique<CointegrationColumns>();
+    CointegrationColumns& out = *columns;
+    const bool ok = py_without_gil([&] {
+        prepare_stocks(stocks);
+        std::vector<std::pair<const StockData*, const StockData*>> tested;
+        tested.reserve(pairs.size());
+        for (const auto& [i, j] : pairs) tested.emplace_back(&stocks[i], &stocks[j]);
+        const auto results = SIMDCointegrationAnalyzer::batchAnalyzeCointegration_SIMD(tested);
+        for (size_t p = 0; p < results.size(); ++p) {
+            const CointegrationResult& result = results[p];
+            out.i.push_back(static_cast<long long>(pairs[p].first));
+            out.j.push_back(static_cast<long long>(pairs[p].second));
+#define COINTEGRATION_PUSH(name) out.name.push_back(result.name);
+            COINTEGRATION_COLUMNS(COINTEGRATION_PUSH)
+#undef COINTEGRATION_PUSH
+            out.is_cointegrated.push_back(result.is_cointegrated ? 1.0 : 0.0);
+        }
+    });
+    if (!ok) return nullptr;
+
+    PyObject* owner = py_owner(std::move(columns));
+    if (!owner) return nullptr;
+    PyObject* result = PyDict_New();
+    bool filled = result && py_set_item(result, "i", py_column(owner, out.i)) &&
+                  py_set_item(result, "j", py_column(owner, out.j));
+#define COINTEGRATION_ITEM(name) filled = filled && py_set_item(result, #name, py_column(owner, out.name));
+    COINTEGRATION_COLUMNS(COINTEGRATION_ITEM)
+#undef COINTEGRATION_ITEM
+    filled = filled && py_set_item(result, "is_cointegrated", py_column(owner, out.is_cointegrated));
+    if (!filled) Py_CLEAR(result);
+    Py_DECREF(owner);
+    return result;
+}
+
+PyMethodDef methods[] = {
+    {"correlations", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(correlations)),
+     METH_VARARGS | METH_KEYWORDS,
+     "correlations(closes, *, min_correlation=-1.0, on='returns', threads=0)\n"
+     "Pearson correlation of every pair i < j of equal-length series ('returns', 'prices', or\n"
+     "'ranks' for Spearman), at or above min_correlation, as {'i', 'j', 'correlation'} columns."},
+    {"cointegration", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(cointegration)),
+     METH_VARARGS | METH_KEYWORDS,
+     "cointegration(closes, pairs=None)\n"
+     "Engle-Granger test of each (i, j) pair (default: every pair) as columns of the results."},
+    {nullptr, nullptr, 0, nullptr},
+};
+
+PyModuleDef module = {
+    PyModuleDef_HEAD_INIT, "mft_pairs",
+    "MFT pair statistics: correlation screens and cointegration tests over close-price series.",
+    -1, methods, nullptr, nullptr, nullptr, nullptr,
+};
+
+} // namespace
+
+PyMODINIT_FUNC PyInit_mft_pairs() {
+    return PyModule_Create(&module);
+}
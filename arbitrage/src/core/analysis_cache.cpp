@@ -0,0 +1,390 @@
+#include "analysis_cache.h"
+#include "analysis_cache_format.h"
+#include "binary_file.h"
+#include "memory_accounting.h"
+#include "stable_hash.h"
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+struct KeyHash {
+    size_t operator()(const AnalysisCacheKey& key) const {
+        return static_cast<size_t>(fnv1a(&key, sizeof(key)));
+    }
+};
+
+template <class Record>
+bool keyLess(const Record& record, const AnalysisCacheKey& key) {
+    return record.key < key;
+}
+
+// Loaded records (sorted, read-only, searched without a lock) and the
+// records added since, spread over shards by key
+template <class Record>
+class ResultTable {
+public:
+    bool find(const AnalysisCacheKey& key, Record& record) const {
+        const Shard& shard = shards_[KeyHash{}(key) % AnalysisCache::kShards];
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex, std::defer_lock);
+            lock_traced(lock, "wait: cache shard");
+            auto it = shard.entries.find(key);
+            if (it != shard.entries.end()) {
+                record = it->second;
+                return true;
+            }
+        }
+        const Record* end = loaded_ + loaded_count_;
+        const Record* it = std::lower_bound(loaded_, end, key, keyLess<Record>);
+        if (it == end || !(it->key == key)) return false;
+        record = *it;
+        return true;
+    }
+    
+    void store(const Record& record) {
+        Shard& shard = shards_[KeyHash{}(record.key) % AnalysisCache::kShards];
+        std::unique_lock<std::shared_mutex> lock(shard.mutex, std::defer_lock);
+        lock_traced(lock, "wait: cache shard");
+        shard.entries[record.key] = record;
+    }
+    
+    void attach(const Record* records, size_t count) {
+        loaded_ = records;
+        loaded_count_ = count;
+    }
+    
+    void clear() {
+        for (Shard& shard : shards_) {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            shard.entries.clear();
+        }
+        attach(nullptr, 0);
+    }
+    
+    size_t loadedCount() const { return loaded_count_; }
+    
+    size_t addedCount() const {
+        size_t count = 0;
+        for (const Shard& shard : shards_) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            count += shard.entries.size();
+        }
+        return count;
+    }
+    
+    // Every record sorted by key; an added record replaces a loaded one
+    std::vector<Record> merged() const {
+        std::vector<Record> added;
+        for (const Shard& shard : shards_) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            for (const auto& entry : shard.entries) added.push_back(entry.second);
+        }
+        auto by_key = [](const Record& a, const Record& b) { return a.key < b.key; };
+        std::sort(added.begin(), added.end(), by_key);
+        
+        std::vector<Record> records;
+        records.reserve(loaded_count_ + added.size());
+        const Record* loaded = loaded_;
+        const Record* loaded_end = loaded_ + loaded_count_;
+        for (const Record& record : added) {
+            while (loaded != loaded_end && loaded->key < record.key) records.push_back(*loaded++);
+            if (loaded != loaded_end && loaded->key == record.key) ++loaded;
+            records.push_back(record);
+        }
+        records.insert(records.end(), loaded, loaded_end);
+        return records;
+    }
+
+private:
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<AnalysisCacheKey, Record, KeyHash, std::equal_to<AnalysisCacheKey>,
+                           TrackingAllocator<std::pair<const AnalysisCacheKey, Record>, MemorySubsystem::Caches>> entries;
+    };
+    
+    Shard shards_[AnalysisCache::kShards];
+    const Record* loaded_ = nullptr;
+    size_t loaded_count_ = 0;
+};
+
+struct CacheState {
+    ResultTable<CachedCointegration> cointegration;
+    ResultTable<CachedCorrelation> correlation;
+    std::unique_ptr<MappedFile> file;   // backs the loaded records
+    std::atomic<size_t> cointegration_hits{0};
+    std::atomic<size_t> cointegration_misses{0};
+    std::atomic<size_t> correlation_hits{0};
+    std::atomic<size_t> correlation_misses{0};
+};
+
+CacheState& state() {
+    static CacheState cache;
+    return cache;
+}
+
+void copyGrade(const std::string& grade, char (&out)[8]) {
+    std::memset(out, 0, sizeof(out));
+    std::memcpy(out, grade.data(), std::min(grade.size(), sizeof(out) - 1));
+}
+
+std::string readGrade(const char (&grade)[8]) {
+    return std::string(grade, strnlen(grade, sizeof(grade)));
+}
+
+}
+
+void toRecord(const CointegrationResult& result, CachedCointegration& record) {
+    record.adf_statistic = result.adf_statistic;
+    record.p_value = result.p_value;
+    record.critical_value_1pct = result.critical_value_1pct;
+    record.critical_value_5pct = result.critical_value_5pct;
+    record.critical_value_10pct = result.critical_value_10pct;
+    record.half_life = result.half_life;
+    record.hedge_ratio = result.hedge_ratio;
+    record.spread_mean = result.spread_mean;
+    record.spread_std = result.spread_std;
+    record.max_spread = result.max_spread;
+    record.min_spread = result.min_spread;
+    record.current_spread = result.current_spread;
+    record.z_score = result.z_score;
+    record.entry_threshold = result.entry_threshold;
+    record.exit_threshold = result.exit_threshold;
+    record.expected_return = result.expected_return;
+    record.sharpe_ratio = result.sharpe_ratio;
+    record.win_rate = result.win_rate;
+    record.num_trades_historical = result.num_trades_historical;
+    record.is_cointegrated = result.is_cointegrated ? 1 : 0;
+    copyGrade(result.cointegration_grade, record.grade);
+}
+
+void fromRecord(const CachedCointegration& record, CointegrationResult& result) {
+    result.adf_statistic = record.adf_statistic;
+    result.p_value = record.p_value;
+    result.critical_value_1pct = record.critical_value_1pct;
+    result.critical_value_5pct = record.critical_value_5pct;
+    result.critical_value_10pct = record.critical_value_10pct;
+    result.half_life = record.half_life;
+    result.hedge_ratio = record.hedge_ratio;
+    result.spread_mean = record.spread_mean;
+    result.spread_std = record.spread_std;
+    result.max_spread = record.max_spread;
+    result.min_spread = record.min_spread;
+    result.current_spread = record.current_spread;
+    result.z_score = record.z_score;
+    result.cointegration_grade = readGrade(record.grade);
+    result.is_cointegrated = record.is_cointegrated != 0;
+    result.entry_threshold = record.entry_threshold;
+    result.exit_threshold = record.exit_threshold;
+    result.expected_return = record.expected_return;
+    result.sharpe_ratio = record.sharpe_ratio;
+    result.num_trades_historical = record.num_trades_historical;
+    result.win_rate = record.win_rate;
+}
+
+void toRecord(const CorrelationResult& result, CachedCorrelation& record) {
+    record.pearson_correlation = result.pearson_correlation;
+    record.spearman_correlation = result.spearman_correlation;
+    record.kendall_tau = result.kendall_tau;
+    record.rolling_correlation_30d = result.rolling_correlation_30d;
+    record.rolling_correlation_60d = result.rolling_correlation_60d;
+    record.correlation_stability = result.correlation_stability;
+    record.correlation_breakdown_count = result.correlation_breakdown_count;
+    record.min_correlation = result.min_correlation;
+    record.max_correlation = result.max_correlation;
+    record.price1 = result.price1;
+    record.price2 = result.price2;
+    record.same_sector = result.same_sector ? 1 : 0;
+    record.affordable_pair = result.affordable_pair ? 1 : 0;
+    copyGrade(result.correlation_grade, record.grade);
+}
+
+void fromRecord(const CachedCorrelation& record, CorrelationResult& result) {
+    result.pearson_correlation = record.pearson_correlation;
+    result.spearman_correlation = record.spearman_correlation;
+    result.kendall_tau = record.kendall_tau;
+    result.rolling_correlation_30d = record.rolling_correlation_30d;
+    result.rolling_correlation_60d = record.rolling_correlation_60d;
+    result.correlation_stability = record.correlation_stability;
+    result.correlation_breakdown_count = record.correlation_breakdown_count;
+    result.min_correlation = record.min_correlation;
+    result.max_correlation = record.max_correlation;
+    result.correlation_grade = readGrade(record.grade);
+    result.same_sector = record.same_sector != 0;
+    result.price1 = record.price1;
+    result.price2 = record.price2;
+    result.affordable_pair = record.affordable_pair != 0;
+}
+
+uint64_t AnalysisCache::symbolId(const std::string& symbol) {
+    return fnv1a(symbol.data(), symbol.size());
+}
+
+AnalysisCacheKey AnalysisCache::makeKey(const StockData& stock1, const StockData& stock2, uint64_t parameters) {
+    const uint64_t content[2] = {
+        stock1.content_hash != 0 ? stock1.content_hash : stock1.contentHash(),
+        stock2.content_hash != 0 ? stock2.content_hash : stock2.contentHash()
+    };
+    return {symbolId(stock1.symbol), symbolId(stock2.symbol), fnv1a(content, sizeof(content)), parameters};
+}
+
+uint64_t AnalysisCache::hashParameters(const std::vector<double>& values) {
+    return fnv1a(values.data(), values.size() * sizeof(double));
+}
+
+void AnalysisCache::cacheCointegrationResult(
+    const StockData& stock1,
+    const StockData& stock2,
+    uint64_t parameters,
+    const CointegrationResult& result) {
+    
+    CachedCointegration record{};
+    record.key = makeKey(stock1, stock2, parameters);
+    toRecord(result, record);
+    state().cointegration.store(record);
+}
+
+bool AnalysisCache::getCachedCointegrationResult(
+    const StockData& stock1,
+    const StockData& stock2,
+    uint64_t parameters,
+    CointegrationResult& result) {
+    
+    CacheState& cache = state();
+    CachedCointegration record;
+    if (!cache.cointegration.find(makeKey(stock1, stock2, parameters), record)) {
+        ++cache.cointegration_misses;
+        return false;
+    }
+    ++cache.cointegration_hits;
+    
+    fromRecord(record, result);
+    result.stock1 = stock1.symbol;
+    result.stock2 = stock2.symbol;
+    return true;
+}
+
+void AnalysisCache::cacheCorrelationResult(
+    const StockData& stock1,
+    const StockData& stock2,
+    uint64_t parameters,
+    const CorrelationResult& result) {
+    
+    CachedCorrelation record{};
+    record.key = makeKey(stock1, stock2, parameters);
+    toRecord(result, record);
+    state().correlation.store(record);
+}
+
+bool AnalysisCache::getCachedCorrelationResult(
+    const StockData& stock1,
+    const StockData& stock2,
+    uint64_t parameters,
+    CorrelationResult& result) {
+    
+    CacheState& cache = state();
+    CachedCorrelation record;
+    if (!cache.correlation.find(makeKey(stock1, stock2, parameters), record)) {
+        ++cache.correlation_misses;
+        return false;
+    }
+    ++cache.correlation_hits;
+    
+    fromRecord(record, result);
+    result.stock1 = stock1.symbol;
+    result.stock2 = stock2.symbol;
+    result.sector1 = stock1.sector;
+    result.sector2 = stock2.sector;
+    return true;
+}
+
+void AnalysisCache::clearCache() {
+    CacheState& cache = state();
+    cache.cointegration.clear();
+    cache.correlation.clear();
+    cache.file.reset();
+    cache.cointegration_hits = 0;
+    cache.cointegration_misses = 0;
+    cache.correlation_hits = 0;
+    cache.correlation_misses = 0;
+}
+
+size_t AnalysisCache::getCacheSize() {
+    const CacheState& cache = state();
+    return cache.cointegration.loadedCount() + cache.cointegration.addedCount() +
+           cache.correlation.loadedCount() + cache.correlation.addedCount();
+}
+
+void AnalysisCache::saveCacheToFile(const std::string& cache_file) {
+    const CacheState& cache = state();
+    const auto cointegration = cache.cointegration.merged();
+    const auto correlation = cache.correlation.merged();
+    
+    AnalysisCacheHeader header{};
+    stampHeader(header, kAnalysisCacheMagic, kAnalysisCacheVersion);
+    header.cointegration_record_size = sizeof(CachedCointegration);
+    header.correlation_record_size = sizeof(CachedCorrelation);
+    header.cointegration_count = cointegration.size();
+    header.cointegration_offset = sizeof(AnalysisCacheHeader);
+    header.correlation_count = correlation.size();
+    header.correlation_offset = header.cointegration_offset + cointegration.size() * sizeof(CachedCointegration);
+    
+    AtomicFileWriter file(cache_file, "analysis cache");
+    file.write(&header, sizeof(header));
+    file.write(cointegration.data(), cointegration.size() * sizeof(CachedCointegration));
+    file.write(correlation.data(), correlation.size() * sizeof(CachedCorrelation));
+    file.commit();
+}
+
+void AnalysisCache::loadCacheFromFile(const std::string& cache_file) {
+    CacheState& cache = state();
+    cache.cointegration.attach(nullptr, 0);
+    cache.correlation.attach(nullptr, 0);
+    cache.file.reset();
+    
+    auto file = mapBinaryFile<AnalysisCacheHeader>(cache_file, kAnalysisCacheMagic, kAnalysisCacheVersion);
+    if (!file) return;
+    
+    const size_t size = file->size();
+    const auto* header = reinterpret_cast<const AnalysisCacheHeader*>(file->data());
+    if (header->cointegration_record_size != sizeof(CachedCointegration) ||
+        header->correlation_record_size != sizeof(CachedCorrelation)) return;
+    
+    auto section_fits = [&](uint64_t offset, uint64_t count, size_t record_size) {
+        return offset % alignof(AnalysisCacheKey) == 0 && offset <= size &&
+               count <= (size - offset) / record_size;
+    };
+    if (!section_fits(header->cointegration_offset, header->cointegration_count, sizeof(CachedCointegration)) ||
+        !section_fits(header->correlation_offset, header->correlation_count, sizeof(CachedCorrelation))) return;
+    
+    cache.cointegration.attach(reinterpret_cast<const CachedCointegration*>(file->data() + header->cointegration_offset),
+                               header->cointegration_count);
+    cache.correlation.attach(reinterpret_cast<const CachedCorrelation*>(file->data() + header->correlation_offset),
+                             header->correlation_count);
+    cache.file = std::move(file);
+}
+
+AnalysisCache::CacheStats AnalysisCache::getCacheStats() {
+    const CacheState& cache = state();
+    CacheStats stats;
+    stats.cointegration_cache_hits = cache.cointegration_hits;
+    stats.cointegration_cache_misses = cache.cointegration_misses;
+    stats.correlation_cache_hits = cache.correlation_hits;
+    stats.correlation_cache_misses = cache.correlation_misses;
+    const size_t hits = stats.cointegration_cache_hits + stats.correlation_cache_hits;
+    const size_t lookups = hits + stats.cointegration_cache_misses + stats.correlation_cache_misses;
+    stats.cache_hit_rate = lookups > 0 ? static_cast<double>(hits) / lookups : 0.0;
+    stats.entries_loaded = cache.cointegration.loadedCount() + cache.correlation.loadedCount();
+    // The mapped file plus the added entries' hash tables, nodes and buckets included
+    const size_t bytes = (cache.file ? cache.file->size() : 0) + memory_usage(MemorySubsystem::Caches).live_bytes;
+    stats.memory_used_mb = bytes >> 20;
+    return stats;
+}
@@ -1,6 +1,20 @@
 #include "arbitrage_analyzer.h"
+#include "tiled_matrix_writer.h"
+#include "gpu_correlation.h"
+#include "hardware_counters.h"
+#include "machine_profile.h"
+#include "memory_accounting.h"
+#include "numa_topology.h"
+#include "trace.h"
+#include "work_stealing_pool.h"
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <chrono>
+#include <cmath>
+#include <deque>
+#include <optional>
+#include <unordered_map>
 
 // Static member initialization
 ArbitrageAnalyzer::AnalysisMetrics ArbitrageAnalyzer::last_metrics_;
@@ -10,11 +24,181 @@ std::mutex ArbitrageAnalyzer::progress_mutex_;
 std::atomic<size_t> ArbitrageAnalyzer::pairs_completed_{0};
 std::atomic<size_t> ArbitrageAnalyzer::total_pairs_{0};
 
-// AnalysisCache static member initialization
-std::unordered_map<std::string, CointegrationResult> AnalysisCache::cointegration_cache_;
-std::unordered_map<std::string, CorrelationResult> AnalysisCache::correlation_cache_;
-AnalysisCache::CacheStats AnalysisCache::cache_stats_;
-std::mutex AnalysisCache::cache_mutex_;
+namespace {
+
+// Settings the cached cointegration results depend on: the analysis
+// revision (bump it when the test changes), its significance level and
+// whether the legs were cut to their common calendar bars
+const uint64_t kCointegrationParameters = AnalysisCache::hashParameters({1.0, 0.05, 0.0});
+const uint64_t kAlignedCointegrationParameters = AnalysisCache::hashParameters({1.0, 0.05, 1.0});
+
+// One stage of runFullAnalysis: a trace span, a memory stage and, when
+// enabled, hardware counters under "stage: <name>"
+struct StageScope {
+    explicit StageScope(const char* name) : span(name, "stage"), counters(std::string("stage: ") + name), memory(name) {}
+    TraceSpan span;
+    ScopedCounters counters;
+    MemoryScope memory;
+};
+
+// Only cointegrated pairs that meet our criteria are kept
+bool meetsCriteria(const CointegrationResult& result, const ArbitrageAnalyzer::AnalysisConfig& config) {
+    return result.is_cointegrated &&
+           result.p_value <= config.max_cointegration_pvalue &&
+           result.half_life > 0 && result.half_life < 100;
+}
+
+std::string cacheFile(const ArbitrageAnalyzer::AnalysisConfig& config) {
+    return config.cache_file.empty() ? config.output_directory + "analysis_cache.mfta" : config.cache_file;
+}
+
+std::string snapshotFile(const ArbitrageAnalyzer::AnalysisConfig& config) {
+    if (!config.use_snapshot) return {};
+    return config.snapshot_file.empty() ? config.output_directory + "stock_snapshot.mfss" : config.snapshot_file;
+}
+
+// Whether stocks i and j can pair: bar by bar when they hold the same bars
+// (or either has no calendar mapping and their lengths match), otherwise on
+// at least min_points common bars of the calendar
+bool pairable(const std::vector<std::unique_ptr<StockData>>& stocks, const TradingCalendar* calendar,
+              size_t i, size_t j, size_t min_points) {
+    if (calendar && calendar->needsAlignment(i, j)) {
+        return calendar->commonBarCount(i, j) >= min_points;
+    }
+    return stocks[i]->size() == stocks[j]->size();
+}
+
+// The rules of isValidPair that involve both stocks, given eligibleStocks(),
+// and the clustered universe when there is one
+bool validPair(const std::vector<std::unique_ptr<StockData>>& stocks, const ArbitrageAnalyzer::AnalysisConfig& config,
+               const TradingCalendar* calendar, const PairUniverse* universe, const std::vector<unsigned char>& eligible,
+               size_t i, size_t j, size_t min_points) {
+    return eligible[i] && eligible[j] &&
+           (!config.require_same_sector || stocks[i]->sector == stocks[j]->sector) &&
+           (!universe || universe->contains(i, j)) &&
+           pairable(stocks, calendar, i, j, min_points);
+}
+
+std::string matrixFile(const ArbitrageAnalyzer::AnalysisConfig& config) {
+    return config.matrix_file.empty() ? config.output_directory + "pair_matrix.mftm" : config.matrix_file;
+}
+
+std::string shardFile(const ArbitrageAnalyzer::AnalysisConfig& config) {
+    return config.shard_file.empty() ?
+        config.output_directory + "shard_" + std::to_string(config.shard_index) + "_of_" +
+            std::to_string(config.shard_count) + ".mfsr" :
+        config.shard_file;
+}
+
+// [begin, end) of `total` items in order that this shard takes; slices
+// differ by at most one item
+std::pair<size_t, size_t> shardSlice(size_t total, const ArbitrageAnalyzer::AnalysisConfig& config) {
+    return {total * config.shard_index / config.shard_count,
+            total * (config.shard_index + 1) / config.shard_count};
+}
+
+// The part of a correlation screen this shard computes: its round-robin
+// share of the Gram tiles, and a hashed share of the pairs that need
+// calendar alignment (their tiles follow the tuned tile size, which may
+// differ between nodes)
+SIMDCorrelationAnalyzer::TileShard tileShard(const ArbitrageAnalyzer::AnalysisConfig& config) {
+    return {config.shard_index, std::max(1u, config.shard_count)};
+}
+
+bool ownsAlignedPair(const ArbitrageAnalyzer::AnalysisConfig& config, size_t i, size_t j) {
+    if (config.shard_count <= 1) return true;
+    uint64_t key = (static_cast<uint64_t>(i) << 32 | j) * 0x9e3779b97f4a7c15ULL;
+    key ^= key >> 32;
+    return key % config.shard_count == config.shard_index;
+}
+
+// Most significant (lowest p-value) first; ties by symbol so the order does
+// not depend on which worker or shard found a pair
+void rankCointegration(std::vector<CointegrationResult>& results) {
+    std::sort(results.begin(), results.end(),
+              [](const CointegrationResult& a, const CointegrationResult& b) {
+                  if (a.p_value != b.p_value) return a.p_value < b.p_value;
+                  if (a.stock1 != b.stock1) return a.stock1 < b.stock1;
+                  return a.stock2 < b.stock2;
+              });
+}
+
+// Strongest correlation first; ties by symbol for a stable order
+void rankCorrelation(std::vector<CorrelationResult>& results) {
+    std::sort(results.begin(), results.end(),
+              [](const CorrelationResult& a, const CorrelationResult& b) {
+                  if (a.pearson_correlation != b.pearson_correlation) {
+                      return a.pearson_correlation > b.pearson_correlation;
+                  }
+                  if (a.stock1 != b.stock1) return a.stock1 < b.stock1;
+                  return a.stock2 < b.stock2;
+              });
+}
+
+// Comma-separated numbers, e.g. "1.5,2,2.5"
+std::vector<double> parseNumberList(const std::string& text) {
+    std::vector<double> values;
+    for (size_t begin = 0; begin <= text.size();) {
+        const size_t comma = std::min(text.find(',', begin), text.size());
+        values.push_back(std::stod(text.substr(begin, comma - begin)));
+        begin = comma + 1;
+    }
+    return values;
+}
+
+std::string stateFile(const ArbitrageAnalyzer::AnalysisConfig& config) {
+    return config.state_file.empty() ? config.output_directory + "incremental_state.mfts" : config.state_file;
+}
+
+// A watched pair's state with its legs the other way round
+PairState swappedLegs(PairState state) {
+    std::swap(state.symbol1, state.symbol2);
+    std::swap(state.last_close1, state.last_close2);
+    for (PairMoments* moments : {&state.returns, &state.closes}) {
+        std::swap(moments->mean1, moments->mean2);
+        std::swap(moments->m2_1, moments->m2_2);
+    }
+    return state;
+}
+
+// Adds to a pair's screen moments the common bars after the last one they
+// cover: calendar bars past its timestamp, or positions past its count
+void extendPairState(PairState& state, const StockData& stock1, size_t i, const StockData& stock2, size_t j,
+                     const TradingCalendar* calendar, std::vector<uint32_t>& index1, std::vector<uint32_t>& index2) {
+    if (state.on_calendar) {
+        const size_t from = state.common_bars == 0 ? 0 :
+            calendar->barAfter(TradingCalendar::time_point(TradingCalendar::time_point::duration(state.last_timestamp)));
+        calendar->commonBars(i, j, index1, index2, from);
+    } else {
+        index1.clear();
+        index2.clear();
+        for (size_t bar = state.common_bars; bar < std::min(stock1.size(), stock2.size()); ++bar) {
+            index1.push_back(static_cast<uint32_t>(bar));
+            index2.push_back(static_cast<uint32_t>(bar));
+        }
+    }
+    
+    // Returns as StockData::calculateReturns has them
+    auto simple_return = [](double close, double previous) {
+        return previous != 0.0 ? (close - previous) / previous : 0.0;
+    };
+    for (size_t k = 0; k < index1.size(); ++k) {
+        const double close1 = stock1.close[index1[k]];
+        const double close2 = stock2.close[index2[k]];
+        if (state.common_bars > 0) {
+            state.returns.add(simple_return(close1, state.last_close1), simple_return(close2, state.last_close2));
+        }
+        state.closes.add(close1, close2);
+        state.last_close1 = close1;
+        state.last_close2 = close2;
+        ++state.common_bars;
+    }
+    if (state.on_calendar && !index1.empty()) {
+        state.last_timestamp = stock1.timestamps[index1.back()].time_since_epoch().count();
+    }
+}
+
+}
 
 bool ArbitrageAnalyzer::runFullAnalysis() {
     return runFullAnalysis(ConfigManager::createDefaultConfig());
@@ -26,11 +210,22 @@ bool ArbitrageAnalyzer::runFullAnalysis(const AnalysisConfig& config) {
     try {
         // Reset metrics
         last_metrics_ = AnalysisMetrics{};
+        GpuCorrelation::setEnabled(config.enable_gpu);
+        set_numa_placement(config.numa_placement);
+        set_numa_replication(config.numa_replicate_returns);
+        set_hardware_counters(config.hardware_counters);
+        reset_counter_report();
+        reset_memory_report();
+        set_tracing(!config.trace_file.empty());
+        reset_trace();
+        std::optional<TraceSpan> analysis_span(std::in_place, "analysis", "run");
         
         reportProgress("Loading Data", 0.0);
         
         // Load stock data
+        std::optional<StageScope> stage(std::in_place, "load");
         auto stocks = loadStockData(config);
+        stage.reset();
         if (stocks.empty()) {
             std::cerr << "No stock data loaded" << std::endl;
             return false;
@@ -39,30 +234,93 @@ bool ArbitrageAnalyzer::runFullAnalysis(const AnalysisConfig& config) {
         last_metrics_.stocks_loaded = stocks.size();
         reportProgress("Loading Data", 100.0);
         
+        if (config.enable_caching) {
+            AnalysisCache::loadCacheFromFile(cacheFile(config));
+        }
+        
+        // One master calendar serves both pair scans
+        std::optional<TradingCalendar> calendar;
+        if (config.align_calendar) {
+            TraceSpan span("trading calendar");
+            calendar.emplace(stocks);
+            last_metrics_.calendar_bars = calendar->size();
+        }
+        const TradingCalendar* shared_calendar = calendar ? &*calendar : nullptr;
+        
+        // One clustering narrows both pair scans
+        std::optional<PairUniverse> universe;
+        if (config.cluster_universe) {
+            reportProgress("Clustering Universe", 0.0);
+            stage.emplace("universe");
+            universe.emplace(clusterUniverse(stocks, config, shared_calendar));
+            stage.reset();
+            reportProgress("Clustering Universe", 100.0);
+        }
+        const PairUniverse* shared_universe = universe ? &*universe : nullptr;
+        
         reportProgress("Analyzing Cointegration", 0.0);
         
         // Analyze cointegration
-        auto cointegration_results = analyzeCointegration(stocks, config);
+        stage.emplace("cointegration");
+        auto cointegration_results = analyzeCointegration(stocks, config, shared_calendar, shared_universe);
+        stage.reset();
         last_metrics_.cointegrated_pairs_found = cointegration_results.size();
         
         reportProgress("Analyzing Correlation", 0.0);
         
         // Analyze correlation
-        auto correlation_results = analyzeCorrelation(stocks, config);
+        stage.emplace("correlation");
+        auto correlation_results = analyzeCorrelation(stocks, config, shared_calendar, shared_universe);
+        stage.reset();
+        // The screens are done; free the matrices they left on the device
+        GpuCorrelation::release();
         last_metrics_.high_correlation_pairs_found = correlation_results.size();
         
-        reportProgress("Generating Opportunities", 0.0);
-        
-        // Generate opportunities
-        auto opportunities = generateOpportunities(cointegration_results, correlation_results, config);
-        last_metrics_.arbitrage_opportunities_found = opportunities.size();
-        
-        reportProgress("Exporting Results", 0.0);
-        
-        // Export results
-        bool export_success = exportResults(cointegration_results, correlation_results, opportunities, config);
+        bool export_success = false;
+        stage.emplace("opportunities and export");
+        if (config.shard_count > 1) {
+            // Opportunities need every shard's pairs; mergeShards() joins them
+            reportProgress("Writing Shard Results", 0.0);
+            ShardResults shard;
+            shard.shard_index = config.shard_index;
+            shard.shard_count = config.shard_count;
+            shard.pairs_analyzed = last_metrics_.total_pairs_analyzed;
+            shard.cointegration = std::move(cointegration_results);
+            shard.correlation = std::move(correlation_results);
+            last_metrics_.shard_file = shardFile(config);
+            shard.save(last_metrics_.shard_file);
+            export_success = true;
+        } else {
+            reportProgress("Generating Opportunities", 0.0);
+            
+            // Generate opportunities
+            auto opportunities = generateOpportunities(cointegration_results, correlation_results, config);
+            last_metrics_.arbitrage_opportunities_found = opportunities.size();
+            
+            reportProgress("Exporting Results", 0.0);
+            
+            // Export results
+            export_success = exportResults(cointegration_results, correlation_results, opportunities, config);
+            if (config.backtest) {
+                export_success = backtestGrid(stocks, cointegration_results, config, shared_calendar) && export_success;
+            }
+            if (config.export_matrix) {
+                reportProgress("Exporting Pair Matrix", 0.0);
+                export_success = exportMatrix(stocks, cointegration_results, config, shared_calendar) && export_success;
+            }
+        }
         last_metrics_.export_successful = export_success;
         
+        if (config.enable_caching) {
+            AnalysisCache::saveCacheToFile(cacheFile(config));
+        }
+        stage.reset();
+        analysis_span.reset();
+        if (!config.trace_file.empty()) {
+            write_chrome_trace(config.trace_file);
+            last_metrics_.trace_file = config.trace_file;
+        }
+        
         reportProgress("Complete", 100.0);
         
         // Calculate final metrics
@@ -83,13 +341,81 @@ bool ArbitrageAnalyzer::runFullAnalysis(const AnalysisConfig& config) {
     }
 }
 
+bool ArbitrageAnalyzer::mergeShards(const std::vector<std::string>& shard_files, const AnalysisConfig& config) {
+    analysis_start_time_ = std::chrono::high_resolution_clock::now();
+    last_metrics_ = AnalysisMetrics{};
+    
+    try {
+        reportProgress("Merging Shards", 0.0);
+        
+        std::vector<CointegrationResult> cointegration_results;
+        std::vector<CorrelationResult> correlation_results;
+        std::vector<unsigned char> seen;
+        for (const auto& path : shard_files) {
+            ShardResults shard;
+            if (!shard.load(path)) {
+                std::cerr << "Cannot read shard results: " << path << std::endl;
+                return false;
+            }
+            if (seen.empty()) seen.assign(shard.shard_count, 0);
+            if (shard.shard_count != seen.size() || seen[shard.shard_index]) {
+                std::cerr << "Shard " << shard.shard_index << "/" << shard.shard_count << " in " << path
+                          << " does not belong to this merge" << std::endl;
+                return false;
+            }
+            seen[shard.shard_index] = 1;
+            last_metrics_.total_pairs_analyzed += shard.pairs_analyzed;
+            std::move(shard.cointegration.begin(), shard.cointegration.end(), std::back_inserter(cointegration_results));
+            std::move(shard.correlation.begin(), shard.correlation.end(), std::back_inserter(correlation_results));
+        }
+        const size_t missing = std::count(seen.begin(), seen.end(), 0);
+        if (seen.empty() || missing > 0) {
+            std::cerr << "Shard merge needs every shard of the run; " << (seen.empty() ? 0 : missing)
+                      << " missing" << std::endl;
+            return false;
+        }
+        
+        rankCointegration(cointegration_results);
+        rankCorrelation(correlation_results);
+        last_metrics_.cointegrated_pairs_found = cointegration_results.size();
+        last_metrics_.high_correlation_pairs_found = correlation_results.size();
+        reportProgress("Merging Shards", 100.0);
+        
+        reportProgress("Generating Opportunities", 0.0);
+        auto opportunities = generateOpportunities(cointegration_results, correlation_results, config);
+        last_metrics_.arbitrage_opportunities_found = opportunities.size();
+        
+        reportProgress("Exporting Results", 0.0);
+        const bool export_success = exportResults(cointegration_results, correlation_results, opportunities, config);
+        last_metrics_.export_successful = export_success;
+        reportProgress("Complete", 100.0);
+        
+        auto end_time = std::chrono::high_resolution_clock::now();
+        last_metrics_.total_time_seconds = std::chrono::duration<double>(end_time - analysis_start_time_).count();
+        auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        last_metrics_.analysis_timestamp = std::ctime(&now);
+        return export_success;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Shard merge failed: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 std::vector<std::unique_ptr<StockData>> ArbitrageAnalyzer::loadStockData(const AnalysisConfig& config) {
-    return FastCSVLoader::loadAllStocks(config.input_data_directory, config.portfolio_constraints);
+    auto stocks = FastCSVLoader::loadAllStocks(config.input_data_directory, config.portfolio_constraints,
+                                               snapshotFile(config));
+    const auto loading = FastCSVLoader::getLastLoadingMetrics();
+    last_metrics_.loading_time_seconds = loading.loading_time_seconds;
+    last_metrics_.stocks_from_snapshot = loading.snapshot_hits;
+    return stocks;
 }
 
 std::vector<CointegrationResult> ArbitrageAnalyzer::analyzeCointegration(
     const std::vector<std::unique_ptr<StockData>>& stocks,
-    const AnalysisConfig& config) {
+    const AnalysisConfig& config,
+    const TradingCalendar* calendar,
+    const PairUniverse* universe) {
     
     std::vector<CointegrationResult> results;
     
@@ -97,115 +423,260 @@ std::vector<CointegrationResult> ArbitrageAnalyzer::analyzeCointegration(
         return results;
     }
     
-    // Generate all possible pairs for analysis
-    std::vector<std::pair<const StockData*, const StockData*>> stock_pairs;
-    
-    size_t max_pairs = config.max_pairs_to_analyze > 0 ? 
-                      static_cast<size_t>(config.max_pairs_to_analyze) : 
-                      stocks.size() * (stocks.size() - 1) / 2;
+    auto start_time = std::chrono::high_resolution_clock::now();
     
-    size_t pairs_generated = 0;
-    
-    for (size_t i = 0; i < stocks.size() && pairs_generated < max_pairs; ++i) {
-        for (size_t j = i + 1; j < stocks.size() && pairs_generated < max_pairs; ++j) {
-            if (stocks[i] && stocks[j]) {
-                // Check if pair meets basic criteria
-                if (isValidPair(*stocks[i], *stocks[j], config)) {
-                    stock_pairs.emplace_back(stocks[i].get(), stocks[j].get());
-                    pairs_generated++;
-                }
-            }
-        }
+    std::optional<TradingCalendar> own_calendar;
+    if (!config.align_calendar) {
+        calendar = nullptr;
+    } else if (!calendar) {
+        calendar = &own_calendar.emplace(stocks);
+    }
+    std::optional<PairUniverse> own_universe;
+    if (!config.cluster_universe) {
+        universe = nullptr;
+    } else if (!universe) {
+        universe = &own_universe.emplace(clusterUniverse(stocks, config, calendar));
     }
-    
-    total_pairs_ = stock_pairs.size();
-    pairs_completed_ = 0;
     
     reportProgress("Analyzing Cointegration", 0.0);
     
-    // Analyze pairs in parallel using enhanced cointegration analyzer
-    if (config.num_threads > 1) {
-        results = analyzeCointegrationParallel(stocks, config);
-    } else {
-        // Sequential analysis
-        results.reserve(stock_pairs.size());
-        
-        for (size_t i = 0; i < stock_pairs.size(); ++i) {
-            auto result = SIMDCointegrationAnalyzer::analyzeCointegration_SIMD(
-                *stock_pairs[i].first, *stock_pairs[i].second);
-            
-            // Only keep cointegrated pairs that meet our criteria
-            if (result.is_cointegrated && 
-                result.p_value <= config.max_cointegration_pvalue &&
-                result.half_life > 0 && result.half_life < 100) {
-                results.push_back(result);
-            }
-            
-            pairs_completed_++;
-            if (i % 100 == 0) {
-                double progress = static_cast<double>(i) / stock_pairs.size() * 100.0;
-                reportProgress("Analyzing Cointegration", progress);
-            }
-        }
+    // One thread runs the same tiled scan inline
+    results = analyzeCointegrationParallel(stocks, config, calendar, universe);
+    
+    if (config.empirical_pvalues && !results.empty()) {
+        results = resamplePValues(stocks, config, calendar, std::move(results));
     }
     
     reportProgress("Analyzing Cointegration", 100.0);
     
-    // Sort results by statistical significance (p-value ascending)
-    std::sort(results.begin(), results.end(), 
-              [](const CointegrationResult& a, const CointegrationResult& b) {
-                  return a.p_value < b.p_value;
-              });
+    auto end_time = std::chrono::high_resolution_clock::now();
+    double seconds = std::chrono::duration<double>(end_time - start_time).count();
+    last_metrics_.total_pairs_analyzed = pairs_completed_;
+    if (seconds > 0) {
+        last_metrics_.pairs_per_second = pairs_completed_ / seconds;
+    }
     
+    rankCointegration(results);
     return results;
 }
 
 std::vector<CorrelationResult> ArbitrageAnalyzer::analyzeCorrelation(
     const std::vector<std::unique_ptr<StockData>>& stocks,
-    const AnalysisConfig& config) {
+    const AnalysisConfig& config,
+    const TradingCalendar* calendar,
+    const PairUniverse* universe) {
+    
+    std::optional<TradingCalendar> own_calendar;
+    if (!config.align_calendar) {
+        calendar = nullptr;
+    } else if (!calendar) {
+        calendar = &own_calendar.emplace(stocks);
+    }
+    std::optional<PairUniverse> own_universe;
+    if (!config.cluster_universe) {
+        universe = nullptr;
+    } else if (!universe) {
+        universe = &own_universe.emplace(clusterUniverse(stocks, config, calendar));
+    }
+    
+    // Every eligible stock goes into the matrix; the pair rules of
+    // isValidPair that involve both stocks are checked only on pairs that
+    // clear the threshold
+    const auto eligible = eligibleStocks(stocks, config);
+    std::vector<const StockData*> candidates(stocks.size(), nullptr);
+    for (size_t i = 0; i < stocks.size(); ++i) {
+        if (eligible[i]) candidates[i] = stocks[i].get();
+    }
+    auto same_sector = [&](size_t i, size_t j) {
+        return (!config.require_same_sector || stocks[i]->sector == stocks[j]->sector) &&
+               (!universe || universe->contains(i, j));
+    };
+    
+    const unsigned threads = config.num_threads > 0 ? config.num_threads : getOptimalThreadCount();
+    // A shard screens only its share of the tiles and aligned pairs
+    auto pairs = SIMDCorrelationAnalyzer::correlatedPairs_SIMD(
+        candidates, &StockData::returns, config.min_correlation_threshold, threads,
+        [&](size_t i, size_t j) {
+            return stocks[i]->size() == stocks[j]->size() &&
+                   !(calendar && calendar->needsAlignment(i, j)) && same_sector(i, j);
+        },
+        tileShard(config), universe);
+    
+    // Stocks with different histories correlate on their common bars' returns
+    if (calendar) {
+        const size_t min_points = static_cast<size_t>(std::max(0, config.min_data_points));
+        auto aligned = scanAlignedPairs(stocks, *calendar, threads,
+            [&](size_t i, size_t j) {
+                return eligible[i] && eligible[j] && ownsAlignedPair(config, i, j) && same_sector(i, j) &&
+                       calendar->commonBarCount(i, j) >= min_points;
+            },
+            [&](const CommonBarSeries& legs, double& score) {
+                score = SIMDStatistics::calculateCorrelation_SIMD(legs.returns_a, legs.returns_b);
+                return score >= config.min_correlation_threshold;
+            });
+        for (auto& pair : aligned) pair.correlation = std::max(-1.0, std::min(1.0, pair.correlation));
+        pairs.insert(pairs.end(), aligned.begin(), aligned.end());
+    }
     
-    // Placeholder implementation
     std::vector<CorrelationResult> results;
+    results.reserve(pairs.size());
+    for (const auto& pair : pairs) {
+        results.push_back(SIMDCorrelationAnalyzer::correlationResult(*stocks[pair.i], *stocks[pair.j], pair.correlation));
+    }
     
-    // For now, just create some dummy results to test the system
-    if (stocks.size() >= 2) {
-        CorrelationResult dummy_result;
-        dummy_result.stock1 = stocks[0]->symbol;
-        dummy_result.stock2 = stocks[1]->symbol;
-        dummy_result.pearson_correlation = 0.85;
-        dummy_result.spearman_correlation = 0.82;
-        dummy_result.correlation_stability = 0.9;
-        dummy_result.correlation_grade = "A";
+    // Rank correlations of every pair that passed, from the stocks' return
+    // ranks (aligned legs rank their common bars). Only the stocks of those
+    // pairs are ranked, once each, before the pairs run
+    if (config.rank_correlations && !pairs.empty()) {
+        ScopedCounters counters("kernel: rank correlations");
+        WorkStealingPool pool(threads);
+        
+        std::vector<unsigned char> ranked(stocks.size(), 0);
+        for (const auto& pair : pairs) {
+            if (calendar && calendar->needsAlignment(pair.i, pair.j)) continue;
+            ranked[pair.i] = ranked[pair.j] = 1;
+        }
+        std::vector<size_t> to_rank;
+        std::vector<size_t> rank_costs;
+        for (size_t s = 0; s < stocks.size(); ++s) {
+            if (!ranked[s] || stocks[s]->hasReturnRanks()) continue;
+            to_rank.push_back(s);
+            rank_costs.push_back(stocks[s]->returns.size());
+        }
+        pool.set_trace_label("return ranks");
+        pool.run(rank_costs, [&](size_t t, unsigned) { stocks[to_rank[t]]->calculateReturnRanks(); });
         
-        results.push_back(dummy_result);
+        constexpr size_t kRunLength = 256;
+        std::vector<size_t> costs;
+        for (size_t p = 0; p < pairs.size(); p += kRunLength) {
+            costs.push_back(std::min(kRunLength, pairs.size() - p));
+        }
+        pool.set_trace_label("rank correlation batch");
+        std::vector<std::pair<StockData, StockData>> legs(pool.size());
+        pool.run(costs, [&](size_t t, unsigned worker) {
+            const size_t end = std::min(pairs.size(), (t + 1) * kRunLength);
+            for (size_t p = t * kRunLength; p < end; ++p) {
+                const size_t i = pairs[p].i, j = pairs[p].j;
+                if (calendar && calendar->needsAlignment(i, j)) {
+                    auto& [leg1, leg2] = legs[worker];
+                    calendar->alignPair(*stocks[i], i, *stocks[j], j, leg1, leg2);
+                    SIMDCorrelationAnalyzer::fillRankCorrelations(leg1, leg2, results[p]);
+                } else {
+                    SIMDCorrelationAnalyzer::fillRankCorrelations(*stocks[i], *stocks[j], results[p]);
+                }
+            }
+        });
     }
     
+    reportProgress("Analyzing Correlation", 100.0);
+    
+    rankCorrelation(results);
     return results;
 }
 
+// Hash join: the cointegration results, usually the smaller list, are keyed
+// by interned symbol pair, and the correlation results probe that table in
+// runs on a work-stealing pool. Each worker feeds a bounded heap of the best
+// matches seen so far; only the heaps' survivors become opportunities.
 std::vector<ArbitrageOpportunity> ArbitrageAnalyzer::generateOpportunities(
     const std::vector<CointegrationResult>& cointegration_results,
     const std::vector<CorrelationResult>& correlation_results,
     const AnalysisConfig& config) {
     
     std::vector<ArbitrageOpportunity> opportunities;
+    if (cointegration_results.empty() || correlation_results.empty()) {
+        return opportunities;
+    }
     
-    // Simple matching of cointegration and correlation results
-    for (const auto& coint : cointegration_results) {
-        for (const auto& corr : correlation_results) {
-            if (coint.stock1 == corr.stock1 && coint.stock2 == corr.stock2) {
-                ArbitrageOpportunity opp;
-                opp.stock1 = coint.stock1;
-                opp.stock2 = coint.stock2;
-                opp.cointegration_score = coint.is_cointegrated ? 90.0 : 50.0;
-                opp.correlation_score = corr.pearson_correlation * 100.0;
-                opp.combined_score = (opp.cointegration_score + opp.correlation_score) / 2.0;
-                opp.profit_potential = 0.05; // 5% expected return
-                opp.opportunity_grade = "A";
-                
-                opportunities.push_back(opp);
+    std::unordered_map<std::string, uint32_t> symbols;
+    auto intern = [&](const std::string& symbol) {
+        return symbols.emplace(symbol, static_cast<uint32_t>(symbols.size())).first->second;
+    };
+    auto pair_id = [](uint32_t id1, uint32_t id2) {
+        return static_cast<uint64_t>(id1) << 32 | id2;
+    };
+    std::unordered_multimap<uint64_t, size_t> cointegrated;
+    cointegrated.reserve(cointegration_results.size());
+    for (size_t c = 0; c < cointegration_results.size(); ++c) {
+        const auto& coint = cointegration_results[c];
+        const uint32_t id1 = intern(coint.stock1);
+        cointegrated.emplace(pair_id(id1, intern(coint.stock2)), c);
+    }
+    
+    struct Match {
+        double combined_score;
+        size_t cointegration;
+        size_t correlation;
+    };
+    auto score = [&](size_t c, size_t r) {
+        const double cointegration_score = cointegration_results[c].is_cointegrated ? 90.0 : 50.0;
+        return (cointegration_score + correlation_results[r].pearson_correlation * 100.0) / 2.0;
+    };
+    // Better = higher score, then lower symbols, so the survivors do not
+    // depend on how the runs were split
+    auto better = [&](const Match& a, const Match& b) {
+        if (a.combined_score != b.combined_score) return a.combined_score > b.combined_score;
+        const auto& pair_a = cointegration_results[a.cointegration];
+        const auto& pair_b = cointegration_results[b.cointegration];
+        if (pair_a.stock1 != pair_b.stock1) return pair_a.stock1 < pair_b.stock1;
+        if (pair_a.stock2 != pair_b.stock2) return pair_a.stock2 < pair_b.stock2;
+        return a.correlation < b.correlation;
+    };
+    const size_t limit = config.max_opportunities > 0 ? static_cast<size_t>(config.max_opportunities) : 0;
+    
+    // Heap with the worst kept match on top, at most `limit` long
+    auto offer = [&](std::vector<Match>& heap, const Match& match) {
+        if (limit == 0) {
+            heap.push_back(match);
+        } else if (heap.size() < limit) {
+            heap.push_back(match);
+            std::push_heap(heap.begin(), heap.end(), better);
+        } else if (better(match, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), better);
+            heap.back() = match;
+            std::push_heap(heap.begin(), heap.end(), better);
+        }
+    };
+    
+    constexpr size_t kRunLength = 4096;
+    std::vector<size_t> costs;
+    for (size_t r = 0; r < correlation_results.size(); r += kRunLength) {
+        costs.push_back(std::min(kRunLength, correlation_results.size() - r));
+    }
+    WorkStealingPool pool(config.num_threads > 0 ? config.num_threads : getOptimalThreadCount());
+    pool.set_trace_label("opportunity batch");
+    std::vector<std::vector<Match>> heaps(pool.size());
+    pool.run(costs, [&](size_t t, unsigned worker) {
+        const size_t end = std::min(correlation_results.size(), (t + 1) * kRunLength);
+        for (size_t r = t * kRunLength; r < end; ++r) {
+            const auto& corr = correlation_results[r];
+            auto first = symbols.find(corr.stock1), second = symbols.find(corr.stock2);
+            if (first == symbols.end() || second == symbols.end()) continue;
+            auto [match, last] = cointegrated.equal_range(pair_id(first->second, second->second));
+            for (; match != last; ++match) {
+                offer(heaps[worker], {score(match->second, r), match->second, r});
             }
         }
+    });
+    
+    std::vector<Match> best;
+    for (const auto& heap : heaps) {
+        for (const Match& match : heap) offer(best, match);
+    }
+    std::sort(best.begin(), best.end(), better);
+    
+    opportunities.reserve(best.size());
+    for (const Match& match : best) {
+        const auto& coint = cointegration_results[match.cointegration];
+        ArbitrageOpportunity opp{};
+        opp.stock1 = coint.stock1;
+        opp.stock2 = coint.stock2;
+        opp.cointegration_score = coint.is_cointegrated ? 90.0 : 50.0;
+        opp.correlation_score = correlation_results[match.correlation].pearson_correlation * 100.0;
+        opp.combined_score = match.combined_score;
+        opp.profit_potential = 0.05; // 5% expected return
+        opp.opportunity_grade = "A";
+        opportunities.push_back(std::move(opp));
     }
     
     return opportunities;
@@ -226,6 +697,65 @@ bool ArbitrageAnalyzer::exportResults(
     );
 }
 
+bool ArbitrageAnalyzer::exportMatrix(
+    const std::vector<std::unique_ptr<StockData>>& stocks,
+    const std::vector<CointegrationResult>& cointegration_results,
+    const AnalysisConfig& config,
+    const TradingCalendar* calendar) {
+    
+    try {
+        TraceSpan span("pair matrix export");
+        std::vector<std::string> symbols;
+        std::vector<const StockData*> all;
+        std::unordered_map<std::string, size_t> index;
+        for (size_t i = 0; i < stocks.size(); ++i) {
+            symbols.push_back(stocks[i]->symbol);
+            all.push_back(stocks[i].get());
+            index.emplace(stocks[i]->symbol, i);
+        }
+        TiledMatrixWriter writer(matrixFile(config), symbols, {
+            {"correlation", MatrixReduction::LargestMagnitude, -1.0f, 1.0f},
+            {"cointegration_pvalue", MatrixReduction::Minimum, 0.0f, static_cast<float>(config.max_cointegration_pvalue)},
+        });
+        
+        // Stocks on the same bars straight from the Gram tiles; the rest on
+        // their common bars, as the correlation screen pairs them
+        const unsigned threads = config.num_threads > 0 ? config.num_threads : getOptimalThreadCount();
+        SIMDCorrelationAnalyzer::allCorrelations_SIMD(all, &StockData::returns, threads,
+            [&](size_t i, size_t j, double correlation) {
+                if (calendar && calendar->needsAlignment(i, j)) return;
+                writer.set(0, i, j, static_cast<float>(correlation));
+            });
+        if (calendar) {
+            auto aligned = scanAlignedPairs(stocks, *calendar, threads,
+                [&](size_t i, size_t j) { return calendar->commonBarCount(i, j) >= 3; },
+                [](const CommonBarSeries& legs, double& score) {
+                    score = SIMDStatistics::calculateCorrelation_SIMD(legs.returns_a, legs.returns_b);
+                    return std::isfinite(score);
+                });
+            for (const auto& pair : aligned) {
+                writer.set(0, pair.i, pair.j, static_cast<float>(std::max(-1.0, std::min(1.0, pair.correlation))));
+            }
+        }
+        for (size_t i = 0; i < stocks.size(); ++i) {
+            if (stocks[i]->returns.size() >= 2) writer.set(0, i, i, 1.0f);
+        }
+        
+        for (const auto& result : cointegration_results) {
+            const auto first = index.find(result.stock1), second = index.find(result.stock2);
+            if (first == index.end() || second == index.end()) continue;
+            writer.set(1, first->second, second->second, static_cast<float>(result.p_value));
+        }
+        
+        writer.finish();
+        last_metrics_.matrix_file = matrixFile(config);
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Pair matrix export failed: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 void ArbitrageAnalyzer::reportProgress(const std::string& stage, double progress) {
     if (progress_callback_) {
         progress_callback_(stage, progress);
@@ -276,62 +806,701 @@ bool ArbitrageAnalyzer::isValidPair(
     return true;
 }
 
-// Parallel cointegration analysis implementation
-std::vector<CointegrationResult> ArbitrageAnalyzer::analyzeCointegrationParallel(
+// The checks of isValidPair that involve one stock only
+std::vector<unsigned char> ArbitrageAnalyzer::eligibleStocks(
     const std::vector<std::unique_ptr<StockData>>& stocks,
     const AnalysisConfig& config) {
     
-    // For now, fall back to sequential analysis
-    // In a full implementation, this would use thread pools
+    const size_t min_points = static_cast<size_t>(std::max(0, config.min_data_points));
+    const auto& constraints = config.portfolio_constraints;
+    std::vector<unsigned char> eligible(stocks.size(), 0);
+    for (size_t i = 0; i < stocks.size(); ++i) {
+        const StockData* stock = stocks[i].get();
+        if (!stock || stock->size() < min_points) continue;
+        if (std::find(config.excluded_symbols.begin(), config.excluded_symbols.end(),
+                      stock->symbol) != config.excluded_symbols.end()) continue;
+        if (!stock->close.empty() &&
+            (stock->close.back() < constraints.min_stock_price ||
+             stock->close.back() > constraints.max_stock_price)) continue;
+        eligible[i] = 1;
+    }
+    return eligible;
+}
+
+// Clustering is linear in the stocks (times the bisection depth); the
+// neighbour search is quadratic in the clusters only
+PairUniverse ArbitrageAnalyzer::clusterUniverse(
+    const std::vector<std::unique_ptr<StockData>>& stocks,
+    const AnalysisConfig& config,
+    const TradingCalendar* calendar) {
+    
+    TraceSpan span("pair universe");
+    auto start_time = std::chrono::high_resolution_clock::now();
+    PairUniverse universe(stocks, eligibleStocks(stocks, config), calendar, config.universe);
+    
+    last_metrics_.universe_clusters = universe.clusterCount();
+    last_metrics_.universe_largest_cluster = universe.largestCluster();
+    last_metrics_.universe_pairs = universe.pairCount();
+    last_metrics_.universe_full_pairs = universe.fullPairCount();
+    last_metrics_.universe_coverage = last_metrics_.universe_full_pairs > 0 ?
+        static_cast<double>(last_metrics_.universe_pairs) / last_metrics_.universe_full_pairs : 0.0;
+    last_metrics_.universe_time_seconds = std::chrono::duration<double>(
+        std::chrono::high_resolution_clock::now() - start_time).count();
+    return universe;
+}
+
+// Parallel cointegration analysis implementation. The upper triangle of the
+// (i, j) stock index space is cut into square tiles of getOptimalBatchSize()
+// stocks a side and the tiles are run on a work-stealing pool; pairs are
+// enumerated inside each tile, never materialized.
+std::vector<CointegrationResult> ArbitrageAnalyzer::analyzeCointegrationParallel(
+    const std::vector<std::unique_ptr<StockData>>& stocks,
+    const AnalysisConfig& config,
+    const TradingCalendar* calendar,
+    const PairUniverse* universe) {
+    
     std::vector<CointegrationResult> results;
+    const size_t n = stocks.size();
     
-    if (stocks.size() < 2) {
+    if (n < 2) {
         return results;
     }
     
-    // Generate pairs
-    std::vector<std::pair<const StockData*, const StockData*>> stock_pairs;
+    // A screened run slices its candidates below; an unscreened one slices the
+    // pairs it enumerates
+    const bool screen = config.enable_prescreen || config.incremental;
+    const PairScope scope = pairScope(stocks, config, calendar, universe, !screen);
+    const size_t min_points = static_cast<size_t>(std::max(0, config.min_data_points));
+    auto valid_pair = [&](size_t i, size_t j) {
+        return validPair(stocks, config, calendar, universe, scope.eligible, i, j, min_points);
+    };
+    size_t total = scope.total;
     
-    size_t max_pairs = config.max_pairs_to_analyze > 0 ? 
-                      static_cast<size_t>(config.max_pairs_to_analyze) : 
-                      stocks.size() * (stocks.size() - 1) / 2;
+    const unsigned threads = config.num_threads > 0 ? config.num_threads : getOptimalThreadCount();
     
-    size_t pairs_generated = 0;
+    // Pre-screen: only the pairs that clear the cheap correlation bounds are
+    // handed to the ADF test, as one sorted candidate list
+    std::vector<std::pair<size_t, size_t>> candidates;
+    if (screen && total > 0) {
+        reportProgress("Screening Pairs", 0.0);
+        auto screen_start = std::chrono::high_resolution_clock::now();
+        if (config.incremental) {
+            candidates = screenIncremental(stocks, config, calendar, threads, scope);
+        } else {
+            candidates = prescreenPairs(stocks, config, calendar, threads, universe, [&](size_t i, size_t j) {
+                return scope.inScope(i, j) && valid_pair(i, j);
+            });
+        }
+        auto screen_end = std::chrono::high_resolution_clock::now();
+        
+        last_metrics_.pairs_screened = total;
+        last_metrics_.pairs_passed_screen = candidates.size();
+        last_metrics_.prescreen_prune_ratio = 1.0 - static_cast<double>(candidates.size()) / total;
+        last_metrics_.prescreen_time_seconds = std::chrono::duration<double>(screen_end - screen_start).count();
+        // prescreenPairs already screened only this shard's tiles; the
+        // incremental screen keeps whole-run state, so it is sliced here
+        if (config.incremental && config.shard_count > 1) {
+            const auto [begin, end] = shardSlice(candidates.size(), config);
+            candidates.erase(candidates.begin() + end, candidates.end());
+            candidates.erase(candidates.begin(), candidates.begin() + begin);
+        }
+        total = candidates.size();
+        reportProgress("Screening Pairs", 100.0);
+    }
+    
+    total_pairs_ = total;
+    pairs_completed_ = 0;
+    if (total == 0) {
+        return results;
+    }
+    
+    // Tiles (bi, bj) with bi <= bj, a diagonal tile holding only its j > i
+    // half; with the pre-screen, runs of getOptimalBatchSize()^2 candidates
+    const size_t edge = getOptimalBatchSize();
+    const size_t blocks = (n + edge - 1) / edge;
+    const size_t run_length = edge * edge;
+    std::vector<std::pair<size_t, size_t>> tiles;
+    std::vector<size_t> costs;
+    if (screen) {
+        for (size_t c = 0; c < candidates.size(); c += run_length) {
+            costs.push_back(std::min(run_length, candidates.size() - c));
+        }
+    } else {
+        for (size_t bi = 0; bi < blocks && bi * edge <= std::min(scope.last_i, n - 1); ++bi) {
+            if ((bi + 1) * edge <= scope.first_i) continue;
+            for (size_t bj = bi; bj < blocks; ++bj) {
+                const size_t rows = std::min(edge, n - bi * edge);
+                const size_t cols = std::min(edge, n - bj * edge);
+                tiles.emplace_back(bi, bj);
+                costs.push_back(bi == bj ? rows * (rows - 1) / 2 : rows * cols);
+            }
+        }
+    }
     
-    for (size_t i = 0; i < stocks.size() && pairs_generated < max_pairs; ++i) {
-        for (size_t j = i + 1; j < stocks.size() && pairs_generated < max_pairs; ++j) {
-            if (stocks[i] && stocks[j]) {
-                if (isValidPair(*stocks[i], *stocks[j], config)) {
-                    stock_pairs.emplace_back(stocks[i].get(), stocks[j].get());
-                    pairs_generated++;
+    return testPairs(stocks, config, calendar, threads, costs, [&](size_t t, const PairSink& add_pair) {
+        if (screen) {
+            const size_t begin = t * run_length, end = std::min(candidates.size(), begin + run_length);
+            for (size_t c = begin; c < end; ++c) {
+                add_pair(candidates[c].first, candidates[c].second);
+            }
+        } else {
+            const size_t i_begin = tiles[t].first * edge, i_end = std::min(n, i_begin + edge);
+            const size_t j_begin = tiles[t].second * edge, j_end = std::min(n, j_begin + edge);
+            for (size_t i = i_begin; i < i_end; ++i) {
+                if (!scope.eligible[i]) continue;
+                for (size_t j = std::max(j_begin, i + 1); j < j_end; ++j) {
+                    if (scope.inScope(i, j) && valid_pair(i, j)) add_pair(i, j);
                 }
             }
         }
+    });
+}
+
+std::vector<std::pair<const StockData*, const StockData*>> ArbitrageAnalyzer::resultLegs(
+    const std::vector<std::unique_ptr<StockData>>& stocks,
+    const std::vector<CointegrationResult>& results,
+    const TradingCalendar* calendar,
+    std::deque<StockData>& aligned_legs) {
+    
+    std::unordered_map<std::string, size_t> index_of;
+    for (size_t s = 0; s < stocks.size(); ++s) index_of.emplace(stocks[s]->symbol, s);
+    
+    std::vector<std::pair<const StockData*, const StockData*>> pairs;
+    pairs.reserve(results.size());
+    for (const auto& result : results) {
+        auto first = index_of.find(result.stock1), second = index_of.find(result.stock2);
+        if (first == index_of.end() || second == index_of.end()) {
+            pairs.emplace_back(nullptr, nullptr);
+            continue;
+        }
+        const size_t i = first->second, j = second->second;
+        if (calendar && calendar->needsAlignment(i, j)) {
+            aligned_legs.emplace_back();
+            aligned_legs.emplace_back();
+            StockData& leg1 = aligned_legs[aligned_legs.size() - 2];
+            StockData& leg2 = aligned_legs.back();
+            calendar->alignPair(*stocks[i], i, *stocks[j], j, leg1, leg2);
+            pairs.emplace_back(&leg1, &leg2);
+        } else {
+            pairs.emplace_back(stocks[i].get(), stocks[j].get());
+        }
+    }
+    return pairs;
+}
+
+bool ArbitrageAnalyzer::backtestGrid(
+    const std::vector<std::unique_ptr<StockData>>& stocks,
+    const std::vector<CointegrationResult>& results,
+    const AnalysisConfig& config,
+    const TradingCalendar* calendar) {
+    
+    TraceSpan span("backtest grid");
+    reportProgress("Backtesting Rule Grid", 0.0);
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    std::deque<StockData> aligned_legs;
+    const auto pairs = resultLegs(stocks, results, calendar, aligned_legs);
+    const auto rules = config.backtest_grid.rules();
+    
+    PairsBacktestEngine::Options options;
+    options.num_threads = config.num_threads;
+    const auto metrics = PairsBacktestEngine::run(pairs, rules, options);
+    
+    last_metrics_.backtest_rules = rules.size();
+    last_metrics_.backtest_pairs = 0;
+    for (const auto& pair : metrics) {
+        if (!pair.empty() && pair.front().bars > 0) ++last_metrics_.backtest_pairs;
+    }
+    last_metrics_.backtest_file = config.output_directory + "backtest_grid.csv";
+    const bool written = CSVExporter::exportBacktestGridCSV(rules, PairsBacktestEngine::pool(metrics),
+                                                           last_metrics_.backtest_file);
+    if (!written) {
+        std::cerr << "Cannot write " << last_metrics_.backtest_file << std::endl;
+        last_metrics_.backtest_file.clear();
     }
     
-    // Analyze pairs sequentially for now
-    results.reserve(stock_pairs.size());
+    last_metrics_.backtest_time_seconds = std::chrono::duration<double>(
+        std::chrono::high_resolution_clock::now() - start_time).count();
+    reportProgress("Backtesting Rule Grid", 100.0);
+    return written;
+}
+
+// Legs are looked up by symbol and cut to their common bars as in the scan;
+// a pair the resampling cannot test keeps its table p-value
+std::vector<CointegrationResult> ArbitrageAnalyzer::resamplePValues(
+    const std::vector<std::unique_ptr<StockData>>& stocks,
+    const AnalysisConfig& config,
+    const TradingCalendar* calendar,
+    std::vector<CointegrationResult> results) {
+    
+    reportProgress("Resampling P-Values", 0.0);
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    std::deque<StockData> aligned_legs;
+    const auto pairs = resultLegs(stocks, results, calendar, aligned_legs);
+    
+    BootstrapCointegrationEngine::Options options;
+    options.method = config.pvalue_method;
+    options.replicates = static_cast<size_t>(std::max(1, config.bootstrap_replicates));
+    options.num_threads = config.num_threads;
+    const auto empirical = BootstrapCointegrationEngine::run(pairs, options);
+    
+    std::vector<CointegrationResult> kept;
+    kept.reserve(results.size());
+    for (size_t k = 0; k < results.size(); ++k) {
+        if (empirical[k].valid) {
+            SIMDCointegrationAnalyzer::applyEmpiricalPValue(
+                results[k], empirical[k].p_value, empirical[k].critical_value_1pct,
+                empirical[k].critical_value_5pct, empirical[k].critical_value_10pct,
+                config.max_cointegration_pvalue);
+            ++last_metrics_.pairs_resampled;
+        }
+        if (meetsCriteria(results[k], config)) kept.push_back(std::move(results[k]));
+    }
+    
+    last_metrics_.pairs_dropped_by_resampling = results.size() - kept.size();
+    last_metrics_.resampling_time_seconds = std::chrono::duration<double>(
+        std::chrono::high_resolution_clock::now() - start_time).count();
+    reportProgress("Resampling P-Values", 100.0);
+    return kept;
+}
+
+// max_pairs_to_analyze keeps the first valid pairs in (i, j) order: find the
+// last row i and column j still inside that prefix. A shard then walks the
+// prefix again to the first and last pair of its slice.
+ArbitrageAnalyzer::PairScope ArbitrageAnalyzer::pairScope(
+    const std::vector<std::unique_ptr<StockData>>& stocks,
+    const AnalysisConfig& config,
+    const TradingCalendar* calendar,
+    const PairUniverse* universe,
+    bool sharded) {
+    
+    PairScope scope;
+    const size_t n = stocks.size();
+    // Per-stock half of isValidPair, checked once instead of once per pair
+    scope.eligible = eligibleStocks(stocks, config);
+    scope.universe = universe;
+    scope.last_i = n;
+    scope.last_j = n;
+    const size_t min_points = static_cast<size_t>(std::max(0, config.min_data_points));
+    const size_t max_pairs = config.max_pairs_to_analyze > 0 ?
+                             static_cast<size_t>(config.max_pairs_to_analyze) : 0;
+    for (size_t i = 0; i < n && (max_pairs == 0 || scope.total < max_pairs); ++i) {
+        if (!scope.eligible[i]) continue;
+        for (size_t j = i + 1; j < n; ++j) {
+            if (!validPair(stocks, config, calendar, universe, scope.eligible, i, j, min_points)) continue;
+            if (++scope.total == max_pairs) {
+                scope.last_i = i;
+                scope.last_j = j;
+                break;
+            }
+        }
+    }
+    
+    if (sharded && config.shard_count > 1) {
+        const auto [begin, end] = shardSlice(scope.total, config);
+        size_t ordinal = 0;
+        for (size_t i = 0; i < n && ordinal < end; ++i) {
+            if (!scope.eligible[i]) continue;
+            for (size_t j = i + 1; j < n && ordinal < end; ++j) {
+                if (!validPair(stocks, config, calendar, universe, scope.eligible, i, j, min_points)) continue;
+                if (ordinal == begin) {
+                    scope.first_i = i;
+                    scope.first_j = j;
+                }
+                if (++ordinal == end) {
+                    scope.last_i = i;
+                    scope.last_j = j;
+                }
+            }
+        }
+        scope.total = end - begin;
+    }
+    return scope;
+}
+
+// Each worker appends to its own result buffer and the buffers are merged
+// once the pool is done
+std::vector<CointegrationResult> ArbitrageAnalyzer::testPairs(
+    const std::vector<std::unique_ptr<StockData>>& stocks,
+    const AnalysisConfig& config,
+    const TradingCalendar* calendar,
+    unsigned int num_threads,
+    const std::vector<size_t>& costs,
+    const PairTask& enumerate) {
+    
+    ScopedCounters counters("kernel: cointegration pair tests");
+    WorkStealingPool pool(num_threads);
+    pool.set_trace_label("pair batch");
+    std::vector<std::vector<CointegrationResult>> worker_results(pool.size());
+    std::atomic<size_t> aligned_pairs{0};
     
-    for (size_t i = 0; i < stock_pairs.size(); ++i) {
-        auto result = SIMDCointegrationAnalyzer::analyzeCointegration_SIMD(
-            *stock_pairs[i].first, *stock_pairs[i].second);
+    pool.run(costs, [&](size_t t, unsigned worker) {
+        auto& local = worker_results[worker];
+        auto keep = [&](CointegrationResult& result) {
+            if (meetsCriteria(result, config)) local.push_back(std::move(result));
+        };
         
-        if (result.is_cointegrated && 
-            result.p_value <= config.max_cointegration_pvalue &&
-            result.half_life > 0 && result.half_life < 100) {
-            results.push_back(result);
+        // Cache entries are keyed on the original stocks, so a hit needs no
+        // alignment; the aligned analysis gets its own parameters
+        auto parameters = [&](size_t i, size_t j) {
+            return calendar && calendar->needsAlignment(i, j) ? kAlignedCointegrationParameters
+                                                              : kCointegrationParameters;
+        };
+        
+        // The task's pairs that miss the cache go through the batched ADF
+        // engine together; legs with different histories are cut to their
+        // common bars first
+        std::vector<std::pair<size_t, size_t>> indices;
+        std::vector<std::pair<const StockData*, const StockData*>> pairs;
+        std::deque<StockData> aligned_legs;
+        size_t analyzed = 0;
+        enumerate(t, [&](size_t i, size_t j) {
+            ++analyzed;
+            CointegrationResult cached;
+            if (config.enable_caching &&
+                AnalysisCache::getCachedCointegrationResult(*stocks[i], *stocks[j], parameters(i, j), cached)) {
+                keep(cached);
+                return;
+            }
+            indices.emplace_back(i, j);
+            if (calendar && calendar->needsAlignment(i, j)) {
+                aligned_legs.emplace_back();
+                aligned_legs.emplace_back();
+                StockData& leg1 = aligned_legs[aligned_legs.size() - 2];
+                StockData& leg2 = aligned_legs.back();
+                calendar->alignPair(*stocks[i], i, *stocks[j], j, leg1, leg2);
+                pairs.emplace_back(&leg1, &leg2);
+            } else {
+                pairs.emplace_back(stocks[i].get(), stocks[j].get());
+            }
+        });
+        aligned_pairs += aligned_legs.size() / 2;
+        
+        // Every tested pair is cached, passing or not, so a rerun on
+        // unchanged data skips the ADF test entirely
+        auto tested = SIMDCointegrationAnalyzer::batchAnalyzeCointegration_SIMD(pairs);
+        for (size_t p = 0; p < tested.size(); ++p) {
+            if (config.enable_caching) {
+                const auto [i, j] = indices[p];
+                AnalysisCache::cacheCointegrationResult(*stocks[i], *stocks[j], parameters(i, j), tested[p]);
+            }
+            keep(tested[p]);
         }
         
-        pairs_completed_++;
-        if (i % 100 == 0) {
-            double progress = static_cast<double>(i) / stock_pairs.size() * 100.0;
-            reportProgress("Analyzing Cointegration", progress);
+        if (analyzed > 0) {
+            const size_t done = pairs_completed_ += analyzed;
+            std::unique_lock<std::mutex> lock(progress_mutex_, std::defer_lock);
+            lock_traced(lock, "wait: progress_mutex_");
+            reportProgress("Analyzing Cointegration", static_cast<double>(done) / total_pairs_ * 100.0);
+        }
+    });
+    
+    last_metrics_.aligned_pairs = aligned_pairs;
+    
+    std::vector<CointegrationResult> results;
+    size_t found = 0;
+    for (const auto& local : worker_results) found += local.size();
+    results.reserve(found);
+    for (auto& local : worker_results) {
+        std::move(local.begin(), local.end(), std::back_inserter(results));
+    }
+    
+    return results;
+}
+
+// Two blocked correlation passes, each pruning the pairs the next one keeps:
+// returns first, then price levels. For the hedge regression of one leg's
+// prices on the other's, var(spread) / var(price) = 1 - rho^2, so the
+// variance-ratio bound is a minimum on the price correlation.
+std::vector<std::pair<size_t, size_t>> ArbitrageAnalyzer::prescreenPairs(
+    const std::vector<std::unique_ptr<StockData>>& stocks,
+    const AnalysisConfig& config,
+    const TradingCalendar* calendar,
+    unsigned int num_threads,
+    const PairUniverse* universe,
+    const SIMDCorrelationAnalyzer::PairFilter& include_pair) {
+    
+    std::vector<const StockData*> candidates;
+    candidates.reserve(stocks.size());
+    for (const auto& stock : stocks) candidates.push_back(stock.get());
+    
+    auto by_index = [](const SIMDCorrelationAnalyzer::PairCorrelation& a,
+                       const SIMDCorrelationAnalyzer::PairCorrelation& b) {
+        return a.i != b.i ? a.i < b.i : a.j < b.j;
+    };
+    
+    // Pairs on different bars go through scanAlignedPairs instead
+    auto same_bars_pair = [&](size_t i, size_t j) {
+        return !(calendar && calendar->needsAlignment(i, j)) && include_pair(i, j);
+    };
+    
+    // A shard computes only its share of the tiles. The price pass packs
+    // the same stocks as the returns pass (returns are one shorter than the
+    // closes), so its tiles line up and the shard's share is the same
+    const auto shard = tileShard(config);
+    auto correlated_returns = SIMDCorrelationAnalyzer::correlatedPairs_SIMD(
+        candidates, &StockData::returns, config.prescreen_min_return_correlation, num_threads, same_bars_pair,
+        shard, universe);
+    std::sort(correlated_returns.begin(), correlated_returns.end(), by_index);
+    
+    for (auto& candidate : candidates) {
+        if (candidate && candidate->returns.size() < 2) candidate = nullptr;
+    }
+    const double min_price_correlation =
+        std::sqrt(std::max(0.0, 1.0 - config.prescreen_max_spread_variance_ratio));
+    auto correlated_prices = SIMDCorrelationAnalyzer::correlatedPairs_SIMD(
+        candidates, &StockData::close, min_price_correlation, num_threads,
+        [&](size_t i, size_t j) {
+            return std::binary_search(correlated_returns.begin(), correlated_returns.end(),
+                                      SIMDCorrelationAnalyzer::PairCorrelation{i, j, 0.0}, by_index);
+        },
+        shard, universe);
+    std::sort(correlated_prices.begin(), correlated_prices.end(), by_index);
+    
+    if (calendar) {
+        // Both bounds on the legs' common bars
+        auto aligned = scanAlignedPairs(stocks, *calendar, num_threads,
+            [&](size_t i, size_t j) { return ownsAlignedPair(config, i, j) && include_pair(i, j); },
+            [&](const CommonBarSeries& legs, double& score) {
+                if (SIMDStatistics::calculateCorrelation_SIMD(legs.returns_a, legs.returns_b) <
+                    config.prescreen_min_return_correlation) return false;
+                score = SIMDStatistics::calculateCorrelation_SIMD(legs.close_a, legs.close_b);
+                return score >= min_price_correlation;
+            });
+        std::vector<SIMDCorrelationAnalyzer::PairCorrelation> merged;
+        merged.reserve(correlated_prices.size() + aligned.size());
+        std::merge(correlated_prices.begin(), correlated_prices.end(), aligned.begin(), aligned.end(),
+                   std::back_inserter(merged), by_index);
+        correlated_prices.swap(merged);
+    }
+    
+    std::vector<std::pair<size_t, size_t>> pairs;
+    pairs.reserve(correlated_prices.size());
+    for (const auto& pair : correlated_prices) pairs.emplace_back(pair.i, pair.j);
+    return pairs;
+}
+
+// Stocks are classed against the previous state as unchanged, grown by
+// appended bars (the old bars hash as before) or new / rewritten. Watched
+// pairs of unchanged and grown stocks extend their moments by the appended
+// bars only, pairs with a new or rewritten stock are measured from scratch,
+// and other pairs are not revisited until the next full screen. A full
+// screen (no state, too many new stocks, or a grown stock past the refresh
+// fraction) finds the watch list with the blocked correlation pass and
+// measures every watched pair from scratch.
+std::vector<std::pair<size_t, size_t>> ArbitrageAnalyzer::screenIncremental(
+    const std::vector<std::unique_ptr<StockData>>& stocks,
+    const AnalysisConfig& config,
+    const TradingCalendar* calendar,
+    unsigned int num_threads,
+    const PairScope& scope) {
+    
+    const size_t n = stocks.size();
+    const size_t min_points = static_cast<size_t>(std::max(0, config.min_data_points));
+    auto valid_pair = [&](size_t i, size_t j) {
+        return scope.inScope(i, j) &&
+               validPair(stocks, config, calendar, scope.universe, scope.eligible, i, j, min_points);
+    };
+    auto on_calendar = [&](size_t i, size_t j) -> uint32_t {
+        return calendar && calendar->alignment(i).aligned && calendar->alignment(j).aligned;
+    };
+    
+    const double min_price_correlation =
+        std::sqrt(std::max(0.0, 1.0 - config.prescreen_max_spread_variance_ratio));
+    const double watch_returns = config.prescreen_min_return_correlation - config.incremental_watch_margin;
+    const double watch_prices = min_price_correlation - config.incremental_watch_margin;
+    
+    const std::string path = stateFile(config);
+    IncrementalState previous;
+    const bool resumed = previous.load(path);
+    
+    enum Change : unsigned char { kUnchanged, kAppended, kReplaced };
+    std::vector<unsigned char> change(n, kReplaced);
+    std::unordered_map<uint64_t, size_t> index_of;
+    IncrementalState next;
+    next.stocks.reserve(n);
+    size_t replaced = 0;
+    bool full = !resumed;
+    for (size_t s = 0; s < n; ++s) {
+        const StockData& stock = *stocks[s];
+        const uint64_t id = AnalysisCache::symbolId(stock.symbol);
+        index_of[id] = s;
+        StockFingerprint print{id, stock.size(), stock.contentHash(), stock.size()};
+        const StockFingerprint* seen = previous.findStock(id);
+        if (seen && seen->bars <= stock.size() && stock.contentHash(seen->bars) == seen->content_hash) {
+            change[s] = seen->bars == stock.size() ? kUnchanged : kAppended;
+            print.bars_at_screen = seen->bars_at_screen;
+            if (stock.size() - seen->bars_at_screen > config.incremental_refresh_fraction * seen->bars_at_screen) {
+                full = true;
+            }
+        } else {
+            ++replaced;
+        }
+        next.stocks.push_back(print);
+    }
+    if (replaced > config.incremental_refresh_fraction * n) full = true;
+    
+    auto fresh = [&](size_t i, size_t j) {
+        PairState state{};
+        state.symbol1 = next.stocks[i].symbol_id;
+        state.symbol2 = next.stocks[j].symbol_id;
+        state.on_calendar = on_calendar(i, j);
+        return state;
+    };
+    
+    // Pairs whose moments this run brings up to date
+    struct Update {
+        size_t i;
+        size_t j;
+        PairState state;
+    };
+    std::vector<Update> updates;
+    size_t extended = 0;
+    if (full) {
+        std::vector<const StockData*> all;
+        all.reserve(n);
+        for (const auto& stock : stocks) all.push_back(stock.get());
+        auto watched = SIMDCorrelationAnalyzer::correlatedPairs_SIMD(
+            all, &StockData::returns, watch_returns, num_threads, [&](size_t i, size_t j) {
+                return !(calendar && calendar->needsAlignment(i, j)) && valid_pair(i, j);
+            }, SIMDCorrelationAnalyzer::TileShard{0, 1}, scope.universe);
+        if (calendar) {
+            auto aligned = scanAlignedPairs(stocks, *calendar, num_threads, valid_pair,
+                [&](const CommonBarSeries& legs, double& score) {
+                    score = SIMDStatistics::calculateCorrelation_SIMD(legs.returns_a, legs.returns_b);
+                    return score >= watch_returns;
+                });
+            watched.insert(watched.end(), aligned.begin(), aligned.end());
+        }
+        updates.reserve(watched.size());
+        for (const auto& pair : watched) updates.push_back({pair.i, pair.j, fresh(pair.i, pair.j)});
+        for (auto& print : next.stocks) print.bars_at_screen = print.bars;
+    } else {
+        for (const PairState& state : previous.pairs) {
+            auto first = index_of.find(state.symbol1), second = index_of.find(state.symbol2);
+            if (first == index_of.end() || second == index_of.end()) continue;
+            size_t i = first->second, j = second->second;
+            if (i == j || change[i] == kReplaced || change[j] == kReplaced) continue;
+            const PairState ordered = i < j ? state : swappedLegs(state);
+            if (i > j) std::swap(i, j);
+            if (!valid_pair(i, j) || ordered.on_calendar != on_calendar(i, j)) continue;
+            updates.push_back({i, j, ordered});
+            if (change[i] == kAppended || change[j] == kAppended) ++extended;
+        }
+        for (size_t r = 0; r < n; ++r) {
+            if (change[r] != kReplaced || !scope.eligible[r]) continue;
+            for (size_t s = 0; s < n; ++s) {
+                // A pair of two new stocks is taken once, from the lower one
+                if (s == r || (change[s] == kReplaced && s < r)) continue;
+                const size_t i = std::min(r, s), j = std::max(r, s);
+                if (valid_pair(i, j)) updates.push_back({i, j, fresh(i, j)});
+            }
+        }
+    }
+    
+    // Extended in runs of pairs on the pool, with scratch index lists per worker
+    constexpr size_t kRunLength = 256;
+    std::vector<size_t> costs;
+    for (size_t u = 0; u < updates.size(); u += kRunLength) {
+        costs.push_back(std::min(kRunLength, updates.size() - u));
+    }
+    WorkStealingPool pool(num_threads);
+    pool.set_trace_label("incremental pair batch");
+    std::vector<std::pair<std::vector<uint32_t>, std::vector<uint32_t>>> scratch(pool.size());
+    pool.run(costs, [&](size_t t, unsigned worker) {
+        const size_t end = std::min(updates.size(), (t + 1) * kRunLength);
+        for (size_t u = t * kRunLength; u < end; ++u) {
+            Update& update = updates[u];
+            extendPairState(update.state, *stocks[update.i], update.i, *stocks[update.j], update.j,
+                            calendar, scratch[worker].first, scratch[worker].second);
+        }
+    });
+    
+    // Both bounds on the moments; pairs within the margin stay watched
+    std::vector<std::pair<size_t, size_t>> candidates;
+    for (Update& update : updates) {
+        const double returns = update.state.returns.correlation();
+        const double prices = update.state.closes.correlation();
+        update.state.passed = returns >= config.prescreen_min_return_correlation && prices >= min_price_correlation;
+        if (update.state.passed) candidates.emplace_back(update.i, update.j);
+        if (returns >= watch_returns && prices >= watch_prices) next.pairs.push_back(update.state);
+    }
+    std::sort(candidates.begin(), candidates.end());
+    
+    next.save(path);
+    
+    last_metrics_.incremental_full_screen = full;
+    last_metrics_.incremental_stocks_changed = replaced;
+    last_metrics_.incremental_pairs_updated = extended;
+    last_metrics_.incremental_pairs_watched = next.pairs.size();
+    return candidates;
+}
+
+std::vector<SIMDCorrelationAnalyzer::PairCorrelation> ArbitrageAnalyzer::scanAlignedPairs(
+    const std::vector<std::unique_ptr<StockData>>& stocks,
+    const TradingCalendar& calendar,
+    unsigned int num_threads,
+    const SIMDCorrelationAnalyzer::PairFilter& include_pair,
+    const AlignedPairTest& test) {
+    
+    const size_t n = stocks.size();
+    const size_t edge = getOptimalBatchSize();
+    const size_t blocks = (n + edge - 1) / edge;
+    std::vector<std::pair<size_t, size_t>> tiles;
+    std::vector<size_t> costs;
+    for (size_t bi = 0; bi < blocks; ++bi) {
+        for (size_t bj = bi; bj < blocks; ++bj) {
+            tiles.emplace_back(bi, bj);
+            costs.push_back(std::min(edge, n - bi * edge) * std::min(edge, n - bj * edge));
         }
     }
     
+    ScopedCounters counters("kernel: aligned pair screen");
+    WorkStealingPool pool(num_threads);
+    pool.set_trace_label("aligned pair tile");
+    std::vector<std::vector<SIMDCorrelationAnalyzer::PairCorrelation>> worker_results(pool.size());
+    // One set of common-bar buffers per worker, reused across its pairs
+    std::vector<CommonBarSeries> legs(pool.size());
+    
+    pool.run(costs, [&](size_t t, unsigned worker) {
+        const size_t i_begin = tiles[t].first * edge, i_end = std::min(n, i_begin + edge);
+        const size_t j_begin = tiles[t].second * edge, j_end = std::min(n, j_begin + edge);
+        CommonBarSeries& scratch = legs[worker];
+        for (size_t i = i_begin; i < i_end; ++i) {
+            for (size_t j = std::max(j_begin, i + 1); j < j_end; ++j) {
+                if (!calendar.needsAlignment(i, j) || !include_pair(i, j)) continue;
+                calendar.gatherCommonBars(*stocks[i], i, *stocks[j], j, scratch);
+                double score = 0.0;
+                if (test(scratch, score)) worker_results[worker].push_back({i, j, score});
+            }
+        }
+    });
+    
+    std::vector<SIMDCorrelationAnalyzer::PairCorrelation> results;
+    for (auto& local : worker_results) {
+        std::move(local.begin(), local.end(), std::back_inserter(results));
+    }
+    std::sort(results.begin(), results.end(),
+              [](const SIMDCorrelationAnalyzer::PairCorrelation& a, const SIMDCorrelationAnalyzer::PairCorrelation& b) {
+                  return a.i != b.i ? a.i < b.i : a.j < b.j;
+              });
     return results;
 }
 
+// The host's machine profile (--autotune) when one is applied, else one
+// thread per hardware thread
+unsigned int ArbitrageAnalyzer::getOptimalThreadCount() {
+    return tuned_threads();
+}
+
+// Stocks per tile side: an e x e tile visits each of its 2e series e times
+// while they are still in cache. The machine profile measures the edge that
+// suits the host's caches; 32 without one.
+size_t ArbitrageAnalyzer::getOptimalBatchSize() {
+    return tuned_pair_tile();
+}
+
 // Configuration management implementation
 ArbitrageAnalyzer::AnalysisConfig ConfigManager::createDefaultConfig() {
     ArbitrageAnalyzer::AnalysisConfig config;
@@ -353,6 +1522,19 @@ bool ConfigManager::validateConfig(const ArbitrageAnalyzer::AnalysisConfig& conf
         return false;
     }
     
+    if (config.prescreen_min_return_correlation < -1.0 || config.prescreen_min_return_correlation > 1.0 ||
+        config.prescreen_max_spread_variance_ratio < 0.0 || config.prescreen_max_spread_variance_ratio > 1.0) {
+        return false;
+    }
+    
+    if (config.shard_count == 0 || config.shard_index >= config.shard_count) {
+        return false;
+    }
+    
+    if (config.cluster_universe && (config.universe.max_cluster_size < 2 || config.universe.window < 2)) {
+        return false;
+    }
+    
     return true;
 }
 
@@ -365,7 +1547,8 @@ ArbitrageAnalyzer::AnalysisConfig ArbitrageCLI::parseCommandLine(int argc, char*
         std::string option = argv[i];
         
         // Skip non-option arguments like --benchmark
-        if (option == "--benchmark" || option == "--interactive" || option == "--help" || option == "-h") {
+        if (option == "--benchmark" || option == "--autotune" || option == "--interactive" ||
+            option == "--help" || option == "-h") {
             continue;
         }
         
@@ -380,6 +1563,19 @@ ArbitrageAnalyzer::AnalysisConfig ArbitrageCLI::parseCommandLine(int argc, char*
     return config;
 }
 
+std::vector<std::string> ArbitrageCLI::parseMergeFiles(int argc, char* argv[]) {
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument.substr(0, 2) == "--") {
+            i++; // Skip the option's value
+        } else {
+            files.push_back(argument);
+        }
+    }
+    return files;
+}
+
 void ArbitrageCLI::parseOption(
     const std::string& option,
     const std::string& value,
@@ -391,18 +1587,135 @@ void ArbitrageCLI::parseOption(
         config.output_directory = value;
     } else if (option == "--min-correlation") {
         config.min_correlation_threshold = std::stod(value);
+    } else if (option == "--cache") {
+        config.enable_caching = value != "off";
+    } else if (option == "--cache-file") {
+        config.cache_file = value;
+    } else if (option == "--snapshot") {
+        config.use_snapshot = value != "off";
+    } else if (option == "--snapshot-file") {
+        config.snapshot_file = value;
+    } else if (option == "--rank-correlations") {
+        config.rank_correlations = value != "off";
+    } else if (option == "--pvalues") {
+        // table | block | permutation
+        config.empirical_pvalues = value != "table";
+        config.pvalue_method = value == "permutation" ? BootstrapCointegrationEngine::Method::Permutation
+                                                      : BootstrapCointegrationEngine::Method::BlockBootstrap;
+    } else if (option == "--replicates") {
+        config.bootstrap_replicates = std::stoi(value);
+    } else if (option == "--backtest") {
+        config.backtest = value != "off";
+    } else if (option == "--grid-entry") {
+        config.backtest_grid.entry_z = parseNumberList(value);
+    } else if (option == "--grid-exit") {
+        config.backtest_grid.exit_z = parseNumberList(value);
+    } else if (option == "--grid-stop") {
+        config.backtest_grid.stop_z = parseNumberList(value);
+    } else if (option == "--grid-holding") {
+        config.backtest_grid.max_holding.clear();
+        for (double bars : parseNumberList(value)) {
+            config.backtest_grid.max_holding.push_back(static_cast<size_t>(std::max(0.0, bars)));
+        }
+    } else if (option == "--max-opportunities") {
+        config.max_opportunities = std::stoi(value);
+    } else if (option == "--incremental") {
+        config.incremental = value != "off";
+    } else if (option == "--state-file") {
+        config.state_file = value;
+    } else if (option == "--shard") {
+        // i/N, 0 <= i < N; anything else fails validation
+        const size_t slash = value.find('/');
+        config.shard_count = 0;
+        if (slash != std::string::npos) {
+            config.shard_index = static_cast<unsigned>(std::stoul(value.substr(0, slash)));
+            config.shard_count = static_cast<unsigned>(std::stoul(value.substr(slash + 1)));
+        }
+    } else if (option == "--shard-file") {
+        config.shard_file = value;
+    } else if (option == "--align-calendar") {
+        config.align_calendar = value != "off";
+    } else if (option == "--profile") {
+        config.machine_profile = value;
+    } else if (option == "--numa") {
+        config.numa_placement = value != "off";
+    } else if (option == "--numa-replicate") {
+        config.numa_replicate_returns = value != "off";
+    } else if (option == "--trace") {
+        config.trace_file = value;
+    } else if (option == "--counters") {
+        config.hardware_counters = value != "off";
+    } else if (option == "--gpu") {
+        config.enable_gpu = value != "off";
+    } else if (option == "--matrix") {
+        config.export_matrix = value != "off";
+    } else if (option == "--matrix-file") {
+        config.matrix_file = value;
+    } else if (option == "--universe") {
+        // all | clusters
+        config.cluster_universe = value == "clusters";
+    } else if (option == "--cluster-size") {
+        config.universe.max_cluster_size = static_cast<size_t>(std::max(0, std::stoi(value)));
+    } else if (option == "--cluster-neighbors") {
+        config.universe.neighbors = static_cast<size_t>(std::max(0, std::stoi(value)));
+    } else if (option == "--cluster-window") {
+        config.universe.window = static_cast<size_t>(std::max(0, std::stoi(value)));
+    } else if (option == "--cluster-sectors") {
+        config.universe.sector_blocks = value != "off";
+    } else if (option == "--prescreen") {
+        config.enable_prescreen = value != "off";
+    } else if (option == "--prescreen-correlation") {
+        config.prescreen_min_return_correlation = std::stod(value);
+    } else if (option == "--prescreen-variance-ratio") {
+        config.prescreen_max_spread_variance_ratio = std::stod(value);
     }
     // Add more options as needed
 }
 
 void ArbitrageCLI::printUsage() {
     std::cout << "MFT Statistical Arbitrage Analyzer\n";
-    std::cout << "Usage: arbitrage_analyzer [OPTIONS]\n\n";
+    std::cout << "Usage: arbitrage_analyzer [OPTIONS]\n";
+    std::cout << "       arbitrage_analyzer merge SHARD_FILE... [OPTIONS]\n\n";
     std::cout << "Options:\n";
     std::cout << "  --input-dir PATH     Input data directory\n";
     std::cout << "  --output-dir PATH    Output directory\n";
     std::cout << "  --min-correlation N  Minimum correlation threshold\n";
+    std::cout << "  --cache on|off       Reuse pair results from earlier runs on unchanged data (default on)\n";
+    std::cout << "  --cache-file PATH    Result cache file (default <output-dir>analysis_cache.mfta)\n";
+    std::cout << "  --snapshot on|off    Reuse parsed stocks while their files are unchanged (default on)\n";
+    std::cout << "  --snapshot-file PATH Stock snapshot file (default <output-dir>stock_snapshot.mfss)\n";
+    std::cout << "  --rank-correlations on|off  Spearman and Kendall for every correlated pair (default on)\n";
+    std::cout << "  --pvalues table|block|permutation  ADF p-values from the table or resampled (default table)\n";
+    std::cout << "  --replicates N       Resampling replicates per pair (default 2000)\n";
+    std::cout << "  --backtest on|off    Backtest every cointegrated pair over the threshold grid (default off)\n";
+    std::cout << "  --grid-entry LIST    Entry |z| values of the grid (default 1.5,2,2.5)\n";
+    std::cout << "  --grid-exit LIST     Exit z values of the grid (default 0,0.5,1)\n";
+    std::cout << "  --grid-stop LIST     Stop-loss |z| values of the grid (default 3,4)\n";
+    std::cout << "  --grid-holding LIST  Holding limits in bars, 0 = none (default 0)\n";
+    std::cout << "  --max-opportunities N  Best opportunities kept, 0 = all (default 0)\n";
+    std::cout << "  --incremental on|off Rescreen only pairs whose data changed since the last run (default off)\n";
+    std::cout << "  --state-file PATH    Incremental state file (default <output-dir>incremental_state.mfts)\n";
+    std::cout << "  --shard I/N          Analyze shard I of N and write its partial results (0 <= I < N)\n";
+    std::cout << "  --shard-file PATH    Shard results file (default <output-dir>shard_I_of_N.mfsr)\n";
+    std::cout << "  --align-calendar on|off  Pair unequal histories on common bars (default on)\n";
+    std::cout << "  --profile PATH|off   Machine profile applied at startup (default ~/.mft/machine_profile)\n";
+    std::cout << "  --numa on|off        Pin worker threads to NUMA nodes on multi-socket hosts (default on)\n";
+    std::cout << "  --numa-replicate on|off  One copy of the screened series per NUMA node (default off)\n";
+    std::cout << "  --trace FILE         Chrome trace JSON of stages, tasks and lock waits, with latencies\n";
+    std::cout << "  --counters on|off    Hardware counters per stage and kernel in the summary (default off)\n";
+    std::cout << "  --gpu on|off         Correlation screens on the CUDA device when present (default on)\n";
+    std::cout << "  --matrix on|off      Tiled correlation / p-value matrix of every pair for the heatmap (default off)\n";
+    std::cout << "  --matrix-file PATH   Pair matrix file (default <output-dir>pair_matrix.mftm)\n";
+    std::cout << "  --universe all|clusters  Every pair, or pairs within and between nearest clusters (default all)\n";
+    std::cout << "  --cluster-size N     Largest cluster of the clustered universe (default 64)\n";
+    std::cout << "  --cluster-neighbors N  Nearest clusters linked to each cluster (default 2)\n";
+    std::cout << "  --cluster-window N   Returns per stock the clusters are built on (default 250)\n";
+    std::cout << "  --cluster-sectors on|off  Keep clusters within sectors (default on)\n";
+    std::cout << "  --prescreen on|off   Correlation pre-screen before the ADF test (default on)\n";
+    std::cout << "  --prescreen-correlation N     Minimum return correlation to pass\n";
+    std::cout << "  --prescreen-variance-ratio N  Maximum spread / price variance ratio to pass\n";
     std::cout << "  --benchmark          Run performance benchmark\n";
+    std::cout << "  --autotune           Measure SIMD tier, threads and pair tiles on this host and save the profile\n";
     std::cout << "  --interactive        Interactive configuration\n";
     std::cout << "  --help               Show this help\n";
 }
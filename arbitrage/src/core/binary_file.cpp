@@ -0,0 +1,49 @@
+#include "binary_file.h"
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+
+AtomicFileWriter::AtomicFileWriter(const std::string& path, const char* what)
+    : path_(path), temporary_(path + ".tmp"), what_(what) {
+    const std::filesystem::path target(path);
+    if (target.has_parent_path()) std::filesystem::create_directories(target.parent_path());
+    file_.open(temporary_, std::ios::binary | std::ios::trunc);
+    if (!file_.is_open()) throw std::runtime_error("Cannot create file: " + temporary_);
+}
+
+void AtomicFileWriter::pad(size_t alignment) {
+    static const char zeros[64] = {};
+    size_t bytes = (alignment - written_ % alignment) % alignment;
+    while (bytes > 0) {
+        const size_t chunk = std::min(bytes, sizeof(zeros));
+        write(zeros, chunk);
+        bytes -= chunk;
+    }
+}
+
+void AtomicFileWriter::commit() {
+    file_.close();
+    if (!file_) throw std::runtime_error(std::string("Error writing ") + what_ + ": " + temporary_);
+    std::filesystem::rename(temporary_, path_);
+}
+
+bool BinaryFileReader::openFile(const std::string& path) {
+    std::error_code error;
+    size_ = std::filesystem::file_size(path, error);
+    if (error) return false;
+    file_.open(path, std::ios::binary);
+    return file_.is_open();
+}
+
+std::unique_ptr<MappedFile> mapFileAtLeast(const std::string& path, size_t min_size) {
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) return nullptr;
+    std::unique_ptr<MappedFile> file;
+    try {
+        file = std::make_unique<MappedFile>(path);
+    } catch (const std::runtime_error&) {
+        return nullptr;
+    }
+    if (file->size() < min_size) return nullptr;
+    return file;
+}
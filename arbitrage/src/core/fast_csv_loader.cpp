@@ -1,10 +1,47 @@
 #include "fast_csv_loader.h"
+#include "async_file_io.h"
+#include "columnar_format.h"
+#include "csv_scanner.h"
+#include "memory_accounting.h"
+#include "numa_topology.h"
+#include "stock_snapshot.h"
+#include "timestamp_decoder.h"
+#include "trace.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <thread>
 #include <algorithm>
 #include <chrono>
+#include <cctype>
+
+namespace {
+
+// The loader's split of `count` stocks over num_threads threads: thread t
+// takes the block [t * batch, (t + 1) * batch) and, with NUMA placement
+// active, is pinned to numa_node_of_worker(t, num_threads), so the columns of
+// the stocks it builds are first touched on that node. Runs body(begin, end,
+// t) on one thread per non-empty block and waits for them.
+template <class Body>
+void runLoaderBlocks(size_t count, unsigned num_threads, const Body& body) {
+    const size_t batch_size = (count + num_threads - 1) / num_threads;
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        const size_t begin = t * batch_size;
+        const size_t end = std::min(begin + batch_size, count);
+        if (begin >= count) break;
+        const int node = numa_placement_active() ? static_cast<int>(numa_node_of_worker(t, num_threads)) : -1;
+        threads.emplace_back([&body, begin, end, node, t]() {
+            if (node >= 0) pin_thread_to_node(static_cast<unsigned>(node));
+            body(begin, end, t);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+}
 
 // Static member initialization
 FastCSVLoader::LoadingMetrics FastCSVLoader::last_metrics_;
@@ -45,15 +82,23 @@ FastCSVLoader::MemoryMappedFile::~MemoryMappedFile() {
 
 std::vector<std::unique_ptr<StockData>> FastCSVLoader::loadAllStocks(
     const std::string& data_directory,
-    const PortfolioConstraints& constraints) {
+    const PortfolioConstraints& constraints,
+    const std::string& snapshot_file) {
     
     auto start_time = std::chrono::high_resolution_clock::now();
+    last_metrics_ = LoadingMetrics{};
     
     // Get all CSV files
     auto csv_files = getCSVFiles(data_directory);
     
-    // Load in parallel
-    auto stocks = ParallelCSVLoader::loadInParallel(csv_files, constraints);
+    std::vector<std::unique_ptr<StockData>> stocks;
+    if (snapshot_file.empty()) {
+        // Load in parallel
+        stocks = ParallelCSVLoader::loadInParallel(csv_files, constraints);
+        last_metrics_.files_parsed = csv_files.size();
+    } else {
+        stocks = loadWithSnapshot(csv_files, snapshot_file);
+    }
     
     // Filter stocks based on constraints
     stocks = filterStocks(std::move(stocks), constraints);
@@ -72,19 +117,86 @@ std::vector<std::unique_ptr<StockData>> FastCSVLoader::loadAllStocks(
         total_points += stock->size();
     }
     last_metrics_.total_data_points = total_points;
-    last_metrics_.memory_used_mb = (total_points * sizeof(double) * 6) / (1024 * 1024); // Rough estimate
+    // Series columns as counted by their allocator (memory_accounting.h)
+    last_metrics_.memory_used_mb = memory_usage(MemorySubsystem::Loader).live_bytes >> 20;
     
     return stocks;
 }
 
+std::vector<std::unique_ptr<StockData>> FastCSVLoader::loadWithSnapshot(
+    const std::vector<std::string>& files,
+    const std::string& snapshot_file) {
+    
+    std::vector<uint64_t> fingerprints(files.size());
+    std::vector<std::unique_ptr<StockData>> loaded(files.size());
+    StockSnapshot snapshot;
+    snapshot.load(snapshot_file);
+    
+    // Unchanged files are copied out of the snapshot by threads split and
+    // pinned as the parse threads are, so a stock lands on the node that
+    // would have parsed it; the rest are parsed
+    const unsigned num_threads = std::max(1u, std::thread::hardware_concurrency());
+    runLoaderBlocks(files.size(), num_threads, [&](size_t begin, size_t end, unsigned t) {
+        set_trace_thread_name("snapshot " + std::to_string(t));
+        for (size_t i = begin; i < end; ++i) {
+            fingerprints[i] = StockSnapshot::sourceFingerprint(files[i]);
+            if (fingerprints[i] != 0) loaded[i] = snapshot.find(fingerprints[i]);
+        }
+    });
+    std::vector<std::string> missing_files;
+    std::vector<size_t> missing;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (loaded[i]) {
+            last_metrics_.snapshot_hits++;
+        } else {
+            missing_files.push_back(files[i]);
+            missing.push_back(i);
+        }
+    }
+    auto parsed = ParallelCSVLoader::loadIndexed(missing_files);
+    for (size_t m = 0; m < missing.size(); ++m) {
+        loaded[missing[m]] = std::move(parsed[m]);
+    }
+    last_metrics_.files_parsed = missing.size();
+    
+    // Rewritten when a file was parsed or one the snapshot holds is gone
+    if (!missing.empty() || snapshot.size() != last_metrics_.snapshot_hits) {
+        std::vector<const StockData*> views;
+        views.reserve(loaded.size());
+        for (const auto& stock : loaded) views.push_back(stock.get());
+        try {
+            StockSnapshot::save(snapshot_file, views, fingerprints);
+        } catch (const std::exception& e) {
+            std::cerr << "Cannot write stock snapshot: " << e.what() << std::endl;
+        }
+    }
+    
+    std::vector<std::unique_ptr<StockData>> results;
+    for (auto& stock : loaded) {
+        if (stock) {
+            results.push_back(std::move(stock));
+        }
+    }
+    return results;
+}
+
 std::unique_ptr<StockData> FastCSVLoader::loadSingleStock(const std::string& csv_path) {
+    if (ColumnarFile::is_columnar_path(csv_path)) {
+        return loadColumnarStock(csv_path);
+    }
+    
     MemoryMappedFile file(csv_path);
     if (!file.isValid()) {
         return nullptr;
     }
     
+    return parseStock(csv_path, file.data(), file.size());
+}
+
+std::unique_ptr<StockData> FastCSVLoader::parseStock(
+    const std::string& csv_path, const char* data, size_t size) {
     std::string symbol = extractSymbolFromFilename(csv_path);
-    return OptimizedCSVParser::parseFeatureCSV(file.data(), file.size(), symbol);
+    return OptimizedCSVParser::parseFeatureCSV(data, size, symbol);
 }
 
 std::vector<std::string> FastCSVLoader::getCSVFiles(const std::string& directory) {
@@ -92,56 +204,73 @@ std::vector<std::string> FastCSVLoader::getCSVFiles(const std::string& directory
     
     try {
         for (const auto& entry : std::filesystem::directory_iterator(directory)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".csv") {
+            if (!entry.is_regular_file()) continue;
+            const auto extension = entry.path().extension();
+            if (extension == kColumnarExtension) {
                 csv_files.push_back(entry.path().string());
+            } else if (extension == ".csv") {
+                // Prefer the binary file when the extractor wrote both
+                auto columnar = entry.path();
+                columnar.replace_extension(kColumnarExtension);
+                if (!std::filesystem::exists(columnar)) {
+                    csv_files.push_back(entry.path().string());
+                }
             }
         }
     } catch (const std::exception& e) {
         std::cerr << "Error reading directory " << directory << ": " << e.what() << std::endl;
     }
     
+    // Directory order is up to the filesystem; sorted, every run (and every
+    // shard of a sharded run) indexes the stocks alike
+    std::sort(csv_files.begin(), csv_files.end());
     return csv_files;
 }
 
-double FastCSVLoader::fast_atof(const char* str, const char** endptr) {
-    // Simple fast implementation - can be optimized further
-    double result = 0.0;
-    double sign = 1.0;
-    const char* p = str;
-    
-    // Skip whitespace
-    while (*p == ' ' || *p == '\t') p++;
-    
-    // Handle sign
-    if (*p == '-') {
-        sign = -1.0;
-        p++;
-    } else if (*p == '+') {
-        p++;
-    }
-    
-    // Parse integer part
-    while (*p >= '0' && *p <= '9') {
-        result = result * 10.0 + (*p - '0');
-        p++;
+std::unique_ptr<StockData> FastCSVLoader::loadColumnarStock(const std::string& path) {
+    ColumnarFile file(path);
+    const double* open = file.find("open");
+    const double* high = file.find("high");
+    const double* low = file.find("low");
+    const double* close = file.find("close");
+    const double* volume = file.find("volume");
+    if (!open || !high || !low || !close || !volume || file.rows() == 0) {
+        return nullptr;
     }
     
-    // Parse decimal part
-    if (*p == '.') {
-        p++;
-        double fraction = 0.1;
-        while (*p >= '0' && *p <= '9') {
-            result += (*p - '0') * fraction;
-            fraction *= 0.1;
-            p++;
+    auto stock = std::make_unique<StockData>();
+    stock->symbol = file.symbol().empty() ? extractSymbolFromFilename(path) : file.symbol();
+    
+    const size_t rows = file.rows();
+    stock->reserve(rows);
+    stock->open.assign(open, open + rows);
+    stock->high.assign(high, high + rows);
+    stock->low.assign(low, low + rows);
+    stock->close.assign(close, close + rows);
+    stock->volume.assign(volume, volume + rows);
+    if (const int64_t* seconds = file.timestamps()) {
+        for (size_t i = 0; i < rows; ++i) {
+            stock->timestamps.push_back(std::chrono::system_clock::from_time_t(static_cast<time_t>(seconds[i])));
         }
     }
     
-    if (endptr) {
-        *endptr = p;
-    }
+    stock->calculateReturns();
+    stock->calculateStatistics();
     
-    return result * sign;
+    return stock;
+}
+
+std::chrono::system_clock::time_point FastCSVLoader::parseTimestamp(
+    const char* timestamp_str, const char** endptr) {
+    thread_local TimestampDecoder decoder;
+    const char* p = timestamp_str;
+    while (*p && *p != ',' && *p != '\n' && *p != '\r') p++;
+    if (endptr) *endptr = p;
+    return decoder.decode(timestamp_str, static_cast<size_t>(p - timestamp_str));
+}
+
+double FastCSVLoader::fast_atof(const char* str, const char** endptr) {
+    return CSVScanner::parse_decimal(str, endptr);
 }
 
 std::string FastCSVLoader::extractSymbolFromFilename(const std::string& filepath) {
@@ -201,36 +330,8 @@ std::vector<std::unique_ptr<StockData>> ParallelCSVLoader::loadInParallel(
     const PortfolioConstraints& constraints,
     unsigned int num_threads) {
     
-    if (num_threads == 0) {
-        num_threads = std::thread::hardware_concurrency();
-    }
-    
-    std::vector<std::unique_ptr<StockData>> all_results(csv_files.size());
-    std::vector<std::thread> threads;
-    
-    const size_t batch_size = (csv_files.size() + num_threads - 1) / num_threads;
-    
-    for (unsigned int t = 0; t < num_threads; ++t) {
-        size_t start_idx = t * batch_size;
-        size_t end_idx = std::min(start_idx + batch_size, csv_files.size());
-        
-        if (start_idx >= csv_files.size()) break;
-        
-        threads.emplace_back([&csv_files, &all_results, &constraints, start_idx, end_idx]() {
-            for (size_t i = start_idx; i < end_idx; ++i) {
-                try {
-                    all_results[i] = FastCSVLoader::loadSingleStock(csv_files[i]);
-                } catch (const std::exception& e) {
-                    std::cerr << "Error loading " << csv_files[i] << ": " << e.what() << std::endl;
-                }
-            }
-        });
-    }
-    
-    // Wait for all threads
-    for (auto& thread : threads) {
-        thread.join();
-    }
+    (void)constraints; // applied afterwards by FastCSVLoader::filterStocks
+    auto all_results = loadIndexed(csv_files, num_threads);
     
     // Remove null entries
     std::vector<std::unique_ptr<StockData>> results;
@@ -243,64 +344,123 @@ std::vector<std::unique_ptr<StockData>> ParallelCSVLoader::loadInParallel(
     return results;
 }
 
+std::vector<std::unique_ptr<StockData>> ParallelCSVLoader::loadIndexed(
+    const std::vector<std::string>& csv_files,
+    unsigned int num_threads) {
+    
+    if (num_threads == 0) {
+        num_threads = std::thread::hardware_concurrency();
+    }
+    
+    std::vector<std::unique_ptr<StockData>> all_results(csv_files.size());
+    
+    // First touch: a stock's columns land on the node of the thread that parses it
+    runLoaderBlocks(csv_files.size(), num_threads, [&](size_t start_idx, size_t end_idx, unsigned t) {
+        set_trace_thread_name("loader " + std::to_string(t));
+        // CSV files are read through AsyncFileIO with several in flight
+        // and parsed as each arrives; columnar files are read in place.
+        // A few per thread keep the device busy; many more read files
+        // out of cache before they are parsed.
+        AsyncIOConfig io_config;
+        io_config.queue_depth = std::max(4u, 16u / num_threads);
+        io_config.fallback_threads = 1;
+        AsyncFileIO io(io_config);
+        size_t next = start_idx;
+        auto next_csv = [&](std::string& path, size_t& index) {
+            for (; next < end_idx; ++next) {
+                if (ColumnarFile::is_columnar_path(csv_files[next])) {
+                    TraceSpan span("parse stock", "stock", static_cast<int64_t>(next));
+                    try {
+                        all_results[next] = FastCSVLoader::loadSingleStock(csv_files[next]);
+                    } catch (const std::exception& e) {
+                        std::cerr << "Error loading " << csv_files[next] << ": " << e.what() << std::endl;
+                    }
+                    continue;
+                }
+                path = csv_files[next];
+                index = next++;
+                return true;
+            }
+            return false;
+        };
+        io.read_files(next_csv, [&](const AsyncIOResult& file) {
+            if (!file.ok()) return;  // as loadSingleStock: unreadable files load as nullptr
+            TraceSpan span("parse stock", "stock", static_cast<int64_t>(file.tag));
+            try {
+                all_results[file.tag] = FastCSVLoader::parseStock(*file.path, file.data, file.size);
+            } catch (const std::exception& e) {
+                std::cerr << "Error loading " << *file.path << ": " << e.what() << std::endl;
+            }
+        });
+    });
+    
+    return all_results;
+}
+
 // Optimized CSV parser implementation
 std::unique_ptr<StockData> OptimizedCSVParser::parseFeatureCSV(
     const char* csv_data, size_t data_size, const std::string& symbol) {
     
-    auto stock = std::make_unique<StockData>();
-    stock->symbol = symbol;
+    const char* data_end = csv_data + data_size;
     
     // Count lines for pre-allocation
-    size_t line_count = countLines(csv_data, data_size);
-    if (line_count < 2) return nullptr; // Need at least header + 1 data line
+    size_t line_count = CSVScanner::count_lines(csv_data, data_end);
+    // Without a line break there is at most a header; a header followed only
+    // by blank lines is caught below, once no close was parsed
+    if (line_count < 1) return nullptr;
     
-    stock->reserve(line_count - 1); // Exclude header
+    const char* header_end = CSVScanner::find_line_end(csv_data, data_end);
+    const ColumnProjection projection = resolveProjection(parseHeader(csv_data, header_end));
     
-    const char* line_start = csv_data;
-    const char* data_end = csv_data + data_size;
+    auto stock = std::make_unique<StockData>();
+    stock->symbol = symbol;
+    stock->reserve(line_count); // Header plus at most one unterminated line
+    
+    // Datetime fields are decoded as one column after the numeric fields
+    std::vector<std::string_view> datetimes;
+    datetimes.reserve(line_count);
+    std::string last;
+    
+    // Only the delimiters up to the last projected column are located; the
+    // feature columns after it are never scanned field by field or converted
+    const size_t delimiters = static_cast<size_t>(projection.last_column);
+    std::vector<const char*> commas(delimiters + 1);
+    auto parse_line = [&](const char* line_start, const char* line_end) {
+        commas[0] = line_start - 1;     // column c starts after commas[c]
+        if (CSVScanner::find_delimiters(line_start, line_end, ',', commas.data() + 1, delimiters) < delimiters) return;
+        auto field = [&](int column) { return commas[column] + 1; };
+        auto field_end = [&](int column) {
+            if (column < projection.last_column) return commas[column + 1];
+            const char* end = line_end;
+            CSVScanner::find_delimiters(field(column), line_end, ',', &end, 1);
+            return end;
+        };
+        
+        const char* datetime = field(projection.datetime);
+        datetimes.emplace_back(datetime, static_cast<size_t>(field_end(projection.datetime) - datetime));
+        
+        const char* endptr;
+        stock->open.push_back(FastCSVLoader::fast_atof(field(projection.open), &endptr));
+        stock->high.push_back(FastCSVLoader::fast_atof(field(projection.high), &endptr));
+        stock->low.push_back(FastCSVLoader::fast_atof(field(projection.low), &endptr));
+        stock->close.push_back(FastCSVLoader::fast_atof(field(projection.close), &endptr));
+        stock->volume.push_back(FastCSVLoader::fast_atof(field(projection.volume), &endptr));
+    };
     
-    // Skip header line
-    while (line_start < data_end && *line_start != '\n') {
+    // Parse data lines
+    const char* line_start = header_end;
+    while (line_start < data_end && (*line_start == '\n' || *line_start == '\r')) {
         line_start++;
     }
-    if (line_start < data_end) line_start++; // Skip the newline
-    
-    // Parse data lines
     while (line_start < data_end) {
-        const char* line_end = line_start;
-        while (line_end < data_end && *line_end != '\n' && *line_end != '\r') {
-            line_end++;
-        }
+        const char* line_end = CSVScanner::find_line_end(line_start, data_end);
         
-        if (line_end > line_start) {
-            // Parse this line - simplified version
-            const char* p = line_start;
-            
-            // Skip datetime (column 0)
-            p = skipToColumn(p, 1);
-            
-            // Parse OHLCV data (columns 1-5)
-            if (p < line_end) {
-                const char* endptr;
-                double open = FastCSVLoader::fast_atof(p, &endptr);
-                stock->open.push_back(open);
-                p = skipToColumn(endptr, 1);
-                
-                double high = FastCSVLoader::fast_atof(p, &endptr);
-                stock->high.push_back(high);
-                p = skipToColumn(endptr, 1);
-                
-                double low = FastCSVLoader::fast_atof(p, &endptr);
-                stock->low.push_back(low);
-                p = skipToColumn(endptr, 1);
-                
-                double close = FastCSVLoader::fast_atof(p, &endptr);
-                stock->close.push_back(close);
-                p = skipToColumn(endptr, 1);
-                
-                double volume = FastCSVLoader::fast_atof(p, &endptr);
-                stock->volume.push_back(volume);
-            }
+        if (line_end == data_end) {
+            // Unterminated last line: fast_atof must not run past the mapping
+            last.assign(line_start, line_end);
+            parse_line(last.data(), last.data() + last.size());
+        } else if (line_end > line_start) {
+            parse_line(line_start, line_end);
         }
         
         // Move to next line
@@ -309,6 +469,10 @@ std::unique_ptr<StockData> OptimizedCSVParser::parseFeatureCSV(
             line_start++;
         }
     }
+    if (stock->close.empty()) return nullptr;
+    
+    TimestampDecoder decoder;
+    decoder.decode_column(datetimes, stock->timestamps);
     
     // Calculate returns and statistics
     stock->calculateReturns();
@@ -317,21 +481,44 @@ std::unique_ptr<StockData> OptimizedCSVParser::parseFeatureCSV(
     return stock;
 }
 
-const char* OptimizedCSVParser::skipToColumn(const char* line_start, int column_index) {
-    const char* p = line_start;
-    for (int i = 0; i < column_index && *p; ++i) {
-        while (*p && *p != ',' && *p != '\n' && *p != '\r') p++;
-        if (*p == ',') p++;
-    }
-    return p;
+OptimizedCSVParser::ColumnProjection OptimizedCSVParser::resolveProjection(
+    const std::unordered_map<std::string, int>& header) {
+    
+    // Columns the header does not name keep their CSVColumn positions
+    auto index = [&header](const char* name, CSVColumn fallback) {
+        auto it = header.find(name);
+        return it != header.end() ? it->second : static_cast<int>(fallback);
+    };
+    ColumnProjection projection;
+    projection.datetime = header.count("datetime") ? index("datetime", CSVColumn::DATETIME)
+                                                   : index("timestamp", CSVColumn::DATETIME);
+    projection.open = index("open", CSVColumn::OPEN);
+    projection.high = index("high", CSVColumn::HIGH);
+    projection.low = index("low", CSVColumn::LOW);
+    projection.close = index("close", CSVColumn::CLOSE);
+    projection.volume = index("volume", CSVColumn::VOLUME);
+    projection.last_column = std::max({projection.datetime, projection.open, projection.high,
+                                       projection.low, projection.close, projection.volume});
+    return projection;
 }
 
-size_t OptimizedCSVParser::countLines(const char* data, size_t size) {
-    size_t count = 0;
-    for (size_t i = 0; i < size; ++i) {
-        if (data[i] == '\n') {
-            count++;
-        }
+std::unordered_map<std::string, int> OptimizedCSVParser::parseHeader(
+    const char* header_start, const char* header_end) {
+    
+    std::unordered_map<std::string, int> columns;
+    int column = 0;
+    const char* p = header_start;
+    while (p <= header_end) {
+        const char* comma = header_end;
+        CSVScanner::find_delimiters(p, header_end, ',', &comma, 1);
+        std::string name(p, comma);
+        // Names are matched case-insensitively, without surrounding spaces or quotes
+        name.erase(0, name.find_first_not_of(" \t\""));
+        name.erase(name.find_last_not_of(" \t\"") + 1);
+        std::transform(name.begin(), name.end(), name.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        columns.emplace(std::move(name), column++);
+        p = comma + 1;
     }
-    return count;
+    return columns;
 }
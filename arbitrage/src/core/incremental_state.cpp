@@ -0,0 +1,90 @@
+#include "incremental_state.h"
+#include "binary_file.h"
+#include <cmath>
+
+namespace {
+
+constexpr char kStateMagic[8] = {'M', 'F', 'T', 'S', 'T', 'A', 'T', 'E'};
+constexpr uint32_t kStateVersion = 1;
+
+struct StateHeader {
+    char magic[8];
+    uint32_t version;
+    uint16_t stock_record_size;
+    uint16_t pair_record_size;
+    uint64_t stock_count;
+    uint64_t pair_count;
+    uint8_t reserved[32];
+};
+static_assert(sizeof(StateHeader) == 64, "StateHeader layout is part of the file format");
+static_assert(sizeof(StockFingerprint) == 32, "StockFingerprint layout is part of the file format");
+static_assert(sizeof(PairState) == 152, "PairState layout is part of the file format");
+
+}
+
+double PairMoments::correlation() const {
+    const double denominator = m2_1 * m2_2;
+    return denominator > 0.0 ? c12 / std::sqrt(denominator) : 0.0;
+}
+
+bool IncrementalState::load(const std::string& path) {
+    stocks.clear();
+    pairs.clear();
+    index();
+    
+    BinaryFileReader file;
+    StateHeader header{};
+    if (!file.open(path, header, kStateMagic, kStateVersion) ||
+        header.stock_record_size != sizeof(StockFingerprint) ||
+        header.pair_record_size != sizeof(PairState)) return false;
+    
+    // Counts are checked against the file size before anything is allocated
+    const uint64_t size = file.size();
+    if (header.stock_count > size / sizeof(StockFingerprint) ||
+        header.pair_count > size / sizeof(PairState) ||
+        sizeof(header) + header.stock_count * sizeof(StockFingerprint) +
+        header.pair_count * sizeof(PairState) != size) return false;
+    
+    stocks.resize(header.stock_count);
+    pairs.resize(header.pair_count);
+    if (!file.read(stocks.data(), stocks.size() * sizeof(StockFingerprint)) ||
+        !file.read(pairs.data(), pairs.size() * sizeof(PairState))) {
+        stocks.clear();
+        pairs.clear();
+        return false;
+    }
+    index();
+    return true;
+}
+
+void IncrementalState::save(const std::string& path) const {
+    StateHeader header{};
+    stampHeader(header, kStateMagic, kStateVersion);
+    header.stock_record_size = sizeof(StockFingerprint);
+    header.pair_record_size = sizeof(PairState);
+    header.stock_count = stocks.size();
+    header.pair_count = pairs.size();
+    
+    AtomicFileWriter file(path, "incremental state");
+    file.write(&header, sizeof(header));
+    file.write(stocks.data(), stocks.size() * sizeof(StockFingerprint));
+    file.write(pairs.data(), pairs.size() * sizeof(PairState));
+    file.commit();
+}
+
+const StockFingerprint* IncrementalState::findStock(uint64_t symbol_id) const {
+    auto it = stock_index_.find(symbol_id);
+    return it == stock_index_.end() ? nullptr : &stocks[it->second];
+}
+
+const PairState* IncrementalState::findPair(uint64_t symbol1, uint64_t symbol2) const {
+    auto it = pair_index_.find({symbol1, symbol2});
+    return it == pair_index_.end() ? nullptr : &pairs[it->second];
+}
+
+void IncrementalState::index() {
+    stock_index_.clear();
+    pair_index_.clear();
+    for (size_t s = 0; s < stocks.size(); ++s) stock_index_[stocks[s].symbol_id] = s;
+    for (size_t p = 0; p < pairs.size(); ++p) pair_index_[{pairs[p].symbol1, pairs[p].symbol2}] = p;
+}
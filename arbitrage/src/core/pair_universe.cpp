@@ -0,0 +1,234 @@
+#include "pair_universe.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+
+namespace {
+
+// 2-means passes per bisection; assignments settle within a few
+constexpr int kRefinements = 8;
+
+double dot(const double* a, const double* b, size_t width) {
+    double sum = 0.0;
+    for (size_t k = 0; k < width; ++k) sum += a[k] * b[k];
+    return sum;
+}
+
+// Scales `row` to unit length; a zero row stays zero
+void normalize(double* row, size_t width) {
+    const double norm = std::sqrt(dot(row, row, width));
+    if (norm > 0.0) {
+        for (size_t k = 0; k < width; ++k) row[k] /= norm;
+    }
+}
+
+// Unit-length profiles of the clustered stocks, one row of `width` values each
+struct Profiles {
+    size_t width = 0;
+    std::vector<double> values;
+    const double* row(size_t r) const { return values.data() + r * width; }
+
+    // Normalized mean of `rows` into `out`
+    void centroid(const std::vector<uint32_t>& rows, std::vector<double>& out) const {
+        out.assign(width, 0.0);
+        for (uint32_t r : rows) {
+            const double* values_r = row(r);
+            for (size_t k = 0; k < width; ++k) out[k] += values_r[k];
+        }
+        normalize(out.data(), width);
+    }
+};
+
+// The stock's last returns, centered on the bars it holds (missing bars stay
+// 0) and scaled to unit length. On the calendar, row position p is calendar
+// bar size() - width + p; otherwise positions count back from the last bar.
+void fillProfile(const StockData& stock, size_t s, const TradingCalendar* calendar,
+                 size_t width, double* row, std::vector<unsigned char>& present) {
+    present.assign(width, 0);
+    const size_t n = stock.returns.size();
+    if (calendar && calendar->alignment(s).aligned && stock.timestamps.size() == n + 1) {
+        const auto& bars = calendar->bars();
+        const size_t first = bars.size() - width;
+        const CalendarAlignment& alignment = calendar->alignment(s);
+        size_t bar = alignment.offset + alignment.span - 1;
+        // Return k ends on bar k + 1; both walks descend
+        for (size_t k = n; k-- > 0;) {
+            while (bars[bar] > stock.timestamps[k + 1]) --bar;
+            if (bar < first) break;
+            row[bar - first] = stock.returns[k];
+            present[bar - first] = 1;
+        }
+    } else {
+        for (size_t m = 0; m < std::min(width, n); ++m) {
+            row[width - 1 - m] = stock.returns[n - 1 - m];
+            present[width - 1 - m] = 1;
+        }
+    }
+
+    size_t count = 0;
+    double sum = 0.0;
+    for (size_t k = 0; k < width; ++k) {
+        if (!present[k]) continue;
+        sum += row[k];
+        ++count;
+    }
+    if (count < 2) {
+        std::fill(row, row + width, 0.0);
+        return;
+    }
+    const double mean = sum / count;
+    for (size_t k = 0; k < width; ++k) {
+        if (present[k]) row[k] -= mean;
+    }
+    normalize(row, width);
+}
+
+// Splits `rows` in two by spherical 2-means, seeded with the row least like
+// the whole and the row least like that one; falls back to halves in order
+// when the profiles do not separate (e.g. all flat)
+void bisect(const Profiles& profiles, const std::vector<uint32_t>& rows,
+            std::vector<uint32_t>& left, std::vector<uint32_t>& right) {
+    const size_t width = profiles.width;
+    std::vector<double> center0, center1;
+    profiles.centroid(rows, center0);
+    auto least_like = [&](const double* target, uint32_t skip) {
+        uint32_t best = skip == rows[0] ? rows[1] : rows[0];
+        double best_score = dot(profiles.row(best), target, width);
+        for (uint32_t r : rows) {
+            const double score = dot(profiles.row(r), target, width);
+            if (r != skip && score < best_score) {
+                best = r;
+                best_score = score;
+            }
+        }
+        return best;
+    };
+    const uint32_t seed0 = least_like(center0.data(), UINT32_MAX);
+    const uint32_t seed1 = least_like(profiles.row(seed0), seed0);
+    center0.assign(profiles.row(seed0), profiles.row(seed0) + width);
+    center1.assign(profiles.row(seed1), profiles.row(seed1) + width);
+
+    std::vector<unsigned char> side(rows.size(), 2);
+    for (int pass = 0; pass < kRefinements; ++pass) {
+        bool changed = false;
+        for (size_t r = 0; r < rows.size(); ++r) {
+            const double* values = profiles.row(rows[r]);
+            const unsigned char s = dot(values, center1.data(), width) > dot(values, center0.data(), width);
+            changed = changed || s != side[r];
+            side[r] = s;
+        }
+        left.clear();
+        right.clear();
+        for (size_t r = 0; r < rows.size(); ++r) (side[r] ? right : left).push_back(rows[r]);
+        if (!changed || left.empty() || right.empty()) break;
+        profiles.centroid(left, center0);
+        profiles.centroid(right, center1);
+    }
+
+    if (left.empty() || right.empty()) {
+        left.assign(rows.begin(), rows.begin() + rows.size() / 2);
+        right.assign(rows.begin() + rows.size() / 2, rows.end());
+    }
+}
+
+}
+
+PairUniverse::PairUniverse(const std::vector<std::unique_ptr<StockData>>& stocks,
+                           const std::vector<unsigned char>& include,
+                           const TradingCalendar* calendar,
+                           const Options& options)
+    : cluster_of_(stocks.size(), kNoCluster) {
+
+    std::vector<size_t> stock_of;
+    size_t longest = 0;
+    for (size_t s = 0; s < stocks.size(); ++s) {
+        if (!include[s] || !stocks[s]) continue;
+        stock_of.push_back(s);
+        longest = std::max(longest, stocks[s]->returns.size());
+    }
+    if (stock_of.empty()) return;
+
+    Profiles profiles;
+    const bool on_calendar = calendar && calendar->size() >= 2;
+    profiles.width = std::max<size_t>(1, std::min(options.window, on_calendar ? calendar->size() - 1 : longest));
+    profiles.values.assign(stock_of.size() * profiles.width, 0.0);
+    std::vector<unsigned char> present;
+    for (size_t r = 0; r < stock_of.size(); ++r) {
+        fillProfile(*stocks[stock_of[r]], stock_of[r], on_calendar ? calendar : nullptr, profiles.width,
+                    profiles.values.data() + r * profiles.width, present);
+    }
+
+    // Sector blocks, then bisection down to the size limit
+    std::map<std::string, std::vector<uint32_t>> blocks;
+    for (size_t r = 0; r < stock_of.size(); ++r) {
+        blocks[options.sector_blocks ? stocks[stock_of[r]]->sector : std::string()].push_back(static_cast<uint32_t>(r));
+    }
+    const size_t max_size = std::max<size_t>(2, options.max_cluster_size);
+    std::vector<std::vector<uint32_t>> pending, clusters;
+    for (auto& block : blocks) pending.push_back(std::move(block.second));
+    std::reverse(pending.begin(), pending.end());
+    while (!pending.empty()) {
+        std::vector<uint32_t> rows = std::move(pending.back());
+        pending.pop_back();
+        if (rows.size() <= max_size) {
+            clusters.push_back(std::move(rows));
+            continue;
+        }
+        std::vector<uint32_t> left, right;
+        bisect(profiles, rows, left, right);
+        pending.push_back(std::move(right));
+        pending.push_back(std::move(left));
+    }
+
+    const size_t count = clusters.size();
+    sizes_.resize(count);
+    std::vector<double> centroids(count * profiles.width);
+    std::vector<double> center;
+    for (size_t c = 0; c < count; ++c) {
+        sizes_[c] = clusters[c].size();
+        for (uint32_t r : clusters[c]) cluster_of_[stock_of[r]] = static_cast<uint32_t>(c);
+        profiles.centroid(clusters[c], center);
+        std::copy(center.begin(), center.end(), centroids.begin() + c * profiles.width);
+    }
+
+    // Each cluster's nearest clusters by mean profile, linked both ways
+    linked_.assign(count * count, 0);
+    const size_t neighbors = std::min(options.neighbors, count - 1);
+    std::vector<std::pair<double, size_t>> scores;
+    for (size_t c = 0; neighbors > 0 && c < count; ++c) {
+        scores.clear();
+        for (size_t d = 0; d < count; ++d) {
+            if (d == c) continue;
+            scores.emplace_back(-dot(&centroids[c * profiles.width], &centroids[d * profiles.width], profiles.width), d);
+        }
+        std::partial_sort(scores.begin(), scores.begin() + neighbors, scores.end());
+        for (size_t k = 0; k < neighbors; ++k) {
+            const size_t d = scores[k].second;
+            linked_[c * count + d] = 1;
+            linked_[d * count + c] = 1;
+        }
+    }
+}
+
+size_t PairUniverse::largestCluster() const {
+    return sizes_.empty() ? 0 : *std::max_element(sizes_.begin(), sizes_.end());
+}
+
+size_t PairUniverse::pairCount() const {
+    const size_t count = sizes_.size();
+    size_t pairs = 0;
+    for (size_t c = 0; c < count; ++c) {
+        pairs += sizes_[c] * (sizes_[c] - 1) / 2;
+        for (size_t d = c + 1; d < count; ++d) {
+            if (linked_[c * count + d]) pairs += sizes_[c] * sizes_[d];
+        }
+    }
+    return pairs;
+}
+
+size_t PairUniverse::fullPairCount() const {
+    size_t stocks = 0;
+    for (size_t size : sizes_) stocks += size;
+    return stocks * (stocks - 1) / 2;
+}
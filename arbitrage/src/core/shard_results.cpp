@@ -0,0 +1,163 @@
+#include "shard_results.h"
+#include "analysis_cache_format.h"
+#include "binary_file.h"
+#include <unordered_map>
+
+namespace {
+
+constexpr char kShardMagic[8] = {'M', 'F', 'T', 'S', 'H', 'A', 'R', 'D'};
+constexpr uint32_t kShardVersion = 1;
+
+struct ShardHeader {
+    char magic[8];
+    uint32_t version;
+    uint16_t cointegration_record_size;
+    uint16_t correlation_record_size;
+    uint32_t shard_index;
+    uint32_t shard_count;
+    uint64_t pairs_analyzed;
+    uint64_t cointegration_count;
+    uint64_t correlation_count;
+    uint64_t string_bytes;
+    uint8_t reserved[8];
+};
+static_assert(sizeof(ShardHeader) == 64, "ShardHeader layout is part of the file format");
+
+// Payloads with string table offsets for their symbols (and sectors); the
+// payload keys are unused
+struct ShardCointegration {
+    uint32_t stock1;
+    uint32_t stock2;
+    CachedCointegration result;
+};
+static_assert(sizeof(ShardCointegration) == 200, "ShardCointegration layout is part of the file format");
+
+struct ShardCorrelation {
+    uint32_t stock1;
+    uint32_t stock2;
+    uint32_t sector1;
+    uint32_t sector2;
+    CachedCorrelation result;
+};
+static_assert(sizeof(ShardCorrelation) == 152, "ShardCorrelation layout is part of the file format");
+
+// Each distinct string stored once
+class StringTable {
+public:
+    uint32_t add(const std::string& value) {
+        auto [it, inserted] = offsets_.emplace(value, static_cast<uint32_t>(bytes_.size()));
+        if (inserted) bytes_.insert(bytes_.end(), value.c_str(), value.c_str() + value.size() + 1);
+        return it->second;
+    }
+    const std::vector<char>& bytes() const { return bytes_; }
+
+private:
+    std::unordered_map<std::string, uint32_t> offsets_;
+    std::vector<char> bytes_;
+};
+
+}
+
+bool ShardResults::load(const std::string& path) {
+    cointegration.clear();
+    correlation.clear();
+
+    BinaryFileReader file;
+    ShardHeader header{};
+    if (!file.open(path, header, kShardMagic, kShardVersion) ||
+        header.cointegration_record_size != sizeof(ShardCointegration) ||
+        header.correlation_record_size != sizeof(ShardCorrelation) ||
+        header.shard_count == 0 || header.shard_index >= header.shard_count) return false;
+
+    // Counts are checked against the file size before anything is allocated
+    const uint64_t size = file.size();
+    if (header.cointegration_count > size / sizeof(ShardCointegration) ||
+        header.correlation_count > size / sizeof(ShardCorrelation) || header.string_bytes > size ||
+        sizeof(header) + header.cointegration_count * sizeof(ShardCointegration) +
+        header.correlation_count * sizeof(ShardCorrelation) + header.string_bytes != size) return false;
+
+    std::vector<ShardCointegration> cointegration_records(header.cointegration_count);
+    std::vector<ShardCorrelation> correlation_records(header.correlation_count);
+    std::vector<char> strings(header.string_bytes);
+    if (!file.read(cointegration_records.data(), cointegration_records.size() * sizeof(ShardCointegration)) ||
+        !file.read(correlation_records.data(), correlation_records.size() * sizeof(ShardCorrelation)) ||
+        !file.read(strings.data(), strings.size()) ||
+        (!strings.empty() && strings.back() != '\0')) return false;
+
+    // An offset is good if it lies in the table, which ends in a NUL
+    bool valid = true;
+    auto string_at = [&](uint32_t offset) {
+        if (offset >= strings.size()) {
+            valid = false;
+            return std::string();
+        }
+        return std::string(strings.data() + offset);
+    };
+
+    cointegration.resize(cointegration_records.size());
+    for (size_t r = 0; r < cointegration_records.size(); ++r) {
+        const ShardCointegration& record = cointegration_records[r];
+        fromRecord(record.result, cointegration[r]);
+        cointegration[r].stock1 = string_at(record.stock1);
+        cointegration[r].stock2 = string_at(record.stock2);
+    }
+    correlation.resize(correlation_records.size());
+    for (size_t r = 0; r < correlation_records.size(); ++r) {
+        const ShardCorrelation& record = correlation_records[r];
+        fromRecord(record.result, correlation[r]);
+        correlation[r].stock1 = string_at(record.stock1);
+        correlation[r].stock2 = string_at(record.stock2);
+        correlation[r].sector1 = string_at(record.sector1);
+        correlation[r].sector2 = string_at(record.sector2);
+    }
+    if (!valid) {
+        cointegration.clear();
+        correlation.clear();
+        return false;
+    }
+
+    shard_index = header.shard_index;
+    shard_count = header.shard_count;
+    pairs_analyzed = header.pairs_analyzed;
+    return true;
+}
+
+void ShardResults::save(const std::string& path) const {
+    StringTable strings;
+    std::vector<ShardCointegration> cointegration_records(cointegration.size());
+    for (size_t r = 0; r < cointegration.size(); ++r) {
+        ShardCointegration& record = cointegration_records[r];
+        record = ShardCointegration{};
+        toRecord(cointegration[r], record.result);
+        record.stock1 = strings.add(cointegration[r].stock1);
+        record.stock2 = strings.add(cointegration[r].stock2);
+    }
+    std::vector<ShardCorrelation> correlation_records(correlation.size());
+    for (size_t r = 0; r < correlation.size(); ++r) {
+        ShardCorrelation& record = correlation_records[r];
+        record = ShardCorrelation{};
+        toRecord(correlation[r], record.result);
+        record.stock1 = strings.add(correlation[r].stock1);
+        record.stock2 = strings.add(correlation[r].stock2);
+        record.sector1 = strings.add(correlation[r].sector1);
+        record.sector2 = strings.add(correlation[r].sector2);
+    }
+
+    ShardHeader header{};
+    stampHeader(header, kShardMagic, kShardVersion);
+    header.cointegration_record_size = sizeof(ShardCointegration);
+    header.correlation_record_size = sizeof(ShardCorrelation);
+    header.shard_index = shard_index;
+    header.shard_count = shard_count;
+    header.pairs_analyzed = pairs_analyzed;
+    header.cointegration_count = cointegration_records.size();
+    header.correlation_count = correlation_records.size();
+    header.string_bytes = strings.bytes().size();
+
+    AtomicFileWriter file(path, "shard results");
+    file.write(&header, sizeof(header));
+    file.write(cointegration_records.data(), cointegration_records.size() * sizeof(ShardCointegration));
+    file.write(correlation_records.data(), correlation_records.size() * sizeof(ShardCorrelation));
+    file.write(strings.bytes().data(), strings.bytes().size());
+    file.commit();
+}
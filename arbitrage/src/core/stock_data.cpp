@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <numeric>
 #include <cmath>
+#include <cstring>
 
 void StockData::calculateStatistics() {
     if (close.empty()) {
@@ -13,6 +14,16 @@ void StockData::calculateStatistics() {
     max_price = *std::max_element(close.begin(), close.end());
     mean_price = std::accumulate(close.begin(), close.end(), 0.0) / close.size();
     
+    // Centered prices and their sum of squares for pair regressions
+    centered_close.resize(close.size());
+    close_centered_sum_sq = 0.0;
+    for (size_t i = 0; i < close.size(); ++i) {
+        centered_close[i] = close[i] - mean_price;
+        close_centered_sum_sq += centered_close[i] * centered_close[i];
+    }
+    
+    content_hash = contentHash();
+    
     // Calculate volatility (standard deviation of returns)
     if (!returns.empty()) {
         mean_return = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
@@ -24,6 +35,16 @@ void StockData::calculateStatistics() {
         variance /= returns.size();
         volatility = std::sqrt(variance);
     }
+    
+    // Ranks are left to calculateReturnRanks: most stocks never reach a
+    // pair that passes the Pearson screen
+    return_ranks.clear();
+}
+
+void StockData::calculateReturnRanks() {
+    if (hasReturnRanks()) return;
+    return_ranks.resize(returns.size());
+    averageRanks(returns.data(), returns.size(), return_ranks.data());
 }
 
 void StockData::calculateReturns() {
@@ -43,3 +64,37 @@ void StockData::calculateReturns() {
         }
     }
 }
+
+uint64_t StockData::contentHash(size_t bars) const {
+    // One multiply-rotate round per 64-bit word; the bar count goes in first
+    // so a truncated series never matches the full one
+    bars = std::min(bars, close.size());
+    uint64_t hash = 0x9e3779b97f4a7c15ULL ^ bars;
+    auto mix = [&hash](uint64_t word) {
+        hash ^= word * 0xbf58476d1ce4e5b9ULL;
+        hash = ((hash << 31) | (hash >> 33)) * 0x94d049bb133111ebULL;
+    };
+    for (size_t i = 0; i < std::min(bars, timestamps.size()); ++i) {
+        mix(static_cast<uint64_t>(timestamps[i].time_since_epoch().count()));
+    }
+    for (size_t i = 0; i < bars; ++i) {
+        uint64_t word;
+        std::memcpy(&word, &close[i], sizeof(word));
+        mix(word);
+    }
+    return hash ^ (hash >> 29);
+}
+
+void averageRanks(const double* values, size_t n, double* ranks) {
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [values](uint32_t a, uint32_t b) { return values[a] < values[b]; });
+    for (size_t begin = 0; begin < n;) {
+        size_t end = begin + 1;
+        while (end < n && values[order[end]] == values[order[begin]]) ++end;
+        // Positions begin..end-1 share the mean of ranks begin+1..end
+        const double rank = 0.5 * static_cast<double>(begin + 1 + end);
+        for (size_t k = begin; k < end; ++k) ranks[order[k]] = rank;
+        begin = end;
+    }
+}
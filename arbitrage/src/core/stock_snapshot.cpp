@@ -0,0 +1,239 @@
+#include "stock_snapshot.h"
+#include "binary_file.h"
+#include "stable_hash.h"
+#include <algorithm>
+
+namespace {
+
+constexpr char kSnapshotMagic[8] = {'M', 'F', 'T', 'S', 'N', 'A', 'P', '\0'};
+constexpr uint32_t kSnapshotVersion = 1;
+constexpr size_t kColumnAlignment = 64;
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint16_t record_size;
+    uint16_t reserved0;
+    uint64_t stock_count;
+    uint64_t string_offset;
+    uint64_t string_size;
+    uint64_t data_offset;
+    uint8_t reserved[16];
+};
+static_assert(sizeof(SnapshotHeader) == 64, "SnapshotHeader layout is part of the file format");
+
+// Columns follow column_offset in this order, each padded to kColumnAlignment:
+// timestamps (timestamp_count), open, high, low, close, volume and
+// centered_close (bars each), returns and return_ranks (return_count each)
+struct SnapshotRecord {
+    uint64_t source_fingerprint;
+    uint64_t bars;
+    uint64_t timestamp_count;
+    uint64_t return_count;
+    uint64_t column_offset;
+    uint64_t content_hash;
+    uint32_t symbol;            // offsets into the string table
+    uint32_t sector;
+    uint32_t market_cap_bucket;
+    uint32_t flags;             // kRanksStored
+    double mean_price;
+    double mean_return;
+    double volatility;
+    double min_price;
+    double max_price;
+    double close_centered_sum_sq;
+};
+static_assert(sizeof(SnapshotRecord) == 112, "SnapshotRecord layout is part of the file format");
+
+constexpr size_t kPriceColumns = 6;     // open, high, low, close, volume, centered_close
+constexpr size_t kReturnColumns = 2;    // returns, return_ranks
+
+// The return_ranks column holds the stock's ranks; without it the column is
+// zeros and the ranks are computed again when a pair needs them
+constexpr uint32_t kRanksStored = 1;
+
+size_t padded(size_t bytes) {
+    return (bytes + kColumnAlignment - 1) / kColumnAlignment * kColumnAlignment;
+}
+
+size_t columnBytes(uint64_t bars, uint64_t timestamp_count, uint64_t return_count) {
+    return padded(timestamp_count * sizeof(int64_t)) + kPriceColumns * padded(bars * sizeof(double)) +
+           kReturnColumns * padded(return_count * sizeof(double));
+}
+
+}
+
+uint64_t StockSnapshot::sourceFingerprint(const std::string& path) {
+    // The bytes themselves: an edit that keeps the size and modification
+    // time (touch -r, copies preserving times, coarse clocks) still shows
+    const auto file = mapFileAtLeast(path, 1);
+    if (!file) return 0;
+    uint64_t hash = fnv1a(path.data(), path.size());
+    hash = fnv1a(file->data(), file->size(), hash);
+    return hash ? hash : 1;
+}
+
+bool StockSnapshot::load(const std::string& path) {
+    file_.reset();
+    index_.clear();
+
+    std::shared_ptr<MappedFile> file = mapBinaryFile<SnapshotHeader>(path, kSnapshotMagic, kSnapshotVersion);
+    if (!file) return false;
+
+    const size_t size = file->size();
+    const auto* header = reinterpret_cast<const SnapshotHeader*>(file->data());
+    if (header->record_size != sizeof(SnapshotRecord) ||
+        header->stock_count > (size - sizeof(SnapshotHeader)) / sizeof(SnapshotRecord) ||
+        header->string_offset > size || header->string_size > size - header->string_offset ||
+        header->string_size == 0 || file->data()[header->string_offset + header->string_size - 1] != '\0' ||
+        header->data_offset > size || header->data_offset % kColumnAlignment != 0) return false;
+
+    // Every record's strings and columns must lie inside the file
+    const auto* records = reinterpret_cast<const SnapshotRecord*>(file->data() + sizeof(SnapshotHeader));
+    for (size_t r = 0; r < header->stock_count; ++r) {
+        const SnapshotRecord& record = records[r];
+        const uint64_t limit = size / sizeof(double);
+        if (record.symbol >= header->string_size || record.sector >= header->string_size ||
+            record.market_cap_bucket >= header->string_size ||
+            record.bars > limit || record.timestamp_count > limit || record.return_count > limit ||
+            record.column_offset % kColumnAlignment != 0 || record.column_offset < header->data_offset ||
+            record.column_offset > size ||
+            columnBytes(record.bars, record.timestamp_count, record.return_count) > size - record.column_offset) {
+            index_.clear();
+            return false;
+        }
+        index_.emplace(record.source_fingerprint, r);
+    }
+    file_ = std::move(file);
+    return true;
+}
+
+std::unique_ptr<StockData> StockSnapshot::find(uint64_t source_fingerprint) const {
+    auto it = index_.find(source_fingerprint);
+    if (it == index_.end()) return nullptr;
+
+    const char* base = file_->data();
+    const auto* header = reinterpret_cast<const SnapshotHeader*>(base);
+    const auto& record = reinterpret_cast<const SnapshotRecord*>(base + sizeof(SnapshotHeader))[it->second];
+    const char* strings = base + header->string_offset;
+
+    auto stock = std::make_unique<StockData>();
+    stock->symbol = strings + record.symbol;
+    stock->sector = strings + record.sector;
+    stock->market_cap_bucket = strings + record.market_cap_bucket;
+
+    const char* column = base + record.column_offset;
+    const auto* ticks = reinterpret_cast<const int64_t*>(column);
+    stock->timestamps.reserve(record.timestamp_count);
+    for (size_t i = 0; i < record.timestamp_count; ++i) {
+        stock->timestamps.emplace_back(std::chrono::system_clock::duration(ticks[i]));
+    }
+    column += padded(record.timestamp_count * sizeof(int64_t));
+
+    auto copy = [&column](auto& values, uint64_t count) {
+        const auto* data = reinterpret_cast<const double*>(column);
+        values.assign(data, data + count);
+        column += padded(count * sizeof(double));
+    };
+    copy(stock->open, record.bars);
+    copy(stock->high, record.bars);
+    copy(stock->low, record.bars);
+    copy(stock->close, record.bars);
+    copy(stock->volume, record.bars);
+    copy(stock->centered_close, record.bars);
+    copy(stock->returns, record.return_count);
+    if (record.flags & kRanksStored) {
+        copy(stock->return_ranks, record.return_count);
+    }
+
+    stock->mean_price = record.mean_price;
+    stock->mean_return = record.mean_return;
+    stock->volatility = record.volatility;
+    stock->min_price = record.min_price;
+    stock->max_price = record.max_price;
+    stock->close_centered_sum_sq = record.close_centered_sum_sq;
+    stock->content_hash = record.content_hash;
+    return stock;
+}
+
+void StockSnapshot::save(const std::string& path,
+                         const std::vector<const StockData*>& stocks,
+                         const std::vector<uint64_t>& source_fingerprints) {
+    std::vector<SnapshotRecord> records;
+    std::vector<const StockData*> saved;
+    std::string strings(1, '\0');   // offset 0 is the empty string
+    auto intern = [&strings](const std::string& text) {
+        if (text.empty()) return uint32_t(0);
+        const size_t offset = strings.size();
+        strings.append(text).push_back('\0');
+        return static_cast<uint32_t>(offset);
+    };
+
+    for (size_t s = 0; s < stocks.size(); ++s) {
+        const StockData* stock = stocks[s];
+        if (!stock || source_fingerprints[s] == 0) continue;
+        SnapshotRecord record{};
+        record.source_fingerprint = source_fingerprints[s];
+        record.bars = stock->size();
+        record.timestamp_count = stock->timestamps.size();
+        record.return_count = stock->returns.size();
+        if (!stock->returns.empty() && stock->hasReturnRanks()) record.flags |= kRanksStored;
+        record.content_hash = stock->content_hash;
+        record.symbol = intern(stock->symbol);
+        record.sector = intern(stock->sector);
+        record.market_cap_bucket = intern(stock->market_cap_bucket);
+        record.mean_price = stock->mean_price;
+        record.mean_return = stock->mean_return;
+        record.volatility = stock->volatility;
+        record.min_price = stock->min_price;
+        record.max_price = stock->max_price;
+        record.close_centered_sum_sq = stock->close_centered_sum_sq;
+        // Columns a stock never filled are stored as zeros
+        records.push_back(record);
+        saved.push_back(stock);
+    }
+
+    SnapshotHeader header{};
+    stampHeader(header, kSnapshotMagic, kSnapshotVersion);
+    header.record_size = sizeof(SnapshotRecord);
+    header.stock_count = records.size();
+    header.string_offset = sizeof(SnapshotHeader) + records.size() * sizeof(SnapshotRecord);
+    header.string_size = strings.size();
+    header.data_offset = padded(header.string_offset + header.string_size);
+    uint64_t offset = header.data_offset;
+    for (SnapshotRecord& record : records) {
+        record.column_offset = offset;
+        offset += columnBytes(record.bars, record.timestamp_count, record.return_count);
+    }
+
+    AtomicFileWriter file(path, "stock snapshot");
+    const char zeros[sizeof(double)] = {};
+    file.write(&header, sizeof(header));
+    file.write(records.data(), records.size() * sizeof(SnapshotRecord));
+    file.write(strings.data(), strings.size());
+    file.pad(kColumnAlignment);
+
+    std::vector<int64_t> ticks;
+    auto column = [&](const double* values, size_t stored, size_t count) {
+        file.write(values, stored * sizeof(double));
+        for (size_t i = stored; i < count; ++i) file.write(zeros, sizeof(double));
+        file.pad(kColumnAlignment);
+    };
+    for (size_t r = 0; r < records.size(); ++r) {
+        const StockData& stock = *saved[r];
+        const size_t bars = records[r].bars, return_count = records[r].return_count;
+        ticks.clear();
+        for (const auto& timestamp : stock.timestamps) ticks.push_back(timestamp.time_since_epoch().count());
+        file.write(ticks.data(), ticks.size() * sizeof(int64_t));
+        file.pad(kColumnAlignment);
+        column(stock.open.data(), std::min(stock.open.size(), bars), bars);
+        column(stock.high.data(), std::min(stock.high.size(), bars), bars);
+        column(stock.low.data(), std::min(stock.low.size(), bars), bars);
+        column(stock.close.data(), bars, bars);
+        column(stock.volume.data(), std::min(stock.volume.size(), bars), bars);
+        column(stock.centered_close.data(), std::min(stock.centered_close.size(), bars), bars);
+        column(stock.returns.data(), return_count, return_count);
+        column(stock.return_ranks.data(), records[r].flags & kRanksStored ? return_count : 0, return_count);
+    }
+    file.commit();
+}
@@ -0,0 +1,174 @@
+#include "trading_calendar.h"
+#include <algorithm>
+#include <tuple>
+
+namespace {
+
+bool usableTimestamps(const StockData& stock) {
+    return !stock.close.empty() && stock.timestamps.size() == stock.close.size() &&
+           std::is_sorted(stock.timestamps.begin(), stock.timestamps.end()) &&
+           std::adjacent_find(stock.timestamps.begin(), stock.timestamps.end()) == stock.timestamps.end();
+}
+
+}
+
+TradingCalendar::TradingCalendar(const std::vector<std::unique_ptr<StockData>>& stocks)
+    : alignments_(stocks.size()) {
+    
+    // Union of the per-stock calendars: every usable timestamp once, then a
+    // single sort and unique
+    size_t total = 0;
+    for (const auto& stock : stocks) {
+        if (stock && usableTimestamps(*stock)) total += stock->timestamps.size();
+    }
+    bars_.reserve(total);
+    for (const auto& stock : stocks) {
+        if (!stock || !usableTimestamps(*stock)) continue;
+        bars_.insert(bars_.end(), stock->timestamps.begin(), stock->timestamps.end());
+    }
+    std::sort(bars_.begin(), bars_.end());
+    bars_.erase(std::unique(bars_.begin(), bars_.end()), bars_.end());
+    bars_.shrink_to_fit();
+    
+    for (size_t s = 0; s < stocks.size(); ++s) {
+        if (!stocks[s] || !usableTimestamps(*stocks[s])) continue;
+        const auto& timestamps = stocks[s]->timestamps;
+        CalendarAlignment& alignment = alignments_[s];
+        alignment.aligned = true;
+        alignment.offset = std::lower_bound(bars_.begin(), bars_.end(), timestamps.front()) - bars_.begin();
+        const size_t last = std::lower_bound(bars_.begin(), bars_.end(), timestamps.back()) - bars_.begin();
+        alignment.span = last - alignment.offset + 1;
+        alignment.gap_free = alignment.span == timestamps.size();
+        alignment.first_word = alignment.offset / 64;
+        alignment.presence.assign(last / 64 - alignment.first_word + 1, 0);
+        
+        // Both sequences ascend, so one forward walk places every bar
+        size_t bar = alignment.offset;
+        for (const auto& timestamp : timestamps) {
+            while (bars_[bar] < timestamp) ++bar;
+            alignment.presence[bar / 64 - alignment.first_word] |= uint64_t{1} << (bar % 64);
+        }
+        alignment.rank.resize(alignment.presence.size());
+        uint32_t count = 0;
+        for (size_t w = 0; w < alignment.presence.size(); ++w) {
+            alignment.rank[w] = count;
+            count += static_cast<uint32_t>(__builtin_popcountll(alignment.presence[w]));
+        }
+    }
+    
+    // Number the distinct bar sets once, so sameBars() is one compare per
+    // pair: the offset and presence words fix a stock's bars
+    std::vector<size_t> order;
+    for (size_t s = 0; s < stocks.size(); ++s) {
+        if (alignments_[s].aligned) order.push_back(s);
+    }
+    auto key = [&](size_t s) { return std::tie(alignments_[s].offset, alignments_[s].presence); };
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return key(a) < key(b); });
+    uint32_t bar_set = 0;
+    for (size_t k = 0; k < order.size(); ++k) {
+        if (k > 0 && key(order[k - 1]) != key(order[k])) ++bar_set;
+        alignments_[order[k]].bar_set = bar_set;
+    }
+}
+
+size_t TradingCalendar::commonBarCount(size_t a, size_t b) const {
+    const CalendarAlignment& x = alignments_[a];
+    const CalendarAlignment& y = alignments_[b];
+    if (!x.aligned || !y.aligned) return 0;
+    const size_t begin = std::max(x.offset, y.offset);
+    const size_t end = std::min(x.offset + x.span, y.offset + y.span);
+    if (begin >= end) return 0;
+    if (x.gap_free && y.gap_free) return end - begin;
+    
+    // Bits outside either span are zero in that stock's words
+    size_t count = 0;
+    for (size_t w = begin / 64; w <= (end - 1) / 64; ++w) {
+        count += __builtin_popcountll(x.presence[w - x.first_word] & y.presence[w - y.first_word]);
+    }
+    return count;
+}
+
+size_t TradingCalendar::barIndex(const CalendarAlignment& alignment, size_t bar) {
+    if (alignment.gap_free) return bar - alignment.offset;
+    const size_t w = bar / 64 - alignment.first_word;
+    const uint64_t below = alignment.presence[w] & ((uint64_t{1} << (bar % 64)) - 1);
+    return alignment.rank[w] + __builtin_popcountll(below);
+}
+
+void TradingCalendar::commonBars(size_t a, size_t b, std::vector<uint32_t>& index_a,
+                                 std::vector<uint32_t>& index_b, size_t from_bar) const {
+    index_a.clear();
+    index_b.clear();
+    const CalendarAlignment& x = alignments_[a];
+    const CalendarAlignment& y = alignments_[b];
+    if (!x.aligned || !y.aligned) return;
+    const size_t begin = std::max({x.offset, y.offset, from_bar});
+    const size_t end = std::min(x.offset + x.span, y.offset + y.span);
+    if (begin >= end) return;
+    
+    if (x.gap_free && y.gap_free) {
+        // Two contiguous slices
+        for (size_t bar = begin; bar < end; ++bar) {
+            index_a.push_back(static_cast<uint32_t>(bar - x.offset));
+            index_b.push_back(static_cast<uint32_t>(bar - y.offset));
+        }
+        return;
+    }
+    for (size_t w = begin / 64; w <= (end - 1) / 64; ++w) {
+        uint64_t common = x.presence[w - x.first_word] & y.presence[w - y.first_word];
+        if (w == begin / 64) common &= ~0ULL << (begin % 64);
+        while (common) {
+            const size_t bar = w * 64 + __builtin_ctzll(common);
+            index_a.push_back(static_cast<uint32_t>(barIndex(x, bar)));
+            index_b.push_back(static_cast<uint32_t>(barIndex(y, bar)));
+            common &= common - 1;
+        }
+    }
+}
+
+size_t TradingCalendar::barAfter(time_point time) const {
+    return std::upper_bound(bars_.begin(), bars_.end(), time) - bars_.begin();
+}
+
+void TradingCalendar::gatherCommonBars(const StockData& stock_a, size_t a, const StockData& stock_b, size_t b,
+                                       CommonBarSeries& out) const {
+    commonBars(a, b, out.index_a, out.index_b);
+    const size_t bars = out.index_a.size();
+    
+    auto gather = [bars](const StockData& stock, const std::vector<uint32_t>& index,
+                         std::vector<double>& close, std::vector<double>& returns) {
+        close.resize(bars);
+        returns.resize(bars > 0 ? bars - 1 : 0);
+        for (size_t k = 0; k < bars; ++k) close[k] = stock.close[index[k]];
+        for (size_t k = 1; k < bars; ++k) {
+            returns[k - 1] = close[k - 1] != 0.0 ? (close[k] - close[k - 1]) / close[k - 1] : 0.0;
+        }
+    };
+    gather(stock_a, out.index_a, out.close_a, out.returns_a);
+    gather(stock_b, out.index_b, out.close_b, out.returns_b);
+}
+
+void TradingCalendar::alignPair(const StockData& stock_a, size_t a, const StockData& stock_b, size_t b,
+                                StockData& out_a, StockData& out_b) const {
+    thread_local std::vector<uint32_t> index_a, index_b;
+    commonBars(a, b, index_a, index_b);
+    
+    auto cut = [](const StockData& stock, const std::vector<uint32_t>& index, StockData& out) {
+        out.symbol = stock.symbol;
+        out.sector = stock.sector;
+        out.market_cap_bucket = stock.market_cap_bucket;
+        out.timestamps.clear();
+        out.close.clear();
+        out.returns.clear();
+        out.timestamps.reserve(index.size());
+        out.close.reserve(index.size());
+        for (uint32_t i : index) {
+            out.timestamps.push_back(stock.timestamps[i]);
+            out.close.push_back(stock.close[i]);
+        }
+        out.calculateReturns();
+        out.calculateStatistics();
+    };
+    cut(stock_a, index_a, out_a);
+    cut(stock_b, index_b, out_b);
+}
@@ -125,6 +125,35 @@ bool CSVExporter::exportOpportunitiesCSV(
     return true;
 }
 
+bool CSVExporter::exportBacktestGridCSV(
+    const std::vector<PairsBacktestEngine::Rule>& rules,
+    const std::vector<PairsBacktestEngine::Metrics>& metrics,
+    const std::string& output_path) {
+    
+    std::ofstream file(output_path);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    file << "Entry_Z,Exit_Z,Stop_Z,Max_Holding,Trades,Win_Rate,Total_PnL,Expected_Return,Sharpe_Ratio,Turnover\n";
+    for (size_t r = 0; r < rules.size() && r < metrics.size(); ++r) {
+        const auto& rule = rules[r];
+        const auto& m = metrics[r];
+        file << std::fixed << std::setprecision(2) << rule.entry_z << ","
+             << std::fixed << std::setprecision(2) << rule.exit_z << ","
+             << std::fixed << std::setprecision(2) << rule.stop_z << ","
+             << rule.max_holding << ","
+             << m.trades << ","
+             << std::fixed << std::setprecision(6) << m.winRate() << ","
+             << std::fixed << std::setprecision(6) << m.pnl() << ","
+             << std::fixed << std::setprecision(6) << m.expectedReturn() << ","
+             << std::fixed << std::setprecision(6) << m.sharpeRatio() << ","
+             << std::fixed << std::setprecision(6) << m.turnover() << "\n";
+    }
+    
+    return true;
+}
+
 bool CSVExporter::exportAllToCSV(
     const std::vector<CointegrationResult>& cointegration_results,
     const std::vector<CorrelationResult>& correlation_results,
@@ -0,0 +1,154 @@
+#include "tiled_matrix_writer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+size_t alignUp(size_t value) {
+    return (value + 63) / 64 * 64;
+}
+
+// A 2 x 2 block's summary under `reduction`, NaN when every cell is NaN
+float reduce(MatrixReduction reduction, const float (&cells)[4]) {
+    float result = std::numeric_limits<float>::quiet_NaN();
+    for (float value : cells) {
+        if (std::isnan(value)) continue;
+        if (std::isnan(result)) {
+            result = value;
+        } else if (reduction == MatrixReduction::Minimum) {
+            result = std::min(result, value);
+        } else if (std::fabs(value) > std::fabs(result)) {
+            result = value;
+        }
+    }
+    return result;
+}
+
+}
+
+TiledMatrixWriter::TiledMatrixWriter(const std::string& path, const std::vector<std::string>& symbols,
+                                     const std::vector<Layer>& layers)
+    : path_(path), temporary_(path + ".tmp"), size_(symbols.size()) {
+    if (size_ == 0 || layers.empty()) throw std::runtime_error("Empty matrix: " + path);
+    tiles0_ = tiled_matrix_tiles(size_, kTiledMatrixTile, 0);
+    levels_ = tiled_matrix_levels(size_, kTiledMatrixTile);
+
+    TiledMatrixHeader header{};
+    std::memcpy(header.magic, kTiledMatrixMagic, sizeof(kTiledMatrixMagic));
+    header.version = kTiledMatrixVersion;
+    header.size = static_cast<uint32_t>(size_);
+    header.tile = kTiledMatrixTile;
+    header.level_count = levels_;
+    header.layer_count = static_cast<uint32_t>(layers.size());
+    header.names_offset = sizeof(TiledMatrixHeader);
+    for (const auto& symbol : symbols) header.names_bytes += symbol.size() + 1;
+    header.layers_offset = alignUp(header.names_offset + header.names_bytes);
+
+    level_offsets_.resize(levels_);
+    size_t level_offset = 0;
+    for (uint32_t level = 0; level < levels_; ++level) {
+        level_offsets_[level] = level_offset;
+        const size_t tiles = tiled_matrix_tiles(size_, kTiledMatrixTile, level);
+        level_offset += tiles * tiles * kTiledMatrixTile * kTiledMatrixTile * sizeof(float);
+    }
+    const size_t layer_bytes = tiled_matrix_layer_bytes(size_, kTiledMatrixTile, levels_);
+    size_t data_offset = alignUp(header.layers_offset + layers.size() * sizeof(TiledMatrixLayer));
+    for (size_t l = 0; l < layers.size(); ++l) {
+        layer_offsets_.push_back(data_offset);
+        reductions_.push_back(layers[l].reduction);
+        data_offset += layer_bytes;
+    }
+    bytes_ = data_offset;
+
+    const std::filesystem::path target(path);
+    if (target.has_parent_path()) std::filesystem::create_directories(target.parent_path());
+    fd_ = open(temporary_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ == -1) throw std::runtime_error("Cannot create file: " + temporary_);
+    void* mapped = ftruncate(fd_, static_cast<off_t>(bytes_)) == 0
+                       ? mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0)
+                       : MAP_FAILED;
+    if (mapped == MAP_FAILED) {
+        close(fd_);
+        std::remove(temporary_.c_str());
+        throw std::runtime_error("Cannot map file: " + temporary_);
+    }
+    base_ = static_cast<uint8_t*>(mapped);
+
+    std::memcpy(base_, &header, sizeof(header));
+    char* names = reinterpret_cast<char*>(base_ + header.names_offset);
+    for (const auto& symbol : symbols) {
+        std::memcpy(names, symbol.c_str(), symbol.size() + 1);
+        names += symbol.size() + 1;
+    }
+    auto* directory = reinterpret_cast<TiledMatrixLayer*>(base_ + header.layers_offset);
+    for (size_t l = 0; l < layers.size(); ++l) {
+        std::strncpy(directory[l].name, layers[l].name.c_str(), sizeof(directory[l].name) - 1);
+        directory[l].reduction = static_cast<uint32_t>(layers[l].reduction);
+        directory[l].display_min = layers[l].display_min;
+        directory[l].display_max = layers[l].display_max;
+        directory[l].data_offset = layer_offsets_[l];
+        // Level 0 starts out all missing; the coarser levels are written by finish()
+        float* cells = level_data(l, 0);
+        std::fill(cells, cells + tiles0_ * tiles0_ * kTiledMatrixTile * kTiledMatrixTile,
+                  std::numeric_limits<float>::quiet_NaN());
+    }
+}
+
+TiledMatrixWriter::~TiledMatrixWriter() {
+    unmap();
+    if (!finished_) std::remove(temporary_.c_str());
+}
+
+void TiledMatrixWriter::finish() {
+    for (size_t layer = 0; layer < layer_offsets_.size(); ++layer) {
+        for (uint32_t level = 1; level < levels_; ++level) reduceLevel(layer, level);
+    }
+    const bool synced = msync(base_, bytes_, MS_SYNC) == 0;
+    unmap();
+    if (!synced || std::rename(temporary_.c_str(), path_.c_str()) != 0) {
+        throw std::runtime_error("Error writing matrix file: " + temporary_);
+    }
+    finished_ = true;
+}
+
+void TiledMatrixWriter::reduceLevel(size_t layer, uint32_t level) {
+    constexpr size_t tile = kTiledMatrixTile;
+    const size_t below_tiles = tiled_matrix_tiles(size_, tile, level - 1);
+    const size_t tiles = tiled_matrix_tiles(size_, tile, level);
+    const float* below = level_data(layer, level - 1);
+    float* out = level_data(layer, level);
+    // Cells of the level below past its tiles (the last odd row or column) are missing
+    auto source = [&](size_t row, size_t col) {
+        if (row >= below_tiles * tile || col >= below_tiles * tile) return std::numeric_limits<float>::quiet_NaN();
+        return below[((row / tile) * below_tiles + col / tile) * tile * tile + (row % tile) * tile + col % tile];
+    };
+    for (size_t tr = 0; tr < tiles; ++tr) {
+        for (size_t tc = 0; tc < tiles; ++tc) {
+            float* cells = out + (tr * tiles + tc) * tile * tile;
+            for (size_t r = 0; r < tile; ++r) {
+                const size_t row = 2 * (tr * tile + r);
+                for (size_t c = 0; c < tile; ++c) {
+                    const size_t col = 2 * (tc * tile + c);
+                    const float block[4] = {source(row, col), source(row, col + 1),
+                                            source(row + 1, col), source(row + 1, col + 1)};
+                    cells[r * tile + c] = reduce(reductions_[layer], block);
+                }
+            }
+        }
+    }
+}
+
+void TiledMatrixWriter::unmap() {
+    if (base_) munmap(base_, bytes_);
+    if (fd_ != -1) close(fd_);
+    base_ = nullptr;
+    fd_ = -1;
+}
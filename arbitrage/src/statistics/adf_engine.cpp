@@ -0,0 +1,78 @@
+#include "adf_engine.h"
+#include "simd_dispatch.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+
+std::vector<BatchADFEngine::Result> BatchADFEngine::run(
+    const std::vector<const std::vector<double>*>& series,
+    const Options& options) {
+    
+    std::vector<Result> results(series.size());
+    
+    // Equal lengths share a pass
+    std::map<size_t, std::vector<size_t>> by_length;
+    for (size_t s = 0; s < series.size(); ++s) {
+        if (series[s] && series[s]->size() >= kMinLength) by_length[series[s]->size()].push_back(s);
+    }
+    
+    const SimdKernels& kernels = simd_kernels();
+    const size_t lanes = kernels.lanes;
+    std::vector<double> packed, coef, var, rss;
+    
+    for (const auto& [rows, members] : by_length) {
+        const size_t max_lag = std::min({static_cast<size_t>(std::max(0, options.max_lags)), rows / 4,
+                                         SimdKernels::adf_max_lag});
+        const size_t samples = rows - max_lag - 1;
+        packed.resize(rows * lanes);
+        coef.resize((max_lag + 1) * lanes);
+        var.resize(coef.size());
+        rss.resize(coef.size());
+        
+        for (size_t g = 0; g < members.size(); g += lanes) {
+            // A short last group repeats its final series
+            for (size_t l = 0; l < lanes; ++l) {
+                const auto& y = *series[members[std::min(g + l, members.size() - 1)]];
+                for (size_t t = 0; t < rows; ++t) packed[t * lanes + l] = y[t];
+            }
+            kernels.adf_lanes(packed.data(), rows, max_lag, coef.data(), var.data(), rss.data());
+            
+            for (size_t l = 0; l < lanes && g + l < members.size(); ++l) {
+                // Every lag order is fitted on the same sample, so the
+                // criteria compare like with like
+                size_t best = max_lag;
+                if (options.selection != LagSelection::Fixed) {
+                    const double penalty = options.selection == LagSelection::AIC ? 2.0 : std::log(double(samples));
+                    double best_criterion = std::numeric_limits<double>::max();
+                    for (size_t p = 0; p <= max_lag; ++p) {
+                        const double residual = rss[p * lanes + l];
+                        if (!(residual > 0.0)) continue;
+                        const double criterion = samples * std::log(residual / samples) + penalty * (p + 2);
+                        if (criterion < best_criterion) {
+                            best = p;
+                            best_criterion = criterion;
+                        }
+                    }
+                }
+                
+                Result& result = results[members[g + l]];
+                const double residual = rss[best * lanes + l];
+                const double variance = var[best * lanes + l];
+                const size_t parameters = best + 2;
+                result.lags = static_cast<int>(best);
+                if (residual > 0.0 && variance > 0.0 && samples > parameters) {
+                    const double sigma2 = residual / (samples - parameters);
+                    result.statistic = coef[best * lanes + l] / std::sqrt(sigma2 * variance);
+                    result.valid = true;
+                }
+            }
+        }
+    }
+    
+    return results;
+}
+
+BatchADFEngine::Result BatchADFEngine::run(const std::vector<double>& series, const Options& options) {
+    return run(std::vector<const std::vector<double>*>{&series}, options).front();
+}
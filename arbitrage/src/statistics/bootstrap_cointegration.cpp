@@ -0,0 +1,218 @@
+#include "bootstrap_cointegration.h"
+#include "counter_rng.h"
+#include "hardware_counters.h"
+#include "simd_statistics.h"
+#include "stable_hash.h"
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+// Replicates whose spreads share one batched ADF call
+constexpr size_t kRunLength = 64;
+
+// The pair's stream key: its symbols, so a pair draws the same numbers
+// wherever it sits in the input
+uint64_t streamKey(const StockData& stock1, const StockData& stock2, uint64_t seed) {
+    // Each symbol ends in a 0xff byte, so ("AB", "C") and ("A", "BC") differ
+    static constexpr unsigned char kEnd = 0xff;
+    uint64_t hash = kFnv1aBasis;
+    auto mix = [&hash](const std::string& text) {
+        hash = fnv1a(text.data(), text.size(), hash);
+        hash = fnv1a(&kEnd, 1, hash);
+    };
+    mix(stock1.symbol);
+    mix(stock2.symbol);
+    uint64_t z = seed + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return hash ^ z ^ (z >> 31);
+}
+
+// Order in which replicate r takes the m bar-to-bar changes
+void resampleOrder(const Philox4x32& rng, uint64_t replicate, size_t m, size_t block_length,
+                   BootstrapCointegrationEngine::Method method, std::vector<uint32_t>& order) {
+    order.resize(m);
+    Philox4x32::Block draws{};
+    uint64_t counter = 0;
+    size_t used = draws.size();
+    auto next = [&]() {
+        if (used == draws.size()) {
+            draws = rng(replicate, counter++);
+            used = 0;
+        }
+        return draws[used++];
+    };
+    
+    if (method == BootstrapCointegrationEngine::Method::Permutation) {
+        for (size_t i = 0; i < m; ++i) order[i] = static_cast<uint32_t>(i);
+        for (size_t i = m - 1; i > 0; --i) {
+            std::swap(order[i], order[Philox4x32::below(next(), static_cast<uint32_t>(i + 1))]);
+        }
+        return;
+    }
+    const uint32_t starts = static_cast<uint32_t>(m - block_length + 1);
+    for (size_t t = 0; t < m; t += block_length) {
+        const uint32_t start = Philox4x32::below(next(), starts);
+        for (size_t k = 0; k < block_length && t + k < m; ++k) {
+            order[t + k] = start + static_cast<uint32_t>(k);
+        }
+    }
+}
+
+// Spread of the rebuilt paths against their own hedge regression
+void replicateSpread(const StockData& stock1, const StockData& stock2, const std::vector<uint32_t>& order,
+                     std::vector<double>& x, std::vector<double>& y, std::vector<double>& spread) {
+    const size_t n = stock1.close.size();
+    x.resize(n);
+    y.resize(n);
+    x[0] = stock1.close[0];
+    y[0] = stock2.close[0];
+    double sum_x = x[0], sum_y = y[0];
+    for (size_t t = 1; t < n; ++t) {
+        const uint32_t k = order[t - 1];
+        x[t] = x[t - 1] + (stock1.close[k + 1] - stock1.close[k]);
+        y[t] = y[t - 1] + (stock2.close[k + 1] - stock2.close[k]);
+        sum_x += x[t];
+        sum_y += y[t];
+    }
+    const double mean_x = sum_x / n, mean_y = sum_y / n;
+    double sxx = 0.0, sxy = 0.0;
+    for (size_t t = 0; t < n; ++t) {
+        const double dx = x[t] - mean_x;
+        sxx += dx * dx;
+        sxy += dx * (y[t] - mean_y);
+    }
+    const double hedge_ratio = sxx > 0.0 ? sxy / sxx : 0.0;
+    spread.resize(n);
+    for (size_t t = 0; t < n; ++t) spread[t] = y[t] - hedge_ratio * x[t];
+}
+
+}
+
+std::vector<BootstrapCointegrationEngine::Result> BootstrapCointegrationEngine::run(
+    const std::vector<std::pair<const StockData*, const StockData*>>& pairs,
+    const Options& options) {
+    
+    std::vector<Result> results(pairs.size());
+    if (pairs.empty() || options.replicates == 0) {
+        return results;
+    }
+    
+    // Observed spreads, as EnhancedCointegrationAnalyzer tests them
+    std::vector<size_t> tested;
+    std::vector<std::vector<double>> observed;
+    for (size_t p = 0; p < pairs.size(); ++p) {
+        const StockData* stock1 = pairs[p].first;
+        const StockData* stock2 = pairs[p].second;
+        if (!stock1 || !stock2 || stock1->close.size() != stock2->close.size() ||
+            stock1->close.size() <= BatchADFEngine::kMinLength) continue;
+        const auto regression = SIMDCointegrationAnalyzer::regressPair_SIMD(*stock1, *stock2);
+        std::vector<double> spread(stock1->close.size());
+        for (size_t t = 0; t < spread.size(); ++t) {
+            spread[t] = stock2->close[t] - regression.hedge_ratio * stock1->close[t];
+        }
+        tested.push_back(p);
+        observed.push_back(std::move(spread));
+    }
+    std::vector<const std::vector<double>*> observed_series;
+    for (const auto& spread : observed) observed_series.push_back(&spread);
+    const auto observed_adf = BatchADFEngine::run(observed_series, options.adf);
+    
+    // Tasks of kRunLength replicates of one pair
+    struct Task {
+        size_t pair;                // index into tested
+        size_t first_replicate;
+    };
+    std::vector<Task> tasks;
+    std::vector<size_t> costs;
+    for (size_t k = 0; k < tested.size(); ++k) {
+        if (!observed_adf[k].valid) continue;
+        for (size_t r = 0; r < options.replicates; r += kRunLength) {
+            tasks.push_back({k, r});
+            costs.push_back(std::min(kRunLength, options.replicates - r) * observed[k].size());
+        }
+    }
+    
+    // Replicate statistics by pair and replicate, with a flag per usable
+    // fit (no infinity sentinels: the build uses -ffast-math)
+    std::vector<std::vector<double>> statistics(tested.size());
+    std::vector<std::vector<unsigned char>> usable(tested.size());
+    for (size_t k = 0; k < tested.size(); ++k) {
+        if (!observed_adf[k].valid) continue;
+        statistics[k].assign(options.replicates, 0.0);
+        usable[k].assign(options.replicates, 0);
+    }
+    
+    struct Scratch {
+        std::vector<uint32_t> order;
+        std::vector<double> x, y;
+        std::vector<std::vector<double>> spreads{kRunLength};
+        std::vector<const std::vector<double>*> series;
+    };
+    const unsigned threads = options.num_threads > 0 ? options.num_threads :
+                             std::max(1u, std::thread::hardware_concurrency());
+    ScopedCounters counters("kernel: bootstrap resampling");
+    WorkStealingPool pool(threads);
+    pool.set_trace_label("resample batch");
+    std::vector<Scratch> scratch(pool.size());
+    
+    pool.run(costs, [&](size_t t, unsigned worker) {
+        const Task& task = tasks[t];
+        const StockData& stock1 = *pairs[tested[task.pair]].first;
+        const StockData& stock2 = *pairs[tested[task.pair]].second;
+        const Philox4x32 rng(streamKey(stock1, stock2, options.seed));
+        const size_t m = stock1.close.size() - 1;
+        const size_t block_length = std::min(m, options.block_length > 0 ? options.block_length :
+            std::max<size_t>(1, static_cast<size_t>(std::lround(std::cbrt(static_cast<double>(m + 1))))));
+        
+        Scratch& local = scratch[worker];
+        const size_t count = std::min(kRunLength, options.replicates - task.first_replicate);
+        local.series.clear();
+        for (size_t r = 0; r < count; ++r) {
+            resampleOrder(rng, task.first_replicate + r, m, block_length, options.method, local.order);
+            replicateSpread(stock1, stock2, local.order, local.x, local.y, local.spreads[r]);
+            local.series.push_back(&local.spreads[r]);
+        }
+        const auto adf = BatchADFEngine::run(local.series, options.adf);
+        for (size_t r = 0; r < count; ++r) {
+            statistics[task.pair][task.first_replicate + r] = adf[r].statistic;
+            usable[task.pair][task.first_replicate + r] = adf[r].valid;
+        }
+    });
+    
+    for (size_t k = 0; k < tested.size(); ++k) {
+        if (!observed_adf[k].valid) continue;
+        Result& result = results[tested[k]];
+        result.statistic = observed_adf[k].statistic;
+        
+        std::vector<double> replicates;
+        replicates.reserve(options.replicates);
+        for (size_t r = 0; r < options.replicates; ++r) {
+            if (usable[k][r]) replicates.push_back(statistics[k][r]);
+        }
+        if (replicates.empty()) continue;
+        std::sort(replicates.begin(), replicates.end());
+        
+        // (1 + at or below) / (1 + replicates), so the p-value is never 0
+        const size_t below = std::upper_bound(replicates.begin(), replicates.end(), result.statistic) -
+                             replicates.begin();
+        result.p_value = static_cast<double>(below + 1) / (replicates.size() + 1);
+        auto quantile = [&](double q) {
+            return replicates[static_cast<size_t>(q * (replicates.size() - 1))];
+        };
+        result.critical_value_1pct = quantile(0.01);
+        result.critical_value_5pct = quantile(0.05);
+        result.critical_value_10pct = quantile(0.10);
+        result.valid = true;
+    }
+    
+    return results;
+}
+
+BootstrapCointegrationEngine::Result BootstrapCointegrationEngine::run(
+    const StockData& stock1, const StockData& stock2, const Options& options) {
+    return run({{&stock1, &stock2}}, options).front();
+}
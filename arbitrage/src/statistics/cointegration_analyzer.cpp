@@ -1,4 +1,6 @@
 #include "simd_statistics.h"
+#include "simd_dispatch.h"
+#include "adf_engine.h"
 #include <algorithm>
 #include <numeric>
 #include <cmath>
@@ -15,51 +17,60 @@ public:
         const StockData& stock2,
         double significance_level = 0.05) {
         
-        CointegrationResult result;
-        result.stock1 = stock1.symbol;
-        result.stock2 = stock2.symbol;
-        
-        if (stock1.close.size() != stock2.close.size() || stock1.close.size() < 50) {
-            result.is_cointegrated = false;
-            result.p_value = 1.0;
-            return result;
-        }
-        
-        // Step 1: Estimate hedge ratio using linear regression
-        auto regression_result = estimateHedgeRatio(stock1.close, stock2.close);
-        result.hedge_ratio = regression_result.second; // beta (slope)
-        double alpha = regression_result.first; // intercept
-        
-        // Step 2: Calculate spread (residuals)
-        std::vector<double> spread = calculateSpread(stock1.close, stock2.close, result.hedge_ratio);
-        
-        // Step 3: Perform Augmented Dickey-Fuller test on spread
-        auto adf_result = augmentedDickeyFullerTest(spread);
-        result.adf_statistic = adf_result.test_statistic;
-        result.p_value = adf_result.p_value;
-        
-        // Set critical values
-        result.critical_value_1pct = -3.43;
-        result.critical_value_5pct = -2.86;
-        result.critical_value_10pct = -2.57;
-        
-        // Determine if cointegrated
-        result.is_cointegrated = (result.adf_statistic < result.critical_value_5pct) && 
-                                (result.p_value < significance_level);
-        
-        // Calculate spread statistics
-        calculateSpreadStatistics(spread, result);
-        
-        // Calculate half-life of mean reversion
-        result.half_life = calculateHalfLife(spread);
+        return analyzeBatch({{&stock1, &stock2}}, significance_level).front();
+    }
+    
+    // Cointegration analysis of many pairs with one batched ADF pass over
+    // their spreads, kBatchPairs at a time
+    static std::vector<CointegrationResult> analyzeBatch(
+        const std::vector<std::pair<const StockData*, const StockData*>>& stock_pairs,
+        double significance_level = 0.05) {
         
-        // Generate trading signals and metrics
-        generateTradingMetrics(spread, result);
+        std::vector<CointegrationResult> results(stock_pairs.size());
+        std::vector<SIMDCointegrationAnalyzer::HedgeRegression> regressions(kBatchPairs);
+        std::vector<std::vector<double>> spreads(kBatchPairs);
+        std::vector<const std::vector<double>*> tested;
+        std::vector<size_t> tested_pairs;
         
-        // Assign grade based on statistical significance
-        result.cointegration_grade = assignGrade(result);
+        for (size_t begin = 0; begin < stock_pairs.size(); begin += kBatchPairs) {
+            const size_t end = std::min(stock_pairs.size(), begin + kBatchPairs);
+            tested.clear();
+            tested_pairs.clear();
+            
+            for (size_t p = begin; p < end; ++p) {
+                const StockData& stock1 = *stock_pairs[p].first;
+                const StockData& stock2 = *stock_pairs[p].second;
+                CointegrationResult& result = results[p];
+                result.stock1 = stock1.symbol;
+                result.stock2 = stock2.symbol;
+                
+                if (stock1.close.size() != stock2.close.size() || stock1.close.size() < 50) {
+                    result.is_cointegrated = false;
+                    result.p_value = 1.0;
+                    continue;
+                }
+                
+                // Step 1: Estimate hedge ratio from the per-stock price moments
+                auto& regression = regressions[p - begin];
+                regression = SIMDCointegrationAnalyzer::regressPair_SIMD(stock1, stock2);
+                result.hedge_ratio = regression.hedge_ratio;
+                
+                // Step 2: Calculate spread (residuals)
+                calculateSpread(stock1.close, stock2.close, result.hedge_ratio, spreads[p - begin]);
+                tested.push_back(&spreads[p - begin]);
+                tested_pairs.push_back(p);
+            }
+            
+            // Step 3: Augmented Dickey-Fuller test on every spread of the batch
+            const auto adf = BatchADFEngine::run(tested, BatchADFEngine::Options{});
+            
+            for (size_t k = 0; k < tested_pairs.size(); ++k) {
+                const size_t p = tested_pairs[k];
+                finishAnalysis(adf[k], spreads[p - begin], regressions[p - begin], significance_level, results[p]);
+            }
+        }
         
-        return result;
+        return results;
     }
     
     // Calculate correlation between two price series
@@ -74,165 +85,70 @@ public:
         return SIMDStatistics::calculateCorrelation_SIMD(series1, series2);
     }
 
-private:
-    // Augmented Dickey-Fuller test result
-    struct ADFResult {
-        double test_statistic;
-        double p_value;
-        int lags_used;
-    };
-    
-    // Estimate hedge ratio using OLS regression: price2 = alpha + beta * price1 + error
-    static std::pair<double, double> estimateHedgeRatio(
-        const std::vector<double, aligned_allocator<double, 32>>& price1,
-        const std::vector<double, aligned_allocator<double, 32>>& price2) {
-        
-        // Convert to standard vectors for regression
-        std::vector<double> x(price1.begin(), price1.end());
-        std::vector<double> y(price2.begin(), price2.end());
-        
-        return SIMDStatistics::linearRegression_SIMD(y, x);
+    // Verdict and grade from empirical critical values and p-value instead
+    // of the table ones
+    static void applyEmpiricalPValue(CointegrationResult& result, double p_value, double critical_1pct,
+                                     double critical_5pct, double critical_10pct, double significance_level) {
+        result.p_value = p_value;
+        result.critical_value_1pct = critical_1pct;
+        result.critical_value_5pct = critical_5pct;
+        result.critical_value_10pct = critical_10pct;
+        result.is_cointegrated = result.adf_statistic < critical_5pct && p_value < significance_level;
+        result.cointegration_grade = assignGrade(result);
     }
+
+private:
+    // Pairs whose spreads are held at once for one batched ADF pass
+    static constexpr size_t kBatchPairs = 64;
     
     // Calculate spread: spread = price2 - hedge_ratio * price1
-    static std::vector<double> calculateSpread(
+    static void calculateSpread(
         const std::vector<double, aligned_allocator<double, 32>>& price1,
         const std::vector<double, aligned_allocator<double, 32>>& price2,
-        double hedge_ratio) {
-        
-        std::vector<double> spread;
-        spread.reserve(price1.size());
+        double hedge_ratio,
+        std::vector<double>& spread) {
         
+        spread.resize(price1.size());
         for (size_t i = 0; i < price1.size(); ++i) {
-            spread.push_back(price2[i] - hedge_ratio * price1[i]);
+            spread[i] = price2[i] - hedge_ratio * price1[i];
         }
-        
-        return spread;
     }
     
-    // Augmented Dickey-Fuller test for unit root
-    static ADFResult augmentedDickeyFullerTest(const std::vector<double>& series, int max_lags = 10) {
-        ADFResult result;
-        
-        if (series.size() < 20) {
-            result.test_statistic = 0.0;
-            result.p_value = 1.0;
-            result.lags_used = 0;
-            return result;
-        }
-        
-        // Determine optimal number of lags using AIC
-        int optimal_lags = selectOptimalLags(series, max_lags);
-        result.lags_used = optimal_lags;
-        
-        // Perform ADF test with optimal lags
-        result.test_statistic = performADFTest(series, optimal_lags);
-        
-        // Calculate p-value using MacKinnon critical values approximation
-        result.p_value = calculateADFPValue(result.test_statistic, series.size());
+    // Everything after the ADF test, for one pair
+    static void finishAnalysis(
+        const BatchADFEngine::Result& adf,
+        const std::vector<double>& spread,
+        const SIMDCointegrationAnalyzer::HedgeRegression& regression,
+        double significance_level,
+        CointegrationResult& result) {
         
-        return result;
-    }
-    
-    // Select optimal lags using Akaike Information Criterion
-    static int selectOptimalLags(const std::vector<double>& series, int max_lags) {
-        double best_aic = std::numeric_limits<double>::max();
-        int best_lags = 1;
-        
-        for (int lags = 1; lags <= std::min(max_lags, static_cast<int>(series.size() / 4)); ++lags) {
-            double aic = calculateAIC(series, lags);
-            if (aic < best_aic) {
-                best_aic = aic;
-                best_lags = lags;
-            }
-        }
+        result.adf_statistic = adf.valid ? adf.statistic : 0.0;
+        result.p_value = adf.valid ? calculateADFPValue(result.adf_statistic) : 1.0;
         
-        return best_lags;
-    }
-    
-    // Calculate AIC for ADF regression with given lags
-    static double calculateAIC(const std::vector<double>& series, int lags) {
-        // Simplified AIC calculation for ADF regression
-        // In practice, this would involve running the full ADF regression
-        
-        size_t n = series.size() - lags - 1;
-        if (n < 10) return std::numeric_limits<double>::max();
-        
-        // Estimate residual sum of squares for ADF regression
-        double rss = estimateADFResidualSumSquares(series, lags);
-        
-        // AIC = 2k + n*ln(RSS/n) where k is number of parameters
-        int k = lags + 2; // intercept + trend + lagged differences
-        return 2.0 * k + n * std::log(rss / n);
-    }
-    
-    // Estimate RSS for ADF regression (simplified)
-    static double estimateADFResidualSumSquares(const std::vector<double>& series, int lags) {
-        // This is a simplified estimation
-        // In practice, you'd run the full ADF regression
-        
-        std::vector<double> diff_series;
-        for (size_t i = 1; i < series.size(); ++i) {
-            diff_series.push_back(series[i] - series[i-1]);
-        }
-        
-        double mean_diff = std::accumulate(diff_series.begin(), diff_series.end(), 0.0) / diff_series.size();
-        
-        double rss = 0.0;
-        for (double diff : diff_series) {
-            double residual = diff - mean_diff;
-            rss += residual * residual;
-        }
-        
-        return rss;
-    }
-    
-    // Perform ADF test with specified lags
-    static double performADFTest(const std::vector<double>& series, int lags) {
-        // Simplified ADF test implementation
-        // Full implementation would use matrix operations for regression
-        
-        if (series.size() < lags + 10) {
-            return 0.0;
-        }
-        
-        // Create lagged differences
-        std::vector<double> y, x, lagged_diffs;
-        
-        for (size_t i = lags + 1; i < series.size(); ++i) {
-            // Dependent variable: first difference
-            y.push_back(series[i] - series[i-1]);
-            
-            // Independent variable: lagged level
-            x.push_back(series[i-1]);
-        }
+        // Set critical values
+        result.critical_value_1pct = -3.43;
+        result.critical_value_5pct = -2.86;
+        result.critical_value_10pct = -2.57;
         
-        if (y.empty() || x.empty()) {
-            return 0.0;
-        }
+        // Determine if cointegrated
+        result.is_cointegrated = (result.adf_statistic < result.critical_value_5pct) && 
+                                (result.p_value < significance_level);
         
-        // Simple regression to get coefficient and standard error
-        auto regression = SIMDStatistics::linearRegression_SIMD(y, x);
-        double beta = regression.second;
+        // Calculate spread statistics
+        calculateSpreadStatistics(spread, regression, result);
         
-        // Estimate standard error (simplified)
-        double residual_sum = 0.0;
-        for (size_t i = 0; i < y.size(); ++i) {
-            double predicted = regression.first + beta * x[i];
-            double residual = y[i] - predicted;
-            residual_sum += residual * residual;
-        }
+        // Calculate half-life of mean reversion
+        result.half_life = calculateHalfLife(spread);
         
-        double mse = residual_sum / (y.size() - 2);
-        double x_var = SIMDStatistics::variance_SIMD(x);
-        double se_beta = std::sqrt(mse / (x_var * x.size()));
+        // Generate trading signals and metrics
+        generateTradingMetrics(spread, result);
         
-        // t-statistic for unit root test (H0: beta = 0)
-        return beta / se_beta;
+        // Assign grade based on statistical significance
+        result.cointegration_grade = assignGrade(result);
     }
     
     // Calculate p-value using MacKinnon approximation
-    static double calculateADFPValue(double test_statistic, size_t sample_size) {
+    static double calculateADFPValue(double test_statistic) {
         // Simplified p-value calculation using critical value approximation
         // This is a rough approximation - in practice you'd use MacKinnon tables
         
@@ -248,8 +164,10 @@ private:
         return std::min(0.99, 0.30 + (test_statistic + 2.0) / 2.0 * 0.69);
     }
     
-    // Calculate spread statistics
-    static void calculateSpreadStatistics(const std::vector<double>& spread, CointegrationResult& result) {
+    // Calculate spread statistics; mean, std and current value come with the regression
+    static void calculateSpreadStatistics(const std::vector<double>& spread,
+                                          const SIMDCointegrationAnalyzer::HedgeRegression& regression,
+                                          CointegrationResult& result) {
         if (spread.empty()) {
             result.spread_mean = 0.0;
             result.spread_std = 0.0;
@@ -258,18 +176,11 @@ private:
             return;
         }
         
-        // Calculate mean and standard deviation
-        result.spread_mean = std::accumulate(spread.begin(), spread.end(), 0.0) / spread.size();
-        
-        double variance = 0.0;
-        for (double s : spread) {
-            double diff = s - result.spread_mean;
-            variance += diff * diff;
-        }
-        result.spread_std = std::sqrt(variance / spread.size());
+        result.spread_mean = regression.spread_mean;
+        result.spread_std = regression.spread_std;
         
         // Current spread and z-score
-        result.current_spread = spread.back();
+        result.current_spread = regression.current_spread;
         result.z_score = (result.current_spread - result.spread_mean) / result.spread_std;
         
         // Min and max spread
@@ -451,18 +362,95 @@ CointegrationResult SIMDCointegrationAnalyzer::analyzeCointegration_SIMD(
     return EnhancedCointegrationAnalyzer::analyzeCointegration(stock1, stock2);
 }
 
+void SIMDCointegrationAnalyzer::applyEmpiricalPValue(
+    CointegrationResult& result, double p_value, double critical_1pct,
+    double critical_5pct, double critical_10pct, double significance_level) {
+    
+    EnhancedCointegrationAnalyzer::applyEmpiricalPValue(result, p_value, critical_1pct, critical_5pct,
+                                                        critical_10pct, significance_level);
+}
+
+SIMDCointegrationAnalyzer::HedgeRegression SIMDCointegrationAnalyzer::regressPair_SIMD(
+    const StockData& stock1,
+    const StockData& stock2) {
+    
+    HedgeRegression regression;
+    const size_t n = std::min(stock1.close.size(), stock2.close.size());
+    if (n == 0) {
+        return regression;
+    }
+    
+    // Centered closes and sums of squares, from the stock when it has them
+    struct Leg {
+        const double* centered;
+        double mean;
+        double sum_sq;
+        std::vector<double> scratch;
+    };
+    auto leg = [n](const StockData& stock) {
+        Leg l{nullptr, stock.mean_price, stock.close_centered_sum_sq, {}};
+        if (stock.centered_close.size() == n && stock.close.size() == n) {
+            l.centered = stock.centered_close.data();
+            return l;
+        }
+        l.mean = std::accumulate(stock.close.begin(), stock.close.begin() + n, 0.0) / n;
+        l.scratch.resize(n);
+        l.sum_sq = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            l.scratch[i] = stock.close[i] - l.mean;
+            l.sum_sq += l.scratch[i] * l.scratch[i];
+        }
+        l.centered = l.scratch.data();
+        return l;
+    };
+    const Leg x = leg(stock1);
+    const Leg y = leg(stock2);
+    
+    // The cross term is the only per-pair pass: {sum xy, sum xx, sum yy}
+    double products[3];
+    simd_kernels().centered_products(x.centered, y.centered, n, 0.0, 0.0, products);
+    const double cross = products[0];
+    
+    regression.hedge_ratio = x.sum_sq > 0.0 ? cross / x.sum_sq : 0.0;
+    regression.intercept = y.mean - regression.hedge_ratio * x.mean;
+    // spread = close2 - hedge_ratio * close1, so its mean is the intercept and
+    // its centered sum of squares is Syy - 2 b Sxy + b^2 Sxx
+    const double b = regression.hedge_ratio;
+    const double spread_sum_sq = y.sum_sq - 2.0 * b * cross + b * b * x.sum_sq;
+    regression.spread_mean = regression.intercept;
+    regression.spread_std = std::sqrt(std::max(0.0, spread_sum_sq) / n);
+    regression.current_spread = stock2.close[n - 1] - b * stock1.close[n - 1];
+    return regression;
+}
+
+double SIMDCointegrationAnalyzer::calculateHedgeRatio_SIMD(
+    const std::vector<double>& prices1,
+    const std::vector<double>& prices2) {
+    
+    return SIMDStatistics::linearRegression_SIMD(prices2, prices1).second;
+}
+
+std::tuple<double, double, double> SIMDCointegrationAnalyzer::calculateSpreadStats_SIMD(
+    const std::vector<double>& spread) {
+    
+    if (spread.empty()) {
+        return {0.0, 0.0, 0.0};
+    }
+    const SimdKernels& kernels = simd_kernels();
+    const double mean = kernels.sum(spread.data(), spread.size()) / spread.size();
+    const double variance = kernels.squared_deviation_sum(spread.data(), spread.size(), mean) / spread.size();
+    return {mean, std::sqrt(variance), spread.back()};
+}
+
 // Batch analysis using enhanced analyzer
 std::vector<CointegrationResult> SIMDCointegrationAnalyzer::batchAnalyzeCointegration_SIMD(
     const std::vector<std::pair<const StockData*, const StockData*>>& stock_pairs) {
     
-    std::vector<CointegrationResult> results;
-    results.reserve(stock_pairs.size());
-    
+    std::vector<std::pair<const StockData*, const StockData*>> valid_pairs;
+    valid_pairs.reserve(stock_pairs.size());
     for (const auto& pair : stock_pairs) {
-        if (pair.first && pair.second) {
-            results.push_back(EnhancedCointegrationAnalyzer::analyzeCointegration(*pair.first, *pair.second));
-        }
+        if (pair.first && pair.second) valid_pairs.push_back(pair);
     }
     
-    return results;
+    return EnhancedCointegrationAnalyzer::analyzeBatch(valid_pairs);
 }
@@ -1,6 +1,385 @@
-// Placeholder file for correlation analyzer implementation
-// This will be expanded in future development
 #include "simd_statistics.h"
+#include "gpu_correlation.h"
+#include "hardware_counters.h"
+#include "numa_topology.h"
+#include "pair_universe.h"
+#include "simd_dispatch.h"
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <map>
 
-// Implementation is currently in simd_statistics.cpp
-// This file exists to satisfy the CMakeLists.txt build requirements
+// All-pairs correlation as a blocked Gram product of standardized series.
+// Per-pair correlation analysis lives in simd_statistics.cpp.
+
+namespace {
+
+constexpr size_t kPanel = SimdKernels::gram_panel;
+// Tile side in panels (64 series) and rows per depth step: one step's panels
+// for both sides of a tile (2 x 64 x 256 doubles) fit in L2 while the 64 x 64
+// accumulator block stays in L1
+constexpr size_t kTilePanels = 8;
+constexpr size_t kDepthBlock = 256;
+
+// Stocks whose series share one length, standardized so that z_i . z_j is
+// their Pearson correlation and packed into panels of kPanel series:
+// series k sits at panels[(k / kPanel) * depth * kPanel + t * kPanel + k % kPanel]
+struct PackedGroup {
+    std::vector<size_t> members;            // indices into the stock list
+    std::vector<unsigned char> has_variance;
+    size_t depth = 0;
+    size_t panel_count = 0;
+    std::vector<double> panels;
+    // One copy of panels per NUMA node, first touched there; empty unless
+    // replication is active
+    std::vector<std::vector<double>> replicas;
+    // With a universe, the members are ordered by cluster and clusters[k]
+    // is member k's, so each cluster's pairs fall in a few tiles
+    const PairUniverse* universe = nullptr;
+    std::vector<uint32_t> clusters;
+
+    const double* panel(size_t p, unsigned node) const {
+        const auto& source = node < replicas.size() ? replicas[node] : panels;
+        return source.data() + p * depth * kPanel;
+    }
+
+    // Members a and b are a pair of the universe
+    bool pairs(size_t a, size_t b) const {
+        return !universe || universe->pairsClusters(clusters[a], clusters[b]);
+    }
+
+    // Some pair of the universe has one member in panel pi and one in panel
+    // pj; runs of one cluster are checked once
+    bool spansPanels(size_t pi, size_t pj) const {
+        if (!universe) return true;
+        const size_t row_end = std::min(members.size(), (pi + 1) * kPanel);
+        const size_t col_end = std::min(members.size(), (pj + 1) * kPanel);
+        for (size_t a = pi * kPanel; a < row_end; ++a) {
+            if (a > pi * kPanel && clusters[a] == clusters[a - 1]) continue;
+            for (size_t b = pj * kPanel; b < col_end; ++b) {
+                if (b > pj * kPanel && clusters[b] == clusters[b - 1]) continue;
+                if (universe->pairsClusters(clusters[a], clusters[b])) return true;
+            }
+        }
+        return false;
+    }
+};
+
+PackedGroup packGroup(const std::vector<const StockData*>& stocks, SIMDCorrelationAnalyzer::Series series,
+                      std::vector<size_t> members) {
+    const SimdKernels& kernels = simd_kernels();
+    PackedGroup group;
+    group.members = std::move(members);
+    group.depth = (stocks[group.members.front()]->*series).size();
+    group.panel_count = (group.members.size() + kPanel - 1) / kPanel;
+    group.has_variance.assign(group.members.size(), 0);
+    // Padding columns stay zero and never pass the threshold check
+    group.panels.assign(group.panel_count * group.depth * kPanel, 0.0);
+
+    for (size_t k = 0; k < group.members.size(); ++k) {
+        const auto& values = stocks[group.members[k]]->*series;
+        const double mean = kernels.sum(values.data(), group.depth) / group.depth;
+        const double deviation = kernels.squared_deviation_sum(values.data(), group.depth, mean);
+        if (!(deviation > 0.0)) continue;
+        group.has_variance[k] = 1;
+        const double scale = 1.0 / std::sqrt(deviation);
+        double* column = group.panels.data() + (k / kPanel) * group.depth * kPanel + k % kPanel;
+        for (size_t t = 0; t < group.depth; ++t) {
+            column[t * kPanel] = (values[t] - mean) * scale;
+        }
+    }
+    if (numa_replication_active()) {
+        group.replicas.resize(NumaTopology::system().nodes());
+        for (unsigned node = 0; node < group.replicas.size(); ++node) {
+            run_on_numa_node(node, [&]() { group.replicas[node] = group.panels; });
+        }
+    }
+    return group;
+}
+
+// Content key of a packed group for GpuCorrelation residency: equal keys
+// mean the same standardized matrix, so a later screen of the same series
+// reuses the device copy
+uint64_t groupKey(const PackedGroup& group) {
+    uint64_t hash = 0xcbf29ce484222325ULL ^ group.depth ^ (group.members.size() << 32);
+    auto mix = [&hash](uint64_t word) {
+        hash = (hash ^ word) * 0x100000001b3ULL;
+        hash ^= hash >> 29;
+    };
+    for (double value : group.panels) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        mix(bits);
+    }
+    for (unsigned char flag : group.has_variance) mix(flag);
+    return hash;
+}
+
+// Tiles along one side of a group's upper triangle
+size_t tilesPerSide(const PackedGroup& group) {
+    return (group.panel_count + kTilePanels - 1) / kTilePanels;
+}
+
+// Walk position of the tile holding members a <= b of a group whose tiles
+// start at `first`
+size_t tileOrdinal(const PackedGroup& group, size_t first, size_t a, size_t b) {
+    const size_t side = tilesPerSide(group);
+    const size_t row = a / (kTilePanels * kPanel), col = b / (kTilePanels * kPanel);
+    return first + row * side - row * (row - 1) / 2 + (col - row);
+}
+
+bool ownsTile(const SIMDCorrelationAnalyzer::TileShard& shard, size_t ordinal) {
+    return shard.count <= 1 || ordinal % shard.count == shard.index;
+}
+
+// First walk position of each group's tiles
+std::vector<size_t> firstTiles(const std::vector<PackedGroup>& groups) {
+    std::vector<size_t> first(groups.size());
+    size_t ordinal = 0;
+    for (size_t g = 0; g < groups.size(); ++g) {
+        first[g] = ordinal;
+        const size_t side = tilesPerSide(groups[g]);
+        ordinal += side * (side + 1) / 2;
+    }
+    return first;
+}
+
+// Runs the Gram product over the upper triangle of every group not marked
+// in `skip`, in tiles of kTilePanels x kTilePanels panels on a pool of
+// `workers` threads, and calls visit(worker, i, j, correlation) for each
+// pair of stocks with variance, i < j being stock indices. Only the tiles
+// `shard` owns are run, and of a group packed by cluster only the panel
+// pairs that hold a pair of its universe.
+template <typename Visit>
+void runGramTiles(const std::vector<PackedGroup>& groups, const std::vector<unsigned char>& skip,
+                  const SIMDCorrelationAnalyzer::TileShard& shard, unsigned workers, Visit&& visit) {
+    struct Tile {
+        size_t group;
+        size_t row_panel;
+        size_t col_panel;
+    };
+    std::vector<Tile> tiles;
+    std::vector<size_t> costs;
+    size_t ordinal = 0;
+    for (size_t g = 0; g < groups.size(); ++g) {
+        const size_t panels = groups[g].panel_count;
+        for (size_t bi = 0; bi < panels; bi += kTilePanels) {
+            for (size_t bj = bi; bj < panels; bj += kTilePanels) {
+                if (skip[g] || !ownsTile(shard, ordinal++)) continue;
+                const size_t row_end = std::min(panels, bi + kTilePanels);
+                const size_t col_end = std::min(panels, bj + kTilePanels);
+                size_t panel_pairs = 0;
+                for (size_t pi = bi; pi < row_end; ++pi) {
+                    for (size_t pj = bi == bj ? pi : bj; pj < col_end; ++pj) {
+                        panel_pairs += groups[g].spansPanels(pi, pj);
+                    }
+                }
+                if (panel_pairs == 0) continue;
+                tiles.push_back({g, bi, bj});
+                costs.push_back(panel_pairs * groups[g].depth);
+            }
+        }
+    }
+    if (tiles.empty()) {
+        return;
+    }
+    
+    const SimdKernels& kernels = simd_kernels();
+    ScopedCounters counters("kernel: gram correlation tiles");
+    WorkStealingPool pool(workers);
+    pool.set_trace_label("correlation tile");
+    std::vector<std::vector<double>> worker_blocks(pool.size());
+    
+    pool.run(costs, [&](size_t t, unsigned worker) {
+        const Tile& tile = tiles[t];
+        const PackedGroup& group = groups[tile.group];
+        const unsigned node = pool.node_of(worker);
+        const size_t row_end = std::min(group.panel_count, tile.row_panel + kTilePanels);
+        const size_t col_end = std::min(group.panel_count, tile.col_panel + kTilePanels);
+        const bool diagonal = tile.row_panel == tile.col_panel;
+        
+        auto& block = worker_blocks[worker];
+        block.assign(kTilePanels * kTilePanels * kPanel * kPanel, 0.0);
+        auto block_at = [&](size_t pi, size_t pj) {
+            return block.data() + ((pi - tile.row_panel) * kTilePanels + (pj - tile.col_panel)) * kPanel * kPanel;
+        };
+        
+        // Walk the depth in steps so each step's panels are reused from cache
+        for (size_t d = 0; d < group.depth; d += kDepthBlock) {
+            const size_t rows = std::min(kDepthBlock, group.depth - d);
+            for (size_t pi = tile.row_panel; pi < row_end; ++pi) {
+                for (size_t pj = diagonal ? pi : tile.col_panel; pj < col_end; ++pj) {
+                    if (!group.spansPanels(pi, pj)) continue;
+                    kernels.gram_panel_product(group.panel(pi, node) + d * kPanel, group.panel(pj, node) + d * kPanel,
+                                               rows, block_at(pi, pj));
+                }
+            }
+        }
+        
+        for (size_t pi = tile.row_panel; pi < row_end; ++pi) {
+            for (size_t pj = diagonal ? pi : tile.col_panel; pj < col_end; ++pj) {
+                if (!group.spansPanels(pi, pj)) continue;
+                const double* values = block_at(pi, pj);
+                for (size_t r = 0; r < kPanel; ++r) {
+                    const size_t a = pi * kPanel + r;
+                    if (a >= group.members.size() || !group.has_variance[a]) continue;
+                    for (size_t c = pi == pj ? r + 1 : 0; c < kPanel; ++c) {
+                        const size_t b = pj * kPanel + c;
+                        if (b >= group.members.size() || !group.has_variance[b] || !group.pairs(a, b)) continue;
+                        // A unit dot product can round a hair past 1
+                        const double correlation = std::min(1.0, std::max(-1.0, values[r * kPanel + c]));
+                        const size_t i = group.members[a], j = group.members[b];
+                        visit(worker, std::min(i, j), std::max(i, j), correlation);
+                    }
+                }
+            }
+        }
+    });
+}
+
+// Equal-length groups of the stocks with at least two values of `series`;
+// with a universe, only its clustered stocks, ordered by cluster
+std::vector<PackedGroup> packGroups(const std::vector<const StockData*>& stocks,
+                                    SIMDCorrelationAnalyzer::Series series,
+                                    const PairUniverse* universe = nullptr) {
+    std::map<size_t, std::vector<size_t>> by_length;
+    for (size_t i = 0; i < stocks.size(); ++i) {
+        if (stocks[i] && (stocks[i]->*series).size() >= 2 &&
+            (!universe || universe->clusterOf(i) != PairUniverse::kNoCluster)) {
+            by_length[(stocks[i]->*series).size()].push_back(i);
+        }
+    }
+    std::vector<PackedGroup> groups;
+    for (auto& [length, members] : by_length) {
+        if (members.size() < 2) continue;
+        if (universe) {
+            std::stable_sort(members.begin(), members.end(), [universe](size_t a, size_t b) {
+                return universe->clusterOf(a) < universe->clusterOf(b);
+            });
+        }
+        PackedGroup group = packGroup(stocks, series, std::move(members));
+        if (universe) {
+            group.universe = universe;
+            for (size_t member : group.members) group.clusters.push_back(universe->clusterOf(member));
+        }
+        groups.push_back(std::move(group));
+    }
+    return groups;
+}
+
+// Screens a group on the device, keeping the pairs of the tiles `shard`
+// owns (the group's walk starts at first_tile); false leaves it to the CPU
+// tiles
+bool screenOnDevice(const PackedGroup& group, double min_correlation,
+                    const SIMDCorrelationAnalyzer::PairFilter& include_pair,
+                    const SIMDCorrelationAnalyzer::TileShard& shard, size_t first_tile,
+                    std::vector<SIMDCorrelationAnalyzer::PairCorrelation>& results) {
+    const uint64_t key = groupKey(group);
+    if (!GpuCorrelation::resident(key) &&
+        !GpuCorrelation::upload(key, group.panels.data(), group.depth, group.members.size(), kPanel,
+                                group.has_variance.data())) return false;
+    std::vector<GpuCorrelation::Pair> pairs;
+    if (!GpuCorrelation::correlatedPairs(key, min_correlation, pairs)) return false;
+    for (const auto& pair : pairs) {
+        if (!ownsTile(shard, tileOrdinal(group, first_tile, pair.a, pair.b)) || !group.pairs(pair.a, pair.b)) continue;
+        const size_t i = std::min(group.members[pair.a], group.members[pair.b]);
+        const size_t j = std::max(group.members[pair.a], group.members[pair.b]);
+        if (include_pair && !include_pair(i, j)) continue;
+        results.push_back({i, j, pair.correlation});
+    }
+    return true;
+}
+
+}
+
+std::vector<SIMDCorrelationAnalyzer::PairCorrelation> SIMDCorrelationAnalyzer::correlatedPairs_SIMD(
+    const std::vector<const StockData*>& stocks,
+    Series series,
+    double min_correlation,
+    unsigned int num_threads,
+    const PairFilter& include_pair,
+    const TileShard& shard,
+    const PairUniverse* universe) {
+    
+    std::vector<PairCorrelation> results;
+    
+    // Only equal-length series share a matrix
+    std::vector<PackedGroup> groups = packGroups(stocks, series, universe);
+    if (groups.empty()) {
+        return results;
+    }
+    
+    // Groups the device screens skip the CPU tiles
+    std::vector<unsigned char> on_device(groups.size(), 0);
+    if (GpuCorrelation::enabled() && GpuCorrelation::available()) {
+        const std::vector<size_t> first = firstTiles(groups);
+        for (size_t g = 0; g < groups.size(); ++g) {
+            on_device[g] = screenOnDevice(groups[g], min_correlation, include_pair, shard, first[g], results);
+        }
+    }
+    
+    const unsigned workers = std::max(1u, num_threads);
+    std::vector<std::vector<PairCorrelation>> worker_results(workers);
+    runGramTiles(groups, on_device, shard, workers, [&](unsigned worker, size_t i, size_t j, double correlation) {
+        if (correlation < min_correlation) return;
+        if (include_pair && !include_pair(i, j)) return;
+        worker_results[worker].push_back({i, j, correlation});
+    });
+    
+    size_t found = results.size();
+    for (const auto& local : worker_results) found += local.size();
+    results.reserve(found);
+    for (auto& local : worker_results) {
+        std::move(local.begin(), local.end(), std::back_inserter(results));
+    }
+    
+    return results;
+}
+
+void SIMDCorrelationAnalyzer::allCorrelations_SIMD(
+    const std::vector<const StockData*>& stocks,
+    Series series,
+    unsigned int num_threads,
+    const CorrelationSink& sink) {
+    
+    std::vector<PackedGroup> groups = packGroups(stocks, series);
+    const std::vector<unsigned char> on_cpu(groups.size(), 0);
+    runGramTiles(groups, on_cpu, TileShard{0, 1}, std::max(1u, num_threads), [&](unsigned, size_t i, size_t j, double correlation) {
+        sink(i, j, correlation);
+    });
+}
+
+std::vector<CorrelationResult> SIMDCorrelationAnalyzer::analyzeAllPairs_SIMD(
+    const std::vector<const StockData*>& stocks,
+    double min_correlation,
+    unsigned int num_threads,
+    const PairFilter& include_pair) {
+    
+    auto pairs = correlatedPairs_SIMD(stocks, &StockData::returns, min_correlation, num_threads, include_pair);
+    std::vector<CorrelationResult> results;
+    results.reserve(pairs.size());
+    for (const auto& pair : pairs) {
+        results.push_back(correlationResult(*stocks[pair.i], *stocks[pair.j], pair.correlation));
+    }
+    return results;
+}
+
+CorrelationResult SIMDCorrelationAnalyzer::correlationResult(
+    const StockData& stock1,
+    const StockData& stock2,
+    double correlation) {
+    
+    CorrelationResult result{};
+    result.stock1 = stock1.symbol;
+    result.stock2 = stock2.symbol;
+    result.pearson_correlation = correlation;
+    result.correlation_grade = correlation > 0.7 ? "A" : "C";
+    result.sector1 = stock1.sector;
+    result.sector2 = stock2.sector;
+    result.same_sector = stock1.sector == stock2.sector;
+    result.price1 = stock1.close.empty() ? 0.0 : stock1.close.back();
+    result.price2 = stock2.close.empty() ? 0.0 : stock2.close.back();
+    result.affordable_pair = result.price1 < 500.0 && result.price2 < 500.0;
+    return result;
+}
@@ -0,0 +1,117 @@
+#include "cuda_device.h"
+#include <cuda_runtime.h>
+
+namespace {
+
+// 64 x 64 output tile per block of 16 x 16 threads, each thread holding a
+// 4 x 4 block of accumulators; the depth is walked kStep rows at a time
+// through shared memory
+constexpr unsigned kTile = 64;
+constexpr unsigned kThreads = 16;
+constexpr unsigned kPerThread = kTile / kThreads;
+constexpr unsigned kStep = 16;
+
+__device__ double packedValue(const double* panels, size_t depth, size_t count, size_t width, size_t t, size_t k) {
+    return k < count ? panels[(k / width) * depth * width + t * width + k % width] : 0.0;
+}
+
+__global__ void thresholdGramKernel(const double* panels, const unsigned char* has_variance,
+                                    size_t depth, size_t count, size_t width, double min_correlation,
+                                    GpuCorrelation::Pair* pairs, unsigned long long capacity,
+                                    unsigned long long* found) {
+    // Upper triangle of tiles only
+    if (blockIdx.y > blockIdx.x) return;
+    const size_t row0 = static_cast<size_t>(blockIdx.y) * kTile;
+    const size_t col0 = static_cast<size_t>(blockIdx.x) * kTile;
+    const unsigned tx = threadIdx.x, ty = threadIdx.y;
+
+    __shared__ double rows[kStep][kTile];
+    __shared__ double cols[kStep][kTile];
+    double sums[kPerThread][kPerThread] = {};
+
+    for (size_t d = 0; d < depth; d += kStep) {
+        for (unsigned l = ty * kThreads + tx; l < kStep * kTile; l += kThreads * kThreads) {
+            const unsigned s = l / kTile, k = l % kTile;
+            const size_t t = d + s;
+            rows[s][k] = t < depth ? packedValue(panels, depth, count, width, t, row0 + k) : 0.0;
+            cols[s][k] = t < depth ? packedValue(panels, depth, count, width, t, col0 + k) : 0.0;
+        }
+        __syncthreads();
+        for (unsigned s = 0; s < kStep; ++s) {
+            double a[kPerThread], b[kPerThread];
+            for (unsigned r = 0; r < kPerThread; ++r) a[r] = rows[s][ty + r * kThreads];
+            for (unsigned c = 0; c < kPerThread; ++c) b[c] = cols[s][tx + c * kThreads];
+            for (unsigned r = 0; r < kPerThread; ++r) {
+                for (unsigned c = 0; c < kPerThread; ++c) sums[r][c] += a[r] * b[c];
+            }
+        }
+        __syncthreads();
+    }
+
+    for (unsigned r = 0; r < kPerThread; ++r) {
+        const size_t i = row0 + ty + r * kThreads;
+        if (i >= count || !has_variance[i]) continue;
+        for (unsigned c = 0; c < kPerThread; ++c) {
+            const size_t j = col0 + tx + c * kThreads;
+            if (j <= i || j >= count || !has_variance[j]) continue;
+            // A unit dot product can round a hair past 1
+            const double correlation = fmin(1.0, fmax(-1.0, sums[r][c]));
+            if (correlation < min_correlation) continue;
+            const unsigned long long slot = atomicAdd(found, 1ULL);
+            if (slot < capacity) {
+                pairs[slot] = {static_cast<uint32_t>(i), static_cast<uint32_t>(j), correlation};
+            }
+        }
+    }
+}
+
+}
+
+bool CudaDevice::firstDevice(std::string& name) {
+    int devices = 0;
+    if (cudaGetDeviceCount(&devices) != cudaSuccess || devices == 0) return false;
+    cudaDeviceProp properties;
+    if (cudaGetDeviceProperties(&properties, 0) != cudaSuccess) return false;
+    name = properties.name;
+    return true;
+}
+
+void* CudaDevice::allocate(size_t bytes) {
+    void* device = nullptr;
+    if (cudaMalloc(&device, bytes) != cudaSuccess) {
+        cudaGetLastError();     // clear the sticky allocation error
+        return nullptr;
+    }
+    return device;
+}
+
+void CudaDevice::free(void* device) {
+    if (device) cudaFree(device);
+}
+
+bool CudaDevice::upload(void* device, const void* host, size_t bytes) {
+    return cudaMemcpy(device, host, bytes, cudaMemcpyHostToDevice) == cudaSuccess;
+}
+
+bool CudaDevice::correlatedPairs(const double* panels, const unsigned char* has_variance,
+                                 size_t depth, size_t count, size_t width, double min_correlation,
+                                 GpuCorrelation::Pair* pairs, size_t capacity,
+                                 GpuCorrelation::Pair* host_pairs, size_t& found) {
+    unsigned long long* counter = static_cast<unsigned long long*>(allocate(sizeof(unsigned long long)));
+    if (!counter) return false;
+    const unsigned tiles = static_cast<unsigned>((count + kTile - 1) / kTile);
+    bool ok = cudaMemset(counter, 0, sizeof(unsigned long long)) == cudaSuccess;
+    if (ok) {
+        thresholdGramKernel<<<dim3(tiles, tiles), dim3(kThreads, kThreads)>>>(
+            panels, has_variance, depth, count, width, min_correlation, pairs, capacity, counter);
+        ok = cudaGetLastError() == cudaSuccess && cudaDeviceSynchronize() == cudaSuccess;
+    }
+    unsigned long long passed = 0;
+    ok = ok && cudaMemcpy(&passed, counter, sizeof(passed), cudaMemcpyDeviceToHost) == cudaSuccess;
+    if (ok && passed <= capacity && passed > 0) {
+        ok = cudaMemcpy(host_pairs, pairs, passed * sizeof(GpuCorrelation::Pair), cudaMemcpyDeviceToHost) == cudaSuccess;
+    }
+    free(counter);
+    found = static_cast<size_t>(passed);
+    return ok;
+}
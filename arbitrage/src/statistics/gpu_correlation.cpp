@@ -0,0 +1,180 @@
+#include "gpu_correlation.h"
+#ifdef MFT_HAVE_CUDA
+#include "cuda_device.h"
+#endif
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+namespace {
+
+std::atomic<bool> offload_enabled{true};
+
+#ifdef MFT_HAVE_CUDA
+
+struct ResidentMatrix {
+    uint64_t key;
+    void* panels;
+    void* has_variance;
+    size_t depth;
+    size_t count;
+    size_t width;
+};
+
+// One process-wide device context; calls are serialized on its mutex
+struct DeviceState {
+    std::mutex mutex;
+    bool probed = false;
+    bool present = false;
+    std::string name;
+    std::vector<ResidentMatrix> matrices;           // oldest first
+    void* pairs = nullptr;                          // device pair buffer
+    size_t capacity = 0;
+    std::vector<GpuCorrelation::Pair> host_pairs;
+};
+
+DeviceState& state() {
+    static DeviceState device;
+    return device;
+}
+
+// Caller holds the mutex
+bool probe(DeviceState& device) {
+    if (!device.probed) {
+        device.probed = true;
+        device.present = CudaDevice::firstDevice(device.name);
+    }
+    return device.present;
+}
+
+void freeMatrix(const ResidentMatrix& matrix) {
+    CudaDevice::free(matrix.panels);
+    CudaDevice::free(matrix.has_variance);
+}
+
+// Allocates, evicting the oldest resident matrices while the device is full
+void* allocateEvicting(DeviceState& device, size_t bytes) {
+    void* memory = CudaDevice::allocate(bytes);
+    while (!memory && !device.matrices.empty()) {
+        freeMatrix(device.matrices.front());
+        device.matrices.erase(device.matrices.begin());
+        memory = CudaDevice::allocate(bytes);
+    }
+    return memory;
+}
+
+#endif
+
+}
+
+#ifdef MFT_HAVE_CUDA
+
+bool GpuCorrelation::available() {
+    DeviceState& device = state();
+    std::lock_guard<std::mutex> lock(device.mutex);
+    return probe(device);
+}
+
+std::string GpuCorrelation::deviceName() {
+    DeviceState& device = state();
+    std::lock_guard<std::mutex> lock(device.mutex);
+    return probe(device) ? device.name : std::string();
+}
+
+bool GpuCorrelation::resident(uint64_t key) {
+    DeviceState& device = state();
+    std::lock_guard<std::mutex> lock(device.mutex);
+    return std::any_of(device.matrices.begin(), device.matrices.end(),
+                       [&](const ResidentMatrix& matrix) { return matrix.key == key; });
+}
+
+bool GpuCorrelation::upload(uint64_t key, const double* panels, size_t depth, size_t count, size_t width,
+                            const unsigned char* has_variance) {
+    DeviceState& device = state();
+    std::lock_guard<std::mutex> lock(device.mutex);
+    if (!probe(device) || count == 0) return false;
+
+    const size_t panel_bytes = (count + width - 1) / width * width * depth * sizeof(double);
+    ResidentMatrix matrix{key, allocateEvicting(device, panel_bytes), nullptr, depth, count, width};
+    if (matrix.panels) matrix.has_variance = allocateEvicting(device, count);
+    if (!matrix.has_variance ||
+        !CudaDevice::upload(matrix.panels, panels, panel_bytes) ||
+        !CudaDevice::upload(matrix.has_variance, has_variance, count)) {
+        freeMatrix(matrix);
+        return false;
+    }
+    // A re-upload under the same key replaces the old copy
+    for (auto it = device.matrices.begin(); it != device.matrices.end(); ++it) {
+        if (it->key == key) {
+            freeMatrix(*it);
+            device.matrices.erase(it);
+            break;
+        }
+    }
+    device.matrices.push_back(matrix);
+    return true;
+}
+
+bool GpuCorrelation::correlatedPairs(uint64_t key, double min_correlation, std::vector<Pair>& pairs) {
+    DeviceState& device = state();
+    std::lock_guard<std::mutex> lock(device.mutex);
+    auto matrix = std::find_if(device.matrices.begin(), device.matrices.end(),
+                               [&](const ResidentMatrix& resident) { return resident.key == key; });
+    if (matrix == device.matrices.end()) return false;
+
+    // A pass that overflows the pair buffer is rerun with room for every pair
+    size_t found = 0;
+    for (;;) {
+        if (device.capacity == 0) {
+            device.capacity = std::min<size_t>(matrix->count * (matrix->count - 1) / 2 + 1, size_t(1) << 20);
+            device.pairs = CudaDevice::allocate(device.capacity * sizeof(Pair));
+            if (!device.pairs) {
+                device.capacity = 0;
+                return false;
+            }
+        }
+        device.host_pairs.resize(device.capacity);
+        if (!CudaDevice::correlatedPairs(static_cast<const double*>(matrix->panels),
+                                         static_cast<const unsigned char*>(matrix->has_variance),
+                                         matrix->depth, matrix->count, matrix->width, min_correlation,
+                                         static_cast<Pair*>(device.pairs), device.capacity,
+                                         device.host_pairs.data(), found)) return false;
+        if (found <= device.capacity) break;
+        CudaDevice::free(device.pairs);
+        device.pairs = CudaDevice::allocate(found * sizeof(Pair));
+        device.capacity = device.pairs ? found : 0;
+        if (!device.pairs) return false;
+    }
+    pairs.assign(device.host_pairs.begin(), device.host_pairs.begin() + found);
+    return true;
+}
+
+void GpuCorrelation::release() {
+    DeviceState& device = state();
+    std::lock_guard<std::mutex> lock(device.mutex);
+    for (const ResidentMatrix& matrix : device.matrices) freeMatrix(matrix);
+    device.matrices.clear();
+    CudaDevice::free(device.pairs);
+    device.pairs = nullptr;
+    device.capacity = 0;
+    device.host_pairs = {};
+}
+
+#else
+
+bool GpuCorrelation::available() { return false; }
+std::string GpuCorrelation::deviceName() { return {}; }
+bool GpuCorrelation::resident(uint64_t) { return false; }
+bool GpuCorrelation::upload(uint64_t, const double*, size_t, size_t, size_t, const unsigned char*) { return false; }
+bool GpuCorrelation::correlatedPairs(uint64_t, double, std::vector<Pair>&) { return false; }
+void GpuCorrelation::release() {}
+
+#endif
+
+void GpuCorrelation::setEnabled(bool enabled) {
+    offload_enabled = enabled;
+}
+
+bool GpuCorrelation::enabled() {
+    return offload_enabled;
+}
@@ -0,0 +1,141 @@
+#include "pairs_backtest.h"
+#include "hardware_counters.h"
+#include "simd_dispatch.h"
+#include "simd_statistics.h"
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+// As EnhancedCointegrationAnalyzer::simulateHistoricalTrades
+constexpr size_t kMinBars = 20;
+
+}
+
+std::vector<PairsBacktestEngine::Rule> PairsBacktestEngine::Grid::rules() const {
+    std::vector<Rule> grid;
+    grid.reserve(entry_z.size() * exit_z.size() * stop_z.size() * max_holding.size());
+    for (double entry : entry_z)
+        for (double exit : exit_z)
+            for (double stop : stop_z)
+                for (size_t holding : max_holding) grid.push_back({entry, exit, stop, holding});
+    return grid;
+}
+
+double PairsBacktestEngine::Metrics::sharpeRatio() const {
+    if (trades < 2) return 0.0;
+    const double mean = return_sum / trades;
+    const double variance = std::max(0.0, return_sum_sq - mean * return_sum) / (trades - 1);
+    return variance > 0.0 ? mean / std::sqrt(variance) : 0.0;
+}
+
+void PairsBacktestEngine::Metrics::merge(const Metrics& other) {
+    bars += other.bars;
+    trades += other.trades;
+    winning_trades += other.winning_trades;
+    entries += other.entries;
+    return_sum += other.return_sum;
+    return_sum_sq += other.return_sum_sq;
+}
+
+std::vector<std::vector<PairsBacktestEngine::Metrics>> PairsBacktestEngine::run(
+    const std::vector<std::pair<const StockData*, const StockData*>>& pairs,
+    const std::vector<Rule>& rules,
+    const Options& options) {
+
+    std::vector<std::vector<Metrics>> results(pairs.size(), std::vector<Metrics>(rules.size()));
+    std::vector<size_t> tested;
+    for (size_t p = 0; p < pairs.size(); ++p) {
+        const StockData* stock1 = pairs[p].first;
+        const StockData* stock2 = pairs[p].second;
+        if (stock1 && stock2 && stock1->close.size() == stock2->close.size() && stock1->close.size() >= kMinBars) {
+            tested.push_back(p);
+        }
+    }
+    if (tested.empty() || rules.empty()) {
+        return results;
+    }
+
+    // Rules packed `lanes` to a group, parameter by parameter; a short last
+    // group repeats its final rule. No holding limit is one past any spread.
+    const SimdKernels& kernels = simd_kernels();
+    const size_t lanes = kernels.lanes;
+    const size_t groups = (rules.size() + lanes - 1) / lanes;
+    size_t longest = 0;
+    for (size_t p : tested) longest = std::max(longest, pairs[p].first->close.size());
+    std::vector<double> entry(groups * lanes), exit(groups * lanes), stop(groups * lanes), holding(groups * lanes);
+    for (size_t k = 0; k < groups * lanes; ++k) {
+        const Rule& rule = rules[std::min(k, rules.size() - 1)];
+        entry[k] = rule.entry_z;
+        exit[k] = rule.exit_z;
+        stop[k] = rule.stop_z;
+        holding[k] = rule.max_holding > 0 ? static_cast<double>(rule.max_holding) : static_cast<double>(longest + 1);
+    }
+
+    struct Scratch {
+        std::vector<double> z;
+        std::vector<double> stats;
+    };
+    const unsigned threads = options.num_threads > 0 ? options.num_threads :
+                             std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> costs;
+    for (size_t p : tested) costs.push_back(pairs[p].first->close.size() * groups);
+
+    ScopedCounters counters("kernel: threshold backtest");
+    WorkStealingPool workers(threads);
+    workers.set_trace_label("backtest pair");
+    std::vector<Scratch> scratch(workers.size());
+
+    workers.run(costs, [&](size_t t, unsigned worker) {
+        const StockData& stock1 = *pairs[tested[t]].first;
+        const StockData& stock2 = *pairs[tested[t]].second;
+        const auto regression = SIMDCointegrationAnalyzer::regressPair_SIMD(stock1, stock2);
+        if (!(regression.spread_std > 0.0)) return;
+
+        // z-scores of the spread from the second bar on, as the analyzer trades it
+        Scratch& local = scratch[worker];
+        const size_t n = stock1.close.size();
+        local.z.resize(n - 1);
+        for (size_t i = 1; i < n; ++i) {
+            const double spread = stock2.close[i] - regression.hedge_ratio * stock1.close[i];
+            local.z[i - 1] = (spread - regression.spread_mean) / regression.spread_std;
+        }
+
+        local.stats.resize(SimdKernels::backtest_stats * lanes);
+        std::vector<Metrics>& metrics = results[tested[t]];
+        for (size_t g = 0; g < groups; ++g) {
+            const size_t first = g * lanes;
+            kernels.threshold_backtest_lanes(local.z.data(), local.z.size(), entry.data() + first,
+                                             exit.data() + first, stop.data() + first, holding.data() + first,
+                                             local.stats.data());
+            for (size_t l = 0; l < lanes && first + l < rules.size(); ++l) {
+                Metrics& m = metrics[first + l];
+                m.bars = local.z.size();
+                m.trades = static_cast<size_t>(local.stats[l]);
+                m.winning_trades = static_cast<size_t>(local.stats[lanes + l]);
+                m.return_sum = local.stats[2 * lanes + l];
+                m.return_sum_sq = local.stats[3 * lanes + l];
+                m.entries = static_cast<size_t>(local.stats[4 * lanes + l]);
+            }
+        }
+    });
+
+    return results;
+}
+
+std::vector<PairsBacktestEngine::Metrics> PairsBacktestEngine::run(
+    const StockData& stock1, const StockData& stock2, const std::vector<Rule>& rules) {
+    return run({{&stock1, &stock2}}, rules, Options{}).front();
+}
+
+std::vector<PairsBacktestEngine::Metrics> PairsBacktestEngine::pool(
+    const std::vector<std::vector<Metrics>>& metrics) {
+
+    std::vector<Metrics> pooled(metrics.empty() ? 0 : metrics.front().size());
+    for (const auto& pair : metrics) {
+        for (size_t r = 0; r < pooled.size() && r < pair.size(); ++r) pooled[r].merge(pair[r]);
+    }
+    return pooled;
+}
@@ -0,0 +1,80 @@
+#include "rolling_cointegration.h"
+#include "simd_dispatch.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+std::vector<RollingCointegrationEngine::Series> RollingCointegrationEngine::run(
+    const std::vector<std::pair<const StockData*, const StockData*>>& pairs,
+    const Options& options) {
+    
+    std::vector<Series> results(pairs.size());
+    
+    // Equal lengths share a pass
+    std::map<size_t, std::vector<size_t>> by_length;
+    for (size_t p = 0; p < pairs.size(); ++p) {
+        const StockData* stock1 = pairs[p].first;
+        const StockData* stock2 = pairs[p].second;
+        if (stock1 && stock2 && !stock1->close.empty() && stock1->size() == stock2->size()) {
+            by_length[stock1->size()].push_back(p);
+        }
+    }
+    
+    const bool kalman = options.estimator == Estimator::Kalman;
+    const double state_forgetting = kalman ? 1.0 : options.forgetting;
+    const double state_noise = kalman ? options.state_noise : 0.0;
+    
+    const SimdKernels& kernels = simd_kernels();
+    const size_t lanes = kernels.lanes;
+    std::vector<double> x, y, beta, alpha, error, error_var, ar_coef, ar_var;
+    
+    for (const auto& [rows, members] : by_length) {
+        for (auto* buffer : {&x, &y, &beta, &alpha, &error, &error_var, &ar_coef, &ar_var}) {
+            buffer->resize(rows * lanes);
+        }
+        
+        for (size_t g = 0; g < members.size(); g += lanes) {
+            // A short last group repeats its final pair
+            for (size_t l = 0; l < lanes; ++l) {
+                const auto& pair = pairs[members[std::min(g + l, members.size() - 1)]];
+                for (size_t t = 0; t < rows; ++t) {
+                    x[t * lanes + l] = pair.first->close[t];
+                    y[t * lanes + l] = pair.second->close[t];
+                }
+            }
+            kernels.hedge_filter_lanes(x.data(), y.data(), rows, options.warmup,
+                                       state_forgetting, state_noise, options.forgetting,
+                                       beta.data(), alpha.data(), error.data(), error_var.data(),
+                                       ar_coef.data(), ar_var.data());
+            
+            for (size_t l = 0; l < lanes && g + l < members.size(); ++l) {
+                Series& series = results[members[g + l]];
+                for (auto* column : {&series.hedge_ratio, &series.intercept, &series.spread,
+                                     &series.z_score, &series.half_life, &series.adf_statistic}) {
+                    column->resize(rows);
+                }
+                // The kernel regresses on close1 - close1[0]
+                const double origin = x[l];
+                for (size_t t = 0; t < rows; ++t) {
+                    const size_t k = t * lanes + l;
+                    series.hedge_ratio[t] = beta[k];
+                    series.intercept[t] = alpha[k] - beta[k] * origin;
+                    series.spread[t] = error[k];
+                    series.z_score[t] = error_var[k] > 0.0 ? error[k] / std::sqrt(error_var[k]) : 0.0;
+                    // AR(1) persistence of the spread is 1 + ar_coef
+                    const double persistence = 1.0 + ar_coef[k];
+                    series.half_life[t] = persistence > 0.0 && persistence < 1.0 ?
+                                          -std::log(2.0) / std::log(persistence) : 0.0;
+                    series.adf_statistic[t] = ar_var[k] > 0.0 ? ar_coef[k] / std::sqrt(ar_var[k]) : 0.0;
+                }
+            }
+        }
+    }
+    
+    return results;
+}
+
+RollingCointegrationEngine::Series RollingCointegrationEngine::run(
+    const StockData& stock1, const StockData& stock2, const Options& options) {
+    return run(std::vector<std::pair<const StockData*, const StockData*>>{{&stock1, &stock2}}, options).front();
+}
@@ -1,25 +1,133 @@
 #include "simd_statistics.h"
+#include "simd_dispatch.h"
+#include "rolling_statistics.h"
+#include "adf_engine.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <chrono>
+#include <numeric>
 
 // Static member initialization
 SIMDStatistics::SIMDMetrics SIMDStatistics::last_metrics_;
 std::chrono::high_resolution_clock::time_point SIMDStatistics::start_time_;
 
+namespace {
+// Kernels of the active tier, nullptr when it is scalar
+const SimdKernels* vector_kernels() {
+    const SimdKernels& kernels = simd_kernels();
+    return kernels.tier == SimdTier::Scalar ? nullptr : &kernels;
+}
+
+// Counters of the timed call on this thread, opened on first use
+HardwareCounters* timing_counters() {
+    if (!hardware_counters_enabled()) return nullptr;
+    thread_local HardwareCounters counters(false);
+    return counters.valid() ? &counters : nullptr;
+}
+
+// Knight's O(n log n) tau-b: sort the pairs by (x, y), then the discordant
+// pairs are the exchanges a stable merge sort of y makes in that order;
+// ties in x, in y and in both come from runs of the two sorted orders
+double kendallTauB(const double* x, const double* y, const std::vector<uint32_t>& order) {
+    const size_t n = order.size();
+    if (n < 2) return 0.0;
+    
+    uint64_t x_ties = 0, joint_ties = 0;
+    for (size_t begin = 0; begin < n;) {
+        size_t end = begin + 1;
+        while (end < n && x[order[end]] == x[order[begin]]) ++end;
+        x_ties += static_cast<uint64_t>(end - begin) * (end - begin - 1) / 2;
+        for (size_t k = begin; k < end;) {
+            size_t run = k + 1;
+            while (run < end && y[order[run]] == y[order[k]]) ++run;
+            joint_ties += static_cast<uint64_t>(run - k) * (run - k - 1) / 2;
+            k = run;
+        }
+        begin = end;
+    }
+    
+    // Bottom-up merge sort of y in x order, counting exchanges
+    std::vector<double> values(n), merged(n);
+    for (size_t k = 0; k < n; ++k) values[k] = y[order[k]];
+    uint64_t exchanges = 0;
+    for (size_t width = 1; width < n; width *= 2) {
+        for (size_t left = 0; left < n; left += 2 * width) {
+            const size_t middle = std::min(n, left + width), right = std::min(n, left + 2 * width);
+            size_t i = left, j = middle, out = left;
+            while (i < middle && j < right) {
+                if (values[j] < values[i]) {
+                    exchanges += middle - i;
+                    merged[out++] = values[j++];
+                } else {
+                    merged[out++] = values[i++];
+                }
+            }
+            while (i < middle) merged[out++] = values[i++];
+            while (j < right) merged[out++] = values[j++];
+        }
+        values.swap(merged);
+    }
+    
+    uint64_t y_ties = 0;
+    for (size_t begin = 0; begin < n;) {
+        size_t end = begin + 1;
+        while (end < n && values[end] == values[begin]) ++end;
+        y_ties += static_cast<uint64_t>(end - begin) * (end - begin - 1) / 2;
+        begin = end;
+    }
+    
+    const double pairs = static_cast<double>(n) * (n - 1) / 2.0;
+    const double numerator = pairs - static_cast<double>(x_ties) - static_cast<double>(y_ties) +
+                             static_cast<double>(joint_ties) - 2.0 * static_cast<double>(exchanges);
+    const double denominator = (pairs - static_cast<double>(x_ties)) * (pairs - static_cast<double>(y_ties));
+    return denominator > 0.0 ? numerator / std::sqrt(denominator) : 0.0;
+}
+
+double kendallTauB(const double* x, const double* y, size_t n) {
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [x, y](uint32_t a, uint32_t b) {
+        return x[a] != x[b] ? x[a] < x[b] : y[a] < y[b];
+    });
+    return kendallTauB(x, y, order);
+}
+
+// The same over average ranks in [1, n]: twice a rank is an integer, so the
+// (x, y) order is a counting sort on x with only x's tie runs sorted by y
+double kendallTauBOfRanks(const double* x, const double* y, size_t n) {
+    std::vector<uint32_t> starts(2 * n + 3, 0), order(n);
+    auto key = [x](size_t i) { return static_cast<size_t>(std::lround(2.0 * x[i])); };
+    for (size_t i = 0; i < n; ++i) ++starts[key(i) + 1];
+    for (size_t k = 1; k < starts.size(); ++k) starts[k] += starts[k - 1];
+    for (size_t i = 0; i < n; ++i) order[starts[key(i)]++] = static_cast<uint32_t>(i);
+    for (size_t begin = 0; begin < n;) {
+        size_t end = begin + 1;
+        while (end < n && x[order[end]] == x[order[begin]]) ++end;
+        if (end - begin > 1) {
+            std::sort(order.begin() + begin, order.begin() + end, [y](uint32_t a, uint32_t b) { return y[a] < y[b]; });
+        }
+        begin = end;
+    }
+    return kendallTauB(x, y, order);
+}
+
+// A stock's cached return ranks, or ranks computed here when it has none
+const double* returnRanks(const StockData& stock, std::vector<double>& scratch) {
+    if (stock.hasReturnRanks()) return stock.return_ranks.data();
+    scratch.resize(stock.returns.size());
+    averageRanks(stock.returns.data(), stock.returns.size(), scratch.data());
+    return scratch.data();
+}
+}
+
 bool SIMDStatistics::isAVX2Available() {
-#ifdef HAVE_AVX2
-    return true;
-#else
-    return false;
-#endif
+    const SimdTier tier = active_simd_tier();
+    return tier == SimdTier::AVX2 || tier == SimdTier::AVX512;
 }
 
 bool SIMDStatistics::isNEONAvailable() {
-#ifdef HAVE_NEON
-    return true;
-#else
-    return false;
-#endif
+    return active_simd_tier() == SimdTier::NEON;
 }
 
 double SIMDStatistics::calculateCorrelation_SIMD(
@@ -33,19 +141,10 @@ double SIMDStatistics::calculateCorrelation_SIMD(
     
     double result;
     
-#ifdef HAVE_AVX2
-    if (isAVX2Available()) {
-        result = calculateCorrelation_AVX2(data1, data2, size);
-        endTiming(size * 4, "AVX2"); // Estimate 4 ops per element
-    } else
-#endif
-#ifdef HAVE_NEON
-    if (isNEONAvailable()) {
-        result = calculateCorrelation_NEON(data1, data2, size);
-        endTiming(size * 4, "NEON");
-    } else
-#endif
-    {
+    if (const SimdKernels* kernels = vector_kernels()) {
+        result = calculateCorrelation_Vector(*kernels, data1, data2, size);
+        endTiming(size * 4, simd_tier_name(kernels->tier)); // Estimate 4 ops per element
+    } else {
         result = calculateCorrelation_Scalar(data1, data2, size);
         endTiming(size * 4, "Scalar");
     }
@@ -84,25 +183,18 @@ double SIMDStatistics::calculateCorrelation_Scalar(
     return (denominator > 0.0) ? numerator / denominator : 0.0;
 }
 
-#ifdef HAVE_AVX2
-double SIMDStatistics::calculateCorrelation_AVX2(
-    const double* data1, const double* data2, size_t size) {
+double SIMDStatistics::calculateCorrelation_Vector(
+    const SimdKernels& kernels, const double* data1, const double* data2, size_t size) {
     
-    // Simplified AVX2 implementation
-    // In a full implementation, this would use proper AVX2 intrinsics
-    return calculateCorrelation_Scalar(data1, data2, size);
-}
-#endif
-
-#ifdef HAVE_NEON
-double SIMDStatistics::calculateCorrelation_NEON(
-    const double* data1, const double* data2, size_t size) {
+    const double mean1 = kernels.sum(data1, size) / size;
+    const double mean2 = kernels.sum(data2, size) / size;
+    
+    double products[3];
+    kernels.centered_products(data1, data2, size, mean1, mean2, products);
     
-    // Simplified NEON implementation
-    // In a full implementation, this would use proper NEON intrinsics
-    return calculateCorrelation_Scalar(data1, data2, size);
+    double denominator = std::sqrt(products[1] * products[2]);
+    return (denominator > 0.0) ? products[0] / denominator : 0.0;
 }
-#endif
 
 std::pair<double, double> SIMDStatistics::linearRegression_SIMD(
     const std::vector<double>& y,
@@ -112,10 +204,28 @@ std::pair<double, double> SIMDStatistics::linearRegression_SIMD(
         return {0.0, 0.0};
     }
     
-    // Use scalar implementation for now
+    if (const SimdKernels* kernels = vector_kernels()) {
+        return linearRegression_Vector(*kernels, y.data(), x.data(), x.size());
+    }
     return linearRegression_Scalar(y.data(), x.data(), x.size());
 }
 
+std::pair<double, double> SIMDStatistics::linearRegression_Vector(
+    const SimdKernels& kernels, const double* y, const double* x, size_t size) {
+    
+    const double mean_x = kernels.sum(x, size) / size;
+    const double mean_y = kernels.sum(y, size) / size;
+    
+    // {sum dx*dy, sum dx*dx, sum dy*dy}
+    double products[3];
+    kernels.centered_products(x, y, size, mean_x, mean_y, products);
+    
+    double slope = (products[1] > 0.0) ? products[0] / products[1] : 0.0;
+    double intercept = mean_y - slope * mean_x;
+    
+    return {intercept, slope}; // {alpha, beta}
+}
+
 std::pair<double, double> SIMDStatistics::linearRegression_Scalar(
     const double* y, const double* x, size_t size) {
     
@@ -147,9 +257,17 @@ std::pair<double, double> SIMDStatistics::linearRegression_Scalar(
 double SIMDStatistics::variance_SIMD(const std::vector<double>& data) {
     if (data.empty()) return 0.0;
     
+    if (const SimdKernels* kernels = vector_kernels()) {
+        return variance_Vector(*kernels, data.data(), data.size());
+    }
     return variance_Scalar(data.data(), data.size());
 }
 
+double SIMDStatistics::variance_Vector(const SimdKernels& kernels, const double* data, size_t size) {
+    const double mean = kernels.sum(data, size) / size;
+    return kernels.squared_deviation_sum(data, size, mean) / size;
+}
+
 double SIMDStatistics::variance_Scalar(const double* data, size_t size) {
     if (size == 0) return 0.0;
     
@@ -170,7 +288,41 @@ double SIMDStatistics::variance_Scalar(const double* data, size_t size) {
     return variance / size;
 }
 
+// Rolling statistics are RollingStatistics', the same code the feature
+// columns use, so a window here matches the feature files exactly
+std::vector<double> SIMDStatistics::rollingMean_SIMD(const std::vector<double>& data, int window_size) {
+    if (window_size <= 0 || data.size() < static_cast<size_t>(window_size)) return {};
+    startTiming();
+    std::vector<double> result(data.size() - window_size + 1);
+    RollingStatistics::mean(data.data(), data.size(), static_cast<size_t>(window_size), result.data());
+    endTiming(data.size() * 2, simd_tier_name(active_simd_tier()));
+    return result;
+}
+
+std::vector<double> SIMDStatistics::rollingStdDev_SIMD(const std::vector<double>& data, int window_size) {
+    if (window_size <= 1 || data.size() < static_cast<size_t>(window_size)) return {};
+    startTiming();
+    std::vector<double> result(data.size() - window_size + 1);
+    RollingStatistics::stddev(data.data(), data.size(), static_cast<size_t>(window_size), result.data());
+    endTiming(data.size() * 5, simd_tier_name(active_simd_tier()));
+    return result;
+}
+
+std::vector<double> SIMDStatistics::rollingCorrelation_SIMD(const std::vector<double>& series1,
+                                                            const std::vector<double>& series2,
+                                                            int window_size) {
+    const size_t size = std::min(series1.size(), series2.size());
+    if (window_size <= 1 || size < static_cast<size_t>(window_size)) return {};
+    startTiming();
+    std::vector<double> result(size - window_size + 1);
+    RollingStatistics::correlation(series1.data(), series2.data(), size, static_cast<size_t>(window_size),
+                                   result.data());
+    endTiming(size * 12, simd_tier_name(active_simd_tier()));
+    return result;
+}
+
 void SIMDStatistics::startTiming() {
+    if (HardwareCounters* counters = timing_counters()) counters->start();
     start_time_ = std::chrono::high_resolution_clock::now();
 }
 
@@ -181,6 +333,11 @@ void SIMDStatistics::endTiming(size_t operations, const std::string& simd_type)
     last_metrics_.computation_time_ms = duration.count() / 1000.0;
     last_metrics_.operations_performed = operations;
     last_metrics_.simd_type_used = simd_type;
+    last_metrics_.counters = CounterValues{};
+    if (HardwareCounters* counters = timing_counters()) {
+        last_metrics_.counters = counters->read();
+        record_counters("kernel: correlation (" + simd_type + ")", last_metrics_.counters);
+    }
     
     if (last_metrics_.computation_time_ms > 0.0) {
         double ops_per_second = operations / (last_metrics_.computation_time_ms / 1000.0);
@@ -188,6 +345,31 @@ void SIMDStatistics::endTiming(size_t operations, const std::string& simd_type)
     }
 }
 
+double SIMDStatistics::augmentedDickeyFuller_SIMD(
+    const std::vector<double>& series,
+    int lags) {
+    
+    BatchADFEngine::Options options;
+    options.max_lags = lags;
+    options.selection = BatchADFEngine::LagSelection::Fixed;
+    return BatchADFEngine::run(series, options).statistic;
+}
+
+std::vector<double> SIMDStatistics::batchAugmentedDickeyFuller_SIMD(
+    const std::vector<std::vector<double>>& spreads) {
+    
+    std::vector<const std::vector<double>*> series;
+    series.reserve(spreads.size());
+    for (const auto& spread : spreads) series.push_back(&spread);
+    
+    std::vector<double> statistics;
+    statistics.reserve(spreads.size());
+    for (const auto& result : BatchADFEngine::run(series, BatchADFEngine::Options{})) {
+        statistics.push_back(result.statistic);
+    }
+    return statistics;
+}
+
 // Note: Cointegration analyzer implementation moved to cointegration_analyzer.cpp
 
 // Correlation analyzer implementation
@@ -204,9 +386,7 @@ CorrelationResult SIMDCorrelationAnalyzer::analyzeCorrelation_SIMD(
         result.pearson_correlation = SIMDStatistics::calculateCorrelation_SIMD(
             stock1.returns, stock2.returns);
         
-        // Simplified other correlations
-        result.spearman_correlation = result.pearson_correlation * 0.95; // Approximation
-        result.kendall_tau = result.pearson_correlation * 0.8; // Approximation
+        fillRankCorrelations(stock1, stock2, result);
         
         result.correlation_stability = 0.9; // Dummy value
         result.correlation_grade = result.pearson_correlation > 0.7 ? "A" : "C";
@@ -215,6 +395,68 @@ CorrelationResult SIMDCorrelationAnalyzer::analyzeCorrelation_SIMD(
     return result;
 }
 
+double SIMDCorrelationAnalyzer::calculateSpearmanCorrelation_SIMD(
+    const std::vector<double>& series1,
+    const std::vector<double>& series2) {
+    
+    if (series1.size() != series2.size() || series1.size() < 2) {
+        return 0.0;
+    }
+    return SIMDStatistics::calculateCorrelation_SIMD(rankTransform_SIMD(series1), rankTransform_SIMD(series2));
+}
+
+double SIMDCorrelationAnalyzer::calculateSpearmanCorrelation_SIMD(
+    const StockData& stock1,
+    const StockData& stock2) {
+    
+    const size_t n = stock1.returns.size();
+    if (stock2.returns.size() != n || n < 2) {
+        return 0.0;
+    }
+    std::vector<double> scratch1, scratch2;
+    const double* ranks1 = returnRanks(stock1, scratch1);
+    const double* ranks2 = returnRanks(stock2, scratch2);
+    return SIMDStatistics::calculateCorrelation_SIMD(ranks1, ranks2, n);
+}
+
+double SIMDCorrelationAnalyzer::calculateKendallTau_SIMD(
+    const std::vector<double>& series1,
+    const std::vector<double>& series2) {
+    
+    if (series1.size() != series2.size()) {
+        return 0.0;
+    }
+    return kendallTauB(series1.data(), series2.data(), series1.size());
+}
+
+double SIMDCorrelationAnalyzer::calculateKendallTau_SIMD(
+    const StockData& stock1,
+    const StockData& stock2) {
+    
+    const size_t n = stock1.returns.size();
+    if (stock2.returns.size() != n) {
+        return 0.0;
+    }
+    // Ranks order the bars exactly as the returns do, ties included
+    std::vector<double> scratch1, scratch2;
+    return kendallTauBOfRanks(returnRanks(stock1, scratch1), returnRanks(stock2, scratch2), n);
+}
+
+void SIMDCorrelationAnalyzer::fillRankCorrelations(
+    const StockData& stock1,
+    const StockData& stock2,
+    CorrelationResult& result) {
+    
+    result.spearman_correlation = calculateSpearmanCorrelation_SIMD(stock1, stock2);
+    result.kendall_tau = calculateKendallTau_SIMD(stock1, stock2);
+}
+
+std::vector<double> SIMDCorrelationAnalyzer::rankTransform_SIMD(const std::vector<double>& data) {
+    std::vector<double> ranks(data.size());
+    averageRanks(data.data(), data.size(), ranks.data());
+    return ranks;
+}
+
 // Performance benchmark implementation
 SIMDPerformanceBenchmark::BenchmarkResult SIMDPerformanceBenchmark::last_benchmark_;
 
@@ -262,13 +504,7 @@ void SIMDPerformanceBenchmark::compareImplementations(
     last_benchmark_.gflops_scalar = (iterations * ops_per_iteration) / (last_benchmark_.scalar_time_ms / 1000.0) / 1e9;
     last_benchmark_.gflops_simd = (iterations * ops_per_iteration) / (last_benchmark_.simd_time_ms / 1000.0) / 1e9;
     
-    if (SIMDStatistics::isAVX2Available()) {
-        last_benchmark_.best_implementation = "AVX2";
-    } else if (SIMDStatistics::isNEONAvailable()) {
-        last_benchmark_.best_implementation = "NEON";
-    } else {
-        last_benchmark_.best_implementation = "Scalar";
-    }
+    last_benchmark_.best_implementation = simd_tier_name(active_simd_tier());
     
     std::cout << "Performance Benchmark Results:" << std::endl;
     std::cout << "  Scalar time: " << last_benchmark_.scalar_time_ms << " ms" << std::endl;
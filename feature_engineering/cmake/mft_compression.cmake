@@ -0,0 +1,31 @@
+# mft_compression: the optional LZ4 and Zstd codecs behind compressed .mftc
+# columns (column_codec.h). Each codec is used when its header and library
+# are found, for instance under CMAKE_PREFIX_PATH, and defines MFT_HAVE_LZ4
+# or MFT_HAVE_ZSTD for the targets linking this one. Without them the build
+# still succeeds: the codec is reported unavailable, --compression refuses
+# it, and files compressed with it cannot be read.
+include_guard(GLOBAL)
+
+add_library(mft_compression INTERFACE)
+
+find_path(MFT_LZ4_INCLUDE_DIR lz4.h)
+find_library(MFT_LZ4_LIBRARY lz4)
+if(MFT_LZ4_INCLUDE_DIR AND MFT_LZ4_LIBRARY)
+    target_include_directories(mft_compression INTERFACE ${MFT_LZ4_INCLUDE_DIR})
+    target_link_libraries(mft_compression INTERFACE ${MFT_LZ4_LIBRARY})
+    target_compile_definitions(mft_compression INTERFACE MFT_HAVE_LZ4)
+    message(STATUS "Columnar compression: LZ4 (${MFT_LZ4_LIBRARY})")
+else()
+    message(STATUS "Columnar compression: LZ4 not found")
+endif()
+
+find_path(MFT_ZSTD_INCLUDE_DIR zstd.h)
+find_library(MFT_ZSTD_LIBRARY zstd)
+if(MFT_ZSTD_INCLUDE_DIR AND MFT_ZSTD_LIBRARY)
+    target_include_directories(mft_compression INTERFACE ${MFT_ZSTD_INCLUDE_DIR})
+    target_link_libraries(mft_compression INTERFACE ${MFT_ZSTD_LIBRARY})
+    target_compile_definitions(mft_compression INTERFACE MFT_HAVE_ZSTD)
+    message(STATUS "Columnar compression: Zstd (${MFT_ZSTD_LIBRARY})")
+else()
+    message(STATUS "Columnar compression: Zstd not found")
+endif()
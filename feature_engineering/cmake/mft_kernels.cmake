@@ -0,0 +1,49 @@
+# mft_kernels: the vector kernels shared by feature_engineering and
+# arbitrage. It holds the runtime-dispatched kernel table (simd_dispatch.h),
+# one translation unit per tier built with that tier's flags, and
+# RollingStatistics on top of them. Both projects include this file and link
+# the target, so kernel tuning lands in both at once.
+include_guard(GLOBAL)
+
+set(MFT_KERNELS_ROOT ${CMAKE_CURRENT_LIST_DIR}/..)
+set(MFT_KERNELS_AVX2_SOURCE ${MFT_KERNELS_ROOT}/src/simd_kernels_avx2.cpp)
+set(MFT_KERNELS_AVX512_SOURCE ${MFT_KERNELS_ROOT}/src/simd_kernels_avx512.cpp)
+set(MFT_KERNELS_ROLLING_SOURCE ${MFT_KERNELS_ROOT}/src/rolling_statistics.cpp)
+
+add_library(mft_kernels STATIC
+    ${MFT_KERNELS_ROOT}/src/simd_dispatch.cpp
+    ${MFT_KERNELS_AVX2_SOURCE}
+    ${MFT_KERNELS_AVX512_SOURCE}
+    ${MFT_KERNELS_ROOT}/src/simd_kernels_neon.cpp
+    ${MFT_KERNELS_ROLLING_SOURCE}
+)
+target_include_directories(mft_kernels PUBLIC ${MFT_KERNELS_ROOT}/include)
+target_compile_features(mft_kernels PUBLIC cxx_std_17)
+
+# The tier files carry their own ISA flags; everything else follows
+# MFT_PORTABLE_BUILD like the projects using it. The compensated sums of
+# RollingStatistics must not be reassociated, so that file opts out of
+# fast math.
+if(MSVC)
+    target_compile_options(mft_kernels PRIVATE /O2 /fp:fast)
+    set_source_files_properties(${MFT_KERNELS_AVX2_SOURCE} PROPERTIES COMPILE_OPTIONS "/arch:AVX2")
+    set_source_files_properties(${MFT_KERNELS_AVX512_SOURCE} PROPERTIES COMPILE_OPTIONS "/arch:AVX512")
+    set_source_files_properties(${MFT_KERNELS_ROLLING_SOURCE} PROPERTIES COMPILE_OPTIONS "/fp:precise")
+else()
+    target_compile_options(mft_kernels PRIVATE -O3 -ffast-math -funroll-loops)
+    if(NOT MFT_PORTABLE_BUILD)
+        target_compile_options(mft_kernels PRIVATE -march=native)
+    endif()
+    set_source_files_properties(${MFT_KERNELS_ROLLING_SOURCE} PROPERTIES COMPILE_OPTIONS "-fno-fast-math")
+    if(NOT CMAKE_SYSTEM_PROCESSOR MATCHES "arm64|aarch64|ARM64")
+        include(CheckCXXCompilerFlag)
+        check_cxx_compiler_flag("-mavx2" MFT_KERNELS_HAVE_AVX2)
+        check_cxx_compiler_flag("-mavx512f" MFT_KERNELS_HAVE_AVX512)
+        if(MFT_KERNELS_HAVE_AVX2)
+            set_source_files_properties(${MFT_KERNELS_AVX2_SOURCE} PROPERTIES COMPILE_OPTIONS "-mavx2;-mfma")
+        endif()
+        if(MFT_KERNELS_HAVE_AVX512)
+            set_source_files_properties(${MFT_KERNELS_AVX512_SOURCE} PROPERTIES COMPILE_OPTIONS "-mavx512f;-mavx2;-mfma")
+        endif()
+    endif()
+endif()
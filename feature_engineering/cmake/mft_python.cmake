@@ -0,0 +1,31 @@
+# mft_python: the CPython extension modules (mft_features here, mft_pairs in
+# arbitrage), built with -DMFT_PYTHON=ON. They need Python's development
+# headers only: NumPy and pyarrow are picked up at run time when installed
+# (python/mft_python.h). Put the build directory on PYTHONPATH, or copy the
+# module next to the notebook, to import it.
+include_guard(GLOBAL)
+
+set(MFT_PYTHON_ROOT ${CMAKE_CURRENT_LIST_DIR}/..)
+option(MFT_PYTHON "Build the Python extension modules" OFF)
+
+if(MFT_PYTHON)
+    if(CMAKE_VERSION VERSION_LESS 3.18)
+        message(FATAL_ERROR "MFT_PYTHON needs CMake 3.18 or newer")
+    endif()
+    find_package(Python3 3.9 REQUIRED COMPONENTS Interpreter Development.Module)
+    message(STATUS "Python modules: ENABLED (Python ${Python3_VERSION})")
+else()
+    message(STATUS "Python modules: DISABLED (-DMFT_PYTHON=ON to build)")
+endif()
+
+# mft_add_python_module(<name> <sources>...): a module importable as <name>,
+# linked against the static libraries it then needs position-independent
+function(mft_add_python_module name)
+    Python3_add_library(${name} MODULE WITH_SOABI ${ARGN})
+    target_include_directories(${name} PRIVATE ${MFT_PYTHON_ROOT}/python)
+    set_target_properties(${name} PROPERTIES
+        CXX_VISIBILITY_PRESET hidden
+        POSITION_INDEPENDENT_CODE ON
+    )
+    set_target_properties(mft_kernels PROPERTIES POSITION_INDEPENDENT_CODE ON)
+endfunction()
@@ -0,0 +1,114 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Whole-file reads and writes with many files in flight from one thread, for
+// the bulk phases that touch thousands of files: the CSV readers, the
+// feature writers and the arbitrage loader.
+//
+// On Linux the requests go through an io_uring. Opens, reads, writes and
+// closes are all ring operations, so one io_uring_enter submits the next
+// step of every file that is ready and reaps whatever finished, and up to
+// queue_depth files are in flight without a thread apiece. Reads land in
+// per-request slots registered with the ring (IORING_OP_READ_FIXED); a file
+// that outgrows its slot continues into a buffer of its own. Elsewhere, or
+// when the kernel refuses a ring (old kernel, seccomp, io_uring_disabled),
+// a few threads run the same requests with blocking calls.
+//
+// An AsyncFileIO belongs to the thread that created it: every call and every
+// callback happens on that thread.
+
+enum class AsyncIOBackend {
+    IoUring,
+    ThreadPool,
+};
+
+const char* async_io_backend_name(AsyncIOBackend backend);
+
+struct AsyncIOConfig {
+    unsigned queue_depth = 32;          // files in flight
+    // Registered read buffer per in-flight file; larger files are read on
+    // into a heap buffer
+    size_t read_slot_bytes = 256 << 10;
+    unsigned fallback_threads = 4;      // ThreadPool backend workers
+    bool force_thread_pool = false;
+};
+
+// One finished request
+struct AsyncIOResult {
+    size_t tag = 0;
+    const std::string* path = nullptr;
+    // A read's contents, valid only during the callback
+    const char* data = nullptr;
+    size_t size = 0;
+    // errno of the step that failed, 0 on success
+    int error = 0;
+    const char* failed_step = nullptr;  // "open", "create", "read", "write" or "close"
+
+    bool ok() const { return error == 0; }
+    // "Cannot <step> file: <path>: <reason>"
+    std::string message() const;
+};
+
+class AsyncFileIO {
+public:
+    using Callback = std::function<void(const AsyncIOResult&)>;
+
+    explicit AsyncFileIO(const AsyncIOConfig& config = {});
+    // Waits for the writes still in flight (drain())
+    ~AsyncFileIO();
+    AsyncFileIO(const AsyncFileIO&) = delete;
+    AsyncFileIO& operator=(const AsyncFileIO&) = delete;
+
+    AsyncIOBackend backend() const;
+
+    // Reads whole files until next(path, tag) returns false, keeping up to
+    // queue_depth of them in flight. on_read gets each file once it has been
+    // read (or failed), in completion order rather than request order.
+    void read_files(const std::function<bool(std::string&, size_t&)>& next, const Callback& on_read);
+    // The same over a list; the tag is the index in `paths`
+    void read_files(const std::vector<std::string>& paths, const Callback& on_read);
+
+    // Creates or truncates `path` and writes `content` to it, taking the
+    // bytes over; returns once the write is submitted, after waiting for
+    // one to finish if queue_depth are in flight. Failures are kept for
+    // take_write_errors().
+    void write_file(std::string path, std::string content, size_t tag = 0);
+    // Waits for every write in flight
+    void drain();
+    // Failed writes since the last call: tag and message()
+    std::vector<std::pair<size_t, std::string>> take_write_errors();
+
+    // Files read and written so far
+    size_t files_read() const { return files_read_; }
+    size_t files_written() const { return files_written_; }
+
+    // Backend internals (async_file_io.cpp)
+    struct Request;
+    class Engine;
+
+private:
+    // An idle request, waiting for one to finish if all are in flight
+    Request* acquire();
+    // Submits what is queued and completes what finished, waiting for at
+    // least one request if `block` and any are in flight
+    void poll(bool block);
+    // Hands one finished request to on_read_ (reads) or the error list
+    void complete(Request& request);
+
+    AsyncIOConfig config_;
+    std::unique_ptr<char[]> slots_;         // queue_depth read slots
+    std::vector<std::unique_ptr<Request>> requests_;
+    std::vector<Request*> idle_;
+    std::vector<Request*> finished_;
+    std::unique_ptr<Engine> engine_;
+    const Callback* on_read_ = nullptr;     // during read_files
+    size_t reads_in_flight_ = 0;
+    std::vector<std::pair<size_t, std::string>> write_errors_;
+    size_t files_read_ = 0;
+    size_t files_written_ = 0;
+};
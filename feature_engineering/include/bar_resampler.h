@@ -0,0 +1,57 @@
+#pragma once
+#include "ohlcv_data.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Trading hours in the wall-clock time the timestamps are stored in, as
+// minutes after midnight. A close at or before the open is a session that
+// runs past midnight (futures, FX); its bars belong to the day it opened.
+// The default session is the whole day.
+struct TradingSession {
+    int open_minute = 0;
+    int close_minute = 24 * 60;
+
+    // Session length in minutes, 1440 when open and close coincide
+    int64_t minutes() const;
+};
+
+// One bar length of a resample: `minutes` per bar, or one bar per session
+// when minutes is 0
+struct BarFrequency {
+    std::string name;               // "5m", "1h" or "daily"; data_frequency column and file suffix
+    int64_t minutes = 0;
+};
+
+// Frequencies built from each source series before its features are
+// computed; off while `frequencies` is empty
+struct ResampleConfig {
+    std::vector<BarFrequency> frequencies;
+    TradingSession session;
+
+    bool enabled() const { return !frequencies.empty(); }
+};
+
+// Parses "5m,15m,1h,daily" (m or min, h, d or daily) into distinct
+// frequencies, shortest first with daily last. Throws std::runtime_error on
+// anything else.
+std::vector<BarFrequency> parse_frequency_list(const std::string& list);
+// Parses "09:30-16:00"; throws std::runtime_error otherwise
+TradingSession parse_trading_session(const std::string& text);
+
+// Builds every frequency of a ResampleConfig from a series of finer bars in
+// one pass over it. Buckets are anchored at the session open each day, so
+// hourly bars of a 09:30 open run 09:30-10:30, ..., and the last bucket of
+// a session ends at its close rather than spilling into the next one. Bars
+// outside the session are dropped.
+//
+// A bucket's bar opens at its first source bar's open and closes at its last
+// one's close, with the high and low over them and the volume summed, and is
+// stamped with the bucket's start. Source bars must be in time order; only
+// buckets that received a bar are emitted.
+class BarResampler {
+public:
+    // out[k] gets the bars of config.frequencies[k], with the source's
+    // symbol. Resizes `out`, reusing its vectors.
+    static void resample(const OHLCVData& source, const ResampleConfig& config, std::vector<OHLCVData>& out);
+};
@@ -1,47 +1,103 @@
 #pragma once
 
 #include "ohlcv_data.h"
+#include "feature_selection.h"
+#include "feature_block.h"
+#include "garch_model.h"
+#include "regime_model.h"
 #include <vector>
-#include <string>
 #include <memory>
-#include <map>
-#include <functional>
 
-class BatchOHLCProcessor {
-private:
-    class ComputationCache {
-    private:
-        std::map<std::string, std::vector<double>> cache_;
-        bool use_simd_;
-
-    public:
-        ComputationCache(bool enable_simd = true);
-        std::vector<double>& get_or_compute(
-            const std::string& key,
-            std::function<std::vector<double>()> simd_computer,
-            std::function<std::vector<double>()> scalar_computer
-        );
-        void clear();
-    };
+class FeatureGraph;
 
+class BatchOHLCProcessor {
 public:
     BatchOHLCProcessor() = default;
 
+    // Runs chains of columns over the same inputs fused (FusionPlan, on by
+    // default); off, every column makes its own pass, with the same values
+    void set_loop_fusion(bool enabled) { loop_fusion_ = enabled; }
+
     FeatureSet calculate_features(
         const std::vector<double>& open,
         const std::vector<double>& high,
         const std::vector<double>& low,
         const std::vector<double>& close,
         const std::vector<double>& volume,
-        bool force_scalar = false
+        bool force_scalar = false,
+        const FeatureMask& selection = all_features()
     );
 
+    // Same features written into `block` (reset to close.size() rows). Keep
+    // one block per worker thread and reuse it across series. `garch` holds
+    // fitted parameters for the GARCH-filtered regime features (see
+    // GarchModel), `regimes` fitted models for the HMM regime features (see
+    // RegimeModel).
+    void calculate_features_into(
+        const std::vector<double>& open,
+        const std::vector<double>& high,
+        const std::vector<double>& low,
+        const std::vector<double>& close,
+        const std::vector<double>& volume,
+        FeatureBlock& block,
+        bool force_scalar = false,
+        const FeatureMask& selection = all_features(),
+        const GarchParams* garch = nullptr,
+        const RegimeFeatureParams* regimes = nullptr
+    );
+
+    // Equal-length series are grouped SIMD-lane-wide (4 on AVX2, 8 on AVX-512,
+    // 2 on NEON) and their recursive filters (EMA cascade, KAMA, GARCH,
+    // Klinger) run for the whole group at once; the rest run per series.
+    // Copies each series' block out into a FeatureSet; batch_calculate_features_into
+    // leaves the columns in the blocks.
     std::vector<FeatureSet> batch_calculate_features(
         const std::vector<std::vector<double>>& open_prices,
         const std::vector<std::vector<double>>& high_prices,
         const std::vector<std::vector<double>>& low_prices,
         const std::vector<std::vector<double>>& close_prices,
         const std::vector<std::vector<double>>& volumes,
-        bool force_scalar = false
+        bool force_scalar = false,
+        const FeatureMask& selection = all_features()
+    );
+
+    // Fills blocks[i] for series i. `blocks` is resized to the series count;
+    // blocks already present are reused and new ones are Float64.
+    void batch_calculate_features_into(
+        const std::vector<std::vector<double>>& open_prices,
+        const std::vector<std::vector<double>>& high_prices,
+        const std::vector<std::vector<double>>& low_prices,
+        const std::vector<std::vector<double>>& close_prices,
+        const std::vector<std::vector<double>>& volumes,
+        std::vector<std::unique_ptr<FeatureBlock>>& blocks,
+        bool force_scalar = false,
+        const FeatureMask& selection = all_features()
+    );
+
+private:
+    // Fills `block` from a graph built over the same series, possibly pre-seeded
+    void calculate_features_from_graph(
+        const std::vector<double>& open,
+        const std::vector<double>& high,
+        const std::vector<double>& low,
+        const std::vector<double>& close,
+        const std::vector<double>& volume,
+        FeatureGraph& graph,
+        FeatureBlock& block,
+        const FeatureMask& selection
     );
+
+    // One group of series_lanes() equal-length series, given by index
+    void calculate_lane_group(
+        const std::vector<std::vector<double>>& open_prices,
+        const std::vector<std::vector<double>>& high_prices,
+        const std::vector<std::vector<double>>& low_prices,
+        const std::vector<std::vector<double>>& close_prices,
+        const std::vector<std::vector<double>>& volumes,
+        const size_t* series, size_t lanes,
+        const FeatureMask& selection,
+        std::vector<std::unique_ptr<FeatureBlock>>& blocks
+    );
+
+    bool loop_fusion_ = true;
 };
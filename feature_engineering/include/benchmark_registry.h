@@ -0,0 +1,101 @@
+#pragma once
+#include "ohlcv_data.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Benchmark harness behind run_benchmarks (and run_feature_extractor
+// --benchmark): one registry of every indicator, vector kernel, rolling
+// statistic and pipeline stage, timed with warmup and repetitions over a
+// deterministic synthetic dataset or replayed feature-extractor CSVs.
+// Results are summarized per case, written as JSON and can be compared
+// against a saved baseline to gate upgrades on regressions.
+
+// Series every case runs over
+struct BenchmarkDataset {
+    std::string name;                               // "synthetic_32x5000" or the replayed directory
+    std::vector<std::unique_ptr<OHLCVData>> series;
+    std::vector<std::string> files;                 // source CSVs when replayed
+
+    size_t total_points() const;
+
+    // Random walks with wicks and volume from a fixed seed, so runs on
+    // different builds see the same bars
+    static BenchmarkDataset synthetic(size_t series, size_t bars);
+    // Up to `limit` CSVs of `directory` (0 = all) read with FastCSVReader;
+    // throws std::runtime_error when none can be read
+    static BenchmarkDataset replay(const std::string& directory, size_t limit);
+};
+
+struct BenchmarkCase {
+    std::string name;       // "<group>/<kernel>", "@<tier>" or "@<n>t" for sweeps
+    std::string group;      // indicator, features, kernel, statistics, parallel, live, io
+    // Builds the case's inputs outside the timed region and returns the
+    // timed body, which reports the data points it processed; an empty
+    // function when the case does not apply to the dataset
+    std::function<std::function<size_t()>(const BenchmarkDataset&)> prepare;
+};
+
+// Every registered case, in report order
+const std::vector<BenchmarkCase>& benchmark_registry();
+
+struct BenchmarkOptions {
+    size_t warmup = 1;
+    size_t repetitions = 5;
+    std::vector<std::string> filters;   // substrings of case names; empty runs everything
+    bool quiet = false;                 // no per-case progress lines
+};
+
+struct BenchmarkResult {
+    std::string name;
+    std::string group;
+    size_t repetitions = 0;
+    size_t points = 0;                  // per repetition
+    double min_ms = 0.0;
+    double median_ms = 0.0;
+    double mean_ms = 0.0;
+    double stddev_ms = 0.0;             // sample standard deviation
+    double max_ms = 0.0;
+    double points_per_second = 0.0;     // at the median
+    // From hardware counters over the timed repetitions; 0 when disabled
+    double cycles_per_point = 0.0;
+    double ipc = 0.0;
+};
+
+bool benchmark_selected(const BenchmarkCase& benchmark, const BenchmarkOptions& options);
+
+// Times the selected cases over `dataset`
+std::vector<BenchmarkResult> run_benchmarks(const std::vector<BenchmarkCase>& cases,
+                                            const BenchmarkDataset& dataset,
+                                            const BenchmarkOptions& options);
+
+// Writes {"schema", "host", "dataset", "options", "results"}; throws
+// std::runtime_error when the file cannot be written
+void write_benchmark_json(const std::string& path, const BenchmarkDataset& dataset,
+                          const BenchmarkOptions& options, const std::vector<BenchmarkResult>& results);
+
+// Results and dataset name of a file written by write_benchmark_json;
+// throws std::runtime_error on a missing or malformed file
+std::vector<BenchmarkResult> read_benchmark_json(const std::string& path, std::string* dataset_name = nullptr);
+
+struct BenchmarkComparison {
+    std::string name;
+    double baseline_ms = 0.0;           // medians
+    double current_ms = 0.0;
+    double change = 0.0;                // current / baseline - 1
+    bool regression = false;
+};
+
+// A case regresses when its median is slower than the baseline's by more
+// than `threshold` (relative) and by more than twice the larger of the two
+// standard deviations, so noisy cases need a clear slowdown to trip it.
+// Cases missing from either side are skipped.
+std::vector<BenchmarkComparison> compare_benchmarks(const std::vector<BenchmarkResult>& baseline,
+                                                    const std::vector<BenchmarkResult>& current,
+                                                    double threshold);
+
+// Command-line driver; argv[0] is skipped. Returns the process exit code:
+// 1 on bad arguments or when a comparison finds a regression.
+int run_benchmark_main(int argc, char* argv[]);
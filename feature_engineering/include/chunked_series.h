@@ -0,0 +1,22 @@
+#pragma once
+#include "feature_pipeline.h"
+#include <string>
+#include <cstddef>
+
+// One series of the bounded-memory mode (PipelineConfig::memory_budget_mb):
+// read `chunk_rows` rows at a time through one StreamingFeatureEngine and
+// appended chunk by chunk to the pipeline's output files, as one streaming
+// pass would write them. Not published to shared memory or joined to the panel.
+struct ChunkedSeriesResult {
+    std::string symbol;
+    size_t rows = 0;                // 0 when the file has no rows; nothing is written then
+    size_t chunks = 0;
+    bool sweep_written = false;
+};
+
+// Throws std::runtime_error if the file cannot be read or an output written
+ChunkedSeriesResult process_series_in_chunks(const std::string& csv_file,
+                                             const std::string& output_dir,
+                                             const FeatureMask& selection,
+                                             const PipelineConfig& config,
+                                             size_t chunk_rows);
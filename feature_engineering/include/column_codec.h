@@ -0,0 +1,45 @@
+#pragma once
+#include "columnar_format.h"
+#include <cstddef>
+#include <cstdint>
+
+// Per-column compression of .mftc version 2 files (columnar_format.h). A
+// column is encoded (ColumnEncoding) to turn slowly varying values into runs
+// of zero bytes, then compressed as one chunk by its codec: LZ4 for speed,
+// Zstd for archives. The codecs are optional build dependencies
+// (cmake/mft_compression.cmake); one that was not built in is reported
+// unavailable, and files using it cannot be written or read.
+
+struct ColumnarCompression {
+    ColumnCodec codec = ColumnCodec::None;
+    // Zstd level, or LZ4 acceleration; 0 = the codec's default (3 and 1)
+    int level = 0;
+};
+
+bool column_codec_available(ColumnCodec codec);
+const char* column_codec_name(ColumnCodec codec);
+
+// Delta for the datetime column; Xor for float columns whose neighbouring
+// values mostly share their sign, exponent and leading mantissa bits (prices,
+// moving averages, bands), judged on a sample of rows; Shuffle for the rest
+ColumnEncoding choose_column_encoding(ColumnType type, const uint8_t* values, size_t count);
+
+// Encodes `count` values of `element` bytes (4 or 8) from `in` into `out`:
+// each value becomes its difference from (Delta) or XOR with (Xor) the one
+// before it, or stays as it is (Shuffle), and the result is stored as
+// `element` byte planes (byte b of every value, then byte b + 1), so the
+// zero and repeated high bytes sit together.
+// decode_column inverts it. Neither buffer may overlap the other.
+void encode_column(ColumnEncoding encoding, const uint8_t* in, size_t count, size_t element, uint8_t* out);
+void decode_column(ColumnEncoding encoding, const uint8_t* in, size_t count, size_t element, uint8_t* out);
+
+// Largest output of compress_chunk for `bytes` of input
+size_t compress_chunk_bound(ColumnCodec codec, size_t bytes);
+// Compresses `bytes` from `in` into `out` and returns the stored size, or 0
+// if it does not fit `capacity`. Throws std::runtime_error for a codec that
+// is not available.
+size_t compress_chunk(const ColumnarCompression& compression, const uint8_t* in, size_t bytes,
+                      uint8_t* out, size_t capacity);
+// Decompresses a chunk of `stored` bytes that must expand to exactly `raw`
+// bytes; false if it is corrupt or the codec is not available
+bool decompress_chunk(ColumnCodec codec, const uint8_t* in, size_t stored, uint8_t* out, size_t raw);
@@ -0,0 +1,149 @@
+#pragma once
+#include "mapped_file.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// MFT columnar feature file (.mftc), host (little-endian) byte order.
+//
+//   offset 0          ColumnarHeader (64 bytes)
+//   strings_offset    symbol bytes followed by data_frequency bytes (no NUL)
+//   directory_offset  column_count ColumnarColumn records (80 bytes each)
+//   data_offset       per column: row_count values, every payload 64-byte aligned
+//
+// Columns appear in CSV order: datetime, open, high, low, close, volume, then
+// the selected features. Every column spans all rows; rows a feature has not
+// produced yet (its warm-up) hold NaN, where the CSV has a blank cell. The
+// datetime column is int64 seconds since the Unix epoch (UTC), all other
+// columns are float64, so a mapped file can be read in place. Features
+// extracted in float32 mode are float32 columns instead; a float32 payload
+// is row_count * 4 bytes, again padded to 64.
+//
+// Version 2 files may hold compressed columns (column_codec.h). Such a
+// column's record names its codec and encoding, and its payload is a
+// ColumnarChunk followed by stored_bytes of codec output, which expand to
+// the row_count values above. Columns that did not shrink are stored as in
+// version 1. Writers emit version 1 whenever no column is compressed.
+constexpr char kColumnarMagic[8] = {'M', 'F', 'T', 'C', 'O', 'L', '\0', '\0'};
+constexpr uint32_t kColumnarVersion = 1;
+constexpr uint32_t kColumnarCompressedVersion = 2;
+constexpr size_t kColumnarAlignment = 64;
+constexpr const char* kColumnarExtension = ".mftc";
+
+enum class ColumnType : uint32_t {
+    Float64 = 0,
+    Int64 = 1,
+    Float32 = 2,
+};
+
+enum class ColumnCodec : uint8_t {
+    None = 0,
+    Lz4 = 1,
+    Zstd = 2,
+};
+
+// Applied to a column's values before its codec (encode_column)
+enum class ColumnEncoding : uint8_t {
+    None = 0,
+    Delta = 1,      // integer differences, for timestamps
+    Xor = 2,        // bitwise XOR with the previous value, for slowly varying floats
+    Shuffle = 3,    // byte planes of the values alone, for the other floats
+};
+
+struct ColumnarHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t column_count;
+    uint64_t row_count;
+    uint64_t strings_offset;
+    uint64_t directory_offset;
+    uint32_t symbol_length;
+    uint32_t frequency_length;
+    uint8_t reserved[16];
+};
+static_assert(sizeof(ColumnarHeader) == 64, "ColumnarHeader layout is part of the file format");
+
+struct ColumnarColumn {
+    char name[64];          // NUL-terminated
+    uint32_t type;          // ColumnType
+    uint8_t codec;          // ColumnCodec, None in version 1
+    uint8_t encoding;       // ColumnEncoding, None unless compressed
+    uint16_t reserved;
+    uint64_t data_offset;
+};
+static_assert(sizeof(ColumnarColumn) == 80, "ColumnarColumn layout is part of the file format");
+
+// Start of a compressed column's payload
+struct ColumnarChunk {
+    uint64_t stored_bytes;  // codec output that follows
+    uint64_t raw_bytes;     // row_count * element size once expanded
+};
+static_assert(sizeof(ColumnarChunk) == 16, "ColumnarChunk layout is part of the file format");
+
+// Read-only view of a .mftc file. The file is held in a MappedFile and
+// column accessors point straight into it. A compressed column is expanded
+// into a buffer of the view the first time it is accessed, or ahead of that
+// by decompress(), so only the columns a reader asks for are decompressed.
+// Accessors may be called from several threads at once.
+class ColumnarFile {
+public:
+    // Throws std::runtime_error if the file cannot be opened or is malformed
+    explicit ColumnarFile(const std::string& filepath);
+    // View of a .mftc image already in memory (a shared-memory segment), which
+    // must outlive the view; `source` names it in errors. Throws
+    // std::runtime_error if the image is malformed.
+    ColumnarFile(const void* data, size_t size, const std::string& source);
+    ~ColumnarFile();
+    ColumnarFile(const ColumnarFile&) = delete;
+    ColumnarFile& operator=(const ColumnarFile&) = delete;
+
+    const std::string& symbol() const { return symbol_; }
+    const std::string& data_frequency() const { return data_frequency_; }
+    size_t rows() const { return rows_; }
+    size_t column_count() const { return columns_.size(); }
+
+    const char* column_name(size_t index) const { return columns_[index]->name; }
+    ColumnType column_type(size_t index) const { return static_cast<ColumnType>(columns_[index]->type); }
+    ColumnCodec column_codec(size_t index) const { return static_cast<ColumnCodec>(columns_[index]->codec); }
+
+    // Float64 column by position or name; nullptr if absent or of another type
+    const double* values(size_t index) const;
+    const double* find(const std::string& name) const;
+    // Float32 column by position or name; nullptr if absent or of another type
+    const float* values_f32(size_t index) const;
+    const float* find_f32(const std::string& name) const;
+    // The datetime column, nullptr if absent
+    const int64_t* timestamps() const;
+    // The accessors above throw std::runtime_error for a compressed column
+    // that is corrupt or whose codec this build lacks
+
+    // Expands the named compressed columns still pending, one task per
+    // column on up to `threads` threads (0 = hardware_concurrency()).
+    // Unknown names and stored columns are skipped; an empty list means every
+    // column. Throws std::runtime_error as the accessors.
+    void decompress(const std::vector<std::string>& names = {}, unsigned threads = 0) const;
+
+    // True when `filepath` has the .mftc extension
+    static bool is_columnar_path(const std::string& filepath);
+
+private:
+    struct Expanded;
+
+    void parse(const std::string& source);
+    // Start of a column's values, expanding it first if compressed
+    const uint8_t* column_data(size_t index) const;
+    size_t element_size(size_t index) const;
+
+    std::unique_ptr<MappedFile> file_;      // null for an in-memory image
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    std::string source_;
+
+    size_t rows_ = 0;
+    std::string symbol_;
+    std::string data_frequency_;
+    std::vector<const ColumnarColumn*> columns_;
+    std::vector<std::unique_ptr<Expanded>> expanded_;   // per column, null unless compressed
+};
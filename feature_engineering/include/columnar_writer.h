@@ -0,0 +1,124 @@
+#pragma once
+
+#include "ohlcv_data.h"
+#include "feature_selection.h"
+#include "feature_block.h"
+#include "columnar_format.h"
+#include "column_codec.h"
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+class AsyncFileIO;
+
+struct ColumnarWriteOptions {
+    // Codec of every column; a column that does not shrink is stored as is.
+    // With ColumnCodec::None the file is a plain version 1 image.
+    ColumnarCompression compression;
+    // Hand the finished image to this AsyncFileIO instead of writing it in
+    // place (see CSVWriteOptions::async_io)
+    AsyncFileIO* async_io = nullptr;
+};
+
+// Writes the same columns as FastCSVWriter in the binary .mftc layout
+// described in columnar_format.h, skipping text formatting entirely.
+class ColumnarWriter {
+public:
+    static void write_ohlcv_with_features(
+        const std::string& filepath,
+        const OHLCVData& ohlcv_data,
+        const FeatureSet& features,
+        const std::string& data_frequency = "daily",
+        const FeatureMask& columns = all_features(),
+        const ColumnarWriteOptions& options = ColumnarWriteOptions()
+    );
+
+    static void write_ohlcv_with_features(
+        const std::string& filepath,
+        const OHLCVData& ohlcv_data,
+        const FeatureBlock& block,
+        const std::string& data_frequency = "daily",
+        const FeatureMask& columns = all_features(),
+        const ColumnarWriteOptions& options = ColumnarWriteOptions()
+    );
+
+    // Returns `bytes` zeroed bytes, 64-byte aligned, to lay an image out in
+    using Allocator = std::function<uint8_t*(size_t bytes)>;
+
+    // Lay the same .mftc image out in memory from `allocate` instead of a
+    // file; SharedFeaturePublisher builds straight into its segment this way
+    static void build_image(
+        const OHLCVData& ohlcv_data,
+        const FeatureSet& features,
+        const std::string& data_frequency,
+        const FeatureMask& columns,
+        const Allocator& allocate
+    );
+
+    static void build_image(
+        const OHLCVData& ohlcv_data,
+        const FeatureBlock& block,
+        const std::string& data_frequency,
+        const FeatureMask& columns,
+        const Allocator& allocate
+    );
+
+private:
+    struct Column;
+
+    static Column column(Feature feature, const std::vector<double>& values);
+    static Column column(Feature feature, const std::vector<int>& values);
+    static std::vector<Column> select(const FeatureSet& features, const FeatureMask& columns);
+    static std::vector<Column> select(const FeatureBlock& block, const FeatureMask& columns);
+
+    static void write_columns(
+        const std::string& filepath,
+        const OHLCVData& ohlcv_data,
+        const std::string& data_frequency,
+        const std::vector<Column>& columns,
+        const ColumnarWriteOptions& options
+    );
+
+    static void build(
+        const OHLCVData& ohlcv_data,
+        const std::string& data_frequency,
+        const std::vector<Column>& columns,
+        const Allocator& allocate
+    );
+};
+
+// .mftc output of a series written chunk by chunk (bounded-memory mode). The
+// layout is fixed up front for `capacity` rows, an upper bound such as
+// FastCSVReader::ChunkReader::count_rows(); append() writes each chunk's rows
+// into every column in place and finish() records the row count, so the file
+// is only valid once finish() returned. Float32 precision stores float32
+// feature columns, as a Float32 FeatureBlock does.
+class ColumnarAppender {
+public:
+    // Creates the file; throws std::runtime_error on failure
+    ColumnarAppender(const std::string& filepath, const std::string& symbol, const std::string& data_frequency,
+                     const FeatureMask& columns, FeaturePrecision precision, size_t capacity);
+
+    // Chunk layout as FastCSVWriter::append_ohlcv_with_features; chunks come
+    // in row order. Throws std::runtime_error past `capacity` rows.
+    void append(const OHLCVData& chunk, size_t first_row, const FeatureSet& features,
+                const std::array<size_t, kFeatureCount>& column_rows);
+    // Writes the header with the rows appended; throws std::runtime_error
+    void finish();
+
+private:
+    void write_at(uint64_t offset, const void* data, size_t bytes);
+
+    std::string path_;
+    std::ofstream file_;
+    ColumnarHeader header_{};
+    FeatureMask columns_;
+    FeaturePrecision precision_;
+    size_t capacity_;
+    size_t rows_ = 0;
+    std::vector<uint64_t> offsets_;     // data offset per column, CSV order
+    std::vector<uint8_t> scratch_;      // one column of a chunk
+};
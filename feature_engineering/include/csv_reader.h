@@ -1,7 +1,10 @@
 #pragma once
 
 #include "ohlcv_data.h"
+#include "mapped_file.h"
+#include "timestamp_decoder.h"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <chrono>
@@ -11,10 +14,44 @@ public:
     // Reads a single CSV file into an OHLCVData structure.
     static std::unique_ptr<OHLCVData> read_csv_file(const std::string& filepath);
 
-    // Reads all CSV files in a directory.
-    static std::vector<std::unique_ptr<OHLCVData>> read_directory(const std::string& directory);
+    // Parses a whole CSV file already in memory, as read_csv_file does
+    static std::unique_ptr<OHLCVData> parse_csv(const char* data, size_t size);
+
+    // Reads all CSV files in a directory, up to `io_depth` at a time through
+    // AsyncFileIO (0 maps each file in turn instead).
+    static std::vector<std::unique_ptr<OHLCVData>> read_directory(const std::string& directory, unsigned io_depth = 32);
+
+    // Reads a file as read_csv_file does, but a chunk of rows at a time into
+    // a reused OHLCVData, so a series larger than memory can be processed
+    // front to back. Pages already parsed are released behind the reader.
+    class ChunkReader {
+    public:
+        // Throws std::runtime_error if the file cannot be opened
+        explicit ChunkReader(const std::string& filepath);
+
+        // Lines after the header, an upper bound on the rows (one scan of the file)
+        size_t count_rows() const;
+        // Replaces the rows of `chunk` with the next `rows` rows (fewer at the
+        // end of the file); false once the file is exhausted
+        bool next(OHLCVData& chunk, size_t rows);
+
+    private:
+        MappedFile file_;
+        const char* pos_ = nullptr;
+        const char* end_ = nullptr;
+        TimestampDecoder decoder_;
+        std::vector<std::string_view> datetimes_;
+        std::string last_;
+    };
 
 private:
+    // Parses lines from `ptr` until `max_rows` rows were added to `data` or
+    // `end` is reached, and returns where it stopped. Datetime fields are
+    // collected in `datetimes`; an unterminated last line is parsed from a
+    // copy in `last`, which must outlive them.
+    static const char* parse_rows(const char* ptr, const char* end, size_t max_rows, OHLCVData& data,
+                                  std::vector<std::string_view>& datetimes, std::string& last);
+
     // A faster, non-locale-dependent string-to-double converter.
     static double fast_atof(const char* str, const char** endptr);
 
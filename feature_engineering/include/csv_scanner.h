@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+
+// Byte scanning for CSV parsing: AVX2 compares 32 bytes per step, NEON 16,
+// with a scalar tail and fallback.
+class CSVScanner {
+public:
+    // First '\n' or '\r' in [p, end), or end
+    static const char* find_line_end(const char* p, const char* end);
+
+    // Number of '\n' bytes in [p, end)
+    static size_t count_lines(const char* p, const char* end);
+
+    // Stores the positions of the first `max` `delimiter` bytes in [p, end)
+    // into `out` and returns how many were found
+    static size_t find_delimiters(const char* p, const char* end, char delimiter,
+                                  const char** out, size_t max);
+
+    // Parses [ \t]*[+-]?digits[.digits] at p and sets *endptr past it; the
+    // number parser of both the feature and the arbitrage CSV loaders. Up to
+    // 19 significant digits are read exactly and scaled once, so prices
+    // round the same way as strtod.
+    static double parse_decimal(const char* p, const char** endptr);
+};
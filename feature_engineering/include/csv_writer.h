@@ -2,21 +2,114 @@
 
 #include "ohlcv_data.h"
 #include "batch_ohlc_processor.h" // For FeatureSet
+#include "feature_selection.h"
+#include "feature_block.h"
+#include <array>
+#include <vector>
 #include <string>
+#include <chrono>
+
+class AsyncFileIO;
+
+// Tuning for large outputs. Files over `parallel_min_rows` rows are cut into
+// `chunk_rows` row ranges that are formatted on several threads and written
+// back in order.
+struct CSVWriteOptions {
+    size_t parallel_min_rows = 200000;
+    size_t chunk_rows = 65536;
+    unsigned max_threads = 0;   // 0 = hardware_concurrency()
+    bool direct_io = false;     // Linux: O_DIRECT + pwrite, bypassing the page cache
+    // Hand each whole file to this AsyncFileIO and return once it is
+    // submitted; its failures surface through take_write_errors(). Appends
+    // and direct_io writes stay synchronous.
+    AsyncFileIO* async_io = nullptr;
+    // Per-thread formatting buffers keep up to this many bytes of capacity
+    // between files; past it they are released after the write, so one huge
+    // file does not pin its buffers for the life of the thread
+    size_t retained_buffer_bytes = size_t(16) << 20;
+};
 
 class FastCSVWriter {
 public:
-    // Writes the original OHLCV data along with all calculated features to a single wide-format CSV file.
+    // Writes the original OHLCV data along with the selected features to a single wide-format CSV file.
     static void write_ohlcv_with_features(
         const std::string& filepath,
         const OHLCVData& ohlcv_data,
         const FeatureSet& features,
-        const std::string& data_frequency = "daily"
+        const std::string& data_frequency = "daily",
+        const FeatureMask& columns = all_features(),
+        const CSVWriteOptions& options = CSVWriteOptions()
+    );
+
+    // Same layout, reading the columns of a FeatureBlock
+    static void write_ohlcv_with_features(
+        const std::string& filepath,
+        const OHLCVData& ohlcv_data,
+        const FeatureBlock& block,
+        const std::string& data_frequency = "daily",
+        const FeatureMask& columns = all_features(),
+        const CSVWriteOptions& options = CSVWriteOptions()
+    );
+
+    // A series written chunk by chunk: `chunk` holds rows first_row ..
+    // first_row + chunk.size() - 1, and the values of each feature column in
+    // `features` start at row column_rows[feature] (values for rows before
+    // first_row are skipped). The chunk at first_row 0 creates the file with
+    // its header; later chunks are appended, through the page cache even
+    // with direct_io.
+    static void append_ohlcv_with_features(
+        const std::string& filepath,
+        const OHLCVData& chunk,
+        size_t first_row,
+        const FeatureSet& features,
+        const std::array<size_t, kFeatureCount>& column_rows,
+        const std::string& data_frequency,
+        const FeatureMask& columns,
+        const CSVWriteOptions& options = CSVWriteOptions()
+    );
+
+    // One column of write_named_columns(): values for rows offset .. offset + length - 1
+    struct NamedColumn {
+        std::string name;
+        const double* values;
+        size_t length;
+        size_t offset;
+    };
+
+    // "datetime,symbol,<names...>" rows for tables outside FeatureSet, e.g.
+    // the panel features; cells outside a column's rows are left empty
+    static void write_named_columns(
+        const std::string& filepath,
+        const std::string& symbol,
+        const std::vector<std::chrono::system_clock::time_point>& timestamps,
+        const std::vector<NamedColumn>& columns,
+        const CSVWriteOptions& options = CSVWriteOptions()
+    );
+
+    // The same rows appended to an existing file without a header, or
+    // starting it when `create` is set
+    static void append_named_columns(
+        const std::string& filepath,
+        const std::string& symbol,
+        const std::vector<std::chrono::system_clock::time_point>& timestamps,
+        const std::vector<NamedColumn>& columns,
+        bool create,
+        const CSVWriteOptions& options = CSVWriteOptions()
     );
 
 private:
-    static std::string format_datetime(const std::chrono::system_clock::time_point& tp);
-    static std::string format_double(double value, int precision = 6);
-    static std::string safe_get_value(const std::vector<double>& vec, size_t index, size_t offset = 0);
-    static std::string safe_get_int_value(const std::vector<int>& vec, size_t index, size_t offset = 0);
-};
\ No newline at end of file
+    struct ColumnView;
+
+    static ColumnView column_view(Feature feature, const std::vector<double>& values, size_t offset);
+    static ColumnView column_view(Feature feature, const std::vector<int>& values, size_t offset);
+    // With `append`, the rows go after the end of an existing file and no header is written
+    static void write_columns(const std::string& filepath, const OHLCVData& ohlcv_data,
+                              const std::string& data_frequency, const std::vector<ColumnView>& columns,
+                              const CSVWriteOptions& options, bool append = false);
+    // Appends rows [begin, end) to `out`
+    static void format_rows(std::string& out, const OHLCVData& ohlcv_data, const std::string& data_frequency,
+                            const std::vector<ColumnView>& columns, size_t begin, size_t end);
+    // Writes the parts in order; they may be moved from
+    static void write_parts(const std::string& filepath, std::string* parts, size_t count,
+                            const CSVWriteOptions& options, bool append = false);
+};
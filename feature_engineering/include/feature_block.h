@@ -0,0 +1,67 @@
+#pragma once
+
+#include "ohlcv_data.h"
+#include "feature_selection.h"
+#include "memory_accounting.h"
+#include <vector>
+#include <array>
+#include <cstddef>
+
+// Columnar feature storage for one series: a single 64-byte aligned
+// allocation holding every Feature column back to back. Each column has a
+// row stride padded to a whole cache line, so every column start is aligned
+// for AVX2/NEON loads. reset() only reallocates when a longer series arrives,
+// so a block kept per worker thread is reused across stocks without
+// allocator traffic.
+//
+// A Float32 block stores every column as float: half the footprint and write
+// bandwidth, and twice the SIMD lanes for kernels that fill it directly.
+enum class FeaturePrecision { Float64, Float32 };
+
+class FeatureBlock {
+public:
+    static constexpr size_t kAlignment = 64;
+
+    explicit FeatureBlock(FeaturePrecision precision = FeaturePrecision::Float64) : precision_(precision) {}
+    ~FeatureBlock();
+    FeatureBlock(const FeatureBlock&) = delete;
+    FeatureBlock& operator=(const FeatureBlock&) = delete;
+
+    // Prepares room for `rows` values per column and marks every column empty
+    void reset(size_t rows);
+
+    size_t rows() const { return rows_; }
+    size_t stride() const { return stride_; }
+    size_t capacity_bytes() const { return capacity_; }
+    FeaturePrecision precision() const { return precision_; }
+
+    // Writable span of `rows()` values; call set_length() after filling it.
+    // column() is nullptr on a Float32 block and column_f32() on a Float64 one.
+    double* column(Feature feature);
+    const double* column(Feature feature) const;
+    float* column_f32(Feature feature);
+    const float* column_f32(Feature feature) const;
+    size_t length(Feature feature) const { return lengths_[static_cast<size_t>(feature)]; }
+    void set_length(Feature feature, size_t length);
+
+    // Copies computed values into the column (truncated to rows()), narrowing
+    // to float on a Float32 block
+    void assign(Feature feature, const double* values, size_t length);
+    void assign(Feature feature, const std::vector<double>& values);
+    void assign(Feature feature, const std::vector<int>& values);
+
+    // Copies the block into the vector-based FeatureSet layout (float columns widened)
+    FeatureSet to_feature_set() const;
+
+private:
+    size_t offset(Feature feature) const { return static_cast<size_t>(feature) * stride_; }
+    size_t element_size() const { return precision_ == FeaturePrecision::Float32 ? sizeof(float) : sizeof(double); }
+
+    FeaturePrecision precision_;
+    void* data_ = nullptr;
+    size_t capacity_ = 0;   // bytes allocated
+    MemoryCharge memory_;   // capacity_, in the Features subsystem
+    size_t rows_ = 0;
+    size_t stride_ = 0;     // elements per column, padded to a cache line
+    std::array<size_t, kFeatureCount> lengths_{};
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <utility>
+#include "garch_model.h"
+#include "regime_model.h"
+
+// Shared intermediates consumed by several features. Each node is computed at
+// most once per series, on first request, and may pull its own dependencies
+// from the same graph (e.g. RollingVolatility20 and GarchVolatility21 both
+// read Returns).
+enum class FeatureNode : size_t {
+    Returns,
+    RollingVolatility20,    // sample stddev of Returns over 20 bars
+    Sma20,
+    VolumeSma20,
+    CloseEma15,             // TRIX cascade: EMA15(close), EMA15(EMA15), ...
+    CloseEma15x2,
+    CloseEma15x3,
+    GarchVolatility21,
+    GarchFilteredVolatility,  // single-pass GarchModel filter of Returns
+    RegimeProbabilities2,     // RegimeModel::filter of Returns, 2 states, state-major
+    RegimeProbabilities3,     // ... 3 states
+    Vwap,
+    Rsi14,
+    Kama10_2_30,
+    Kama20_10_30,
+    Klinger34_55,           // EMA34 - EMA55 of trend-signed volume
+    Count
+};
+
+// AVX2 selects SIMDTechnicalIndicators, which runs the AVX2 or AVX-512 kernels
+enum class ComputeBackend { Scalar, AVX2, NEON };
+
+class FeatureGraph {
+public:
+    FeatureGraph(const std::vector<double>& high, const std::vector<double>& low,
+                 const std::vector<double>& close, const std::vector<double>& volume,
+                 ComputeBackend backend = ComputeBackend::Scalar);
+
+    template <FeatureNode N>
+    const std::vector<double>& get() {
+        static_assert(N != FeatureNode::Count, "FeatureNode::Count is not a node");
+        constexpr size_t id = static_cast<size_t>(N);
+        if (!computed_[id]) {
+            values_[id] = compute(N);
+            computed_[id] = true;
+        }
+        return values_[id];
+    }
+
+    // Seeds a node computed elsewhere, e.g. by the cross-series lane kernels
+    void provide(FeatureNode node, std::vector<double> values) {
+        const size_t id = static_cast<size_t>(node);
+        values_[id] = std::move(values);
+        computed_[id] = true;
+    }
+
+    // Parameters for GarchFilteredVolatility; default_params() of the series otherwise
+    void set_garch_params(const GarchParams& params) {
+        garch_params_ = params;
+        has_garch_params_ = true;
+    }
+
+    // Models for the RegimeProbabilities nodes; default_params() of the series otherwise
+    void set_regime_params(const RegimeFeatureParams& params) {
+        regime_params_ = params;
+        has_regime_params_ = true;
+    }
+
+    ComputeBackend backend() const { return backend_; }
+
+private:
+    static constexpr size_t kNodeCount = static_cast<size_t>(FeatureNode::Count);
+
+    std::vector<double> compute(FeatureNode node);
+
+    const std::vector<double>& high_;
+    const std::vector<double>& low_;
+    const std::vector<double>& close_;
+    const std::vector<double>& volume_;
+    ComputeBackend backend_;
+    std::array<std::vector<double>, kNodeCount> values_;
+    std::bitset<kNodeCount> computed_;
+    GarchParams garch_params_{};
+    bool has_garch_params_ = false;
+    RegimeFeatureParams regime_params_{};
+    bool has_regime_params_ = false;
+};
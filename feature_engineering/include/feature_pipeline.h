@@ -0,0 +1,142 @@
+#pragma once
+#include "bar_resampler.h"
+#include "feature_selection.h"
+#include "work_stealing_pool.h"
+#include "csv_writer.h"
+#include "columnar_writer.h"
+#include "panel_engine.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Output files written per stock: <symbol>_features.csv and/or .mftc
+enum class OutputFormat {
+    Csv,
+    Columnar,
+    Both,
+};
+
+// Thread counts per stage and the depth of the queues between them
+struct PipelineConfig {
+    unsigned read_threads = 2;
+    unsigned compute_threads = 0;   // 0 = tuned_threads() (machine_profile.h)
+    unsigned write_threads = 2;
+    size_t queue_depth = 64;        // series in flight per queue
+    // Files in flight per read and per write thread through AsyncFileIO
+    // (io_uring on Linux); 0 maps each input file and writes each output in
+    // turn. A writer hands its files over once formatted and holds up to
+    // this many until they are on their way to disk.
+    unsigned io_depth = 32;
+    std::string data_frequency = "daily";
+    OutputFormat format = OutputFormat::Csv;
+    CSVWriteOptions csv;
+    // .mftc column compression; the chunked (memory_budget) and shared
+    // segment images stay uncompressed
+    ColumnarWriteOptions columnar;
+    FeaturePrecision precision = FeaturePrecision::Float64;  // feature storage and .mftc column type
+    // Fused passes over the returns and bar chains (FusionPlan); same values either way
+    bool loop_fusion = true;
+    // Fit GARCH(1,1) per stock for the GARCH-filtered regime features instead
+    // of the defaults; fits are reused from and saved to garch_cache if set
+    bool fit_garch = false;
+    std::string garch_cache;
+    // Fit the 2- and 3-state regime HMMs per stock by Baum-Welch
+    // (RegimeModel::fit_features) instead of the warm-up defaults
+    bool fit_regimes = false;
+    // Panel stage after the per-stock features: cross-sectional columns over
+    // every stock (PanelEngine), written to <symbol>_panel.csv. Keeps each
+    // stock's timestamps and closes until the end of the run.
+    bool panel = false;
+    PanelConfig panel_config;
+    std::string panel_factors;      // optional factor returns CSV for PanelEngine::load_factors
+    // Also publish each stock's .mftc image to the shared-memory segment
+    // shared_segment_name(publish_prefix, symbol) for live viewers
+    std::string publish_prefix;
+    // Window sweep after the per-stock features: <indicator>_<window> columns
+    // for every window of the list (WindowSweep), written to <symbol>_windows.csv
+    WindowSweepSelection window_sweep;
+    // Bounded-memory mode, 0 = off. Series longer than plan_memory()'s
+    // series_rows skip the stages and are streamed from their files in
+    // chunks after them, one series per compute thread
+    // (process_series_in_chunks); the rest go through the stages as usual.
+    // The panel keeps every series whole and cannot be combined with it.
+    size_t memory_budget_mb = 0;
+    // Resampling before the features, off while resample.frequencies is
+    // empty: the compute stage builds every frequency from each source series
+    // in one pass (BarResampler) and computes and writes each one as
+    // <symbol>_<frequency>_features.csv/.mftc (and _windows.csv), with the
+    // frequency in place of data_frequency. Source files are parsed once and
+    // no resampled bars are written out on their own. Chunked series and the
+    // panel take the source bars as they are, so neither can be combined with it.
+    ResampleConfig resample;
+};
+
+// How a memory budget is split. The stages hold at most 2 * queue_depth
+// series plus one per worker, and each read and write thread up to io_depth
+// files in flight, so a series is taken whole when that many of its size fit
+// in the budget; longer ones are chunked, each compute thread
+// holding one chunk (its bars, three feature sets of every column, the text
+// or column buffers being written and the window sweep). Resident bytes per
+// row are estimated from the selected columns, precision and output format.
+// Neither count goes below kMinChunkRows, so a budget too small for that is
+// exceeded rather than honoured.
+struct MemoryPlan {
+    static constexpr size_t kMinChunkRows = 4096;
+    size_t series_rows = 0;         // longest series the stages take whole
+    size_t chunk_rows = 0;          // rows per chunk of a longer series
+};
+
+// Requires config.memory_budget_mb > 0
+MemoryPlan plan_memory(const PipelineConfig& config, const FeatureMask& selection);
+// Parses a size in megabytes, with an optional M or G suffix ("512", "48G");
+// throws std::runtime_error otherwise
+size_t parse_memory_size(const std::string& text);
+
+// Parses "csv", "mftc" (or "binary") and "both"; throws std::runtime_error otherwise
+OutputFormat parse_output_format(const std::string& name);
+// Parses "none", "lz4" and "zstd", optionally with ":<level>" ("zstd:19");
+// throws std::runtime_error otherwise or if the codec was not built in
+ColumnarCompression parse_columnar_compression(const std::string& text);
+// Parses "f64" and "f32"; throws std::runtime_error otherwise
+FeaturePrecision parse_feature_precision(const std::string& name);
+
+struct PipelineStats {
+    double wall_ms = 0.0;
+    size_t files_read = 0;
+    size_t read_errors = 0;
+    size_t stocks_written = 0;
+    size_t process_errors = 0;
+    size_t total_data_points = 0;
+    size_t garch_fitted = 0;        // with fit_garch: stocks fitted this run
+    size_t garch_cached = 0;        // ... and stocks whose fit came from the cache
+    size_t regimes_fitted = 0;      // with fit_regimes: stocks whose regime HMMs were fitted
+    size_t panel_written = 0;       // with panel: <symbol>_panel.csv files written
+    double panel_ms = 0.0;          // panel alignment, features and writes, after the stages
+    size_t sweep_written = 0;       // with window_sweep: <symbol>_windows.csv files written
+    size_t chunked_stocks = 0;      // with memory_budget_mb: series streamed in chunks
+    double chunked_ms = 0.0;        // ... and the time spent on them, after the stages
+    size_t resampled_series = 0;    // with resample: frequency series computed, one per file and frequency
+    // With io_depth: async_io_backend_name() of the stage threads' AsyncFileIO.
+    // A file that fails after it was handed over counts in process_errors,
+    // its stock staying in stocks_written.
+    std::string io_backend;
+
+    // Per-stage worker counters (steals are always 0: stages pull from queues)
+    PoolStats read;
+    PoolStats compute;
+    PoolStats write;
+
+    // Peak occupancy of the read->compute and compute->write queues
+    size_t parsed_queue_peak = 0;
+    size_t computed_queue_peak = 0;
+};
+
+// Streams every file through read -> compute -> write stages connected by
+// bounded queues, so a stock is written while others are still being parsed
+// and computed. At most about 2 * queue_depth series (plus one per worker)
+// are resident at any time; with memory_budget_mb, series too long for that
+// are chunked instead (plan_memory). Files are read largest first.
+PipelineStats run_feature_pipeline(const std::vector<std::string>& csv_files,
+                                   const std::string& output_dir,
+                                   const FeatureMask& selection,
+                                   const PipelineConfig& config);
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <bitset>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Every FeatureSet column as X(field, row_offset), in CSV column order.
+// row_offset is the input row that holds the column's first value.
+#define FEATURE_COLUMNS(X) \
+    X(returns, 1) \
+    X(sma, 19) \
+    X(rsi, 14) \
+    X(volatility, 20) \
+    X(momentum, 10) \
+    X(spread, 0) \
+    X(internal_bar_strength, 0) \
+    X(skewness_30, 29) \
+    X(kurtosis_30, 29) \
+    X(log_pct_change_5, 5) \
+    X(auto_correlation_50_10, 59) \
+    X(kama_10_2_30, 0) \
+    X(linear_slope_20, 19) \
+    X(linear_slope_60, 59) \
+    X(parkinson_volatility_20, 19) \
+    X(volume_sma_20, 19) \
+    X(velocity, 1) \
+    X(acceleration, 2) \
+    X(candle_way, 0) \
+    X(candle_filling, 0) \
+    X(candle_amplitude, 0) \
+    X(z_score_20, 19) \
+    X(percentile_rank_50, 49) \
+    X(coefficient_of_variation_30, 29) \
+    X(detrended_price_oscillator_20, 19) \
+    X(hurst_exponent_100, 99) \
+    X(garch_volatility_21, 20) \
+    X(shannon_entropy_volume_10, 9) \
+    X(chande_momentum_oscillator_14, 14) \
+    X(aroon_oscillator_25, 24) \
+    X(trix_15, 45) \
+    X(vortex_indicator_14, 14) \
+    X(supertrend_10_3, 9) \
+    X(ichimoku_senkou_span_A_9_26, 25) \
+    X(ichimoku_senkou_span_B_26_52, 51) \
+    X(fisher_transform_10, 9) \
+    X(volume_weighted_average_price_intraday, 0) \
+    X(volume_profile_high_volume_node_intraday, 0) \
+    X(volume_profile_low_volume_node_intraday, 0) \
+    X(on_balance_volume_sma_20, 20) \
+    X(klinger_oscillator_34_55, 55) \
+    X(money_flow_index_14, 14) \
+    X(vwap_deviation_stddev_30, 30) \
+    X(markov_regime_switching_garch_2_state, 1) \
+    X(adx_rating_14, 14) \
+    X(chow_test_statistic_breakpoint_detection_50, 100) \
+    X(market_regime_hmm_3_states_price_vol, 1) \
+    X(high_volatility_indicator_garch_threshold, 20) \
+    X(return_x_volume_interaction_10, 10) \
+    X(volatility_x_rsi_interaction_14, 0) \
+    X(price_to_kama_ratio_20_10_30, 0) \
+    X(polynomial_regression_price_degree_2_slope, 19) \
+    X(conditional_value_at_risk_cvar_95_20, 19) \
+    X(drawdown_duration_from_peak_50, 49) \
+    X(ulcer_index_14, 13) \
+    X(sortino_ratio_30, 29) \
+    X(hmm_regime_probability_low_vol, 1) \
+    X(hmm_regime_probability_mid_vol, 1) \
+    X(hmm_regime_probability_high_vol, 1)
+
+enum class Feature : size_t {
+#define FEATURE_ENUM_ENTRY(name, offset) name,
+    FEATURE_COLUMNS(FEATURE_ENUM_ENTRY)
+#undef FEATURE_ENUM_ENTRY
+    Count
+};
+
+constexpr size_t kFeatureCount = static_cast<size_t>(Feature::Count);
+
+// One bit per Feature; a set bit means compute and write that column
+using FeatureMask = std::bitset<kFeatureCount>;
+
+inline FeatureMask all_features() { return FeatureMask().set(); }
+
+inline bool is_selected(const FeatureMask& mask, Feature feature) {
+    return mask.test(static_cast<size_t>(feature));
+}
+
+const char* feature_name(Feature feature);
+size_t feature_row_offset(Feature feature);
+
+// Parses a comma-separated list of column names ("all" selects everything).
+// Throws std::runtime_error on unknown names.
+FeatureMask parse_feature_list(const std::string& list);
+std::vector<std::string> feature_names(const FeatureMask& mask = all_features());
+
+// Indicators of a window sweep as X(name, on_returns): each is written once
+// per window length w as <name>_<w>, over the closes or the returns
+#define WINDOW_SWEEP_INDICATORS(X) \
+    X(sma, false) \
+    X(volatility, true) \
+    X(z_score, true) \
+    X(linear_slope, false)
+
+enum class SweepIndicator : size_t {
+#define SWEEP_ENUM_ENTRY(name, on_returns) name,
+    WINDOW_SWEEP_INDICATORS(SWEEP_ENUM_ENTRY)
+#undef SWEEP_ENUM_ENTRY
+    Count
+};
+
+constexpr size_t kSweepIndicatorCount = static_cast<size_t>(SweepIndicator::Count);
+using SweepMask = std::bitset<kSweepIndicatorCount>;
+
+// Extra columns over a list of window lengths (WindowSweep); off while
+// `windows` is empty
+struct WindowSweepSelection {
+    std::vector<size_t> windows;
+    SweepMask indicators = SweepMask().set();
+
+    bool enabled() const { return !windows.empty() && indicators.any(); }
+};
+
+const char* sweep_indicator_name(SweepIndicator indicator);
+bool sweep_on_returns(SweepIndicator indicator);
+
+// Parses "5,10,20,60" into ascending, distinct window lengths of at least 2.
+// Throws std::runtime_error on anything else.
+std::vector<size_t> parse_window_list(const std::string& list);
+// Parses a comma-separated list of sweep indicator names ("all" selects
+// every one). Throws std::runtime_error on unknown names.
+SweepMask parse_sweep_indicators(const std::string& list);
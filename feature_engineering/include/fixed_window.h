@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+
+// Window kernels specialized on a compile-time window length, for the
+// indicators whose period is fixed by their column name (z_score_20,
+// ulcer_index_14, money_flow_index_14, vortex_indicator_14,
+// sortino_ratio_30). The per-window loops are fully unrolled over W, the
+// per-bar terms of the current windows sit in a stack buffer of W - 1 +
+// kLanes values instead of a heap vector, and kLanes neighbouring windows
+// are computed together so their sums are independent and vectorize.
+//
+// Every window is summed oldest bar first, so results match the runtime-window
+// TechnicalIndicators variants to round-off. Instantiated for the windows
+// those columns use (fixed_window.cpp); other windows take the runtime path.
+// Each function writes its count of values and returns it (0 if `n` is too
+// short), with the output layout of the TechnicalIndicators counterpart.
+// The kernels stay out of line: fast math lets every inlined copy round
+// differently, and a caller running a series in blocks (FusionPlan) must
+// reproduce a whole-series call bit for bit
+#ifdef _MSC_VER
+#define FIXED_WINDOW_KERNEL __declspec(noinline)
+#else
+#define FIXED_WINDOW_KERNEL __attribute__((noinline))
+#endif
+
+template <int W>
+struct FixedWindow {
+    static_assert(W >= 2, "a fixed window needs at least two bars");
+
+    // Windows computed side by side per step
+    static constexpr size_t kLanes = 8;
+
+    // (last - mean) / sample stddev of each window of `returns`; 0 when flat.
+    // n - W + 1 values.
+    FIXED_WINDOW_KERNEL static size_t z_score(const double* returns, size_t n, double* out);
+    // Window mean over the downside deviation (RMS of the negative returns);
+    // 0 without negative returns. n - W + 1 values.
+    FIXED_WINDOW_KERNEL static size_t sortino_ratio(const double* returns, size_t n, double* out);
+    // RMS percentage drawdown from the window maximum. n - W + 1 values.
+    FIXED_WINDOW_KERNEL static size_t ulcer_index(const double* prices, size_t n, double* out);
+    // Money flow index over W typical-price changes; 50 without money flow.
+    // n - W values.
+    FIXED_WINDOW_KERNEL static size_t money_flow_index(const double* high, const double* low, const double* close,
+                                   const double* volume, size_t n, double* out);
+    // VI+ over W bars: sum |high - previous low| / sum true range. n - W values.
+    FIXED_WINDOW_KERNEL static size_t vortex_indicator(const double* high, const double* low, const double* close,
+                                   size_t n, double* out);
+};
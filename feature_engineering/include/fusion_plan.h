@@ -0,0 +1,60 @@
+#pragma once
+
+#include "feature_block.h"
+#include "feature_graph.h"
+#include "feature_selection.h"
+#include <vector>
+#include <cstddef>
+
+struct SimdKernels;
+
+// Loop fusion for the indicator chains that read the same inputs. Run one
+// after another, each column makes its own pass over the whole series and
+// long series are bound by memory bandwidth. The plan walks the series once
+// in blocks of kBlockRows rows instead, and runs every fused column over a
+// block while its inputs are still in L2:
+//
+//   returns chain  returns, volatility, z_score_20 and sortino_ratio_30 over
+//                  the block's returns, computed once
+//   bar chain      vortex_indicator_14, adx_rating_14 and money_flow_index_14
+//                  over the block's bars, sharing the per-bar true range
+//                  (vortex and ADX) on the vector kernels
+//
+// Columns are bit-identical to the unfused path of the same backend. Only
+// kernels whose values do not depend on where a call starts take part, and
+// each column is cut where its kernel groups rows anyway (SIMD lanes,
+// FixedWindow::kLanes windows, RollingStatistics::kBlockRows), so every
+// value comes out of the same instructions. Supertrend's carried true-range
+// sum, the order-statistic windows (CVaR, percentile rank) and the recursive
+// filters (graph nodes) stay unfused, as does the NEON backend, whose
+// returns and volatility have their own kernels.
+class FusionPlan {
+public:
+    // Rows per block: a multiple of every cut above, and the bar chain's
+    // scratch terms stay well within L2
+    static constexpr size_t kBlockRows = 4096;
+
+    // Claims the selected columns the backend can fuse. Volatility stays with
+    // the graph while volatility_x_rsi_interaction_14 also reads it.
+    FusionPlan(const FeatureMask& selection, ComputeBackend backend);
+
+    bool empty() const { return columns_.none(); }
+    // Columns run() fills, which the caller skips
+    bool fuses(Feature feature) const { return columns_.test(static_cast<size_t>(feature)); }
+
+    // Fills the fused columns of `block` (already reset to n rows). When the
+    // returns chain runs, `returns` receives every return for the graph's
+    // Returns node; otherwise it is left empty.
+    void run(const double* high, const double* low, const double* close, const double* volume, size_t n,
+             FeatureBlock& block, std::vector<double>& returns) const;
+
+private:
+    void run_returns_chain(const double* close, size_t n, FeatureBlock& block, std::vector<double>& returns) const;
+    void run_bar_chain(const double* high, const double* low, const double* close, const double* volume, size_t n,
+                       FeatureBlock& block) const;
+
+    FeatureMask columns_;
+    const SimdKernels* kernels_ = nullptr;  // nullptr: scalar reference kernels
+    bool returns_chain_ = false;
+    bool bar_chain_ = false;
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <cstddef>
+
+struct GarchParams {
+    double omega;
+    double alpha;
+    double beta;
+};
+
+// GARCH(1,1) on one return series, run as a single recursive pass: the
+// variance is seeded with the mean squared return of the first kWarmup
+// returns and then updated once per return,
+//   h = omega + alpha * r^2 + beta * h,
+// so every value is the one-step-ahead variance given the returns so far.
+class GarchModel {
+public:
+    static constexpr size_t kWarmup = 20;
+    static constexpr double kDefaultAlpha = 0.1;
+    static constexpr double kDefaultBeta = 0.85;
+
+    // kDefaultAlpha / kDefaultBeta with omega targeting the warm-up variance
+    static GarchParams default_params(const double* returns, size_t n);
+
+    // sqrt(h) after returns [0, kWarmup - 1 + k]: n - kWarmup + 1 values, 0 if n < kWarmup
+    static size_t filtered_volatility(const double* returns, size_t n, const GarchParams& params, double* out);
+
+    // Gaussian maximum likelihood over an (alpha, beta) grid with variance
+    // targeting, then a finer grid around the best point. Candidates run
+    // SIMD-lane-wide on the active kernel table. Series shorter than
+    // kMinFitReturns get default_params().
+    static constexpr size_t kMinFitReturns = 100;
+    static GarchParams fit(const std::vector<double>& returns);
+    // fit() for every series, in parallel across series
+    static std::vector<GarchParams> fit_batch(const std::vector<std::vector<double>>& returns);
+};
+
+// Fitted parameters keyed by symbol, kept across runs in a small CSV file
+// (symbol,rows,omega,alpha,beta). An entry is reused only while the series
+// still has the row count it was fitted on. Thread-safe.
+class GarchParamCache {
+public:
+    // Missing file = empty cache; malformed lines are skipped
+    void load(const std::string& path);
+    // Throws std::runtime_error if the file cannot be written
+    void save(const std::string& path) const;
+
+    bool find(const std::string& symbol, size_t rows, GarchParams& params) const;
+    void store(const std::string& symbol, size_t rows, const GarchParams& params);
+    size_t size() const;
+
+private:
+    struct Entry {
+        size_t rows;
+        GarchParams params;
+    };
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Hardware performance counters for kernels and pipeline stages, read
+// through perf_event on Linux. Other platforms (macOS kperf needs a private
+// framework and root) report supported() false and every scope is a no-op.
+struct CounterValues {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cache_misses = 0;          // last-level cache misses
+    uint64_t branch_misses = 0;
+    uint64_t vector_instructions = 0;   // packed FP instructions; 0 where the CPU has no known event
+    double wall_ms = 0.0;
+
+    double ipc() const { return cycles ? static_cast<double>(instructions) / cycles : 0.0; }
+    // Last-level misses per thousand instructions
+    double misses_per_kilo_instruction() const {
+        return instructions ? 1000.0 * static_cast<double>(cache_misses) / instructions : 0.0;
+    }
+
+    CounterValues& operator+=(const CounterValues& other);
+    CounterValues operator-(const CounterValues& other) const;
+};
+
+// One group of counters on the calling thread. With include_new_threads the
+// threads it starts afterwards are counted too, their counts folded in as
+// they exit, so a scope around a pool run sees every worker.
+class HardwareCounters {
+public:
+    explicit HardwareCounters(bool include_new_threads = true);
+    ~HardwareCounters();
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+    // At least cycles and instructions could be opened
+    bool valid() const { return fds_[0] >= 0 && fds_[1] >= 0; }
+
+    // Zeroes and enables the counters
+    void start();
+    // Counts since start(), scaled up when the kernel multiplexed them
+    CounterValues read() const;
+
+    // perf_event is usable in this process (probed once)
+    static bool supported();
+    // Whether this CPU has a packed-FP event for vector_instructions;
+    // MFT_PERF_VECTOR_EVENT (a raw event code in hex) overrides the built-in one
+    static bool vector_event_supported();
+
+private:
+    static constexpr size_t kCounters = 5;
+    int fds_[kCounters];
+    uint64_t start_ns_ = 0;
+};
+
+// Runtime switch for the scopes below, off by default; when enabled without
+// perf_event support they record nothing and the report says so
+void set_hardware_counters(bool enabled);
+bool hardware_counters_enabled();
+
+// Adds `values` to the report under `label` (thread-safe)
+void record_counters(const std::string& label, const CounterValues& values);
+
+struct CounterRecord {
+    std::string label;
+    CounterValues values;
+    size_t samples = 0;
+};
+// Labels in first-recorded order
+std::vector<CounterRecord> counter_report();
+void reset_counter_report();
+// Prints one line per label: cycles, instructions, IPC, LLC misses per
+// thousand instructions, branch misses and vector instructions
+void print_counter_report(const char* title);
+
+// Counts a scope, including threads it starts, and records it under
+// `label` when it ends; does nothing unless counters are enabled
+class ScopedCounters {
+public:
+    explicit ScopedCounters(std::string label);
+    ~ScopedCounters();
+    ScopedCounters(const ScopedCounters&) = delete;
+    ScopedCounters& operator=(const ScopedCounters&) = delete;
+
+private:
+    std::string label_;
+    std::unique_ptr<HardwareCounters> counters_;
+};
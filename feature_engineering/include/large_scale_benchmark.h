@@ -1,4 +0,0 @@
-#pragma once
-
-// Function to run large scale benchmark with massive datasets
-void run_large_scale_benchmark();
@@ -0,0 +1,229 @@
+#pragma once
+#include "lock_free_ring.h"
+#include "ohlcv_data.h"
+#include "rolling_moments.h"
+#include "streaming_feature_engine.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Live ingestion front-end: market data handler threads submit trades and
+// quotes, each symbol's shard aggregates them into bars on a consumer
+// thread of its own, and every completed bar goes through the symbol's
+// StreamingFeatureEngine and is handed to a publish callback.
+//
+//   handler threads --submit()--> ring per shard --> consumer thread (pinned)
+//                                                     BarBuilder -> StreamingFeatureEngine
+//                                                     LiveMicrostructure -> publish
+//
+// Nothing on the path takes a lock or allocates once a symbol's engine has
+// warmed up. A symbol always maps to the same shard, so its ticks are
+// consumed in submit order by a single thread and its state is never shared.
+
+enum class TickKind : uint8_t {
+    Trade,
+    Quote,
+};
+
+struct MarketTick {
+    uint32_t symbol = 0;            // LiveIngestEngine::add_symbol id
+    TickKind kind = TickKind::Trade;
+    int64_t time_ns = 0;            // exchange time, ns since the epoch; assigns the bar
+    double price = 0.0;             // trade
+    double size = 0.0;
+    double bid = 0.0;               // quote
+    double ask = 0.0;
+    uint64_t arrival_ns = 0;        // steady clock, stamped by LiveIngestEngine::submit
+};
+
+// One bar of trades, plus the per-bar inputs of the microstructure features
+struct LiveBar {
+    int64_t start_ns = 0;
+    double open = 0.0, high = 0.0, low = 0.0, close = 0.0, volume = 0.0;
+    size_t trades = 0;
+    // Tick rule: a trade above the previous trade's price is an uptick, one
+    // below a downtick, and one at the same price keeps the last direction
+    double uptick_volume = 0.0;
+    double downtick_volume = 0.0;
+    // Mean quoted spread (ask - bid) of the quotes in the bar, or the
+    // prevailing one if none arrived; NaN before the first quote
+    double spread = 0.0;
+    // Volume-weighted 2 * |price - mid| / mid of the trades against the
+    // prevailing quote; NaN when no trade had one
+    double effective_spread = 0.0;
+
+    // Appends the bar as one row (timestamp = start)
+    void append_to(OHLCVData& data) const;
+};
+
+// Aggregates one symbol's ticks into bars of `bar_ns`, aligned to multiples
+// of it since the epoch. A bar is complete when the first tick of a later
+// bar arrives (or at flush()); bars without trades are not emitted.
+class BarBuilder {
+public:
+    explicit BarBuilder(int64_t bar_ns);
+
+    // Adds a tick; true, with the previous bar in `completed`, when the tick
+    // starts a new bar after one that had trades
+    bool add(const MarketTick& tick, LiveBar& completed);
+    // Completes the open bar; false if it has no trades
+    bool flush(LiveBar& completed);
+
+private:
+    void finish(LiveBar& completed);
+
+    int64_t bar_ns_;
+    LiveBar bar_;
+    bool open_ = false;             // bar_ has a start
+    bool traded_ = false;           // last_price_ is set
+    double last_price_ = 0.0;
+    int direction_ = 0;             // +1 uptick, -1 downtick, 0 until the price first moves
+    bool quoted_ = false;           // bid_ and ask_ are set
+    double bid_ = 0.0, ask_ = 0.0;  // prevailing quote
+    double spread_sum_ = 0.0;
+    size_t quotes_ = 0;
+    double effective_weighted_ = 0.0, effective_volume_ = 0.0;
+};
+
+// order_flow_imbalance_5, bid_ask_spread_volatility_10 and
+// effective_spread_5_min_avg over completed bars, as TechnicalIndicators
+// computes them over whole series: 5-bar mean of (up - down) / (up + down)
+// volume, 10-bar sample standard deviation of the bar spread and 5-bar mean
+// of the effective spread. NaN until a window is full, and a bar without a
+// spread value is skipped by that window.
+struct MicrostructureFeatures {
+    double order_flow_imbalance_5;
+    double bid_ask_spread_volatility_10;
+    double effective_spread_5_min_avg;
+};
+
+class LiveMicrostructure {
+public:
+    LiveMicrostructure();
+    void on_bar(const LiveBar& bar);
+    const MicrostructureFeatures& latest() const { return latest_; }
+
+private:
+    RollingMoments imbalance_, spread_, effective_spread_;
+    MicrostructureFeatures latest_;
+};
+
+// Latencies in ns, with four linear sub-buckets per power of two (25%
+// resolution). One thread records; any thread may read, and a read taken
+// while recording continues is a consistent-enough snapshot, not an exact one.
+class LatencyHistogram {
+public:
+    static constexpr size_t kBuckets = 256;
+
+    struct Summary {
+        uint64_t count = 0;
+        double p50_us = 0.0;        // upper bound of the bucket holding the percentile
+        double p90_us = 0.0;
+        double p99_us = 0.0;
+        double p999_us = 0.0;
+        double max_us = 0.0;
+        std::array<uint64_t, kBuckets> buckets{};
+    };
+
+    void record(uint64_t ns);
+    // Adds this histogram's counts to `summary.buckets` and raises its max;
+    // finish() then fills the percentiles
+    void merge_into(Summary& summary) const;
+    static void finish(Summary& summary);
+
+    static size_t bucket_of(uint64_t ns);
+    static uint64_t bucket_upper_ns(size_t bucket);
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> counts_{};
+    std::atomic<uint64_t> max_ns_{0};
+};
+
+// What a publish callback sees for one completed bar. `features` holds the
+// values this bar appended to each column: one per column once it has
+// warmed up, none before (and several at once where the engine appends a
+// warm-up, see StreamingFeatureEngine). The references are valid only
+// during the callback.
+struct LiveFeatureUpdate {
+    uint32_t symbol_id;
+    const std::string& symbol;
+    const LiveBar& bar;
+    const FeatureSet& features;
+    const MicrostructureFeatures& microstructure;
+    uint64_t bars;                  // completed bars of the symbol, this one included
+};
+
+// Runs on the shard's consumer thread; must not block it for long, since
+// the shard's ring fills meanwhile
+using LivePublish = std::function<void(const LiveFeatureUpdate&)>;
+
+struct LiveIngestConfig {
+    unsigned shards = 1;
+    size_t ring_capacity = 1 << 16;     // ticks per shard ring
+    // SPSC rings, for handlers that feed each shard from one thread only;
+    // otherwise MPSC rings take any number of submitting threads
+    bool single_producer = false;
+    int64_t bar_ns = 60'000'000'000;    // 1-minute bars
+    // Consumer s runs on consumer_cpus[s % size]; when empty, consumers are
+    // spread over the NUMA nodes' CPUs. Pinning is a no-op where the
+    // platform cannot pin (pin_thread_to_cpu).
+    bool pin_consumers = true;
+    std::vector<unsigned> consumer_cpus;
+};
+
+// Shards and their consumer threads. Symbols are added before start();
+// submit() may then be called from any thread (from one thread per shard
+// with single_producer) until stop().
+class LiveIngestEngine {
+public:
+    LiveIngestEngine(const LiveIngestConfig& config, LivePublish publish);
+    ~LiveIngestEngine();
+    LiveIngestEngine(const LiveIngestEngine&) = delete;
+    LiveIngestEngine& operator=(const LiveIngestEngine&) = delete;
+
+    // Returns the symbol's id for MarketTick::symbol; throws
+    // std::runtime_error once started
+    uint32_t add_symbol(const std::string& symbol);
+    size_t symbol_count() const { return symbols_.size(); }
+
+    void start();
+    // Stamps the tick's arrival and queues it on its symbol's shard; false,
+    // and the tick counted as dropped, when the ring is full or the symbol
+    // id is unknown. Never blocks.
+    bool submit(MarketTick tick);
+    // Lets the consumers drain their rings, completes every open bar
+    // (publishing it) and joins them; submit() must have stopped by then
+    void stop();
+
+    // Tick arrival (submit) to the publish callback being called, for the
+    // tick that completed each bar, merged over the shards
+    LatencyHistogram::Summary latency() const;
+    uint64_t ticks_consumed() const;
+    uint64_t ticks_dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t bars_published() const;
+
+private:
+    struct SymbolState;
+    struct Shard;
+
+    void consume(Shard& shard, unsigned index);
+    void on_tick(Shard& shard, const MarketTick& tick);
+    void publish(Shard& shard, SymbolState& state, const LiveBar& bar, uint64_t arrival_ns);
+    unsigned consumer_cpu(unsigned shard) const;
+
+    LiveIngestConfig config_;
+    LivePublish publish_;
+    std::vector<std::unique_ptr<SymbolState>> symbols_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::vector<std::thread> consumers_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+// Nanoseconds on the steady clock, the time base of MarketTick::arrival_ns
+uint64_t live_clock_ns();
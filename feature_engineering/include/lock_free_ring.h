@@ -0,0 +1,121 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Fixed-capacity lock-free rings for the live ingestion front-end
+// (LiveIngestEngine). Unlike BoundedQueue nothing blocks: try_push fails
+// while the ring is full and try_pop while it is empty, and the caller
+// decides whether to spin, back off or drop. The capacity is rounded up to a
+// power of two. Producer and consumer indices sit on cache lines of their
+// own so the two sides never write to the same line except through a slot.
+
+constexpr size_t kRingCacheLine = 64;
+
+inline size_t ring_capacity_for(size_t requested) {
+    size_t capacity = 2;
+    while (capacity < requested) capacity <<= 1;
+    return capacity;
+}
+
+// One producer thread and one consumer thread. Each side keeps a copy of
+// the other's index and reloads it only when the ring looks full (or
+// empty), so a steady stream costs one shared load per lap, not per item.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity)
+        : mask_(ring_capacity_for(capacity) - 1), slots_(mask_ + 1) {}
+
+    bool try_push(T item) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_) return false;
+        }
+        slots_[tail & mask_] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& item) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) return false;
+        }
+        item = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    alignas(kRingCacheLine) std::atomic<size_t> head_{0};   // consumer
+    size_t tail_cache_ = 0;
+    alignas(kRingCacheLine) std::atomic<size_t> tail_{0};   // producer
+    size_t head_cache_ = 0;
+    alignas(kRingCacheLine) const size_t mask_;
+    std::vector<T> slots_;
+};
+
+// Any number of producer threads, one consumer thread (Vyukov's bounded
+// queue with a single consumer). Every slot carries a sequence number: a
+// producer claims position p by advancing the tail with a CAS once slot
+// p's sequence reads p, and publishes by setting it to p + 1; the consumer
+// frees the slot for the next lap by setting it to p + capacity. A
+// producer that stalls between claim and publish holds up the consumer at
+// that slot only; the other producers keep going until the ring fills.
+template <typename T>
+class MpscRing {
+public:
+    explicit MpscRing(size_t capacity)
+        : mask_(ring_capacity_for(capacity) - 1), slots_(mask_ + 1) {
+        for (size_t i = 0; i <= mask_; ++i) slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    bool try_push(T item) {
+        size_t position = tail_.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots_[position & mask_];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (lag == 0) {
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            } else if (lag < 0) {
+                return false;                   // the consumer has not freed this slot yet: full
+            } else {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = std::move(item);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& item) {
+        Slot& slot = slots_[head_ & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != head_ + 1) return false;
+        item = std::move(slot.value);
+        slot.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+        ++head_;
+        return true;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct alignas(kRingCacheLine) Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    alignas(kRingCacheLine) std::atomic<size_t> tail_{0};   // producers
+    alignas(kRingCacheLine) size_t head_ = 0;               // consumer only
+    const size_t mask_;
+    std::vector<Slot> slots_;
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include "simd_dispatch.h"
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+// Runtime settings measured on the host they run on. autotune_machine()
+// times the shared kernels under each candidate setting and keeps the
+// fastest; the profile is saved once per host and both CLIs apply it at
+// startup, in place of the built-in defaults (widest detected SIMD tier,
+// one thread per hardware thread, 32-stock pair tiles). Settings given on
+// the command line still win.
+struct MachineProfile {
+    // Host the profile was measured on; a profile only applies there
+    std::string host;
+    unsigned cores = 0;                         // hardware_concurrency()
+    SimdTier detected_tier = SimdTier::Scalar;  // detect_simd_tier()
+
+    SimdTier simd_tier = SimdTier::Scalar;  // fastest tier, at most detected_tier
+    unsigned threads = 0;                   // worker threads, 0 = hardware_concurrency()
+    size_t pair_tile = 0;                   // stocks per side of a pair tile, 0 = 32
+
+    // Same host name, core count and detected tier as this machine
+    bool matches_host() const;
+
+    // $MFT_MACHINE_PROFILE, else ~/.mft/machine_profile
+    static std::string default_path();
+    // "key: value" lines as config/default_config.yaml, '#' comments;
+    // false if the file is missing or lacks a key
+    static bool load(const std::string& path, MachineProfile& profile);
+    // Creates the directory; throws std::runtime_error if the file cannot be written
+    void save(const std::string& path) const;
+};
+
+// Measures every setting of the profile on this host, in order, each with
+// the ones before it in place:
+//   simd_tier  a mix of per-bar, window and reduction kernels on every tier
+//              the CPU supports (a wider tier can lose to its clock drop)
+//   pair_tile  all-pairs products of synthetic series in square tiles of
+//              8 to 128 stocks a side, on one thread; the smallest edge
+//              within kTuneTolerance of the best, as smaller tiles balance
+//              better across threads
+//   threads    the tiled pair products on 1, 2, 4, ... hardware threads;
+//              the fewest within kTuneTolerance of the best, since SMT
+//              siblings and saturated memory bandwidth add little
+// Takes a few seconds. Progress lines go to `log` when given. Leaves the
+// active SIMD tier as it found it.
+constexpr double kTuneTolerance = 0.05;
+MachineProfile autotune_machine(std::ostream* log = nullptr);
+
+enum class ProfileStatus {
+    Applied,
+    Missing,     // no readable profile at the path
+    OtherHost,   // measured on another machine; re-run the autotuner here
+};
+
+// Loads the profile at `path` (empty = MachineProfile::default_path()) and,
+// if it was measured on this host, caps the SIMD tier to it and makes it
+// the profile tuned_threads() and tuned_pair_tile() read
+ProfileStatus apply_machine_profile(const std::string& path);
+void apply_machine_profile(const MachineProfile& profile);
+const char* profile_status_name(ProfileStatus status);
+
+// Worker threads for a pool left at 0 = auto: the applied profile's, else
+// hardware_concurrency(); at least 1
+unsigned tuned_threads();
+// Stocks per side of a pair tile: the applied profile's, else 32
+size_t tuned_pair_tile();
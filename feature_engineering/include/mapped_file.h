@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Read-only view of a whole file. POSIX systems memory-map it and advise the
+// kernel of a sequential scan; Windows reads it in large chunks into a buffer.
+class MappedFile {
+public:
+    // Throws std::runtime_error if the file cannot be opened or read
+    explicit MappedFile(const std::string& filepath);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Drops the pages wholly before byte `end` from this process's resident
+    // set once a sequential reader is done with them; they are read back in
+    // if touched again. No-op where the file is buffered instead of mapped.
+    void release(size_t end);
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<char> buffer_;
+};
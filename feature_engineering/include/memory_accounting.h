@@ -0,0 +1,125 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Memory accounting for batch sizing: live and peak bytes per subsystem,
+// counted where the large buffers are allocated, and the process resident
+// set sampled per stage. Counting is always on and costs a few relaxed
+// atomic operations per allocation, so only bulk buffers take part (series,
+// feature blocks, cache tables, output buffers), never per-value objects.
+enum class MemorySubsystem {
+    Loader,     // parsed series
+    Features,   // computed feature columns
+    Caches,     // result caches kept across stocks and runs
+    Exports,    // formatted output on its way to disk
+};
+constexpr size_t kMemorySubsystems = 4;
+
+const char* memory_subsystem_name(MemorySubsystem subsystem);
+
+void memory_allocated(MemorySubsystem subsystem, size_t bytes);
+void memory_released(MemorySubsystem subsystem, size_t bytes);
+
+struct MemoryUsage {
+    size_t live_bytes = 0;
+    size_t peak_bytes = 0;  // since the start of the process or reset_memory_report()
+};
+MemoryUsage memory_usage(MemorySubsystem subsystem);
+
+// Bytes one owner holds in a subsystem, released when it is destroyed and
+// handed over when it is moved. A copy starts uncharged, so members of
+// copyable types never count twice.
+class MemoryCharge {
+public:
+    MemoryCharge() = default;
+    MemoryCharge(MemorySubsystem subsystem, size_t bytes) { set(subsystem, bytes); }
+    ~MemoryCharge() { release(); }
+    MemoryCharge(const MemoryCharge&) {}
+    MemoryCharge& operator=(const MemoryCharge&) { return *this; }
+    MemoryCharge(MemoryCharge&& other) noexcept : subsystem_(other.subsystem_), bytes_(other.bytes_) { other.bytes_ = 0; }
+    MemoryCharge& operator=(MemoryCharge&& other) noexcept;
+
+    // Charges `bytes` in place of what was charged before
+    void set(MemorySubsystem subsystem, size_t bytes);
+    void release();
+    size_t bytes() const { return bytes_; }
+
+private:
+    MemorySubsystem subsystem_ = MemorySubsystem::Loader;
+    size_t bytes_ = 0;
+};
+
+// std::allocator that counts its blocks in a subsystem, for containers whose
+// nodes or buffers make up a subsystem's data (e.g. a cache's hash table)
+template <class T, MemorySubsystem Subsystem>
+class TrackingAllocator {
+public:
+    using value_type = T;
+
+    template <class U>
+    struct rebind {
+        using other = TrackingAllocator<U, Subsystem>;
+    };
+
+    TrackingAllocator() = default;
+    template <class U>
+    TrackingAllocator(const TrackingAllocator<U, Subsystem>&) {}
+
+    T* allocate(size_t n) {
+        T* p = std::allocator<T>().allocate(n);
+        memory_allocated(Subsystem, n * sizeof(T));
+        return p;
+    }
+    void deallocate(T* p, size_t n) {
+        memory_released(Subsystem, n * sizeof(T));
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <class U>
+    bool operator==(const TrackingAllocator<U, Subsystem>&) const { return true; }
+    template <class U>
+    bool operator!=(const TrackingAllocator<U, Subsystem>&) const { return false; }
+};
+
+// Resident set of the process and its high-water mark, in bytes; 0 where
+// the platform does not report them
+size_t process_rss_bytes();
+size_t process_peak_rss_bytes();
+
+// One stage's memory: the resident set's peak and its value at the end, and
+// each subsystem's peak live bytes during the stage
+struct MemoryStageRecord {
+    std::string label;
+    size_t samples = 0;
+    size_t peak_rss_bytes = 0;
+    size_t end_rss_bytes = 0;
+    std::array<size_t, kMemorySubsystems> peak_live_bytes{};
+};
+
+// Samples a stage into the memory report (and, while tracing, into the
+// trace as "memory" counter events) when it starts and ends. On Linux the
+// kernel's resident high-water mark is reset at the start, so the peak is
+// the stage's own; a stage that starts while another is running (the
+// overlapping pipeline stages) leaves it, and reports an upper bound.
+// Elsewhere the peak is the process's so far.
+class MemoryScope {
+public:
+    explicit MemoryScope(std::string label);
+    ~MemoryScope();
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    std::string label_;
+};
+
+// Stages in first-recorded order; repeated labels are merged (peaks kept)
+std::vector<MemoryStageRecord> memory_report();
+// Clears the stages and restarts every subsystem's peak from its live bytes
+void reset_memory_report();
+// Prints each subsystem's live and peak bytes, each stage's, and the
+// process's peak resident set
+void print_memory_report(const char* title);
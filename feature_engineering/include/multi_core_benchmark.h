@@ -1,4 +0,0 @@
-#pragma once
-
-// Function to run multi-core benchmark with optimal distribution (1000 stocks per core)
-void run_multi_core_benchmark();
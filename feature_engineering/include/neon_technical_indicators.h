@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <functional>
+#include <cstdint>
 
 #ifdef __ARM_NEON
 #include <arm_neon.h>
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// NUMA placement for worker threads. Linux reads each node's CPU list from
+// sysfs; other systems, and single-node machines, see one node and every
+// placement call is a no-op.
+struct NumaTopology {
+    std::vector<std::vector<unsigned>> node_cpus;   // CPUs of each node, never empty
+
+    size_t nodes() const { return node_cpus.size(); }
+
+    // Detected once, on first use
+    static const NumaTopology& system();
+};
+
+// Runtime switch for pinning pool workers to nodes, on by default
+void set_numa_placement(bool enabled);
+// Placement is enabled and the machine has more than one node
+bool numa_placement_active();
+
+// Runtime switch for keeping one copy of large shared read-only data per
+// node (e.g. the packed return matrix of the pair scan), off by default;
+// active only while placement is
+void set_numa_replication(bool enabled);
+bool numa_replication_active();
+
+// Node of worker `worker` of `workers`: workers are split into contiguous
+// blocks, one per node, so neighbouring worker indices share a node
+unsigned numa_node_of_worker(unsigned worker, unsigned workers);
+
+// Restricts the calling thread to the CPUs of `node`; false when the
+// platform cannot pin threads
+bool pin_thread_to_node(unsigned node);
+// Restricts the calling thread to one CPU; false when the platform cannot
+// pin threads or the CPU does not exist
+bool pin_thread_to_cpu(unsigned cpu);
+
+// Saves the calling thread's CPU affinity and restores it when destroyed,
+// for a caller that takes part in a pinned pool as one of its workers
+class ThreadAffinityGuard {
+public:
+    ThreadAffinityGuard();
+    ~ThreadAffinityGuard();
+    ThreadAffinityGuard(const ThreadAffinityGuard&) = delete;
+    ThreadAffinityGuard& operator=(const ThreadAffinityGuard&) = delete;
+
+private:
+    std::vector<unsigned char> saved_;  // platform affinity mask, empty if unsaved
+};
+
+// Runs fn on a thread pinned to `node` and waits for it, so the pages fn
+// touches first are placed on that node
+void run_on_numa_node(unsigned node, const std::function<void()>& fn);
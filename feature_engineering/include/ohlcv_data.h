@@ -1,5 +1,6 @@
 #pragma once
 
+#include "memory_accounting.h"
 #include <vector>
 #include <string>
 #include <chrono>
@@ -9,6 +10,8 @@ struct OHLCVData {
     std::string symbol;
     std::vector<std::chrono::system_clock::time_point> timestamps;
     std::vector<double> open, high, low, close, volume;
+    // Column capacity, in the Loader subsystem; refreshed by charge_memory()
+    MemoryCharge memory;
 
     void reserve(size_t size) {
         timestamps.reserve(size);
@@ -19,6 +22,16 @@ struct OHLCVData {
         volume.reserve(size);
     }
 
+    size_t capacity_bytes() const {
+        return timestamps.capacity() * sizeof(timestamps[0]) +
+               (open.capacity() + high.capacity() + low.capacity() + close.capacity() + volume.capacity()) * sizeof(double);
+    }
+
+    // Charges the columns' current capacity, once they are filled
+    void charge_memory() {
+        memory.set(MemorySubsystem::Loader, capacity_bytes());
+    }
+
     size_t size() const {
         return close.size();
     }
@@ -86,6 +99,10 @@ struct FeatureSet {
     std::vector<double> chow_test_statistic_breakpoint_detection_50;
     std::vector<double> market_regime_hmm_3_states_price_vol;
     std::vector<double> high_volatility_indicator_garch_threshold;
+    // Filtered state probabilities of the 3-state RegimeModel, by variance
+    std::vector<double> hmm_regime_probability_low_vol;
+    std::vector<double> hmm_regime_probability_mid_vol;
+    std::vector<double> hmm_regime_probability_high_vol;
 
     // Non-Linear/Interaction
     std::vector<double> return_x_volume_interaction_10;
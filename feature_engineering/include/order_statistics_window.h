@@ -0,0 +1,40 @@
+#pragma once
+#include "rolling_moments.h"
+#include <vector>
+#include <cstddef>
+
+// Sliding-window order statistics over a fixed value universe.
+// Values are rank-compressed against the full series up front, then two
+// Fenwick trees (counts and value sums) give O(log n) insert/erase and
+// rank, k-th smallest and sum-of-k-smallest queries on the current window.
+// The sums are compensated, so inserts and erases do not drift over a long
+// series. Non-finite values are left out: insert and erase skip them.
+class OrderStatisticWindow {
+public:
+    // `universe` must contain every value that will be inserted
+    explicit OrderStatisticWindow(const std::vector<double>& universe);
+    OrderStatisticWindow(const double* universe, size_t n);
+
+    void insert(double value);
+    void erase(double value);
+    size_t size() const { return size_; }
+
+    // Number of window values strictly less than `value`
+    size_t count_less(double value) const;
+    // k-th smallest value in the window, k in [0, size)
+    double kth_smallest(size_t k) const;
+    // Sum of the k smallest window values
+    double sum_smallest(size_t k) const;
+
+private:
+    size_t rank_of(double value) const;
+    void update(size_t rank, long count_delta, double value_delta);
+    // Largest rank r such that prefix count up to r (exclusive) is <= k
+    size_t lower_rank_for(size_t k) const;
+
+    std::vector<double> values_;     // sorted unique values
+    std::vector<long> count_tree_;   // 1-based Fenwick trees
+    std::vector<CompensatedSum> sum_tree_;
+    size_t size_ = 0;
+    size_t top_bit_ = 1;
+};
@@ -0,0 +1,111 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct PanelConfig {
+    // Market series: this symbol's returns when set and present, otherwise
+    // the equal-weighted return of every series trading the bar
+    std::string market_symbol;
+    // symbol -> sector; a sector's series is the equal-weighted return of its
+    // members, and unmapped symbols share one sector
+    std::unordered_map<std::string, std::string> sectors;
+    unsigned threads = 0;   // 0 = tuned_threads() (machine_profile.h)
+};
+
+// One series of the panel and its panel columns at its own bars
+struct PanelSeries {
+    std::string symbol;
+    std::vector<std::chrono::system_clock::time_point> timestamps;
+    std::vector<double> close;
+    std::vector<size_t> position;               // bar i sits at index()[position[i]]
+    // column_names() order; column k holds rows offsets[k] onwards, like a
+    // feature column and its row offset
+    std::vector<std::vector<double>> columns;
+    std::vector<size_t> offsets;
+};
+
+// Cross-sectional features over a universe aligned on one shared timestamp
+// index, the sorted union of every series' bars. Runs after the per-stock
+// features, once every series has been added:
+//  - cross_sectional_momentum_rank_20: percentile rank in [0, 1] of each
+//    series' 20-bar mean return among the series trading that bar, ties
+//    averaged; ranked per bar, in parallel over slices of the index, each
+//    slice gathering the bars of every series that fall in it
+//  - beta_to_market_60, correlation_to_sector_40 and <factor>_beta_120:
+//    running covariance sums over the last N bars at which both the series
+//    and the shared series have a return, in parallel over series; a bar
+//    without a shared return repeats the current window's value
+//  - relative_strength_spx_50: 50-bar return less the compounded market
+//    return over the same span
+class PanelEngine {
+public:
+    using time_point = std::chrono::system_clock::time_point;
+
+    static constexpr size_t kMomentumWindow = 20;
+    static constexpr size_t kMarketBetaWindow = 60;
+    static constexpr size_t kRelativeStrengthWindow = 50;
+    static constexpr size_t kSectorCorrelationWindow = 40;
+    static constexpr size_t kFactorBetaWindow = 120;
+
+    explicit PanelEngine(PanelConfig config = {});
+
+    // Bars in ascending time order. Thread-safe, so pipeline workers can add
+    // series as they finish them.
+    void add_series(const std::string& symbol, const std::vector<time_point>& timestamps,
+                    const std::vector<double>& close);
+    // Shared per-bar factor returns (e.g. Fama-French SMB), matched to the index
+    // by timestamp; adds the column <name>_beta_120
+    void add_factor(const std::string& name, const std::vector<time_point>& timestamps,
+                    const std::vector<double>& returns);
+    // Factors from a "datetime,<name>,..." CSV of per-bar returns; throws
+    // std::runtime_error if the file cannot be read
+    void load_factors(const std::string& path);
+    // "symbol,sector" lines; throws std::runtime_error if the file cannot be read
+    static std::unordered_map<std::string, std::string> load_sectors(const std::string& path);
+
+    // Aligns everything added so far and fills every series' columns
+    void compute();
+
+    const std::vector<time_point>& index() const { return index_; }
+    const std::vector<std::string>& column_names() const { return column_names_; }
+    const std::vector<PanelSeries>& series() const { return series_; }
+
+private:
+    struct Factor {
+        std::string name;
+        std::vector<time_point> timestamps;
+        std::vector<double> returns;
+    };
+    // A shared return series on the index; values[t] is valid where has[t] is set
+    struct Shared {
+        std::vector<double> values;
+        std::vector<unsigned char> has;
+    };
+
+    void build_index();
+    // Equal-weighted mean of the members' returns per index bar
+    Shared mean_returns(const std::vector<size_t>& members) const;
+    void rank_momentum();
+    void compute_series(size_t s, const Shared& market, const std::vector<double>& market_level,
+                        const Shared& sector, const std::vector<Shared>& factors);
+
+    PanelConfig config_;
+    std::mutex mutex_;
+    std::vector<PanelSeries> series_;
+    std::vector<Factor> factors_;
+    std::vector<time_point> index_;
+    std::vector<std::string> column_names_;
+
+    // Per-series ranges, series after series: bar i of series s sits at
+    // first_bar_[s] + i, so storage grows with the bars each series has
+    // rather than index bars x series. returns_ is valid from bar 1,
+    // momentum_ (the 20-bar mean return, replaced by its rank) from bar
+    // kMomentumWindow.
+    std::vector<size_t> first_bar_;
+    std::vector<double> returns_;
+    std::vector<double> momentum_;
+};
@@ -1,4 +0,0 @@
-#pragma once
-
-// Function to run comprehensive performance benchmark
-void run_performance_benchmark();
@@ -0,0 +1,130 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstddef>
+
+// K-state Gaussian hidden Markov model of one return series: a hidden regime
+// follows a Markov chain and each return is drawn from its regime's normal
+// distribution. Arrays are padded to kMaxStates; entries past `states` are
+// zero, so the per-bar recursions run over whole fixed-width state vectors
+// that the compiler keeps in SIMD registers.
+struct HmmParams {
+    static constexpr size_t kMaxStates = 4;
+    size_t states = 0;
+    std::array<double, kMaxStates> initial{};
+    std::array<std::array<double, kMaxStates>, kMaxStates> transition{};  // [from][to]
+    std::array<double, kMaxStates> mean{};
+    std::array<double, kMaxStates> variance{};
+};
+
+// Fitted models behind the regime features (markov_regime_switching_garch_2_state
+// and the 3-state columns)
+struct RegimeFeatureParams {
+    HmmParams two_state;
+    HmmParams three_state;
+};
+
+// Causal forward filter, O(K^2) per return: after update(r), probabilities()
+// holds P(state | returns so far). Emissions are weighed in log space against
+// their largest term, so returns far out in every state's tail neither
+// underflow nor divide by zero.
+class RegimeFilter {
+public:
+    explicit RegimeFilter(const HmmParams& params);
+
+    void update(double ret);
+    const double* probabilities() const { return probabilities_.data(); }
+    size_t states() const { return states_; }
+    // Index of the most probable state
+    size_t most_likely() const;
+    // log p(returns so far)
+    double log_likelihood() const { return log_likelihood_.value(); }
+    size_t count() const { return count_; }
+
+    // A bar's likelihood as exp(shift) * scale, 0 < scale <= 1
+    struct Normalizer {
+        double shift;
+        double scale;
+    };
+
+    // Sum of the normalizers' logs, taking one log per 1e50 of scale
+    // rather than one per bar
+    class LogLikelihood {
+    public:
+        void add(const Normalizer& normalizer);
+        double value() const;
+    private:
+        double log_sum_ = 0.0;
+        double product_ = 1.0;
+    };
+
+    // Per-bar recursion shared with RegimeModel's filter and forward-backward.
+    // Emissions do not depend on the previous bar, so they are computed for
+    // runs of returns ahead of the recursion, vectorized across bars and
+    // states; the recursion itself has no exp or log.
+    struct Step {
+        explicit Step(const HmmParams& params);
+        // emission[t * kMaxStates + k] = exp(log density - shift[t]), shift[t]
+        // being the bar's largest log density
+        void emissions(const double* returns, size_t count, double* emission, double* shift) const;
+        // Predicted probabilities and one bar's emissions in; filtered
+        // probabilities out, and the emissions divided by the bar's likelihood
+        Normalizer filter(const double* predicted, double shift, double* emission, double* filtered) const;
+        void predict(const double* filtered, double* predicted) const;
+
+        size_t states;
+        alignas(32) double transition[HmmParams::kMaxStates][HmmParams::kMaxStates];
+        alignas(32) double mean[HmmParams::kMaxStates];
+        alignas(32) double inv_variance[HmmParams::kMaxStates];
+        alignas(32) double log_norm[HmmParams::kMaxStates];
+    };
+
+private:
+    Step step_;
+    size_t states_;
+    std::array<double, HmmParams::kMaxStates> probabilities_{};
+    std::array<double, HmmParams::kMaxStates> predicted_{};
+    LogLikelihood log_likelihood_;
+    size_t count_ = 0;
+};
+
+// States are always ordered by variance, lowest first, so state K - 1 is the
+// turbulent regime of any series.
+class RegimeModel {
+public:
+    // Returns that seed default_params(); the streaming path holds its regime
+    // columns back until it has seen them
+    static constexpr size_t kWarmup = 50;
+    static constexpr double kDefaultStay = 0.98;
+
+    // The warm-up returns' mean for every state, variances spread evenly in
+    // log scale from half to twice the warm-up variance, kDefaultStay on the
+    // diagonal and a uniform initial distribution
+    static HmmParams default_params(const double* returns, size_t n, size_t states);
+
+    // P(state k | returns [0, t]) into out[k * n + t], one column per state
+    static void filter(const double* returns, size_t n, const HmmParams& params, double* out);
+    // Index of the most probable state per return of a state-major filter()
+    // or smooth() output
+    static std::vector<double> most_likely_states(const std::vector<double>& probabilities, size_t states);
+    // P(state k | all n returns) into out[k * n + t] by forward-backward;
+    // returns the log-likelihood
+    static double smooth(const double* returns, size_t n, const HmmParams& params, double* out);
+
+    // Baum-Welch from the full-sample default_params() until the
+    // log-likelihood gains less than kTolerance relatively, or after
+    // kMaxIterations. Variances are floored at a small share of the sample
+    // variance and transitions at kMinTransition, so no state collapses onto
+    // a single return. Series shorter than kMinFitReturns get default_params().
+    // Holds eight doubles per return while it runs.
+    static constexpr size_t kMinFitReturns = 200;
+    static constexpr size_t kMaxIterations = 100;
+    static constexpr double kTolerance = 1e-7;
+    static constexpr double kMinTransition = 1e-6;
+    static HmmParams fit(const std::vector<double>& returns, size_t states);
+    // fit() for every series, in parallel across series
+    static std::vector<HmmParams> fit_batch(const std::vector<std::vector<double>>& returns, size_t states);
+
+    // The 2- and 3-state fits behind the regime features
+    static RegimeFeatureParams fit_features(const std::vector<double>& returns);
+};
@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+// Sliding-window rescaled-range (R/S) Hurst exponent, applied to log prices
+// as in TechnicalIndicators::hurst_exponent_100. Log prices are taken
+// once per series and the window sum slides in O(1), so no window allocates
+// or recomputes a logarithm; scratch buffers are kept across compute() calls.
+//
+// With no lags this is the single-scale estimate of hurst_exponent_100:
+// log(R/S) / log(n) over the window's n positive prices. Windows are taken
+// in runs that share a multiple t of the window length among their
+// cumulative-sum positions; each run gets prefix sums of the logs (and their
+// squares) local to t, so a window's mean and deviation sum of squares are
+// O(1). Its cumulative-deviation range is the extreme of P[j] - mean * j
+// over the window's prefix sums P, found on convex hulls of the positions
+// before and from t, each swept once per run, so a window costs O(log window)
+// instead of O(window). Windows missing t (only when nonpositive prices
+// shorten them) are scanned directly.
+//
+// With lags, the series is cut into lag-length chunks aligned to the start of
+// the series; each chunk's R/S is computed once and a window averages the
+// chunks it fully contains, so a window costs O(lags) instead of O(window).
+// The estimate is the least-squares slope of log(mean R/S) on log(lag).
+class RollingHurst {
+public:
+    // Windows with fewer positive prices than this give 0.5
+    static constexpr size_t kMinPrices = 10;
+
+    // Lags below 2 or above `window` are dropped
+    explicit RollingHurst(size_t window, std::vector<size_t> lags = {});
+
+    size_t window() const { return window_; }
+    const std::vector<size_t>& lags() const { return lags_; }
+
+    // out[k] covers prices[k .. k + window - 1], clamped to [0, 1]; writes
+    // n - window + 1 values and returns that count (0 if n < window).
+    // Keep one object per thread and reuse it across series: the scratch
+    // buffers then stop growing after the longest series.
+    size_t compute(const double* prices, size_t n, double* out);
+
+private:
+    // Upper convex hull of points added in increasing x, queried for the
+    // largest y - slope * x
+    struct UpperHull {
+        std::vector<double> x, y;
+        void clear() { x.clear(); y.clear(); }
+        void push(double px, double py);
+        double max(double slope) const;
+    };
+
+    // R/S of logs_[begin, begin + length): range of cumulative deviations
+    // from the mean over the sample standard deviation, 1 for a flat run
+    double rescaled_range(size_t begin, size_t length, double sum) const;
+    double multi_scale(size_t lo, size_t hi) const;
+    // Single-scale estimates of the windows k in [first, last), all holding
+    // cumulative-sum position t (see above)
+    void single_scale_run(size_t first, size_t last, size_t t, double* out);
+    double hurst_of(double rs, size_t m) const;
+
+    size_t window_;
+    std::vector<size_t> lags_;
+    std::vector<double> log_length_;    // log(m) for window lengths m <= window
+
+    // Scratch, reused across calls
+    std::vector<double> logs_;          // log of each positive price, in order
+    std::vector<size_t> valid_;         // valid_[i] = positive prices among prices[0, i)
+    std::vector<double> chunk_prefix_;  // per lag: prefix sums of chunk R/S, back to back
+    std::vector<size_t> chunk_offset_;  // start of each lag's prefix sums in chunk_prefix_
+    std::vector<size_t> lo_, hi_;       // per window: its positive prices are logs_[lo_, hi_)
+    std::vector<double> local_sum_;     // per run: prefix sums of logs_ - anchor from t - window
+    std::vector<double> local_squares_; // the same for the squared deviations from the anchor
+    std::vector<double> before_max_, before_min_;  // per run window: extremes over positions < t
+    UpperHull upper_, lower_;
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Finite test on the exponent bits: fast math folds std::isfinite to true
+inline bool is_finite(double x) {
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return (bits & 0x7ff0000000000000ULL) != 0x7ff0000000000000ULL;
+}
+
+// Neumaier-compensated running sum. Supports removal by adding the negated value.
+// add() lives in compensated_sum.cpp, built without fast math.
+struct CompensatedSum {
+    double sum = 0.0;
+    double compensation = 0.0;
+
+    void add(double x);
+    double value() const { return sum + compensation; }
+    void reset() { sum = 0.0; compensation = 0.0; }
+};
+
+// Fixed-window running power sums (x, x^2, x^3, x^4) with O(1) push/evict.
+// Values are stored relative to an anchor close to the window mean to limit
+// cancellation, and the sums are rebuilt from the ring buffer once every
+// `window` pushes so round-off cannot accumulate over long series
+// (amortized O(1) per bar).
+class RollingMoments {
+public:
+    explicit RollingMoments(size_t window);
+
+    // Appends a value, evicting the oldest one once the window is full
+    void push(double x);
+    void reset();
+    // Pushes values[0 .. n) and writes sqrt(sample_variance()) after each
+    // push that leaves the window full; returns the count written. Out of
+    // line, so a series pushed whole or in blocks rounds alike under fast math
+    size_t push_stddev(const double* values, size_t n, double* out);
+
+    bool full() const { return count_ == window_; }
+    size_t count() const { return count_; }
+    size_t window() const { return window_; }
+    double newest() const;
+    double oldest() const;
+
+    double sum() const;
+    double mean() const;
+    double population_variance() const;
+    double sample_variance() const;
+    // Population skewness m3 / m2^1.5, 0 when the window is flat
+    double skewness() const;
+    // Population excess kurtosis m4 / m2^2 - 3, 0 when the window is flat
+    double excess_kurtosis() const;
+
+private:
+    void accumulate(double d, double sign);
+    void resync();
+    // Central moments of the window (divided by n)
+    void central_moments(double& m2, double& m3, double& m4) const;
+
+    size_t window_;
+    size_t count_ = 0;
+    size_t head_ = 0;           // index of the oldest value in ring_
+    size_t since_resync_ = 0;
+    double anchor_ = 0.0;
+    std::vector<double> ring_;
+    CompensatedSum s1_, s2_, s3_, s4_;
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+
+// Rolling window sum, mean, variance, covariance and correlation shared by
+// the feature columns (SIMDTechnicalIndicators, NEONTechnicalIndicators) and
+// the arbitrage statistics (SIMDStatistics), so both report the same numbers
+// for the same window. Built into the mft_kernels library with the vector
+// kernels (cmake/mft_kernels.cmake).
+//
+// The output rows are cut into blocks. Each block accumulates
+// Neumaier-compensated prefix sums of x, y, x^2, y^2 and x * y over its
+// span, relative to the block's first values, and the window sums are read
+// off them by SimdKernels::compensated_window_sums on the active tier. The
+// sums restart at every block, so round-off never grows with the series, and
+// a call over x + k * kBlockRows gives the same values as the windows from
+// k * kBlockRows of a call over x.
+//
+// Element storage is double or float (explicitly instantiated); sums and
+// outputs are always double. Each function writes n - window + 1 values and
+// returns that count: 0 when n < window, or window < 2 for the sample
+// statistics.
+class RollingStatistics {
+public:
+    // Output rows per block; the prefix arrays of a block stay within L2 for
+    // windows up to a few hundred bars
+    static constexpr size_t kBlockRows = 1024;
+
+    template <class T>
+    static size_t sum(const T* x, size_t n, size_t window, double* out);
+    template <class T>
+    static size_t mean(const T* x, size_t n, size_t window, double* out);
+    // Sample variance (divided by window - 1); 0 for a flat window
+    template <class T>
+    static size_t variance(const T* x, size_t n, size_t window, double* out);
+    template <class T>
+    static size_t stddev(const T* x, size_t n, size_t window, double* out);
+    // Sample covariance of x and y over the same window
+    template <class T>
+    static size_t covariance(const T* x, const T* y, size_t n, size_t window, double* out);
+    // Pearson correlation; 0 when either window is flat
+    template <class T>
+    static size_t correlation(const T* x, const T* y, size_t n, size_t window, double* out);
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "columnar_writer.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// MFT shared feature segment, version 1: one stock's latest .mftc image
+// (columnar_format.h) in POSIX shared memory, so a process can view another
+// process's features while it runs, straight out of the segment.
+//
+//   offset 0               SharedSegmentHeader (128 bytes), page-sized header area
+//   slot_offset[0] / [1]   two image slots, page aligned
+//
+// Publishes alternate between the slots. `sequence` is 2 * publishes and is
+// odd while a publish is being written; publish k (counting from 1) lives
+// in slot k & 1, and the slot of the latest complete publish is therefore
+// (sequence >> 1) & 1 at any time. The writer reuses that slot only when it
+// starts the publish after next, which bumps the sequence past
+// 2 * (sequence >> 1) + 2 first, so a reader that sees no more than that
+// after reading knows its image was not touched. A slot too small for an
+// image moves to the end of the segment and its old pages are released.
+constexpr char kSharedSegmentMagic[8] = {'M', 'F', 'T', 'S', 'H', 'M', '\0', '\0'};
+constexpr uint32_t kSharedSegmentVersion = 1;
+constexpr size_t kSharedSegmentHeaderBytes = 4096;
+
+struct SharedSegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved0;
+    std::atomic<uint64_t> sequence;
+    uint64_t slot_offset[2];
+    uint64_t slot_capacity[2];
+    uint64_t slot_size[2];          // bytes of the image in the slot
+    uint8_t reserved[56];
+};
+static_assert(sizeof(SharedSegmentHeader) == 128, "SharedSegmentHeader layout is part of the segment format");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "the sequence is shared between processes");
+
+// Segment name for one stock of a run publishing under `prefix`:
+// "/<prefix>.<symbol>", with any '/' in either part replaced by '_'
+std::string shared_segment_name(const std::string& prefix, const std::string& symbol);
+
+// Writes images into a segment, creating it if needed (mode 0644, so other
+// users can only map it read-only). A segment left by an earlier publisher
+// of the same version is taken over and its sequence continued, so readers
+// stay attached across runs. One publisher per segment at a time. The
+// segment outlives the publisher; remove() deletes it.
+class SharedFeaturePublisher {
+public:
+    // Throws std::runtime_error if the segment cannot be created or mapped
+    explicit SharedFeaturePublisher(const std::string& name);
+    ~SharedFeaturePublisher();
+    SharedFeaturePublisher(const SharedFeaturePublisher&) = delete;
+    SharedFeaturePublisher& operator=(const SharedFeaturePublisher&) = delete;
+
+    // Same columns as ColumnarWriter::write_ohlcv_with_features, built in
+    // place in the segment. Throws std::runtime_error if it cannot grow.
+    void publish(const OHLCVData& ohlcv_data, const FeatureSet& features,
+                 const std::string& data_frequency = "daily", const FeatureMask& columns = all_features());
+    void publish(const OHLCVData& ohlcv_data, const FeatureBlock& block,
+                 const std::string& data_frequency = "daily", const FeatureMask& columns = all_features());
+
+    const std::string& name() const { return name_; }
+    // Completed publishes, including an earlier publisher's
+    uint64_t publishes() const;
+
+    // Deletes the segment; readers already attached keep their mapping
+    static void remove(const std::string& name);
+
+private:
+    void publish_image(const std::function<void(const ColumnarWriter::Allocator&)>& build);
+    uint8_t* reserve(int slot, size_t bytes);
+    void map(size_t size);
+    SharedSegmentHeader* header() const { return reinterpret_cast<SharedSegmentHeader*>(base_); }
+
+    std::string name_;
+    int fd_ = -1;
+    uint8_t* base_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Maps a segment read-only and hands out views of its latest image that
+// point straight into the segment: nothing is parsed, converted or copied.
+class SharedFeatureReader {
+public:
+    // Throws std::runtime_error if the segment does not exist or is not a
+    // feature segment of this version
+    explicit SharedFeatureReader(const std::string& name);
+    ~SharedFeatureReader();
+    SharedFeatureReader(const SharedFeatureReader&) = delete;
+    SharedFeatureReader& operator=(const SharedFeatureReader&) = delete;
+
+    const std::string& name() const { return name_; }
+    // Completed publishes; a change means there is a newer image to read
+    uint64_t publishes() const;
+
+    // Calls `visit` with a view of the latest image. The view is valid only
+    // during the call, and only if the publisher did not reuse its slot
+    // meanwhile: read() checks that after `visit` returns and, if it did,
+    // calls `visit` again on the newer image, so `visit` must be safe to
+    // repeat and only its last call's results count. Returns the publish
+    // read, or 0 if nothing was published yet or no read was consistent
+    // within `attempts`.
+    uint64_t read(const std::function<void(const ColumnarFile&)>& visit, int attempts = 8);
+
+private:
+    bool covers(uint64_t offset, uint64_t bytes);
+    const SharedSegmentHeader* header() const { return reinterpret_cast<const SharedSegmentHeader*>(base_); }
+
+    std::string name_;
+    int fd_ = -1;
+    const uint8_t* base_ = nullptr;
+    size_t size_ = 0;
+};
@@ -0,0 +1,166 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Runtime CPU dispatch for the vector kernels. Each tier lives in its own
+// translation unit built with that tier's instruction-set flags, so one binary
+// built for the baseline ISA runs on every machine and picks the widest tier
+// the CPU (and OS) supports the first time a kernel is used.
+enum class SimdTier { Scalar, NEON, AVX2, AVX512 };
+
+// Raw-pointer kernels shared by SIMDTechnicalIndicators and SIMDStatistics
+struct SimdKernels {
+    SimdTier tier;
+    // out[i] = a[i] - b[i]
+    void (*subtract)(const double* a, const double* b, double* out, size_t n);
+    // out[i] = a[i] / b[i], 0 where b[i] == 0
+    void (*divide)(const double* a, const double* b, double* out, size_t n);
+    // out[i] = in[i] * factor
+    void (*scale)(const double* in, double factor, double* out, size_t n);
+    // sum of p[0, n)
+    double (*sum)(const double* p, size_t n);
+    // sum of (p[i] - mean)^2
+    double (*squared_deviation_sum)(const double* p, size_t n, double mean);
+    // sum of i * p[i]
+    double (*index_weighted_sum)(const double* p, size_t n);
+    // out = {sum dx*dy, sum dx*dx, sum dy*dy} with dx = x - mean_x, dy = y - mean_y
+    void (*centered_products)(const double* x, const double* y, size_t n,
+                              double mean_x, double mean_y, double out[3]);
+
+    // float32 storage: elementwise kernels run twice the lanes of their double
+    // counterparts; reductions widen to double and return double sums
+    void (*subtract_f32)(const float* a, const float* b, float* out, size_t n);
+    void (*divide_f32)(const float* a, const float* b, float* out, size_t n);
+    void (*scale_f32)(const float* in, float factor, float* out, size_t n);
+    double (*sum_f32)(const float* p, size_t n);
+    double (*squared_deviation_sum_f32)(const float* p, size_t n, double mean);
+    double (*index_weighted_sum_f32)(const float* p, size_t n);
+
+    // Indicator building blocks (src/simd_kernel_bodies.h). Per-bar kernels
+    // take the current and previous bar as separate pointers (p + 1, p).
+    // out[k] = sum of terms[k .. k + window - 1], newest first; n - window + 1 outputs
+    void (*window_sums)(const double* terms, size_t n, size_t window, double* out);
+    // out[i] = |a[i] - b[i]|
+    void (*abs_diff)(const double* a, const double* b, double* out, size_t n);
+    // max(high - low, |high - prev_close|, |low - prev_close|)
+    void (*true_range)(const double* high, const double* low, const double* prev_close, double* out, size_t n);
+    // Wilder's +DM / -DM
+    void (*directional_movement)(const double* high, const double* prev_high,
+                                 const double* low, const double* prev_low,
+                                 double* plus, double* minus, size_t n);
+    // (high + low + close) / 3
+    void (*typical_price)(const double* high, const double* low, const double* close, double* out, size_t n);
+    // typical * volume into positive or negative by the typical-price move, else 0
+    void (*money_flows)(const double* typical, const double* prev_typical, const double* volume,
+                        double* positive, double* negative, size_t n);
+    // Upward and downward part of current - previous
+    void (*gains_losses)(const double* current, const double* previous, double* gains, double* losses, size_t n);
+    // (close - low) / (high - low), 0.5 for an empty range
+    void (*bar_strength)(const double* high, const double* low, const double* close, double* out, size_t n);
+    // volume * (+1 up, -1 down, tie_sign unchanged)
+    void (*direction_volume)(const double* current, const double* previous, const double* volume,
+                             double tie_sign, double* out, size_t n);
+    // Sum of squared percentage drawdowns from each window's high; n - period + 1 outputs
+    void (*ulcer_sums)(const double* prices, size_t n, size_t period, double* out);
+    // Rolling statistics of one window length read off prefix sums, where
+    // sum[k], sum_sq[k] and sum_tx[k] hold the sums of x_j, x_j^2 and j * x_j
+    // over j < k. Output r covers the window x[first + r, first + r + window):
+    // its mean, sample variance (needs window > 1) and least-squares slope on
+    // the position in the window. Null outputs are skipped, and then so may
+    // their inputs be (sum_sq for var, sum_tx for slope).
+    void (*prefix_window_stats)(const double* sum, const double* sum_sq, const double* sum_tx,
+                                size_t first, size_t rows, size_t window,
+                                double* mean, double* var, double* slope);
+    // Window sums off a compensated prefix sum, hi[k] + lo[k] = sum of x_j
+    // over j < k: out[r] = (hi[r + window] - hi[r]) + (lo[r + window] - lo[r])
+    void (*compensated_window_sums)(const double* hi, const double* lo, size_t rows, size_t window, double* out);
+
+    // Recurrences run across `lanes` equal-length series at once, stored
+    // interleaved as p[t * lanes + s]; `rows` counts time steps.
+    size_t lanes;
+    // EMA seeded with the first row, as TechnicalIndicators::exponential_moving_average
+    void (*ema_lanes)(const double* in, size_t rows, double alpha, double* out);
+    // KAMA seeded with the first row; lookback grows to `period` over the first rows
+    void (*kama_lanes)(const double* prices, size_t rows, size_t period, double fast_sc, double slow_sc, double* out);
+    // GARCH(1,1) variance restarted from zero over each `window`; rows - window + 1 outputs
+    void (*garch_variance_lanes)(const double* returns, size_t rows, size_t window,
+                                 double omega, double alpha, double beta, double* out);
+
+    // One series, `lanes` GARCH(1,1) candidates (alpha[l], beta[l]) with
+    // variance targeting on squared standardized returns z2: h_0 = 1 and
+    // h_t = (1 - alpha - beta) + alpha * z2[t - 1] + beta * h_{t-1}.
+    // weighted[l] = sum z2[t] / h_t; products[b * lanes + l] = product of h_t
+    // over steps [b * block, (b + 1) * block), so the caller takes one log per
+    // block for sum log h_t. ceil(n / block) blocks.
+    static constexpr size_t garch_likelihood_block = 16;
+    void (*garch_likelihood_lanes)(const double* z2, size_t n, const double* alpha, const double* beta,
+                                   double* weighted, double* products);
+
+    // One tile of a Gram product Z^T Z over series packed in panels of
+    // gram_panel columns, p[t * gram_panel + c]: adds
+    // sum_t a[t * gram_panel + r] * b[t * gram_panel + c] over `depth` rows to
+    // out[r * gram_panel + c] for every r, c < gram_panel.
+    static constexpr size_t gram_panel = 8;
+    void (*gram_panel_product)(const double* a, const double* b, size_t depth, double* out);
+
+    // Augmented Dickey-Fuller regressions of `lanes` series stored interleaved
+    // as y[t * lanes + l]: dy_t on 1, y_{t-1}, dy_{t-1}, ..., dy_{t-max_lag}
+    // over the rows t in [max_lag + 1, rows), one shared sample for every lag
+    // order. The normal equations are factored once (LDL^T) and read off for
+    // each lag order p = 0..max_lag: coef[p * lanes + l] is the coefficient
+    // on y_{t-1}, var[p * lanes + l] its (X'X)^-1 diagonal entry and
+    // rss[p * lanes + l] the residual sum of squares.
+    static constexpr size_t adf_max_lag = 12;
+    void (*adf_lanes)(const double* y, size_t rows, size_t max_lag, double* coef, double* var, double* rss);
+
+    // Online hedge regression y_t = alpha_t + beta_t (x_t - x_0) of `lanes`
+    // pairs stored interleaved as x[t * lanes + l], y[t * lanes + l]. The
+    // (alpha, beta) covariance, in units of the observation noise, starts at
+    // hedge_filter_prior * I and is predicted as P / state_forgetting +
+    // state_noise * I: recursive least squares with forgetting when
+    // state_noise = 0, a random-walk Kalman filter when state_forgetting = 1.
+    // Per row t, at [t * lanes + l]: beta and alpha after the update, the
+    // one-step prediction error and its variance, the noise being the
+    // moment_forgetting-weighted mean of error^2 / gain denominator from row
+    // `warmup` on (0 until then). ar_coef and ar_var are the coefficient
+    // and its variance in the Dickey-Fuller regression ds_t on 1, s_{t-1} of
+    // the spread s = y - beta_t x, over moment_forgetting-weighted moments
+    // of rows after `warmup`; 0 while undefined.
+    static constexpr double hedge_filter_prior = 1e6;
+    void (*hedge_filter_lanes)(const double* x, const double* y, size_t rows, size_t warmup,
+                               double state_forgetting, double state_noise, double moment_forgetting,
+                               double* beta, double* alpha, double* error, double* error_var,
+                               double* ar_coef, double* ar_var);
+
+    // One z-score series, `lanes` threshold rules (entry[l], exit[l],
+    // stop[l], max_hold[l]) at once. A flat lane goes short above entry and
+    // long below -entry, at that bar's z; a position closes once z reverts
+    // past exit (below exit short, above -exit long), |z| passes stop or it
+    // has been held max_hold bars, and returns 0.01 per unit of z gained. A
+    // bar that closes a position does not open one. stats[k * lanes + l] for
+    // k = trades, winning trades, sum of trade returns, sum of their squares
+    // and entries (one more than trades while a position is still open).
+    static constexpr size_t backtest_stats = 5;
+    void (*threshold_backtest_lanes)(const double* z, size_t n, const double* entry, const double* exit,
+                                     const double* stop, const double* max_hold, double* stats);
+};
+
+// Kernel tables compiled into this build; nullptr when the compiler could not target the tier
+const SimdKernels* scalar_kernels();
+const SimdKernels* neon_kernels();
+const SimdKernels* avx2_kernels();
+const SimdKernels* avx512_kernels();
+
+// Widest tier both the CPU and this build support
+SimdTier detect_simd_tier();
+
+// Kernels of the active tier (detected on first use)
+const SimdKernels& simd_kernels();
+SimdTier active_simd_tier();
+
+// Caps the active tier, e.g. to compare against scalar; returns the tier now in use
+SimdTier limit_simd_tier(SimdTier max_tier);
+
+const char* simd_tier_name(SimdTier tier);
+// "scalar", "neon", "avx2", "avx512"; throws std::runtime_error otherwise
+SimdTier parse_simd_tier(const std::string& name);
@@ -0,0 +1,5 @@
+#pragma once
+
+// Compares every vector indicator against TechnicalIndicators on each SIMD
+// tier this CPU supports; prints the worst error and returns false on a mismatch
+bool run_simd_parity_check();
@@ -3,24 +3,10 @@
 #include <vector>
 #include <functional>
 
-#ifdef __AVX2__
-#include <immintrin.h>
-#define SIMD_ENABLED 1
-#else
-#ifdef _MSC_VER
-#pragma message("AVX2 not available. Falling back to scalar implementation.")
-#else
-#warning "AVX2 not available. Falling back to scalar implementation."
-#endif
-#define SIMD_ENABLED 0
-#endif
-
+// Vector indicators on the kernels picked at runtime by simd_dispatch.h
+// (AVX2, AVX-512 or NEON); the scalar tier delegates to TechnicalIndicators.
 class SIMDTechnicalIndicators {
 public:
-#if SIMD_ENABLED
-    static constexpr size_t AVX2_DOUBLE_COUNT = 4;
-#endif
-
     static std::vector<double> calculate_returns_simd(const std::vector<double>& prices);
     static std::vector<double> simple_moving_average_simd(const std::vector<double>& data, size_t window);
     static std::vector<double> calculate_rolling_volatility_simd(const std::vector<double>& returns, int window);
@@ -29,19 +15,63 @@ public:
     static std::vector<double> log_pct_change_simd(const std::vector<double>& prices, int window_size);
     static std::vector<double> calculate_momentum_simd(const std::vector<double>& prices, int period);
 
+    // Vector versions of the windowed TechnicalIndicators; per-bar terms run
+    // on the kernel table, recursive smoothing (RSI, OBV, EMAs) stays scalar
+    static std::vector<double> calculate_rsi_simd(const std::vector<double>& prices, int period);
+    static size_t internal_bar_strength_simd(const double* high, const double* low, const double* close, size_t n, double* out);
+    static std::vector<double> detrended_price_oscillator_simd(const std::vector<double>& prices, const std::vector<double>& sma, int window);
+    static std::vector<double> chande_momentum_oscillator_14_simd(const std::vector<double>& prices);
+    static std::vector<double> vortex_indicator_14_simd(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close);
+    static std::vector<double> adx_rating_14_simd(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close);
+    static std::vector<double> money_flow_index_14_simd(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, const std::vector<double>& volume);
+    static std::vector<double> on_balance_volume_sma_20_simd(const std::vector<double>& prices, const std::vector<double>& volume);
+    // Klinger's input: volume signed by the typical-price move, one row per bar after the first
+    static std::vector<double> klinger_signed_volume_simd(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, const std::vector<double>& volume);
+    static std::vector<double> klinger_oscillator_34_55_simd(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, const std::vector<double>& volume);
+    static std::vector<double> ulcer_index_14_simd(const std::vector<double>& prices);
+
+    // Span forms of the above for FeatureBlock columns: write to `out` (sized
+    // for the vector result) and return the count written; intermediates sit
+    // in per-thread scratch instead of fresh vectors
+    static size_t compute_spread_simd(const double* high, const double* low, size_t n, double* out);
+    static size_t linear_slope_simd(const double* prices, size_t n, int window_size, double* out);
+    static size_t log_pct_change_simd(const double* prices, size_t n, int window_size, double* out);
+    static size_t calculate_momentum_simd(const double* prices, size_t n, int period, double* out);
+    static size_t detrended_price_oscillator_simd(const double* prices, size_t n, const double* sma, size_t sma_n, int window, double* out);
+    static size_t chande_momentum_oscillator_14_simd(const double* prices, size_t n, double* out);
+    static size_t vortex_indicator_14_simd(const double* high, const double* low, const double* close, size_t n, double* out);
+    static size_t adx_rating_14_simd(const double* high, const double* low, const double* close, size_t n, double* out);
+    static size_t money_flow_index_14_simd(const double* high, const double* low, const double* close, const double* volume, size_t n, double* out);
+    static size_t on_balance_volume_sma_20_simd(const double* prices, const double* volume, size_t n, double* out);
+    static size_t ulcer_index_14_simd(const double* prices, size_t n, double* out);
+
+    // Recursive filters vectorized across series instead of time: series_lanes()
+    // equal-length series interleaved as data[t * lanes + s], `rows` time steps.
+    // On the scalar tier there is a single lane.
+    static size_t series_lanes();
+    static void ema_lanes(const double* data, size_t rows, int period, double* out);
+    static void kama_lanes(const double* prices, size_t rows, int l1, int l2, int l3, double* out);
+    // rows - 20 output rows, as garch_volatility_21
+    static void garch_volatility_21_lanes(const double* returns, size_t rows, double* out);
+
+    // float32 spans for a FeaturePrecision::Float32 block: twice the lanes per
+    // register, window sums accumulated in double. Return the count written.
+    static size_t log_pct_change_f32(const float* prices, size_t n, int window_size, float* out);
+    static size_t calculate_momentum_f32(const float* prices, size_t n, int period, float* out);
+    static size_t linear_slope_f32(const float* prices, size_t n, int window_size, float* out);
+
     static void process_multiple_series_parallel(
         const std::vector<std::vector<double>>& input_series,
         std::vector<std::vector<double>>& output_results,
         std::function<std::vector<double>(const std::vector<double>&)> processor
     );
 
+    // True when the active tier is AVX2 or AVX-512
     static bool is_simd_available();
 
-#if SIMD_ENABLED
     // SIMD helper functions
     static std::vector<double> simd_subtract_arrays(const std::vector<double>& a, const std::vector<double>& b);
     static std::vector<double> simd_divide_arrays(const std::vector<double>& a, const std::vector<double>& b);
     static double simd_sum_array(const std::vector<double>& data, size_t start, size_t count);
     static std::vector<double> simd_rolling_sum(const std::vector<double>& data, size_t window);
-#endif
 };
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "ohlcv_data.h"
+#include "rolling_moments.h"
+#include "regime_model.h"
+#include <vector>
+#include <deque>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+
+// Incremental feature engine for live sessions. Each on_bar() call appends to
+// the FeatureSet so that, after N bars, every column matches what
+// BatchOHLCProcessor::calculate_features() returns for the same N bars (up to
+// floating-point round-off). State is O(window) per indicator and most updates
+// are O(1); the percentile/CVaR windows are O(log window), and Hurst and ulcer
+// are O(window) but never touch the full history.
+//
+// Differences from the batch path:
+//  - The GARCH-filtered and regime HMM features always use the default
+//    parameters of GarchModel and RegimeModel; fitted parameters
+//    (BatchOHLCProcessor's `garch` and `regimes`) are a batch option.
+//  - kama_10_2_30, price_to_kama_ratio_20_10_30 and the regime HMM features
+//    are empty until the batch minimum length is reached, then the warm-up
+//    values are appended at once.
+//  - return_x_volume_interaction_10 and volatility_x_rsi_interaction_14 stay
+//    empty, as in the batch path where their input lengths never line up.
+class StreamingFeatureEngine {
+public:
+    StreamingFeatureEngine();
+
+    void on_bar(double open, double high, double low, double close, double volume);
+
+    const FeatureSet& features() const { return features_; }
+    size_t bar_count() const { return bars_; }
+    void reset();
+
+    // Moves the values appended since the last call into `out` (its previous
+    // contents are dropped, its capacity reused) and empties the columns.
+    // The indicator state is kept, so a series fed in chunks and drained
+    // after each one never holds more than a chunk of feature history; a
+    // column's values continue where the previous drain stopped.
+    void take_features(FeatureSet& out);
+
+private:
+    // Fixed-capacity history, ago(0) is the newest value
+    class History {
+    public:
+        explicit History(size_t capacity);
+        void push(double x);
+        double ago(size_t k) const;
+        size_t size() const { return count_; }
+    private:
+        std::vector<double> ring_;
+        size_t head_ = 0;   // slot of the next write
+        size_t count_ = 0;
+    };
+
+    // Sliding window sum, rebuilt from its buffer once per window
+    class RollingSum {
+    public:
+        explicit RollingSum(size_t window);
+        void push(double x);
+        bool full() const { return count_ == ring_.size(); }
+        double sum() const { return sum_; }
+    private:
+        std::vector<double> ring_;
+        size_t head_ = 0;
+        size_t count_ = 0;
+        size_t since_resync_ = 0;
+        double sum_ = 0.0;
+    };
+
+    // Running sums for the least-squares slope against x = 0..window-1
+    class RollingLinearFit {
+    public:
+        explicit RollingLinearFit(size_t window);
+        void push(double y);
+        bool full() const { return count_ == ring_.size(); }
+        double slope() const;
+    private:
+        std::vector<double> ring_;
+        size_t head_ = 0;
+        size_t count_ = 0;
+        size_t since_resync_ = 0;
+        double sum_y_ = 0.0, sum_xy_ = 0.0;
+    };
+
+    // Monotonic deque; reports the most recent occurrence of the extreme
+    class RollingExtreme {
+    public:
+        RollingExtreme(size_t window, bool track_max);
+        void push(double x);
+        bool full() const { return pushed_ >= window_; }
+        double value() const { return deque_.front().second; }
+        size_t index() const { return deque_.front().first; }
+    private:
+        size_t window_;
+        bool track_max_;
+        size_t pushed_ = 0;
+        std::deque<std::pair<size_t, double>> deque_;
+    };
+
+    // The window in value order for rank and tail queries: a treap with one
+    // node per ring slot, keyed by (value, push order), whose subtree sizes
+    // and sums make push, count_less and sum_smallest O(log window).
+    // Non-finite values hold their ring slot but stay out of the treap.
+    class SortedWindow {
+    public:
+        explicit SortedWindow(size_t window);
+        void push(double x);
+        bool full() const { return count_ == nodes_.size(); }
+        size_t count_less(double x) const;
+        double sum_smallest(size_t k) const;
+    private:
+        static constexpr uint32_t kNil = UINT32_MAX;
+        struct Node {
+            double value = 0.0;
+            uint64_t order = 0;
+            uint32_t priority = 0;
+            uint32_t left = kNil, right = kNil;
+            uint32_t size = 1;
+            double sum = 0.0;
+            bool linked = false;    // in the treap
+        };
+        void update(uint32_t t);
+        // a: keys below (value, order); b: the rest
+        void split(uint32_t t, double value, uint64_t order, uint32_t& a, uint32_t& b);
+        uint32_t merge(uint32_t a, uint32_t b);
+        uint32_t size(uint32_t t) const { return t == kNil ? 0 : nodes_[t].size; }
+        double sum(uint32_t t) const { return t == kNil ? 0.0 : nodes_[t].sum; }
+
+        std::vector<Node> nodes_;   // ring slots
+        uint32_t root_ = kNil;
+        size_t head_ = 0;
+        size_t count_ = 0;
+        uint64_t pushed_ = 0;
+        uint32_t seed_ = 2463534242u;
+    };
+
+    // Kaufman adaptive moving average with a rolling efficiency-ratio denominator
+    struct KamaState {
+        KamaState(int l1, int l2, int l3);
+        int l1;
+        double fast_sc, slow_sc;
+        double value = 0.0;
+        RollingSum abs_changes;
+        std::vector<double> warmup;
+    };
+
+    void on_return(double ret);
+    void update_regimes(double ret);
+    double update_kama(KamaState& state, double close);
+    double hurst_from_history();
+
+    FeatureSet features_;
+    size_t bars_ = 0;
+    size_t returns_ = 0;
+
+    History close_, high_, low_, typical_, return_history_;
+
+    // Close-based state
+    RollingSum close_sum_20_, volume_sum_20_, obv_sum_20_, parkinson_sum_20_;
+    RollingSum ac_x_, ac_y_, ac_xy_, ac_x2_, ac_y2_;
+    RollingSum cmo_up_, cmo_down_;
+    RollingSum vortex_vm_plus_, vortex_tr_, supertrend_tr_;
+    RollingSum mfi_positive_, mfi_negative_;
+    RollingSum adx_dm_plus_, adx_dm_minus_, adx_tr_;
+    RollingSum volume_sum_10_, volume_log_sum_10_;
+    RollingMoments close_moments_30_;
+    RollingLinearFit slope_20_, slope_60_;
+    SortedWindow percentile_window_;
+    RollingExtreme aroon_high_, aroon_low_;
+    RollingExtreme tenkan_high_, tenkan_low_, kijun_high_, kijun_low_;
+    RollingExtreme span_b_high_, span_b_low_, fisher_high_, fisher_low_;
+    RollingExtreme drawdown_peak_;
+    KamaState kama_10_, kama_20_;
+    RollingMoments vwap_deviation_30_;
+    double rsi_avg_gain_ = 0.0, rsi_avg_loss_ = 0.0;
+    double last_velocity_ = 0.0;
+    double ema1_ = 0.0, ema2_ = 0.0, ema3_ = 0.0;
+    double klinger_ema34_ = 0.0, klinger_ema55_ = 0.0;
+    double cumulative_pv_ = 0.0, cumulative_volume_ = 0.0;
+    double obv_ = 0.0;
+    double max_volume_ = 0.0, min_volume_ = 0.0;
+    double hvn_price_ = 0.0, lvn_price_ = 0.0;
+    bool hvn_found_ = false;
+
+    // Return-based state
+    RollingMoments return_moments_20_, return_moments_30_;
+    RollingMoments chow_prior_, chow_recent_;
+    RollingSum sortino_sum_, sortino_downside_, sortino_count_;
+    SortedWindow cvar_window_;
+    double garch_weighted_sq_ = 0.0;
+    double garch_variance_ = 0.0, garch_omega_ = 0.0;  // recursive filter (sum of squares during warm-up)
+    // Regime HMM filters, built from the first RegimeModel::kWarmup returns
+    std::optional<RegimeFilter> regime_2_, regime_3_;
+    std::vector<double> regime_warmup_;
+
+    std::vector<double> hurst_log_prices_, hurst_cumsum_;
+};
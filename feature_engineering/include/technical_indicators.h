@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include <utility>
+#include <cstddef>
 
 class TechnicalIndicators {
 public:
@@ -21,11 +22,20 @@ public:
     static std::vector<double> parkinson_volatility(const std::vector<double>& high, const std::vector<double>& low, int window_size);
 
     // Statistical/Mathematical
+    // The fixed-period columns z_score_20, vortex_indicator_14,
+    // money_flow_index_14, ulcer_index_14 and sortino_ratio_30 run the
+    // FixedWindow kernels; their variants with a period argument take any window.
     static std::vector<double> z_score_20(const std::vector<double>& returns);
+    static std::vector<double> z_score(const std::vector<double>& returns, int window);
     static std::vector<double> percentile_rank_50(const std::vector<double>& prices);
+    static std::vector<double> percentile_rank(const std::vector<double>& prices, int window);
     static std::vector<double> coefficient_of_variation_30(const std::vector<double>& returns);
     static std::vector<double> detrended_price_oscillator_20(const std::vector<double>& prices);
+    // `sma` is simple_moving_average(prices, window)
+    static std::vector<double> detrended_price_oscillator(const std::vector<double>& prices, const std::vector<double>& sma, int window);
     static std::vector<double> hurst_exponent_100(const std::vector<double>& prices);
+    // R/S Hurst over `window` bars; with `lags`, the slope across those scales (see RollingHurst)
+    static std::vector<double> hurst_exponent(const std::vector<double>& prices, size_t window, const std::vector<size_t>& lags = {});
     static std::vector<double> garch_volatility_21(const std::vector<double>& returns);
     static std::vector<double> shannon_entropy_volume_10(const std::vector<double>& volume);
 
@@ -33,7 +43,10 @@ public:
     static std::vector<double> chande_momentum_oscillator_14(const std::vector<double>& prices);
     static std::vector<double> aroon_oscillator_25(const std::vector<double>& high, const std::vector<double>& low);
     static std::vector<double> trix_15(const std::vector<double>& prices);
+    // `ema3` is the third EMA stage of the TRIX cascade
+    static std::vector<double> trix_from_triple_ema(const std::vector<double>& ema3);
     static std::vector<double> vortex_indicator_14(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close);
+    static std::vector<double> vortex_indicator(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, int period);
     static std::vector<double> supertrend_10_3(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close);
     static std::vector<double> ichimoku_senkou_span_A_9_26(const std::vector<double>& high, const std::vector<double>& low);
     static std::vector<double> ichimoku_senkou_span_B_26_52(const std::vector<double>& high, const std::vector<double>& low);
@@ -46,7 +59,10 @@ public:
     static std::vector<double> on_balance_volume_sma_20(const std::vector<double>& prices, const std::vector<double>& volume);
     static std::vector<double> klinger_oscillator_34_55(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, const std::vector<double>& volume);
     static std::vector<double> money_flow_index_14(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, const std::vector<double>& volume);
+    static std::vector<double> money_flow_index(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, const std::vector<double>& volume, int period);
     static std::vector<double> vwap_deviation_stddev_30(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, const std::vector<double>& volume);
+    // `vwap` is volume_weighted_average_price_intraday() of the same bars
+    static std::vector<double> vwap_deviation_stddev(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, const std::vector<double>& vwap, int window);
 
     // Cross-Sectional/Relative
     static std::vector<double> relative_strength_spx_50(const std::vector<double>& prices, const std::vector<double>& spx_prices);
@@ -57,11 +73,15 @@ public:
     static std::vector<double> pair_spread_vs_competitor_A_30(const std::vector<double>& prices, const std::vector<double>& competitor_prices);
 
     // Regime Detection
+    // Filtered probability of the high-variance state of a 2-state
+    // RegimeModel with default parameters; empty below RegimeModel::kWarmup returns
     static std::vector<double> markov_regime_switching_garch_2_state(const std::vector<double>& returns);
     static std::vector<double> adx_rating_14(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close);
     static std::vector<double> chow_test_statistic_breakpoint_detection_50(const std::vector<double>& returns);
-    static std::vector<double> market_regime_hmm_3_states_price_vol(const std::vector<double>& prices, const std::vector<double>& volatility);
+    // Most probable state of the same 3-state filter: 0 calm, 1 normal, 2 turbulent
+    static std::vector<double> market_regime_hmm_3_states_price_vol(const std::vector<double>& returns);
     static std::vector<double> high_volatility_indicator_garch_threshold(const std::vector<double>& returns, double threshold);
+    static std::vector<double> volatility_threshold_indicator(const std::vector<double>& volatility, double threshold);
 
     // Market Microstructure
     static std::vector<double> bid_ask_spread_volatility_10(const std::vector<double>& bid_ask_spread);
@@ -86,15 +106,78 @@ public:
     static std::vector<double> return_x_volume_interaction_10(const std::vector<double>& returns, const std::vector<double>& volume);
     static std::vector<double> volatility_x_rsi_interaction_14(const std::vector<double>& volatility, const std::vector<double>& rsi);
     static std::vector<double> price_to_kama_ratio_20_10_30(const std::vector<double>& prices);
+    static std::vector<double> price_to_kama_ratio(const std::vector<double>& prices, const std::vector<double>& kama_values);
     static std::vector<double> polynomial_regression_price_degree_2_slope(const std::vector<double>& prices, int window);
 
     // Alternative Risk Measures
     static std::vector<double> conditional_value_at_risk_cvar_95_20(const std::vector<double>& returns);
+    static std::vector<double> conditional_value_at_risk(const std::vector<double>& returns, int window, double tail_fraction = 0.05);
     static std::vector<double> drawdown_duration_from_peak_50(const std::vector<double>& prices);
     static std::vector<double> ulcer_index_14(const std::vector<double>& prices);
+    static std::vector<double> ulcer_index(const std::vector<double>& prices, int period);
     static std::vector<double> sortino_ratio_30(const std::vector<double>& returns);
+    static std::vector<double> sortino_ratio(const std::vector<double>& returns, int window);
+
+    // Rolling extrema over full windows (output[k] covers data[k .. k+window-1]).
+    // Arg variants return the index of the most recent occurrence of the extreme.
+    static std::vector<size_t> rolling_argmax(const std::vector<double>& data, int window);
+    static std::vector<size_t> rolling_argmin(const std::vector<double>& data, int window);
+    static std::vector<double> rolling_max(const std::vector<double>& data, int window);
+    static std::vector<double> rolling_min(const std::vector<double>& data, int window);
+    static std::vector<size_t> rolling_argmax(const double* data, size_t n, int window);
+    static std::vector<size_t> rolling_argmin(const double* data, size_t n, int window);
+
+    // Span variants writing into caller-owned storage such as a FeatureBlock
+    // column. Each returns the number of values written (0 if `n` is too short)
+    // and produces the same values as its vector counterpart.
+    static size_t calculate_returns(const double* prices, size_t n, double* out);
+    static size_t simple_moving_average(const double* data, size_t n, size_t window, double* out);
+    static size_t calculate_rolling_volatility(const double* returns, size_t n, int window, double* out);
+    static size_t compute_spread(const double* high, const double* low, size_t n, double* out);
+    static size_t internal_bar_strength(const double* high, const double* low, const double* close, size_t n, double* out);
+    static size_t log_pct_change(const double* prices, size_t n, int window_size, double* out);
+    static size_t momentum(const double* prices, size_t n, int period, double* out);
+    static size_t linear_slope(const double* prices, size_t n, int window_size, double* out);
+    static size_t skewness(const double* prices, size_t n, int window_size, double* out);
+    static size_t kurtosis(const double* prices, size_t n, int window_size, double* out);
+    static size_t hurst_exponent_100(const double* prices, size_t n, double* out);
+    static size_t adx_rating_14(const double* high, const double* low, const double* close, size_t n, double* out);
+    // candle_information() split per column; candle_way is -1, 0 or 1
+    static size_t candle_way(const double* open, const double* close, size_t n, double* out);
+    static size_t candle_filling(const double* open, const double* high, const double* low, const double* close, size_t n, double* out);
+    static size_t candle_amplitude(const double* high, const double* low, size_t n, double* out);
+    // derivatives() split per column
+    static size_t velocity(const double* prices, size_t n, double* out);
+    static size_t acceleration(const double* prices, size_t n, double* out);
+    static size_t auto_correlation(const double* prices, size_t n, int window_size, int lag, double* out);
+    static size_t parkinson_volatility(const double* high, const double* low, size_t n, int window_size, double* out);
+    static size_t percentile_rank(const double* prices, size_t n, int window, double* out);
+    static size_t coefficient_of_variation_30(const double* returns, size_t n, double* out);
+    static size_t detrended_price_oscillator(const double* prices, size_t n, const double* sma, size_t sma_n, int window, double* out);
+    static size_t shannon_entropy_volume_10(const double* volume, size_t n, double* out);
+    static size_t chande_momentum_oscillator_14(const double* prices, size_t n, double* out);
+    static size_t aroon_oscillator_25(const double* high, const double* low, size_t n, double* out);
+    static size_t trix_from_triple_ema(const double* ema3, size_t n, double* out);
+    static size_t supertrend_10_3(const double* high, const double* low, const double* close, size_t n, double* out);
+    static size_t ichimoku_senkou_span_A_9_26(const double* high, const double* low, size_t n, double* out);
+    static size_t ichimoku_senkou_span_B_26_52(const double* high, const double* low, size_t n, double* out);
+    static size_t fisher_transform_10(const double* high, const double* low, size_t n, double* out);
+    static size_t volume_profile_high_volume_node_intraday(const double* prices, const double* volume, size_t n, double* out);
+    static size_t volume_profile_low_volume_node_intraday(const double* prices, const double* volume, size_t n, double* out);
+    static size_t on_balance_volume_sma_20(const double* prices, const double* volume, size_t n, double* out);
+    static size_t vwap_deviation_stddev(const double* high, const double* low, const double* close, const double* vwap, size_t n, int window, double* out);
+    static size_t chow_test_statistic_breakpoint_detection_50(const double* returns, size_t n, double* out);
+    static size_t volatility_threshold_indicator(const double* volatility, size_t n, double threshold, double* out);
+    static size_t return_x_volume_interaction_10(const double* returns, const double* volume, size_t n, double* out);
+    static size_t volatility_x_rsi_interaction_14(const double* volatility, const double* rsi, size_t n, double* out);
+    static size_t price_to_kama_ratio(const double* prices, const double* kama_values, size_t n, double* out);
+    static size_t polynomial_regression_price_degree_2_slope(const double* prices, size_t n, int window, double* out);
+    static size_t conditional_value_at_risk(const double* returns, size_t n, int window, double tail_fraction, double* out);
+    static size_t drawdown_duration_from_peak_50(const double* prices, size_t n, double* out);
+
+    // EMA seeded with the first value, same length as the input
+    static std::vector<double> exponential_moving_average(const std::vector<double>& data, int period);
 
 private:
     static double calculate_atr(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, int period, size_t index);
-    static std::vector<double> exponential_moving_average(const std::vector<double>& data, int period);
 };
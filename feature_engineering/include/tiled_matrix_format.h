@@ -0,0 +1,127 @@
+#pragma once
+#include "mapped_file.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// MFT tiled matrix file (.mftm), version 1, host (little-endian) byte order:
+// a symbol x symbol matrix with one or more float32 layers (correlation,
+// cointegration p-value, ...), each stored as a pyramid of square tiles so a
+// viewer maps the file and reads only the tiles it shows.
+//
+//   offset 0        TiledMatrixHeader (64 bytes)
+//   names_offset    `size` NUL-terminated symbols, in matrix order
+//   layers_offset   layer_count TiledMatrixLayer records (64 bytes each)
+//   data_offset     per layer: its levels, finest first, 64-byte aligned
+//
+// Level 0 holds every cell. Each further level halves the side (rounding
+// up), a cell standing for a 2 x 2 block of the level below, until one
+// tile covers the level. A level of side s is ceil(s / tile) tiles square,
+// stored row-major, each tile x tile floats, row-major. Cells past the
+// matrix edge, and pairs never computed, are NaN.
+constexpr char kTiledMatrixMagic[8] = {'M', 'F', 'T', 'M', 'A', 'T', 'R', 'X'};
+constexpr uint32_t kTiledMatrixVersion = 1;
+constexpr uint32_t kTiledMatrixTile = 256;
+constexpr const char* kTiledMatrixExtension = ".mftm";
+
+// How a coarser cell sums up its 2 x 2 block, NaN cells ignored
+enum class MatrixReduction : uint32_t {
+    LargestMagnitude = 0,   // the value furthest from zero (correlations)
+    Minimum = 1,            // the smallest value (p-values)
+};
+
+struct TiledMatrixHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t size;              // symbols per side
+    uint32_t tile;              // tile side in cells
+    uint32_t level_count;
+    uint32_t layer_count;
+    uint32_t reserved0;
+    uint64_t names_offset;
+    uint64_t names_bytes;
+    uint64_t layers_offset;
+    uint8_t reserved[8];
+};
+static_assert(sizeof(TiledMatrixHeader) == 64, "TiledMatrixHeader layout is part of the file format");
+
+struct TiledMatrixLayer {
+    char name[40];              // NUL-terminated
+    uint32_t reduction;         // MatrixReduction
+    uint32_t reserved;
+    float display_min;          // value range a colormap spans
+    float display_max;
+    uint64_t data_offset;
+};
+static_assert(sizeof(TiledMatrixLayer) == 64, "TiledMatrixLayer layout is part of the file format");
+
+// Side of `level` of a matrix of `size` symbols
+inline size_t tiled_matrix_side(size_t size, uint32_t level) {
+    return (size + (size_t(1) << level) - 1) >> level;
+}
+
+// Levels of a pyramid that ends at the first level one tile covers
+inline uint32_t tiled_matrix_levels(size_t size, size_t tile) {
+    uint32_t levels = 1;
+    while (tiled_matrix_side(size, levels - 1) > tile) ++levels;
+    return levels;
+}
+
+// Tiles per side of `level`
+inline size_t tiled_matrix_tiles(size_t size, size_t tile, uint32_t level) {
+    return (tiled_matrix_side(size, level) + tile - 1) / tile;
+}
+
+// Bytes of one layer's pyramid, every level included
+inline size_t tiled_matrix_layer_bytes(size_t size, size_t tile, uint32_t levels) {
+    size_t bytes = 0;
+    for (uint32_t level = 0; level < levels; ++level) {
+        const size_t tiles = tiled_matrix_tiles(size, tile, level);
+        bytes += tiles * tiles * tile * tile * sizeof(float);
+    }
+    return bytes;
+}
+
+// Read-only view of a .mftm file. The file is held in a MappedFile and tile
+// accessors point straight into it; nothing is copied.
+class TiledMatrixFile {
+public:
+    // Throws std::runtime_error if the file cannot be opened or is malformed
+    explicit TiledMatrixFile(const std::string& filepath);
+    TiledMatrixFile(const TiledMatrixFile&) = delete;
+    TiledMatrixFile& operator=(const TiledMatrixFile&) = delete;
+
+    size_t size() const { return size_; }
+    size_t tile() const { return tile_; }
+    uint32_t levels() const { return levels_; }
+    size_t layer_count() const { return layers_.size(); }
+
+    const char* symbol(size_t index) const { return symbols_[index]; }
+    const char* layer_name(size_t layer) const { return layers_[layer]->name; }
+    MatrixReduction reduction(size_t layer) const { return static_cast<MatrixReduction>(layers_[layer]->reduction); }
+    float display_min(size_t layer) const { return layers_[layer]->display_min; }
+    float display_max(size_t layer) const { return layers_[layer]->display_max; }
+
+    size_t side(uint32_t level) const { return tiled_matrix_side(size_, level); }
+    size_t tiles(uint32_t level) const { return tiled_matrix_tiles(size_, tile_, level); }
+
+    // Tile (row, col) of a level: tile() x tile() floats, row-major
+    const float* tile_data(size_t layer, uint32_t level, size_t row, size_t col) const;
+    // Cell (row, col) of a level
+    float value(size_t layer, uint32_t level, size_t row, size_t col) const;
+
+    // True when `filepath` has the .mftm extension
+    static bool is_matrix_path(const std::string& filepath);
+
+private:
+    MappedFile file_;
+    const uint8_t* data_ = nullptr;
+
+    size_t size_ = 0;
+    size_t tile_ = 0;
+    uint32_t levels_ = 0;
+    std::vector<const char*> symbols_;          // into the file
+    std::vector<const TiledMatrixLayer*> layers_;
+    std::vector<size_t> level_offsets_;         // from a layer's data_offset
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Decodes "YYYY-MM-DD HH:MM:SS" and "YYYY-MM-DD" timestamps with the same
+// result as std::get_time followed by std::mktime on a tm with tm_isdst = 0
+// (the historical FastCSVReader behaviour), but without a locale stream or
+// mktime() per row. The date part is memoized across consecutive rows and
+// turned into a day number with days_from_civil; the local-to-UTC offset is
+// looked up with mktime() once per calendar month and used for the whole
+// month when the mapping is a straight line over it (with tm_isdst = 0 it
+// normally is; otherwise rows fall back to mktime). Anything that is not
+// fixed-layout goes through the original std::get_time path.
+class TimestampDecoder {
+public:
+    using time_point = std::chrono::system_clock::time_point;
+
+    time_point decode(const char* text, size_t length);
+    time_point decode(std::string_view text) { return decode(text.data(), text.size()); }
+
+    // Decodes a whole column, appending to `out`
+    void decode_column(const std::vector<std::string_view>& fields, std::vector<time_point>& out);
+
+    // std::get_time + std::mktime, kept for inputs outside the fixed layout
+    static time_point decode_slow(const std::string& text);
+
+private:
+    bool set_date(const char* text);
+    int64_t to_time_t(int hour, int minute, int second) const;
+
+    char cached_date_[10] = {};
+    bool has_date_ = false;
+    int64_t days_ = 0;               // days since 1970-01-01 of the cached date
+    int year_ = 0, month_ = 0, day_ = 0;
+
+    int64_t offset_month_ = INT64_MIN;  // year * 12 + month the offset below belongs to
+    int64_t offset_ = 0;                // civil seconds minus time_t over that month
+    bool linear_month_ = false;
+};
@@ -0,0 +1,94 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Span tracing for stages, stocks, pair batches and lock waits, exported as
+// Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+//
+// Every thread appends to its own buffer of fixed-size chunks, so recording
+// takes no lock: a clock read and a store per span. Buffers outlive their
+// threads until reset_trace(). Names and categories must be string literals
+// (or otherwise outlive the trace). When tracing is off a span costs one
+// relaxed load.
+void set_tracing(bool enabled);
+bool tracing_enabled();
+
+// Clock shared by every span, nanoseconds
+uint64_t trace_now_ns();
+
+// Adds one completed span on the calling thread; `arg` (e.g. a stock or
+// task index) is exported unless negative
+void trace_record(const char* name, const char* category, uint64_t start_ns, uint64_t end_ns,
+                  int64_t arg = -1);
+
+// Adds a sample of named values at the current time, exported as a counter
+// track (e.g. memory in use per subsystem); names must be string literals
+void trace_counter(const char* name, const std::vector<std::pair<const char*, double>>& values);
+
+// Label for the calling thread's row in the trace
+void set_trace_thread_name(const std::string& name);
+
+// Records [construction, end()) or [construction, destruction)
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, const char* category = "stage", int64_t arg = -1)
+        : name_(name), category_(category), arg_(arg), start_ns_(tracing_enabled() ? trace_now_ns() : 0) {}
+    ~TraceSpan() { end(); }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    void end() {
+        if (start_ns_) trace_record(name_, category_, start_ns_, trace_now_ns(), arg_);
+        start_ns_ = 0;
+    }
+
+private:
+    const char* name_;
+    const char* category_;
+    int64_t arg_;
+    uint64_t start_ns_;
+};
+
+// Acquires a deferred lock (std::unique_lock / std::shared_lock), recording
+// a "lock" span under `name` only when the mutex was contended
+template <class Lock>
+void lock_traced(Lock& lock, const char* name) {
+    if (!tracing_enabled()) {
+        lock.lock();
+        return;
+    }
+    if (lock.try_lock()) return;
+    const uint64_t start = trace_now_ns();
+    lock.lock();
+    trace_record(name, "lock", start, trace_now_ns());
+}
+
+// Span durations of one name and category. buckets[b] counts spans of
+// [2^b, 2^(b+1)) microseconds, bucket 0 also holding those under 1 us.
+struct TraceLatency {
+    std::string name;
+    std::string category;
+    size_t count = 0;
+    double total_ms = 0.0;
+    double p50_us = 0.0;
+    double p90_us = 0.0;
+    double p99_us = 0.0;
+    double max_us = 0.0;
+    std::vector<size_t> buckets;
+};
+
+// Latencies of every recorded span, largest total first. Call once the
+// traced work has finished.
+std::vector<TraceLatency> trace_latencies();
+// One line per name: count, total, p50 / p90 / p99 / max
+void print_trace_latencies(const char* title);
+
+// Writes every recorded span and counter sample, plus thread names, as
+// Chrome trace JSON; throws std::runtime_error when the file cannot be written
+void write_chrome_trace(const std::string& path);
+
+// Drops every recorded span and restarts the trace clock's origin
+void reset_trace();
@@ -0,0 +1,38 @@
+#pragma once
+#include "feature_selection.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// The window-length indicators of a WindowSweepSelection (sma, volatility,
+// z_score, linear_slope) for every window of the list in one pass per
+// series, instead of one pass per window. The closes and their returns are
+// cut into blocks of output rows; each block builds the prefix sums of x,
+// x^2 and t * x over itself plus the longest window's lookback, and every
+// window reads its rows off them (SimdKernels::prefix_window_stats) while
+// the block is still in cache. Prefix sums restart at each block, relative
+// to its first value, so their round-off stays that of a block and not of
+// the series.
+//
+// Values follow the single-window functions: simple_moving_average and
+// linear_slope over the closes, calculate_rolling_volatility (sample
+// standard deviation) and the z_score_20 definition over the returns. A
+// window whose values are all equal has volatility and z-score 0.
+class WindowSweep {
+public:
+    struct Column {
+        SweepIndicator indicator;
+        size_t window;
+        size_t offset;                  // input row of values[0]
+        std::vector<double> values;     // empty when the series is shorter than the window
+
+        // "<indicator>_<window>"
+        std::string name() const;
+    };
+
+    // One column per selected indicator and window, indicator-major and then
+    // by ascending window. Resizes `columns`, reusing its vectors.
+    static void compute(const std::vector<double>& close, const WindowSweepSelection& selection,
+                        std::vector<Column>& columns);
+    static std::vector<Column> compute(const std::vector<double>& close, const WindowSweepSelection& selection);
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <functional>
+#include <cstddef>
+
+// Per-worker counters collected by WorkStealingPool::run()
+struct WorkerStats {
+    size_t tasks = 0;       // tasks executed by this worker
+    size_t steals = 0;      // tasks taken from another worker's queue
+    double busy_ms = 0.0;   // time spent inside task bodies
+};
+
+struct PoolStats {
+    double wall_ms = 0.0;
+    std::vector<WorkerStats> workers;
+
+    size_t total_tasks() const;
+    size_t total_steals() const;
+    // Sum of busy time over workers * wall time, in [0, 1]
+    double utilization() const;
+    // Slowest worker's busy time over the mean busy time (1.0 = perfectly balanced)
+    double imbalance() const;
+};
+
+// Runs a fixed set of indexed tasks on a group of threads. Tasks are sorted
+// largest-cost first and dealt round-robin into per-worker deques; a worker
+// pops from the front of its own deque and, once empty, steals from the back
+// of the others so a few long tasks cannot leave the rest of the cores idle.
+// With NUMA placement active (numa_topology.h) each worker is pinned to its
+// node for the run and steals from workers on the same node first.
+class WorkStealingPool {
+public:
+    using Task = std::function<void(size_t task, unsigned worker)>;
+
+    explicit WorkStealingPool(unsigned num_threads);
+
+    unsigned size() const { return num_threads_; }
+
+    // NUMA node worker `worker` runs on; 0 unless placement is active
+    unsigned node_of(unsigned worker) const;
+
+    // Name of each task's span when tracing is on (trace.h); a string literal
+    void set_trace_label(const char* label) { trace_label_ = label; }
+
+    // Executes task(i, worker) for every i in [0, costs.size()) and blocks
+    // until all are done. `costs` only orders the work (e.g. bytes or rows).
+    PoolStats run(const std::vector<size_t>& costs, const Task& task);
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    bool pop_local(WorkerQueue& queue, size_t& task);
+    bool steal(unsigned thief, size_t& task);
+
+    unsigned num_threads_;
+    std::vector<WorkerQueue> queues_;
+    const char* trace_label_ = "task";
+};
+
+// Prints a short load-balance summary for a finished phase
+void print_pool_stats(const char* phase, const PoolStats& stats);
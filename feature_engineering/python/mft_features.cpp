@@ -0,0 +1,241 @@
+// mft_features: the feature engine as a Python extension module.
+//
+//   import numpy as np, mft_features
+//   cols = mft_features.compute(o, h, l, c, v, features="returns,rsi")
+//   cols["rsi"]                # float64 ndarray over the C++ FeatureBlock
+//
+// Series go in as any float64 buffer or Arrow array (see mft_python.h) and
+// the GIL is released while the features are computed. Each feature comes
+// back as a NumPy view (a memoryview without NumPy) over the storage the
+// engine filled, so no column is copied or formatted. Column k starts at bar
+// feature_offsets()[k] of the input, as in the CSV output.
+#include "mft_python.h"
+#include "batch_ohlc_processor.h"
+#include "feature_block.h"
+#include "feature_selection.h"
+#include <stdexcept>
+
+namespace {
+
+// None = every feature; a comma-separated string or a sequence of names
+bool parse_selection(PyObject* object, FeatureMask& mask) {
+    if (!object || object == Py_None) {
+        mask = all_features();
+        return true;
+    }
+    std::string list;
+    if (PyUnicode_Check(object)) {
+        const char* text = PyUnicode_AsUTF8(object);
+        if (!text) return false;
+        list = text;
+    } else {
+        PyObject* items = PySequence_Fast(object, "features: expected a string or a sequence of names");
+        if (!items) return false;
+        for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(items); ++i) {
+            const char* name = PyUnicode_AsUTF8(PySequence_Fast_GET_ITEM(items, i));
+            if (!name) {
+                Py_DECREF(items);
+                return false;
+            }
+            list += name;
+            list += ',';
+        }
+        Py_DECREF(items);
+    }
+    try {
+        mask = parse_feature_list(list);
+    } catch (const std::exception& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return false;
+    }
+    return true;
+}
+
+bool parse_precision(const char* text, FeaturePrecision& precision) {
+    const std::string name = text ? text : "float64";
+    if (name == "float64") {
+        precision = FeaturePrecision::Float64;
+    } else if (name == "float32") {
+        precision = FeaturePrecision::Float32;
+    } else {
+        PyErr_Format(PyExc_ValueError, "precision: expected 'float64' or 'float32', got '%s'", text);
+        return false;
+    }
+    return true;
+}
+
+struct OHLCVInputs {
+    std::vector<double> open, high, low, close, volume;
+};
+
+bool read_inputs(PyObject* const args[5], OHLCVInputs& in) {
+    if (!py_read_series(args[0], "open", in.open) || !py_read_series(args[1], "high", in.high) ||
+        !py_read_series(args[2], "low", in.low) || !py_read_series(args[3], "close", in.close) ||
+        !py_read_series(args[4], "volume", in.volume)) {
+        return false;
+    }
+    const size_t n = in.close.size();
+    if (in.open.size() != n || in.high.size() != n || in.low.size() != n || in.volume.size() != n) {
+        PyErr_SetString(PyExc_ValueError, "open, high, low, close and volume must have the same length");
+        return false;
+    }
+    return true;
+}
+
+// The block compute() filled; its columns are the views handed out
+struct BlockResult {
+    explicit BlockResult(FeaturePrecision precision) : block(precision) {}
+    FeatureBlock block;
+};
+
+PyObject* compute(PyObject*, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"open", "high", "low", "close", "volume", "features", "precision", "fusion", nullptr};
+    PyObject* series[5];
+    PyObject* features = nullptr;
+    const char* precision_name = "float64";
+    int fusion = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOOOO|$Ozp:compute", const_cast<char**>(keywords),
+                                     &series[0], &series[1], &series[2], &series[3], &series[4],
+                                     &features, &precision_name, &fusion)) {
+        return nullptr;
+    }
+    FeatureMask mask;
+    FeaturePrecision precision;
+    OHLCVInputs in;
+    if (!parse_selection(features, mask) || !parse_precision(precision_name, precision) || !read_inputs(series, in)) {
+        return nullptr;
+    }
+
+    auto result = std::make_unique<BlockResult>(precision);
+    FeatureBlock& block = result->block;
+    const bool ok = py_without_gil([&] {
+        BatchOHLCProcessor processor;
+        processor.set_loop_fusion(fusion != 0);
+        processor.calculate_features_into(in.open, in.high, in.low, in.close, in.volume, block, false, mask);
+    });
+    if (!ok) return nullptr;
+
+    PyObject* owner = py_owner(std::move(result));
+    if (!owner) return nullptr;
+    PyObject* columns = PyDict_New();
+    for (size_t f = 0; columns && f < kFeatureCount; ++f) {
+        const Feature feature = static_cast<Feature>(f);
+        if (!is_selected(mask, feature)) continue;
+        PyObject* column = precision == FeaturePrecision::Float32
+                               ? py_column(owner, block.column_f32(feature), block.length(feature))
+                               : py_column(owner, block.column(feature), block.length(feature));
+        if (!py_set_item(columns, feature_name(feature), column)) Py_CLEAR(columns);
+    }
+    Py_DECREF(owner);
+    return columns;
+}
+
+PyObject* batch_compute(PyObject*, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"opens", "highs", "lows", "closes", "volumes", "features", "fusion", nullptr};
+    PyObject* lists[5];
+    PyObject* features = nullptr;
+    int fusion = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOOOO|$Op:batch_compute", const_cast<char**>(keywords),
+                                     &lists[0], &lists[1], &lists[2], &lists[3], &lists[4], &features, &fusion)) {
+        return nullptr;
+    }
+    FeatureMask mask;
+    std::vector<std::vector<double>> open, high, low, close, volume;
+    if (!parse_selection(features, mask) || !py_read_series_list(lists[0], "opens", open) ||
+        !py_read_series_list(lists[1], "highs", high) || !py_read_series_list(lists[2], "lows", low) ||
+        !py_read_series_list(lists[3], "closes", close) || !py_read_series_list(lists[4], "volumes", volume)) {
+        return nullptr;
+    }
+    const size_t count = close.size();
+    if (open.size() != count || high.size() != count || low.size() != count || volume.size() != count) {
+        PyErr_SetString(PyExc_ValueError, "opens, highs, lows, closes and volumes must hold the same number of series");
+        return nullptr;
+    }
+    for (size_t s = 0; s < count; ++s) {
+        const size_t n = close[s].size();
+        if (open[s].size() != n || high[s].size() != n || low[s].size() != n || volume[s].size() != n) {
+            PyErr_Format(PyExc_ValueError, "series %zu: open, high, low, close and volume must have the same length", s);
+            return nullptr;
+        }
+    }
+
+    auto results = std::make_unique<std::vector<std::unique_ptr<FeatureBlock>>>();
+    const bool ok = py_without_gil([&] {
+        BatchOHLCProcessor processor;
+        processor.set_loop_fusion(fusion != 0);
+        processor.batch_calculate_features_into(open, high, low, close, volume, *results, false, mask);
+    });
+    if (!ok) return nullptr;
+
+    const std::vector<std::unique_ptr<FeatureBlock>>& blocks = *results;
+    PyObject* owner = py_owner(std::move(results));
+    if (!owner) return nullptr;
+    PyObject* out = PyList_New(static_cast<Py_ssize_t>(blocks.size()));
+    for (size_t s = 0; out && s < blocks.size(); ++s) {
+        const FeatureBlock& block = *blocks[s];
+        PyObject* columns = PyDict_New();
+        for (size_t f = 0; columns && f < kFeatureCount; ++f) {
+            const Feature feature = static_cast<Feature>(f);
+            if (!is_selected(mask, feature)) continue;
+            if (!py_set_item(columns, feature_name(feature), py_column(owner, block.column(feature), block.length(feature)))) {
+                Py_CLEAR(columns);
+            }
+        }
+        if (!columns) {
+            Py_CLEAR(out);
+            break;
+        }
+        PyList_SET_ITEM(out, static_cast<Py_ssize_t>(s), columns);
+    }
+    Py_DECREF(owner);
+    return out;
+}
+
+PyObject* feature_names_py(PyObject*, PyObject*) {
+    PyObject* names = PyList_New(static_cast<Py_ssize_t>(kFeatureCount));
+    for (size_t f = 0; names && f < kFeatureCount; ++f) {
+        PyObject* name = PyUnicode_FromString(feature_name(static_cast<Feature>(f)));
+        if (!name) {
+            Py_CLEAR(names);
+            break;
+        }
+        PyList_SET_ITEM(names, static_cast<Py_ssize_t>(f), name);
+    }
+    return names;
+}
+
+PyObject* feature_offsets(PyObject*, PyObject*) {
+    PyObject* offsets = PyDict_New();
+    for (size_t f = 0; offsets && f < kFeatureCount; ++f) {
+        const Feature feature = static_cast<Feature>(f);
+        if (!py_set_item(offsets, feature_name(feature), PyLong_FromSize_t(feature_row_offset(feature)))) {
+            Py_CLEAR(offsets);
+        }
+    }
+    return offsets;
+}
+
+PyMethodDef methods[] = {
+    {"compute", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(compute)), METH_VARARGS | METH_KEYWORDS,
+     "compute(open, high, low, close, volume, *, features=None, precision='float64', fusion=True)\n"
+     "Features of one series as {name: column}, columns viewing one FeatureBlock."},
+    {"batch_compute", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(batch_compute)),
+     METH_VARARGS | METH_KEYWORDS,
+     "batch_compute(opens, highs, lows, closes, volumes, *, features=None, fusion=True)\n"
+     "Features of many series (equal-length ones lane-grouped) as a list of {name: column}."},
+    {"feature_names", feature_names_py, METH_NOARGS, "Every feature column name, in output order."},
+    {"feature_offsets", feature_offsets, METH_NOARGS, "{name: first input bar of that column}."},
+    {nullptr, nullptr, 0, nullptr},
+};
+
+PyModuleDef module = {
+    PyModuleDef_HEAD_INIT, "mft_features",
+    "MFT feature engine: OHLCV series in, feature columns out as views over C++ storage.",
+    -1, methods, nullptr, nullptr, nullptr, nullptr,
+};
+
+} // namespace
+
+PyMODINIT_FUNC PyInit_mft_features() {
+    return PyModule_Create(&module);
+}
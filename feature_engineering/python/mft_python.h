@@ -0,0 +1,325 @@
+#pragma once
+
+// Helpers shared by the CPython extension modules (mft_features here,
+// mft_pairs in arbitrage). They use the plain C API and the buffer protocol,
+// so the modules build against Python's headers alone; NumPy and pyarrow are
+// used at run time when installed, never at build time.
+//
+// Inputs: any 1-D float64 buffer exporter (NumPy arrays and their strided
+// slices, memoryview, array.array('d'), pyarrow.Buffer) or Arrow C Data
+// Interface exporter (pyarrow.Array, polars Series, ...). The engines take
+// std::vector series, so each input is copied once into one; nothing goes
+// through text.
+//
+// Outputs: columns are views over the C++ storage that computed them (a
+// FeatureBlock, a result vector). An owner object keeps that storage alive
+// for as long as any view of it is reachable; no column is copied.
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+// --- Arrow C Data Interface (ABI-stable structs, as the spec asks) ---
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+#endif
+
+// --- Owners ---
+
+// Capsule that deletes `value` when the last reference to it goes
+template <class T>
+PyObject* py_owner(std::unique_ptr<T> value) {
+    PyObject* capsule = PyCapsule_New(value.get(), "mft.owner", [](PyObject* self) {
+        delete static_cast<T*>(PyCapsule_GetPointer(self, "mft.owner"));
+    });
+    if (capsule) value.release();
+    return capsule;
+}
+
+template <class T>
+T* py_owned(PyObject* owner) {
+    return static_cast<T*>(PyCapsule_GetPointer(owner, "mft.owner"));
+}
+
+// --- Column views ---
+
+// Buffer exporter over `length` values at `data`, holding a reference to
+// the owner of that memory
+struct PyColumnView {
+    PyObject_HEAD
+    PyObject* owner;
+    void* data;
+    Py_ssize_t shape[1];
+    Py_ssize_t strides[1];
+    const char* format;     // struct-module code: "d", "f", "i" or "q"
+};
+
+inline PyTypeObject* py_column_view_type() {
+    static PyTypeObject type = [] {
+        PyTypeObject t{};
+        Py_SET_REFCNT(&t, 1);
+        static PyBufferProcs buffer_procs{};
+        buffer_procs.bf_getbuffer = [](PyObject* self, Py_buffer* view, int flags) -> int {
+            auto* column = reinterpret_cast<PyColumnView*>(self);
+            view->obj = self;
+            Py_INCREF(self);
+            view->buf = column->data;
+            view->itemsize = column->strides[0];
+            view->len = column->shape[0] * column->strides[0];
+            view->readonly = 0;
+            view->ndim = 1;
+            view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>(column->format) : nullptr;
+            view->shape = (flags & PyBUF_ND) == PyBUF_ND ? column->shape : nullptr;
+            view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? column->strides : nullptr;
+            view->suboffsets = nullptr;
+            view->internal = nullptr;
+            return 0;
+        };
+        t.tp_name = "mft.ColumnView";
+        t.tp_basicsize = sizeof(PyColumnView);
+        t.tp_flags = Py_TPFLAGS_DEFAULT;
+        t.tp_doc = "Buffer over one column of C++ results";
+        t.tp_as_buffer = &buffer_procs;
+        t.tp_dealloc = [](PyObject* self) {
+            Py_XDECREF(reinterpret_cast<PyColumnView*>(self)->owner);
+            Py_TYPE(self)->tp_free(self);
+        };
+        return t;
+    }();
+    static const bool ready = PyType_Ready(&type) == 0;
+    return ready ? &type : nullptr;
+}
+
+// NumPy's asarray when NumPy is installed, else None (memoryview then)
+inline PyObject* py_numpy_asarray() {
+    static PyObject* asarray = [] {
+        PyObject* numpy = PyImport_ImportModule("numpy");
+        if (!numpy) {
+            PyErr_Clear();
+            return Py_None;
+        }
+        PyObject* fn = PyObject_GetAttrString(numpy, "asarray");
+        Py_DECREF(numpy);
+        if (!fn) PyErr_Clear();
+        return fn ? fn : Py_None;
+    }();
+    return asarray;
+}
+
+// A NumPy array (or, without NumPy, a memoryview) over `length` values of
+// `format` at `data`, kept valid by a reference to `owner`
+inline PyObject* py_column(PyObject* owner, const void* data, size_t length, const char* format, size_t itemsize) {
+    PyTypeObject* type = py_column_view_type();
+    if (!type) return nullptr;
+    auto* column = PyObject_New(PyColumnView, type);
+    if (!column) return nullptr;
+    Py_INCREF(owner);
+    column->owner = owner;
+    column->data = const_cast<void*>(data);
+    column->shape[0] = static_cast<Py_ssize_t>(length);
+    column->strides[0] = static_cast<Py_ssize_t>(itemsize);
+    column->format = format;
+
+    PyObject* view = reinterpret_cast<PyObject*>(column);
+    PyObject* asarray = py_numpy_asarray();
+    PyObject* result = asarray == Py_None ? PyMemoryView_FromObject(view)
+                                          : PyObject_CallOneArg(asarray, view);
+    Py_DECREF(view);
+    return result;
+}
+
+inline PyObject* py_column(PyObject* owner, const double* data, size_t length) {
+    return py_column(owner, data, length, "d", sizeof(double));
+}
+inline PyObject* py_column(PyObject* owner, const float* data, size_t length) {
+    return py_column(owner, data, length, "f", sizeof(float));
+}
+inline PyObject* py_column(PyObject* owner, const std::vector<double>& values) {
+    return py_column(owner, values.data(), values.size());
+}
+inline PyObject* py_column(PyObject* owner, const std::vector<int>& values) {
+    static_assert(sizeof(int) == 4, "struct code \"i\" is a 4-byte int");
+    return py_column(owner, values.data(), values.size(), "i", sizeof(int));
+}
+inline PyObject* py_column(PyObject* owner, const std::vector<long long>& values) {
+    return py_column(owner, values.data(), values.size(), "q", sizeof(long long));
+}
+
+// Sets `key` of `dict` to `value`, taking over the reference; false (with
+// the Python error set) if either failed
+inline bool py_set_item(PyObject* dict, const char* key, PyObject* value) {
+    if (!value) return false;
+    const int status = PyDict_SetItemString(dict, key, value);
+    Py_DECREF(value);
+    return status == 0;
+}
+
+// --- Inputs ---
+
+namespace py_detail {
+
+inline bool is_float64_format(const char* format) {
+    if (!format) return false;
+    if (*format == '@' || *format == '=' || *format == '<' || *format == '!' || *format == '>') {
+        // Explicit byte order: only the native one can be read in place
+        const bool little = *format == '<' || ((*format == '@' || *format == '=') && PY_LITTLE_ENDIAN);
+        const bool big = *format == '>' || *format == '!';
+        if ((little && !PY_LITTLE_ENDIAN) || (big && PY_LITTLE_ENDIAN)) return false;
+        ++format;
+    }
+    return std::strcmp(format, "d") == 0;
+}
+
+template <class Vector>
+bool read_arrow(PyObject* object, const char* name, Vector& out) {
+    PyObject* capsules = PyObject_CallMethod(object, "__arrow_c_array__", nullptr);
+    if (!capsules) return false;
+    if (!PyTuple_Check(capsules) || PyTuple_GET_SIZE(capsules) != 2) {
+        Py_DECREF(capsules);
+        PyErr_Format(PyExc_TypeError, "%s: __arrow_c_array__ did not return (schema, array)", name);
+        return false;
+    }
+    auto* schema = static_cast<ArrowSchema*>(PyCapsule_GetPointer(PyTuple_GET_ITEM(capsules, 0), "arrow_schema"));
+    auto* array = static_cast<ArrowArray*>(PyCapsule_GetPointer(PyTuple_GET_ITEM(capsules, 1), "arrow_array"));
+    bool ok = schema && array;
+    if (ok && std::strcmp(schema->format, "g") != 0) {
+        PyErr_Format(PyExc_TypeError, "%s: Arrow type '%s' is not float64", name, schema->format);
+        ok = false;
+    }
+    if (ok && array->null_count != 0 && array->buffers[0]) {
+        PyErr_Format(PyExc_ValueError, "%s: Arrow array has nulls; fill them first", name);
+        ok = false;
+    }
+    if (ok) {
+        const auto* values = static_cast<const double*>(array->buffers[1]) + array->offset;
+        out.assign(values, values + array->length);
+    }
+    // The capsules release the Arrow structs when they go
+    Py_DECREF(capsules);
+    return ok;
+}
+
+} // namespace py_detail
+
+// Copies a 1-D float64 series into `out` (see the top of this file for what
+// is accepted); false with a Python error set otherwise. `name` labels the
+// argument in error messages.
+template <class Vector>
+bool py_read_series(PyObject* object, const char* name, Vector& out) {
+    if (PyObject_CheckBuffer(object)) {
+        Py_buffer view;
+        if (PyObject_GetBuffer(object, &view, PyBUF_STRIDES | PyBUF_FORMAT) != 0) return false;
+        bool ok = true;
+        if (view.ndim != 1) {
+            PyErr_Format(PyExc_ValueError, "%s: expected a 1-D series, got %d dimensions", name, view.ndim);
+            ok = false;
+        } else if (!py_detail::is_float64_format(view.format)) {
+            PyErr_Format(PyExc_TypeError, "%s: expected float64 values, got format '%s'", name,
+                         view.format ? view.format : "B");
+            ok = false;
+        } else {
+            const size_t n = static_cast<size_t>(view.shape[0]);
+            out.resize(n);
+            const char* src = static_cast<const char*>(view.buf);
+            if (view.strides[0] == static_cast<Py_ssize_t>(sizeof(double))) {
+                if (n) std::memcpy(out.data(), src, n * sizeof(double));
+            } else {
+                for (size_t i = 0; i < n; ++i) std::memcpy(&out[i], src + static_cast<Py_ssize_t>(i) * view.strides[0], sizeof(double));
+            }
+        }
+        PyBuffer_Release(&view);
+        return ok;
+    }
+    if (PyObject_HasAttrString(object, "__arrow_c_array__")) return py_detail::read_arrow(object, name, out);
+
+    // Anything else NumPy can turn into float64 (pandas Series, lists)
+    PyObject* asarray = py_numpy_asarray();
+    if (asarray != Py_None) {
+        PyObject* dtype = PyUnicode_FromString("float64");
+        PyObject* array = dtype ? PyObject_CallFunctionObjArgs(asarray, object, dtype, nullptr) : nullptr;
+        Py_XDECREF(dtype);
+        if (!array) return false;
+        const bool ok = PyObject_CheckBuffer(array) && py_read_series(array, name, out);
+        Py_DECREF(array);
+        return ok;
+    }
+    PyErr_Format(PyExc_TypeError, "%s: expected a float64 buffer or Arrow array, got %s", name,
+                 Py_TYPE(object)->tp_name);
+    return false;
+}
+
+// One series per item of a sequence
+template <class Vector>
+bool py_read_series_list(PyObject* sequence, const char* name, std::vector<Vector>& out) {
+    PyObject* items = PySequence_Fast(sequence, name);
+    if (!items) return false;
+    const Py_ssize_t n = PySequence_Fast_GET_SIZE(items);
+    out.resize(static_cast<size_t>(n));
+    bool ok = true;
+    for (Py_ssize_t i = 0; ok && i < n; ++i) {
+        ok = py_read_series(PySequence_Fast_GET_ITEM(items, i), name, out[static_cast<size_t>(i)]);
+    }
+    Py_DECREF(items);
+    return ok;
+}
+
+// --- Running without the GIL ---
+
+// Runs fn with the GIL released so other Python threads keep going. A C++
+// exception becomes MemoryError or RuntimeError once the GIL is back; fn
+// must not touch Python objects.
+template <class Fn>
+bool py_without_gil(Fn&& fn) {
+    std::string error;
+    bool out_of_memory = false;
+    Py_BEGIN_ALLOW_THREADS
+    try {
+        fn();
+    } catch (const std::bad_alloc&) {
+        out_of_memory = true;
+    } catch (const std::exception& e) {
+        error = e.what();
+        if (error.empty()) error = "C++ exception";
+    }
+    Py_END_ALLOW_THREADS
+    if (out_of_memory) {
+        PyErr_NoMemory();
+        return false;
+    }
+    if (!error.empty()) {
+        PyErr_SetString(PyExc_RuntimeError, error.c_str());
+        return false;
+    }
+    return true;
+}
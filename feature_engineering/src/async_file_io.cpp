@@ -0,0 +1,622 @@
+#include "async_file_io.h"
+#include "memory_accounting.h"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// The ring needs the 5.6 opcodes (openat, read, write, close); their headers
+// are the first to define IORING_FEAT_RW_CUR_POS
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#ifdef IORING_FEAT_RW_CUR_POS
+#define MFT_HAVE_IO_URING 1
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+#endif
+
+namespace {
+enum class Stage { Open, Transfer, Close };
+}
+
+struct AsyncFileIO::Request {
+    bool write = false;
+    Stage stage = Stage::Open;
+    size_t tag = 0;
+    std::string path;
+    std::string content;        // write: the bytes
+    MemoryCharge queued;        // write: content, in Exports until it completes
+    char* slot = nullptr;       // read: registered slot, then heap once it fills
+    size_t slot_bytes = 0;
+    unsigned slot_index = 0;
+    // Kept across files so the next large one reuses it; left uninitialized
+    std::unique_ptr<char[]> heap;
+    size_t heap_bytes = 0;
+    MemoryCharge heap_memory;   // heap_bytes, in Loader
+    bool on_heap = false;       // reading into heap rather than slot
+    size_t done = 0;            // bytes transferred
+    int fd = -1;
+    int error = 0;
+    const char* failed_step = nullptr;
+
+    char* buffer() { return on_heap ? heap.get() : slot; }
+    size_t capacity() const { return on_heap ? heap_bytes : slot_bytes; }
+
+    // Makes room past `done` once the buffer is full: moves from the slot to
+    // the heap buffer for at least `file_size` bytes, or doubles the heap one.
+    // One byte more than the file is kept, for the read that returns 0.
+    void grow(size_t file_size) {
+        const size_t wanted = std::max(file_size + 1, capacity() * 2);
+        if (wanted > heap_bytes) {
+            std::unique_ptr<char[]> larger(new char[wanted]);
+            if (on_heap) std::copy(heap.get(), heap.get() + done, larger.get());
+            heap = std::move(larger);
+            heap_bytes = wanted;
+            heap_memory.set(MemorySubsystem::Loader, heap_bytes);
+        }
+        if (!on_heap) std::copy(slot, slot + done, heap.get());
+        on_heap = true;
+    }
+
+    void fail(int errno_value, const char* step) {
+        if (error) return;
+        error = errno_value;
+        failed_step = step;
+    }
+};
+
+class AsyncFileIO::Engine {
+public:
+    virtual ~Engine() = default;
+    virtual AsyncIOBackend backend() const = 0;
+    // Takes the request (stage Open) until poll() hands it back finished
+    virtual void start(Request* request) = 0;
+    // Submits what is queued and appends finished requests to `finished`,
+    // waiting for at least one if `block` and any are in flight
+    virtual void poll(bool block, std::vector<Request*>& finished) = 0;
+    virtual size_t in_flight() const = 0;
+};
+
+namespace {
+
+using Request = AsyncFileIO::Request;
+
+size_t file_size_of(int fd) {
+#ifndef _WIN32
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) return static_cast<size_t>(st.st_size);
+#else
+    (void)fd;
+#endif
+    return 0;
+}
+
+// Blocking reads and writes on a few threads. Requests go through their
+// stages in one go on whichever worker takes them.
+class ThreadPoolEngine : public AsyncFileIO::Engine {
+public:
+    explicit ThreadPoolEngine(unsigned threads) {
+        for (unsigned t = 0; t < std::max(1u, threads); ++t) workers_.emplace_back([this] { work(); });
+    }
+
+    ~ThreadPoolEngine() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        work_ready_.notify_all();
+        for (auto& worker : workers_) worker.join();
+    }
+
+    AsyncIOBackend backend() const override { return AsyncIOBackend::ThreadPool; }
+
+    void start(Request* request) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            work_.push_back(request);
+        }
+        ++in_flight_;
+        work_ready_.notify_one();
+    }
+
+    void poll(bool block, std::vector<Request*>& finished) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (block && in_flight_ > 0) done_ready_.wait(lock, [&] { return !done_.empty(); });
+        in_flight_ -= done_.size();
+        finished.insert(finished.end(), done_.begin(), done_.end());
+        done_.clear();
+    }
+
+    size_t in_flight() const override { return in_flight_; }
+
+private:
+    void work() {
+        for (;;) {
+            Request* request;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                work_ready_.wait(lock, [&] { return stop_ || !work_.empty(); });
+                if (work_.empty()) return;
+                request = work_.front();
+                work_.pop_front();
+            }
+            if (request->write) write_file(*request);
+            else read_file(*request);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                done_.push_back(request);
+            }
+            done_ready_.notify_one();
+        }
+    }
+
+#ifndef _WIN32
+    static void read_file(Request& request) {
+        const int fd = open(request.path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) return request.fail(errno, "open");
+        for (;;) {
+            if (request.done == request.capacity()) request.grow(file_size_of(fd));
+            const ssize_t n = read(fd, request.buffer() + request.done, request.capacity() - request.done);
+            if (n > 0) {
+                request.done += static_cast<size_t>(n);
+            } else if (n == 0) {
+                break;
+            } else if (errno != EINTR) {
+                request.fail(errno, "read");
+                break;
+            }
+        }
+        if (close(fd) != 0) request.fail(errno, "close");
+    }
+
+    static void write_file(Request& request) {
+        const int fd = open(request.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd == -1) return request.fail(errno, "create");
+        while (request.done < request.content.size()) {
+            const ssize_t n = write(fd, request.content.data() + request.done, request.content.size() - request.done);
+            if (n > 0) {
+                request.done += static_cast<size_t>(n);
+            } else if (n == -1 && errno == EINTR) {
+                continue;
+            } else {
+                request.fail(n == 0 ? EIO : errno, "write");
+                break;
+            }
+        }
+        if (close(fd) != 0) request.fail(errno, "close");
+    }
+#else
+    static void read_file(Request& request) {
+        std::ifstream file(request.path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return request.fail(ENOENT, "open");
+        const size_t size = static_cast<size_t>(file.tellg());
+        file.seekg(0);
+        if (size > request.capacity()) request.grow(size);
+        if (!file.read(request.buffer(), static_cast<std::streamsize>(size))) return request.fail(EIO, "read");
+        request.done = size;
+    }
+
+    static void write_file(Request& request) {
+        std::ofstream file(request.path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return request.fail(EACCES, "create");
+        file.write(request.content.data(), static_cast<std::streamsize>(request.content.size()));
+        file.close();
+        if (!file) request.fail(EIO, "write");
+    }
+#endif
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable work_ready_, done_ready_;
+    std::deque<Request*> work_, done_;
+    size_t in_flight_ = 0;          // owner thread only
+    bool stop_ = false;
+};
+
+#ifdef MFT_HAVE_IO_URING
+
+int io_uring_setup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int io_uring_register(int fd, unsigned opcode, const void* arg, unsigned count) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+// Each request has one ring operation in flight at a time, stage after
+// stage: open -> read or write until done -> close. The submission queue
+// therefore never holds more entries than there are requests.
+class UringEngine : public AsyncFileIO::Engine {
+public:
+    // Throws std::system_error when the kernel will not set up a ring
+    UringEngine(unsigned entries, const std::vector<iovec>& slots) {
+        io_uring_params params{};
+        ring_fd_ = io_uring_setup(entries, &params);
+        if (ring_fd_ < 0) throw std::system_error(errno, std::generic_category(), "io_uring_setup");
+        try {
+            map_rings(params);
+        } catch (...) {
+            unmap_rings();
+            close(ring_fd_);
+            throw;
+        }
+        // Registered buffers count against RLIMIT_MEMLOCK; without them the
+        // slots are read into with plain IORING_OP_READ
+        fixed_buffers_ = !slots.empty() &&
+                         io_uring_register(ring_fd_, IORING_REGISTER_BUFFERS, slots.data(),
+                                           static_cast<unsigned>(slots.size())) == 0;
+    }
+
+    ~UringEngine() override {
+        unmap_rings();
+        close(ring_fd_);
+    }
+
+    AsyncIOBackend backend() const override { return AsyncIOBackend::IoUring; }
+
+    void start(Request* request) override {
+        request->stage = Stage::Open;
+        prepare(*request);
+        ++in_flight_;
+    }
+
+    void poll(bool block, std::vector<Request*>& finished) override {
+        const size_t before = finished.size();
+        for (;;) {
+            const bool wait = block && finished.size() == before && in_flight_ > 0 &&
+                              __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE) == *cq_head_;
+            if (queued_ > 0 || wait) enter(wait);
+            reap(finished);
+            if (!block || finished.size() > before || in_flight_ == 0) break;
+        }
+        // Stages that reap() moved on start now rather than at the next call
+        if (queued_ > 0) enter(false);
+    }
+
+    size_t in_flight() const override { return in_flight_; }
+
+private:
+    void map_rings(const io_uring_params& params) {
+        sq_bytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_bytes_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) sq_bytes_ = cq_bytes_ = std::max(sq_bytes_, cq_bytes_);
+        if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+            throw std::system_error(ENOSYS, std::generic_category(), "io_uring without file opcodes");
+        }
+
+        sq_ring_ = map(sq_bytes_, IORING_OFF_SQ_RING);
+        cq_ring_ = single ? sq_ring_ : map(cq_bytes_, IORING_OFF_CQ_RING);
+        sqes_bytes_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(map(sqes_bytes_, IORING_OFF_SQES));
+
+        char* sq = static_cast<char*>(sq_ring_);
+        sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        char* cq = static_cast<char*>(cq_ring_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    void* map(size_t bytes, off_t offset) {
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, offset);
+        if (p == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "io_uring mmap");
+        return p;
+    }
+
+    void unmap_rings() {
+        if (sqes_) munmap(sqes_, sqes_bytes_);
+        if (cq_ring_ && cq_ring_ != sq_ring_) munmap(cq_ring_, cq_bytes_);
+        if (sq_ring_) munmap(sq_ring_, sq_bytes_);
+    }
+
+    io_uring_sqe& next_sqe() {
+        const unsigned tail = *sq_tail_ + queued_;
+        io_uring_sqe& sqe = sqes_[tail & sq_mask_];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sq_array_[tail & sq_mask_] = tail & sq_mask_;
+        ++queued_;
+        return sqe;
+    }
+
+    // Queues the operation of the request's current stage
+    void prepare(Request& request) {
+        io_uring_sqe& sqe = next_sqe();
+        sqe.user_data = reinterpret_cast<uint64_t>(&request);
+        switch (request.stage) {
+        case Stage::Open:
+            sqe.opcode = IORING_OP_OPENAT;
+            sqe.fd = AT_FDCWD;
+            sqe.addr = reinterpret_cast<uint64_t>(request.path.c_str());
+            sqe.open_flags = request.write ? O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC : O_RDONLY | O_CLOEXEC;
+            sqe.len = request.write ? 0644 : 0;
+            break;
+        case Stage::Transfer:
+            sqe.fd = request.fd;
+            sqe.off = request.done;
+            if (request.write) {
+                sqe.opcode = IORING_OP_WRITE;
+                sqe.addr = reinterpret_cast<uint64_t>(request.content.data() + request.done);
+                sqe.len = static_cast<unsigned>(std::min<size_t>(request.content.size() - request.done, 1u << 30));
+            } else {
+                const bool fixed = fixed_buffers_ && !request.on_heap;
+                sqe.opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+                if (fixed) sqe.buf_index = static_cast<uint16_t>(request.slot_index);
+                sqe.addr = reinterpret_cast<uint64_t>(request.buffer() + request.done);
+                sqe.len = static_cast<unsigned>(std::min<size_t>(request.capacity() - request.done, 1u << 30));
+            }
+            break;
+        case Stage::Close:
+            sqe.opcode = IORING_OP_CLOSE;
+            sqe.fd = request.fd;
+            break;
+        }
+    }
+
+    // Publishes the queued entries and submits them, waiting for a completion if asked
+    void enter(bool wait) {
+        __atomic_store_n(sq_tail_, *sq_tail_ + queued_, __ATOMIC_RELEASE);
+        const unsigned to_submit = queued_;
+        queued_ = 0;
+        for (unsigned submitted = 0;;) {
+            const int n = io_uring_enter(ring_fd_, to_submit - submitted, wait ? 1 : 0,
+                                         wait ? IORING_ENTER_GETEVENTS : 0);
+            if (n >= 0) submitted += static_cast<unsigned>(n);
+            else if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+                throw std::system_error(errno, std::generic_category(), "io_uring_enter");
+            if (submitted == to_submit && n >= 0) return;
+        }
+    }
+
+    void reap(std::vector<Request*>& finished) {
+        unsigned head = *cq_head_;
+        const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+            advance(*reinterpret_cast<Request*>(cqe.user_data), cqe.res, finished);
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+
+    // Moves a request past the operation that completed with `res`
+    void advance(Request& request, int res, std::vector<Request*>& finished) {
+        const bool retry = res == -EINTR || res == -EAGAIN;
+        switch (request.stage) {
+        case Stage::Open:
+            if (retry) break;
+            if (res < 0) {
+                request.fail(-res, request.write ? "create" : "open");
+                return finish(request, finished);
+            }
+            request.fd = res;
+            request.stage = Stage::Transfer;
+            if (request.write && request.content.empty()) request.stage = Stage::Close;
+            break;
+        case Stage::Transfer:
+            if (retry) break;
+            if (res < 0 || (request.write && res == 0)) {
+                request.fail(res < 0 ? -res : EIO, request.write ? "write" : "read");
+                request.stage = Stage::Close;
+                break;
+            }
+            if (!request.write && res == 0) {
+                request.stage = Stage::Close;
+                break;
+            }
+            request.done += static_cast<size_t>(res);
+            if (request.write) {
+                if (request.done == request.content.size()) request.stage = Stage::Close;
+            } else if (request.done == request.capacity()) {
+                request.grow(file_size_of(request.fd));
+            }
+            break;
+        case Stage::Close:
+            if (res < 0) request.fail(-res, "close");
+            request.fd = -1;
+            return finish(request, finished);
+        }
+        prepare(request);
+    }
+
+    void finish(Request& request, std::vector<Request*>& finished) {
+        --in_flight_;
+        finished.push_back(&request);
+    }
+
+    int ring_fd_ = -1;
+    bool fixed_buffers_ = false;
+    void* sq_ring_ = nullptr;
+    void* cq_ring_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sq_bytes_ = 0, cq_bytes_ = 0, sqes_bytes_ = 0;
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+    unsigned cq_mask_ = 0;
+    unsigned queued_ = 0;           // prepared entries not yet published
+    size_t in_flight_ = 0;
+};
+
+#endif
+
+} // namespace
+
+const char* async_io_backend_name(AsyncIOBackend backend) {
+    return backend == AsyncIOBackend::IoUring ? "io_uring" : "thread pool";
+}
+
+std::string AsyncIOResult::message() const {
+    if (!error) return {};
+    return std::string("Cannot ") + failed_step + " file: " + (path ? *path : std::string()) + ": " +
+           std::generic_category().message(error);
+}
+
+AsyncFileIO::AsyncFileIO(const AsyncIOConfig& config) : config_(config) {
+    config_.queue_depth = std::max(1u, config_.queue_depth);
+    config_.read_slot_bytes = std::max<size_t>(4096, config_.read_slot_bytes);
+    slots_.reset(new char[config_.queue_depth * config_.read_slot_bytes]);
+    for (unsigned i = 0; i < config_.queue_depth; ++i) {
+        auto request = std::make_unique<Request>();
+        request->slot = slots_.get() + i * config_.read_slot_bytes;
+        request->slot_bytes = config_.read_slot_bytes;
+        request->slot_index = i;
+        idle_.push_back(request.get());
+        requests_.push_back(std::move(request));
+    }
+#ifdef MFT_HAVE_IO_URING
+    if (!config_.force_thread_pool) {
+        std::vector<iovec> slots;
+        for (const auto& request : requests_) slots.push_back({request->slot, request->slot_bytes});
+        try {
+            engine_ = std::make_unique<UringEngine>(config_.queue_depth, slots);
+        } catch (const std::system_error&) {
+            // Kernel without io_uring or with it disabled: use the pool
+        }
+    }
+#endif
+    if (!engine_) engine_ = std::make_unique<ThreadPoolEngine>(config_.fallback_threads);
+}
+
+AsyncFileIO::~AsyncFileIO() {
+    on_read_ = nullptr;
+    try {
+        drain();
+    } catch (const std::exception&) {
+        // Nothing left to report to
+    }
+}
+
+AsyncIOBackend AsyncFileIO::backend() const {
+    return engine_->backend();
+}
+
+AsyncFileIO::Request* AsyncFileIO::acquire() {
+    while (idle_.empty()) poll(true);
+    Request* request = idle_.back();
+    idle_.pop_back();
+    request->stage = Stage::Open;
+    request->done = 0;
+    request->fd = -1;
+    request->error = 0;
+    request->failed_step = nullptr;
+    request->on_heap = false;
+    request->content.clear();
+    return request;
+}
+
+void AsyncFileIO::poll(bool block) {
+    finished_.clear();
+    engine_->poll(block, finished_);
+    // Back to idle before any callback runs, so a callback that throws
+    // loses none; the contents stay put until the request is reused
+    idle_.insert(idle_.end(), finished_.begin(), finished_.end());
+    for (Request* request : finished_) complete(*request);
+}
+
+void AsyncFileIO::complete(Request& request) {
+    if (request.write) {
+        if (request.error) {
+            AsyncIOResult result;
+            result.path = &request.path;
+            result.error = request.error;
+            result.failed_step = request.failed_step;
+            write_errors_.emplace_back(request.tag, result.message());
+        } else {
+            ++files_written_;
+        }
+        request.content = std::string();
+        request.queued.release();
+        return;
+    }
+    --reads_in_flight_;
+    if (!request.error) ++files_read_;
+    if (!on_read_) return;
+    AsyncIOResult result;
+    result.tag = request.tag;
+    result.path = &request.path;
+    result.error = request.error;
+    result.failed_step = request.failed_step;
+    if (!request.error) {
+        result.data = request.buffer();
+        result.size = request.done;
+    }
+    (*on_read_)(result);
+}
+
+void AsyncFileIO::read_files(const std::function<bool(std::string&, size_t&)>& next, const Callback& on_read) {
+    // Files left in flight by a throwing callback complete unseen
+    struct Detach {
+        const Callback*& slot;
+        ~Detach() { slot = nullptr; }
+    } detach{on_read_};
+    on_read_ = &on_read;
+
+    for (;;) {
+        Request* request = acquire();
+        if (!next(request->path, request->tag)) {
+            idle_.push_back(request);
+            break;
+        }
+        request->write = false;
+        ++reads_in_flight_;
+        engine_->start(request);
+    }
+    while (reads_in_flight_ > 0) poll(true);
+}
+
+void AsyncFileIO::read_files(const std::vector<std::string>& paths, const Callback& on_read) {
+    size_t index = 0;
+    read_files([&](std::string& path, size_t& tag) {
+        if (index == paths.size()) return false;
+        tag = index;
+        path = paths[index++];
+        return true;
+    }, on_read);
+}
+
+void AsyncFileIO::write_file(std::string path, std::string content, size_t tag) {
+    Request* request = acquire();
+    request->write = true;
+    request->tag = tag;
+    request->path = std::move(path);
+    request->content = std::move(content);
+    request->queued.set(MemorySubsystem::Exports, request->content.capacity());
+    engine_->start(request);
+    poll(false);
+}
+
+void AsyncFileIO::drain() {
+    while (engine_->in_flight() > 0) poll(true);
+}
+
+std::vector<std::pair<size_t, std::string>> AsyncFileIO::take_write_errors() {
+    std::vector<std::pair<size_t, std::string>> errors;
+    errors.swap(write_errors_);
+    return errors;
+}
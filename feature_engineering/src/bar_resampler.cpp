@@ -0,0 +1,141 @@
+#include "bar_resampler.h"
+#include "civil_time.h"
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr int64_t kMinutesPerDay = 24 * 60;
+
+std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t");
+    return s.substr(begin, end - begin + 1);
+}
+
+// Parses "HH:MM" into minutes after midnight, up to 24:00
+int parse_clock(const std::string& text) {
+    if (text.size() != 5 || text[2] != ':' || !std::isdigit(static_cast<unsigned char>(text[0])) ||
+        !std::isdigit(static_cast<unsigned char>(text[1])) || !std::isdigit(static_cast<unsigned char>(text[3])) ||
+        !std::isdigit(static_cast<unsigned char>(text[4]))) {
+        return -1;
+    }
+    const int hours = (text[0] - '0') * 10 + (text[1] - '0');
+    const int minutes = (text[3] - '0') * 10 + (text[4] - '0');
+    if (minutes > 59 || hours * 60 + minutes > kMinutesPerDay) return -1;
+    return hours * 60 + minutes;
+}
+
+BarFrequency parse_frequency(const std::string& token) {
+    std::string text = token;
+    for (auto& c : text) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    if (text == "daily" || text == "d" || text == "1d") return {"daily", 0};
+
+    size_t digits = 0;
+    while (digits < text.size() && std::isdigit(static_cast<unsigned char>(text[digits]))) ++digits;
+    const std::string unit = text.substr(digits);
+    int64_t scale = 0;
+    if (unit == "m" || unit == "min") scale = 1;
+    else if (unit == "h") scale = 60;
+    if (digits == 0 || digits > 5 || scale == 0) throw std::runtime_error("Invalid bar frequency: " + token);
+    const int64_t minutes = std::stoll(text.substr(0, digits)) * scale;
+    if (minutes == 0 || minutes > kMinutesPerDay) throw std::runtime_error("Invalid bar frequency: " + token);
+    return {minutes % 60 == 0 ? std::to_string(minutes / 60) + "h" : std::to_string(minutes) + "m", minutes};
+}
+
+}
+
+int64_t TradingSession::minutes() const {
+    const int64_t length = ((close_minute - open_minute) % kMinutesPerDay + kMinutesPerDay) % kMinutesPerDay;
+    return length == 0 ? kMinutesPerDay : length;
+}
+
+std::vector<BarFrequency> parse_frequency_list(const std::string& list) {
+    std::vector<BarFrequency> frequencies;
+    std::stringstream ss(list);
+    std::string token;
+    while (std::getline(ss, token, ',')) {
+        token = trim(token);
+        if (token.empty()) continue;
+        frequencies.push_back(parse_frequency(token));
+    }
+    // Daily (0 minutes) sorts after every intraday length
+    auto order = [](const BarFrequency& f) {
+        return f.minutes ? f.minutes : std::numeric_limits<int64_t>::max();
+    };
+    std::sort(frequencies.begin(), frequencies.end(),
+              [&](const BarFrequency& a, const BarFrequency& b) { return order(a) < order(b); });
+    frequencies.erase(std::unique(frequencies.begin(), frequencies.end(),
+                                  [](const BarFrequency& a, const BarFrequency& b) { return a.minutes == b.minutes; }),
+                      frequencies.end());
+    return frequencies;
+}
+
+TradingSession parse_trading_session(const std::string& text) {
+    const std::string session = trim(text);
+    const size_t dash = session.find('-');
+    TradingSession result;
+    if (dash != std::string::npos) {
+        result.open_minute = parse_clock(trim(session.substr(0, dash)));
+        result.close_minute = parse_clock(trim(session.substr(dash + 1)));
+    }
+    if (dash == std::string::npos || result.open_minute < 0 || result.close_minute < 0 ||
+        result.open_minute == kMinutesPerDay) {
+        throw std::runtime_error("Invalid trading session: " + text);
+    }
+    return result;
+}
+
+void BarResampler::resample(const OHLCVData& source, const ResampleConfig& config, std::vector<OHLCVData>& out) {
+    const size_t count = config.frequencies.size();
+    const int64_t open = static_cast<int64_t>(config.session.open_minute) * 60;
+    const int64_t length = config.session.minutes() * 60;
+
+    // Bucket length in seconds and the start of the bucket each bar is filling
+    std::vector<int64_t> span(count);
+    std::vector<int64_t> current(count, std::numeric_limits<int64_t>::min());
+    out.resize(count);
+    for (size_t k = 0; k < count; ++k) {
+        span[k] = config.frequencies[k].minutes ? config.frequencies[k].minutes * 60 : length;
+        OHLCVData& bars = out[k];
+        bars.symbol = source.symbol;
+        bars.timestamps.clear();
+        bars.open.clear();
+        bars.high.clear();
+        bars.low.clear();
+        bars.close.clear();
+        bars.volume.clear();
+    }
+
+    for (size_t i = 0; i < source.size(); ++i) {
+        const int64_t t = std::chrono::floor<std::chrono::seconds>(source.timestamps[i].time_since_epoch()).count();
+        // Latest session open at or before t
+        const int64_t session_start = floor_days(t - open) * 86400 + open;
+        const int64_t into = t - session_start;
+        if (into >= length) continue;
+
+        for (size_t k = 0; k < count; ++k) {
+            const int64_t bucket = session_start + into / span[k] * span[k];
+            OHLCVData& bars = out[k];
+            if (bucket != current[k]) {
+                current[k] = bucket;
+                bars.timestamps.push_back(std::chrono::system_clock::time_point(std::chrono::seconds(bucket)));
+                bars.open.push_back(source.open[i]);
+                bars.high.push_back(source.high[i]);
+                bars.low.push_back(source.low[i]);
+                bars.close.push_back(source.close[i]);
+                bars.volume.push_back(source.volume[i]);
+                continue;
+            }
+            bars.high.back() = std::max(bars.high.back(), source.high[i]);
+            bars.low.back() = std::min(bars.low.back(), source.low[i]);
+            bars.close.back() = source.close[i];
+            bars.volume.back() += source.volume[i];
+        }
+    }
+    for (OHLCVData& bars : out) bars.charge_memory();
+}
@@ -1,5 +1,9 @@
 #include "batch_ohlc_processor.h"
+#include "feature_graph.h"
+#include "feature_block.h"
+#include "fusion_plan.h"
 #include "technical_indicators.h"
+#include "fixed_window.h"
 #include "simd_technical_indicators.h"
 #include "neon_technical_indicators.h"
 #include <stdexcept>
@@ -7,195 +11,256 @@
 #include <numeric>
 #include <execution>
 #include <thread>
+#include <map>
 
-BatchOHLCProcessor::ComputationCache::ComputationCache(bool enable_simd) : use_simd_(enable_simd) {}
-
-std::vector<double>& BatchOHLCProcessor::ComputationCache::get_or_compute(
-    const std::string& key,
-    std::function<std::vector<double>()> simd_computer,
-    std::function<std::vector<double>()> scalar_computer) {
-    if (cache_.count(key)) return cache_.at(key);
-    auto result = use_simd_ ? simd_computer() : scalar_computer();
-    auto [it, success] = cache_.emplace(key, std::move(result));
-    return it->second;
+namespace {
+// Use NEON if available, otherwise fall back to AVX2, then scalar
+ComputeBackend select_backend(bool force_scalar) {
+    if (force_scalar) return ComputeBackend::Scalar;
+    if (NEONTechnicalIndicators::is_neon_available()) return ComputeBackend::NEON;
+    if (SIMDTechnicalIndicators::is_simd_available()) return ComputeBackend::AVX2;
+    return ComputeBackend::Scalar;
 }
 
-void BatchOHLCProcessor::ComputationCache::clear() { cache_.clear(); }
+bool well_formed(const std::vector<double>& open, const std::vector<double>& high, const std::vector<double>& low,
+                 const std::vector<double>& close, const std::vector<double>& volume) {
+    return !close.empty() && open.size() == close.size() && high.size() == close.size() &&
+           low.size() == close.size() && volume.size() == close.size();
+}
+}
 
 FeatureSet BatchOHLCProcessor::calculate_features(
     const std::vector<double>& open, const std::vector<double>& high,
     const std::vector<double>& low, const std::vector<double>& close,
-    const std::vector<double>& volume, bool force_scalar
+    const std::vector<double>& volume, bool force_scalar,
+    const FeatureMask& selection
+) {
+    // Scratch block reused by every call on this thread
+    thread_local FeatureBlock block;
+    calculate_features_into(open, high, low, close, volume, block, force_scalar, selection);
+    return block.to_feature_set();
+}
+
+void BatchOHLCProcessor::calculate_features_into(
+    const std::vector<double>& open, const std::vector<double>& high,
+    const std::vector<double>& low, const std::vector<double>& close,
+    const std::vector<double>& volume, FeatureBlock& block, bool force_scalar,
+    const FeatureMask& selection, const GarchParams* garch, const RegimeFeatureParams* regimes
+) {
+    FeatureGraph graph(high, low, close, volume, select_backend(force_scalar));
+    if (garch) graph.set_garch_params(*garch);
+    if (regimes) graph.set_regime_params(*regimes);
+    calculate_features_from_graph(open, high, low, close, volume, graph, block, selection);
+}
+
+void BatchOHLCProcessor::calculate_features_from_graph(
+    const std::vector<double>& open, const std::vector<double>& high,
+    const std::vector<double>& low, const std::vector<double>& close,
+    const std::vector<double>& volume, FeatureGraph& graph, FeatureBlock& block,
+    const FeatureMask& selection
 ) {
     if (close.empty()) throw std::runtime_error("Input vectors cannot be empty.");
+    if (!well_formed(open, high, low, close, volume)) {
+        throw std::runtime_error("Input vectors must have the same length.");
+    }
 
-    FeatureSet features;
-    // Use NEON if available, otherwise fall back to AVX2, then scalar
-    const bool use_neon = NEONTechnicalIndicators::is_neon_available() && !force_scalar;
-    const bool use_simd = SIMDTechnicalIndicators::is_simd_available() && !force_scalar && !use_neon;
-    ComputationCache cache(use_neon || use_simd);
-
-    auto& returns = cache.get_or_compute("returns",
-        [&](){ 
-            if (use_neon) return NEONTechnicalIndicators::calculate_returns_neon(close);
-            else if (use_simd) return SIMDTechnicalIndicators::calculate_returns_simd(close);
-            else return TechnicalIndicators::calculate_returns(close);
-        },
-        [&](){ return TechnicalIndicators::calculate_returns(close); }
-    );
-    features.returns = returns;
-
-    if (!returns.empty()) {
-        features.volatility = cache.get_or_compute("volatility",
-            [&](){ 
-                if (use_neon) return NEONTechnicalIndicators::calculate_rolling_volatility_neon(returns, 20);
-                else if (use_simd) return SIMDTechnicalIndicators::calculate_rolling_volatility_simd(returns, 20);
-                else return TechnicalIndicators::calculate_rolling_volatility(returns, 20);
-            },
-            [&](){ return TechnicalIndicators::calculate_rolling_volatility(returns, 20); }
-        );
+    const size_t n = close.size();
+    block.reset(n);
+    const bool use_neon = graph.backend() == ComputeBackend::NEON;
+    const bool use_simd = graph.backend() == ComputeBackend::AVX2;
+    // Windowed indicators without a dedicated NEON path run on the active kernel table
+    const bool use_vector = use_neon || use_simd;
+
+    // Chains of columns over the same inputs go first, one pass per block of
+    // rows; their returns seed the graph
+    const FusionPlan plan(loop_fusion_ ? selection : FeatureMask(), graph.backend());
+    if (!plan.empty()) {
+        std::vector<double> fused_returns;
+        plan.run(high.data(), low.data(), close.data(), volume.data(), n, block, fused_returns);
+        if (!fused_returns.empty()) graph.provide(FeatureNode::Returns, std::move(fused_returns));
     }
 
-    features.sma = cache.get_or_compute("sma20",
-        [&](){ 
-            if (use_neon) return NEONTechnicalIndicators::simple_moving_average_neon(close, 20);
-            else if (use_simd) return SIMDTechnicalIndicators::simple_moving_average_simd(close, 20);
-            else return TechnicalIndicators::simple_moving_average(close, 20);
-        },
-        [&](){ return TechnicalIndicators::simple_moving_average(close, 20); }
-    );
-    features.volume_sma_20 = cache.get_or_compute("vol_sma20",
-        [&](){ 
-            if (use_neon) return NEONTechnicalIndicators::simple_moving_average_neon(volume, 20);
-            else if (use_simd) return SIMDTechnicalIndicators::simple_moving_average_simd(volume, 20);
-            else return TechnicalIndicators::simple_moving_average(volume, 20);
-        },
-        [&](){ return TechnicalIndicators::simple_moving_average(volume, 20); }
-    );
-    features.spread = cache.get_or_compute("spread",
-        [&](){ 
-            if (use_neon) return NEONTechnicalIndicators::compute_spread_neon(high, low);
-            else if (use_simd) return SIMDTechnicalIndicators::compute_spread_simd(high, low);
-            else return TechnicalIndicators::compute_spread(high, low);
-        },
-        [&](){ return TechnicalIndicators::compute_spread(high, low); }
-    );
-    features.log_pct_change_5 = cache.get_or_compute("log_pct_5",
-        [&](){ 
-            if (use_neon) return NEONTechnicalIndicators::log_pct_change_neon(close, 5);
-            else if (use_simd) return SIMDTechnicalIndicators::log_pct_change_simd(close, 5);
-            else return TechnicalIndicators::log_pct_change(close, 5);
-        },
-        [&](){ return TechnicalIndicators::log_pct_change(close, 5); }
-    );
-    features.linear_slope_20 = cache.get_or_compute("slope20",
-        [&](){ 
-            if (use_neon) return NEONTechnicalIndicators::linear_slope_neon(close, 20);
-            else if (use_simd) return SIMDTechnicalIndicators::linear_slope_simd(close, 20);
-            else return TechnicalIndicators::linear_slope(close, 20);
-        },
-        [&](){ return TechnicalIndicators::linear_slope(close, 20); }
-    );
-    features.linear_slope_60 = cache.get_or_compute("slope60",
-        [&](){ 
-            if (use_neon) return NEONTechnicalIndicators::linear_slope_neon(close, 60);
-            else if (use_simd) return SIMDTechnicalIndicators::linear_slope_simd(close, 60);
-            else return TechnicalIndicators::linear_slope(close, 60);
-        },
-        [&](){ return TechnicalIndicators::linear_slope(close, 60); }
-    );
-    
-    // Calculate momentum using optimized implementation
-    features.momentum = cache.get_or_compute("momentum10",
-        [&](){ 
-            if (use_neon) return NEONTechnicalIndicators::calculate_momentum_neon(close, 10);
-            else if (use_simd) return SIMDTechnicalIndicators::calculate_momentum_simd(close, 10);
-            else {
-                std::vector<double> result;
-                if (close.size() > 10) {
-                    result.reserve(close.size() - 10);
-                    for (size_t i = 10; i < close.size(); ++i) {
-                        result.push_back(close[i-10] != 0.0 ? close[i] / close[i-10] : 0.0);
-                    }
-                }
-                return result;
-            }
-        },
-        [&](){ 
-            std::vector<double> result;
-            if (close.size() > 10) {
-                result.reserve(close.size() - 10);
-                for (size_t i = 10; i < close.size(); ++i) {
-                    result.push_back(close[i-10] != 0.0 ? close[i] / close[i-10] : 0.0);
-                }
-            }
-            return result;
+    // Unselected and fused columns are skipped; shared inputs are pulled from the graph on demand
+    auto selected = [&](Feature feature) { return is_selected(selection, feature) && !plan.fuses(feature); };
+    auto returns = [&]() -> const std::vector<double>& { return graph.get<FeatureNode::Returns>(); };
+    // Span kernels write straight into the block column; a Float32 block
+    // takes them through a double scratch span and narrows
+    const bool f32 = block.precision() == FeaturePrecision::Float32;
+    thread_local std::vector<double> scratch;
+    auto write_column = [&](Feature feature, auto&& kernel) {
+        if (!selected(feature)) return;
+        if (!f32) {
+            block.set_length(feature, kernel(block.column(feature)));
+            return;
         }
-    );
-
-    features.rsi = TechnicalIndicators::calculate_rsi(close, 14);
-    features.internal_bar_strength = TechnicalIndicators::internal_bar_strength(open, high, low, close);
-    auto candle_info = TechnicalIndicators::candle_information(open, high, low, close);
-    features.candle_way = std::move(candle_info.first);
-    features.candle_filling = std::move(candle_info.second.first);
-    features.candle_amplitude = std::move(candle_info.second.second);
-    auto derivatives_pair = TechnicalIndicators::derivatives(close);
-    features.velocity = std::move(derivatives_pair.first);
-    features.acceleration = std::move(derivatives_pair.second);
-    features.skewness_30 = TechnicalIndicators::skewness(close, 30);
-    features.kurtosis_30 = TechnicalIndicators::kurtosis(close, 30);
-    features.auto_correlation_50_10 = TechnicalIndicators::auto_correlation(close, 50, 10);
-    features.kama_10_2_30 = TechnicalIndicators::kama(close, 10, 2, 30);
-    features.parkinson_volatility_20 = TechnicalIndicators::parkinson_volatility(high, low, 20);
+        scratch.resize(n);
+        block.assign(feature, scratch.data(), kernel(scratch.data()));
+    };
+
+    if (selected(Feature::returns)) block.assign(Feature::returns, returns());
+    if (selected(Feature::volatility)) block.assign(Feature::volatility, graph.get<FeatureNode::RollingVolatility20>());
+    if (selected(Feature::sma)) block.assign(Feature::sma, graph.get<FeatureNode::Sma20>());
+    if (selected(Feature::volume_sma_20)) block.assign(Feature::volume_sma_20, graph.get<FeatureNode::VolumeSma20>());
+
+    if (f32 && use_vector) {
+        // Ratios and slopes run on float closes, twice the lanes. The spread
+        // cancels the price level, so it is taken in double and narrowed.
+        write_column(Feature::spread, [&](double* out) { return SIMDTechnicalIndicators::compute_spread_simd(high.data(), low.data(), n, out); });
+        thread_local std::vector<float> close32;
+        close32.assign(close.begin(), close.end());
+        auto write_f32 = [&](Feature feature, auto&& kernel) {
+            if (selected(feature)) block.set_length(feature, kernel(block.column_f32(feature)));
+        };
+        write_f32(Feature::log_pct_change_5, [&](float* out) { return SIMDTechnicalIndicators::log_pct_change_f32(close32.data(), n, 5, out); });
+        write_f32(Feature::linear_slope_20, [&](float* out) { return SIMDTechnicalIndicators::linear_slope_f32(close32.data(), n, 20, out); });
+        write_f32(Feature::linear_slope_60, [&](float* out) { return SIMDTechnicalIndicators::linear_slope_f32(close32.data(), n, 60, out); });
+        write_f32(Feature::momentum, [&](float* out) { return SIMDTechnicalIndicators::calculate_momentum_f32(close32.data(), n, 10, out); });
+    } else if (use_neon) {
+        if (selected(Feature::spread)) block.assign(Feature::spread, NEONTechnicalIndicators::compute_spread_neon(high, low));
+        if (selected(Feature::log_pct_change_5)) block.assign(Feature::log_pct_change_5, NEONTechnicalIndicators::log_pct_change_neon(close, 5));
+        if (selected(Feature::linear_slope_20)) block.assign(Feature::linear_slope_20, NEONTechnicalIndicators::linear_slope_neon(close, 20));
+        if (selected(Feature::linear_slope_60)) block.assign(Feature::linear_slope_60, NEONTechnicalIndicators::linear_slope_neon(close, 60));
+        if (selected(Feature::momentum)) block.assign(Feature::momentum, NEONTechnicalIndicators::calculate_momentum_neon(close, 10));
+    } else if (use_simd) {
+        write_column(Feature::spread, [&](double* out) { return SIMDTechnicalIndicators::compute_spread_simd(high.data(), low.data(), n, out); });
+        write_column(Feature::log_pct_change_5, [&](double* out) { return SIMDTechnicalIndicators::log_pct_change_simd(close.data(), n, 5, out); });
+        write_column(Feature::linear_slope_20, [&](double* out) { return SIMDTechnicalIndicators::linear_slope_simd(close.data(), n, 20, out); });
+        write_column(Feature::linear_slope_60, [&](double* out) { return SIMDTechnicalIndicators::linear_slope_simd(close.data(), n, 60, out); });
+        write_column(Feature::momentum, [&](double* out) { return SIMDTechnicalIndicators::calculate_momentum_simd(close.data(), n, 10, out); });
+    } else {
+        write_column(Feature::spread, [&](double* out) { return TechnicalIndicators::compute_spread(high.data(), low.data(), n, out); });
+        write_column(Feature::log_pct_change_5, [&](double* out) { return TechnicalIndicators::log_pct_change(close.data(), n, 5, out); });
+        write_column(Feature::linear_slope_20, [&](double* out) { return TechnicalIndicators::linear_slope(close.data(), n, 20, out); });
+        write_column(Feature::linear_slope_60, [&](double* out) { return TechnicalIndicators::linear_slope(close.data(), n, 60, out); });
+        write_column(Feature::momentum, [&](double* out) { return TechnicalIndicators::momentum(close.data(), n, 10, out); });
+    }
+
+    if (selected(Feature::rsi)) block.assign(Feature::rsi, graph.get<FeatureNode::Rsi14>());
+    write_column(Feature::internal_bar_strength, [&](double* out) {
+        return use_vector ? SIMDTechnicalIndicators::internal_bar_strength_simd(high.data(), low.data(), close.data(), n, out)
+                          : TechnicalIndicators::internal_bar_strength(high.data(), low.data(), close.data(), n, out);
+    });
+    write_column(Feature::candle_way, [&](double* out) { return TechnicalIndicators::candle_way(open.data(), close.data(), n, out); });
+    write_column(Feature::candle_filling, [&](double* out) { return TechnicalIndicators::candle_filling(open.data(), high.data(), low.data(), close.data(), n, out); });
+    write_column(Feature::candle_amplitude, [&](double* out) { return TechnicalIndicators::candle_amplitude(high.data(), low.data(), n, out); });
+    write_column(Feature::velocity, [&](double* out) { return TechnicalIndicators::velocity(close.data(), n, out); });
+    write_column(Feature::acceleration, [&](double* out) { return TechnicalIndicators::acceleration(close.data(), n, out); });
+    write_column(Feature::skewness_30, [&](double* out) { return TechnicalIndicators::skewness(close.data(), n, 30, out); });
+    write_column(Feature::kurtosis_30, [&](double* out) { return TechnicalIndicators::kurtosis(close.data(), n, 30, out); });
+    write_column(Feature::auto_correlation_50_10, [&](double* out) { return TechnicalIndicators::auto_correlation(close.data(), n, 50, 10, out); });
+    if (selected(Feature::kama_10_2_30)) block.assign(Feature::kama_10_2_30, graph.get<FeatureNode::Kama10_2_30>());
+    write_column(Feature::parkinson_volatility_20, [&](double* out) { return TechnicalIndicators::parkinson_volatility(high.data(), low.data(), n, 20, out); });
 
     // Statistical/Mathematical Features
-    features.z_score_20 = TechnicalIndicators::z_score_20(returns);
-    features.percentile_rank_50 = TechnicalIndicators::percentile_rank_50(close);
-    features.coefficient_of_variation_30 = TechnicalIndicators::coefficient_of_variation_30(returns);
-    features.detrended_price_oscillator_20 = TechnicalIndicators::detrended_price_oscillator_20(close);
-    features.hurst_exponent_100 = TechnicalIndicators::hurst_exponent_100(close);
-    features.garch_volatility_21 = TechnicalIndicators::garch_volatility_21(returns);
-    features.shannon_entropy_volume_10 = TechnicalIndicators::shannon_entropy_volume_10(volume);
+    write_column(Feature::z_score_20, [&](double* out) { return FixedWindow<20>::z_score(returns().data(), returns().size(), out); });
+    write_column(Feature::percentile_rank_50, [&](double* out) { return TechnicalIndicators::percentile_rank(close.data(), n, 50, out); });
+    write_column(Feature::coefficient_of_variation_30, [&](double* out) { return TechnicalIndicators::coefficient_of_variation_30(returns().data(), returns().size(), out); });
+    write_column(Feature::detrended_price_oscillator_20, [&](double* out) {
+        const std::vector<double>& sma = graph.get<FeatureNode::Sma20>();
+        return use_vector ? SIMDTechnicalIndicators::detrended_price_oscillator_simd(close.data(), n, sma.data(), sma.size(), 20, out)
+                          : TechnicalIndicators::detrended_price_oscillator(close.data(), n, sma.data(), sma.size(), 20, out);
+    });
+    write_column(Feature::hurst_exponent_100, [&](double* out) { return TechnicalIndicators::hurst_exponent_100(close.data(), n, out); });
+    if (selected(Feature::garch_volatility_21)) block.assign(Feature::garch_volatility_21, graph.get<FeatureNode::GarchVolatility21>());
+    write_column(Feature::shannon_entropy_volume_10, [&](double* out) { return TechnicalIndicators::shannon_entropy_volume_10(volume.data(), n, out); });
 
     // Technical Analysis Extended
-    features.chande_momentum_oscillator_14 = TechnicalIndicators::chande_momentum_oscillator_14(close);
-    features.aroon_oscillator_25 = TechnicalIndicators::aroon_oscillator_25(high, low);
-    features.trix_15 = TechnicalIndicators::trix_15(close);
-    features.vortex_indicator_14 = TechnicalIndicators::vortex_indicator_14(high, low, close);
-    features.supertrend_10_3 = TechnicalIndicators::supertrend_10_3(high, low, close);
-    features.ichimoku_senkou_span_A_9_26 = TechnicalIndicators::ichimoku_senkou_span_A_9_26(high, low);
-    features.ichimoku_senkou_span_B_26_52 = TechnicalIndicators::ichimoku_senkou_span_B_26_52(high, low);
-    features.fisher_transform_10 = TechnicalIndicators::fisher_transform_10(high, low);
+    write_column(Feature::chande_momentum_oscillator_14, [&](double* out) {
+        return use_vector ? SIMDTechnicalIndicators::chande_momentum_oscillator_14_simd(close.data(), n, out)
+                          : TechnicalIndicators::chande_momentum_oscillator_14(close.data(), n, out);
+    });
+    write_column(Feature::aroon_oscillator_25, [&](double* out) { return TechnicalIndicators::aroon_oscillator_25(high.data(), low.data(), n, out); });
+    write_column(Feature::trix_15, [&](double* out) {
+        const std::vector<double>& ema3 = graph.get<FeatureNode::CloseEma15x3>();
+        return TechnicalIndicators::trix_from_triple_ema(ema3.data(), ema3.size(), out);
+    });
+    write_column(Feature::vortex_indicator_14, [&](double* out) {
+        return use_vector ? SIMDTechnicalIndicators::vortex_indicator_14_simd(high.data(), low.data(), close.data(), n, out)
+                          : FixedWindow<14>::vortex_indicator(high.data(), low.data(), close.data(), n, out);
+    });
+    write_column(Feature::supertrend_10_3, [&](double* out) { return TechnicalIndicators::supertrend_10_3(high.data(), low.data(), close.data(), n, out); });
+    write_column(Feature::ichimoku_senkou_span_A_9_26, [&](double* out) { return TechnicalIndicators::ichimoku_senkou_span_A_9_26(high.data(), low.data(), n, out); });
+    write_column(Feature::ichimoku_senkou_span_B_26_52, [&](double* out) { return TechnicalIndicators::ichimoku_senkou_span_B_26_52(high.data(), low.data(), n, out); });
+    write_column(Feature::fisher_transform_10, [&](double* out) { return TechnicalIndicators::fisher_transform_10(high.data(), low.data(), n, out); });
 
     // Volume/Liquidity Advanced
-    features.volume_weighted_average_price_intraday = TechnicalIndicators::volume_weighted_average_price_intraday(high, low, close, volume);
-    features.volume_profile_high_volume_node_intraday = TechnicalIndicators::volume_profile_high_volume_node_intraday(close, volume);
-    features.volume_profile_low_volume_node_intraday = TechnicalIndicators::volume_profile_low_volume_node_intraday(close, volume);
-    features.on_balance_volume_sma_20 = TechnicalIndicators::on_balance_volume_sma_20(close, volume);
-    features.klinger_oscillator_34_55 = TechnicalIndicators::klinger_oscillator_34_55(high, low, close, volume);
-    features.money_flow_index_14 = TechnicalIndicators::money_flow_index_14(high, low, close, volume);
-    features.vwap_deviation_stddev_30 = TechnicalIndicators::vwap_deviation_stddev_30(high, low, close, volume);
+    if (selected(Feature::volume_weighted_average_price_intraday)) block.assign(Feature::volume_weighted_average_price_intraday, graph.get<FeatureNode::Vwap>());
+    write_column(Feature::volume_profile_high_volume_node_intraday, [&](double* out) { return TechnicalIndicators::volume_profile_high_volume_node_intraday(close.data(), volume.data(), n, out); });
+    write_column(Feature::volume_profile_low_volume_node_intraday, [&](double* out) { return TechnicalIndicators::volume_profile_low_volume_node_intraday(close.data(), volume.data(), n, out); });
+    write_column(Feature::on_balance_volume_sma_20, [&](double* out) {
+        return use_vector ? SIMDTechnicalIndicators::on_balance_volume_sma_20_simd(close.data(), volume.data(), n, out)
+                          : TechnicalIndicators::on_balance_volume_sma_20(close.data(), volume.data(), n, out);
+    });
+    if (selected(Feature::klinger_oscillator_34_55)) block.assign(Feature::klinger_oscillator_34_55, graph.get<FeatureNode::Klinger34_55>());
+    write_column(Feature::money_flow_index_14, [&](double* out) {
+        return use_vector ? SIMDTechnicalIndicators::money_flow_index_14_simd(high.data(), low.data(), close.data(), volume.data(), n, out)
+                          : FixedWindow<14>::money_flow_index(high.data(), low.data(), close.data(), volume.data(), n, out);
+    });
+    write_column(Feature::vwap_deviation_stddev_30, [&](double* out) {
+        const std::vector<double>& vwap = graph.get<FeatureNode::Vwap>();
+        return vwap.size() > n ? 0 : TechnicalIndicators::vwap_deviation_stddev(high.data(), low.data(), close.data(), vwap.data(), vwap.size(), 30, out);
+    });
 
     // Regime Detection
-    features.markov_regime_switching_garch_2_state = TechnicalIndicators::markov_regime_switching_garch_2_state(returns);
-    features.adx_rating_14 = TechnicalIndicators::adx_rating_14(high, low, close);
-    features.chow_test_statistic_breakpoint_detection_50 = TechnicalIndicators::chow_test_statistic_breakpoint_detection_50(returns);
-    features.market_regime_hmm_3_states_price_vol = TechnicalIndicators::market_regime_hmm_3_states_price_vol(close, features.volatility);
-    features.high_volatility_indicator_garch_threshold = TechnicalIndicators::high_volatility_indicator_garch_threshold(returns, 0.02);
+    // Columns of the state-major RegimeProbabilities nodes
+    auto regime_column = [&](const std::vector<double>& probabilities, size_t states, size_t state) {
+        const size_t n = probabilities.size() / states;
+        return std::make_pair(probabilities.data() + state * n, n);
+    };
+    if (selected(Feature::markov_regime_switching_garch_2_state)) {
+        const auto high = regime_column(graph.get<FeatureNode::RegimeProbabilities2>(), 2, 1);
+        block.assign(Feature::markov_regime_switching_garch_2_state, high.first, high.second);
+    }
+    write_column(Feature::adx_rating_14, [&](double* out) {
+        return use_vector ? SIMDTechnicalIndicators::adx_rating_14_simd(high.data(), low.data(), close.data(), n, out)
+                          : TechnicalIndicators::adx_rating_14(high.data(), low.data(), close.data(), n, out);
+    });
+    write_column(Feature::chow_test_statistic_breakpoint_detection_50, [&](double* out) { return TechnicalIndicators::chow_test_statistic_breakpoint_detection_50(returns().data(), returns().size(), out); });
+    if (selected(Feature::market_regime_hmm_3_states_price_vol)) block.assign(Feature::market_regime_hmm_3_states_price_vol, RegimeModel::most_likely_states(graph.get<FeatureNode::RegimeProbabilities3>(), 3));
+    if (selected(Feature::hmm_regime_probability_low_vol)) {
+        const auto low = regime_column(graph.get<FeatureNode::RegimeProbabilities3>(), 3, 0);
+        block.assign(Feature::hmm_regime_probability_low_vol, low.first, low.second);
+    }
+    if (selected(Feature::hmm_regime_probability_mid_vol)) {
+        const auto mid = regime_column(graph.get<FeatureNode::RegimeProbabilities3>(), 3, 1);
+        block.assign(Feature::hmm_regime_probability_mid_vol, mid.first, mid.second);
+    }
+    if (selected(Feature::hmm_regime_probability_high_vol)) {
+        const auto high = regime_column(graph.get<FeatureNode::RegimeProbabilities3>(), 3, 2);
+        block.assign(Feature::hmm_regime_probability_high_vol, high.first, high.second);
+    }
+    write_column(Feature::high_volatility_indicator_garch_threshold, [&](double* out) {
+        const std::vector<double>& volatility = graph.get<FeatureNode::GarchFilteredVolatility>();
+        return TechnicalIndicators::volatility_threshold_indicator(volatility.data(), volatility.size(), 0.02, out);
+    });
 
     // Non-Linear/Interaction
-    features.return_x_volume_interaction_10 = TechnicalIndicators::return_x_volume_interaction_10(returns, volume);
-    features.volatility_x_rsi_interaction_14 = TechnicalIndicators::volatility_x_rsi_interaction_14(features.volatility, features.rsi);
-    features.price_to_kama_ratio_20_10_30 = TechnicalIndicators::price_to_kama_ratio_20_10_30(close);
-    features.polynomial_regression_price_degree_2_slope = TechnicalIndicators::polynomial_regression_price_degree_2_slope(close, 20);
+    // The interaction columns pair series of unequal lengths (returns have
+    // one row fewer than volume; volatility and RSI differ by their warm-ups)
+    // and stay empty, as their vector forms do
+    write_column(Feature::return_x_volume_interaction_10, [&](double* out) {
+        const std::vector<double>& r = returns();
+        return r.size() != n ? 0 : TechnicalIndicators::return_x_volume_interaction_10(r.data(), volume.data(), n, out);
+    });
+    write_column(Feature::volatility_x_rsi_interaction_14, [&](double* out) {
+        const std::vector<double>& volatility = graph.get<FeatureNode::RollingVolatility20>();
+        const std::vector<double>& rsi = graph.get<FeatureNode::Rsi14>();
+        return volatility.size() != rsi.size() ? 0 : TechnicalIndicators::volatility_x_rsi_interaction_14(volatility.data(), rsi.data(), rsi.size(), out);
+    });
+    write_column(Feature::price_to_kama_ratio_20_10_30, [&](double* out) {
+        const std::vector<double>& kama = graph.get<FeatureNode::Kama20_10_30>();
+        return kama.size() != n ? 0 : TechnicalIndicators::price_to_kama_ratio(close.data(), kama.data(), n, out);
+    });
+    write_column(Feature::polynomial_regression_price_degree_2_slope, [&](double* out) { return TechnicalIndicators::polynomial_regression_price_degree_2_slope(close.data(), n, 20, out); });
 
     // Alternative Risk Measures
-    features.conditional_value_at_risk_cvar_95_20 = TechnicalIndicators::conditional_value_at_risk_cvar_95_20(returns);
-    features.drawdown_duration_from_peak_50 = TechnicalIndicators::drawdown_duration_from_peak_50(close);
-    features.ulcer_index_14 = TechnicalIndicators::ulcer_index_14(close);
-    features.sortino_ratio_30 = TechnicalIndicators::sortino_ratio_30(returns);
-
-    return features;
+    write_column(Feature::conditional_value_at_risk_cvar_95_20, [&](double* out) { return TechnicalIndicators::conditional_value_at_risk(returns().data(), returns().size(), 20, 0.05, out); });
+    write_column(Feature::drawdown_duration_from_peak_50, [&](double* out) { return TechnicalIndicators::drawdown_duration_from_peak_50(close.data(), n, out); });
+    write_column(Feature::ulcer_index_14, [&](double* out) {
+        return use_vector ? SIMDTechnicalIndicators::ulcer_index_14_simd(close.data(), n, out)
+                          : FixedWindow<14>::ulcer_index(close.data(), n, out);
+    });
+    write_column(Feature::sortino_ratio_30, [&](double* out) { return FixedWindow<30>::sortino_ratio(returns().data(), returns().size(), out); });
 }
 
 std::vector<FeatureSet> BatchOHLCProcessor::batch_calculate_features(
@@ -204,19 +269,149 @@ std::vector<FeatureSet> BatchOHLCProcessor::batch_calculate_features(
     const std::vector<std::vector<double>>& low_prices,
     const std::vector<std::vector<double>>& close_prices,
     const std::vector<std::vector<double>>& volumes,
-    bool force_scalar
+    bool force_scalar,
+    const FeatureMask& selection
 ) {
-    if (close_prices.empty()) return {};
-    std::vector<FeatureSet> results(close_prices.size());
-    std::vector<size_t> indices(close_prices.size());
-    std::iota(indices.begin(), indices.end(), 0);
-
-    std::for_each(indices.begin(), indices.end(),
-        [&](size_t i) {
-            results[i] = calculate_features(
-                open_prices[i], high_prices[i], low_prices[i],
-                close_prices[i], volumes[i], force_scalar
-            );
-        });
+    std::vector<std::unique_ptr<FeatureBlock>> blocks;
+    batch_calculate_features_into(open_prices, high_prices, low_prices, close_prices, volumes, blocks, force_scalar, selection);
+    std::vector<FeatureSet> results(blocks.size());
+    for (size_t i = 0; i < blocks.size(); ++i) results[i] = blocks[i]->to_feature_set();
     return results;
 }
+
+void BatchOHLCProcessor::batch_calculate_features_into(
+    const std::vector<std::vector<double>>& open_prices,
+    const std::vector<std::vector<double>>& high_prices,
+    const std::vector<std::vector<double>>& low_prices,
+    const std::vector<std::vector<double>>& close_prices,
+    const std::vector<std::vector<double>>& volumes,
+    std::vector<std::unique_ptr<FeatureBlock>>& blocks,
+    bool force_scalar,
+    const FeatureMask& selection
+) {
+    blocks.resize(close_prices.size());
+    for (auto& block : blocks) {
+        if (!block) block = std::make_unique<FeatureBlock>();
+    }
+    if (close_prices.empty()) return;
+    std::vector<bool> done(close_prices.size(), false);
+
+    const bool recursive_selected =
+        is_selected(selection, Feature::trix_15) || is_selected(selection, Feature::kama_10_2_30) ||
+        is_selected(selection, Feature::price_to_kama_ratio_20_10_30) || is_selected(selection, Feature::garch_volatility_21) ||
+        is_selected(selection, Feature::klinger_oscillator_34_55);
+    const size_t lanes = select_backend(force_scalar) == ComputeBackend::Scalar ? 1 : SIMDTechnicalIndicators::series_lanes();
+    if (lanes > 1 && recursive_selected) {
+        // Only series of one length can share lanes; leftovers run alone below
+        std::map<size_t, std::vector<size_t>> by_length;
+        for (size_t i = 0; i < close_prices.size(); ++i) {
+            if (well_formed(open_prices[i], high_prices[i], low_prices[i], close_prices[i], volumes[i])) {
+                by_length[close_prices[i].size()].push_back(i);
+            }
+        }
+        for (const auto& entry : by_length) {
+            const std::vector<size_t>& series = entry.second;
+            for (size_t g = 0; g + lanes <= series.size(); g += lanes) {
+                calculate_lane_group(open_prices, high_prices, low_prices, close_prices, volumes,
+                                     series.data() + g, lanes, selection, blocks);
+                for (size_t s = 0; s < lanes; ++s) done[series[g + s]] = true;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < close_prices.size(); ++i) {
+        if (done[i]) continue;
+        calculate_features_into(
+            open_prices[i], high_prices[i], low_prices[i],
+            close_prices[i], volumes[i], *blocks[i], force_scalar, selection
+        );
+    }
+}
+
+void BatchOHLCProcessor::calculate_lane_group(
+    const std::vector<std::vector<double>>& open_prices,
+    const std::vector<std::vector<double>>& high_prices,
+    const std::vector<std::vector<double>>& low_prices,
+    const std::vector<std::vector<double>>& close_prices,
+    const std::vector<std::vector<double>>& volumes,
+    const size_t* series, size_t lanes,
+    const FeatureMask& selection,
+    std::vector<std::unique_ptr<FeatureBlock>>& blocks
+) {
+    const ComputeBackend backend = select_backend(false);
+    std::vector<FeatureGraph> graphs;
+    graphs.reserve(lanes);
+    for (size_t s = 0; s < lanes; ++s) {
+        const size_t i = series[s];
+        graphs.emplace_back(high_prices[i], low_prices[i], close_prices[i], volumes[i], backend);
+    }
+    auto selected = [&](Feature feature) { return is_selected(selection, feature); };
+
+    // Transposed scratch: row t of every series sits in one SIMD register
+    const size_t n = close_prices[series[0]].size();
+    std::vector<double> lane_in(n * lanes), lane_out(n * lanes), lane_aux(n * lanes);
+    auto interleave = [&](auto&& series_of, size_t rows) {
+        for (size_t s = 0; s < lanes; ++s) {
+            const std::vector<double>& values = series_of(s);
+            for (size_t t = 0; t < rows; ++t) lane_in[t * lanes + s] = values[t];
+        }
+    };
+    auto scatter = [&](FeatureNode node, const std::vector<double>& lane_values, size_t rows) {
+        for (size_t s = 0; s < lanes; ++s) {
+            std::vector<double> values(rows);
+            for (size_t t = 0; t < rows; ++t) values[t] = lane_values[t * lanes + s];
+            graphs[s].provide(node, std::move(values));
+        }
+    };
+    auto close_of = [&](size_t s) -> const std::vector<double>& { return close_prices[series[s]]; };
+
+    if (selected(Feature::trix_15)) {
+        interleave(close_of, n);
+        SIMDTechnicalIndicators::ema_lanes(lane_in.data(), n, 15, lane_out.data());
+        scatter(FeatureNode::CloseEma15, lane_out, n);
+        SIMDTechnicalIndicators::ema_lanes(lane_out.data(), n, 15, lane_aux.data());
+        scatter(FeatureNode::CloseEma15x2, lane_aux, n);
+        SIMDTechnicalIndicators::ema_lanes(lane_aux.data(), n, 15, lane_out.data());
+        scatter(FeatureNode::CloseEma15x3, lane_out, n);
+    }
+    // kama() needs l1 + 1 bars; shorter series keep the graph's empty result
+    if (selected(Feature::kama_10_2_30) && n >= 11) {
+        interleave(close_of, n);
+        SIMDTechnicalIndicators::kama_lanes(lane_in.data(), n, 10, 2, 30, lane_out.data());
+        scatter(FeatureNode::Kama10_2_30, lane_out, n);
+    }
+    if (selected(Feature::price_to_kama_ratio_20_10_30) && n >= 21) {
+        interleave(close_of, n);
+        SIMDTechnicalIndicators::kama_lanes(lane_in.data(), n, 20, 10, 30, lane_out.data());
+        scatter(FeatureNode::Kama20_10_30, lane_out, n);
+    }
+    if (selected(Feature::garch_volatility_21)) {
+        const size_t rows = graphs[0].get<FeatureNode::Returns>().size();
+        bool aligned = rows >= 21;
+        for (size_t s = 1; s < lanes && aligned; ++s) aligned = graphs[s].get<FeatureNode::Returns>().size() == rows;
+        if (aligned) {
+            interleave([&](size_t s) -> const std::vector<double>& { return graphs[s].get<FeatureNode::Returns>(); }, rows);
+            SIMDTechnicalIndicators::garch_volatility_21_lanes(lane_in.data(), rows, lane_out.data());
+            scatter(FeatureNode::GarchVolatility21, lane_out, rows - 20);
+        }
+    }
+    if (selected(Feature::klinger_oscillator_34_55) && n >= 2) {
+        std::vector<std::vector<double>> signed_volume(lanes);
+        for (size_t s = 0; s < lanes; ++s) {
+            const size_t i = series[s];
+            signed_volume[s] = SIMDTechnicalIndicators::klinger_signed_volume_simd(high_prices[i], low_prices[i], close_prices[i], volumes[i]);
+        }
+        const size_t rows = n - 1;
+        interleave([&](size_t s) -> const std::vector<double>& { return signed_volume[s]; }, rows);
+        SIMDTechnicalIndicators::ema_lanes(lane_in.data(), rows, 34, lane_out.data());
+        SIMDTechnicalIndicators::ema_lanes(lane_in.data(), rows, 55, lane_aux.data());
+        for (size_t k = 0; k < rows * lanes; ++k) lane_out[k] -= lane_aux[k];
+        scatter(FeatureNode::Klinger34_55, lane_out, rows);
+    }
+
+    for (size_t s = 0; s < lanes; ++s) {
+        const size_t i = series[s];
+        calculate_features_from_graph(open_prices[i], high_prices[i], low_prices[i], close_prices[i], volumes[i],
+                                      graphs[s], *blocks[i], selection);
+    }
+}
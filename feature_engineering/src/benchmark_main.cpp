@@ -0,0 +1,5 @@
+#include "benchmark_registry.h"
+
+int main(int argc, char* argv[]) {
+    return run_benchmark_main(argc, argv);
+}
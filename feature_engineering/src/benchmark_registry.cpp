@@ -0,0 +1,1200 @@
+#include "../include/benchmark_registry.h"
+#include "../include/batch_ohlc_processor.h"
+#include "../include/csv_reader.h"
+#include "../include/feature_block.h"
+#include "../include/feature_selection.h"
+#include "../include/garch_model.h"
+#include "../include/regime_model.h"
+#include "../include/hardware_counters.h"
+#include "../include/live_ingest.h"
+#include "../include/numa_topology.h"
+#include "../include/order_statistics_window.h"
+#include "../include/rolling_hurst.h"
+#include "../include/rolling_moments.h"
+#include "../include/simd_dispatch.h"
+#include "../include/technical_indicators.h"
+#include "../include/window_sweep.h"
+#include "../include/work_stealing_pool.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+using Clock = std::chrono::high_resolution_clock;
+using Body = std::function<size_t()>;
+
+// Results flow here so the compiler cannot drop a timed body
+volatile double benchmark_sink = 0.0;
+
+void consume(double value) {
+    benchmark_sink = benchmark_sink + value;
+}
+
+const SimdKernels* kernels_for(SimdTier tier) {
+    switch (tier) {
+        case SimdTier::Scalar: return scalar_kernels();
+        case SimdTier::NEON: return neon_kernels();
+        case SimdTier::AVX2: return avx2_kernels();
+        case SimdTier::AVX512: return avx512_kernels();
+    }
+    return nullptr;
+}
+
+// Tiers built in and allowed by the active cap, narrowest first
+std::vector<SimdTier> available_tiers() {
+    const SimdTier widest = active_simd_tier();
+    std::vector<SimdTier> tiers;
+    for (SimdTier tier : {SimdTier::Scalar, SimdTier::NEON, SimdTier::AVX2, SimdTier::AVX512}) {
+        if (kernels_for(tier) && (tier == SimdTier::Scalar || tier <= widest)) tiers.push_back(tier);
+    }
+    return tiers;
+}
+
+// 1, 2, 4, ... below the core count, then the core count
+std::vector<unsigned> thread_sweep() {
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> counts;
+    for (unsigned n = 1; n < cores; n *= 2) counts.push_back(n);
+    counts.push_back(cores);
+    return counts;
+}
+
+// `lanes` series per group, stored interleaved as p[t * lanes + s] over the
+// group's shortest length; the last group wraps around to the first series
+struct InterleavedGroup {
+    size_t rows = 0;
+    std::vector<double> values;
+};
+
+std::vector<InterleavedGroup> interleave(const std::vector<std::vector<double>>& columns, size_t lanes) {
+    std::vector<InterleavedGroup> groups;
+    if (columns.empty()) return groups;
+    for (size_t first = 0; first < columns.size(); first += lanes) {
+        InterleavedGroup group;
+        group.rows = SIZE_MAX;
+        for (size_t s = 0; s < lanes; ++s) group.rows = std::min(group.rows, columns[(first + s) % columns.size()].size());
+        group.values.resize(group.rows * lanes);
+        for (size_t s = 0; s < lanes; ++s) {
+            const auto& column = columns[(first + s) % columns.size()];
+            for (size_t t = 0; t < group.rows; ++t) group.values[t * lanes + s] = column[t];
+        }
+        groups.push_back(std::move(group));
+    }
+    return groups;
+}
+
+std::vector<std::vector<double>> closes_of(const BenchmarkDataset& data) {
+    std::vector<std::vector<double>> closes;
+    for (const auto& s : data.series) closes.push_back(s->close);
+    return closes;
+}
+
+std::vector<std::vector<double>> returns_of(const BenchmarkDataset& data) {
+    std::vector<std::vector<double>> returns;
+    for (const auto& s : data.series) returns.push_back(TechnicalIndicators::calculate_returns(s->close));
+    return returns;
+}
+
+size_t longest_series(const BenchmarkDataset& data) {
+    size_t longest = 0;
+    for (const auto& s : data.series) longest = std::max(longest, s->size());
+    return longest;
+}
+
+void add_feature_cases(std::vector<BenchmarkCase>& cases) {
+    // One case per indicator column, its graph dependencies included
+    for (size_t f = 0; f < kFeatureCount; ++f) {
+        const Feature feature = static_cast<Feature>(f);
+        cases.push_back({std::string("indicator/") + feature_name(feature), "indicator",
+            [feature](const BenchmarkDataset& data) -> Body {
+                auto block = std::make_shared<FeatureBlock>();
+                FeatureMask mask;
+                mask.set(static_cast<size_t>(feature));
+                return [&data, block, mask]() {
+                    BatchOHLCProcessor processor;
+                    size_t points = 0;
+                    for (const auto& s : data.series) {
+                        processor.calculate_features_into(s->open, s->high, s->low, s->close, s->volume,
+                                                          *block, false, mask);
+                        points += s->size();
+                    }
+                    return points;
+                };
+            }});
+    }
+
+    // Every feature through the scalar reference and each SIMD tier
+    cases.push_back({"features/all@reference", "features", [](const BenchmarkDataset& data) -> Body {
+        auto block = std::make_shared<FeatureBlock>();
+        return [&data, block]() {
+            BatchOHLCProcessor processor;
+            size_t points = 0;
+            for (const auto& s : data.series) {
+                processor.calculate_features_into(s->open, s->high, s->low, s->close, s->volume, *block, true);
+                points += s->size();
+            }
+            return points;
+        };
+    }});
+    for (SimdTier tier : available_tiers()) {
+        cases.push_back({std::string("features/all@") + simd_tier_name(tier), "features",
+            [tier](const BenchmarkDataset& data) -> Body {
+                auto block = std::make_shared<FeatureBlock>();
+                return [&data, block, tier]() {
+                    limit_simd_tier(tier);
+                    BatchOHLCProcessor processor;
+                    size_t points = 0;
+                    for (const auto& s : data.series) {
+                        processor.calculate_features_into(s->open, s->high, s->low, s->close, s->volume, *block);
+                        points += s->size();
+                    }
+                    return points;
+                };
+            }});
+    }
+    cases.push_back({"features/all_f32", "features", [](const BenchmarkDataset& data) -> Body {
+        auto block = std::make_shared<FeatureBlock>(FeaturePrecision::Float32);
+        return [&data, block]() {
+            BatchOHLCProcessor processor;
+            size_t points = 0;
+            for (const auto& s : data.series) {
+                processor.calculate_features_into(s->open, s->high, s->low, s->close, s->volume, *block);
+                points += s->size();
+            }
+            return points;
+        };
+    }});
+    // The fused returns and bar chains (FusionPlan) against their column-by-column passes
+    for (bool fused : {true, false}) {
+        cases.push_back({std::string("features/fused_chains") + (fused ? "" : "@unfused"), "features",
+            [fused](const BenchmarkDataset& data) -> Body {
+                auto block = std::make_shared<FeatureBlock>();
+                const FeatureMask mask = parse_feature_list(
+                    "returns,volatility,z_score_20,sortino_ratio_30,vortex_indicator_14,adx_rating_14,money_flow_index_14");
+                return [&data, block, mask, fused]() {
+                    BatchOHLCProcessor processor;
+                    processor.set_loop_fusion(fused);
+                    size_t points = 0;
+                    for (const auto& s : data.series) {
+                        processor.calculate_features_into(s->open, s->high, s->low, s->close, s->volume,
+                                                          *block, false, mask);
+                        points += s->size();
+                    }
+                    return points;
+                };
+            }});
+    }
+    cases.push_back({"features/batch_lanes", "features", [](const BenchmarkDataset& data) -> Body {
+        auto columns = std::make_shared<std::vector<std::vector<std::vector<double>>>>(5);
+        for (const auto& s : data.series) {
+            (*columns)[0].push_back(s->open);
+            (*columns)[1].push_back(s->high);
+            (*columns)[2].push_back(s->low);
+            (*columns)[3].push_back(s->close);
+            (*columns)[4].push_back(s->volume);
+        }
+        return [&data, columns]() {
+            BatchOHLCProcessor processor;
+            const auto& c = *columns;
+            thread_local std::vector<std::unique_ptr<FeatureBlock>> blocks;
+            processor.batch_calculate_features_into(c[0], c[1], c[2], c[3], c[4], blocks);
+            consume(static_cast<double>(blocks.size()));
+            return data.total_points();
+        };
+    }});
+}
+
+void add_kernel_cases(std::vector<BenchmarkCase>& cases) {
+    for (SimdTier tier : available_tiers()) {
+        const SimdKernels* k = kernels_for(tier);
+        const std::string at = std::string("@") + simd_tier_name(tier);
+
+        cases.push_back({"kernel/centered_products" + at, "kernel", [k](const BenchmarkDataset& data) -> Body {
+            return [&data, k]() {
+                size_t points = 0;
+                for (const auto& s : data.series) {
+                    double out[3];
+                    k->centered_products(s->close.data(), s->open.data(), s->size(), 100.0, 100.0, out);
+                    consume(out[0]);
+                    points += s->size();
+                }
+                return points;
+            };
+        }});
+        cases.push_back({"kernel/window_sums_20" + at, "kernel", [k](const BenchmarkDataset& data) -> Body {
+            auto out = std::make_shared<std::vector<double>>(longest_series(data));
+            return [&data, k, out]() {
+                size_t points = 0;
+                for (const auto& s : data.series) {
+                    if (s->size() < 20) continue;
+                    k->window_sums(s->close.data(), s->size(), 20, out->data());
+                    consume((*out)[0]);
+                    points += s->size();
+                }
+                return points;
+            };
+        }});
+        cases.push_back({"kernel/true_range" + at, "kernel", [k](const BenchmarkDataset& data) -> Body {
+            auto out = std::make_shared<std::vector<double>>(longest_series(data));
+            return [&data, k, out]() {
+                size_t points = 0;
+                for (const auto& s : data.series) {
+                    if (s->size() < 2) continue;
+                    k->true_range(s->high.data() + 1, s->low.data() + 1, s->close.data(), out->data(), s->size() - 1);
+                    consume((*out)[0]);
+                    points += s->size();
+                }
+                return points;
+            };
+        }});
+        cases.push_back({"kernel/ulcer_sums_14" + at, "kernel", [k](const BenchmarkDataset& data) -> Body {
+            auto out = std::make_shared<std::vector<double>>(longest_series(data));
+            return [&data, k, out]() {
+                size_t points = 0;
+                for (const auto& s : data.series) {
+                    if (s->size() < 14) continue;
+                    k->ulcer_sums(s->close.data(), s->size(), 14, out->data());
+                    consume((*out)[0]);
+                    points += s->size();
+                }
+                return points;
+            };
+        }});
+
+        // Lane recurrences over interleaved groups of series
+        cases.push_back({"kernel/ema_lanes" + at, "kernel", [k](const BenchmarkDataset& data) -> Body {
+            auto groups = std::make_shared<std::vector<InterleavedGroup>>(interleave(closes_of(data), k->lanes));
+            auto out = std::make_shared<std::vector<double>>();
+            return [k, groups, out]() {
+                size_t points = 0;
+                for (const auto& g : *groups) {
+                    out->resize(g.values.size());
+                    k->ema_lanes(g.values.data(), g.rows, 2.0 / 21.0, out->data());
+                    consume(out->empty() ? 0.0 : out->back());
+                    points += g.values.size();
+                }
+                return points;
+            };
+        }});
+        cases.push_back({"kernel/kama_lanes" + at, "kernel", [k](const BenchmarkDataset& data) -> Body {
+            auto groups = std::make_shared<std::vector<InterleavedGroup>>(interleave(closes_of(data), k->lanes));
+            auto out = std::make_shared<std::vector<double>>();
+            return [k, groups, out]() {
+                size_t points = 0;
+                for (const auto& g : *groups) {
+                    out->resize(g.values.size());
+                    k->kama_lanes(g.values.data(), g.rows, 10, 2.0 / 3.0, 2.0 / 31.0, out->data());
+                    consume(out->empty() ? 0.0 : out->back());
+                    points += g.values.size();
+                }
+                return points;
+            };
+        }});
+        cases.push_back({"kernel/garch_variance_lanes" + at, "kernel", [k](const BenchmarkDataset& data) -> Body {
+            auto groups = std::make_shared<std::vector<InterleavedGroup>>(interleave(returns_of(data), k->lanes));
+            auto out = std::make_shared<std::vector<double>>();
+            return [k, groups, out]() {
+                size_t points = 0;
+                for (const auto& g : *groups) {
+                    if (g.rows < 21) continue;
+                    out->resize((g.rows - 20) * k->lanes);
+                    k->garch_variance_lanes(g.values.data(), g.rows, 21, 1e-6, 0.1, 0.85, out->data());
+                    consume(out->back());
+                    points += g.values.size();
+                }
+                return points;
+            };
+        }});
+        cases.push_back({"kernel/garch_likelihood_lanes" + at, "kernel", [k](const BenchmarkDataset& data) -> Body {
+            // Squared standardized returns of each series, one candidate per lane
+            auto z2 = std::make_shared<std::vector<std::vector<double>>>();
+            for (auto& r : returns_of(data)) {
+                double variance = 0.0;
+                for (double x : r) variance += x * x;
+                variance = r.empty() || variance == 0.0 ? 1.0 : variance / r.size();
+                for (double& x : r) x = x * x / variance;
+                z2->push_back(std::move(r));
+            }
+            auto alpha = std::make_shared<std::vector<double>>(k->lanes);
+            auto beta = std::make_shared<std::vector<double>>(k->lanes);
+            for (size_t l = 0; l < k->lanes; ++l) {
+                (*alpha)[l] = 0.05 + 0.02 * l;
+                (*beta)[l] = 0.90 - 0.02 * l;
+            }
+            auto weighted = std::make_shared<std::vector<double>>(k->lanes);
+            auto products = std::make_shared<std::vector<double>>();
+            return [k, z2, alpha, beta, weighted, products]() {
+                const size_t block = SimdKernels::garch_likelihood_block;
+                size_t points = 0;
+                for (const auto& series : *z2) {
+                    products->resize((series.size() + block - 1) / block * k->lanes + k->lanes);
+                    k->garch_likelihood_lanes(series.data(), series.size(), alpha->data(), beta->data(),
+                                              weighted->data(), products->data());
+                    consume((*weighted)[0]);
+                    points += series.size() * k->lanes;
+                }
+                return points;
+            };
+        }});
+        cases.push_back({"kernel/threshold_backtest_lanes" + at, "kernel", [k](const BenchmarkDataset& data) -> Body {
+            // Each series' standardized returns as a z-score, one rule per lane
+            auto z = std::make_shared<std::vector<std::vector<double>>>();
+            for (auto& r : returns_of(data)) {
+                double variance = 0.0;
+                for (double x : r) variance += x * x;
+                const double scale = r.empty() || variance == 0.0 ? 1.0 : std::sqrt(r.size() / variance);
+                for (double& x : r) x *= scale;
+                z->push_back(std::move(r));
+            }
+            auto rules = std::make_shared<std::vector<double>>(4 * k->lanes);
+            for (size_t l = 0; l < k->lanes; ++l) {
+                (*rules)[l] = 1.5 + 0.25 * l;
+                (*rules)[k->lanes + l] = 0.5;
+                (*rules)[2 * k->lanes + l] = 3.0;
+                (*rules)[3 * k->lanes + l] = 20.0;
+            }
+            auto stats = std::make_shared<std::vector<double>>(SimdKernels::backtest_stats * k->lanes);
+            return [k, z, rules, stats]() {
+                const size_t L = k->lanes;
+                size_t points = 0;
+                for (const auto& series : *z) {
+                    k->threshold_backtest_lanes(series.data(), series.size(), rules->data(), rules->data() + L,
+                                                rules->data() + 2 * L, rules->data() + 3 * L, stats->data());
+                    consume((*stats)[2 * L]);
+                    points += series.size() * L;
+                }
+                return points;
+            };
+        }});
+        cases.push_back({"kernel/gram_panel_product" + at, "kernel", [k](const BenchmarkDataset& data) -> Body {
+            auto panels = std::make_shared<std::vector<InterleavedGroup>>(
+                interleave(returns_of(data), SimdKernels::gram_panel));
+            return [k, panels]() {
+                const size_t width = SimdKernels::gram_panel;
+                size_t points = 0;
+                for (const auto& a : *panels) {
+                    for (const auto& b : *panels) {
+                        const size_t depth = std::min(a.rows, b.rows);
+                        double out[width * width] = {};
+                        k->gram_panel_product(a.values.data(), b.values.data(), depth, out);
+                        consume(out[0]);
+                        points += depth * width;
+                    }
+                }
+                return points;
+            };
+        }});
+        cases.push_back({"kernel/adf_lanes" + at, "kernel", [k](const BenchmarkDataset& data) -> Body {
+            auto groups = std::make_shared<std::vector<InterleavedGroup>>(interleave(closes_of(data), k->lanes));
+            const size_t outputs = (SimdKernels::adf_max_lag + 1) * k->lanes;
+            auto coef = std::make_shared<std::vector<double>>(outputs);
+            auto var = std::make_shared<std::vector<double>>(outputs);
+            auto rss = std::make_shared<std::vector<double>>(outputs);
+            return [k, groups, coef, var, rss]() {
+                size_t points = 0;
+                for (const auto& g : *groups) {
+                    if (g.rows <= SimdKernels::adf_max_lag + 2) continue;
+                    k->adf_lanes(g.values.data(), g.rows, SimdKernels::adf_max_lag, coef->data(), var->data(), rss->data());
+                    consume((*coef)[0]);
+                    points += g.values.size();
+                }
+                return points;
+            };
+        }});
+        cases.push_back({"kernel/hedge_filter_lanes" + at, "kernel", [k](const BenchmarkDataset& data) -> Body {
+            // Each series' close hedged against its open
+            std::vector<std::vector<double>> opens;
+            for (const auto& s : data.series) opens.push_back(s->open);
+            auto x = std::make_shared<std::vector<InterleavedGroup>>(interleave(opens, k->lanes));
+            auto y = std::make_shared<std::vector<InterleavedGroup>>(interleave(closes_of(data), k->lanes));
+            auto out = std::make_shared<std::vector<std::vector<double>>>(6);
+            return [k, x, y, out]() {
+                size_t points = 0;
+                for (size_t g = 0; g < x->size(); ++g) {
+                    const size_t rows = (*x)[g].rows;
+                    for (auto& column : *out) column.resize(rows * k->lanes);
+                    auto& o = *out;
+                    k->hedge_filter_lanes((*x)[g].values.data(), (*y)[g].values.data(), rows, 20,
+                                          0.995, 0.0, 0.995,
+                                          o[0].data(), o[1].data(), o[2].data(), o[3].data(), o[4].data(), o[5].data());
+                    consume(o[0].empty() ? 0.0 : o[0].back());
+                    points += rows * k->lanes;
+                }
+                return points;
+            };
+        }});
+    }
+}
+
+void add_statistics_cases(std::vector<BenchmarkCase>& cases) {
+    cases.push_back({"statistics/rolling_moments_30", "statistics", [](const BenchmarkDataset& data) -> Body {
+        return [&data]() {
+            size_t points = 0;
+            RollingMoments moments(30);
+            for (const auto& s : data.series) {
+                moments.reset();
+                double total = 0.0;
+                for (double x : s->close) {
+                    moments.push(x);
+                    if (moments.full()) total += moments.skewness() + moments.excess_kurtosis();
+                }
+                consume(total);
+                points += s->size();
+            }
+            return points;
+        };
+    }});
+    cases.push_back({"statistics/rolling_hurst_100", "statistics", [](const BenchmarkDataset& data) -> Body {
+        auto out = std::make_shared<std::vector<double>>(longest_series(data));
+        return [&data, out]() {
+            RollingHurst hurst(100);
+            size_t points = 0;
+            for (const auto& s : data.series) {
+                if (hurst.compute(s->close.data(), s->size(), out->data()) > 0) consume((*out)[0]);
+                points += s->size();
+            }
+            return points;
+        };
+    }});
+    cases.push_back({"statistics/rolling_hurst_100_multiscale", "statistics", [](const BenchmarkDataset& data) -> Body {
+        auto out = std::make_shared<std::vector<double>>(longest_series(data));
+        return [&data, out]() {
+            RollingHurst hurst(100, {10, 20, 50, 100});
+            size_t points = 0;
+            for (const auto& s : data.series) {
+                if (hurst.compute(s->close.data(), s->size(), out->data()) > 0) consume((*out)[0]);
+                points += s->size();
+            }
+            return points;
+        };
+    }});
+    // Eight window lengths of sma, volatility and linear_slope: one sweep
+    // per series against one single-window call per window and indicator
+    static const std::vector<size_t> kSweepWindows = {5, 10, 20, 30, 60, 90, 120, 250};
+    cases.push_back({"statistics/window_sweep_8", "statistics", [](const BenchmarkDataset& data) -> Body {
+        auto selection = std::make_shared<WindowSweepSelection>();
+        selection->windows = kSweepWindows;
+        selection->indicators = parse_sweep_indicators("sma,volatility,linear_slope");
+        auto columns = std::make_shared<std::vector<WindowSweep::Column>>();
+        return [&data, selection, columns]() {
+            size_t points = 0;
+            for (const auto& s : data.series) {
+                WindowSweep::compute(s->close, *selection, *columns);
+                if (!columns->front().values.empty()) consume(columns->front().values[0]);
+                points += s->size() * kSweepWindows.size();
+            }
+            return points;
+        };
+    }});
+    cases.push_back({"statistics/window_sweep_8@per_window", "statistics", [](const BenchmarkDataset& data) -> Body {
+        return [&data]() {
+            size_t points = 0;
+            for (const auto& s : data.series) {
+                const auto returns = TechnicalIndicators::calculate_returns(s->close);
+                for (size_t window : kSweepWindows) {
+                    const int w = static_cast<int>(window);
+                    consume(static_cast<double>(TechnicalIndicators::simple_moving_average(s->close, window).size() +
+                                                TechnicalIndicators::calculate_rolling_volatility(returns, w).size() +
+                                                TechnicalIndicators::linear_slope(s->close, w).size()));
+                }
+                points += s->size() * kSweepWindows.size();
+            }
+            return points;
+        };
+    }});
+    cases.push_back({"statistics/order_statistics_50", "statistics", [](const BenchmarkDataset& data) -> Body {
+        return [&data]() {
+            size_t points = 0;
+            for (const auto& s : data.series) {
+                // Rank of each close within the trailing 50, as percentile_rank_50
+                OrderStatisticWindow window(s->close);
+                double total = 0.0;
+                for (size_t i = 0; i < s->size(); ++i) {
+                    window.insert(s->close[i]);
+                    if (i >= 50) window.erase(s->close[i - 50]);
+                    total += static_cast<double>(window.count_less(s->close[i]));
+                }
+                consume(total);
+                points += s->size();
+            }
+            return points;
+        };
+    }});
+    cases.push_back({"statistics/garch_fit", "statistics", [](const BenchmarkDataset& data) -> Body {
+        auto returns = std::make_shared<std::vector<std::vector<double>>>(returns_of(data));
+        return [returns]() {
+            size_t points = 0;
+            for (const auto& r : *returns) {
+                consume(GarchModel::fit(r).alpha);
+                points += r.size();
+            }
+            return points;
+        };
+    }});
+    cases.push_back({"statistics/garch_fit_batch", "statistics", [](const BenchmarkDataset& data) -> Body {
+        auto returns = std::make_shared<std::vector<std::vector<double>>>(returns_of(data));
+        return [returns]() {
+            size_t points = 0;
+            for (const auto& params : GarchModel::fit_batch(*returns)) consume(params.alpha);
+            for (const auto& r : *returns) points += r.size();
+            return points;
+        };
+    }});
+    cases.push_back({"statistics/regime_filter_3", "statistics", [](const BenchmarkDataset& data) -> Body {
+        auto returns = std::make_shared<std::vector<std::vector<double>>>(returns_of(data));
+        return [returns]() {
+            size_t points = 0;
+            std::vector<double> probabilities;
+            for (const auto& r : *returns) {
+                probabilities.resize(3 * r.size());
+                RegimeModel::filter(r.data(), r.size(), RegimeModel::default_params(r.data(), r.size(), 3),
+                                    probabilities.data());
+                consume(probabilities.empty() ? 0.0 : probabilities.back());
+                points += r.size();
+            }
+            return points;
+        };
+    }});
+    cases.push_back({"statistics/regime_fit_batch_3", "statistics", [](const BenchmarkDataset& data) -> Body {
+        auto returns = std::make_shared<std::vector<std::vector<double>>>(returns_of(data));
+        return [returns]() {
+            size_t points = 0;
+            for (const auto& params : RegimeModel::fit_batch(*returns, 3)) consume(params.variance[0]);
+            for (const auto& r : *returns) points += r.size();
+            return points;
+        };
+    }});
+}
+
+void add_pipeline_cases(std::vector<BenchmarkCase>& cases) {
+    // Every feature for every series on the work-stealing pool
+    for (unsigned threads : thread_sweep()) {
+        cases.push_back({"parallel/features_all@" + std::to_string(threads) + "t", "parallel",
+            [threads](const BenchmarkDataset& data) -> Body {
+                auto costs = std::make_shared<std::vector<size_t>>();
+                for (const auto& s : data.series) costs->push_back(s->size());
+                return [&data, threads, costs]() {
+                    WorkStealingPool pool(threads);
+                    std::vector<std::unique_ptr<FeatureBlock>> blocks;
+                    for (unsigned w = 0; w < pool.size(); ++w) blocks.push_back(std::make_unique<FeatureBlock>());
+                    BatchOHLCProcessor processor;
+                    pool.run(*costs, [&](size_t i, unsigned worker) {
+                        const OHLCVData& s = *data.series[i];
+                        processor.calculate_features_into(s.open, s.high, s.low, s.close, s.volume, *blocks[worker]);
+                    });
+                    return data.total_points();
+                };
+            }});
+    }
+
+    // Every bar replayed as a quote and four trades (open, high, low, close)
+    // through the live ingestion front-end, symbols interleaved bar by bar,
+    // from one submitting thread into `shards` consumers; points are ticks
+    for (unsigned shards : thread_sweep()) {
+        cases.push_back({"live/ingest_ticks@" + std::to_string(shards) + "t", "live",
+            [shards](const BenchmarkDataset& data) -> Body {
+                constexpr int64_t kBarNs = 60'000'000'000;
+                auto ticks = std::make_shared<std::vector<MarketTick>>();
+                const size_t longest = longest_series(data);
+                for (size_t t = 0; t < longest; ++t) {
+                    for (size_t s = 0; s < data.series.size(); ++s) {
+                        const OHLCVData& series = *data.series[s];
+                        if (t >= series.size()) continue;
+                        const auto id = static_cast<uint32_t>(s);
+                        const int64_t start = static_cast<int64_t>(t) * kBarNs;
+                        const double half_spread = 0.0005 * series.close[t];
+                        MarketTick quote{id, TickKind::Quote, start, 0.0, 0.0,
+                                         series.open[t] - half_spread, series.open[t] + half_spread};
+                        ticks->push_back(quote);
+                        const double prices[] = {series.open[t], series.high[t], series.low[t], series.close[t]};
+                        for (int k = 0; k < 4; ++k) {
+                            ticks->push_back({id, TickKind::Trade, start + (k + 1) * kBarNs / 5, prices[k],
+                                              series.volume[t] / 4});
+                        }
+                    }
+                }
+                return [&data, shards, ticks]() {
+                    LiveIngestConfig config;
+                    config.shards = shards;
+                    config.single_producer = true;
+                    LiveIngestEngine engine(config, [](const LiveFeatureUpdate& update) {
+                        consume(update.bar.close);
+                    });
+                    for (const auto& s : data.series) engine.add_symbol(s->symbol);
+                    engine.start();
+                    for (const MarketTick& tick : *ticks) {
+                        while (!engine.submit(tick)) std::this_thread::yield();
+                    }
+                    engine.stop();
+                    return ticks->size();
+                };
+            }});
+    }
+
+    // Re-reads the replayed files; synthetic datasets have none
+    cases.push_back({"io/csv_read", "io", [](const BenchmarkDataset& data) -> Body {
+        if (data.files.empty()) return nullptr;
+        return [&data]() {
+            size_t points = 0;
+            for (const auto& path : data.files) {
+                auto series = FastCSVReader::read_csv_file(path);
+                if (series) points += series->size();
+            }
+            return points;
+        };
+    }});
+    // Streaming copy of every close column: the memory-bandwidth ceiling
+    // the memory-bound kernels above can be read against
+    cases.push_back({"io/memory_copy", "io", [](const BenchmarkDataset& data) -> Body {
+        auto out = std::make_shared<std::vector<double>>(longest_series(data));
+        return [&data, out]() {
+            size_t points = 0;
+            for (const auto& s : data.series) {
+                std::copy(s->close.begin(), s->close.end(), out->begin());
+                consume((*out)[0]);
+                points += s->size();
+            }
+            return points;
+        };
+    }});
+}
+
+std::vector<BenchmarkCase> build_registry() {
+    std::vector<BenchmarkCase> cases;
+    add_feature_cases(cases);
+    add_kernel_cases(cases);
+    add_statistics_cases(cases);
+    add_pipeline_cases(cases);
+    return cases;
+}
+
+std::string json_escape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+// Just enough JSON to read back write_benchmark_json's output
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object } type = Type::Null;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> items;
+    std::map<std::string, JsonValue> members;
+
+    const JsonValue* find(const std::string& key) const {
+        auto it = members.find(key);
+        return it == members.end() ? nullptr : &it->second;
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : text_(text) {}
+
+    JsonValue parse() {
+        JsonValue value = parse_value();
+        skip_space();
+        if (pos_ != text_.size()) fail("trailing characters");
+        return value;
+    }
+
+private:
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("JSON " + what + " at offset " + std::to_string(pos_));
+    }
+
+    void skip_space() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) ++pos_;
+    }
+
+    bool consume_literal(const char* literal) {
+        const size_t length = std::strlen(literal);
+        if (text_.compare(pos_, length, literal) != 0) return false;
+        pos_ += length;
+        return true;
+    }
+
+    void expect(char c) {
+        skip_space();
+        if (pos_ >= text_.size() || text_[pos_] != c) fail(std::string("expected '") + c + "'");
+        ++pos_;
+    }
+
+    std::string parse_string() {
+        expect('"');
+        std::string out;
+        while (pos_ < text_.size() && text_[pos_] != '"') {
+            char c = text_[pos_++];
+            if (c == '\\' && pos_ < text_.size()) {
+                const char escaped = text_[pos_++];
+                switch (escaped) {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'r': out += '\r'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'u':
+                        if (pos_ + 4 > text_.size()) fail("bad escape");
+                        out += static_cast<char>(std::strtol(text_.substr(pos_, 4).c_str(), nullptr, 16));
+                        pos_ += 4;
+                        break;
+                    default: out += escaped;
+                }
+            } else {
+                out += c;
+            }
+        }
+        if (pos_ >= text_.size()) fail("unterminated string");
+        ++pos_;
+        return out;
+    }
+
+    JsonValue parse_value() {
+        skip_space();
+        if (pos_ >= text_.size()) fail("unexpected end");
+        JsonValue value;
+        const char c = text_[pos_];
+        if (c == '{') {
+            value.type = JsonValue::Type::Object;
+            ++pos_;
+            skip_space();
+            if (pos_ < text_.size() && text_[pos_] == '}') { ++pos_; return value; }
+            do {
+                std::string key = parse_string();
+                expect(':');
+                value.members[key] = parse_value();
+                skip_space();
+            } while (pos_ < text_.size() && text_[pos_] == ',' && ++pos_);
+            expect('}');
+        } else if (c == '[') {
+            value.type = JsonValue::Type::Array;
+            ++pos_;
+            skip_space();
+            if (pos_ < text_.size() && text_[pos_] == ']') { ++pos_; return value; }
+            do {
+                value.items.push_back(parse_value());
+                skip_space();
+            } while (pos_ < text_.size() && text_[pos_] == ',' && ++pos_);
+            expect(']');
+        } else if (c == '"') {
+            value.type = JsonValue::Type::String;
+            value.string = parse_string();
+        } else if (consume_literal("true")) {
+            value.type = JsonValue::Type::Bool;
+            value.number = 1.0;
+        } else if (consume_literal("false")) {
+            value.type = JsonValue::Type::Bool;
+        } else if (consume_literal("null")) {
+            value.type = JsonValue::Type::Null;
+        } else {
+            const char* start = text_.c_str() + pos_;
+            char* end = nullptr;
+            value.number = std::strtod(start, &end);
+            if (end == start) fail("unexpected character");
+            value.type = JsonValue::Type::Number;
+            pos_ += static_cast<size_t>(end - start);
+        }
+        return value;
+    }
+
+    const std::string& text_;
+    size_t pos_ = 0;
+};
+
+double number_member(const JsonValue& object, const char* key) {
+    const JsonValue* value = object.find(key);
+    return value && value->type == JsonValue::Type::Number ? value->number : 0.0;
+}
+
+std::string string_member(const JsonValue& object, const char* key) {
+    const JsonValue* value = object.find(key);
+    return value && value->type == JsonValue::Type::String ? value->string : std::string();
+}
+
+std::vector<std::string> split_list(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    for (std::string item; std::getline(stream, item, ',');) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+void print_usage() {
+    std::cout << "Usage: run_benchmarks [options]\n"
+              << "  --list                 Print the registered cases and exit\n"
+              << "  --filter a,b           Run the cases whose names contain any of these\n"
+              << "  --warmup N             Untimed runs per case (default 1)\n"
+              << "  --repetitions N        Timed runs per case (default 5)\n"
+              << "  --series N --bars N    Synthetic dataset shape (default 32 x 5000)\n"
+              << "  --csv-dir DIR          Replay the OHLCV CSVs of DIR instead\n"
+              << "  --csv-limit N          At most N files of --csv-dir\n"
+              << "  --simd TIER            Cap the SIMD tier (scalar|neon|avx2|avx512)\n"
+              << "  --counters on|off      Cycles per point and IPC from hardware counters\n"
+              << "  --json PATH            Write the results as JSON\n"
+              << "  --compare PATH         Compare against a baseline JSON; exit 1 on a regression\n"
+              << "  --threshold F          Median slowdown counted as a regression (default 0.10)\n";
+}
+}
+
+size_t BenchmarkDataset::total_points() const {
+    size_t points = 0;
+    for (const auto& s : series) points += s->size();
+    return points;
+}
+
+BenchmarkDataset BenchmarkDataset::synthetic(size_t series, size_t bars) {
+    BenchmarkDataset data;
+    data.name = "synthetic_" + std::to_string(series) + "x" + std::to_string(bars);
+    std::mt19937 gen(42);
+    std::normal_distribution<double> move(0.0, 0.02);
+    std::uniform_real_distribution<double> wick(0.0, 0.01);
+    std::uniform_int_distribution<int> lots(500, 5000);
+    const auto start = std::chrono::system_clock::time_point(std::chrono::hours(24 * 365 * 50));
+    for (size_t s = 0; s < series; ++s) {
+        auto stock = std::make_unique<OHLCVData>();
+        stock->symbol = "SYN" + std::to_string(s);
+        stock->reserve(bars);
+        double price = 50.0 + 5.0 * static_cast<double>(s % 20);
+        for (size_t i = 0; i < bars; ++i) {
+            const double open = price;
+            price *= 1.0 + move(gen);
+            stock->timestamps.push_back(start + std::chrono::minutes(i));
+            stock->open.push_back(open);
+            stock->high.push_back(std::max(open, price) * (1.0 + wick(gen)));
+            stock->low.push_back(std::min(open, price) * (1.0 - wick(gen)));
+            stock->close.push_back(price);
+            stock->volume.push_back(static_cast<double>(lots(gen)));
+        }
+        data.series.push_back(std::move(stock));
+    }
+    return data;
+}
+
+BenchmarkDataset BenchmarkDataset::replay(const std::string& directory, size_t limit) {
+    BenchmarkDataset data;
+    data.name = std::filesystem::path(directory).lexically_normal().filename().string();
+    if (data.name.empty()) data.name = directory;
+
+    std::vector<std::string> paths;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".csv") paths.push_back(entry.path().string());
+    }
+    // Sorted so a limited replay picks the same files every run
+    std::sort(paths.begin(), paths.end());
+    for (const auto& path : paths) {
+        if (limit && data.series.size() >= limit) break;
+        try {
+            auto series = FastCSVReader::read_csv_file(path);
+            if (!series || series->empty()) continue;
+            data.series.push_back(std::move(series));
+            data.files.push_back(path);
+        } catch (const std::exception& e) {
+            std::cerr << "Skipping " << path << ": " << e.what() << std::endl;
+        }
+    }
+    if (data.series.empty()) throw std::runtime_error("No readable CSV files in " + directory);
+    return data;
+}
+
+const std::vector<BenchmarkCase>& benchmark_registry() {
+    static const std::vector<BenchmarkCase> cases = build_registry();
+    return cases;
+}
+
+bool benchmark_selected(const BenchmarkCase& benchmark, const BenchmarkOptions& options) {
+    if (options.filters.empty()) return true;
+    for (const auto& filter : options.filters) {
+        if (benchmark.name.find(filter) != std::string::npos) return true;
+    }
+    return false;
+}
+
+std::vector<BenchmarkResult> run_benchmarks(const std::vector<BenchmarkCase>& cases,
+                                            const BenchmarkDataset& dataset,
+                                            const BenchmarkOptions& options) {
+    std::vector<BenchmarkResult> results;
+    const SimdTier original_tier = active_simd_tier();
+    const size_t repetitions = std::max<size_t>(1, options.repetitions);
+
+    for (const auto& benchmark : cases) {
+        if (!benchmark_selected(benchmark, options)) continue;
+        const Body body = benchmark.prepare(dataset);
+        if (!body) continue;
+
+        for (size_t w = 0; w < options.warmup; ++w) body();
+
+        std::unique_ptr<HardwareCounters> counters;
+        if (hardware_counters_enabled()) {
+            counters = std::make_unique<HardwareCounters>(true);
+            if (counters->valid()) counters->start(); else counters.reset();
+        }
+        std::vector<double> times;
+        size_t points = 0;
+        for (size_t r = 0; r < repetitions; ++r) {
+            const auto start = Clock::now();
+            points = body();
+            times.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        const CounterValues counted = counters ? counters->read() : CounterValues{};
+        limit_simd_tier(original_tier);
+
+        BenchmarkResult result;
+        result.name = benchmark.name;
+        result.group = benchmark.group;
+        result.repetitions = repetitions;
+        result.points = points;
+        std::sort(times.begin(), times.end());
+        result.min_ms = times.front();
+        result.max_ms = times.back();
+        const size_t mid = times.size() / 2;
+        result.median_ms = times.size() % 2 ? times[mid] : 0.5 * (times[mid - 1] + times[mid]);
+        result.mean_ms = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+        if (times.size() > 1) {
+            double squares = 0.0;
+            for (double t : times) squares += (t - result.mean_ms) * (t - result.mean_ms);
+            result.stddev_ms = std::sqrt(squares / (times.size() - 1));
+        }
+        if (result.median_ms > 0.0) result.points_per_second = points / (result.median_ms / 1000.0);
+        if (points > 0 && counted.cycles > 0) {
+            result.cycles_per_point = static_cast<double>(counted.cycles) / (static_cast<double>(points) * repetitions);
+            result.ipc = counted.ipc();
+        }
+
+        if (!options.quiet) {
+            std::cout << "  " << std::left << std::setw(52) << result.name << std::right << std::fixed
+                      << std::setprecision(3) << std::setw(11) << result.median_ms << " ms  +- "
+                      << std::setw(8) << result.stddev_ms << "  " << std::setprecision(1)
+                      << std::setw(9) << result.points_per_second / 1e6 << " Mpts/s";
+            if (result.cycles_per_point > 0.0) {
+                std::cout << "  " << std::setprecision(2) << result.cycles_per_point << " cyc/pt, IPC " << result.ipc;
+            }
+            std::cout << std::endl;
+        }
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+void write_benchmark_json(const std::string& path, const BenchmarkDataset& dataset,
+                          const BenchmarkOptions& options, const std::vector<BenchmarkResult>& results) {
+    std::ofstream file(path);
+    if (!file.is_open()) throw std::runtime_error("Cannot create file: " + path);
+    file << std::setprecision(10);
+    file << "{\n";
+    file << "  \"schema\": \"mft-benchmark-1\",\n";
+    file << "  \"host\": {\"cores\": " << std::thread::hardware_concurrency()
+         << ", \"numa_nodes\": " << NumaTopology::system().nodes()
+         << ", \"simd_tier\": \"" << simd_tier_name(active_simd_tier()) << "\"},\n";
+    file << "  \"dataset\": {\"name\": \"" << json_escape(dataset.name) << "\", \"series\": " << dataset.series.size()
+         << ", \"points\": " << dataset.total_points() << "},\n";
+    file << "  \"options\": {\"warmup\": " << options.warmup << ", \"repetitions\": " << options.repetitions << "},\n";
+    file << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& r = results[i];
+        file << (i ? ",\n" : "\n")
+             << "    {\"name\": \"" << json_escape(r.name) << "\", \"group\": \"" << json_escape(r.group)
+             << "\", \"repetitions\": " << r.repetitions << ", \"points\": " << r.points
+             << ", \"min_ms\": " << r.min_ms << ", \"median_ms\": " << r.median_ms
+             << ", \"mean_ms\": " << r.mean_ms << ", \"stddev_ms\": " << r.stddev_ms
+             << ", \"max_ms\": " << r.max_ms << ", \"points_per_second\": " << r.points_per_second
+             << ", \"cycles_per_point\": " << r.cycles_per_point << ", \"ipc\": " << r.ipc << "}";
+    }
+    file << "\n  ]\n}\n";
+    if (!file) throw std::runtime_error("Error writing benchmark results: " + path);
+}
+
+std::vector<BenchmarkResult> read_benchmark_json(const std::string& path, std::string* dataset_name) {
+    std::ifstream file(path);
+    if (!file.is_open()) throw std::runtime_error("Cannot open file: " + path);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string text = buffer.str();
+    const JsonValue root = JsonParser(text).parse();
+
+    const JsonValue* list = root.find("results");
+    if (root.type != JsonValue::Type::Object || !list || list->type != JsonValue::Type::Array) {
+        throw std::runtime_error("Not a benchmark results file: " + path);
+    }
+    if (dataset_name) {
+        const JsonValue* dataset = root.find("dataset");
+        *dataset_name = dataset ? string_member(*dataset, "name") : std::string();
+    }
+    std::vector<BenchmarkResult> results;
+    for (const JsonValue& item : list->items) {
+        BenchmarkResult r;
+        r.name = string_member(item, "name");
+        if (r.name.empty()) continue;
+        r.group = string_member(item, "group");
+        r.repetitions = static_cast<size_t>(number_member(item, "repetitions"));
+        r.points = static_cast<size_t>(number_member(item, "points"));
+        r.min_ms = number_member(item, "min_ms");
+        r.median_ms = number_member(item, "median_ms");
+        r.mean_ms = number_member(item, "mean_ms");
+        r.stddev_ms = number_member(item, "stddev_ms");
+        r.max_ms = number_member(item, "max_ms");
+        r.points_per_second = number_member(item, "points_per_second");
+        r.cycles_per_point = number_member(item, "cycles_per_point");
+        r.ipc = number_member(item, "ipc");
+        results.push_back(std::move(r));
+    }
+    return results;
+}
+
+std::vector<BenchmarkComparison> compare_benchmarks(const std::vector<BenchmarkResult>& baseline,
+                                                    const std::vector<BenchmarkResult>& current,
+                                                    double threshold) {
+    std::map<std::string, const BenchmarkResult*> by_name;
+    for (const auto& r : baseline) by_name[r.name] = &r;
+
+    std::vector<BenchmarkComparison> comparisons;
+    for (const auto& now : current) {
+        auto it = by_name.find(now.name);
+        if (it == by_name.end() || it->second->median_ms <= 0.0) continue;
+        const BenchmarkResult& base = *it->second;
+        BenchmarkComparison c;
+        c.name = now.name;
+        c.baseline_ms = base.median_ms;
+        c.current_ms = now.median_ms;
+        c.change = now.median_ms / base.median_ms - 1.0;
+        const double noise = 2.0 * std::max(base.stddev_ms, now.stddev_ms);
+        c.regression = c.change > threshold && now.median_ms - base.median_ms > noise;
+        comparisons.push_back(std::move(c));
+    }
+    return comparisons;
+}
+
+int run_benchmark_main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    size_t series = 32, bars = 5000, csv_limit = 0;
+    std::string csv_dir, json_path, compare_path;
+    double threshold = 0.10;
+    bool list = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--list") {
+            list = true;
+        } else if (arg == "--filter" && has_value) {
+            options.filters = split_list(argv[++i]);
+        } else if (arg == "--warmup" && has_value) {
+            options.warmup = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--repetitions" && has_value) {
+            options.repetitions = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--series" && has_value) {
+            series = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--bars" && has_value) {
+            bars = static_cast<size_t>(std::max(2, std::atoi(argv[++i])));
+        } else if (arg == "--csv-dir" && has_value) {
+            csv_dir = argv[++i];
+        } else if (arg == "--csv-limit" && has_value) {
+            csv_limit = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--simd" && has_value) {
+            try {
+                limit_simd_tier(parse_simd_tier(argv[++i]));
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << " (use scalar, neon, avx2 or avx512)" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--counters" && has_value) {
+            set_hardware_counters(std::string(argv[++i]) != "off");
+        } else if (arg == "--json" && has_value) {
+            json_path = argv[++i];
+        } else if (arg == "--compare" && has_value) {
+            compare_path = argv[++i];
+        } else if (arg == "--threshold" && has_value) {
+            threshold = std::atof(argv[++i]);
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            print_usage();
+            return 1;
+        }
+    }
+
+    const auto& cases = benchmark_registry();
+    if (list) {
+        for (const auto& benchmark : cases) {
+            if (benchmark_selected(benchmark, options)) std::cout << benchmark.name << std::endl;
+        }
+        return 0;
+    }
+
+    try {
+        const BenchmarkDataset dataset = csv_dir.empty() ? BenchmarkDataset::synthetic(series, bars)
+                                                         : BenchmarkDataset::replay(csv_dir, csv_limit);
+        std::cout << "=== BENCHMARKS ===" << std::endl;
+        std::cout << "Dataset: " << dataset.name << " (" << dataset.series.size() << " series, "
+                  << dataset.total_points() << " points)" << std::endl;
+        std::cout << "SIMD Tier: " << simd_tier_name(active_simd_tier()) << ", CPU Cores: "
+                  << std::thread::hardware_concurrency() << ", NUMA Nodes: " << NumaTopology::system().nodes()
+                  << std::endl;
+        std::cout << "Warmup " << options.warmup << ", repetitions " << options.repetitions
+                  << " (median +- standard deviation)" << std::endl;
+
+        const auto results = run_benchmarks(cases, dataset, options);
+        if (hardware_counters_enabled() && !HardwareCounters::supported()) {
+            std::cout << "Hardware counters: perf_event unavailable" << std::endl;
+        }
+        if (!json_path.empty()) {
+            write_benchmark_json(json_path, dataset, options, results);
+            std::cout << "Results written to: " << json_path << std::endl;
+        }
+
+        if (!compare_path.empty()) {
+            std::string baseline_dataset;
+            const auto baseline = read_benchmark_json(compare_path, &baseline_dataset);
+            if (baseline_dataset != dataset.name) {
+                std::cout << "Warning: baseline dataset " << baseline_dataset << " differs from " << dataset.name
+                          << std::endl;
+            }
+            const auto comparisons = compare_benchmarks(baseline, results, threshold);
+            size_t regressions = 0;
+            std::cout << "=== COMPARISON vs " << compare_path << " (threshold " << std::fixed
+                      << std::setprecision(1) << threshold * 100.0 << "%) ===" << std::endl;
+            for (const auto& c : comparisons) {
+                if (c.regression) ++regressions;
+                std::cout << "  " << std::left << std::setw(52) << c.name << std::right << std::setprecision(3)
+                          << std::setw(11) << c.baseline_ms << " -> " << std::setw(11) << c.current_ms << " ms  "
+                          << std::showpos << std::setprecision(1) << std::setw(7) << c.change * 100.0 << "%"
+                          << std::noshowpos << (c.regression ? "  REGRESSION" : "") << std::endl;
+            }
+            std::cout << comparisons.size() << " cases compared, " << regressions << " regression(s)" << std::endl;
+            if (regressions > 0) return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
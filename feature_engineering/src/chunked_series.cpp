@@ -0,0 +1,145 @@
+#include "chunked_series.h"
+#include "columnar_writer.h"
+#include "csv_reader.h"
+#include "csv_writer.h"
+#include "streaming_feature_engine.h"
+#include "window_sweep.h"
+#include <algorithm>
+#include <array>
+#include <memory>
+
+namespace {
+
+// Calls f on every pair of matching row columns of a and b
+template <typename F>
+void for_each_row_column(OHLCVData& a, OHLCVData& b, F f) {
+    f(a.timestamps, b.timestamps);
+    f(a.open, b.open);
+    f(a.high, b.high);
+    f(a.low, b.low);
+    f(a.close, b.close);
+    f(a.volume, b.volume);
+}
+
+// Moves the rows of `from` to the front of `to`
+void prepend_rows(OHLCVData& to, OHLCVData& from) {
+    for_each_row_column(to, from, [](auto& dst, auto& src) {
+        dst.insert(dst.begin(), src.begin(), src.end());
+        src.clear();
+    });
+}
+
+// Moves the last `count` rows of `from` into `to`, replacing its rows
+void split_rows(OHLCVData& from, size_t count, OHLCVData& to) {
+    for_each_row_column(from, to, [count](auto& src, auto& dst) {
+        dst.assign(src.end() - count, src.end());
+        src.resize(src.size() - count);
+    });
+}
+
+}
+
+ChunkedSeriesResult process_series_in_chunks(const std::string& csv_file,
+                                             const std::string& output_dir,
+                                             const FeatureMask& selection,
+                                             const PipelineConfig& config,
+                                             size_t chunk_rows) {
+    FastCSVReader::ChunkReader reader(csv_file);
+    const bool csv = config.format != OutputFormat::Columnar;
+    const bool columnar = config.format != OutputFormat::Csv;
+    const bool sweep = config.window_sweep.enabled();
+    const size_t lookback = sweep ? *std::max_element(config.window_sweep.windows.begin(),
+                                                      config.window_sweep.windows.end()) : 0;
+
+    // Feature values not written yet; pending.<column>[0] belongs to row
+    // pending_row[column]. A column can owe a row its value until a later
+    // bar (the return-based windows lag a row behind their row offsets), so
+    // rows are held back until every started column has caught up, and
+    // values for rows past the chunk wait for the next one.
+    FeatureSet drained, pending;
+    std::array<size_t, kFeatureCount> pending_row{};
+    for (size_t f = 0; f < kFeatureCount; ++f) pending_row[f] = feature_row_offset(static_cast<Feature>(f));
+
+    ChunkedSeriesResult result;
+    StreamingFeatureEngine engine;
+    OHLCVData chunk, held;                              // held: rows read but not written yet
+    std::unique_ptr<ColumnarAppender> columnar_out;
+    std::vector<double> closes;                         // written rows' lookback, then this chunk's closes
+    std::vector<WindowSweep::Column> sweep_columns;
+    std::vector<FastCSVWriter::NamedColumn> views;
+    std::string base;
+    size_t read_rows = 0;
+
+    for (bool more = true; more;) {
+        more = reader.next(chunk, chunk_rows);
+        for (size_t i = 0; i < chunk.size(); ++i) {
+            engine.on_bar(chunk.open[i], chunk.high[i], chunk.low[i], chunk.close[i], chunk.volume[i]);
+        }
+        read_rows += chunk.size();
+        engine.take_features(drained);
+        size_t hold = 0;
+#define CHUNKED_PENDING(name, offset) \
+        { \
+            const size_t f = static_cast<size_t>(Feature::name); \
+            pending.name.insert(pending.name.end(), drained.name.begin(), drained.name.end()); \
+            const bool started = !pending.name.empty() || pending_row[f] > offset; \
+            const size_t known = pending_row[f] + pending.name.size(); \
+            if (more && started && selection.test(f) && known < read_rows) hold = std::max(hold, read_rows - known); \
+        }
+        FEATURE_COLUMNS(CHUNKED_PENDING)
+#undef CHUNKED_PENDING
+
+        prepend_rows(chunk, held);
+        hold = std::min(hold, chunk.size());
+        split_rows(chunk, hold, held);
+        if (chunk.empty()) continue;
+
+        const size_t first_row = result.rows;
+        if (first_row == 0) {
+            base = output_dir + "/" + chunk.symbol;
+            if (columnar) {
+                columnar_out = std::make_unique<ColumnarAppender>(base + "_features" + kColumnarExtension,
+                                                                  chunk.symbol, config.data_frequency, selection,
+                                                                  config.precision, reader.count_rows());
+            }
+        }
+        if (csv) {
+            FastCSVWriter::append_ohlcv_with_features(base + "_features.csv", chunk, first_row, pending,
+                                                      pending_row, config.data_frequency, selection, config.csv);
+        }
+        if (columnar_out) columnar_out->append(chunk, first_row, pending, pending_row);
+
+        if (sweep) {
+            // Sweep rows start at the chunk; the carried closes are only lookback
+            const size_t carried = closes.size();
+            closes.insert(closes.end(), chunk.close.begin(), chunk.close.end());
+            WindowSweep::compute(closes, config.window_sweep, sweep_columns);
+            views.clear();
+            for (const auto& column : sweep_columns) {
+                const size_t skip = column.offset >= carried ? 0 : std::min(column.values.size(), carried - column.offset);
+                views.push_back({column.name(), column.values.data() + skip, column.values.size() - skip,
+                                 column.offset >= carried ? column.offset - carried : 0});
+            }
+            FastCSVWriter::append_named_columns(base + "_windows.csv", chunk.symbol, chunk.timestamps, views,
+                                                first_row == 0, config.csv);
+            closes.erase(closes.begin(), closes.end() - std::min(lookback, closes.size()));
+        }
+
+        result.rows += chunk.size();
+        ++result.chunks;
+#define CHUNKED_DROP_WRITTEN(name, offset) \
+        { \
+            const size_t f = static_cast<size_t>(Feature::name); \
+            const size_t done = result.rows > pending_row[f] ? std::min(pending.name.size(), result.rows - pending_row[f]) : 0; \
+            pending.name.erase(pending.name.begin(), pending.name.begin() + done); \
+            pending_row[f] += done; \
+        }
+        FEATURE_COLUMNS(CHUNKED_DROP_WRITTEN)
+#undef CHUNKED_DROP_WRITTEN
+    }
+
+    if (columnar_out) columnar_out->finish();
+    result.symbol = chunk.symbol;
+    result.sweep_written = sweep && result.rows > 0;
+    return result;
+}
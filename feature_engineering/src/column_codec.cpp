@@ -0,0 +1,230 @@
+#include "column_codec.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#ifdef MFT_HAVE_LZ4
+#include <lz4.h>
+#endif
+#ifdef MFT_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+template <class Word>
+Word load(const uint8_t* p) {
+    Word w;
+    std::memcpy(&w, p, sizeof(Word));
+    return w;
+}
+
+// Delta or XOR against the previous value (or the value as is), split into
+// byte planes
+template <class Word>
+void encode_words(ColumnEncoding encoding, const uint8_t* in, size_t count, uint8_t* out) {
+    Word previous = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const Word value = load<Word>(in + i * sizeof(Word));
+        Word coded = value;
+        if (encoding == ColumnEncoding::Delta) coded = Word(value - previous);
+        if (encoding == ColumnEncoding::Xor) coded = Word(value ^ previous);
+        previous = value;
+        for (size_t b = 0; b < sizeof(Word); ++b) out[b * count + i] = static_cast<uint8_t>(coded >> (8 * b));
+    }
+}
+
+template <class Word>
+void decode_words(ColumnEncoding encoding, const uint8_t* in, size_t count, uint8_t* out) {
+    Word previous = 0;
+    for (size_t i = 0; i < count; ++i) {
+        Word coded = 0;
+        for (size_t b = 0; b < sizeof(Word); ++b) coded |= Word(in[b * count + i]) << (8 * b);
+        Word value = coded;
+        if (encoding == ColumnEncoding::Delta) value = Word(previous + coded);
+        if (encoding == ColumnEncoding::Xor) value = Word(previous ^ coded);
+        previous = value;
+        std::memcpy(out + i * sizeof(Word), &value, sizeof(Word));
+    }
+}
+
+// Share of sampled neighbours whose XOR leaves the top two bytes zero
+template <class Word>
+bool mostly_shared_prefix(const uint8_t* values, size_t count) {
+    constexpr size_t kSamples = 256;
+    constexpr int kPrefixShift = 8 * (sizeof(Word) - 2);
+    if (count < 2) return false;
+    const size_t step = count / kSamples + 1;
+    size_t sampled = 0, shared = 0;
+    for (size_t i = 1; i < count; i += step) {
+        const Word x = load<Word>(values + i * sizeof(Word)) ^ load<Word>(values + (i - 1) * sizeof(Word));
+        shared += (x >> kPrefixShift) == 0;
+        ++sampled;
+    }
+    return 2 * shared >= sampled;
+}
+
+#ifdef MFT_HAVE_ZSTD
+struct ZstdContexts {
+    ZSTD_CCtx* compress = ZSTD_createCCtx();
+    ZSTD_DCtx* decompress = ZSTD_createDCtx();
+    ~ZstdContexts() {
+        ZSTD_freeCCtx(compress);
+        ZSTD_freeDCtx(decompress);
+    }
+};
+
+// One pair per thread, reused across columns
+ZstdContexts& zstd_contexts() {
+    thread_local ZstdContexts contexts;
+    return contexts;
+}
+#endif
+
+} // namespace
+
+bool column_codec_available(ColumnCodec codec) {
+    switch (codec) {
+    case ColumnCodec::None:
+        return true;
+    case ColumnCodec::Lz4:
+#ifdef MFT_HAVE_LZ4
+        return true;
+#else
+        return false;
+#endif
+    case ColumnCodec::Zstd:
+#ifdef MFT_HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+const char* column_codec_name(ColumnCodec codec) {
+    switch (codec) {
+    case ColumnCodec::None: return "none";
+    case ColumnCodec::Lz4: return "lz4";
+    case ColumnCodec::Zstd: return "zstd";
+    }
+    return "unknown";
+}
+
+ColumnEncoding choose_column_encoding(ColumnType type, const uint8_t* values, size_t count) {
+    switch (type) {
+    case ColumnType::Int64:
+        return ColumnEncoding::Delta;
+    case ColumnType::Float64:
+        return mostly_shared_prefix<uint64_t>(values, count) ? ColumnEncoding::Xor : ColumnEncoding::Shuffle;
+    case ColumnType::Float32:
+        return mostly_shared_prefix<uint32_t>(values, count) ? ColumnEncoding::Xor : ColumnEncoding::Shuffle;
+    }
+    return ColumnEncoding::None;
+}
+
+void encode_column(ColumnEncoding encoding, const uint8_t* in, size_t count, size_t element, uint8_t* out) {
+    if (encoding == ColumnEncoding::None) {
+        std::memcpy(out, in, count * element);
+    } else if (element == sizeof(uint64_t)) {
+        encode_words<uint64_t>(encoding, in, count, out);
+    } else {
+        encode_words<uint32_t>(encoding, in, count, out);
+    }
+}
+
+void decode_column(ColumnEncoding encoding, const uint8_t* in, size_t count, size_t element, uint8_t* out) {
+    if (encoding == ColumnEncoding::None) {
+        std::memcpy(out, in, count * element);
+    } else if (element == sizeof(uint64_t)) {
+        decode_words<uint64_t>(encoding, in, count, out);
+    } else {
+        decode_words<uint32_t>(encoding, in, count, out);
+    }
+}
+
+size_t compress_chunk_bound(ColumnCodec codec, size_t bytes) {
+    switch (codec) {
+    case ColumnCodec::None:
+        return bytes;
+    case ColumnCodec::Lz4:
+#ifdef MFT_HAVE_LZ4
+        // LZ4 takes int sizes; larger chunks are stored raw
+        return bytes <= LZ4_MAX_INPUT_SIZE ? static_cast<size_t>(LZ4_compressBound(static_cast<int>(bytes))) : 0;
+#else
+        return 0;
+#endif
+    case ColumnCodec::Zstd:
+#ifdef MFT_HAVE_ZSTD
+        return ZSTD_compressBound(bytes);
+#else
+        return 0;
+#endif
+    }
+    return 0;
+}
+
+size_t compress_chunk(const ColumnarCompression& compression, const uint8_t* in, size_t bytes,
+                      uint8_t* out, size_t capacity) {
+    if (!column_codec_available(compression.codec)) {
+        throw std::runtime_error(std::string("Compression codec not available in this build: ") +
+                                 column_codec_name(compression.codec));
+    }
+    switch (compression.codec) {
+    case ColumnCodec::None:
+        if (bytes > capacity) return 0;
+        std::memcpy(out, in, bytes);
+        return bytes;
+    case ColumnCodec::Lz4: {
+#ifdef MFT_HAVE_LZ4
+        if (bytes > LZ4_MAX_INPUT_SIZE) return 0;
+        const int stored = LZ4_compress_fast(reinterpret_cast<const char*>(in), reinterpret_cast<char*>(out),
+                                             static_cast<int>(bytes), static_cast<int>(std::min<size_t>(capacity, INT_MAX)),
+                                             compression.level > 0 ? compression.level : 1);
+        return stored > 0 ? static_cast<size_t>(stored) : 0;
+#else
+        return 0;
+#endif
+    }
+    case ColumnCodec::Zstd: {
+#ifdef MFT_HAVE_ZSTD
+        const size_t stored = ZSTD_compressCCtx(zstd_contexts().compress, out, capacity, in, bytes,
+                                                compression.level != 0 ? compression.level : 3);
+        return ZSTD_isError(stored) ? 0 : stored;
+#else
+        return 0;
+#endif
+    }
+    }
+    return 0;
+}
+
+bool decompress_chunk(ColumnCodec codec, const uint8_t* in, size_t stored, uint8_t* out, size_t raw) {
+    switch (codec) {
+    case ColumnCodec::None:
+        if (stored != raw) return false;
+        std::memcpy(out, in, raw);
+        return true;
+    case ColumnCodec::Lz4:
+#ifdef MFT_HAVE_LZ4
+        if (stored > INT_MAX || raw > INT_MAX) return false;
+        return LZ4_decompress_safe(reinterpret_cast<const char*>(in), reinterpret_cast<char*>(out),
+                                   static_cast<int>(stored), static_cast<int>(raw)) == static_cast<int>(raw);
+#else
+        return false;
+#endif
+    case ColumnCodec::Zstd: {
+#ifdef MFT_HAVE_ZSTD
+        const size_t size = ZSTD_decompressDCtx(zstd_contexts().decompress, out, raw, in, stored);
+        return !ZSTD_isError(size) && size == raw;
+#else
+        return false;
+#endif
+    }
+    }
+    return false;
+}
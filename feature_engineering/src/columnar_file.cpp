@@ -0,0 +1,199 @@
+#include "columnar_format.h"
+#include "column_codec.h"
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+// A compressed column's values once expanded
+struct ColumnarFile::Expanded {
+    std::once_flag once;
+    std::unique_ptr<uint8_t[]> values;
+};
+
+ColumnarFile::ColumnarFile(const std::string& filepath)
+    : file_(std::make_unique<MappedFile>(filepath)),
+      data_(reinterpret_cast<const uint8_t*>(file_->data())),
+      size_(file_->size()) {
+    parse(filepath);
+}
+
+ColumnarFile::ColumnarFile(const void* data, size_t size, const std::string& source)
+    : data_(static_cast<const uint8_t*>(data)), size_(size) {
+    parse(source);
+}
+
+ColumnarFile::~ColumnarFile() = default;
+
+void ColumnarFile::parse(const std::string& source) {
+    source_ = source;
+    auto fail = [&](const char* what) {
+        throw std::runtime_error(std::string("Invalid columnar file (") + what + "): " + source);
+    };
+
+    if (size_ < sizeof(ColumnarHeader)) fail("truncated header");
+    const auto* header = reinterpret_cast<const ColumnarHeader*>(data_);
+    if (std::memcmp(header->magic, kColumnarMagic, sizeof(kColumnarMagic)) != 0) fail("bad magic");
+    if (header->version != kColumnarVersion && header->version != kColumnarCompressedVersion) {
+        fail("unsupported version");
+    }
+
+    // Every bound is checked against the image size first so the sums below
+    // cannot wrap, even on a garbage header
+    if (header->row_count > size_ || header->strings_offset > size_ || header->directory_offset > size_ ||
+        header->column_count > size_ / sizeof(ColumnarColumn)) {
+        fail("bad offsets");
+    }
+    rows_ = static_cast<size_t>(header->row_count);
+    const uint64_t strings_end = header->strings_offset + header->symbol_length + header->frequency_length;
+    const uint64_t directory_end = header->directory_offset + uint64_t(header->column_count) * sizeof(ColumnarColumn);
+    if (strings_end > size_ || directory_end > size_ || header->directory_offset % alignof(ColumnarColumn) != 0) {
+        fail("bad offsets");
+    }
+
+    const char* strings = reinterpret_cast<const char*>(data_ + header->strings_offset);
+    symbol_.assign(strings, header->symbol_length);
+    data_frequency_.assign(strings + header->symbol_length, header->frequency_length);
+
+    const auto* directory = reinterpret_cast<const ColumnarColumn*>(data_ + header->directory_offset);
+    columns_.reserve(header->column_count);
+    expanded_.resize(header->column_count);
+    for (uint32_t i = 0; i < header->column_count; ++i) {
+        const ColumnarColumn& column = directory[i];
+        const size_t element = static_cast<ColumnType>(column.type) == ColumnType::Float32 ? sizeof(float) : sizeof(double);
+        if (std::memchr(column.name, '\0', sizeof(column.name)) == nullptr || column.data_offset > size_) {
+            fail("bad column");
+        }
+        if (static_cast<ColumnCodec>(column.codec) == ColumnCodec::None) {
+            if (column.encoding != 0 || column.data_offset % element != 0 ||
+                rows_ * element > size_ - column.data_offset) {
+                fail("bad column");
+            }
+        } else {
+            // Stored as a ColumnarChunk and its codec output
+            if (header->version < kColumnarCompressedVersion || column.codec > uint8_t(ColumnCodec::Zstd) ||
+                column.encoding > uint8_t(ColumnEncoding::Shuffle) || sizeof(ColumnarChunk) > size_ - column.data_offset) {
+                fail("bad column");
+            }
+            ColumnarChunk chunk;
+            std::memcpy(&chunk, data_ + column.data_offset, sizeof(chunk));
+            if (chunk.raw_bytes != rows_ * element ||
+                chunk.stored_bytes > size_ - column.data_offset - sizeof(ColumnarChunk)) {
+                fail("bad column");
+            }
+            expanded_[i] = std::make_unique<Expanded>();
+        }
+        columns_.push_back(&column);
+    }
+}
+
+size_t ColumnarFile::element_size(size_t index) const {
+    return column_type(index) == ColumnType::Float32 ? sizeof(float) : sizeof(double);
+}
+
+const uint8_t* ColumnarFile::column_data(size_t index) const {
+    const uint8_t* payload = data_ + columns_[index]->data_offset;
+    Expanded* expanded = expanded_[index].get();
+    if (!expanded) return payload;
+
+    std::call_once(expanded->once, [&] {
+        const ColumnCodec codec = column_codec(index);
+        if (!column_codec_available(codec)) {
+            throw std::runtime_error(std::string("Cannot read columnar file (") + column_codec_name(codec) +
+                                     " not available in this build): " + source_);
+        }
+        ColumnarChunk chunk;
+        std::memcpy(&chunk, payload, sizeof(chunk));
+        const size_t element = element_size(index);
+        const auto encoding = static_cast<ColumnEncoding>(columns_[index]->encoding);
+        // Expanded straight into place when there is nothing to decode
+        std::unique_ptr<uint8_t[]> values(new uint8_t[std::max<size_t>(1, chunk.raw_bytes)]);
+        std::unique_ptr<uint8_t[]> encoded;
+        uint8_t* target = values.get();
+        if (encoding != ColumnEncoding::None) {
+            encoded.reset(new uint8_t[std::max<size_t>(1, chunk.raw_bytes)]);
+            target = encoded.get();
+        }
+        if (!decompress_chunk(codec, payload + sizeof(chunk), chunk.stored_bytes, target, chunk.raw_bytes)) {
+            throw std::runtime_error("Invalid columnar file (corrupt column " + std::string(column_name(index)) +
+                                     "): " + source_);
+        }
+        if (encoded) decode_column(encoding, encoded.get(), rows_, element, values.get());
+        expanded->values = std::move(values);
+    });
+    return expanded->values.get();
+}
+
+void ColumnarFile::decompress(const std::vector<std::string>& names, unsigned threads) const {
+    std::vector<size_t> pending;
+    std::vector<size_t> costs;
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        if (!expanded_[i]) continue;
+        if (!names.empty() && std::find(names.begin(), names.end(), columns_[i]->name) == names.end()) continue;
+        pending.push_back(i);
+        ColumnarChunk chunk;
+        std::memcpy(&chunk, data_ + columns_[i]->data_offset, sizeof(chunk));
+        costs.push_back(static_cast<size_t>(chunk.raw_bytes));
+    }
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, pending.size()));
+    if (threads <= 1) {
+        for (size_t index : pending) column_data(index);
+        return;
+    }
+
+    // Pool tasks must not throw: the first failure is rethrown afterwards
+    std::mutex error_mutex;
+    std::string error;
+    WorkStealingPool pool(threads);
+    pool.set_trace_label("decompress column");
+    pool.run(costs, [&](size_t k, unsigned) {
+        try {
+            column_data(pending[k]);
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (error.empty()) error = e.what();
+        }
+    });
+    if (!error.empty()) throw std::runtime_error(error);
+}
+
+const double* ColumnarFile::values(size_t index) const {
+    if (index >= columns_.size() || column_type(index) != ColumnType::Float64) return nullptr;
+    return reinterpret_cast<const double*>(column_data(index));
+}
+
+const double* ColumnarFile::find(const std::string& name) const {
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        if (name == columns_[i]->name) return values(i);
+    }
+    return nullptr;
+}
+
+const float* ColumnarFile::values_f32(size_t index) const {
+    if (index >= columns_.size() || column_type(index) != ColumnType::Float32) return nullptr;
+    return reinterpret_cast<const float*>(column_data(index));
+}
+
+const float* ColumnarFile::find_f32(const std::string& name) const {
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        if (name == columns_[i]->name) return values_f32(i);
+    }
+    return nullptr;
+}
+
+const int64_t* ColumnarFile::timestamps() const {
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        if (column_type(i) == ColumnType::Int64 && std::strcmp(columns_[i]->name, "datetime") == 0) {
+            return reinterpret_cast<const int64_t*>(column_data(i));
+        }
+    }
+    return nullptr;
+}
+
+bool ColumnarFile::is_columnar_path(const std::string& filepath) {
+    const size_t n = std::strlen(kColumnarExtension);
+    return filepath.size() >= n && filepath.compare(filepath.size() - n, n, kColumnarExtension) == 0;
+}
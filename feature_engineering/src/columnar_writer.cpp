@@ -0,0 +1,364 @@
+#include "columnar_writer.h"
+#include "async_file_io.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+// One feature column: `length` values that start at row `offset`
+struct ColumnarWriter::Column {
+    Feature feature;
+    const double* values;
+    const int* int_values;     // set instead of `values` for integer columns
+    const float* float_values; // set instead of `values` for a Float32 block
+    size_t length;
+    size_t offset;
+};
+
+namespace {
+size_t align_up(size_t value) {
+    return (value + kColumnarAlignment - 1) / kColumnarAlignment * kColumnarAlignment;
+}
+
+void set_name(ColumnarColumn& entry, const char* name) {
+    std::strncpy(entry.name, name, sizeof(entry.name) - 1);
+}
+
+// Header and offsets of an image with `column_count` columns of `rows` rows
+struct ImageLayout {
+    ColumnarHeader header{};
+    size_t data_offset = 0;
+    size_t payload = 0;         // bytes per float64/int64 column
+    size_t float_payload = 0;   // bytes per float32 column
+};
+
+ImageLayout plan_image(const std::string& symbol, const std::string& data_frequency, size_t column_count, size_t rows) {
+    ImageLayout layout;
+    ColumnarHeader& header = layout.header;
+    std::memcpy(header.magic, kColumnarMagic, sizeof(kColumnarMagic));
+    header.version = kColumnarVersion;
+    header.column_count = static_cast<uint32_t>(column_count);
+    header.row_count = rows;
+    header.strings_offset = sizeof(ColumnarHeader);
+    header.symbol_length = static_cast<uint32_t>(symbol.size());
+    header.frequency_length = static_cast<uint32_t>(data_frequency.size());
+    header.directory_offset = align_up(header.strings_offset + header.symbol_length + header.frequency_length);
+    layout.data_offset = align_up(header.directory_offset + column_count * sizeof(ColumnarColumn));
+    layout.payload = align_up(rows * sizeof(double));
+    layout.float_payload = align_up(rows * sizeof(float));
+    return layout;
+}
+
+// The version 2 form of an uncompressed image: every column encoded and
+// compressed as one chunk, or copied as it is when that does not make it
+// smaller. Header, strings and directory keep their offsets.
+std::string compress_image(const std::string& image, const ColumnarCompression& compression) {
+    ColumnarHeader header;
+    std::memcpy(&header, image.data(), sizeof(header));
+    const size_t rows = static_cast<size_t>(header.row_count);
+    const auto* directory = reinterpret_cast<const ColumnarColumn*>(image.data() + header.directory_offset);
+    const size_t data_offset = align_up(header.directory_offset + header.column_count * sizeof(ColumnarColumn));
+
+    std::string out(image.data(), data_offset);
+    out.reserve(image.size() / 2);
+    std::vector<uint8_t> encoded;
+    std::vector<uint8_t> stored;
+    bool compressed = false;
+    for (uint32_t c = 0; c < header.column_count; ++c) {
+        ColumnarColumn entry = directory[c];
+        const auto type = static_cast<ColumnType>(entry.type);
+        const size_t element = type == ColumnType::Float32 ? sizeof(float) : sizeof(double);
+        const size_t raw_bytes = rows * element;
+        const auto* raw = reinterpret_cast<const uint8_t*>(image.data() + entry.data_offset);
+
+        const ColumnEncoding encoding = choose_column_encoding(type, raw, rows);
+        const uint8_t* input = raw;
+        if (encoding != ColumnEncoding::None) {
+            encoded.resize(raw_bytes);
+            encode_column(encoding, raw, rows, element, encoded.data());
+            input = encoded.data();
+        }
+        size_t stored_bytes = 0;
+        if (const size_t bound = compress_chunk_bound(compression.codec, raw_bytes); bound > 0 && raw_bytes > 0) {
+            stored.resize(bound);
+            stored_bytes = compress_chunk(compression, input, raw_bytes, stored.data(), stored.size());
+        }
+
+        entry.data_offset = out.size();
+        if (stored_bytes > 0 && stored_bytes + sizeof(ColumnarChunk) < raw_bytes) {
+            entry.codec = static_cast<uint8_t>(compression.codec);
+            entry.encoding = static_cast<uint8_t>(encoding);
+            const ColumnarChunk chunk{stored_bytes, raw_bytes};
+            out.append(reinterpret_cast<const char*>(&chunk), sizeof(chunk));
+            out.append(reinterpret_cast<const char*>(stored.data()), stored_bytes);
+            compressed = true;
+        } else {
+            out.append(reinterpret_cast<const char*>(raw), raw_bytes);
+        }
+        out.resize(align_up(out.size()), '\0');
+        std::memcpy(out.data() + header.directory_offset + c * sizeof(ColumnarColumn), &entry, sizeof(entry));
+    }
+    if (!compressed) return image;
+    header.version = kColumnarCompressedVersion;
+    std::memcpy(out.data(), &header, sizeof(header));
+    return out;
+}
+}
+
+void ColumnarWriter::write_ohlcv_with_features(
+    const std::string& filepath, const OHLCVData& ohlcv_data,
+    const FeatureSet& features, const std::string& data_frequency,
+    const FeatureMask& columns, const ColumnarWriteOptions& options) {
+    write_columns(filepath, ohlcv_data, data_frequency, select(features, columns), options);
+}
+
+void ColumnarWriter::write_ohlcv_with_features(
+    const std::string& filepath, const OHLCVData& ohlcv_data,
+    const FeatureBlock& block, const std::string& data_frequency,
+    const FeatureMask& columns, const ColumnarWriteOptions& options) {
+    write_columns(filepath, ohlcv_data, data_frequency, select(block, columns), options);
+}
+
+void ColumnarWriter::build_image(
+    const OHLCVData& ohlcv_data, const FeatureSet& features,
+    const std::string& data_frequency, const FeatureMask& columns,
+    const Allocator& allocate) {
+    build(ohlcv_data, data_frequency, select(features, columns), allocate);
+}
+
+void ColumnarWriter::build_image(
+    const OHLCVData& ohlcv_data, const FeatureBlock& block,
+    const std::string& data_frequency, const FeatureMask& columns,
+    const Allocator& allocate) {
+    build(ohlcv_data, data_frequency, select(block, columns), allocate);
+}
+
+std::vector<ColumnarWriter::Column> ColumnarWriter::select(const FeatureSet& features, const FeatureMask& columns) {
+    std::vector<Column> selected;
+    selected.reserve(columns.count());
+#define FEATURE_SET_COLUMN(name, offset) \
+    if (is_selected(columns, Feature::name)) selected.push_back(column(Feature::name, features.name));
+    FEATURE_COLUMNS(FEATURE_SET_COLUMN)
+#undef FEATURE_SET_COLUMN
+    return selected;
+}
+
+std::vector<ColumnarWriter::Column> ColumnarWriter::select(const FeatureBlock& block, const FeatureMask& columns) {
+    std::vector<Column> selected;
+    selected.reserve(columns.count());
+    for (size_t f = 0; f < kFeatureCount; ++f) {
+        if (!columns.test(f)) continue;
+        Feature feature = static_cast<Feature>(f);
+        selected.push_back({feature, block.column(feature), nullptr, block.column_f32(feature),
+                            block.length(feature), feature_row_offset(feature)});
+    }
+    return selected;
+}
+
+ColumnarWriter::Column ColumnarWriter::column(Feature feature, const std::vector<double>& values) {
+    return {feature, values.data(), nullptr, nullptr, values.size(), feature_row_offset(feature)};
+}
+
+ColumnarWriter::Column ColumnarWriter::column(Feature feature, const std::vector<int>& values) {
+    return {feature, nullptr, values.data(), nullptr, values.size(), feature_row_offset(feature)};
+}
+
+void ColumnarWriter::write_columns(
+    const std::string& filepath, const OHLCVData& ohlcv_data,
+    const std::string& data_frequency, const std::vector<Column>& columns, const ColumnarWriteOptions& options) {
+    try {
+        if (auto p = std::filesystem::path(filepath).parent_path(); !p.empty()) {
+            std::filesystem::create_directories(p);
+        }
+
+        // Whole file built in memory, then written once
+        std::string content;
+        build(ohlcv_data, data_frequency, columns, [&](size_t bytes) {
+            content.assign(bytes, '\0');
+            return reinterpret_cast<uint8_t*>(content.data());
+        });
+        if (options.compression.codec != ColumnCodec::None) {
+            content = compress_image(content, options.compression);
+        }
+
+        if (options.async_io) {
+            options.async_io->write_file(filepath, std::move(content));
+            return;
+        }
+        std::ofstream file(filepath, std::ios::out | std::ios::binary);
+        if (!file.is_open()) throw std::runtime_error("Cannot create file: " + filepath);
+        file.write(content.data(), content.size());
+        file.close();
+
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Error writing columnar file: " + std::string(e.what()));
+    }
+}
+
+void ColumnarWriter::build(
+    const OHLCVData& ohlcv_data, const std::string& data_frequency,
+    const std::vector<Column>& columns, const Allocator& allocate) {
+    const size_t rows = ohlcv_data.size();
+    const ImageLayout layout = plan_image(ohlcv_data.symbol, data_frequency, 6 + columns.size(), rows);
+    const ColumnarHeader& header = layout.header;
+    const size_t data_offset = layout.data_offset;
+    const size_t payload = layout.payload;
+    // Float32 block columns stay float32 on disk, at half the payload
+    const size_t float_payload = layout.float_payload;
+    size_t feature_bytes = 0;
+    for (const auto& column : columns) feature_bytes += column.float_values ? float_payload : payload;
+
+    uint8_t* content = allocate(data_offset + 6 * payload + feature_bytes);
+    std::memcpy(content, &header, sizeof(header));
+    std::memcpy(content + header.strings_offset, ohlcv_data.symbol.data(), header.symbol_length);
+    std::memcpy(content + header.strings_offset + header.symbol_length,
+                data_frequency.data(), header.frequency_length);
+
+    auto* directory = reinterpret_cast<ColumnarColumn*>(content + header.directory_offset);
+    size_t next = 0;
+    size_t next_offset = data_offset;
+    auto add_column = [&](const char* name, ColumnType type) -> uint8_t* {
+        ColumnarColumn& entry = directory[next];
+        set_name(entry, name);
+        entry.type = static_cast<uint32_t>(type);
+        entry.data_offset = next_offset;
+        ++next;
+        next_offset += type == ColumnType::Float32 ? float_payload : payload;
+        return content + entry.data_offset;
+    };
+
+    auto* times = reinterpret_cast<int64_t*>(add_column("datetime", ColumnType::Int64));
+    for (size_t i = 0; i < rows; ++i) {
+        times[i] = std::chrono::duration_cast<std::chrono::seconds>(
+            ohlcv_data.timestamps[i].time_since_epoch()).count();
+    }
+    auto copy_raw = [&](const char* name, const std::vector<double>& values) {
+        std::memcpy(add_column(name, ColumnType::Float64), values.data(), rows * sizeof(double));
+    };
+    copy_raw("open", ohlcv_data.open);
+    copy_raw("high", ohlcv_data.high);
+    copy_raw("low", ohlcv_data.low);
+    copy_raw("close", ohlcv_data.close);
+    copy_raw("volume", ohlcv_data.volume);
+
+    // Features are row-aligned: NaN before the first valid row and after the last
+    constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+    for (const auto& column : columns) {
+        const size_t begin = std::min(column.offset, rows);
+        const size_t count = std::min(column.length, rows - begin);
+        if (column.float_values) {
+            auto* out = reinterpret_cast<float*>(add_column(feature_name(column.feature), ColumnType::Float32));
+            std::fill(out, out + rows, std::numeric_limits<float>::quiet_NaN());
+            std::copy(column.float_values, column.float_values + count, out + begin);
+            continue;
+        }
+        auto* out = reinterpret_cast<double*>(add_column(feature_name(column.feature), ColumnType::Float64));
+        std::fill(out, out + rows, nan);
+        for (size_t k = 0; k < count; ++k) {
+            out[begin + k] = column.int_values ? column.int_values[k] : column.values[k];
+        }
+    }
+}
+
+ColumnarAppender::ColumnarAppender(const std::string& filepath, const std::string& symbol,
+                                   const std::string& data_frequency, const FeatureMask& columns,
+                                   FeaturePrecision precision, size_t capacity)
+    : path_(filepath), columns_(columns), precision_(precision), capacity_(capacity) {
+    if (auto p = std::filesystem::path(filepath).parent_path(); !p.empty()) {
+        std::filesystem::create_directories(p);
+    }
+    const ImageLayout layout = plan_image(symbol, data_frequency, 6 + columns.count(), capacity);
+    header_ = layout.header;
+    header_.row_count = 0;
+
+    std::vector<uint8_t> head(layout.data_offset, 0);
+    std::memcpy(head.data() + header_.strings_offset, symbol.data(), header_.symbol_length);
+    std::memcpy(head.data() + header_.strings_offset + header_.symbol_length,
+                data_frequency.data(), header_.frequency_length);
+    auto* directory = reinterpret_cast<ColumnarColumn*>(head.data() + header_.directory_offset);
+    size_t next_offset = layout.data_offset;
+    auto add_column = [&](const char* name, ColumnType type) {
+        ColumnarColumn& entry = directory[offsets_.size()];
+        set_name(entry, name);
+        entry.type = static_cast<uint32_t>(type);
+        entry.data_offset = next_offset;
+        offsets_.push_back(next_offset);
+        next_offset += type == ColumnType::Float32 ? layout.float_payload : layout.payload;
+    };
+    add_column("datetime", ColumnType::Int64);
+    for (const char* name : {"open", "high", "low", "close", "volume"}) add_column(name, ColumnType::Float64);
+    const ColumnType feature_type = precision == FeaturePrecision::Float32 ? ColumnType::Float32 : ColumnType::Float64;
+    for (size_t f = 0; f < kFeatureCount; ++f) {
+        if (columns.test(f)) add_column(feature_name(static_cast<Feature>(f)), feature_type);
+    }
+
+    file_.open(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file_.is_open()) throw std::runtime_error("Cannot create file: " + filepath);
+    write_at(0, head.data(), head.size());
+    // Extend the file to its full size; the payloads are filled in place
+    if (next_offset > head.size()) write_at(next_offset - 1, "", 1);
+}
+
+void ColumnarAppender::write_at(uint64_t offset, const void* data, size_t bytes) {
+    file_.seekp(static_cast<std::streamoff>(offset));
+    file_.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    if (!file_) throw std::runtime_error("Error writing columnar file: " + path_);
+}
+
+void ColumnarAppender::append(const OHLCVData& chunk, size_t first_row, const FeatureSet& features,
+                              const std::array<size_t, kFeatureCount>& column_rows) {
+    const size_t rows = chunk.size();
+    if (first_row + rows > capacity_) {
+        throw std::runtime_error("Error writing columnar file: more rows than its capacity: " + path_);
+    }
+
+    size_t next = 0;
+    scratch_.resize(rows * sizeof(double));
+    auto* times = reinterpret_cast<int64_t*>(scratch_.data());
+    for (size_t i = 0; i < rows; ++i) {
+        times[i] = std::chrono::duration_cast<std::chrono::seconds>(chunk.timestamps[i].time_since_epoch()).count();
+    }
+    write_at(offsets_[next++] + first_row * sizeof(int64_t), times, rows * sizeof(int64_t));
+    for (const auto* raw : {&chunk.open, &chunk.high, &chunk.low, &chunk.close, &chunk.volume}) {
+        write_at(offsets_[next++] + first_row * sizeof(double), raw->data(), rows * sizeof(double));
+    }
+
+    // Rows of the chunk a feature has values for are filled, the rest NaN
+    auto write_feature = [&](Feature feature, const auto& values) {
+        const size_t row = column_rows[static_cast<size_t>(feature)];
+        auto fill = [&](auto* out) {
+            using Element = std::remove_pointer_t<decltype(out)>;
+            std::fill(out, out + rows, std::numeric_limits<Element>::quiet_NaN());
+            for (size_t i = 0; i < rows; ++i) {
+                const size_t global = first_row + i;
+                if (global < row || global - row >= values.size()) continue;
+                out[i] = static_cast<Element>(values[global - row]);
+            }
+        };
+        if (precision_ == FeaturePrecision::Float32) {
+            auto* out = reinterpret_cast<float*>(scratch_.data());
+            fill(out);
+            write_at(offsets_[next++] + first_row * sizeof(float), out, rows * sizeof(float));
+        } else {
+            auto* out = reinterpret_cast<double*>(scratch_.data());
+            fill(out);
+            write_at(offsets_[next++] + first_row * sizeof(double), out, rows * sizeof(double));
+        }
+    };
+#define FEATURE_SET_APPEND(name, offset) \
+    if (is_selected(columns_, Feature::name)) write_feature(Feature::name, features.name);
+    FEATURE_COLUMNS(FEATURE_SET_APPEND)
+#undef FEATURE_SET_APPEND
+    rows_ = first_row + rows;
+}
+
+void ColumnarAppender::finish() {
+    header_.row_count = rows_;
+    write_at(0, &header_, sizeof(header_));
+    file_.close();
+    if (!file_) throw std::runtime_error("Error writing columnar file: " + path_);
+}
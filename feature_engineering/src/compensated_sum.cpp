@@ -0,0 +1,11 @@
+#include "rolling_moments.h"
+#include <cmath>
+
+// Built without fast math (CMakeLists.txt): reassociation folds the
+// correction terms below to zero
+void CompensatedSum::add(double x) {
+    double t = sum + x;
+    if (std::abs(sum) >= std::abs(x)) compensation += (sum - t) + x;
+    else compensation += (x - t) + sum;
+    sum = t;
+}
@@ -1,4 +1,8 @@
 #include "../include/csv_reader.h"
+#include "async_file_io.h"
+#include "mapped_file.h"
+#include "csv_scanner.h"
+#include "timestamp_decoder.h"
 #include <fstream>
 #include <filesystem>
 #include <sstream>
@@ -7,159 +11,177 @@
 #include <iomanip>
 #include <chrono>
 #include <ctime>
-
-#ifdef _WIN32
-    #include <windows.h>
-    #include <io.h>
-#else
-    #include <sys/mman.h>
-    #include <sys/stat.h>
-    #include <fcntl.h>
-    #include <unistd.h>
-#endif
+#include <limits>
 
 double FastCSVReader::fast_atof(const char* p, const char** endptr) {
-    if (!p) { if (endptr) *endptr = p; return 0.0; }
-    
-    while (*p == ' ' || *p == '\t') p++;
-    
-    double sign = (*p == '-') ? (p++, -1.0) : 1.0;
-    if (*p == '+') p++;
+    return CSVScanner::parse_decimal(p, endptr);
+}
 
-    double result = 0.0;
-    while (*p >= '0' && *p <= '9') {
-        result = result * 10.0 + (*p - '0');
-        p++;
-    }
+std::chrono::system_clock::time_point FastCSVReader::parse_timestamp(const std::string& datetime_str) {
+    thread_local TimestampDecoder decoder;
+    return decoder.decode(datetime_str);
+}
+
+namespace {
+// Position after the line break ending at `line_end`, handling both \n and \r\n
+const char* skip_line_break(const char* line_end, const char* end) {
+    if (line_end < end && *line_end == '\r') line_end++;
+    if (line_end < end && *line_end == '\n') line_end++;
+    return line_end;
+}
+}
+
+const char* FastCSVReader::parse_rows(const char* ptr, const char* end, size_t max_rows, OHLCVData& data,
+                                      std::vector<std::string_view>& datetimes, std::string& last) {
+    const size_t target = max_rows > std::numeric_limits<size_t>::max() - data.size()
+                              ? std::numeric_limits<size_t>::max() : data.size() + max_rows;
+
+    // symbol,datetime,open,high,low,close,volume needs six delimiters
+    auto parse_line = [&](const char* line_start, const char* line_end) {
+        const char* commas[6];
+        if (CSVScanner::find_delimiters(line_start, line_end, ',', commas, 6) < 6) return;
+        const char* field_ptrs[7] = {line_start, commas[0] + 1, commas[1] + 1, commas[2] + 1,
+                                     commas[3] + 1, commas[4] + 1, commas[5] + 1};
+        
+        // Extract symbol (first field)
+        if (data.symbol.empty()) {
+            data.symbol.assign(field_ptrs[0], commas[0] - field_ptrs[0]);
+        }
+        
+        datetimes.emplace_back(field_ptrs[1], commas[1] - field_ptrs[1]);
+        
+        // Parse OHLCV values directly
+        const char* endptr;
+        data.open.push_back(fast_atof(field_ptrs[2], &endptr));
+        data.high.push_back(fast_atof(field_ptrs[3], &endptr));
+        data.low.push_back(fast_atof(field_ptrs[4], &endptr));
+        data.close.push_back(fast_atof(field_ptrs[5], &endptr));
+        data.volume.push_back(fast_atof(field_ptrs[6], &endptr));
+    };
     
-    if (*p == '.') {
-        p++;
-        double f = 0.1;
-        while (*p >= '0' && *p <= '9') {
-            result += (*p - '0') * f;
-            f *= 0.1;
-            p++;
+    // Line-by-line parsing straight from the mapped bytes
+    while (ptr < end && data.size() < target) {
+        const char* line_end = CSVScanner::find_line_end(ptr, end);
+        
+        if (line_end == end) {
+            // Unterminated last line: fast_atof must not run past the mapping
+            last.assign(ptr, line_end);
+            parse_line(last.data(), last.data() + last.size());
+        } else if (line_end > ptr) {
+            parse_line(ptr, line_end);
         }
+        
+        ptr = skip_line_break(line_end, end);
     }
-    if (endptr) *endptr = p;
-    return result * sign;
+    return ptr;
 }
 
-std::chrono::system_clock::time_point FastCSVReader::parse_timestamp(const std::string& datetime_str) {
-    std::tm tm = {};
-    std::istringstream ss(datetime_str);
-    ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-    if (ss.fail()) {
-        ss.clear();
-        ss.str(datetime_str);
-        ss >> std::get_time(&tm, "%Y-%m-%d");
-        if(ss.fail()) return (std::chrono::system_clock::time_point::min)();
-    }
-    return std::chrono::system_clock::from_time_t(std::mktime(&tm));
+std::unique_ptr<OHLCVData> FastCSVReader::read_csv_file(const std::string& filepath) {
+    MappedFile file(filepath);
+    return parse_csv(file.data(), file.size());
 }
 
-std::unique_ptr<OHLCVData> FastCSVReader::read_csv_file(const std::string& filepath) {
-    // Cross-platform file reading approach
-    std::ifstream file(filepath, std::ios::binary);
-    if (!file.is_open()) {
-        throw std::runtime_error("Cannot open file: " + filepath);
-    }
-    
-    // Get file size
-    file.seekg(0, std::ios::end);
-    std::streamsize size = file.tellg();
-    file.seekg(0, std::ios::beg);
-    
+std::unique_ptr<OHLCVData> FastCSVReader::parse_csv(const char* contents, size_t size) {
+    auto data = std::make_unique<OHLCVData>();
     if (size == 0) {
-        return std::make_unique<OHLCVData>();
-    }
-    
-    // Read entire file into memory
-    std::string content(size, '\0');
-    if (!file.read(&content[0], size)) {
-        throw std::runtime_error("Cannot read file: " + filepath);
+        return data;
     }
-    file.close();
     
-    auto data = std::make_unique<OHLCVData>();
-    data->reserve(size / 80); // Estimate rows based on file size
+    const char* ptr = contents;
+    const char* end = ptr + size;
     
-    const char* ptr = content.c_str();
-    const char* end = ptr + content.size();
+    // One row per line after the header
+    const size_t lines = CSVScanner::count_lines(ptr, end);
+    data->reserve(lines > 0 ? lines : 1);
     
     // Skip header line
-    while (ptr < end && *ptr != '\n') ptr++;
-    if (ptr < end) ptr++; // Skip the newline
+    ptr = skip_line_break(CSVScanner::find_line_end(ptr, end), end);
     
-    // Fast line-by-line parsing
-    while (ptr < end) {
-        const char* line_start = ptr;
-        const char* line_end = ptr;
-        
-        // Find end of line
-        while (line_end < end && *line_end != '\n' && *line_end != '\r') line_end++;
-        
-        if (line_end > line_start) {
-            // Parse fields directly from memory
-            const char* field_ptrs[7];
-            int field_count = 0;
-            const char* field_start = line_start;
-            
-            for (const char* p = line_start; p <= line_end && field_count < 7; p++) {
-                if (p == line_end || *p == ',') {
-                    field_ptrs[field_count++] = field_start;
-                    field_start = p + 1;
-                }
-            }
-            
-            if (field_count >= 7) {
-                // Extract symbol (first field)
-                if (data->symbol.empty()) {
-                    const char* symbol_end = field_ptrs[1] - 1;
-                    data->symbol.assign(field_ptrs[0], symbol_end - field_ptrs[0]);
-                }
-                
-                // Parse timestamp
-                const char* ts_end = field_ptrs[2] - 1;
-                std::string ts_str(field_ptrs[1], ts_end - field_ptrs[1]);
-                data->timestamps.push_back(parse_timestamp(ts_str));
-                
-                // Parse OHLCV values directly
-                const char* endptr;
-                data->open.push_back(fast_atof(field_ptrs[2], &endptr));
-                data->high.push_back(fast_atof(field_ptrs[3], &endptr));
-                data->low.push_back(fast_atof(field_ptrs[4], &endptr));
-                data->close.push_back(fast_atof(field_ptrs[5], &endptr));
-                data->volume.push_back(fast_atof(field_ptrs[6], &endptr));
-            }
-        }
-        
-        // Move to next line, handling both \n and \r\n
-        ptr = line_end;
-        if (ptr < end && *ptr == '\r') ptr++;
-        if (ptr < end && *ptr == '\n') ptr++;
-    }
+    // Datetime fields are decoded as one column once the lines are split
+    std::vector<std::string_view> datetimes;
+    datetimes.reserve(lines);
+    std::string last;
+    parse_rows(ptr, end, std::numeric_limits<size_t>::max(), *data, datetimes, last);
     
+    TimestampDecoder decoder;
+    decoder.decode_column(datetimes, data->timestamps);
+    data->charge_memory();
     return data;
 }
 
-std::vector<std::unique_ptr<OHLCVData>> FastCSVReader::read_directory(const std::string& directory) {
+FastCSVReader::ChunkReader::ChunkReader(const std::string& filepath) : file_(filepath) {
+    pos_ = file_.data();
+    end_ = pos_ + file_.size();
+    if (pos_ < end_) pos_ = skip_line_break(CSVScanner::find_line_end(pos_, end_), end_);
+}
+
+size_t FastCSVReader::ChunkReader::count_rows() const {
+    if (file_.empty()) return 0;
+    const size_t lines = CSVScanner::count_lines(file_.data(), end_) + (end_[-1] != '\n' ? 1 : 0);
+    return lines - 1;
+}
+
+bool FastCSVReader::ChunkReader::next(OHLCVData& chunk, size_t rows) {
+    chunk.timestamps.clear();
+    chunk.open.clear();
+    chunk.high.clear();
+    chunk.low.clear();
+    chunk.close.clear();
+    chunk.volume.clear();
+    if (pos_ >= end_ || rows == 0) return false;
+
+    chunk.reserve(rows);
+    datetimes_.clear();
+    pos_ = parse_rows(pos_, end_, rows, chunk, datetimes_, last_);
+    decoder_.decode_column(datetimes_, chunk.timestamps);
+    chunk.charge_memory();
+    file_.release(static_cast<size_t>(pos_ - file_.data()));
+    return !chunk.empty();
+}
+
+std::vector<std::unique_ptr<OHLCVData>> FastCSVReader::read_directory(const std::string& directory, unsigned io_depth) {
     std::vector<std::unique_ptr<OHLCVData>> all_data;
     if (!std::filesystem::exists(directory)) {
         throw std::runtime_error("Directory does not exist: " + directory);
     }
     
+    std::vector<std::string> paths;
     for (const auto& entry : std::filesystem::directory_iterator(directory)) {
         if (entry.is_regular_file() && entry.path().extension() == ".csv") {
+            paths.push_back(entry.path().string());
+        }
+    }
+    
+    auto keep = [&](std::unique_ptr<OHLCVData> data) {
+        if (data && !data->empty()) {
+            all_data.push_back(std::move(data));
+        }
+    };
+    if (io_depth == 0) {
+        for (const auto& path : paths) {
             try {
-                auto data = read_csv_file(entry.path().string());
-                if (data && !data->empty()) {
-                    all_data.push_back(std::move(data));
-                }
+                keep(read_csv_file(path));
             } catch (const std::exception& e) {
-                std::cerr << "Could not process file " << entry.path() << ": " << e.what() << std::endl;
+                std::cerr << "Could not process file " << path << ": " << e.what() << std::endl;
             }
         }
+        return all_data;
     }
+    
+    // Each file is parsed straight from its read buffer as its read completes
+    AsyncIOConfig io_config;
+    io_config.queue_depth = io_depth;
+    AsyncFileIO io(io_config);
+    io.read_files(paths, [&](const AsyncIOResult& file) {
+        if (!file.ok()) {
+            std::cerr << "Could not process file " << *file.path << ": " << file.message() << std::endl;
+            return;
+        }
+        try {
+            keep(parse_csv(file.data, file.size));
+        } catch (const std::exception& e) {
+            std::cerr << "Could not process file " << *file.path << ": " << e.what() << std::endl;
+        }
+    });
     return all_data;
 }
@@ -0,0 +1,164 @@
+#include "csv_scanner.h"
+#include <cmath>
+#include <cstdint>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define CSV_SCANNER_NEON 1
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+inline unsigned lowest_bit(uint64_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+
+inline unsigned bit_count(uint32_t mask) {
+#ifdef _MSC_VER
+    return __popcnt(mask);
+#else
+    return static_cast<unsigned>(__builtin_popcount(mask));
+#endif
+}
+
+#ifdef CSV_SCANNER_NEON
+// 4 bits per byte lane of a 16-byte compare result
+inline uint64_t nibble_mask(uint8x16_t cmp) {
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+#endif
+}
+
+const char* CSVScanner::find_line_end(const char* p, const char* end) {
+#ifdef __AVX2__
+    const __m256i lf = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    for (; p + 32 <= end; p += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(v, lf), _mm256_cmpeq_epi8(v, cr));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hit));
+        if (mask) return p + lowest_bit(mask);
+    }
+#elif defined(CSV_SCANNER_NEON)
+    const uint8x16_t lf = vdupq_n_u8('\n');
+    const uint8x16_t cr = vdupq_n_u8('\r');
+    for (; p + 16 <= end; p += 16) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        uint64_t mask = nibble_mask(vorrq_u8(vceqq_u8(v, lf), vceqq_u8(v, cr)));
+        if (mask) return p + lowest_bit(mask) / 4;
+    }
+#endif
+    while (p < end && *p != '\n' && *p != '\r') ++p;
+    return p;
+}
+
+size_t CSVScanner::count_lines(const char* p, const char* end) {
+    size_t count = 0;
+#ifdef __AVX2__
+    const __m256i lf = _mm256_set1_epi8('\n');
+    for (; p + 32 <= end; p += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        count += bit_count(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, lf))));
+    }
+#elif defined(CSV_SCANNER_NEON)
+    const uint8x16_t lf = vdupq_n_u8('\n');
+    const uint8x16_t one = vdupq_n_u8(1);
+    for (; p + 16 <= end; p += 16) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        count += vaddvq_u8(vandq_u8(vceqq_u8(v, lf), one));
+    }
+#endif
+    for (; p < end; ++p) count += (*p == '\n');
+    return count;
+}
+
+size_t CSVScanner::find_delimiters(const char* p, const char* end, char delimiter,
+                                   const char** out, size_t max) {
+    size_t found = 0;
+    if (max == 0) return 0;
+#ifdef __AVX2__
+    const __m256i d = _mm256_set1_epi8(delimiter);
+    for (; p + 32 <= end; p += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, d)));
+        while (mask) {
+            out[found++] = p + lowest_bit(mask);
+            if (found == max) return found;
+            mask &= mask - 1;
+        }
+    }
+#elif defined(CSV_SCANNER_NEON)
+    const uint8x16_t d = vdupq_n_u8(static_cast<uint8_t>(delimiter));
+    for (; p + 16 <= end; p += 16) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        uint64_t mask = nibble_mask(vceqq_u8(v, d));
+        while (mask) {
+            unsigned bit = lowest_bit(mask);
+            out[found++] = p + bit / 4;
+            if (found == max) return found;
+            mask &= ~(uint64_t(0xF) << (bit & ~3u));
+        }
+    }
+#endif
+    for (; p < end; ++p) {
+        if (*p == delimiter) {
+            out[found++] = p;
+            if (found == max) break;
+        }
+    }
+    return found;
+}
+
+double CSVScanner::parse_decimal(const char* p, const char** endptr) {
+    if (!p) {
+        if (endptr) *endptr = p;
+        return 0.0;
+    }
+    while (*p == ' ' || *p == '\t') ++p;
+    const bool negative = *p == '-';
+    if (*p == '-' || *p == '+') ++p;
+
+    // Digits past the 19th no longer fit the mantissa: dropped, they only
+    // move the decimal exponent (integer part) or are ignored (fraction)
+    constexpr uint64_t kMantissaLimit = 1000000000000000000ull;
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    for (; *p >= '0' && *p <= '9'; ++p) {
+        if (mantissa < kMantissaLimit) mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+        else ++exponent;
+    }
+    if (*p == '.') {
+        for (++p; *p >= '0' && *p <= '9'; ++p) {
+            if (mantissa < kMantissaLimit) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                --exponent;
+            }
+        }
+    }
+    if (endptr) *endptr = p;
+
+    // Powers of ten up to 1e22 are exact doubles, so a mantissa below 2^53
+    // (up to 15 significant digits, every price in practice) is exact too
+    // and one multiplication or division gives the correctly rounded value.
+    // Longer mantissas, up to kMantissaLimit, round once on conversion and
+    // again on scaling: within an ulp or so, not always correctly rounded
+    static constexpr double kPowers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                         1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    double value = static_cast<double>(mantissa);
+    if (exponent < 0 && exponent >= -22) value /= kPowers[-exponent];
+    else if (exponent > 0 && exponent <= 22) value *= kPowers[exponent];
+    else if (exponent != 0) value *= std::pow(10.0, exponent);
+    return negative ? -value : value;
+}
@@ -1,168 +1,402 @@
 #include "../include/csv_writer.h"
-#include <fstream>
-#include <filesystem>
-#include <iomanip>
-#include <sstream>
+#include "async_file_io.h"
+#include "civil_time.h"
+#include "memory_accounting.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
 #include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <limits>
 #include <stdexcept>
-#include <vector>
 #include <string>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+// Frees `buffer` once its capacity passes `limit`; smaller ones stay for reuse
+void trim_buffer(std::string& buffer, size_t limit) {
+    if (buffer.capacity() > limit) std::string().swap(buffer);
+}
 
-std::string FastCSVWriter::format_datetime(const std::chrono::system_clock::time_point& tp) {
-    if (tp == std::chrono::system_clock::time_point::min()) return "";
-    auto time_t = std::chrono::system_clock::to_time_t(tp);
-    std::tm tm;
-    #ifdef _WIN32
-    localtime_s(&tm, &time_t);
-    #else
-    localtime_r(&time_t, &tm);
-    #endif
-    
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+// Mirrors std::fixed << std::setprecision(p): NaN/inf become an empty cell
+void append_fixed(std::string& out, double value, int precision) {
+    if (std::isnan(value) || std::isinf(value)) return;
+    char buf[400];  // fits the widest fixed-notation double
+    auto result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, precision);
+    out.append(buf, result.ptr);
 }
 
-std::string FastCSVWriter::format_double(double value, int precision) {
-    if (std::isnan(value) || std::isinf(value)) return "";
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(precision) << value;
-    return oss.str();
+void append_int(std::string& out, int value) {
+    char buf[16];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, result.ptr);
 }
 
-std::string FastCSVWriter::safe_get_value(const std::vector<double>& vec, size_t index, size_t offset) {
-    size_t effective_index = index >= offset ? index - offset : -1;
-    return (effective_index < vec.size()) ? format_double(vec[effective_index]) : "";
+void append_two_digits(std::string& out, unsigned value) {
+    out += static_cast<char>('0' + value / 10);
+    out += static_cast<char>('0' + value % 10);
+}
+
+// Local-time "YYYY-MM-DD HH:MM:SS" without a localtime() call per row. The
+// UTC offset is looked up once per 15-minute UTC bucket (every real-world
+// offset change falls on such a boundary) and the date text is reused for
+// as long as consecutive rows stay on the same local day.
+class DateTimeFormatter {
+public:
+    void append(std::string& out, const std::chrono::system_clock::time_point& tp) {
+        if (tp == std::chrono::system_clock::time_point::min()) return;
+        const int64_t t = static_cast<int64_t>(std::chrono::system_clock::to_time_t(tp));
+
+        const int64_t bucket = (t >= 0 ? t : t - 899) / 900;
+        if (bucket != bucket_) {
+            bucket_ = bucket;
+            offset_ = utc_offset(static_cast<time_t>(t));
+        }
+
+        const int64_t local = t + offset_;
+        const int64_t day = floor_days(local);
+        if (day != day_) {
+            day_ = day;
+            date_.clear();
+            CivilDate date = civil_from_days(day);
+            char buf[24];
+            auto result = std::to_chars(buf, buf + sizeof(buf), date.year);
+            date_.append(buf, result.ptr);
+            date_ += '-';
+            append_two_digits(date_, date.month);
+            date_ += '-';
+            append_two_digits(date_, date.day);
+            date_ += ' ';
+        }
+        out += date_;
+
+        const unsigned seconds_of_day = static_cast<unsigned>(local - day * 86400);
+        append_two_digits(out, seconds_of_day / 3600);
+        out += ':';
+        append_two_digits(out, seconds_of_day / 60 % 60);
+        out += ':';
+        append_two_digits(out, seconds_of_day % 60);
+    }
+
+private:
+    static int64_t utc_offset(time_t t) {
+        std::tm tm;
+#ifdef _WIN32
+        localtime_s(&tm, &t);
+#else
+        localtime_r(&t, &tm);
+#endif
+        const int64_t local = days_from_civil(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday) * 86400 +
+                              tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+        return local - static_cast<int64_t>(t);
+    }
+
+    int64_t bucket_ = std::numeric_limits<int64_t>::min();
+    int64_t offset_ = 0;
+    int64_t day_ = std::numeric_limits<int64_t>::min();
+    std::string date_;
+};
 }
 
-std::string FastCSVWriter::safe_get_int_value(const std::vector<int>& vec, size_t index, size_t offset) {
-    size_t effective_index = index >= offset ? index - offset : -1;
-    return (effective_index < vec.size()) ? std::to_string(vec[effective_index]) : "";
+// One output column: values start at input row `offset`
+struct FastCSVWriter::ColumnView {
+    Feature feature;
+    const double* values;
+    const int* int_values;     // set instead of `values` for integer columns
+    const float* float_values; // set instead of `values` for a Float32 block
+    size_t length;
+    size_t offset;
+};
+
+void FastCSVWriter::write_ohlcv_with_features(
+    const std::string& filepath, const OHLCVData& ohlcv_data,
+    const FeatureSet& features, const std::string& data_frequency,
+    const FeatureMask& columns, const CSVWriteOptions& options) {
+    std::vector<ColumnView> views;
+    views.reserve(columns.count());
+#define FEATURE_SET_COLUMN_VIEW(name, offset) \
+    if (is_selected(columns, Feature::name)) views.push_back(column_view(Feature::name, features.name, offset));
+    FEATURE_COLUMNS(FEATURE_SET_COLUMN_VIEW)
+#undef FEATURE_SET_COLUMN_VIEW
+    write_columns(filepath, ohlcv_data, data_frequency, views, options);
 }
 
 void FastCSVWriter::write_ohlcv_with_features(
     const std::string& filepath, const OHLCVData& ohlcv_data,
-    const FeatureSet& features, const std::string& data_frequency) {
+    const FeatureBlock& block, const std::string& data_frequency,
+    const FeatureMask& columns, const CSVWriteOptions& options) {
+    std::vector<ColumnView> views;
+    views.reserve(columns.count());
+    for (size_t f = 0; f < kFeatureCount; ++f) {
+        if (!columns.test(f)) continue;
+        Feature feature = static_cast<Feature>(f);
+        views.push_back({feature, block.column(feature), nullptr, block.column_f32(feature),
+                         block.length(feature), feature_row_offset(feature)});
+    }
+    write_columns(filepath, ohlcv_data, data_frequency, views, options);
+}
+
+void FastCSVWriter::append_ohlcv_with_features(
+    const std::string& filepath, const OHLCVData& chunk, size_t first_row,
+    const FeatureSet& features, const std::array<size_t, kFeatureCount>& column_rows,
+    const std::string& data_frequency, const FeatureMask& columns, const CSVWriteOptions& options) {
+    std::vector<ColumnView> views;
+    views.reserve(columns.count());
+    // Rebase each column on the chunk, dropping values of rows already written
+    auto rebase = [&](ColumnView view) {
+        const size_t row = view.offset;
+        if (row >= first_row) {
+            view.offset = row - first_row;
+        } else {
+            const size_t skip = std::min(view.length, first_row - row);
+            if (view.values) view.values += skip;
+            if (view.int_values) view.int_values += skip;
+            view.length -= skip;
+            view.offset = 0;
+        }
+        views.push_back(view);
+    };
+#define FEATURE_SET_CHUNK_VIEW(name, offset) \
+    if (is_selected(columns, Feature::name)) \
+        rebase(column_view(Feature::name, features.name, column_rows[static_cast<size_t>(Feature::name)]));
+    FEATURE_COLUMNS(FEATURE_SET_CHUNK_VIEW)
+#undef FEATURE_SET_CHUNK_VIEW
+    write_columns(filepath, chunk, data_frequency, views, options, first_row > 0);
+}
+
+FastCSVWriter::ColumnView FastCSVWriter::column_view(Feature feature, const std::vector<double>& values, size_t offset) {
+    return {feature, values.data(), nullptr, nullptr, values.size(), offset};
+}
+
+FastCSVWriter::ColumnView FastCSVWriter::column_view(Feature feature, const std::vector<int>& values, size_t offset) {
+    return {feature, nullptr, values.data(), nullptr, values.size(), offset};
+}
+
+void FastCSVWriter::format_rows(
+    std::string& out, const OHLCVData& ohlcv_data, const std::string& data_frequency,
+    const std::vector<ColumnView>& columns, size_t begin, size_t end) {
+    DateTimeFormatter datetime;
+    for (size_t i = begin; i < end; ++i) {
+        // Original OHLCV columns
+        datetime.append(out, ohlcv_data.timestamps[i]);
+        out += ',';
+        append_fixed(out, ohlcv_data.open[i], 6);
+        out += ',';
+        append_fixed(out, ohlcv_data.high[i], 6);
+        out += ',';
+        append_fixed(out, ohlcv_data.low[i], 6);
+        out += ',';
+        append_fixed(out, ohlcv_data.close[i], 6);
+        out += ',';
+        append_fixed(out, ohlcv_data.volume[i], 0);
+        out += ',';
+        out += ohlcv_data.symbol;
+        out += ',';
+        out += data_frequency;
+
+        // Selected feature columns, aligned to their first valid row
+        for (const auto& column : columns) {
+            out += ',';
+            if (i < column.offset || i - column.offset >= column.length) continue;
+            const size_t k = i - column.offset;
+            if (column.int_values) {
+                append_int(out, column.int_values[k]);
+                continue;
+            }
+            const double value = column.float_values ? column.float_values[k] : column.values[k];
+            if (column.feature == Feature::candle_way) {
+                append_int(out, static_cast<int>(value));
+            } else {
+                append_fixed(out, value, 6);
+            }
+        }
+        out += '\n';
+    }
+}
+
+void FastCSVWriter::write_columns(
+    const std::string& filepath, const OHLCVData& ohlcv_data,
+    const std::string& data_frequency, const std::vector<ColumnView>& columns,
+    const CSVWriteOptions& options, bool append) {
+    try {
+        if (auto p = std::filesystem::path(filepath).parent_path(); !p.empty()) {
+            std::filesystem::create_directories(p);
+        }
+
+        const size_t rows = ohlcv_data.size();
+        const size_t chunk_rows = std::max<size_t>(1, options.chunk_rows);
+        const bool parallel = rows > options.parallel_min_rows && rows > chunk_rows;
+        const size_t chunks = parallel ? (rows + chunk_rows - 1) / chunk_rows : 1;
+
+        // parts[0] holds the header (and all rows when formatting serially);
+        // buffers keep their capacity between files written by this thread
+        thread_local std::vector<std::string> buffers;
+        std::vector<std::string>& parts = buffers;  // the formatting threads must see this thread's buffers
+        if (parts.size() < chunks + 1) parts.resize(chunks + 1);
+        for (size_t c = 0; c <= chunks; ++c) parts[c].clear();
+
+        std::string& header = parts[0];
+        if (!append) {
+            header += "datetime,open,high,low,close,volume,symbol,data_frequency";
+            for (const auto& column : columns) {
+                header += ',';
+                header += feature_name(column.feature);
+            }
+            header += '\n';
+        }
+
+        const size_t row_bytes = 80 + columns.size() * 12;  // rough per-row estimate
+        if (!parallel) {
+            header.reserve(header.size() + rows * row_bytes);
+            format_rows(header, ohlcv_data, data_frequency, columns, 0, rows);
+        } else {
+            unsigned threads = options.max_threads ? options.max_threads : std::thread::hardware_concurrency();
+            threads = static_cast<unsigned>(std::min<size_t>(std::max(1u, threads), chunks));
+            std::atomic<size_t> next_chunk{0};
+            auto worker = [&]() {
+                for (size_t c; (c = next_chunk.fetch_add(1)) < chunks;) {
+                    const size_t begin = c * chunk_rows;
+                    const size_t end = std::min(rows, begin + chunk_rows);
+                    std::string& out = parts[c + 1];
+                    out.reserve((end - begin) * row_bytes);
+                    format_rows(out, ohlcv_data, data_frequency, columns, begin, end);
+                }
+            };
+            std::vector<std::thread> pool;
+            for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+            worker();
+            for (auto& thread : pool) thread.join();
+        }
+
+        // Charged once formatted and again once written, as an AsyncFileIO
+        // write takes parts[0] over (and charges it itself)
+        thread_local MemoryCharge buffers_memory;
+        auto charge_buffers = [&] {
+            size_t bytes = 0;
+            for (const auto& part : parts) bytes += part.capacity();
+            buffers_memory.set(MemorySubsystem::Exports, bytes);
+        };
+        charge_buffers();
+        write_parts(filepath, parts.data(), chunks + 1, options, append);
+        // All of this thread's buffers share one cap, filled in part order
+        size_t retained = 0;
+        for (auto& part : parts) {
+            trim_buffer(part, options.retained_buffer_bytes - std::min(retained, options.retained_buffer_bytes));
+            retained += part.capacity();
+        }
+        charge_buffers();
+
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Error writing CSV file: " + std::string(e.what()));
+    }
+}
+
+void FastCSVWriter::write_named_columns(
+    const std::string& filepath, const std::string& symbol,
+    const std::vector<std::chrono::system_clock::time_point>& timestamps,
+    const std::vector<NamedColumn>& columns, const CSVWriteOptions& options) {
+    append_named_columns(filepath, symbol, timestamps, columns, true, options);
+}
+
+void FastCSVWriter::append_named_columns(
+    const std::string& filepath, const std::string& symbol,
+    const std::vector<std::chrono::system_clock::time_point>& timestamps,
+    const std::vector<NamedColumn>& columns, bool create, const CSVWriteOptions& options) {
     try {
         if (auto p = std::filesystem::path(filepath).parent_path(); !p.empty()) {
             std::filesystem::create_directories(p);
         }
-        
-        // Use large buffer for maximum write performance
-        constexpr size_t BUFFER_SIZE = 1024 * 1024; // 1MB buffer
-        std::vector<char> buffer;
-        buffer.reserve(ohlcv_data.size() * 200); // Estimate line length
-        
-        // Build entire CSV content in memory first
-        std::string content;
-        content.reserve(ohlcv_data.size() * 200);
-        
-        // Header
-        content += "datetime,open,high,low,close,volume,symbol,data_frequency,returns,sma,rsi,volatility,momentum,spread,internal_bar_strength,skewness_30,kurtosis_30,log_pct_change_5,auto_correlation_50_10,kama_10_2_30,linear_slope_20,linear_slope_60,parkinson_volatility_20,volume_sma_20,velocity,acceleration,candle_way,candle_filling,candle_amplitude,";
-        content += "z_score_20,percentile_rank_50,coefficient_of_variation_30,detrended_price_oscillator_20,hurst_exponent_100,garch_volatility_21,shannon_entropy_volume_10,";
-        content += "chande_momentum_oscillator_14,aroon_oscillator_25,trix_15,vortex_indicator_14,supertrend_10_3,ichimoku_senkou_span_A_9_26,ichimoku_senkou_span_B_26_52,fisher_transform_10,";
-        content += "volume_weighted_average_price_intraday,volume_profile_high_volume_node_intraday,volume_profile_low_volume_node_intraday,on_balance_volume_sma_20,klinger_oscillator_34_55,money_flow_index_14,vwap_deviation_stddev_30,";
-        content += "markov_regime_switching_garch_2_state,adx_rating_14,chow_test_statistic_breakpoint_detection_50,market_regime_hmm_3_states_price_vol,high_volatility_indicator_garch_threshold,";
-        content += "return_x_volume_interaction_10,volatility_x_rsi_interaction_14,price_to_kama_ratio_20_10_30,polynomial_regression_price_degree_2_slope,";
-        content += "conditional_value_at_risk_cvar_95_20,drawdown_duration_from_peak_50,ulcer_index_14,sortino_ratio_30\n";
-        
-        // Pre-allocate string for reuse
-        std::string line;
-        line.reserve(500); // Increased for more features
-        
-        for (size_t i = 0; i < ohlcv_data.size(); ++i) {
-            line.clear();
-            
-            // Build line efficiently - Original features
-            line += format_datetime(ohlcv_data.timestamps[i]) + ",";
-            line += format_double(ohlcv_data.open[i]) + ",";
-            line += format_double(ohlcv_data.high[i]) + ",";
-            line += format_double(ohlcv_data.low[i]) + ",";
-            line += format_double(ohlcv_data.close[i]) + ",";
-            line += format_double(ohlcv_data.volume[i], 0) + ",";
-            line += ohlcv_data.symbol + "," + data_frequency + ",";
-            line += safe_get_value(features.returns, i, 1) + ",";
-            line += safe_get_value(features.sma, i, 19) + ",";
-            line += safe_get_value(features.rsi, i, 14) + ",";
-            line += safe_get_value(features.volatility, i, 20) + ",";
-            line += safe_get_value(features.momentum, i, 10) + ",";
-            line += safe_get_value(features.spread, i, 0) + ",";
-            line += safe_get_value(features.internal_bar_strength, i, 0) + ",";
-            line += safe_get_value(features.skewness_30, i, 29) + ",";
-            line += safe_get_value(features.kurtosis_30, i, 29) + ",";
-            line += safe_get_value(features.log_pct_change_5, i, 5) + ",";
-            line += safe_get_value(features.auto_correlation_50_10, i, 59) + ",";
-            line += safe_get_value(features.kama_10_2_30, i, 0) + ",";
-            line += safe_get_value(features.linear_slope_20, i, 19) + ",";
-            line += safe_get_value(features.linear_slope_60, i, 59) + ",";
-            line += safe_get_value(features.parkinson_volatility_20, i, 19) + ",";
-            line += safe_get_value(features.volume_sma_20, i, 19) + ",";
-            line += safe_get_value(features.velocity, i, 1) + ",";
-            line += safe_get_value(features.acceleration, i, 2) + ",";
-            line += safe_get_int_value(features.candle_way, i, 0) + ",";
-            line += safe_get_value(features.candle_filling, i, 0) + ",";
-            line += safe_get_value(features.candle_amplitude, i, 0) + ",";
-            
-            // Statistical/Mathematical Features
-            line += safe_get_value(features.z_score_20, i, 19) + ",";
-            line += safe_get_value(features.percentile_rank_50, i, 49) + ",";
-            line += safe_get_value(features.coefficient_of_variation_30, i, 29) + ",";
-            line += safe_get_value(features.detrended_price_oscillator_20, i, 19) + ",";
-            line += safe_get_value(features.hurst_exponent_100, i, 99) + ",";
-            line += safe_get_value(features.garch_volatility_21, i, 20) + ",";
-            line += safe_get_value(features.shannon_entropy_volume_10, i, 9) + ",";
-            
-            // Technical Analysis Extended
-            line += safe_get_value(features.chande_momentum_oscillator_14, i, 14) + ",";
-            line += safe_get_value(features.aroon_oscillator_25, i, 24) + ",";
-            line += safe_get_value(features.trix_15, i, 45) + ","; // 3 EMAs of 15 periods each
-            line += safe_get_value(features.vortex_indicator_14, i, 14) + ",";
-            line += safe_get_value(features.supertrend_10_3, i, 9) + ",";
-            line += safe_get_value(features.ichimoku_senkou_span_A_9_26, i, 25) + ",";
-            line += safe_get_value(features.ichimoku_senkou_span_B_26_52, i, 51) + ",";
-            line += safe_get_value(features.fisher_transform_10, i, 9) + ",";
-            
-            // Volume/Liquidity Advanced
-            line += safe_get_value(features.volume_weighted_average_price_intraday, i, 0) + ",";
-            line += safe_get_value(features.volume_profile_high_volume_node_intraday, i, 0) + ",";
-            line += safe_get_value(features.volume_profile_low_volume_node_intraday, i, 0) + ",";
-            line += safe_get_value(features.on_balance_volume_sma_20, i, 20) + ",";
-            line += safe_get_value(features.klinger_oscillator_34_55, i, 55) + ",";
-            line += safe_get_value(features.money_flow_index_14, i, 14) + ",";
-            line += safe_get_value(features.vwap_deviation_stddev_30, i, 30) + ",";
-            
-            // Regime Detection
-            line += safe_get_value(features.markov_regime_switching_garch_2_state, i, 0) + ",";
-            line += safe_get_value(features.adx_rating_14, i, 14) + ",";
-            line += safe_get_value(features.chow_test_statistic_breakpoint_detection_50, i, 100) + ",";
-            line += safe_get_value(features.market_regime_hmm_3_states_price_vol, i, 0) + ",";
-            line += safe_get_value(features.high_volatility_indicator_garch_threshold, i, 20) + ",";
-            
-            // Non-Linear/Interaction
-            line += safe_get_value(features.return_x_volume_interaction_10, i, 10) + ",";
-            line += safe_get_value(features.volatility_x_rsi_interaction_14, i, 0) + ",";
-            line += safe_get_value(features.price_to_kama_ratio_20_10_30, i, 0) + ",";
-            line += safe_get_value(features.polynomial_regression_price_degree_2_slope, i, 19) + ",";
-            
-            // Alternative Risk Measures
-            line += safe_get_value(features.conditional_value_at_risk_cvar_95_20, i, 19) + ",";
-            line += safe_get_value(features.drawdown_duration_from_peak_50, i, 49) + ",";
-            line += safe_get_value(features.ulcer_index_14, i, 13) + ",";
-            line += safe_get_value(features.sortino_ratio_30, i, 29) + "\n";
-            
-            content += line;
+        thread_local std::string out;
+        out.clear();
+        if (create) {
+            out += "datetime,symbol";
+            for (const auto& column : columns) {
+                out += ',';
+                out += column.name;
+            }
+            out += '\n';
+        }
+        out.reserve(out.size() + timestamps.size() * (40 + columns.size() * 12));
+
+        DateTimeFormatter datetime;
+        for (size_t i = 0; i < timestamps.size(); ++i) {
+            datetime.append(out, timestamps[i]);
+            out += ',';
+            out += symbol;
+            for (const auto& column : columns) {
+                out += ',';
+                if (i < column.offset || i - column.offset >= column.length) continue;
+                append_fixed(out, column.values[i - column.offset], 6);
+            }
+            out += '\n';
         }
-        
-        // Single write operation for maximum speed
-        std::ofstream file(filepath, std::ios::out | std::ios::binary);
-        if (!file.is_open()) throw std::runtime_error("Cannot create file: " + filepath);
-        
-        // Set large buffer for file stream
-        file.rdbuf()->pubsetbuf(nullptr, BUFFER_SIZE);
-        file.write(content.data(), content.size());
-        file.close();
-        
+        thread_local MemoryCharge out_memory;
+        out_memory.set(MemorySubsystem::Exports, out.capacity());
+        write_parts(filepath, &out, 1, options, !create);
+        trim_buffer(out, options.retained_buffer_bytes);
+        out_memory.set(MemorySubsystem::Exports, out.capacity());
     } catch (const std::exception& e) {
         throw std::runtime_error("Error writing CSV file: " + std::string(e.what()));
     }
 }
+
+void FastCSVWriter::write_parts(const std::string& filepath, std::string* parts, size_t count,
+                                const CSVWriteOptions& options, bool append) {
+    const bool direct_io = options.direct_io;
+    if (options.async_io && !append && !direct_io) {
+        // The only part is moved over; parallel chunks are joined first
+        std::string content = std::move(parts[0]);
+        for (size_t i = 1; i < count; ++i) content += parts[i];
+        options.async_io->write_file(filepath, std::move(content));
+        return;
+    }
+#ifdef __linux__
+    // O_DIRECT writes whole blocks from offset 0, so appends stay buffered
+    if (direct_io && !append) {
+        // O_DIRECT needs block-aligned buffers and lengths: copy into one
+        // aligned buffer padded to a block, write it, then trim the padding
+        constexpr size_t kBlock = 4096;
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) total += parts[i].size();
+        const size_t padded = (total + kBlock - 1) / kBlock * kBlock;
+
+        int fd = open(filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+        void* buffer = nullptr;
+        if (fd != -1 && padded > 0 && posix_memalign(&buffer, kBlock, padded) == 0) {
+            char* p = static_cast<char*>(buffer);
+            for (size_t i = 0; i < count; ++i) p = std::copy(parts[i].begin(), parts[i].end(), p);
+            std::fill(p, static_cast<char*>(buffer) + padded, '\0');
+
+            size_t written = 0;
+            while (written < padded) {
+                ssize_t n = pwrite(fd, static_cast<char*>(buffer) + written, padded - written, written);
+                if (n <= 0) break;
+                written += static_cast<size_t>(n);
+            }
+            free(buffer);
+            const bool ok = written == padded && ftruncate(fd, static_cast<off_t>(total)) == 0;
+            close(fd);
+            if (ok) return;
+            throw std::runtime_error("Direct write failed: " + filepath);
+        }
+        if (buffer) free(buffer);
+        if (fd != -1) close(fd);
+        // Filesystem without O_DIRECT support (e.g. tmpfs): use the buffered path
+    }
+#else
+    (void)direct_io;
+#endif
+
+    std::ofstream file(filepath, std::ios::out | std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+    if (!file.is_open()) throw std::runtime_error("Cannot create file: " + filepath);
+    for (size_t i = 0; i < count; ++i) file.write(parts[i].data(), parts[i].size());
+    if (!file) throw std::runtime_error("Cannot write file: " + filepath);
+}
@@ -0,0 +1,117 @@
+#include "feature_block.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace {
+void* allocate_aligned(size_t bytes, size_t alignment) {
+#ifdef _WIN32
+    return _aligned_malloc(bytes, alignment);
+#else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, alignment, bytes) != 0) return nullptr;
+    return ptr;
+#endif
+}
+
+void free_aligned(void* ptr) {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+template <typename T, typename Stored>
+void copy_column(const Stored* column, size_t length, std::vector<T>& out) {
+    out.resize(length);
+    for (size_t i = 0; i < length; ++i) out[i] = static_cast<T>(column[i]);
+}
+}
+
+FeatureBlock::~FeatureBlock() {
+    free_aligned(data_);
+}
+
+void FeatureBlock::reset(size_t rows) {
+    const size_t per_line = kAlignment / element_size();
+    const size_t stride = std::max<size_t>(1, (rows + per_line - 1) / per_line) * per_line;
+    const size_t needed = stride * kFeatureCount * element_size();
+
+    if (needed > capacity_) {
+        free_aligned(data_);
+        data_ = allocate_aligned(needed, kAlignment);
+        if (!data_) {
+            capacity_ = 0;
+            memory_.release();
+            throw std::bad_alloc();
+        }
+        capacity_ = needed;
+        memory_.set(MemorySubsystem::Features, capacity_);
+    }
+    rows_ = rows;
+    stride_ = stride;
+    lengths_.fill(0);
+}
+
+double* FeatureBlock::column(Feature feature) {
+    if (precision_ != FeaturePrecision::Float64) return nullptr;
+    return static_cast<double*>(data_) + offset(feature);
+}
+
+const double* FeatureBlock::column(Feature feature) const {
+    if (precision_ != FeaturePrecision::Float64) return nullptr;
+    return static_cast<const double*>(data_) + offset(feature);
+}
+
+float* FeatureBlock::column_f32(Feature feature) {
+    if (precision_ != FeaturePrecision::Float32) return nullptr;
+    return static_cast<float*>(data_) + offset(feature);
+}
+
+const float* FeatureBlock::column_f32(Feature feature) const {
+    if (precision_ != FeaturePrecision::Float32) return nullptr;
+    return static_cast<const float*>(data_) + offset(feature);
+}
+
+void FeatureBlock::set_length(Feature feature, size_t length) {
+    lengths_[static_cast<size_t>(feature)] = std::min(length, rows_);
+}
+
+void FeatureBlock::assign(Feature feature, const double* values, size_t length) {
+    length = std::min(length, rows_);
+    if (precision_ == FeaturePrecision::Float32) {
+        float* out = column_f32(feature);
+        for (size_t i = 0; i < length; ++i) out[i] = static_cast<float>(values[i]);
+    } else {
+        std::copy(values, values + length, column(feature));
+    }
+    lengths_[static_cast<size_t>(feature)] = length;
+}
+
+void FeatureBlock::assign(Feature feature, const std::vector<double>& values) {
+    assign(feature, values.data(), values.size());
+}
+
+void FeatureBlock::assign(Feature feature, const std::vector<int>& values) {
+    const size_t length = std::min(values.size(), rows_);
+    if (precision_ == FeaturePrecision::Float32) {
+        float* out = column_f32(feature);
+        for (size_t i = 0; i < length; ++i) out[i] = static_cast<float>(values[i]);
+    } else {
+        double* out = column(feature);
+        for (size_t i = 0; i < length; ++i) out[i] = values[i];
+    }
+    lengths_[static_cast<size_t>(feature)] = length;
+}
+
+FeatureSet FeatureBlock::to_feature_set() const {
+    FeatureSet features;
+    const bool f32 = precision_ == FeaturePrecision::Float32;
+#define COPY_FEATURE_COLUMN(name, offset) \
+    if (f32) copy_column(column_f32(Feature::name), length(Feature::name), features.name); \
+    else copy_column(column(Feature::name), length(Feature::name), features.name);
+    FEATURE_COLUMNS(COPY_FEATURE_COLUMN)
+#undef COPY_FEATURE_COLUMN
+    return features;
+}
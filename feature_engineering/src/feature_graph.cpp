@@ -0,0 +1,90 @@
+#include "feature_graph.h"
+#include "technical_indicators.h"
+#include "simd_technical_indicators.h"
+#include "neon_technical_indicators.h"
+
+FeatureGraph::FeatureGraph(const std::vector<double>& high, const std::vector<double>& low,
+                           const std::vector<double>& close, const std::vector<double>& volume,
+                           ComputeBackend backend)
+    : high_(high), low_(low), close_(close), volume_(volume), backend_(backend) {}
+
+std::vector<double> FeatureGraph::compute(FeatureNode node) {
+    switch (node) {
+    case FeatureNode::Returns:
+        if (backend_ == ComputeBackend::NEON) return NEONTechnicalIndicators::calculate_returns_neon(close_);
+        if (backend_ == ComputeBackend::AVX2) return SIMDTechnicalIndicators::calculate_returns_simd(close_);
+        return TechnicalIndicators::calculate_returns(close_);
+
+    case FeatureNode::RollingVolatility20: {
+        const auto& returns = get<FeatureNode::Returns>();
+        if (returns.empty()) return {};
+        if (backend_ == ComputeBackend::NEON) return NEONTechnicalIndicators::calculate_rolling_volatility_neon(returns, 20);
+        if (backend_ == ComputeBackend::AVX2) return SIMDTechnicalIndicators::calculate_rolling_volatility_simd(returns, 20);
+        return TechnicalIndicators::calculate_rolling_volatility(returns, 20);
+    }
+
+    case FeatureNode::Sma20:
+        if (backend_ == ComputeBackend::NEON) return NEONTechnicalIndicators::simple_moving_average_neon(close_, 20);
+        if (backend_ == ComputeBackend::AVX2) return SIMDTechnicalIndicators::simple_moving_average_simd(close_, 20);
+        return TechnicalIndicators::simple_moving_average(close_, 20);
+
+    case FeatureNode::VolumeSma20:
+        if (backend_ == ComputeBackend::NEON) return NEONTechnicalIndicators::simple_moving_average_neon(volume_, 20);
+        if (backend_ == ComputeBackend::AVX2) return SIMDTechnicalIndicators::simple_moving_average_simd(volume_, 20);
+        return TechnicalIndicators::simple_moving_average(volume_, 20);
+
+    case FeatureNode::CloseEma15:
+        return TechnicalIndicators::exponential_moving_average(close_, 15);
+    case FeatureNode::CloseEma15x2:
+        return TechnicalIndicators::exponential_moving_average(get<FeatureNode::CloseEma15>(), 15);
+    case FeatureNode::CloseEma15x3:
+        return TechnicalIndicators::exponential_moving_average(get<FeatureNode::CloseEma15x2>(), 15);
+
+    case FeatureNode::GarchVolatility21:
+        return TechnicalIndicators::garch_volatility_21(get<FeatureNode::Returns>());
+
+    case FeatureNode::GarchFilteredVolatility: {
+        const auto& returns = get<FeatureNode::Returns>();
+        if (returns.size() < GarchModel::kWarmup) return {};
+        const GarchParams params = has_garch_params_ ? garch_params_
+                                                     : GarchModel::default_params(returns.data(), returns.size());
+        std::vector<double> volatility(returns.size() - GarchModel::kWarmup + 1);
+        GarchModel::filtered_volatility(returns.data(), returns.size(), params, volatility.data());
+        return volatility;
+    }
+
+    case FeatureNode::RegimeProbabilities2:
+    case FeatureNode::RegimeProbabilities3: {
+        const auto& returns = get<FeatureNode::Returns>();
+        if (returns.size() < RegimeModel::kWarmup) return {};
+        const size_t states = node == FeatureNode::RegimeProbabilities2 ? 2 : 3;
+        const HmmParams params = !has_regime_params_ ? RegimeModel::default_params(returns.data(), returns.size(), states)
+                                 : states == 2       ? regime_params_.two_state
+                                                     : regime_params_.three_state;
+        std::vector<double> probabilities(states * returns.size());
+        RegimeModel::filter(returns.data(), returns.size(), params, probabilities.data());
+        return probabilities;
+    }
+
+    case FeatureNode::Vwap:
+        return TechnicalIndicators::volume_weighted_average_price_intraday(high_, low_, close_, volume_);
+
+    case FeatureNode::Rsi14:
+        // NEON reaches the vector kernels through the same dispatch table
+        if (backend_ != ComputeBackend::Scalar) return SIMDTechnicalIndicators::calculate_rsi_simd(close_, 14);
+        return TechnicalIndicators::calculate_rsi(close_, 14);
+
+    case FeatureNode::Kama10_2_30:
+        return TechnicalIndicators::kama(close_, 10, 2, 30);
+    case FeatureNode::Kama20_10_30:
+        return TechnicalIndicators::kama(close_, 20, 10, 30);
+
+    case FeatureNode::Klinger34_55:
+        if (backend_ != ComputeBackend::Scalar) return SIMDTechnicalIndicators::klinger_oscillator_34_55_simd(high_, low_, close_, volume_);
+        return TechnicalIndicators::klinger_oscillator_34_55(high_, low_, close_, volume_);
+
+    case FeatureNode::Count:
+        break;
+    }
+    return {};
+}
@@ -0,0 +1,554 @@
+#include "feature_pipeline.h"
+#include "async_file_io.h"
+#include "bounded_queue.h"
+#include "batch_ohlc_processor.h"
+#include "chunked_series.h"
+#include "csv_reader.h"
+#include "csv_writer.h"
+#include "columnar_writer.h"
+#include "feature_block.h"
+#include "garch_model.h"
+#include "regime_model.h"
+#include "hardware_counters.h"
+#include "machine_profile.h"
+#include "memory_accounting.h"
+#include "shared_feature_segment.h"
+#include "technical_indicators.h"
+#include "trace.h"
+#include "window_sweep.h"
+#include <algorithm>
+#include <numeric>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+using Clock = std::chrono::high_resolution_clock;
+
+struct ComputedStock {
+    std::unique_ptr<OHLCVData> data;
+    std::unique_ptr<FeatureBlock> block;
+    std::vector<WindowSweep::Column> sweep;
+    std::string frequency;      // data_frequency column
+    std::string name;           // output file stem: the symbol, or <symbol>_<frequency> when resampled
+};
+
+double elapsed_ms(Clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+
+// Starts `count` threads running body(worker); with hardware counters
+// enabled each thread's counts are recorded under `stage`, and with
+// tracing each thread's row is labelled after it
+template <typename Body>
+std::vector<std::thread> launch(const char* stage, unsigned count, Body body) {
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+    for (unsigned t = 0; t < count; ++t) {
+        threads.emplace_back([stage, body](unsigned worker) {
+            set_trace_thread_name(std::string(stage) + " #" + std::to_string(worker));
+            if (!hardware_counters_enabled()) return body(worker);
+            HardwareCounters counters(false);
+            if (counters.valid()) counters.start();
+            body(worker);
+            if (counters.valid()) record_counters(stage, counters.read());
+        }, t);
+    }
+    return threads;
+}
+
+void join_all(std::vector<std::thread>& threads) {
+    for (auto& thread : threads) thread.join();
+}
+
+unsigned resolve_compute_threads(const PipelineConfig& config) {
+    return config.compute_threads ? config.compute_threads : tuned_threads();
+}
+
+// Rows of a CSV file of `bytes` bytes, from the line length of its first
+// 64 KB (exact for files no larger)
+size_t estimate_rows(const std::string& path, size_t bytes) {
+    constexpr size_t kSample = 64 << 10;
+    std::vector<char> sample(std::min(bytes, kSample));
+    std::ifstream file(path, std::ios::binary);
+    file.read(sample.data(), static_cast<std::streamsize>(sample.size()));
+    const size_t read = static_cast<size_t>(file.gcount());
+    const size_t lines = static_cast<size_t>(std::count(sample.begin(), sample.begin() + read, '\n'));
+    if (read == 0 || lines == 0) return 0;
+    if (read >= bytes) return lines - 1;
+    return static_cast<size_t>(static_cast<double>(bytes) * lines / read);
+}
+}
+
+OutputFormat parse_output_format(const std::string& name) {
+    if (name == "csv") return OutputFormat::Csv;
+    if (name == "mftc" || name == "binary") return OutputFormat::Columnar;
+    if (name == "both") return OutputFormat::Both;
+    throw std::runtime_error("Unknown output format: " + name);
+}
+
+ColumnarCompression parse_columnar_compression(const std::string& text) {
+    const size_t colon = text.find(':');
+    const std::string name = text.substr(0, colon);
+    ColumnarCompression compression;
+    if (name == "lz4") {
+        compression.codec = ColumnCodec::Lz4;
+    } else if (name == "zstd") {
+        compression.codec = ColumnCodec::Zstd;
+    } else if (name != "none" || colon != std::string::npos) {
+        throw std::runtime_error("Unknown compression: " + text);
+    }
+    if (colon != std::string::npos) {
+        const std::string level = text.substr(colon + 1);
+        if (level.empty() || level.size() > 3 || !std::all_of(level.begin(), level.end(), [](unsigned char c) { return std::isdigit(c) != 0; })) {
+            throw std::runtime_error("Invalid compression level: " + text);
+        }
+        compression.level = std::stoi(level);
+    }
+    if (!column_codec_available(compression.codec)) {
+        throw std::runtime_error(std::string("Compression not available in this build: ") + name);
+    }
+    return compression;
+}
+
+FeaturePrecision parse_feature_precision(const std::string& name) {
+    if (name == "f64") return FeaturePrecision::Float64;
+    if (name == "f32") return FeaturePrecision::Float32;
+    throw std::runtime_error("Unknown feature precision: " + name);
+}
+
+size_t parse_memory_size(const std::string& text) {
+    size_t digits = 0;
+    while (digits < text.size() && std::isdigit(static_cast<unsigned char>(text[digits]))) ++digits;
+    std::string suffix = text.substr(digits);
+    for (auto& c : suffix) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    const bool gigabytes = suffix == "G" || suffix == "GB";
+    if (digits == 0 || digits > 12 || !(suffix.empty() || suffix == "M" || suffix == "MB" || gigabytes)) {
+        throw std::runtime_error("Invalid memory size: " + text);
+    }
+    const size_t value = static_cast<size_t>(std::stoull(text.substr(0, digits)));
+    return gigabytes ? value * 1024 : value;
+}
+
+MemoryPlan plan_memory(const PipelineConfig& config, const FeatureMask& selection) {
+    const double budget = static_cast<double>(config.memory_budget_mb) * (1 << 20);
+    const size_t selected = selection.count();
+    const size_t element = config.precision == FeaturePrecision::Float32 ? sizeof(float) : sizeof(double);
+    const size_t bar = sizeof(std::chrono::system_clock::time_point) + 5 * sizeof(double);
+    // A row of the text or image being written, as the writers size them
+    size_t output = 0;
+    if (config.format != OutputFormat::Columnar) output += 80 + selected * 12;
+    if (config.format != OutputFormat::Csv) output += (6 + selected) * sizeof(double);
+    // Sweep columns plus the closes and returns they are computed from
+    size_t sweep = 0;
+    if (config.window_sweep.enabled()) {
+        sweep = (config.window_sweep.indicators.count() * config.window_sweep.windows.size() + 2) * sizeof(double);
+    }
+
+    const unsigned compute_threads = resolve_compute_threads(config);
+    const size_t slots = 2 * std::max<size_t>(1, config.queue_depth) + std::max(1u, config.read_threads) +
+                         compute_threads + std::max(1u, config.write_threads);
+    const size_t series_row = bar + selected * element + output + sweep;
+    const size_t chunk_row = bar + 3 * kFeatureCount * sizeof(double) + output + sweep;
+    // AsyncFileIO: source files read but not parsed yet (about 64 bytes a
+    // line) and outputs handed over but not written yet
+    const size_t io_row = static_cast<size_t>(config.io_depth) *
+                          (std::max(1u, config.read_threads) * 64 + std::max(1u, config.write_threads) * output);
+
+    MemoryPlan plan;
+    plan.series_rows = std::max(MemoryPlan::kMinChunkRows,
+                                static_cast<size_t>(budget / (slots * series_row + io_row)));
+    plan.chunk_rows = std::max(MemoryPlan::kMinChunkRows, static_cast<size_t>(budget / (compute_threads * chunk_row)));
+    return plan;
+}
+
+PipelineStats run_feature_pipeline(const std::vector<std::string>& csv_files,
+                                   const std::string& output_dir,
+                                   const FeatureMask& selection,
+                                   const PipelineConfig& config) {
+    const unsigned read_threads = std::max(1u, config.read_threads);
+    const unsigned compute_threads = resolve_compute_threads(config);
+    const unsigned write_threads = std::max(1u, config.write_threads);
+    const size_t depth = std::max<size_t>(1, config.queue_depth);
+
+    PipelineStats stats;
+    stats.read.workers.resize(read_threads);
+    stats.compute.workers.resize(compute_threads);
+    stats.write.workers.resize(write_threads);
+
+    // Largest files first so the long histories do not end up as the tail
+    std::vector<size_t> sizes(csv_files.size(), 0);
+    for (size_t i = 0; i < csv_files.size(); ++i) {
+        std::error_code ec;
+        auto bytes = std::filesystem::file_size(csv_files[i], ec);
+        if (!ec) sizes[i] = static_cast<size_t>(bytes);
+    }
+    std::vector<size_t> order(csv_files.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+    // With a memory budget, series too long to hold whole are set aside for chunking
+    std::vector<size_t> chunked;
+    MemoryPlan plan;
+    if (config.memory_budget_mb > 0) {
+        plan = plan_memory(config, selection);
+        auto whole = std::stable_partition(order.begin(), order.end(), [&](size_t i) {
+            return estimate_rows(csv_files[i], sizes[i]) <= plan.series_rows;
+        });
+        chunked.assign(whole, order.end());
+        order.erase(whole, order.end());
+    }
+
+    // Outputs written per file: one per frequency when resampling
+    const size_t expected = csv_files.size() * (config.resample.enabled() ? config.resample.frequencies.size() : 1);
+
+    std::filesystem::create_directories(output_dir);
+
+    BoundedQueue<std::unique_ptr<OHLCVData>> parsed(depth);
+    BoundedQueue<ComputedStock> computed(depth);
+
+    // Feature blocks circulate compute -> write -> compute; enough for every
+    // slot a block can occupy, so taking one never waits on the writers
+    const size_t block_count = compute_threads + depth + write_threads;
+    BoundedQueue<std::unique_ptr<FeatureBlock>> free_blocks(block_count);
+    for (size_t i = 0; i < block_count; ++i) free_blocks.push(std::make_unique<FeatureBlock>(config.precision));
+
+    PanelConfig panel_config = config.panel_config;
+    if (!panel_config.threads) panel_config.threads = compute_threads;
+    PanelEngine panel(panel_config);
+    if (config.panel && !config.panel_factors.empty()) {
+        try {
+            panel.load_factors(config.panel_factors);
+        } catch (const std::exception& e) {
+            std::cerr << "Error loading factors: " << e.what() << std::endl;
+        }
+    }
+
+    GarchParamCache garch_cache;
+    if (config.fit_garch && !config.garch_cache.empty()) garch_cache.load(config.garch_cache);
+
+    std::atomic<size_t> next_file{0};
+    std::atomic<size_t> files_read{0}, read_errors{0}, written{0}, process_errors{0}, data_points{0};
+    std::atomic<size_t> garch_fitted{0}, garch_cached{0}, regimes_fitted{0}, sweep_written{0}, chunked_stocks{0};
+    std::atomic<size_t> resampled_series{0};
+    std::atomic<unsigned> readers_left{read_threads}, computers_left{compute_threads};
+    std::mutex log_mutex;
+    BatchOHLCProcessor processor;
+    processor.set_loop_fusion(config.loop_fusion);
+
+    auto start = Clock::now();
+
+    AsyncIOConfig io_config;
+    io_config.queue_depth = config.io_depth;
+    std::mutex backend_mutex;
+    auto note_backend = [&](const AsyncFileIO& io) {
+        std::lock_guard<std::mutex> lock(backend_mutex);
+        stats.io_backend = async_io_backend_name(io.backend());
+    };
+
+    // The read, compute and write stages overlap, so they share one memory stage
+    std::optional<MemoryScope> stream_memory;
+    stream_memory.emplace("read/compute/write");
+    auto readers = launch("stage: read", read_threads, [&](unsigned worker) {
+        WorkerStats& ws = stats.read.workers[worker];
+        // Parses one file (mapped, or from the bytes AsyncFileIO read) and queues it
+        auto take = [&](size_t index, const std::string& path, auto&& parse) {
+            TraceSpan span("read stock", "stock", static_cast<int64_t>(index));
+            auto t0 = Clock::now();
+            std::unique_ptr<OHLCVData> data;
+            try {
+                data = parse();
+            } catch (const std::exception& e) {
+                ++read_errors;
+                std::lock_guard<std::mutex> lock(log_mutex);
+                std::cerr << "Error reading " << path << ": " << e.what() << std::endl;
+            }
+            ws.busy_ms += elapsed_ms(t0);
+            ++ws.tasks;
+            if (!data || data->empty()) return;
+            ++files_read;
+            span.end();
+            TraceSpan wait("wait: parsed queue full", "queue");
+            parsed.push(std::move(data));
+        };
+
+        if (config.io_depth == 0) {
+            for (size_t k; (k = next_file.fetch_add(1)) < order.size();) {
+                const std::string& path = csv_files[order[k]];
+                take(order[k], path, [&] { return FastCSVReader::read_csv_file(path); });
+            }
+        } else {
+            // Files are still claimed largest first, but parsed as their reads complete
+            AsyncFileIO io(io_config);
+            note_backend(io);
+            io.read_files([&](std::string& path, size_t& index) {
+                const size_t k = next_file.fetch_add(1);
+                if (k >= order.size()) return false;
+                index = order[k];
+                path = csv_files[index];
+                return true;
+            }, [&](const AsyncIOResult& file) {
+                take(file.tag, *file.path, [&] {
+                    if (!file.ok()) throw std::runtime_error(file.message());
+                    return FastCSVReader::parse_csv(file.data, file.size);
+                });
+            });
+        }
+        if (--readers_left == 0) parsed.close();
+    });
+
+    auto computers = launch("stage: compute", compute_threads, [&](unsigned worker) {
+        WorkerStats& ws = stats.compute.workers[worker];
+        std::unique_ptr<OHLCVData> data;
+        std::vector<OHLCVData> resampled;
+        std::vector<WindowSweep::Column> sweep;
+
+        // Computes one series (the source, or one of its frequencies) and
+        // hands it to the writers; false if it failed
+        auto compute_series = [&](std::unique_ptr<OHLCVData> series, const std::string& frequency,
+                                  std::string name) {
+            std::unique_ptr<FeatureBlock> block;
+            {
+                TraceSpan block_wait("wait: free block", "queue");
+                free_blocks.pop(block);
+            }
+            TraceSpan span("compute stock", "stock", static_cast<int64_t>(series->size()));
+            auto t0 = Clock::now();
+            try {
+                GarchParams garch{};
+                if (config.fit_garch) {
+                    if (garch_cache.find(name, series->size(), garch)) {
+                        ++garch_cached;
+                    } else {
+                        garch = GarchModel::fit(TechnicalIndicators::calculate_returns(series->close));
+                        garch_cache.store(name, series->size(), garch);
+                        ++garch_fitted;
+                    }
+                }
+                RegimeFeatureParams regimes{};
+                if (config.fit_regimes) {
+                    regimes = RegimeModel::fit_features(TechnicalIndicators::calculate_returns(series->close));
+                    ++regimes_fitted;
+                }
+                processor.calculate_features_into(series->open, series->high, series->low, series->close,
+                                                  series->volume, *block, false, selection,
+                                                  config.fit_garch ? &garch : nullptr,
+                                                  config.fit_regimes ? &regimes : nullptr);
+                if (config.window_sweep.enabled()) WindowSweep::compute(series->close, config.window_sweep, sweep);
+            } catch (const std::exception& e) {
+                ++process_errors;
+                std::lock_guard<std::mutex> lock(log_mutex);
+                std::cerr << "Error processing " << name << ": " << e.what() << std::endl;
+                free_blocks.push(std::move(block));
+                return false;
+            }
+            if (config.panel) panel.add_series(series->symbol, series->timestamps, series->close);
+            ws.busy_ms += elapsed_ms(t0);
+            data_points += series->size();
+            span.end();
+            TraceSpan push_wait("wait: computed queue full", "queue");
+            computed.push({std::move(series), std::move(block), std::move(sweep), frequency, std::move(name)});
+            return true;
+        };
+
+        for (;;) {
+            TraceSpan wait("wait: parsed queue", "queue");
+            if (!parsed.pop(data)) break;
+            wait.end();
+            if (!config.resample.enabled()) {
+                const std::string name = data->symbol;
+                if (compute_series(std::move(data), config.data_frequency, name)) ++ws.tasks;
+            } else {
+                {
+                    TraceSpan span("resample stock", "stock", static_cast<int64_t>(data->size()));
+                    auto t0 = Clock::now();
+                    BarResampler::resample(*data, config.resample, resampled);
+                    ws.busy_ms += elapsed_ms(t0);
+                }
+                data.reset();
+                for (size_t k = 0; k < resampled.size(); ++k) {
+                    if (resampled[k].empty()) continue;
+                    const BarFrequency& frequency = config.resample.frequencies[k];
+                    auto series = std::make_unique<OHLCVData>(std::move(resampled[k]));
+                    std::string name = series->symbol + "_" + frequency.name;
+                    if (compute_series(std::move(series), frequency.name, std::move(name))) ++resampled_series;
+                }
+                ++ws.tasks;
+            }
+        }
+        if (--computers_left == 0) computed.close();
+    });
+
+    auto writers = launch("stage: write", write_threads, [&](unsigned worker) {
+        WorkerStats& ws = stats.write.workers[worker];
+        std::unique_ptr<AsyncFileIO> io;
+        CSVWriteOptions csv = config.csv;
+        ColumnarWriteOptions columnar = config.columnar;
+        if (config.io_depth > 0) {
+            io = std::make_unique<AsyncFileIO>(io_config);
+            note_backend(*io);
+            csv.async_io = io.get();
+            columnar.async_io = io.get();
+        }
+        // Files that failed after they were handed over
+        auto report_write_errors = [&] {
+            if (!io) return;
+            for (const auto& error : io->take_write_errors()) {
+                ++process_errors;
+                std::lock_guard<std::mutex> lock(log_mutex);
+                std::cerr << "Error writing " << error.second << std::endl;
+            }
+        };
+        ComputedStock item;
+        for (;;) {
+            TraceSpan wait("wait: computed queue", "queue");
+            if (!computed.pop(item)) break;
+            wait.end();
+            TraceSpan span("write stock", "stock", static_cast<int64_t>(item.data->size()));
+            auto t0 = Clock::now();
+            const std::string output_path = output_dir + "/" + item.name + "_features";
+            try {
+                if (config.format != OutputFormat::Columnar) {
+                    FastCSVWriter::write_ohlcv_with_features(output_path + ".csv", *item.data, *item.block,
+                                                             item.frequency, selection, csv);
+                }
+                if (config.format != OutputFormat::Csv) {
+                    ColumnarWriter::write_ohlcv_with_features(output_path + kColumnarExtension, *item.data,
+                                                              *item.block, item.frequency, selection, columnar);
+                }
+                if (!item.sweep.empty()) {
+                    std::vector<FastCSVWriter::NamedColumn> views;
+                    for (const auto& column : item.sweep) {
+                        views.push_back({column.name(), column.values.data(), column.values.size(), column.offset});
+                    }
+                    FastCSVWriter::write_named_columns(output_dir + "/" + item.name + "_windows.csv",
+                                                       item.data->symbol, item.data->timestamps, views, csv);
+                    ++sweep_written;
+                }
+                if (!config.publish_prefix.empty()) {
+                    SharedFeaturePublisher(shared_segment_name(config.publish_prefix, item.name))
+                        .publish(*item.data, *item.block, item.frequency, selection);
+                }
+                size_t current_count = ++written;
+                if (current_count % 100 == 0) {
+                    std::lock_guard<std::mutex> lock(log_mutex);
+                    std::cout << "  - Progress: " << current_count << "/" << expected << " written" << std::endl;
+                }
+            } catch (const std::exception& e) {
+                ++process_errors;
+                std::lock_guard<std::mutex> lock(log_mutex);
+                std::cerr << "Error writing " << output_path << ": " << e.what() << std::endl;
+            }
+            ws.busy_ms += elapsed_ms(t0);
+            ++ws.tasks;
+            item.data.reset();
+            free_blocks.push(std::move(item.block));
+            report_write_errors();
+        }
+        if (io) {
+            TraceSpan span("wait: writes in flight", "queue");
+            io->drain();
+            report_write_errors();
+        }
+    });
+
+    join_all(readers);
+    join_all(computers);
+    join_all(writers);
+    stream_memory.reset();
+
+    if (config.fit_garch && !config.garch_cache.empty()) {
+        try {
+            garch_cache.save(config.garch_cache);
+        } catch (const std::exception& e) {
+            std::cerr << "Error saving " << config.garch_cache << ": " << e.what() << std::endl;
+        }
+    }
+
+    stats.wall_ms = elapsed_ms(start);
+    stats.read.wall_ms = stats.compute.wall_ms = stats.write.wall_ms = stats.wall_ms;
+    if (!chunked.empty()) {
+        auto chunked_start = Clock::now();
+        ScopedCounters counters("stage: chunked");
+        MemoryScope memory("chunked");
+        TraceSpan span("chunked series");
+        std::vector<size_t> costs;
+        for (size_t i : chunked) costs.push_back(sizes[i]);
+        WorkStealingPool(compute_threads).run(costs, [&](size_t k, unsigned) {
+            const std::string& path = csv_files[chunked[k]];
+            TraceSpan series("chunked stock", "stock", static_cast<int64_t>(chunked[k]));
+            try {
+                ChunkedSeriesResult result = process_series_in_chunks(path, output_dir, selection, config,
+                                                                      plan.chunk_rows);
+                if (result.rows == 0) return;
+                ++files_read;
+                ++chunked_stocks;
+                data_points += result.rows;
+                if (result.sweep_written) ++sweep_written;
+                size_t current_count = ++written;
+                if (current_count % 100 == 0) {
+                    std::lock_guard<std::mutex> lock(log_mutex);
+                    std::cout << "  - Progress: " << current_count << "/" << expected << " written" << std::endl;
+                }
+            } catch (const std::exception& e) {
+                ++process_errors;
+                std::lock_guard<std::mutex> lock(log_mutex);
+                std::cerr << "Error processing " << path << " in chunks: " << e.what() << std::endl;
+            }
+        });
+        stats.chunked_ms = elapsed_ms(chunked_start);
+        stats.wall_ms += stats.chunked_ms;
+    }
+    if (config.panel) {
+        auto panel_start = Clock::now();
+        ScopedCounters counters("stage: panel");
+        MemoryScope memory("panel");
+        TraceSpan span("panel");
+        panel.compute();
+        std::atomic<size_t> panel_written{0};
+        const auto& panel_series = panel.series();
+        std::vector<size_t> lengths;
+        for (const auto& series : panel_series) lengths.push_back(series.close.size());
+        WorkStealingPool(write_threads).run(lengths, [&](size_t s, unsigned) {
+            const PanelSeries& series = panel_series[s];
+            std::vector<FastCSVWriter::NamedColumn> views;
+            for (size_t k = 0; k < series.columns.size(); ++k) {
+                views.push_back({panel.column_names()[k], series.columns[k].data(), series.columns[k].size(), series.offsets[k]});
+            }
+            const std::string path = output_dir + "/" + series.symbol + "_panel.csv";
+            try {
+                FastCSVWriter::write_named_columns(path, series.symbol, series.timestamps, views, config.csv);
+                ++panel_written;
+            } catch (const std::exception& e) {
+                ++process_errors;
+                std::lock_guard<std::mutex> lock(log_mutex);
+                std::cerr << "Error writing " << path << ": " << e.what() << std::endl;
+            }
+        });
+        stats.panel_written = panel_written;
+        stats.panel_ms = elapsed_ms(panel_start);
+        stats.wall_ms += stats.panel_ms;
+    }
+    stats.files_read = files_read;
+    stats.read_errors = read_errors;
+    stats.stocks_written = written;
+    stats.process_errors = process_errors;
+    stats.total_data_points = data_points;
+    stats.garch_fitted = garch_fitted;
+    stats.garch_cached = garch_cached;
+    stats.regimes_fitted = regimes_fitted;
+    stats.sweep_written = sweep_written;
+    stats.chunked_stocks = chunked_stocks;
+    stats.resampled_series = resampled_series;
+    stats.parsed_queue_peak = parsed.high_water();
+    stats.computed_queue_peak = computed.high_water();
+    return stats;
+}
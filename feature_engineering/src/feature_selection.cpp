@@ -0,0 +1,119 @@
+#include "feature_selection.h"
+#include <algorithm>
+#include <stdexcept>
+#include <sstream>
+
+namespace {
+struct FeatureInfo {
+    const char* name;
+    size_t row_offset;
+};
+
+const FeatureInfo kFeatureInfo[] = {
+#define FEATURE_INFO_ENTRY(name, offset) {#name, offset},
+    FEATURE_COLUMNS(FEATURE_INFO_ENTRY)
+#undef FEATURE_INFO_ENTRY
+};
+
+struct SweepInfo {
+    const char* name;
+    bool on_returns;
+};
+
+const SweepInfo kSweepInfo[] = {
+#define SWEEP_INFO_ENTRY(name, on_returns) {#name, on_returns},
+    WINDOW_SWEEP_INDICATORS(SWEEP_INFO_ENTRY)
+#undef SWEEP_INFO_ENTRY
+};
+
+std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t");
+    return s.substr(begin, end - begin + 1);
+}
+}
+
+const char* feature_name(Feature feature) {
+    return kFeatureInfo[static_cast<size_t>(feature)].name;
+}
+
+size_t feature_row_offset(Feature feature) {
+    return kFeatureInfo[static_cast<size_t>(feature)].row_offset;
+}
+
+FeatureMask parse_feature_list(const std::string& list) {
+    FeatureMask mask;
+    std::stringstream ss(list);
+    std::string token;
+    while (std::getline(ss, token, ',')) {
+        token = trim(token);
+        if (token.empty()) continue;
+        if (token == "all") {
+            mask.set();
+            continue;
+        }
+        size_t i = 0;
+        while (i < kFeatureCount && token != kFeatureInfo[i].name) ++i;
+        if (i == kFeatureCount) throw std::runtime_error("Unknown feature: " + token);
+        mask.set(i);
+    }
+    return mask;
+}
+
+std::vector<std::string> feature_names(const FeatureMask& mask) {
+    std::vector<std::string> names;
+    for (size_t i = 0; i < kFeatureCount; ++i) {
+        if (mask.test(i)) names.emplace_back(kFeatureInfo[i].name);
+    }
+    return names;
+}
+
+const char* sweep_indicator_name(SweepIndicator indicator) {
+    return kSweepInfo[static_cast<size_t>(indicator)].name;
+}
+
+bool sweep_on_returns(SweepIndicator indicator) {
+    return kSweepInfo[static_cast<size_t>(indicator)].on_returns;
+}
+
+std::vector<size_t> parse_window_list(const std::string& list) {
+    std::vector<size_t> windows;
+    std::stringstream ss(list);
+    std::string token;
+    while (std::getline(ss, token, ',')) {
+        token = trim(token);
+        if (token.empty()) continue;
+        size_t used = 0;
+        long long window = 0;
+        try {
+            window = std::stoll(token, &used);
+        } catch (const std::exception&) {
+            used = 0;
+        }
+        if (used != token.size() || window < 2) throw std::runtime_error("Invalid window length: " + token);
+        windows.push_back(static_cast<size_t>(window));
+    }
+    std::sort(windows.begin(), windows.end());
+    windows.erase(std::unique(windows.begin(), windows.end()), windows.end());
+    return windows;
+}
+
+SweepMask parse_sweep_indicators(const std::string& list) {
+    SweepMask mask;
+    std::stringstream ss(list);
+    std::string token;
+    while (std::getline(ss, token, ',')) {
+        token = trim(token);
+        if (token.empty()) continue;
+        if (token == "all") {
+            mask.set();
+            continue;
+        }
+        size_t i = 0;
+        while (i < kSweepIndicatorCount && token != kSweepInfo[i].name) ++i;
+        if (i == kSweepIndicatorCount) throw std::runtime_error("Unknown sweep indicator: " + token);
+        mask.set(i);
+    }
+    return mask;
+}
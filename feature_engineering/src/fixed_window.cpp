@@ -0,0 +1,210 @@
+#include "fixed_window.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+// body(0), body(1), ..., body(W - 1), expanded at compile time
+template <class Body, int... J>
+inline void unroll(Body& body, std::integer_sequence<int, J...>) {
+    (body(J), ...);
+}
+
+template <int W, class Body>
+inline void unroll(Body&& body) {
+    unroll(body, std::make_integer_sequence<int, W>{});
+}
+
+// A centered sum of squares below this fraction of the raw one is round-off
+// of a window whose values are all equal (as RollingMoments)
+constexpr double kFlatRatio = 1e-12;
+
+// The kernels below compute L windows at once: window k of a call covers
+// x[k .. k + W - 1]. L is kLanes in the main loop and 1 for the tail. They
+// stay out of line too, so every group of windows runs the same code
+// wherever a call starts and however its loop is unrolled.
+
+template <int W, size_t L>
+FIXED_WINDOW_KERNEL void z_score_windows(const double* x, double* out) {
+    double sum[L] = {}, squares[L] = {}, mean[L];
+    unroll<W>([&](int j) {
+        for (size_t k = 0; k < L; ++k) sum[k] += x[j + k];
+    });
+    for (size_t k = 0; k < L; ++k) mean[k] = sum[k] / W;
+    unroll<W>([&](int j) {
+        for (size_t k = 0; k < L; ++k) {
+            const double d = x[j + k] - mean[k];
+            squares[k] += d * d;
+        }
+    });
+    for (size_t k = 0; k < L; ++k) {
+        const bool flat = squares[k] <= kFlatRatio * (squares[k] + W * mean[k] * mean[k]);
+        const double std_dev = flat ? 0.0 : std::sqrt(squares[k] / (W - 1));
+        out[k] = std_dev > 0 ? (x[W - 1 + k] - mean[k]) / std_dev : 0.0;
+    }
+}
+
+template <int W, size_t L>
+FIXED_WINDOW_KERNEL void sortino_windows(const double* x, double* out) {
+    double sum[L] = {}, downside[L] = {}, count[L] = {};
+    unroll<W>([&](int j) {
+        for (size_t k = 0; k < L; ++k) {
+            const double r = x[j + k];
+            const double loss = std::min(r, 0.0);
+            sum[k] += r;
+            downside[k] += loss * loss;
+            count[k] += static_cast<double>(r < 0);
+        }
+    });
+    for (size_t k = 0; k < L; ++k) {
+        const double downside_deviation = count[k] > 0 ? std::sqrt(downside[k] / count[k]) : 0.0;
+        out[k] = downside_deviation > 0 ? (sum[k] / W) / downside_deviation : 0.0;
+    }
+}
+
+template <int W, size_t L>
+FIXED_WINDOW_KERNEL void ulcer_windows(const double* x, double* out) {
+    double peak[L], squares[L] = {};
+    for (size_t k = 0; k < L; ++k) peak[k] = x[k];
+    unroll<W>([&](int j) {
+        for (size_t k = 0; k < L; ++k) peak[k] = std::max(peak[k], x[j + k]);
+    });
+    unroll<W>([&](int j) {
+        for (size_t k = 0; k < L; ++k) {
+            const double d = x[j + k] - peak[k];
+            squares[k] += d * d;
+        }
+    });
+    // 100 * (price - peak) / peak per bar, with the scaling taken out of the sum
+    for (size_t k = 0; k < L; ++k) out[k] = peak[k] > 0 ? 100.0 * std::sqrt(squares[k] / W) / peak[k] : 0.0;
+}
+
+// Window sums of L windows of N terms, stored term-major with `stride`
+// values per term: sums[t][k] covers terms[t][k .. k + W - 1]
+template <int W, size_t N, size_t L>
+FIXED_WINDOW_KERNEL void term_window_sums(const double* terms, size_t stride, double (*sums)[L]) {
+    for (size_t t = 0; t < N; ++t) {
+        for (size_t k = 0; k < L; ++k) sums[t][k] = 0.0;
+    }
+    unroll<W>([&](int j) {
+        for (size_t t = 0; t < N; ++t) {
+            for (size_t k = 0; k < L; ++k) sums[t][k] += terms[t * stride + j + k];
+        }
+    });
+}
+
+// Every window of a contiguous series, kLanes at a time
+template <int W, class Windows, class Tail>
+size_t each_window(const double* x, size_t n, double* out, Windows windows, Tail tail) {
+    if (n < static_cast<size_t>(W)) return 0;
+    const size_t count = n - W + 1;
+    size_t i = 0;
+    for (; i + FixedWindow<W>::kLanes <= count; i += FixedWindow<W>::kLanes) windows(x + i, out + i);
+    for (; i < count; ++i) tail(x + i, out + i);
+    return count;
+}
+
+// Window sums of N per-bar terms that are not contiguous in the input.
+// term(m, values) writes the N terms of bar m, called once per bar in
+// order; they go to a stack buffer holding the current kLanes windows'
+// bars, which slides down by kLanes bars per step. emit(i, sums) gets the
+// N sums of window i (bars i .. i + W - 1).
+template <int W, size_t N, class Term, class Emit>
+size_t window_term_sums(size_t bars, Term&& term, Emit&& emit) {
+    constexpr size_t L = FixedWindow<W>::kLanes;
+    constexpr size_t kSpan = W - 1 + L;
+    if (bars < static_cast<size_t>(W)) return 0;
+    const size_t count = bars - W + 1;
+
+    double buffer[N][kSpan];
+    auto load = [&](size_t bar, size_t slot) {
+        double values[N];
+        term(bar, values);
+        for (size_t t = 0; t < N; ++t) buffer[t][slot] = values[t];
+    };
+    for (size_t m = 0; m + 1 < static_cast<size_t>(W); ++m) load(m, m);
+
+    size_t i = 0;
+    for (; i + L <= count; i += L) {
+        for (size_t k = 0; k < L; ++k) load(i + W - 1 + k, W - 1 + k);
+        double sums[N][L];
+        term_window_sums<W, N, L>(buffer[0], kSpan, sums);
+        for (size_t k = 0; k < L; ++k) {
+            double window[N];
+            for (size_t t = 0; t < N; ++t) window[t] = sums[t][k];
+            emit(i + k, window);
+        }
+        for (size_t t = 0; t < N; ++t) std::copy(buffer[t] + L, buffer[t] + kSpan, buffer[t]);
+    }
+    for (; i < count; ++i) {
+        load(i + W - 1, W - 1);
+        double sums[N][1];
+        term_window_sums<W, N, 1>(buffer[0], kSpan, sums);
+        double window[N];
+        for (size_t t = 0; t < N; ++t) window[t] = sums[t][0];
+        emit(i, window);
+        for (size_t t = 0; t < N; ++t) std::copy(buffer[t] + 1, buffer[t] + W, buffer[t]);
+    }
+    return count;
+}
+
+// Money flow of bar 1, positive or negative by its typical price against
+// bar 0's. Both prices come from this one out-of-line body, so a bar's
+// typical price rounds alike wherever a call starts.
+FIXED_WINDOW_KERNEL void money_flow_terms(const double* high, const double* low, const double* close,
+                                          const double* volume, double* flow) {
+    const double previous = (high[0] + low[0] + close[0]) / 3.0;
+    const double typical = (high[1] + low[1] + close[1]) / 3.0;
+    const double money_flow = typical * volume[1];
+    flow[0] = typical > previous ? money_flow : 0.0;
+    flow[1] = typical < previous ? money_flow : 0.0;
+}
+
+} // namespace
+
+template <int W>
+size_t FixedWindow<W>::z_score(const double* returns, size_t n, double* out) {
+    return each_window<W>(returns, n, out, z_score_windows<W, kLanes>, z_score_windows<W, 1>);
+}
+
+template <int W>
+size_t FixedWindow<W>::sortino_ratio(const double* returns, size_t n, double* out) {
+    return each_window<W>(returns, n, out, sortino_windows<W, kLanes>, sortino_windows<W, 1>);
+}
+
+template <int W>
+size_t FixedWindow<W>::ulcer_index(const double* prices, size_t n, double* out) {
+    return each_window<W>(prices, n, out, ulcer_windows<W, kLanes>, ulcer_windows<W, 1>);
+}
+
+template <int W>
+size_t FixedWindow<W>::money_flow_index(const double* high, const double* low, const double* close,
+                                        const double* volume, size_t n, double* out) {
+    if (n < 2) return 0;
+    return window_term_sums<W, 2>(n - 1, [&](size_t m, double* flow) {
+        money_flow_terms(high + m, low + m, close + m, volume + m, flow);
+    }, [&](size_t i, const double* flow) {
+        out[i] = (flow[0] + flow[1]) > 0 ? 100.0 - (100.0 / (1.0 + flow[0] / flow[1])) : 50.0;
+    });
+}
+
+template <int W>
+size_t FixedWindow<W>::vortex_indicator(const double* high, const double* low, const double* close,
+                                        size_t n, double* out) {
+    if (n < 2) return 0;
+    // Term m is bar m + 1's upward vortex movement and true range
+    return window_term_sums<W, 2>(n - 1, [&](size_t m, double* terms) {
+        terms[0] = std::abs(high[m + 1] - low[m]);
+        terms[1] = std::max({high[m + 1] - low[m + 1],
+                             std::abs(high[m + 1] - close[m]),
+                             std::abs(low[m + 1] - close[m])});
+    }, [&](size_t i, const double* sums) {
+        out[i] = sums[1] > 0 ? sums[0] / sums[1] : 0.0;
+    });
+}
+
+// The windows of the fixed-period columns
+template struct FixedWindow<14>;
+template struct FixedWindow<20>;
+template struct FixedWindow<30>;
@@ -0,0 +1,273 @@
+#include "fusion_plan.h"
+#include "fixed_window.h"
+#include "rolling_moments.h"
+#include "rolling_statistics.h"
+#include "simd_dispatch.h"
+#include "technical_indicators.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+
+namespace {
+
+constexpr size_t kPeriod = 14;               // vortex, ADX and MFI period
+constexpr size_t kBarWindow = kPeriod + 1;   // bars behind one of their values
+
+// Values a column can emit once `end` of its chain's `total` inputs exist:
+// every window that ends before `end`, cut down to a multiple of `cut`
+// until the last block
+size_t ready(size_t end, size_t total, size_t window, size_t cut) {
+    if (end < window) return 0;
+    const size_t windows = end - window + 1;
+    return end == total ? windows : windows - windows % cut;
+}
+
+// Rows [first, first + count) of a column through kernel(out); a Float32
+// block takes them through a double scratch span and narrows, as
+// FeatureBlock::assign
+template <class Kernel>
+void write_rows(FeatureBlock& block, Feature feature, size_t first, size_t count, Kernel&& kernel) {
+    if (block.precision() == FeaturePrecision::Float64) {
+        kernel(block.column(feature) + first);
+        return;
+    }
+    thread_local std::vector<double> scratch;
+    scratch.resize(count);
+    kernel(scratch.data());
+    float* out = block.column_f32(feature) + first;
+    for (size_t i = 0; i < count; ++i) out[i] = static_cast<float>(scratch[i]);
+}
+
+// A fused column of the returns chain and the next value it writes
+struct Cursor {
+    Feature feature;
+    size_t window;
+    size_t cut;
+    size_t next;
+};
+
+// Per-bar terms of the bar chain (term m pairs bar m + 1 with bar m), from
+// the oldest term a pending window still needs
+struct BarTerms {
+    std::vector<double> true_range, vortex_plus, dm_plus, dm_minus, flow_plus, flow_minus;
+    std::vector<double> typical;     // the previous block's last typical price, then this block's
+    std::vector<double> sums[4];
+
+    void resize(size_t capacity) {
+        for (auto* terms : {&true_range, &vortex_plus, &dm_plus, &dm_minus, &flow_plus, &flow_minus}) terms->resize(capacity);
+        for (auto& s : sums) s.resize(capacity);
+        typical.resize(FusionPlan::kBlockRows + 1);
+    }
+
+    // Moves terms [from, from + count) of each kept array to its front
+    void slide(size_t from, size_t count) {
+        for (auto* terms : {&true_range, &vortex_plus, &dm_plus, &dm_minus, &flow_plus, &flow_minus}) {
+            std::memmove(terms->data(), terms->data() + from, count * sizeof(double));
+        }
+    }
+};
+
+} // namespace
+
+FusionPlan::FusionPlan(const FeatureMask& selection, ComputeBackend backend) {
+    if (backend == ComputeBackend::NEON) return;
+    if (backend == ComputeBackend::AVX2) {
+        // As SIMDTechnicalIndicators: the scalar tier runs the reference kernels
+        const SimdKernels& kernels = simd_kernels();
+        if (kernels.tier != SimdTier::Scalar) kernels_ = &kernels;
+    }
+
+    // A chain runs fused once two of its columns share the pass
+    auto claim = [&](std::initializer_list<Feature> chain) {
+        FeatureMask claimed;
+        for (Feature feature : chain) {
+            if (is_selected(selection, feature)) claimed.set(static_cast<size_t>(feature));
+        }
+        if (claimed.count() < 2) return false;
+        columns_ |= claimed;
+        return true;
+    };
+    const bool volatility_shared = is_selected(selection, Feature::volatility_x_rsi_interaction_14);
+    returns_chain_ = volatility_shared
+        ? claim({Feature::returns, Feature::z_score_20, Feature::sortino_ratio_30})
+        : claim({Feature::returns, Feature::volatility, Feature::z_score_20, Feature::sortino_ratio_30});
+    bar_chain_ = claim({Feature::vortex_indicator_14, Feature::adx_rating_14, Feature::money_flow_index_14});
+}
+
+void FusionPlan::run(const double* high, const double* low, const double* close, const double* volume, size_t n,
+                     FeatureBlock& block, std::vector<double>& returns) const {
+    returns.clear();
+    if (returns_chain_) run_returns_chain(close, n, block, returns);
+    if (bar_chain_) run_bar_chain(high, low, close, volume, n, block);
+}
+
+void FusionPlan::run_returns_chain(const double* close, size_t n, FeatureBlock& block, std::vector<double>& returns) const {
+    if (n < 2) return;
+    const size_t total = n - 1;
+    returns.resize(total);
+    double* r = returns.data();
+
+    Cursor columns[] = {
+        {Feature::returns, 1, 1, 0},
+        {Feature::volatility, 20, kernels_ ? RollingStatistics::kBlockRows : 1, 0},
+        {Feature::z_score_20, 20, FixedWindow<20>::kLanes, 0},
+        {Feature::sortino_ratio_30, 30, FixedWindow<30>::kLanes, 0},
+    };
+    // Volatility on the reference kernels: calculate_rolling_volatility's
+    // push_stddev kernel, its moments carried from block to block
+    RollingMoments moments(20);
+    size_t pushed = 0;
+
+    for (size_t start = 0; start < total; start += kBlockRows) {
+        const size_t end = std::min(start + kBlockRows, total);
+        if (kernels_) {
+            kernels_->subtract(close + start + 1, close + start, r + start, end - start);
+            kernels_->divide(r + start, close + start, r + start, end - start);
+        } else {
+            TechnicalIndicators::calculate_returns(close + start, end - start + 1, r + start);
+        }
+
+        for (Cursor& column : columns) {
+            if (!fuses(column.feature)) continue;
+            const size_t last = ready(end, total, column.window, column.cut);
+            if (last <= column.next) continue;
+            const size_t first = column.next, count = last - first;
+            const size_t span = count + column.window - 1;   // returns behind the new values
+            write_rows(block, column.feature, first, count, [&](double* out) {
+                switch (column.feature) {
+                case Feature::returns:
+                    std::copy(r + first, r + last, out);
+                    break;
+                case Feature::volatility:
+                    if (kernels_) {
+                        RollingStatistics::stddev(r + first, span, column.window, out);
+                        break;
+                    }
+                    // The returns not pushed yet complete rows first .. last - 1
+                    moments.push_stddev(r + pushed, first + span - pushed, out);
+                    pushed = first + span;
+                    break;
+                case Feature::z_score_20:
+                    FixedWindow<20>::z_score(r + first, span, out);
+                    break;
+                case Feature::sortino_ratio_30:
+                    FixedWindow<30>::sortino_ratio(r + first, span, out);
+                    break;
+                default:
+                    break;
+                }
+            });
+            column.next = last;
+        }
+    }
+    for (const Cursor& column : columns) {
+        if (fuses(column.feature)) block.set_length(column.feature, column.next);
+    }
+}
+
+void FusionPlan::run_bar_chain(const double* high, const double* low, const double* close, const double* volume,
+                               size_t n, FeatureBlock& block) const {
+    const bool vortex = fuses(Feature::vortex_indicator_14);
+    const bool adx = fuses(Feature::adx_rating_14);
+    const bool mfi = fuses(Feature::money_flow_index_14);
+    // Window sums and per-bar kernels cut at their SIMD lanes, the reference
+    // kernels at their FixedWindow groups
+    const size_t cut = kernels_ ? kernels_->lanes : FixedWindow<kPeriod>::kLanes;
+
+    thread_local BarTerms terms;
+    if (kernels_) terms.resize(kBlockRows + kPeriod + cut);
+    size_t base = 0;   // term held at index 0
+    size_t next = 0;   // next value of every column
+
+    for (size_t start = 0; start < n; start += kBlockRows) {
+        const size_t end = std::min(start + kBlockRows, n);
+        const size_t last = ready(end, n, kBarWindow, cut);
+
+        if (kernels_ && end > 1) {
+            // Terms whose bars both lie in [0, end), after the ones still needed
+            const size_t t0 = start == 0 ? 0 : start - 1, t1 = end - 1;
+            const size_t kept = t0 - next;
+            terms.slide(next - base, kept);
+            base = next;
+            if (vortex || adx) kernels_->true_range(high + t0 + 1, low + t0 + 1, close + t0, terms.true_range.data() + kept, t1 - t0);
+            if (vortex) kernels_->abs_diff(high + t0 + 1, low + t0, terms.vortex_plus.data() + kept, t1 - t0);
+            if (adx) {
+                kernels_->directional_movement(high + t0 + 1, high + t0, low + t0 + 1, low + t0,
+                                               terms.dm_plus.data() + kept, terms.dm_minus.data() + kept, t1 - t0);
+            }
+            if (mfi) {
+                // Typical prices of this block's bars, over the same rows as one call over the series
+                double* typical = terms.typical.data();
+                kernels_->typical_price(high + start, low + start, close + start, typical + 1, end - start);
+                const double* pair = start == 0 ? typical + 1 : typical;   // typical price of bar t0
+                kernels_->money_flows(pair + 1, pair, volume + t0 + 1,
+                                      terms.flow_plus.data() + kept, terms.flow_minus.data() + kept, t1 - t0);
+                typical[0] = typical[end - start];
+            }
+        }
+        if (last <= next) continue;
+
+        const size_t count = last - next;
+        if (!kernels_) {
+            // The reference kernels read the bars directly
+            const size_t bars = count + kPeriod;
+            if (vortex) {
+                write_rows(block, Feature::vortex_indicator_14, next, count, [&](double* out) {
+                    FixedWindow<kPeriod>::vortex_indicator(high + next, low + next, close + next, bars, out);
+                });
+            }
+            if (adx) {
+                write_rows(block, Feature::adx_rating_14, next, count, [&](double* out) {
+                    TechnicalIndicators::adx_rating_14(high + next, low + next, close + next, bars, out);
+                });
+            }
+            if (mfi) {
+                write_rows(block, Feature::money_flow_index_14, next, count, [&](double* out) {
+                    FixedWindow<kPeriod>::money_flow_index(high + next, low + next, close + next, volume + next, bars, out);
+                });
+            }
+            next = last;
+            continue;
+        }
+
+        // Window sums of the terms, then the SIMDTechnicalIndicators formulas
+        const size_t span = count + kPeriod - 1;
+        double* tr_sum = terms.sums[0].data();
+        double* first_sum = terms.sums[1].data();
+        double* second_sum = terms.sums[2].data();
+        if (vortex || adx) kernels_->window_sums(terms.true_range.data(), span, kPeriod, tr_sum);
+        if (vortex) {
+            kernels_->window_sums(terms.vortex_plus.data(), span, kPeriod, first_sum);
+            write_rows(block, Feature::vortex_indicator_14, next, count, [&](double* out) {
+                for (size_t k = 0; k < count; ++k) out[k] = tr_sum[k] > 0 ? first_sum[k] / tr_sum[k] : 0.0;
+            });
+        }
+        if (adx) {
+            kernels_->window_sums(terms.dm_plus.data(), span, kPeriod, first_sum);
+            kernels_->window_sums(terms.dm_minus.data(), span, kPeriod, second_sum);
+            write_rows(block, Feature::adx_rating_14, next, count, [&](double* out) {
+                for (size_t k = 0; k < count; ++k) {
+                    const double di_plus = tr_sum[k] > 0 ? 100.0 * first_sum[k] / tr_sum[k] : 0.0;
+                    const double di_minus = tr_sum[k] > 0 ? 100.0 * second_sum[k] / tr_sum[k] : 0.0;
+                    out[k] = (di_plus + di_minus) > 0 ? 100.0 * std::abs(di_plus - di_minus) / (di_plus + di_minus) : 0.0;
+                }
+            });
+        }
+        if (mfi) {
+            double* positive_sum = terms.sums[3].data();
+            kernels_->window_sums(terms.flow_plus.data(), span, kPeriod, positive_sum);
+            kernels_->window_sums(terms.flow_minus.data(), span, kPeriod, second_sum);
+            write_rows(block, Feature::money_flow_index_14, next, count, [&](double* out) {
+                for (size_t k = 0; k < count; ++k) {
+                    const double pos = positive_sum[k], neg = second_sum[k];
+                    out[k] = (pos + neg) > 0 ? 100.0 - (100.0 / (1.0 + pos / neg)) : 50.0;
+                }
+            });
+        }
+        next = last;
+    }
+    if (vortex) block.set_length(Feature::vortex_indicator_14, next);
+    if (adx) block.set_length(Feature::adx_rating_14, next);
+    if (mfi) block.set_length(Feature::money_flow_index_14, next);
+}
@@ -0,0 +1,170 @@
+#include "garch_model.h"
+#include "machine_profile.h"
+#include "simd_dispatch.h"
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+struct Candidate {
+    double alpha;
+    double beta;
+};
+
+// Keeps alpha + beta away from the integrated (unit root) boundary
+constexpr double kMaxPersistence = 0.999;
+
+// Grid of alpha x beta points inside the stationary region
+std::vector<Candidate> make_grid(double alpha_lo, double alpha_hi, double beta_lo, double beta_hi, size_t steps) {
+    std::vector<Candidate> grid;
+    grid.reserve(steps * steps);
+    for (size_t i = 0; i < steps; ++i) {
+        const double alpha = alpha_lo + (alpha_hi - alpha_lo) * i / (steps - 1);
+        if (alpha <= 0) continue;
+        for (size_t j = 0; j < steps; ++j) {
+            const double beta = beta_lo + (beta_hi - beta_lo) * j / (steps - 1);
+            if (beta < 0 || alpha + beta >= kMaxPersistence) continue;
+            grid.push_back({alpha, beta});
+        }
+    }
+    return grid;
+}
+
+// Highest-likelihood candidate of the grid, evaluated `lanes` at a time. With
+// alpha + beta < 1 every h_t is at least 1 - alpha - beta, so the block
+// products stay positive and finite.
+Candidate best_candidate(const std::vector<double>& z2, const std::vector<Candidate>& grid, Candidate fallback) {
+    const SimdKernels& kernels = simd_kernels();
+    const size_t lanes = kernels.lanes, block = SimdKernels::garch_likelihood_block;
+    const size_t blocks = (z2.size() + block - 1) / block;
+    std::vector<double> alpha(lanes), beta(lanes), weighted(lanes), products(blocks * lanes);
+
+    Candidate best = fallback;
+    double best_ll = -std::numeric_limits<double>::infinity();
+    for (size_t g = 0; g < grid.size(); g += lanes) {
+        // A short last group repeats its final candidate
+        for (size_t l = 0; l < lanes; ++l) {
+            const Candidate& c = grid[std::min(g + l, grid.size() - 1)];
+            alpha[l] = c.alpha;
+            beta[l] = c.beta;
+        }
+        kernels.garch_likelihood_lanes(z2.data(), z2.size(), alpha.data(), beta.data(), weighted.data(), products.data());
+        for (size_t l = 0; l < lanes && g + l < grid.size(); ++l) {
+            double log_sum = 0.0;
+            for (size_t b = 0; b < blocks; ++b) log_sum += std::log(products[b * lanes + l]);
+            const double ll = -0.5 * (log_sum + weighted[l]);
+            if (ll > best_ll) {
+                best_ll = ll;
+                best = grid[g + l];
+            }
+        }
+    }
+    return best;
+}
+
+}
+
+GarchParams GarchModel::default_params(const double* returns, size_t n) {
+    const size_t warmup = std::min(n, kWarmup);
+    double squares = 0.0;
+    for (size_t i = 0; i < warmup; ++i) squares += returns[i] * returns[i];
+    const double variance = warmup > 0 ? squares / warmup : 0.0;
+    return {(1.0 - kDefaultAlpha - kDefaultBeta) * variance, kDefaultAlpha, kDefaultBeta};
+}
+
+size_t GarchModel::filtered_volatility(const double* returns, size_t n, const GarchParams& params, double* out) {
+    if (n < kWarmup) return 0;
+    double variance = 0.0;
+    for (size_t i = 0; i < kWarmup; ++i) variance += returns[i] * returns[i];
+    variance /= kWarmup;
+    out[0] = std::sqrt(variance);
+    for (size_t t = kWarmup; t < n; ++t) {
+        variance = params.omega + params.alpha * returns[t] * returns[t] + params.beta * variance;
+        out[t - kWarmup + 1] = std::sqrt(std::max(0.0, variance));
+    }
+    return n - kWarmup + 1;
+}
+
+GarchParams GarchModel::fit(const std::vector<double>& returns) {
+    const GarchParams fallback = default_params(returns.data(), returns.size());
+    if (returns.size() < kMinFitReturns) return fallback;
+
+    // Standardize so the unconditional variance is 1 (variance targeting);
+    // omega is then 1 - alpha - beta and only (alpha, beta) is searched
+    double squares = 0.0;
+    for (double r : returns) squares += r * r;
+    const double variance = squares / returns.size();
+    if (!(variance > 0)) return fallback;
+    std::vector<double> z2(returns.size());
+    for (size_t i = 0; i < returns.size(); ++i) z2[i] = returns[i] * returns[i] / variance;
+
+    const Candidate start{kDefaultAlpha, kDefaultBeta};
+    const Candidate coarse = best_candidate(z2, make_grid(0.01, 0.31, 0.50, 0.98, 16), start);
+    // Refine within one coarse step either side
+    const double alpha_step = 0.30 / 15, beta_step = 0.48 / 15;
+    const Candidate fine = best_candidate(z2, make_grid(coarse.alpha - alpha_step, coarse.alpha + alpha_step,
+                                                        coarse.beta - beta_step, coarse.beta + beta_step, 9),
+                                          coarse);
+    return {(1.0 - fine.alpha - fine.beta) * variance, fine.alpha, fine.beta};
+}
+
+std::vector<GarchParams> GarchModel::fit_batch(const std::vector<std::vector<double>>& returns) {
+    std::vector<GarchParams> params(returns.size());
+    std::vector<size_t> lengths;
+    for (const auto& series : returns) lengths.push_back(series.size());
+    WorkStealingPool pool(tuned_threads());
+    pool.run(lengths, [&](size_t i, unsigned) { params[i] = fit(returns[i]); });
+    return params;
+}
+
+void GarchParamCache::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream fields(line);
+        std::string symbol;
+        Entry entry{};
+        if (fields >> symbol >> entry.rows >> entry.params.omega >> entry.params.alpha >> entry.params.beta) {
+            entries_[symbol] = entry;
+        }
+    }
+}
+
+void GarchParamCache::save(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) throw std::runtime_error("Cannot create file: " + path);
+    std::lock_guard<std::mutex> lock(mutex_);
+    file << "symbol,rows,omega,alpha,beta\n";
+    file.precision(17);
+    for (const auto& [symbol, entry] : entries_) {
+        file << symbol << ',' << entry.rows << ',' << entry.params.omega << ','
+             << entry.params.alpha << ',' << entry.params.beta << '\n';
+    }
+    if (!file) throw std::runtime_error("Error writing GARCH parameter cache: " + path);
+}
+
+bool GarchParamCache::find(const std::string& symbol, size_t rows, GarchParams& params) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(symbol);
+    if (it == entries_.end() || it->second.rows != rows) return false;
+    params = it->second.params;
+    return true;
+}
+
+void GarchParamCache::store(const std::string& symbol, size_t rows, const GarchParams& params) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[symbol] = {rows, params};
+}
+
+size_t GarchParamCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
@@ -0,0 +1,236 @@
+#include "hardware_counters.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <cstring>
+#endif
+#endif
+
+namespace {
+
+std::atomic<bool> counters_enabled{false};
+
+struct Report {
+    std::mutex mutex;
+    std::vector<CounterRecord> records;
+};
+
+Report& report() {
+    static Report instance;
+    return instance;
+}
+
+uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+#ifdef __linux__
+// Raw code of a packed floating-point instruction event, 0 if unknown
+uint64_t vector_event_code() {
+    if (const char* code = std::getenv("MFT_PERF_VECTOR_EVENT")) {
+        return std::strtoull(code, nullptr, 16);
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    // Intel FP_ARITH_INST_RETIRED (event 0xC7), every packed 128/256/512-bit
+    // single and double umask (0xFC); AMD and others need the override
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid(0, &eax, &ebx, &ecx, &edx)) {
+        char vendor[13] = {};
+        std::memcpy(vendor, &ebx, 4);
+        std::memcpy(vendor + 4, &edx, 4);
+        std::memcpy(vendor + 8, &ecx, 4);
+        if (std::strcmp(vendor, "GenuineIntel") == 0) return 0xFCC7;
+    }
+#endif
+    return 0;
+}
+
+int open_counter(uint32_t type, uint64_t config, bool inherit) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = inherit ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+// Count scaled by the share of time the counter was scheduled
+uint64_t read_counter(int fd) {
+    if (fd < 0) return 0;
+    uint64_t values[3] = {};
+    if (::read(fd, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)) || values[2] == 0) return 0;
+    return values[2] == values[1] ? values[0]
+                                  : static_cast<uint64_t>(static_cast<double>(values[0]) * values[1] / values[2]);
+}
+#endif
+
+}
+
+CounterValues& CounterValues::operator+=(const CounterValues& other) {
+    cycles += other.cycles;
+    instructions += other.instructions;
+    cache_misses += other.cache_misses;
+    branch_misses += other.branch_misses;
+    vector_instructions += other.vector_instructions;
+    wall_ms += other.wall_ms;
+    return *this;
+}
+
+CounterValues CounterValues::operator-(const CounterValues& other) const {
+    auto minus = [](uint64_t a, uint64_t b) { return a > b ? a - b : 0; };
+    CounterValues result;
+    result.cycles = minus(cycles, other.cycles);
+    result.instructions = minus(instructions, other.instructions);
+    result.cache_misses = minus(cache_misses, other.cache_misses);
+    result.branch_misses = minus(branch_misses, other.branch_misses);
+    result.vector_instructions = minus(vector_instructions, other.vector_instructions);
+    result.wall_ms = std::max(0.0, wall_ms - other.wall_ms);
+    return result;
+}
+
+HardwareCounters::HardwareCounters(bool include_new_threads) {
+    std::fill(fds_, fds_ + kCounters, -1);
+#ifdef __linux__
+    fds_[0] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, include_new_threads);
+    fds_[1] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, include_new_threads);
+    fds_[2] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, include_new_threads);
+    fds_[3] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, include_new_threads);
+    static const uint64_t vector_code = vector_event_code();
+    if (vector_code) fds_[4] = open_counter(PERF_TYPE_RAW, vector_code, include_new_threads);
+#else
+    (void)include_new_threads;
+#endif
+}
+
+HardwareCounters::~HardwareCounters() {
+#ifdef __linux__
+    for (int fd : fds_) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+void HardwareCounters::start() {
+#ifdef __linux__
+    for (int fd : fds_) {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+    start_ns_ = now_ns();
+}
+
+CounterValues HardwareCounters::read() const {
+    CounterValues values;
+#ifdef __linux__
+    values.cycles = read_counter(fds_[0]);
+    values.instructions = read_counter(fds_[1]);
+    values.cache_misses = read_counter(fds_[2]);
+    values.branch_misses = read_counter(fds_[3]);
+    values.vector_instructions = read_counter(fds_[4]);
+#endif
+    values.wall_ms = static_cast<double>(now_ns() - start_ns_) / 1e6;
+    return values;
+}
+
+bool HardwareCounters::supported() {
+    static const bool usable = HardwareCounters(false).valid();
+    return usable;
+}
+
+bool HardwareCounters::vector_event_supported() {
+#ifdef __linux__
+    static const bool usable = HardwareCounters(false).fds_[4] >= 0;
+    return usable;
+#else
+    return false;
+#endif
+}
+
+void set_hardware_counters(bool enabled) {
+    counters_enabled = enabled;
+}
+
+bool hardware_counters_enabled() {
+    return counters_enabled;
+}
+
+void record_counters(const std::string& label, const CounterValues& values) {
+    Report& r = report();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto it = std::find_if(r.records.begin(), r.records.end(),
+                           [&](const CounterRecord& record) { return record.label == label; });
+    if (it == r.records.end()) {
+        r.records.push_back({label, values, 1});
+    } else {
+        it->values += values;
+        ++it->samples;
+    }
+}
+
+std::vector<CounterRecord> counter_report() {
+    Report& r = report();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return r.records;
+}
+
+void reset_counter_report() {
+    Report& r = report();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.records.clear();
+}
+
+void print_counter_report(const char* title) {
+    const auto records = counter_report();
+    std::cout << title << " Hardware Counters:" << std::endl;
+    if (records.empty()) {
+        std::cout << "  - none recorded" << (HardwareCounters::supported() ? "" : " (perf_event unavailable)")
+                  << std::endl;
+        return;
+    }
+    for (const auto& record : records) {
+        const CounterValues& v = record.values;
+        std::cout << "  - " << record.label << " (" << record.samples << "x, " << std::fixed
+                  << std::setprecision(1) << v.wall_ms << " ms): "
+                  << std::setprecision(3) << v.cycles / 1e9 << " Gcycles, "
+                  << v.instructions / 1e9 << " Ginstr, IPC " << std::setprecision(2) << v.ipc()
+                  << ", LLC MPKI " << v.misses_per_kilo_instruction()
+                  << ", branch misses " << v.branch_misses;
+        if (HardwareCounters::vector_event_supported()) {
+            std::cout << ", vector instr " << std::setprecision(3) << v.vector_instructions / 1e9 << " G";
+        }
+        std::cout << std::endl;
+    }
+}
+
+ScopedCounters::ScopedCounters(std::string label) : label_(std::move(label)) {
+    if (!hardware_counters_enabled()) return;
+    counters_ = std::make_unique<HardwareCounters>(true);
+    if (counters_->valid()) {
+        counters_->start();
+    } else {
+        counters_.reset();
+    }
+}
+
+ScopedCounters::~ScopedCounters() {
+    if (counters_) record_counters(label_, counters_->read());
+}
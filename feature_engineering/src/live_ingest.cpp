@@ -0,0 +1,312 @@
+#include "live_ingest.h"
+#include "numa_topology.h"
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// Empty polls a consumer spins through before it starts yielding the CPU
+constexpr unsigned kSpinPolls = 4096;
+
+int64_t floor_multiple(int64_t t, int64_t step) {
+    const int64_t q = t / step;
+    return (q * step > t ? q - 1 : q) * step;
+}
+
+}
+
+struct LiveIngestEngine::SymbolState {
+    SymbolState(std::string name, uint32_t id, int64_t bar_ns) : symbol(std::move(name)), id(id), builder(bar_ns) {}
+
+    std::string symbol;
+    uint32_t id;
+    BarBuilder builder;
+    StreamingFeatureEngine engine;
+    LiveMicrostructure microstructure;
+    uint64_t bars = 0;
+};
+
+struct LiveIngestEngine::Shard {
+    Shard(const LiveIngestConfig& config) {
+        if (config.single_producer) spsc = std::make_unique<SpscRing<MarketTick>>(config.ring_capacity);
+        else mpsc = std::make_unique<MpscRing<MarketTick>>(config.ring_capacity);
+    }
+
+    bool push(const MarketTick& tick) { return spsc ? spsc->try_push(tick) : mpsc->try_push(tick); }
+    bool pop(MarketTick& tick) { return spsc ? spsc->try_pop(tick) : mpsc->try_pop(tick); }
+
+    std::unique_ptr<SpscRing<MarketTick>> spsc;
+    std::unique_ptr<MpscRing<MarketTick>> mpsc;
+    LatencyHistogram latency;
+    std::atomic<uint64_t> consumed{0};
+    std::atomic<uint64_t> bars{0};
+    FeatureSet drained;             // the published bar's values, reused
+};
+
+uint64_t live_clock_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void LiveBar::append_to(OHLCVData& data) const {
+    data.timestamps.push_back(std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(start_ns))));
+    data.open.push_back(open);
+    data.high.push_back(high);
+    data.low.push_back(low);
+    data.close.push_back(close);
+    data.volume.push_back(volume);
+}
+
+BarBuilder::BarBuilder(int64_t bar_ns) : bar_ns_(std::max<int64_t>(1, bar_ns)) {}
+
+bool BarBuilder::add(const MarketTick& tick, LiveBar& completed) {
+    const int64_t start = floor_multiple(tick.time_ns, bar_ns_);
+    bool done = false;
+    // A late tick (start before the open bar's) counts towards the open bar
+    if (!open_ || start > bar_.start_ns) {
+        if (open_ && bar_.trades > 0) {
+            finish(completed);
+            done = true;
+        }
+        bar_ = LiveBar{};
+        bar_.start_ns = start;
+        open_ = true;
+        spread_sum_ = 0.0;
+        quotes_ = 0;
+        effective_weighted_ = effective_volume_ = 0.0;
+    }
+
+    if (tick.kind == TickKind::Quote) {
+        bid_ = tick.bid;
+        ask_ = tick.ask;
+        quoted_ = true;
+        spread_sum_ += tick.ask - tick.bid;
+        ++quotes_;
+        return done;
+    }
+
+    if (bar_.trades == 0) {
+        bar_.open = bar_.high = bar_.low = tick.price;
+    } else {
+        bar_.high = std::max(bar_.high, tick.price);
+        bar_.low = std::min(bar_.low, tick.price);
+    }
+    bar_.close = tick.price;
+    bar_.volume += tick.size;
+    ++bar_.trades;
+
+    if (traded_ && tick.price != last_price_) direction_ = tick.price > last_price_ ? 1 : -1;
+    if (direction_ > 0) bar_.uptick_volume += tick.size;
+    else if (direction_ < 0) bar_.downtick_volume += tick.size;
+    last_price_ = tick.price;
+    traded_ = true;
+
+    if (quoted_) {
+        const double mid = 0.5 * (bid_ + ask_);
+        if (mid > 0.0) {
+            effective_weighted_ += tick.size * 2.0 * std::abs(tick.price - mid) / mid;
+            effective_volume_ += tick.size;
+        }
+    }
+    return done;
+}
+
+bool BarBuilder::flush(LiveBar& completed) {
+    if (!open_ || bar_.trades == 0) return false;
+    finish(completed);
+    open_ = false;
+    return true;
+}
+
+void BarBuilder::finish(LiveBar& completed) {
+    completed = bar_;
+    if (quotes_ > 0) completed.spread = spread_sum_ / static_cast<double>(quotes_);
+    else completed.spread = quoted_ ? ask_ - bid_ : kNaN;
+    completed.effective_spread = effective_volume_ > 0.0 ? effective_weighted_ / effective_volume_ : kNaN;
+}
+
+LiveMicrostructure::LiveMicrostructure()
+    : imbalance_(5), spread_(10), effective_spread_(5), latest_{kNaN, kNaN, kNaN} {}
+
+void LiveMicrostructure::on_bar(const LiveBar& bar) {
+    const double total = bar.uptick_volume + bar.downtick_volume;
+    imbalance_.push(total > 0.0 ? (bar.uptick_volume - bar.downtick_volume) / total : 0.0);
+    if (!std::isnan(bar.spread)) spread_.push(bar.spread);
+    if (!std::isnan(bar.effective_spread)) effective_spread_.push(bar.effective_spread);
+
+    latest_.order_flow_imbalance_5 = imbalance_.full() ? imbalance_.mean() : kNaN;
+    latest_.bid_ask_spread_volatility_10 = spread_.full() ? std::sqrt(spread_.sample_variance()) : kNaN;
+    latest_.effective_spread_5_min_avg = effective_spread_.full() ? effective_spread_.mean() : kNaN;
+}
+
+size_t LatencyHistogram::bucket_of(uint64_t ns) {
+    if (ns < 4) return static_cast<size_t>(ns);
+    unsigned exponent = 0;
+    for (uint64_t v = ns; v > 1; v >>= 1) ++exponent;
+    const size_t sub = static_cast<size_t>((ns >> (exponent - 2)) & 3);
+    return 4 * (exponent - 1) + sub;
+}
+
+uint64_t LatencyHistogram::bucket_upper_ns(size_t bucket) {
+    if (bucket < 4) return bucket + 1;
+    const unsigned shift = static_cast<unsigned>(bucket / 4 - 1);
+    const uint64_t top = 5 + bucket % 4;
+    return shift >= 61 && top == 8 ? std::numeric_limits<uint64_t>::max() : top << shift;
+}
+
+void LatencyHistogram::record(uint64_t ns) {
+    // Single writer: plain load and store, no read-modify-write
+    auto& count = counts_[bucket_of(ns)];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (ns > max_ns_.load(std::memory_order_relaxed)) max_ns_.store(ns, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::merge_into(Summary& summary) const {
+    for (size_t b = 0; b < kBuckets; ++b) summary.buckets[b] += counts_[b].load(std::memory_order_relaxed);
+    summary.max_us = std::max(summary.max_us, max_ns_.load(std::memory_order_relaxed) / 1000.0);
+}
+
+void LatencyHistogram::finish(Summary& summary) {
+    summary.count = 0;
+    for (uint64_t n : summary.buckets) summary.count += n;
+    if (summary.count == 0) return;
+    auto percentile = [&](double q) {
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * summary.count)));
+        uint64_t seen = 0;
+        for (size_t b = 0; b < kBuckets; ++b) {
+            seen += summary.buckets[b];
+            if (seen >= rank) return std::min(bucket_upper_ns(b) / 1000.0, summary.max_us);
+        }
+        return summary.max_us;
+    };
+    summary.p50_us = percentile(0.50);
+    summary.p90_us = percentile(0.90);
+    summary.p99_us = percentile(0.99);
+    summary.p999_us = percentile(0.999);
+}
+
+LiveIngestEngine::LiveIngestEngine(const LiveIngestConfig& config, LivePublish publish)
+    : config_(config), publish_(std::move(publish)) {
+    config_.shards = std::max(1u, config_.shards);
+    for (unsigned s = 0; s < config_.shards; ++s) shards_.push_back(std::make_unique<Shard>(config_));
+}
+
+LiveIngestEngine::~LiveIngestEngine() {
+    stop();
+}
+
+uint32_t LiveIngestEngine::add_symbol(const std::string& symbol) {
+    if (running_.load()) throw std::runtime_error("Cannot add symbol " + symbol + " to a running ingest engine");
+    const auto id = static_cast<uint32_t>(symbols_.size());
+    symbols_.push_back(std::make_unique<SymbolState>(symbol, id, config_.bar_ns));
+    return id;
+}
+
+void LiveIngestEngine::start() {
+    if (running_.exchange(true)) return;
+    for (unsigned s = 0; s < shards_.size(); ++s) {
+        consumers_.emplace_back([this, s] { consume(*shards_[s], s); });
+    }
+}
+
+bool LiveIngestEngine::submit(MarketTick tick) {
+    if (tick.symbol >= symbols_.size()) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    tick.arrival_ns = live_clock_ns();
+    if (shards_[tick.symbol % shards_.size()]->push(tick)) return true;
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void LiveIngestEngine::stop() {
+    if (!running_.exchange(false)) return;
+    for (auto& consumer : consumers_) consumer.join();
+    consumers_.clear();
+}
+
+unsigned LiveIngestEngine::consumer_cpu(unsigned shard) const {
+    if (!config_.consumer_cpus.empty()) return config_.consumer_cpus[shard % config_.consumer_cpus.size()];
+    const NumaTopology& topology = NumaTopology::system();
+    const auto shards = static_cast<unsigned>(shards_.size());
+    const unsigned node = numa_node_of_worker(shard, shards);
+    unsigned first = shard;
+    while (first > 0 && numa_node_of_worker(first - 1, shards) == node) --first;
+    const auto& cpus = topology.node_cpus[std::min<size_t>(node, topology.nodes() - 1)];
+    return cpus[(shard - first) % cpus.size()];
+}
+
+void LiveIngestEngine::consume(Shard& shard, unsigned index) {
+    if (config_.pin_consumers) pin_thread_to_cpu(consumer_cpu(index));
+    set_trace_thread_name("live: shard #" + std::to_string(index));
+
+    MarketTick tick;
+    for (unsigned idle = 0;;) {
+        if (shard.pop(tick)) {
+            idle = 0;
+            on_tick(shard, tick);
+            continue;
+        }
+        // stop() comes after the last submit, so an empty ring seen after
+        // it is empty for good
+        if (!running_.load(std::memory_order_acquire)) {
+            if (shard.pop(tick)) {
+                on_tick(shard, tick);
+                continue;
+            }
+            break;
+        }
+        if (++idle >= kSpinPolls) std::this_thread::yield();
+    }
+
+    LiveBar bar;
+    for (size_t id = index; id < symbols_.size(); id += shards_.size()) {
+        SymbolState& state = *symbols_[id];
+        if (state.builder.flush(bar)) publish(shard, state, bar, 0);
+    }
+}
+
+void LiveIngestEngine::on_tick(Shard& shard, const MarketTick& tick) {
+    shard.consumed.store(shard.consumed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    SymbolState& state = *symbols_[tick.symbol];
+    LiveBar bar;
+    if (state.builder.add(tick, bar)) publish(shard, state, bar, tick.arrival_ns);
+}
+
+void LiveIngestEngine::publish(Shard& shard, SymbolState& state, const LiveBar& bar, uint64_t arrival_ns) {
+    state.engine.on_bar(bar.open, bar.high, bar.low, bar.close, bar.volume);
+    state.engine.take_features(shard.drained);
+    state.microstructure.on_bar(bar);
+    ++state.bars;
+    shard.bars.store(shard.bars.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    // Bars completed by stop() have no tick waiting on them
+    if (arrival_ns) shard.latency.record(live_clock_ns() - arrival_ns);
+    if (publish_) publish_({state.id, state.symbol, bar, shard.drained, state.microstructure.latest(), state.bars});
+}
+
+LatencyHistogram::Summary LiveIngestEngine::latency() const {
+    LatencyHistogram::Summary summary;
+    for (const auto& shard : shards_) shard->latency.merge_into(summary);
+    LatencyHistogram::finish(summary);
+    return summary;
+}
+
+uint64_t LiveIngestEngine::ticks_consumed() const {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) total += shard->consumed.load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t LiveIngestEngine::bars_published() const {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) total += shard->bars.load(std::memory_order_relaxed);
+    return total;
+}
@@ -0,0 +1,314 @@
+#include "machine_profile.h"
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr size_t kDefaultPairTile = 32;
+constexpr size_t kRepeats = 5;            // best of, per candidate
+
+// SIMD workload: one series of kTierRows bars through kTierRounds rounds
+constexpr size_t kTierRows = size_t(1) << 16;
+constexpr size_t kTierRounds = 8;
+// Pair workload: daily returns of a small universe, five years each
+constexpr size_t kPairStocks = 384;
+constexpr size_t kPairRows = 1260;
+constexpr size_t kPairTiles[] = {8, 16, 32, 64, 128};
+
+MachineProfile g_profile;   // set at startup, before any pool runs
+bool g_applied = false;
+
+std::string host_name() {
+#ifdef _WIN32
+    const char* name = std::getenv("COMPUTERNAME");
+    return name ? name : "";
+#else
+    char name[256] = {};
+    if (gethostname(name, sizeof(name) - 1) != 0) return "";
+    return name;
+#endif
+}
+
+unsigned hardware_threads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Names parse_simd_tier() reads back
+const char* tier_key(SimdTier tier) {
+    switch (tier) {
+    case SimdTier::Scalar: return "scalar";
+    case SimdTier::NEON: return "neon";
+    case SimdTier::AVX2: return "avx2";
+    case SimdTier::AVX512: return "avx512";
+    }
+    return "scalar";
+}
+
+// Deterministic noise in [-0.5, 0.5)
+std::vector<double> noise(size_t n, uint64_t seed) {
+    std::vector<double> values(n);
+    uint64_t state = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    for (double& v : values) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        v = static_cast<double>(state >> 11) * 0x1.0p-53 - 0.5;
+    }
+    return values;
+}
+
+// Best-of-kRepeats wall time of fn in milliseconds
+template <class Fn>
+double best_ms(Fn&& fn) {
+    double best = 0.0;
+    for (size_t r = 0; r < kRepeats; ++r) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (r == 0 || ms < best) best = ms;
+    }
+    return best;
+}
+
+// Per-bar, window and reduction kernels over one series, as the indicator
+// and pair code mixes them
+double tier_workload(const SimdKernels& kernels, const std::vector<double>& high, const std::vector<double>& low,
+                     const std::vector<double>& close, std::vector<double>& scratch, std::vector<double>& sums) {
+    const size_t n = close.size();
+    double sink = 0.0;
+    for (size_t round = 0; round < kTierRounds; ++round) {
+        kernels.true_range(high.data() + 1, low.data() + 1, close.data(), scratch.data(), n - 1);
+        kernels.window_sums(scratch.data(), n - 1, 14, sums.data());
+        kernels.typical_price(high.data(), low.data(), close.data(), scratch.data(), n);
+        double products[3];
+        kernels.centered_products(close.data(), scratch.data(), n, 0.0, 0.0, products);
+        sink += products[0] + sums[0] + kernels.squared_deviation_sum(close.data(), n, 0.0);
+    }
+    return sink;
+}
+
+// Series-major panel of kPairStocks synthetic return series and the square
+// tiles an edge cuts its upper triangle into
+struct PairPanel {
+    std::vector<double> series = noise(kPairStocks * kPairRows, 7);
+
+    std::vector<std::pair<size_t, size_t>> tiles(size_t edge) const {
+        const size_t blocks = (kPairStocks + edge - 1) / edge;
+        std::vector<std::pair<size_t, size_t>> out;
+        for (size_t bi = 0; bi < blocks; ++bi) {
+            for (size_t bj = bi; bj < blocks; ++bj) out.emplace_back(bi, bj);
+        }
+        return out;
+    }
+
+    // Cross products of every pair of the tile, j > i on the diagonal
+    double run_tile(const SimdKernels& kernels, size_t edge, size_t bi, size_t bj) const {
+        const size_t i_end = std::min(kPairStocks, (bi + 1) * edge);
+        const size_t j_end = std::min(kPairStocks, (bj + 1) * edge);
+        double sink = 0.0;
+        for (size_t i = bi * edge; i < i_end; ++i) {
+            for (size_t j = bi == bj ? i + 1 : bj * edge; j < j_end; ++j) {
+                double products[3];
+                kernels.centered_products(series.data() + i * kPairRows, series.data() + j * kPairRows,
+                                          kPairRows, 0.0, 0.0, products);
+                sink += products[0];
+            }
+        }
+        return sink;
+    }
+};
+
+// First candidate, in the cheaper-first order they are timed, within
+// kTuneTolerance of the fastest
+size_t first_within_tolerance(const std::vector<double>& times) {
+    const double best = *std::min_element(times.begin(), times.end());
+    size_t c = 0;
+    while (times[c] > best * (1.0 + kTuneTolerance)) ++c;
+    return c;
+}
+
+volatile double g_sink;   // keeps the timed work observable
+
+} // namespace
+
+bool MachineProfile::matches_host() const {
+    return host == host_name() && cores == std::thread::hardware_concurrency() && detected_tier == detect_simd_tier();
+}
+
+std::string MachineProfile::default_path() {
+    if (const char* path = std::getenv("MFT_MACHINE_PROFILE")) return path;
+#ifdef _WIN32
+    const char* home = std::getenv("USERPROFILE");
+#else
+    const char* home = std::getenv("HOME");
+#endif
+    if (!home) return "machine_profile";
+    return (std::filesystem::path(home) / ".mft" / "machine_profile").string();
+}
+
+bool MachineProfile::load(const std::string& path, MachineProfile& profile) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+    std::unordered_map<std::string, std::string> values;
+    std::string line;
+    while (std::getline(file, line)) {
+        const size_t colon = line.find(':');
+        if (line.empty() || line[0] == '#' || colon == std::string::npos) continue;
+        auto trim = [](std::string s) {
+            const size_t first = s.find_first_not_of(" \t\r\"");
+            const size_t last = s.find_last_not_of(" \t\r\"");
+            return first == std::string::npos ? std::string() : s.substr(first, last - first + 1);
+        };
+        values[trim(line.substr(0, colon))] = trim(line.substr(colon + 1));
+    }
+    for (const char* key : {"host", "cores", "detected_simd_tier", "simd_tier", "threads", "pair_tile"}) {
+        if (!values.count(key)) return false;
+    }
+    try {
+        MachineProfile loaded;
+        loaded.host = values["host"];
+        loaded.cores = static_cast<unsigned>(std::stoul(values["cores"]));
+        loaded.detected_tier = parse_simd_tier(values["detected_simd_tier"]);
+        loaded.simd_tier = parse_simd_tier(values["simd_tier"]);
+        loaded.threads = static_cast<unsigned>(std::stoul(values["threads"]));
+        loaded.pair_tile = std::stoul(values["pair_tile"]);
+        profile = loaded;
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+void MachineProfile::save(const std::string& path) const {
+    const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) std::filesystem::create_directories(parent);
+    std::ofstream file(path);
+    if (!file.is_open()) throw std::runtime_error("Cannot create file: " + path);
+    file << "# MFT machine profile, measured by --autotune; applies on this host only\n"
+         << "host: " << host << '\n'
+         << "cores: " << cores << '\n'
+         << "detected_simd_tier: " << tier_key(detected_tier) << '\n'
+         << "simd_tier: " << tier_key(simd_tier) << '\n'
+         << "threads: " << threads << '\n'
+         << "pair_tile: " << pair_tile << '\n';
+    if (!file) throw std::runtime_error("Error writing machine profile: " + path);
+}
+
+MachineProfile autotune_machine(std::ostream* log) {
+    MachineProfile profile;
+    profile.host = host_name();
+    profile.cores = std::thread::hardware_concurrency();
+    profile.detected_tier = detect_simd_tier();
+    const SimdTier original = active_simd_tier();
+
+    // SIMD tier: every tier limit_simd_tier() grants as asked
+    {
+        const std::vector<double> close = noise(kTierRows, 1);
+        std::vector<double> high(kTierRows), low(kTierRows), scratch(kTierRows), sums(kTierRows);
+        for (size_t i = 0; i < kTierRows; ++i) {
+            high[i] = close[i] + 0.25;
+            low[i] = close[i] - 0.25;
+        }
+        double best = 0.0;
+        for (SimdTier tier : {SimdTier::Scalar, SimdTier::NEON, SimdTier::AVX2, SimdTier::AVX512}) {
+            if (limit_simd_tier(tier) != tier) continue;
+            const SimdKernels& kernels = simd_kernels();
+            const double ms = best_ms([&] { g_sink = tier_workload(kernels, high, low, close, scratch, sums); });
+            if (log) *log << "  simd " << tier_key(tier) << ": " << ms << " ms" << std::endl;
+            if (tier == SimdTier::Scalar || ms < best) {
+                best = ms;
+                profile.simd_tier = tier;
+            }
+        }
+        limit_simd_tier(profile.simd_tier);
+    }
+    const SimdKernels& kernels = simd_kernels();
+    const PairPanel panel;
+
+    // Pair tile edge, on one thread
+    {
+        std::vector<double> times;
+        for (size_t edge : kPairTiles) {
+            const auto tiles = panel.tiles(edge);
+            const double ms = best_ms([&] {
+                double sink = 0.0;
+                for (const auto& [bi, bj] : tiles) sink += panel.run_tile(kernels, edge, bi, bj);
+                g_sink = sink;
+            });
+            times.push_back(ms);
+            if (log) *log << "  pair tile " << edge << ": " << ms << " ms" << std::endl;
+        }
+        profile.pair_tile = kPairTiles[first_within_tolerance(times)];
+    }
+
+    // Threads: the tiled pass on pools of 1, 2, 4, ... and every hardware thread
+    {
+        const unsigned cores = hardware_threads();
+        std::vector<unsigned> candidates;
+        for (unsigned t = 1; t < cores; t *= 2) candidates.push_back(t);
+        candidates.push_back(cores);
+        const auto tiles = panel.tiles(profile.pair_tile);
+        std::vector<size_t> costs(tiles.size(), 1);
+        std::vector<double> times;
+        for (unsigned threads : candidates) {
+            WorkStealingPool pool(threads);
+            std::vector<double> sinks(threads);
+            const double ms = best_ms([&] {
+                pool.run(costs, [&](size_t t, unsigned worker) {
+                    sinks[worker] += panel.run_tile(kernels, profile.pair_tile, tiles[t].first, tiles[t].second);
+                });
+            });
+            g_sink = sinks[0];
+            times.push_back(ms);
+            if (log) *log << "  threads " << threads << ": " << ms << " ms" << std::endl;
+        }
+        profile.threads = candidates[first_within_tolerance(times)];
+    }
+
+    limit_simd_tier(original);
+    return profile;
+}
+
+ProfileStatus apply_machine_profile(const std::string& path) {
+    MachineProfile profile;
+    if (!MachineProfile::load(path.empty() ? MachineProfile::default_path() : path, profile)) {
+        return ProfileStatus::Missing;
+    }
+    if (!profile.matches_host()) return ProfileStatus::OtherHost;
+    apply_machine_profile(profile);
+    return ProfileStatus::Applied;
+}
+
+void apply_machine_profile(const MachineProfile& profile) {
+    g_profile = profile;
+    g_applied = true;
+    limit_simd_tier(profile.simd_tier);
+}
+
+const char* profile_status_name(ProfileStatus status) {
+    switch (status) {
+    case ProfileStatus::Applied: return "applied";
+    case ProfileStatus::Missing: return "none (run --autotune)";
+    case ProfileStatus::OtherHost: return "measured on another host (run --autotune)";
+    }
+    return "unknown";
+}
+
+unsigned tuned_threads() {
+    return g_applied && g_profile.threads ? g_profile.threads : hardware_threads();
+}
+
+size_t tuned_pair_tile() {
+    return g_applied && g_profile.pair_tile ? g_profile.pair_tile : kDefaultPairTile;
+}
@@ -1,12 +1,18 @@
 #include "csv_reader.h"
 #include "csv_writer.h"
 #include "batch_ohlc_processor.h"
-#include "performance_benchmark.h"
-#include "large_scale_benchmark.h"
-#include "multi_core_benchmark.h"
-#include "adaptive_core_benchmark.h"
+#include "feature_selection.h"
+#include "feature_pipeline.h"
+#include "benchmark_registry.h"
+#include "simd_parity.h"
 #include "neon_technical_indicators.h"
 #include "simd_technical_indicators.h"
+#include "simd_dispatch.h"
+#include "machine_profile.h"
+#include "numa_topology.h"
+#include "hardware_counters.h"
+#include "memory_accounting.h"
+#include "trace.h"
 #include <iostream>
 #include <iomanip>
 #include <chrono>
@@ -32,39 +38,275 @@ void create_dummy_csv(const std::string& filepath, int num_rows) {
 }
 
 int main(int argc, char* argv[]) {
-    // Check for benchmark mode
+    // Benchmark registry, same options as run_benchmarks: --benchmark [--filter ...] [--json ...]
     if (argc > 1 && std::string(argv[1]) == "--benchmark") {
-        std::cout << "=== RUNNING PERFORMANCE BENCHMARK ===" << std::endl;
-        run_performance_benchmark();
-        return 0;
+        return run_benchmark_main(argc - 1, argv + 1);
     }
     
-    // Check for large scale benchmark mode
-    if (argc > 1 && std::string(argv[1]) == "--large-benchmark") {
-        std::cout << "=== RUNNING LARGE SCALE BENCHMARK ===" << std::endl;
-        run_large_scale_benchmark();
-        return 0;
+    // Vector indicators vs the scalar reference on every supported tier
+    if (argc > 1 && std::string(argv[1]) == "--parity") {
+        std::cout << "=== RUNNING SIMD PARITY CHECK ===" << std::endl;
+        return run_simd_parity_check() ? 0 : 1;
     }
-    
-    // Check for multi-core benchmark mode
-    if (argc > 1 && std::string(argv[1]) == "--multi-core") {
-        std::cout << "=== RUNNING MULTI-CORE BENCHMARK ===" << std::endl;
-        run_multi_core_benchmark();
-        return 0;
+
+    // Machine profile: --autotune [--profile path] measures this host and saves
+    // it; every other run applies the saved profile, --profile off skips it
+    std::string profile_path;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--profile") profile_path = argv[i + 1];
     }
-    
-    // Check for adaptive core benchmark mode
-    if (argc > 1 && std::string(argv[1]) == "--adaptive") {
-        std::cout << "=== RUNNING ADAPTIVE CORE BENCHMARK ===" << std::endl;
-        run_adaptive_core_benchmark();
+    if (argc > 1 && std::string(argv[1]) == "--autotune") {
+        const std::string path = profile_path.empty() || profile_path == "off" ? MachineProfile::default_path() : profile_path;
+        std::cout << "=== AUTOTUNING THIS HOST ===" << std::endl;
+        try {
+            const MachineProfile profile = autotune_machine(&std::cout);
+            profile.save(path);
+            std::cout << "SIMD tier " << simd_tier_name(profile.simd_tier) << ", " << profile.threads
+                      << " threads, " << profile.pair_tile << "-stock pair tiles -> " << path << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
         return 0;
     }
+    const ProfileStatus profile_status = profile_path == "off" ? ProfileStatus::Missing
+                                                               : apply_machine_profile(profile_path);
+
+    // Optional column selection: --features returns,rsi,volatility
+    // Pipeline shape: --read-threads N --compute-threads N --write-threads N --queue-depth N
+    // Output: --format csv|mftc|both [--direct-io] [--precision f64|f32] [--compression lz4|zstd[:level]|none]
+    // I/O: --io-depth N files in flight per read/write thread via io_uring or its thread-pool fallback (0 = blocking)
+    // Kernels: --simd scalar|neon|avx2|avx512 caps the runtime-detected tier
+    // Profile: --profile path|off picks the machine profile (default ~/.mft/machine_profile)
+    // Fusion: --fusion on|off runs the returns and bar indicator chains in fused blocks (default on)
+    // NUMA: --numa on|off pins pool workers to their nodes on multi-socket hosts (default on)
+    // Counters: --counters on|off reports cycles, IPC, cache and branch misses per stage (Linux)
+    // GARCH: --fit-garch [--garch-cache path] fits per-stock parameters for the regime features
+    // Regimes: --fit-regimes fits per-stock 2- and 3-state HMMs for the regime probability features
+    // Panel: --panel [--panel-market SYMBOL] [--panel-sectors path] [--panel-factors path]
+    // Window sweep: --windows 5,10,20,60 [--window-features sma,volatility,z_score,linear_slope]
+    // Trace: --trace path writes read/compute/write spans and queue waits as Chrome trace JSON
+    // Live view: --publish PREFIX also puts each stock in shared memory segment /PREFIX.SYMBOL
+    // Memory: --memory-budget 48G streams series too long for the budget in chunks
+    // Resample: --resample 5m,15m,1h,daily [--session 09:30-16:00] computes features per bar frequency
+    FeatureMask selection = all_features();
+    PipelineConfig pipeline;
+    std::string trace_file;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--list-features") {
+            for (const auto& name : feature_names()) std::cout << name << std::endl;
+            return 0;
+        }
+        if (arg == "--read-threads" && i + 1 < argc) {
+            pipeline.read_threads = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+            continue;
+        }
+        if (arg == "--compute-threads" && i + 1 < argc) {
+            pipeline.compute_threads = static_cast<unsigned>(std::max(0, std::atoi(argv[++i])));
+            continue;
+        }
+        if (arg == "--write-threads" && i + 1 < argc) {
+            pipeline.write_threads = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+            continue;
+        }
+        if (arg == "--format" && i + 1 < argc) {
+            try {
+                pipeline.format = parse_output_format(argv[++i]);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << " (use csv, mftc or both)" << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (arg == "--precision" && i + 1 < argc) {
+            try {
+                pipeline.precision = parse_feature_precision(argv[++i]);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << " (use f64 or f32)" << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (arg == "--compression" && i + 1 < argc) {
+            try {
+                pipeline.columnar.compression = parse_columnar_compression(argv[++i]);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << " (use lz4, zstd, zstd:<level> or none)" << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (arg == "--fit-garch") {
+            pipeline.fit_garch = true;
+            continue;
+        }
+        if (arg == "--fit-regimes") {
+            pipeline.fit_regimes = true;
+            continue;
+        }
+        if (arg == "--garch-cache" && i + 1 < argc) {
+            pipeline.fit_garch = true;
+            pipeline.garch_cache = argv[++i];
+            continue;
+        }
+        if (arg == "--panel") {
+            pipeline.panel = true;
+            continue;
+        }
+        if (arg == "--panel-market" && i + 1 < argc) {
+            pipeline.panel = true;
+            pipeline.panel_config.market_symbol = argv[++i];
+            continue;
+        }
+        if (arg == "--panel-sectors" && i + 1 < argc) {
+            pipeline.panel = true;
+            try {
+                pipeline.panel_config.sectors = PanelEngine::load_sectors(argv[++i]);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (arg == "--panel-factors" && i + 1 < argc) {
+            pipeline.panel = true;
+            pipeline.panel_factors = argv[++i];
+            continue;
+        }
+        if (arg == "--direct-io") {
+            pipeline.csv.direct_io = true;
+            continue;
+        }
+        if (arg == "--simd" && i + 1 < argc) {
+            try {
+                limit_simd_tier(parse_simd_tier(argv[++i]));
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << " (use scalar, neon, avx2 or avx512)" << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (arg == "--profile" && i + 1 < argc) {
+            ++i;   // applied before the other options
+            continue;
+        }
+        if (arg == "--fusion" && i + 1 < argc) {
+            pipeline.loop_fusion = std::string(argv[++i]) != "off";
+            continue;
+        }
+        if (arg == "--numa" && i + 1 < argc) {
+            set_numa_placement(std::string(argv[++i]) != "off");
+            continue;
+        }
+        if (arg == "--counters" && i + 1 < argc) {
+            set_hardware_counters(std::string(argv[++i]) != "off");
+            continue;
+        }
+        if (arg == "--trace" && i + 1 < argc) {
+            trace_file = argv[++i];
+            set_tracing(true);
+            continue;
+        }
+        if (arg == "--publish" && i + 1 < argc) {
+            pipeline.publish_prefix = argv[++i];
+            continue;
+        }
+        if (arg == "--memory-budget" && i + 1 < argc) {
+            try {
+                pipeline.memory_budget_mb = parse_memory_size(argv[++i]);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << " (use megabytes, or a G suffix)" << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if ((arg == "--resample" || arg == "--session") && i + 1 < argc) {
+            try {
+                if (arg == "--resample") {
+                    pipeline.resample.frequencies = parse_frequency_list(argv[++i]);
+                } else {
+                    pipeline.resample.session = parse_trading_session(argv[++i]);
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << " (use e.g. --resample 5m,1h,daily --session 09:30-16:00)" << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (arg == "--queue-depth" && i + 1 < argc) {
+            pipeline.queue_depth = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+            continue;
+        }
+        if (arg == "--io-depth" && i + 1 < argc) {
+            pipeline.io_depth = static_cast<unsigned>(std::max(0, std::atoi(argv[++i])));
+            continue;
+        }
+        if ((arg == "--windows" || arg == "--window-features") && i + 1 < argc) {
+            try {
+                if (arg == "--windows") {
+                    pipeline.window_sweep.windows = parse_window_list(argv[++i]);
+                } else {
+                    pipeline.window_sweep.indicators = parse_sweep_indicators(argv[++i]);
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (arg == "--features" && i + 1 < argc) {
+            try {
+                selection = parse_feature_list(argv[++i]);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << " (use --list-features)" << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (arg == "--features") {
+            std::cerr << "Error: --features needs a comma-separated list of feature names (use --list-features)" << std::endl;
+            return 1;
+        }
+    }
+
+    if (pipeline.memory_budget_mb > 0 && pipeline.panel) {
+        std::cerr << "Error: --memory-budget cannot be combined with --panel, which keeps every series whole" << std::endl;
+        return 1;
+    }
+    if (pipeline.resample.enabled() && (pipeline.memory_budget_mb > 0 || pipeline.panel)) {
+        std::cerr << "Error: --resample cannot be combined with --memory-budget or --panel, which take the source bars" << std::endl;
+        return 1;
+    }
 
     // Display optimization information
     std::cout << "=== OPTIMIZATION STATUS ===" << std::endl;
+    std::cout << "SIMD Tier: " << simd_tier_name(active_simd_tier())
+              << " (detected " << simd_tier_name(detect_simd_tier()) << ")" << std::endl;
     std::cout << "NEON SIMD: " << (NEONTechnicalIndicators::is_neon_available() ? "ENABLED" : "DISABLED") << std::endl;
     std::cout << "AVX2 SIMD: " << (SIMDTechnicalIndicators::is_simd_available() ? "ENABLED" : "DISABLED") << std::endl;
     std::cout << "CPU Cores: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "Machine Profile: " << (profile_path == "off" ? "off" : profile_status_name(profile_status)) << std::endl;
+    std::cout << "NUMA Nodes: " << NumaTopology::system().nodes()
+              << (numa_placement_active() ? " (workers pinned)" : "") << std::endl;
+    std::cout << "Features: " << selection.count() << "/" << kFeatureCount << " selected" << std::endl;
+    if (pipeline.window_sweep.enabled()) {
+        std::cout << "Window Sweep: " << pipeline.window_sweep.indicators.count() << " indicators x "
+                  << pipeline.window_sweep.windows.size() << " windows" << std::endl;
+    }
+    if (pipeline.resample.enabled()) {
+        std::cout << "Resample:";
+        for (const auto& frequency : pipeline.resample.frequencies) std::cout << " " << frequency.name;
+        const auto& session = pipeline.resample.session;
+        std::cout << " (session " << std::setfill('0') << std::setw(2) << session.open_minute / 60 << ":"
+                  << std::setw(2) << session.open_minute % 60 << "-" << std::setw(2) << session.close_minute / 60
+                  << ":" << std::setw(2) << session.close_minute % 60 << std::setfill(' ') << ")" << std::endl;
+    }
+    if (pipeline.memory_budget_mb > 0) {
+        const MemoryPlan plan = plan_memory(pipeline, selection);
+        std::cout << "Memory Budget: " << pipeline.memory_budget_mb << " MB (series over " << plan.series_rows
+                  << " rows in chunks of " << plan.chunk_rows << ")" << std::endl;
+    }
     std::cout << "============================" << std::endl;
     std::cout << "Run with --benchmark to test performance optimizations" << std::endl;
     std::cout << std::endl;
@@ -103,144 +345,18 @@ int main(int argc, char* argv[]) {
             }
         }
         
-        std::cout << "Found " << csv_files.size() << " CSV files. Reading in parallel..." << std::endl;
-        
-        // Parallel file reading for maximum I/O throughput
-        const unsigned int num_read_threads = std::min(static_cast<unsigned int>(csv_files.size()), 
-                                                      std::thread::hardware_concurrency());
-        std::vector<std::unique_ptr<OHLCVData>> ohlcv_series(csv_files.size());
-        std::vector<std::thread> read_threads;
-        std::atomic<size_t> read_completed{0};
-        std::mutex read_progress_mutex;
-        
-        const size_t read_batch_size = (csv_files.size() + num_read_threads - 1) / num_read_threads;
-        
-        auto read_start = std::chrono::high_resolution_clock::now();
-        
-        for (unsigned int t = 0; t < num_read_threads; ++t) {
-            read_threads.emplace_back([&, t]() {
-                const size_t start_idx = t * read_batch_size;
-                const size_t end_idx = std::min(start_idx + read_batch_size, csv_files.size());
-                
-                for (size_t i = start_idx; i < end_idx; ++i) {
-                    try {
-                        ohlcv_series[i] = FastCSVReader::read_csv_file(csv_files[i]);
-                        
-                        size_t current_count = ++read_completed;
-                        if (current_count % 500 == 0 || current_count == csv_files.size()) {
-                            std::lock_guard<std::mutex> lock(read_progress_mutex);
-                            std::cout << "  - Read progress: " << current_count << "/" << csv_files.size() 
-                                     << " (" << (current_count * 100 / csv_files.size()) << "%)" << std::endl;
-                        }
-                    } catch (const std::exception& e) {
-                        std::lock_guard<std::mutex> lock(read_progress_mutex);
-                        std::cerr << "Error reading " << csv_files[i] << ": " << e.what() << std::endl;
-                    }
-                }
-            });
-        }
-        
-        // Wait for all read threads to complete
-        for (auto& thread : read_threads) {
-            thread.join();
-        }
-        
-        auto read_end = std::chrono::high_resolution_clock::now();
-        auto read_duration = std::chrono::duration_cast<std::chrono::milliseconds>(read_end - read_start);
-        
-        // Remove null entries
-        ohlcv_series.erase(
-            std::remove_if(ohlcv_series.begin(), ohlcv_series.end(),
-                          [](const auto& ptr) { return !ptr || ptr->empty(); }),
-            ohlcv_series.end()
-        );
+        const unsigned int compute_threads = pipeline.compute_threads ? pipeline.compute_threads : tuned_threads();
+        std::cout << "Found " << csv_files.size() << " CSV files. Streaming through "
+                  << pipeline.read_threads << " read / " << compute_threads << " compute / "
+                  << pipeline.write_threads << " write threads (queue depth "
+                  << pipeline.queue_depth << ")..." << std::endl;
         
-        // Calculate and display reading performance metrics
-        double read_time_seconds = read_duration.count() / 1000.0;
-        double files_per_second = ohlcv_series.size() / read_time_seconds;
+        PipelineStats stats = run_feature_pipeline(csv_files, output_dir, selection, pipeline);
         
-        std::cout << "Parallel reading completed in " << read_duration.count() << " ms" << std::endl;
-        std::cout << "Successfully loaded " << ohlcv_series.size() << " stock datasets." << std::endl;
-        std::cout << "Reading Performance: " << std::fixed << std::setprecision(2) 
-                  << files_per_second << " files/second" << std::endl;
-
-        std::vector<std::vector<double>> opens, highs, lows, closes, volumes;
-        opens.reserve(ohlcv_series.size());
-        highs.reserve(ohlcv_series.size());
-        lows.reserve(ohlcv_series.size());
-        closes.reserve(ohlcv_series.size());
-        volumes.reserve(ohlcv_series.size());
-        
-        for(const auto& data : ohlcv_series) {
-            opens.push_back(data->open);
-            highs.push_back(data->high);
-            lows.push_back(data->low);
-            closes.push_back(data->close);
-            volumes.push_back(data->volume);
-        }
-
-        // Get number of CPU cores for optimal parallelization
-        const unsigned int num_threads = std::thread::hardware_concurrency();
-        std::cout << "Using " << num_threads << " threads for parallel processing" << std::endl;
-
-        BatchOHLCProcessor processor;
-        std::cout << "Calculating features for " << ohlcv_series.size() << " stocks..." << std::endl;
-        
-        auto start_time = std::chrono::high_resolution_clock::now();
-        
-        // Parallel feature calculation and file writing
-        std::filesystem::create_directories(output_dir);
-        std::atomic<size_t> completed_count{0};
-        std::mutex progress_mutex;
-        
-        // Process stocks in parallel batches
-        std::vector<std::thread> threads;
-        const size_t batch_size = (ohlcv_series.size() + num_threads - 1) / num_threads;
-        
-        for (unsigned int t = 0; t < num_threads; ++t) {
-            threads.emplace_back([&, t]() {
-                const size_t start_idx = t * batch_size;
-                const size_t end_idx = std::min(start_idx + batch_size, ohlcv_series.size());
-                
-                for (size_t i = start_idx; i < end_idx; ++i) {
-                    try {
-                        // Calculate features for this stock
-                        auto features = processor.calculate_features(
-                            opens[i], highs[i], lows[i], closes[i], volumes[i]
-                        );
-                        
-                        // Write to file
-                        const std::string output_path = output_dir + "/" + ohlcv_series[i]->symbol + "_features.csv";
-                        FastCSVWriter::write_ohlcv_with_features(output_path, *ohlcv_series[i], features);
-                        
-                        // Update progress
-                        size_t current_count = ++completed_count;
-                        if (current_count % 100 == 0 || current_count == ohlcv_series.size()) {
-                            std::lock_guard<std::mutex> lock(progress_mutex);
-                            std::cout << "  - Progress: " << current_count << "/" << ohlcv_series.size() 
-                                     << " (" << (current_count * 100 / ohlcv_series.size()) << "%)" << std::endl;
-                        }
-                    } catch (const std::exception& e) {
-                        std::lock_guard<std::mutex> lock(progress_mutex);
-                        std::cerr << "Error processing " << ohlcv_series[i]->symbol << ": " << e.what() << std::endl;
-                    }
-                }
-            });
-        }
-        
-        // Wait for all threads to complete
-        for (auto& thread : threads) {
-            thread.join();
-        }
-        
-        auto end_time = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-        
-        // Calculate and display processing performance metrics
-        double process_time_seconds = duration.count() / 1000.0;
-        double stocks_per_second = completed_count.load() / process_time_seconds;
-        double total_time_seconds = read_time_seconds + process_time_seconds;
-        double overall_throughput = completed_count.load() / total_time_seconds;
+        // Calculate and display performance metrics
+        double total_time_seconds = stats.wall_ms / 1000.0;
+        double stocks_per_second = stats.stocks_written / total_time_seconds;
+        double files_per_second = stats.files_read / total_time_seconds;
         
         // Estimate floating-point operations for GFLOPS calculation
         // Based on the technical indicators computed per stock:
@@ -253,39 +369,68 @@ int main(int argc, char* argv[]) {
         // - SIMD operations can be 4-8x more efficient
         
         // Conservative estimate: ~500 floating-point operations per data point per stock
-        size_t total_data_points = 0;
-        for (const auto& data : ohlcv_series) {
-            total_data_points += data->close.size();
-        }
-        
-        // Estimate total floating-point operations
         const double ops_per_data_point = 500.0; // Conservative estimate
-        double total_flops = static_cast<double>(total_data_points) * ops_per_data_point;
-        double gflops = total_flops / (process_time_seconds * 1e9); // Convert to GFLOPS
+        double total_flops = static_cast<double>(stats.total_data_points) * ops_per_data_point;
+        double gflops = total_flops / (total_time_seconds * 1e9); // Convert to GFLOPS
         
-        std::cout << "Parallel processing completed in " << duration.count() << " ms" << std::endl;
-        std::cout << "Successfully processed " << completed_count.load() << " stocks!" << std::endl;
+        std::cout << "Pipeline completed in " << std::fixed << std::setprecision(0) << stats.wall_ms << " ms" << std::endl;
+        std::cout << "Successfully processed " << stats.stocks_written << " stocks!" << std::endl;
         
         // Performance Summary
         std::cout << "\n=== PERFORMANCE METRICS ===" << std::endl;
-        std::cout << "Reading Phase:" << std::endl;
-        std::cout << "  - Time: " << std::fixed << std::setprecision(3) << read_time_seconds << " seconds" << std::endl;
+        std::cout << "Reading Stage:" << std::endl;
+        std::cout << "  - Files Loaded: " << stats.files_read << " (" << stats.read_errors << " errors)" << std::endl;
         std::cout << "  - Throughput: " << std::fixed << std::setprecision(2) << files_per_second << " files/second" << std::endl;
+        if (!stats.io_backend.empty()) {
+            std::cout << "  - Async I/O: " << stats.io_backend << ", " << pipeline.io_depth << " files in flight per thread" << std::endl;
+        }
         
-        std::cout << "Processing Phase:" << std::endl;
-        std::cout << "  - Time: " << std::fixed << std::setprecision(3) << process_time_seconds << " seconds" << std::endl;
+        std::cout << "Processing Stage:" << std::endl;
+        std::cout << "  - Stocks Written: " << stats.stocks_written << " (" << stats.process_errors << " errors)" << std::endl;
         std::cout << "  - Throughput: " << std::fixed << std::setprecision(2) << stocks_per_second << " stocks/second" << std::endl;
+        if (pipeline.panel) {
+            std::cout << "  - Panel Files: " << stats.panel_written << " in " << std::fixed << std::setprecision(0) << stats.panel_ms << " ms" << std::endl;
+        }
+        if (pipeline.memory_budget_mb > 0) {
+            std::cout << "  - Chunked Stocks: " << stats.chunked_stocks << " in " << std::fixed << std::setprecision(0) << stats.chunked_ms << " ms" << std::endl;
+        }
+        if (pipeline.resample.enabled()) {
+            std::cout << "  - Resampled Series: " << stats.resampled_series << std::endl;
+        }
+        if (pipeline.window_sweep.enabled()) {
+            std::cout << "  - Window Sweep Files: " << stats.sweep_written << std::endl;
+        }
+        if (pipeline.fit_garch) {
+            std::cout << "  - GARCH Fits: " << stats.garch_fitted << " fitted, " << stats.garch_cached << " from cache" << std::endl;
+        }
+        if (pipeline.fit_regimes) {
+            std::cout << "  - Regime HMM Fits: " << stats.regimes_fitted << std::endl;
+        }
         
         std::cout << "Computational Performance:" << std::endl;
-        std::cout << "  - Total Data Points: " << total_data_points << std::endl;
+        std::cout << "  - Total Data Points: " << stats.total_data_points << std::endl;
         std::cout << "  - Estimated FLOPS: " << std::scientific << std::setprecision(2) << total_flops << std::endl;
         std::cout << "  - Performance: " << std::fixed << std::setprecision(3) << gflops << " GFLOPS" << std::endl;
         
         std::cout << "Overall Performance:" << std::endl;
         std::cout << "  - Total Time: " << std::fixed << std::setprecision(3) << total_time_seconds << " seconds" << std::endl;
-        std::cout << "  - Overall Throughput: " << std::fixed << std::setprecision(2) << overall_throughput << " stocks/second" << std::endl;
-        std::cout << "  - CPU Cores Used: " << num_threads << std::endl;
-        std::cout << "  - Read Threads Used: " << num_read_threads << std::endl;
+        std::cout << "  - Queue Peaks (parsed/computed): " << stats.parsed_queue_peak << "/"
+                  << stats.computed_queue_peak << " of " << pipeline.queue_depth << std::endl;
+        std::cout << "  - CPU Cores Available: " << std::thread::hardware_concurrency() << std::endl;
+        
+        print_pool_stats("Read Stage", stats.read);
+        print_pool_stats("Compute Stage", stats.compute);
+        print_pool_stats("Write Stage", stats.write);
+        if (hardware_counters_enabled()) {
+            print_counter_report("Pipeline");
+        }
+        print_memory_report("Pipeline");
+        if (!trace_file.empty()) {
+            set_tracing(false);
+            print_trace_latencies("Pipeline");
+            write_chrome_trace(trace_file);
+            std::cout << "  - Trace: " << trace_file << std::endl;
+        }
         std::cout << "=============================" << std::endl;
 
     } catch (const std::exception& e) {
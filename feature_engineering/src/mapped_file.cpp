@@ -0,0 +1,68 @@
+#include "mapped_file.h"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& filepath) {
+#ifdef _WIN32
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) throw std::runtime_error("Cannot open file: " + filepath);
+    const size_t size = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+    buffer_.resize(size);
+
+    constexpr size_t kChunk = 4 << 20;
+    for (size_t offset = 0; offset < size; offset += kChunk) {
+        const size_t n = std::min(kChunk, size - offset);
+        if (!file.read(buffer_.data() + offset, static_cast<std::streamsize>(n))) {
+            throw std::runtime_error("Cannot read file: " + filepath);
+        }
+    }
+    data_ = buffer_.data();
+    size_ = size;
+#else
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd == -1) throw std::runtime_error("Cannot open file: " + filepath);
+
+    struct stat sb;
+    if (fstat(fd, &sb) == -1) {
+        close(fd);
+        throw std::runtime_error("Cannot read file: " + filepath);
+    }
+    size_ = static_cast<size_t>(sb.st_size);
+    if (size_ == 0) {
+        close(fd);
+        return;  // mmap rejects empty files
+    }
+
+    void* map = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) throw std::runtime_error("Cannot map file: " + filepath);
+    madvise(map, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(map);
+    mapped_ = true;
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+    if (mapped_) munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+void MappedFile::release(size_t end) {
+#ifndef _WIN32
+    if (!mapped_) return;
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t bytes = std::min(end, size_) / page * page;
+    if (bytes > 0) madvise(const_cast<char*>(data_), bytes, MADV_DONTNEED);
+#else
+    (void)end;
+#endif
+}
@@ -0,0 +1,258 @@
+#include "memory_accounting.h"
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+
+#ifdef __linux__
+#include <cstdio>
+#include <cstring>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <sys/resource.h>
+#elif defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+namespace {
+
+struct SubsystemCounters {
+    std::atomic<size_t> live{0};
+    std::atomic<size_t> peak{0};
+    std::atomic<size_t> stage_peak{0};   // since the outermost running MemoryScope started
+};
+
+SubsystemCounters g_subsystems[kMemorySubsystems];
+std::atomic<unsigned> g_active_scopes{0};
+// Highest kernel high-water mark seen before a stage reset it
+std::atomic<size_t> g_reset_peak_rss{0};
+
+void raise(std::atomic<size_t>& peak, size_t value) {
+    size_t current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+struct Report {
+    std::mutex mutex;
+    std::vector<MemoryStageRecord> records;
+};
+
+Report& report() {
+    static Report instance;
+    return instance;
+}
+
+double megabytes(size_t bytes) {
+    return bytes / (1024.0 * 1024.0);
+}
+
+#ifdef __linux__
+// VmRSS and VmHWM of /proc/self/status, in bytes
+void read_status(size_t& rss, size_t& hwm) {
+    rss = hwm = 0;
+    std::FILE* file = std::fopen("/proc/self/status", "r");
+    if (!file) return;
+    char line[256];
+    while (std::fgets(line, sizeof(line), file)) {
+        unsigned long long kb = 0;
+        if (std::strncmp(line, "VmRSS:", 6) == 0 && std::sscanf(line + 6, "%llu", &kb) == 1) rss = kb * 1024;
+        if (std::strncmp(line, "VmHWM:", 6) == 0 && std::sscanf(line + 6, "%llu", &kb) == 1) hwm = kb * 1024;
+    }
+    std::fclose(file);
+}
+#endif
+
+// The kernel's high-water mark, before any reset
+size_t kernel_peak_rss() {
+#ifdef __linux__
+    size_t rss, hwm;
+    read_status(rss, hwm);
+    return hwm;
+#elif defined(__APPLE__)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return static_cast<size_t>(usage.ru_maxrss);   // bytes on macOS
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    return 0;
+#endif
+}
+
+// Restarts the kernel's high-water mark from the current resident set
+// (Linux 4.0+); elsewhere it keeps the process's peak
+void reset_kernel_peak_rss() {
+#ifdef __linux__
+    raise(g_reset_peak_rss, kernel_peak_rss());
+    std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+std::vector<std::pair<const char*, double>> memory_sample() {
+    std::vector<std::pair<const char*, double>> values;
+    values.emplace_back("rss", megabytes(process_rss_bytes()));
+    for (size_t s = 0; s < kMemorySubsystems; ++s) {
+        values.emplace_back(memory_subsystem_name(static_cast<MemorySubsystem>(s)),
+                            megabytes(g_subsystems[s].live.load(std::memory_order_relaxed)));
+    }
+    return values;
+}
+
+} // namespace
+
+const char* memory_subsystem_name(MemorySubsystem subsystem) {
+    switch (subsystem) {
+    case MemorySubsystem::Loader: return "loader";
+    case MemorySubsystem::Features: return "features";
+    case MemorySubsystem::Caches: return "caches";
+    case MemorySubsystem::Exports: return "exports";
+    }
+    return "unknown";
+}
+
+void memory_allocated(MemorySubsystem subsystem, size_t bytes) {
+    SubsystemCounters& c = g_subsystems[static_cast<size_t>(subsystem)];
+    const size_t live = c.live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    raise(c.peak, live);
+    raise(c.stage_peak, live);
+}
+
+void memory_released(MemorySubsystem subsystem, size_t bytes) {
+    g_subsystems[static_cast<size_t>(subsystem)].live.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+MemoryUsage memory_usage(MemorySubsystem subsystem) {
+    const SubsystemCounters& c = g_subsystems[static_cast<size_t>(subsystem)];
+    return {c.live.load(std::memory_order_relaxed), c.peak.load(std::memory_order_relaxed)};
+}
+
+MemoryCharge& MemoryCharge::operator=(MemoryCharge&& other) noexcept {
+    if (this != &other) {
+        release();
+        subsystem_ = other.subsystem_;
+        bytes_ = other.bytes_;
+        other.bytes_ = 0;
+    }
+    return *this;
+}
+
+void MemoryCharge::set(MemorySubsystem subsystem, size_t bytes) {
+    if (subsystem == subsystem_ && bytes == bytes_) return;
+    release();
+    subsystem_ = subsystem;
+    bytes_ = bytes;
+    if (bytes_) memory_allocated(subsystem_, bytes_);
+}
+
+void MemoryCharge::release() {
+    if (bytes_) memory_released(subsystem_, bytes_);
+    bytes_ = 0;
+}
+
+size_t process_rss_bytes() {
+#ifdef __linux__
+    size_t rss, hwm;
+    read_status(rss, hwm);
+    return rss;
+#elif defined(__APPLE__)
+    mach_task_basic_info info{};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return static_cast<size_t>(info.resident_size);
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return counters.WorkingSetSize;
+#else
+    return 0;
+#endif
+}
+
+size_t process_peak_rss_bytes() {
+    return std::max(kernel_peak_rss(), g_reset_peak_rss.load(std::memory_order_relaxed));
+}
+
+MemoryScope::MemoryScope(std::string label) : label_(std::move(label)) {
+    if (g_active_scopes.fetch_add(1, std::memory_order_acq_rel) == 0) {
+        reset_kernel_peak_rss();
+        for (auto& c : g_subsystems) c.stage_peak.store(c.live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    trace_counter("memory MB", memory_sample());
+}
+
+MemoryScope::~MemoryScope() {
+    MemoryStageRecord record;
+    record.label = label_;
+    record.samples = 1;
+#ifdef __linux__
+    read_status(record.end_rss_bytes, record.peak_rss_bytes);
+#else
+    record.end_rss_bytes = process_rss_bytes();
+    record.peak_rss_bytes = kernel_peak_rss();
+#endif
+    for (size_t s = 0; s < kMemorySubsystems; ++s) {
+        record.peak_live_bytes[s] = g_subsystems[s].stage_peak.load(std::memory_order_relaxed);
+    }
+    trace_counter("memory MB", memory_sample());
+    g_active_scopes.fetch_sub(1, std::memory_order_acq_rel);
+
+    Report& r = report();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto it = std::find_if(r.records.begin(), r.records.end(),
+                           [&](const MemoryStageRecord& existing) { return existing.label == record.label; });
+    if (it == r.records.end()) {
+        r.records.push_back(std::move(record));
+        return;
+    }
+    ++it->samples;
+    it->peak_rss_bytes = std::max(it->peak_rss_bytes, record.peak_rss_bytes);
+    it->end_rss_bytes = record.end_rss_bytes;
+    for (size_t s = 0; s < kMemorySubsystems; ++s) {
+        it->peak_live_bytes[s] = std::max(it->peak_live_bytes[s], record.peak_live_bytes[s]);
+    }
+}
+
+std::vector<MemoryStageRecord> memory_report() {
+    Report& r = report();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return r.records;
+}
+
+void reset_memory_report() {
+    {
+        Report& r = report();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.records.clear();
+    }
+    for (auto& c : g_subsystems) c.peak.store(c.live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void print_memory_report(const char* title) {
+    std::cout << title << " Memory:" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (size_t s = 0; s < kMemorySubsystems; ++s) {
+        const MemoryUsage usage = memory_usage(static_cast<MemorySubsystem>(s));
+        std::cout << "  - " << memory_subsystem_name(static_cast<MemorySubsystem>(s)) << ": "
+                  << megabytes(usage.peak_bytes) << " MB peak, " << megabytes(usage.live_bytes) << " MB live" << std::endl;
+    }
+    for (const auto& record : memory_report()) {
+        std::cout << "  - stage " << record.label << " (" << record.samples << "x): RSS peak "
+                  << megabytes(record.peak_rss_bytes) << " MB, end " << megabytes(record.end_rss_bytes) << " MB;";
+        for (size_t s = 0; s < kMemorySubsystems; ++s) {
+            std::cout << (s ? ", " : " ") << memory_subsystem_name(static_cast<MemorySubsystem>(s)) << " "
+                      << megabytes(record.peak_live_bytes[s]);
+        }
+        std::cout << " MB peak" << std::endl;
+    }
+    std::cout << "  - process RSS peak: " << megabytes(process_peak_rss_bytes()) << " MB" << std::endl;
+}
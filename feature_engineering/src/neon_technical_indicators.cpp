@@ -1,5 +1,7 @@
 #include "../include/neon_technical_indicators.h"
 #include "../include/technical_indicators.h"
+#include "../include/simd_dispatch.h"
+#include "../include/rolling_statistics.h"
 #include <stdexcept>
 #include <numeric>
 #include <cmath>
@@ -153,20 +155,10 @@ double NEONTechnicalIndicators::neon_sum_array(const std::vector<double>& data,
 }
 
 std::vector<double> NEONTechnicalIndicators::neon_rolling_sum(const std::vector<double>& data, size_t window) {
-    if (data.size() < window) return {};
-
-    std::vector<double> result;
-    result.reserve(data.size() - window + 1);
-    
-    // Calculate first window sum using NEON
-    double sum = neon_sum_array(data, 0, window);
-    result.push_back(sum);
-    
-    // Use sliding window technique for subsequent sums
-    for (size_t i = 1; i <= data.size() - window; ++i) {
-        sum = sum - data[i - 1] + data[i + window - 1];
-        result.push_back(sum);
-    }
+    // Shared with the AVX tiers and SIMDStatistics (rolling_statistics.h)
+    if (window == 0 || data.size() < window) return {};
+    std::vector<double> result(data.size() - window + 1);
+    RollingStatistics::sum(data.data(), data.size(), window, result.data());
     return result;
 }
 
@@ -233,56 +225,16 @@ std::vector<double> NEONTechnicalIndicators::calculate_returns_neon(const std::v
 }
 
 std::vector<double> NEONTechnicalIndicators::simple_moving_average_neon(const std::vector<double>& data, size_t window) {
-    auto sums = neon_rolling_sum(data, window);
-    if (sums.empty()) return {};
-
-    std::vector<double> result(sums.size());
-    const double inv_window = 1.0 / window;
-    const float64x2_t vinv = vdupq_n_f64(inv_window);
-    const size_t size = sums.size();
-    const size_t neon_size = (size / NEON_DOUBLE_COUNT) * NEON_DOUBLE_COUNT;
-
-    for (size_t i = 0; i < neon_size; i += NEON_DOUBLE_COUNT) {
-        float64x2_t vsum = vld1q_f64(&sums[i]);
-        float64x2_t vresult = vmulq_f64(vsum, vinv);
-        vst1q_f64(&result[i], vresult);
-    }
-    for (size_t i = neon_size; i < size; ++i) {
-        result[i] = sums[i] * inv_window;
-    }
+    if (window == 0 || data.size() < window) return {};
+    std::vector<double> result(data.size() - window + 1);
+    RollingStatistics::mean(data.data(), data.size(), window, result.data());
     return result;
 }
 
 std::vector<double> NEONTechnicalIndicators::calculate_rolling_volatility_neon(const std::vector<double>& returns, int window) {
     if (returns.size() < static_cast<size_t>(window) || window <= 1) return {};
-
-    std::vector<double> volatility;
-    volatility.reserve(returns.size() - window + 1);
-
-    for (size_t i = 0; i <= returns.size() - window; ++i) {
-        double mean = neon_sum_array(returns, i, window) / window;
-        
-        // Calculate variance using NEON
-        double variance = 0.0;
-        const size_t end = i + window;
-        const size_t neon_end = i + (window / NEON_DOUBLE_COUNT) * NEON_DOUBLE_COUNT;
-        const float64x2_t vmean = vdupq_n_f64(mean);
-        float64x2_t vvar = vdupq_n_f64(0.0);
-        
-        for (size_t j = i; j < neon_end; j += NEON_DOUBLE_COUNT) {
-            float64x2_t vdata = vld1q_f64(&returns[j]);
-            float64x2_t vdiff = vsubq_f64(vdata, vmean);
-            vvar = vfmaq_f64(vvar, vdiff, vdiff);  // Fused multiply-add
-        }
-
-        variance = vgetq_lane_f64(vvar, 0) + vgetq_lane_f64(vvar, 1);
-
-        for (size_t j = neon_end; j < end; ++j) {
-            double diff = returns[j] - mean;
-            variance += diff * diff;
-        }
-        volatility.push_back(std::sqrt(variance / (window - 1)));
-    }
+    std::vector<double> volatility(returns.size() - window + 1);
+    RollingStatistics::stddev(returns.data(), returns.size(), static_cast<size_t>(window), volatility.data());
     return volatility;
 }
 
@@ -393,7 +345,8 @@ std::vector<double> NEONTechnicalIndicators::aligned_vector(size_t size) {
 }
 
 bool NEONTechnicalIndicators::is_neon_available() {
-    return NEON_ENABLED;
+    // Compiled in and not capped by limit_simd_tier()
+    return NEON_ENABLED && active_simd_tier() == SimdTier::NEON;
 }
 
 void NEONTechnicalIndicators::process_multiple_series_parallel_optimized(
@@ -0,0 +1,150 @@
+#include "numa_topology.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <cstring>
+#include <filesystem>
+#endif
+
+namespace {
+
+std::atomic<bool> placement_enabled{true};
+std::atomic<bool> replication_enabled{false};
+
+#ifdef __linux__
+// "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}
+std::vector<unsigned> parse_cpu_list(const std::string& text) {
+    std::vector<unsigned> cpus;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find(',', pos);
+        if (end == std::string::npos) end = text.size();
+        const std::string range = text.substr(pos, end - pos);
+        const size_t dash = range.find('-');
+        try {
+            const unsigned first = static_cast<unsigned>(std::stoul(range.substr(0, dash)));
+            const unsigned last = dash == std::string::npos ? first
+                                                            : static_cast<unsigned>(std::stoul(range.substr(dash + 1)));
+            for (unsigned cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        } catch (const std::exception&) {
+            // Blank or malformed entries are skipped
+        }
+        pos = end + 1;
+    }
+    return cpus;
+}
+#endif
+
+NumaTopology detect() {
+    NumaTopology topology;
+#ifdef __linux__
+    std::error_code error;
+    for (unsigned node = 0;; ++node) {
+        const std::string dir = "/sys/devices/system/node/node" + std::to_string(node);
+        if (!std::filesystem::exists(dir, error)) break;
+        std::ifstream file(dir + "/cpulist");
+        std::string text;
+        std::getline(file, text);
+        auto cpus = parse_cpu_list(text);
+        // Memory-only nodes have no CPUs to run workers on
+        if (!cpus.empty()) topology.node_cpus.push_back(std::move(cpus));
+    }
+#endif
+    if (topology.node_cpus.empty()) {
+        std::vector<unsigned> cpus(std::max(1u, std::thread::hardware_concurrency()));
+        for (unsigned cpu = 0; cpu < cpus.size(); ++cpu) cpus[cpu] = cpu;
+        topology.node_cpus.push_back(std::move(cpus));
+    }
+    return topology;
+}
+
+}
+
+const NumaTopology& NumaTopology::system() {
+    static const NumaTopology topology = detect();
+    return topology;
+}
+
+void set_numa_placement(bool enabled) {
+    placement_enabled = enabled;
+}
+
+bool numa_placement_active() {
+    return placement_enabled && NumaTopology::system().nodes() > 1;
+}
+
+void set_numa_replication(bool enabled) {
+    replication_enabled = enabled;
+}
+
+bool numa_replication_active() {
+    return replication_enabled && numa_placement_active();
+}
+
+unsigned numa_node_of_worker(unsigned worker, unsigned workers) {
+    const size_t nodes = NumaTopology::system().nodes();
+    if (workers == 0 || nodes <= 1) return 0;
+    return static_cast<unsigned>(static_cast<size_t>(worker) * nodes / workers);
+}
+
+bool pin_thread_to_node(unsigned node) {
+#ifdef __linux__
+    const NumaTopology& topology = NumaTopology::system();
+    if (node >= topology.nodes()) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (unsigned cpu : topology.node_cpus[node]) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+bool pin_thread_to_cpu(unsigned cpu) {
+#ifdef __linux__
+    if (cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+ThreadAffinityGuard::ThreadAffinityGuard() {
+#ifdef __linux__
+    cpu_set_t set;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+        saved_.resize(sizeof(set));
+        std::memcpy(saved_.data(), &set, sizeof(set));
+    }
+#endif
+}
+
+ThreadAffinityGuard::~ThreadAffinityGuard() {
+#ifdef __linux__
+    if (saved_.size() == sizeof(cpu_set_t)) {
+        cpu_set_t set;
+        std::memcpy(&set, saved_.data(), sizeof(set));
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#endif
+}
+
+void run_on_numa_node(unsigned node, const std::function<void()>& fn) {
+    std::thread([&]() {
+        pin_thread_to_node(node);
+        fn();
+    }).join();
+}
@@ -0,0 +1,83 @@
+#include "order_statistics_window.h"
+#include <algorithm>
+#include <iterator>
+
+OrderStatisticWindow::OrderStatisticWindow(const std::vector<double>& universe)
+    : OrderStatisticWindow(universe.data(), universe.size()) {}
+
+OrderStatisticWindow::OrderStatisticWindow(const double* universe, size_t n) {
+    // A NaN would break the ordering the sort and searches rely on
+    std::copy_if(universe, universe + n, std::back_inserter(values_), is_finite);
+    std::sort(values_.begin(), values_.end());
+    values_.erase(std::unique(values_.begin(), values_.end()), values_.end());
+    count_tree_.assign(values_.size() + 1, 0);
+    sum_tree_.assign(values_.size() + 1, CompensatedSum{});
+    while (top_bit_ * 2 <= values_.size()) top_bit_ *= 2;
+}
+
+size_t OrderStatisticWindow::rank_of(double value) const {
+    return static_cast<size_t>(std::lower_bound(values_.begin(), values_.end(), value) - values_.begin());
+}
+
+void OrderStatisticWindow::update(size_t rank, long count_delta, double value_delta) {
+    for (size_t i = rank + 1; i < count_tree_.size(); i += i & (~i + 1)) {
+        count_tree_[i] += count_delta;
+        sum_tree_[i].add(value_delta);
+    }
+}
+
+void OrderStatisticWindow::insert(double value) {
+    if (!is_finite(value)) return;
+    update(rank_of(value), 1, value);
+    ++size_;
+}
+
+void OrderStatisticWindow::erase(double value) {
+    if (size_ == 0 || !is_finite(value)) return;
+    update(rank_of(value), -1, -value);
+    --size_;
+}
+
+size_t OrderStatisticWindow::count_less(double value) const {
+    long count = 0;
+    for (size_t i = rank_of(value); i > 0; i -= i & (~i + 1)) count += count_tree_[i];
+    return static_cast<size_t>(count);
+}
+
+size_t OrderStatisticWindow::lower_rank_for(size_t k) const {
+    size_t pos = 0;
+    long remaining = static_cast<long>(k);
+    for (size_t step = top_bit_; step > 0; step >>= 1) {
+        size_t next = pos + step;
+        if (next < count_tree_.size() && count_tree_[next] <= remaining) {
+            pos = next;
+            remaining -= count_tree_[next];
+        }
+    }
+    return pos;
+}
+
+double OrderStatisticWindow::kth_smallest(size_t k) const {
+    if (k >= size_) return 0.0;
+    return values_[lower_rank_for(k)];
+}
+
+double OrderStatisticWindow::sum_smallest(size_t k) const {
+    if (size_ == 0 || k == 0) return 0.0;
+    k = std::min(k, size_);
+
+    // Walk the trees once, collecting the count/sum of all ranks below the k-th value
+    size_t pos = 0;
+    long remaining = static_cast<long>(k);
+    double sum = 0.0;
+    for (size_t step = top_bit_; step > 0; step >>= 1) {
+        size_t next = pos + step;
+        if (next < count_tree_.size() && count_tree_[next] < remaining) {
+            pos = next;
+            remaining -= count_tree_[next];
+            sum += sum_tree_[next].value();
+        }
+    }
+    // The remaining items all sit at rank `pos`
+    return sum + remaining * values_[pos];
+}
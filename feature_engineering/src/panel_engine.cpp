@@ -0,0 +1,358 @@
+#include "panel_engine.h"
+#include "machine_profile.h"
+#include "rolling_moments.h"
+#include "timestamp_decoder.h"
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+// Index bars per parallel task in the per-bar stages
+constexpr size_t kSliceBars = 256;
+
+unsigned worker_count(unsigned threads) {
+    return threads ? threads : tuned_threads();
+}
+
+// Runs body(begin, end) over [0, count) in parallel slices of kSliceBars
+template <typename Body>
+void for_each_slice(unsigned threads, size_t count, Body body) {
+    const size_t slices = (count + kSliceBars - 1) / kSliceBars;
+    WorkStealingPool pool(worker_count(threads));
+    pool.run(std::vector<size_t>(slices, 1), [&](size_t slice, unsigned) {
+        const size_t begin = slice * kSliceBars;
+        body(begin, std::min(count, begin + kSliceBars));
+    });
+}
+
+// Running sums over the last `window` (x, y) pairs
+class PairWindow {
+public:
+    explicit PairWindow(size_t window) : window_(window), x_(window), y_(window) {}
+
+    void push(double x, double y) {
+        if (count_ == window_) {
+            const double ox = x_[head_], oy = y_[head_];
+            accumulate(-ox, -oy, -ox * ox, -oy * oy, -ox * oy);
+        } else {
+            ++count_;
+        }
+        x_[head_] = x;
+        y_[head_] = y;
+        head_ = (head_ + 1) % window_;
+        accumulate(x, y, x * x, y * y, x * y);
+    }
+
+    bool full() const { return count_ == window_; }
+
+    // Least-squares slope of y on x, as TechnicalIndicators::beta_to_market_60
+    double beta() const {
+        const double n = static_cast<double>(window_);
+        const double den = n * sxx_.value() - sx_.value() * sx_.value();
+        return den > 0 ? (n * sxy_.value() - sx_.value() * sy_.value()) / den : 0.0;
+    }
+
+    double correlation() const {
+        const double n = static_cast<double>(window_);
+        const double vx = n * sxx_.value() - sx_.value() * sx_.value();
+        const double vy = n * syy_.value() - sy_.value() * sy_.value();
+        return (vx > 0 && vy > 0) ? (n * sxy_.value() - sx_.value() * sy_.value()) / std::sqrt(vx * vy) : 0.0;
+    }
+
+private:
+    void accumulate(double x, double y, double xx, double yy, double xy) {
+        sx_.add(x);
+        sy_.add(y);
+        sxx_.add(xx);
+        syy_.add(yy);
+        sxy_.add(xy);
+    }
+
+    size_t window_;
+    size_t count_ = 0;
+    size_t head_ = 0;
+    std::vector<double> x_, y_;
+    CompensatedSum sx_, sy_, sxx_, syy_, sxy_;
+};
+
+std::vector<std::string> split_csv_line(const std::string& line) {
+    std::vector<std::string> fields;
+    std::stringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, ',')) {
+        if (!field.empty() && field.back() == '\r') field.pop_back();
+        fields.push_back(field);
+    }
+    return fields;
+}
+}
+
+PanelEngine::PanelEngine(PanelConfig config) : config_(std::move(config)) {}
+
+void PanelEngine::add_series(const std::string& symbol, const std::vector<time_point>& timestamps,
+                             const std::vector<double>& close) {
+    if (close.empty() || timestamps.size() != close.size()) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    series_.push_back({symbol, timestamps, close, {}, {}, {}});
+}
+
+void PanelEngine::add_factor(const std::string& name, const std::vector<time_point>& timestamps,
+                             const std::vector<double>& returns) {
+    if (timestamps.size() != returns.size()) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    factors_.push_back({name, timestamps, returns});
+}
+
+void PanelEngine::load_factors(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) throw std::runtime_error("Cannot open factor file: " + path);
+    std::string line;
+    if (!std::getline(file, line)) return;
+    const std::vector<std::string> header = split_csv_line(line);
+    if (header.size() < 2) return;
+
+    std::vector<Factor> factors(header.size() - 1);
+    for (size_t f = 0; f < factors.size(); ++f) factors[f].name = header[f + 1];
+    TimestampDecoder decoder;
+    while (std::getline(file, line)) {
+        const std::vector<std::string> fields = split_csv_line(line);
+        if (fields.empty() || fields[0].empty()) continue;
+        const time_point timestamp = decoder.decode(fields[0]);
+        for (size_t f = 0; f < factors.size() && f + 1 < fields.size(); ++f) {
+            if (fields[f + 1].empty()) continue;
+            char* end = nullptr;
+            const double value = std::strtod(fields[f + 1].c_str(), &end);
+            if (end == fields[f + 1].c_str()) continue;
+            factors[f].timestamps.push_back(timestamp);
+            factors[f].returns.push_back(value);
+        }
+    }
+    for (auto& factor : factors) add_factor(factor.name, factor.timestamps, factor.returns);
+}
+
+std::unordered_map<std::string, std::string> PanelEngine::load_sectors(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) throw std::runtime_error("Cannot open sector file: " + path);
+    std::unordered_map<std::string, std::string> sectors;
+    std::string line;
+    while (std::getline(file, line)) {
+        const std::vector<std::string> fields = split_csv_line(line);
+        if (fields.size() >= 2 && !fields[0].empty()) sectors[fields[0]] = fields[1];
+    }
+    return sectors;
+}
+
+void PanelEngine::build_index() {
+    // Workers add series in completion order; sort for reproducible output
+    std::sort(series_.begin(), series_.end(),
+              [](const PanelSeries& a, const PanelSeries& b) { return a.symbol < b.symbol; });
+
+    index_.clear();
+    for (const auto& series : series_) index_.insert(index_.end(), series.timestamps.begin(), series.timestamps.end());
+    std::sort(index_.begin(), index_.end());
+    index_.erase(std::unique(index_.begin(), index_.end()), index_.end());
+
+    for (auto& series : series_) {
+        series.position.resize(series.timestamps.size());
+        for (size_t i = 0; i < series.timestamps.size(); ++i) {
+            series.position[i] = std::lower_bound(index_.begin(), index_.end(), series.timestamps[i]) - index_.begin();
+        }
+    }
+}
+
+PanelEngine::Shared PanelEngine::mean_returns(const std::vector<size_t>& members) const {
+    const size_t bars = index_.size();
+    Shared mean{std::vector<double>(bars, 0.0), std::vector<unsigned char>(bars, 0)};
+    for_each_slice(config_.threads, bars, [&](size_t begin, size_t end) {
+        std::vector<double> sum(end - begin, 0.0);
+        std::vector<size_t> trading(end - begin, 0);
+        // Members in order, so every bar sums its returns in member order
+        for (size_t s : members) {
+            const std::vector<size_t>& position = series_[s].position;
+            const double* returns = returns_.data() + first_bar_[s];
+            for (size_t i = std::lower_bound(position.begin() + 1, position.end(), begin) - position.begin();
+                 i < position.size() && position[i] < end; ++i) {
+                sum[position[i] - begin] += returns[i];
+                ++trading[position[i] - begin];
+            }
+        }
+        for (size_t t = begin; t < end; ++t) {
+            if (trading[t - begin] == 0) continue;
+            mean.values[t] = sum[t - begin] / trading[t - begin];
+            mean.has[t] = 1;
+        }
+    });
+    return mean;
+}
+
+void PanelEngine::rank_momentum() {
+    // Replaces each bar's momenta with their cross-sectional percentile ranks
+    for_each_slice(config_.threads, index_.size(), [&](size_t begin, size_t end) {
+        // (bar in slice, momentum, slot in momentum_) of every series trading
+        // a bar of the slice, ordered by bar then momentum
+        struct Entry {
+            size_t bar;
+            double value;
+            size_t slot;
+        };
+        std::vector<Entry> entries;
+        for (size_t s = 0; s < series_.size(); ++s) {
+            const std::vector<size_t>& position = series_[s].position;
+            if (position.size() <= kMomentumWindow) continue;
+            for (size_t i = std::lower_bound(position.begin() + kMomentumWindow, position.end(), begin) - position.begin();
+                 i < position.size() && position[i] < end; ++i) {
+                entries.push_back({position[i], momentum_[first_bar_[s] + i], first_bar_[s] + i});
+            }
+        }
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+            return a.bar != b.bar ? a.bar < b.bar : a.value < b.value;
+        });
+        for (size_t row = 0; row < entries.size();) {
+            size_t row_end = row + 1;
+            while (row_end < entries.size() && entries[row_end].bar == entries[row].bar) ++row_end;
+            if (row_end - row == 1) {
+                momentum_[entries[row].slot] = 0.5;
+                row = row_end;
+                continue;
+            }
+            const double scale = 1.0 / (row_end - row - 1);
+            for (size_t k = row; k < row_end;) {
+                size_t tie_end = k + 1;
+                while (tie_end < row_end && entries[tie_end].value == entries[k].value) ++tie_end;
+                const double rank = 0.5 * ((k - row) + (tie_end - row) - 1) * scale;
+                for (size_t j = k; j < tie_end; ++j) momentum_[entries[j].slot] = rank;
+                k = tie_end;
+            }
+            row = row_end;
+        }
+    });
+}
+
+void PanelEngine::compute_series(size_t s, const Shared& market, const std::vector<double>& market_level,
+                                 const Shared& sector, const std::vector<Shared>& factors) {
+    PanelSeries& series = series_[s];
+    const size_t n = series.close.size();
+    const double* returns = returns_.data() + first_bar_[s];
+    series.columns.assign(column_names_.size(), {});
+    series.offsets.assign(column_names_.size(), n);
+
+    auto& rank = series.columns[0];
+    series.offsets[0] = std::min(n, kMomentumWindow);
+    rank.assign(momentum_.begin() + first_bar_[s] + series.offsets[0], momentum_.begin() + first_bar_[s] + n);
+
+    // Rolling statistics against a shared series; a bar without a shared
+    // return keeps the window (and value) of the previous bar
+    auto rolling = [&](size_t column, const Shared& shared, size_t window, bool correlation) {
+        PairWindow pairs(window);
+        auto& out = series.columns[column];
+        for (size_t i = 1; i < n; ++i) {
+            const size_t t = series.position[i];
+            if (shared.has[t]) pairs.push(shared.values[t], returns[i]);
+            if (!pairs.full()) continue;
+            if (out.empty()) series.offsets[column] = i;
+            out.push_back(correlation ? pairs.correlation() : pairs.beta());
+        }
+    };
+    rolling(1, market, kMarketBetaWindow, false);
+
+    // Same span as TechnicalIndicators::relative_strength_spx_50
+    const size_t span = kRelativeStrengthWindow - 1;
+    auto& strength = series.columns[2];
+    series.offsets[2] = std::min(n, span);
+    for (size_t i = span; i < n; ++i) {
+        const double base = series.close[i - span];
+        const double stock_return = base > 0 ? (series.close[i] - base) / base : 0.0;
+        const double market_return = market_level[series.position[i]] / market_level[series.position[i - span]] - 1.0;
+        strength.push_back(stock_return - market_return);
+    }
+
+    rolling(3, sector, kSectorCorrelationWindow, true);
+    for (size_t f = 0; f < factors.size(); ++f) rolling(4 + f, factors[f], kFactorBetaWindow, false);
+}
+
+void PanelEngine::compute() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    build_index();
+    const size_t bars = index_.size(), count = series_.size();
+    std::vector<size_t> ids(count), lengths(count);
+    std::iota(ids.begin(), ids.end(), 0);
+    for (size_t s = 0; s < count; ++s) lengths[s] = series_[s].close.size();
+    WorkStealingPool pool(worker_count(config_.threads));
+
+    // Per-series returns and 20-bar mean returns, each series in its own range
+    first_bar_.resize(count);
+    size_t total = 0;
+    for (size_t s = 0; s < count; ++s) {
+        first_bar_[s] = total;
+        total += lengths[s];
+    }
+    returns_.assign(total, 0.0);
+    momentum_.assign(total, 0.0);
+    pool.run(lengths, [&](size_t s, unsigned) {
+        const PanelSeries& series = series_[s];
+        CompensatedSum window_sum;
+        double* own = returns_.data() + first_bar_[s];
+        double* momentum = momentum_.data() + first_bar_[s];
+        for (size_t i = 1; i < series.close.size(); ++i) {
+            const double prev = series.close[i - 1];
+            own[i] = prev > 0 ? (series.close[i] - prev) / prev : 0.0;
+            window_sum.add(own[i]);
+            if (i > kMomentumWindow) window_sum.add(-own[i - kMomentumWindow]);
+            if (i >= kMomentumWindow) momentum[i] = window_sum.value() / kMomentumWindow;
+        }
+    });
+    rank_momentum();
+
+    Shared market;
+    auto market_it = std::find_if(series_.begin(), series_.end(),
+                                  [&](const PanelSeries& series) { return series.symbol == config_.market_symbol; });
+    if (!config_.market_symbol.empty() && market_it != series_.end()) {
+        market = mean_returns({static_cast<size_t>(market_it - series_.begin())});
+    } else {
+        market = mean_returns(ids);
+    }
+    // Compounded market level, flat across bars without a market return
+    std::vector<double> market_level(bars, 1.0);
+    for (size_t t = 0; t < bars; ++t) {
+        const double previous = t > 0 ? market_level[t - 1] : 1.0;
+        market_level[t] = market.has[t] ? previous * (1.0 + market.values[t]) : previous;
+    }
+
+    std::vector<std::string> sector_names;
+    std::vector<size_t> sector_of(count);
+    for (size_t s = 0; s < count; ++s) {
+        auto it = config_.sectors.find(series_[s].symbol);
+        const std::string name = it != config_.sectors.end() ? it->second : std::string();
+        auto pos = std::find(sector_names.begin(), sector_names.end(), name);
+        sector_of[s] = pos - sector_names.begin();
+        if (pos == sector_names.end()) sector_names.push_back(name);
+    }
+    std::vector<std::vector<size_t>> members(sector_names.size());
+    for (size_t s = 0; s < count; ++s) members[sector_of[s]].push_back(s);
+    std::vector<Shared> sectors;
+    for (const auto& group : members) sectors.push_back(mean_returns(group));
+
+    std::vector<Shared> factors;
+    column_names_ = {"cross_sectional_momentum_rank_20", "beta_to_market_60",
+                     "relative_strength_spx_50", "correlation_to_sector_40"};
+    for (const auto& factor : factors_) {
+        Shared aligned{std::vector<double>(bars, 0.0), std::vector<unsigned char>(bars, 0)};
+        for (size_t k = 0; k < factor.timestamps.size(); ++k) {
+            auto it = std::lower_bound(index_.begin(), index_.end(), factor.timestamps[k]);
+            if (it == index_.end() || *it != factor.timestamps[k]) continue;
+            aligned.values[it - index_.begin()] = factor.returns[k];
+            aligned.has[it - index_.begin()] = 1;
+        }
+        factors.push_back(std::move(aligned));
+        column_names_.push_back(factor.name + "_beta_120");
+    }
+
+    pool.run(lengths, [&](size_t s, unsigned) {
+        compute_series(s, market, market_level, sectors[sector_of[s]], factors);
+    });
+}
@@ -0,0 +1,355 @@
+#include "regime_model.h"
+#include "machine_profile.h"
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+constexpr size_t K = HmmParams::kMaxStates;
+constexpr double kLogTwoPi = 1.8378770664093453;
+// Variances below this are treated as this (constant prices)
+constexpr double kMinVariance = 1e-12;
+// Fitted variances stay above this share of the sample variance
+constexpr double kVarianceFloorShare = 1e-3;
+// A bar whose scaled likelihood falls below this under every reachable state
+// is treated as uninformative rather than renormalized from round-off
+constexpr double kMinNormalizer = 1e-250;
+// Log density of the padding states; finite, as fast math assumes
+constexpr double kPaddingLogDensity = -1e300;
+// Bars whose emissions are computed together, ahead of the recursion
+constexpr size_t kBlock = 256;
+
+size_t clamp_states(size_t states) {
+    return std::min(std::max<size_t>(states, 1), K);
+}
+
+// Every state at `mean`, variances from half to twice `variance`
+HmmParams spread_params(double mean, double variance, size_t states) {
+    HmmParams params;
+    params.states = clamp_states(states);
+    const size_t n = params.states;
+    variance = std::max(variance, kMinVariance);
+    for (size_t i = 0; i < n; ++i) {
+        params.initial[i] = 1.0 / n;
+        params.mean[i] = mean;
+        params.variance[i] = n > 1 ? variance * std::exp2(2.0 * i / (n - 1) - 1.0) : variance;
+        for (size_t j = 0; j < n; ++j) {
+            params.transition[i][j] = n > 1 ? (i == j ? RegimeModel::kDefaultStay : (1.0 - RegimeModel::kDefaultStay) / (n - 1))
+                                            : 1.0;
+        }
+    }
+    return params;
+}
+
+void sample_moments(const double* x, size_t n, double& mean, double& variance) {
+    mean = 0.0;
+    variance = 0.0;
+    if (n == 0) return;
+    for (size_t i = 0; i < n; ++i) mean += x[i];
+    mean /= n;
+    for (size_t i = 0; i < n; ++i) variance += (x[i] - mean) * (x[i] - mean);
+    variance /= n;
+}
+
+// Expected counts of one E-step. Moments are taken around the means the
+// E-step ran with, which keeps the variance update free of cancellation.
+struct Sufficient {
+    double initial[K] = {};
+    double transitions[K][K] = {};
+    double weight[K] = {};
+    double sum[K] = {};
+    double sum_sq[K] = {};
+};
+
+// Scaled forward-backward. alpha[t * K + k] holds the filtered probabilities
+// and emission[t * K + k] the bar's emissions divided by its normalizer, so
+// the backward pass needs no further logs or exps: beta_t = A (e_{t+1} .*
+// beta_{t+1}), gamma_t = alpha_t .* beta_t, xi_t = alpha_t A .* (e_{t+1} .* beta_{t+1})'.
+// Posteriors go to out[k * n + t] if `out` is set, expected counts to
+// `stats` if set.
+double forward_backward(const double* x, size_t n, const HmmParams& params, std::vector<double>& alpha,
+                        std::vector<double>& emission, double* out, Sufficient* stats) {
+    const RegimeFilter::Step step(params);
+    const size_t states = step.states;
+    alpha.resize(n * K);
+    emission.resize(n * K);
+
+    RegimeFilter::LogLikelihood log_likelihood;
+    alignas(32) double predicted[K] = {};
+    std::copy(params.initial.begin(), params.initial.begin() + states, predicted);
+    double shift[kBlock];
+    for (size_t first = 0; first < n; first += kBlock) {
+        const size_t count = std::min(kBlock, n - first);
+        step.emissions(x + first, count, &emission[first * K], shift);
+        for (size_t t = first; t < first + count; ++t) {
+            log_likelihood.add(step.filter(predicted, shift[t - first], &emission[t * K], &alpha[t * K]));
+            step.predict(&alpha[t * K], predicted);
+        }
+    }
+
+    alignas(32) double beta[K] = {1.0, 1.0, 1.0, 1.0};
+    alignas(32) double weighted[K];
+    for (size_t t = n; t-- > 0;) {
+        const double* a = &alpha[t * K];
+        alignas(32) double gamma[K];
+        double total = 0.0;
+        for (size_t k = 0; k < K; ++k) {
+            gamma[k] = a[k] * beta[k];
+            total += gamma[k];
+        }
+        const double scale = total > 0 ? 1.0 / total : 0.0;
+        for (size_t k = 0; k < K; ++k) gamma[k] *= scale;
+
+        if (out) {
+            for (size_t k = 0; k < states; ++k) out[k * n + t] = gamma[k];
+        }
+        if (stats) {
+            for (size_t k = 0; k < K; ++k) {
+                const double d = x[t] - params.mean[k];
+                stats->weight[k] += gamma[k];
+                stats->sum[k] += gamma[k] * d;
+                stats->sum_sq[k] += gamma[k] * d * d;
+            }
+            if (t == 0) std::copy(gamma, gamma + K, stats->initial);
+        }
+        if (t == 0) break;
+
+        // Step back to t - 1
+        const double* e = &emission[t * K];
+        for (size_t k = 0; k < K; ++k) weighted[k] = e[k] * beta[k];
+        const double* previous = &alpha[(t - 1) * K];
+        for (size_t i = 0; i < K; ++i) {
+            double b = 0.0;
+            for (size_t j = 0; j < K; ++j) {
+                const double term = step.transition[i][j] * weighted[j];
+                b += term;
+                if (stats) stats->transitions[i][j] += previous[i] * term;
+            }
+            beta[i] = b;
+        }
+    }
+    return log_likelihood.value();
+}
+
+// Re-estimates `params` from one E-step's expected counts
+void maximize(const Sufficient& stats, double variance_floor, HmmParams& params) {
+    const size_t states = params.states;
+    double initial_total = 0.0;
+    for (size_t i = 0; i < states; ++i) {
+        params.initial[i] = std::max(stats.initial[i], RegimeModel::kMinTransition);
+        initial_total += params.initial[i];
+    }
+    for (size_t i = 0; i < states; ++i) params.initial[i] /= initial_total;
+
+    for (size_t i = 0; i < states; ++i) {
+        double row = 0.0;
+        for (size_t j = 0; j < states; ++j) row += stats.transitions[i][j];
+        if (!(row > 0)) continue;
+        double floored = 0.0;
+        for (size_t j = 0; j < states; ++j) {
+            params.transition[i][j] = std::max(stats.transitions[i][j] / row, RegimeModel::kMinTransition);
+            floored += params.transition[i][j];
+        }
+        for (size_t j = 0; j < states; ++j) params.transition[i][j] /= floored;
+    }
+
+    for (size_t k = 0; k < states; ++k) {
+        // A state that lost all its weight keeps its previous emission
+        if (!(stats.weight[k] > 1e-12)) continue;
+        const double shift = stats.sum[k] / stats.weight[k];
+        params.variance[k] = std::max(stats.sum_sq[k] / stats.weight[k] - shift * shift, variance_floor);
+        params.mean[k] += shift;
+    }
+}
+
+// Renumbers the states by ascending variance
+HmmParams order_by_variance(const HmmParams& params) {
+    const size_t states = params.states;
+    size_t order[K];
+    std::iota(order, order + states, size_t{0});
+    std::stable_sort(order, order + states, [&](size_t a, size_t b) { return params.variance[a] < params.variance[b]; });
+    HmmParams ordered;
+    ordered.states = states;
+    for (size_t i = 0; i < states; ++i) {
+        ordered.initial[i] = params.initial[order[i]];
+        ordered.mean[i] = params.mean[order[i]];
+        ordered.variance[i] = params.variance[order[i]];
+        for (size_t j = 0; j < states; ++j) ordered.transition[i][j] = params.transition[order[i]][order[j]];
+    }
+    return ordered;
+}
+
+}
+
+// RegimeFilter
+
+RegimeFilter::Step::Step(const HmmParams& params) : states(clamp_states(params.states)) {
+    for (size_t i = 0; i < K; ++i) {
+        const bool active = i < states;
+        const double variance = std::max(params.variance[i], kMinVariance);
+        mean[i] = active ? params.mean[i] : 0.0;
+        inv_variance[i] = active ? 1.0 / variance : 0.0;
+        // Padding states never hold the largest log density
+        log_norm[i] = active ? -0.5 * (kLogTwoPi + std::log(variance)) : kPaddingLogDensity;
+        for (size_t j = 0; j < K; ++j) transition[i][j] = active && j < states ? params.transition[i][j] : 0.0;
+    }
+}
+
+void RegimeFilter::LogLikelihood::add(const Normalizer& normalizer) {
+    log_sum_ += normalizer.shift;
+    // scale >= kMinNormalizer, so the product stays a normal number
+    if (product_ < 1e-50) {
+        log_sum_ += std::log(product_);
+        product_ = 1.0;
+    }
+    product_ *= normalizer.scale;
+}
+
+double RegimeFilter::LogLikelihood::value() const {
+    return log_sum_ + std::log(product_);
+}
+
+void RegimeFilter::Step::emissions(const double* returns, size_t count, double* emission, double* shift) const {
+    for (size_t t = 0; t < count; ++t) {
+        alignas(32) double log_density[K];
+        for (size_t k = 0; k < K; ++k) {
+            const double d = returns[t] - mean[k];
+            log_density[k] = log_norm[k] - 0.5 * d * d * inv_variance[k];
+        }
+        double largest = log_density[0];
+        for (size_t k = 1; k < K; ++k) largest = std::max(largest, log_density[k]);
+        for (size_t k = 0; k < K; ++k) emission[t * K + k] = std::exp(log_density[k] - largest);
+        shift[t] = largest;
+    }
+}
+
+RegimeFilter::Normalizer RegimeFilter::Step::filter(const double* predicted, double shift, double* emission,
+                                                    double* filtered) const {
+    double total = 0.0;
+    for (size_t k = 0; k < K; ++k) {
+        filtered[k] = predicted[k] * emission[k];
+        total += filtered[k];
+    }
+    if (!(total > kMinNormalizer)) {
+        for (size_t k = 0; k < K; ++k) {
+            emission[k] = 1.0;
+            filtered[k] = predicted[k];
+        }
+        return {shift, kMinNormalizer};
+    }
+    const double scale = 1.0 / total;
+    for (size_t k = 0; k < K; ++k) {
+        emission[k] *= scale;
+        filtered[k] *= scale;
+    }
+    return {shift, total};
+}
+
+void RegimeFilter::Step::predict(const double* filtered, double* predicted) const {
+    alignas(32) double next[K] = {};
+    for (size_t i = 0; i < K; ++i) {
+        for (size_t j = 0; j < K; ++j) next[j] += filtered[i] * transition[i][j];
+    }
+    std::copy(next, next + K, predicted);
+}
+
+RegimeFilter::RegimeFilter(const HmmParams& params) : step_(params), states_(step_.states) {
+    for (size_t k = 0; k < states_; ++k) predicted_[k] = params.initial[k];
+}
+
+void RegimeFilter::update(double ret) {
+    alignas(32) double emission[K];
+    double shift;
+    step_.emissions(&ret, 1, emission, &shift);
+    log_likelihood_.add(step_.filter(predicted_.data(), shift, emission, probabilities_.data()));
+    step_.predict(probabilities_.data(), predicted_.data());
+    ++count_;
+}
+
+size_t RegimeFilter::most_likely() const {
+    return static_cast<size_t>(std::max_element(probabilities_.begin(), probabilities_.begin() + states_) -
+                               probabilities_.begin());
+}
+
+// RegimeModel
+
+HmmParams RegimeModel::default_params(const double* returns, size_t n, size_t states) {
+    double mean, variance;
+    sample_moments(returns, std::min(n, kWarmup), mean, variance);
+    return spread_params(mean, variance, states);
+}
+
+void RegimeModel::filter(const double* returns, size_t n, const HmmParams& params, double* out) {
+    // RegimeFilter::update, a block of emissions at a time
+    const RegimeFilter::Step step(params);
+    const size_t states = step.states;
+    alignas(32) double predicted[K] = {};
+    std::copy(params.initial.begin(), params.initial.begin() + states, predicted);
+    alignas(32) double emission[kBlock * K];
+    alignas(32) double filtered[K];
+    double shift[kBlock];
+    for (size_t first = 0; first < n; first += kBlock) {
+        const size_t count = std::min(kBlock, n - first);
+        step.emissions(returns + first, count, emission, shift);
+        for (size_t i = 0; i < count; ++i) {
+            step.filter(predicted, shift[i], &emission[i * K], filtered);
+            step.predict(filtered, predicted);
+            for (size_t k = 0; k < states; ++k) out[k * n + first + i] = filtered[k];
+        }
+    }
+}
+
+std::vector<double> RegimeModel::most_likely_states(const std::vector<double>& probabilities, size_t states) {
+    if (states == 0) return {};
+    const size_t n = probabilities.size() / states;
+    std::vector<double> result(n, 0.0);
+    for (size_t t = 0; t < n; ++t) {
+        size_t best = 0;
+        for (size_t k = 1; k < states; ++k) {
+            if (probabilities[k * n + t] > probabilities[best * n + t]) best = k;
+        }
+        result[t] = static_cast<double>(best);
+    }
+    return result;
+}
+
+double RegimeModel::smooth(const double* returns, size_t n, const HmmParams& params, double* out) {
+    std::vector<double> alpha, emission;
+    return forward_backward(returns, n, params, alpha, emission, out, nullptr);
+}
+
+HmmParams RegimeModel::fit(const std::vector<double>& returns, size_t states) {
+    const size_t n = returns.size();
+    if (n < kMinFitReturns) return default_params(returns.data(), n, states);
+    double mean, variance;
+    sample_moments(returns.data(), n, mean, variance);
+    if (!(variance > kMinVariance)) return default_params(returns.data(), n, states);
+
+    HmmParams params = spread_params(mean, variance, states);
+    const double variance_floor = kVarianceFloorShare * variance;
+    std::vector<double> alpha, emission;
+    double previous = 0.0;
+    for (size_t iteration = 0; iteration < kMaxIterations; ++iteration) {
+        Sufficient stats;
+        const double log_likelihood = forward_backward(returns.data(), n, params, alpha, emission, nullptr, &stats);
+        if (iteration > 0 && log_likelihood - previous < kTolerance * std::abs(log_likelihood)) break;
+        previous = log_likelihood;
+        maximize(stats, variance_floor, params);
+    }
+    return order_by_variance(params);
+}
+
+std::vector<HmmParams> RegimeModel::fit_batch(const std::vector<std::vector<double>>& returns, size_t states) {
+    std::vector<HmmParams> params(returns.size());
+    std::vector<size_t> lengths;
+    for (const auto& series : returns) lengths.push_back(series.size());
+    WorkStealingPool pool(tuned_threads());
+    pool.run(lengths, [&](size_t i, unsigned) { params[i] = fit(returns[i], states); });
+    return params;
+}
+
+RegimeFeatureParams RegimeModel::fit_features(const std::vector<double>& returns) {
+    return {fit(returns, 2), fit(returns, 3)};
+}
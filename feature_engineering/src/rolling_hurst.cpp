@@ -0,0 +1,210 @@
+#include "rolling_hurst.h"
+#include <algorithm>
+#include <cmath>
+
+RollingHurst::RollingHurst(size_t window, std::vector<size_t> lags) : window_(window), lags_(std::move(lags)) {
+    lags_.erase(std::remove_if(lags_.begin(), lags_.end(), [&](size_t lag) { return lag < 2 || lag > window_; }),
+                lags_.end());
+    std::sort(lags_.begin(), lags_.end());
+    lags_.erase(std::unique(lags_.begin(), lags_.end()), lags_.end());
+    log_length_.resize(window_ + 1);
+    for (size_t m = 1; m <= window_; ++m) log_length_[m] = std::log(static_cast<double>(m));
+}
+
+void RollingHurst::UpperHull::push(double px, double py) {
+    // Drop the last vertex while it lies on or under the segment to the new point
+    while (x.size() >= 2) {
+        const size_t b = x.size() - 1, a = b - 1;
+        if ((x[b] - x[a]) * (py - y[a]) - (y[b] - y[a]) * (px - x[a]) < 0) break;
+        x.pop_back();
+        y.pop_back();
+    }
+    x.push_back(px);
+    y.push_back(py);
+}
+
+double RollingHurst::UpperHull::max(double slope) const {
+    // y - slope * x is concave along the hull: find the first edge no steeper than slope
+    size_t lo = 0, hi = x.size() - 1;
+    while (lo < hi) {
+        const size_t mid = (lo + hi) / 2;
+        if (y[mid + 1] - y[mid] <= slope * (x[mid + 1] - x[mid])) hi = mid;
+        else lo = mid + 1;
+    }
+    return y[lo] - slope * x[lo];
+}
+
+double RollingHurst::rescaled_range(size_t begin, size_t length, double sum) const {
+    const double* x = logs_.data() + begin;
+    const double mean = sum / length;
+    double cumulative = 0.0, range = 0.0, squares = 0.0;
+    for (size_t k = 0; k < length; ++k) {
+        cumulative += x[k];
+        range = std::max(range, std::abs(cumulative - (k + 1) * mean));
+        const double d = x[k] - mean;
+        squares += d * d;
+    }
+    const double std_dev = std::sqrt(squares / (length - 1));
+    return std_dev > 0 ? range / std_dev : 1.0;
+}
+
+double RollingHurst::multi_scale(size_t lo, size_t hi) const {
+    double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+    size_t points = 0;
+    for (size_t j = 0; j < lags_.size(); ++j) {
+        const size_t lag = lags_[j];
+        // Chunks [first, last) lie wholly inside logs_[lo, hi)
+        const size_t first = (lo + lag - 1) / lag, last = hi / lag;
+        if (last <= first) continue;
+        const double* prefix = chunk_prefix_.data() + chunk_offset_[j];
+        const double mean_rs = (prefix[last] - prefix[first]) / (last - first);
+        if (mean_rs <= 0) continue;
+        const double x = std::log(static_cast<double>(lag)), y = std::log(mean_rs);
+        sx += x; sy += y; sxx += x * x; sxy += x * y;
+        ++points;
+    }
+    if (points < 2) return 0.5;
+    const double den = points * sxx - sx * sx;
+    if (den <= 0) return 0.5;
+    return std::max(0.0, std::min(1.0, (points * sxy - sx * sy) / den));
+}
+
+size_t RollingHurst::compute(const double* prices, size_t n, double* out) {
+    if (window_ == 0 || n < window_) return 0;
+
+    logs_.clear();
+    valid_.resize(n + 1);
+    valid_[0] = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (prices[i] > 0) logs_.push_back(std::log(prices[i]));
+        valid_[i + 1] = logs_.size();
+    }
+
+    chunk_prefix_.clear();
+    chunk_offset_.clear();
+    for (size_t lag : lags_) {
+        chunk_offset_.push_back(chunk_prefix_.size());
+        double total = 0.0;
+        chunk_prefix_.push_back(total);
+        for (size_t begin = 0; begin + lag <= logs_.size(); begin += lag) {
+            double sum = 0.0;
+            for (size_t k = 0; k < lag; ++k) sum += logs_[begin + k];
+            total += rescaled_range(begin, lag, sum);
+            chunk_prefix_.push_back(total);
+        }
+    }
+
+    // Positive prices of window k are logs_[valid_[k], valid_[k + window])
+    const size_t count = n - window_ + 1;
+    if (!lags_.empty()) {
+        for (size_t k = 0; k < count; ++k) {
+            const size_t lo = valid_[k], hi = valid_[k + window_];
+            out[k] = hi - lo < kMinPrices ? 0.5 : multi_scale(lo, hi);
+        }
+        return count;
+    }
+
+    lo_.resize(count);
+    hi_.resize(count);
+    for (size_t k = 0; k < count; ++k) {
+        lo_[k] = valid_[k];
+        hi_[k] = valid_[k + window_];
+    }
+    // Window k's cumulative sums sit at positions lo + 1 .. hi; runs share
+    // the first multiple of the window length among them
+    auto boundary = [&](size_t k) { return (lo_[k] / window_ + 1) * window_; };
+    for (size_t first = 0; first < count;) {
+        const size_t t = boundary(first);
+        size_t last = first + 1;
+        while (last < count && boundary(last) == t) ++last;
+        single_scale_run(first, last, t, out);
+        first = last;
+    }
+    return count;
+}
+
+double RollingHurst::hurst_of(double rs, size_t m) const {
+    const double hurst = rs > 0 ? std::log(rs) / log_length_[m] : 0.5;
+    return std::max(0.0, std::min(1.0, hurst));
+}
+
+void RollingHurst::single_scale_run(size_t first, size_t last, size_t t, double* out) {
+    // Windows too short, or short enough to miss t, are settled here
+    size_t end = t;
+    bool any = false;
+    for (size_t k = first; k < last; ++k) {
+        const size_t m = hi_[k] - lo_[k];
+        if (m < kMinPrices) {
+            out[k] = 0.5;
+        } else if (hi_[k] < t) {
+            double sum = 0.0;
+            for (size_t i = lo_[k]; i < hi_[k]; ++i) sum += logs_[i];
+            out[k] = hurst_of(rescaled_range(lo_[k], m, sum), m);
+        } else {
+            end = std::max(end, hi_[k]);
+            any = true;
+        }
+    }
+    if (!any) return;
+    auto in_run = [&](size_t k) { return hi_[k] - lo_[k] >= kMinPrices && hi_[k] >= t; };
+
+    // Prefix sums over positions [t - window, end], of values taken relative
+    // to a log inside the run so that they stay small
+    const size_t base = t - window_;
+    const double anchor = logs_[t - 1];
+    local_sum_.assign(end - base + 1, 0.0);
+    local_squares_.assign(end - base + 1, 0.0);
+    for (size_t j = base; j < end; ++j) {
+        const double d = logs_[j] - anchor;
+        local_sum_[j - base + 1] = local_sum_[j - base] + d;
+        local_squares_[j - base + 1] = local_squares_[j - base] + d * d;
+    }
+    const double* sums = local_sum_.data() - base;
+    auto mean_of = [&](size_t k) { return (sums[hi_[k]] - sums[lo_[k]]) / (hi_[k] - lo_[k]); };
+
+    // Extremes of sums[j] - mean * (j - t) over positions lo + 1 .. t - 1,
+    // sweeping down from t so each window's positions are on the hulls
+    // (x = t - j, increasing as points are added)
+    before_max_.resize(last - first);
+    before_min_.resize(last - first);
+    upper_.clear();
+    lower_.clear();
+    size_t j = t;
+    for (size_t k = last; k-- > first;) {
+        if (!in_run(k)) continue;
+        for (; j > lo_[k] + 1; --j) {
+            const double x = static_cast<double>(t - (j - 1));
+            upper_.push(x, sums[j - 1]);
+            lower_.push(x, -sums[j - 1]);
+        }
+        const double mean = mean_of(k);
+        const bool empty = upper_.x.empty();
+        before_max_[k - first] = empty ? -HUGE_VAL : upper_.max(-mean);
+        before_min_[k - first] = empty ? HUGE_VAL : -lower_.max(mean);
+    }
+
+    // The same over positions t .. hi, sweeping up (x = j - t), then the
+    // window's R/S
+    upper_.clear();
+    lower_.clear();
+    j = t;
+    for (size_t k = first; k < last; ++k) {
+        if (!in_run(k)) continue;
+        for (; j <= hi_[k]; ++j) {
+            const double x = static_cast<double>(j - t);
+            upper_.push(x, sums[j]);
+            lower_.push(x, -sums[j]);
+        }
+        const size_t m = hi_[k] - lo_[k];
+        const double mean = mean_of(k);
+        const double highest = std::max(before_max_[k - first], upper_.max(mean));
+        const double lowest = std::min(before_min_[k - first], -lower_.max(-mean));
+        // Cumulative deviation at position j is sums[j] - mean * (j - t) minus this
+        const double origin = sums[lo_[k]] + mean * (static_cast<double>(t) - static_cast<double>(lo_[k]));
+        const double range = std::max({0.0, highest - origin, origin - lowest});
+
+        const double squares = std::max(0.0, (local_squares_[hi_[k] - base] - local_squares_[lo_[k] - base]) - m * mean * mean);
+        const double std_dev = std::sqrt(squares / (m - 1));
+        out[k] = hurst_of(std_dev > 0 ? range / std_dev : 1.0, m);
+    }
+}
@@ -0,0 +1,113 @@
+#include "rolling_moments.h"
+#include "fixed_window.h"
+#include <cmath>
+#include <algorithm>
+
+RollingMoments::RollingMoments(size_t window) : window_(std::max<size_t>(window, 1)), ring_(window_, 0.0) {}
+
+void RollingMoments::reset() {
+    count_ = 0;
+    head_ = 0;
+    since_resync_ = 0;
+    anchor_ = 0.0;
+    s1_.reset(); s2_.reset(); s3_.reset(); s4_.reset();
+}
+
+void RollingMoments::accumulate(double d, double sign) {
+    double d2 = d * d;
+    s1_.add(sign * d);
+    s2_.add(sign * d2);
+    s3_.add(sign * d2 * d);
+    s4_.add(sign * d2 * d2);
+}
+
+void RollingMoments::push(double x) {
+    if (count_ == 0) anchor_ = x;
+
+    if (count_ < window_) {
+        ring_[(head_ + count_) % window_] = x;
+        ++count_;
+    } else {
+        accumulate(ring_[head_] - anchor_, -1.0);
+        ring_[head_] = x;
+        head_ = (head_ + 1) % window_;
+    }
+    accumulate(x - anchor_, 1.0);
+
+    if (++since_resync_ >= window_ && full()) resync();
+}
+
+FIXED_WINDOW_KERNEL size_t RollingMoments::push_stddev(const double* values, size_t n, double* out) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        push(values[i]);
+        if (full()) out[count++] = std::sqrt(sample_variance());
+    }
+    return count;
+}
+
+void RollingMoments::resync() {
+    since_resync_ = 0;
+    double total = 0.0;
+    for (size_t j = 0; j < count_; ++j) total += ring_[j];
+    anchor_ = total / count_;
+
+    s1_.reset(); s2_.reset(); s3_.reset(); s4_.reset();
+    for (size_t j = 0; j < count_; ++j) accumulate(ring_[j] - anchor_, 1.0);
+}
+
+double RollingMoments::newest() const {
+    return count_ == 0 ? 0.0 : ring_[(head_ + count_ - 1) % window_];
+}
+
+double RollingMoments::oldest() const {
+    return count_ == 0 ? 0.0 : ring_[head_];
+}
+
+double RollingMoments::sum() const {
+    return anchor_ * count_ + s1_.value();
+}
+
+double RollingMoments::mean() const {
+    return count_ == 0 ? 0.0 : anchor_ + s1_.value() / count_;
+}
+
+void RollingMoments::central_moments(double& m2, double& m3, double& m4) const {
+    m2 = m3 = m4 = 0.0;
+    if (count_ == 0) return;
+    const double n = static_cast<double>(count_);
+    const double mu = s1_.value() / n;
+    const double r2 = s2_.value() / n, r3 = s3_.value() / n, r4 = s4_.value() / n;
+    const double mu2 = mu * mu;
+
+    m2 = r2 - mu2;
+    // Treat round-off level variance as a flat window
+    if (m2 <= r2 * 1e-12) { m2 = 0.0; return; }
+    m3 = r3 - 3.0 * mu * r2 + 2.0 * mu2 * mu;
+    m4 = r4 - 4.0 * mu * r3 + 6.0 * mu2 * r2 - 3.0 * mu2 * mu2;
+}
+
+double RollingMoments::population_variance() const {
+    double m2, m3, m4;
+    central_moments(m2, m3, m4);
+    return m2;
+}
+
+double RollingMoments::sample_variance() const {
+    if (count_ < 2) return 0.0;
+    return population_variance() * count_ / (count_ - 1.0);
+}
+
+double RollingMoments::skewness() const {
+    double m2, m3, m4;
+    central_moments(m2, m3, m4);
+    if (m2 <= 0) return 0.0;
+    double std_dev = std::sqrt(m2);
+    return m3 / (std_dev * std_dev * std_dev);
+}
+
+double RollingMoments::excess_kurtosis() const {
+    double m2, m3, m4;
+    central_moments(m2, m3, m4);
+    return m2 > 0 ? (m4 / (m2 * m2)) - 3.0 : 0.0;
+}
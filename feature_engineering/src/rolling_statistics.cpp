@@ -0,0 +1,163 @@
+#include "rolling_statistics.h"
+#include "simd_dispatch.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+constexpr size_t kBlockRows = RollingStatistics::kBlockRows;
+
+// A centered sum of squares below this fraction of the raw one is round-off
+// of a window whose values are all equal
+constexpr double kFlatRatio = 1e-12;
+
+enum Moment : unsigned { kX, kY, kXX, kYY, kXY, kMoments };
+
+struct BlockScratch {
+    std::vector<double> hi, lo;     // prefix sums per moment, stride kBlockRows + window
+    std::vector<double> sums;       // window sums per moment, stride kBlockRows
+};
+
+// Window sums of the requested moments (bit m = Moment m) of x and y, less
+// their block's first values, block by block: finish(first, rows, sums,
+// shift_x, shift_y) gets the sums of moment m for windows first .. first +
+// rows - 1 at sums + m * kBlockRows
+template <class T, class Finish>
+void window_moments(const T* x, const T* y, size_t n, size_t window, unsigned moments, Finish&& finish) {
+    thread_local BlockScratch scratch;
+    const SimdKernels& kernels = simd_kernels();
+    const size_t stride = kBlockRows + window;
+    scratch.hi.resize(kMoments * stride);
+    scratch.lo.resize(kMoments * stride);
+    scratch.sums.resize(kMoments * kBlockRows);
+
+    const size_t windows = n - window + 1;
+    for (size_t first = 0; first < windows; first += kBlockRows) {
+        const size_t rows = std::min(kBlockRows, windows - first);
+        const size_t span = rows + window - 1;
+        const double shift_x = static_cast<double>(x[first]);
+        const double shift_y = y ? static_cast<double>(y[first]) : 0.0;
+
+        double total[kMoments] = {}, compensation[kMoments] = {};
+        for (unsigned m = 0; m < kMoments; ++m) {
+            if (moments & (1u << m)) scratch.hi[m * stride] = scratch.lo[m * stride] = 0.0;
+        }
+        for (size_t j = 0; j < span; ++j) {
+            const double dx = static_cast<double>(x[first + j]) - shift_x;
+            const double dy = y ? static_cast<double>(y[first + j]) - shift_y : 0.0;
+            const double terms[kMoments] = {dx, dy, dx * dx, dy * dy, dx * dy};
+            for (unsigned m = 0; m < kMoments; ++m) {
+                if (!(moments & (1u << m))) continue;
+                // Neumaier step, as CompensatedSum::add
+                const double t = total[m] + terms[m];
+                if (std::abs(total[m]) >= std::abs(terms[m])) compensation[m] += (total[m] - t) + terms[m];
+                else compensation[m] += (terms[m] - t) + total[m];
+                total[m] = t;
+                scratch.hi[m * stride + j + 1] = total[m];
+                scratch.lo[m * stride + j + 1] = compensation[m];
+            }
+        }
+        for (unsigned m = 0; m < kMoments; ++m) {
+            if (!(moments & (1u << m))) continue;
+            kernels.compensated_window_sums(scratch.hi.data() + m * stride, scratch.lo.data() + m * stride,
+                                            rows, window, scratch.sums.data() + m * kBlockRows);
+        }
+        finish(first, rows, scratch.sums.data(), shift_x, shift_y);
+    }
+}
+
+// Centered sum of squares from raw window sums, 0 when it is round-off
+double centered_squares(double sum, double sum_sq, double window) {
+    const double centered = sum_sq - sum * sum / window;
+    return centered > kFlatRatio * sum_sq ? centered : 0.0;
+}
+
+}
+
+template <class T>
+size_t RollingStatistics::sum(const T* x, size_t n, size_t window, double* out) {
+    if (window == 0 || n < window) return 0;
+    const double w = static_cast<double>(window);
+    window_moments(x, static_cast<const T*>(nullptr), n, window, 1u << kX,
+                   [&](size_t first, size_t rows, const double* sums, double shift, double) {
+        for (size_t r = 0; r < rows; ++r) out[first + r] = sums[r] + w * shift;
+    });
+    return n - window + 1;
+}
+
+template <class T>
+size_t RollingStatistics::mean(const T* x, size_t n, size_t window, double* out) {
+    if (window == 0 || n < window) return 0;
+    const double w = static_cast<double>(window);
+    window_moments(x, static_cast<const T*>(nullptr), n, window, 1u << kX,
+                   [&](size_t first, size_t rows, const double* sums, double shift, double) {
+        for (size_t r = 0; r < rows; ++r) out[first + r] = shift + sums[r] / w;
+    });
+    return n - window + 1;
+}
+
+template <class T>
+size_t RollingStatistics::variance(const T* x, size_t n, size_t window, double* out) {
+    if (window < 2 || n < window) return 0;
+    const double w = static_cast<double>(window);
+    window_moments(x, static_cast<const T*>(nullptr), n, window, (1u << kX) | (1u << kXX),
+                   [&](size_t first, size_t rows, const double* sums, double, double) {
+        const double* sx = sums + kX * kBlockRows;
+        const double* sxx = sums + kXX * kBlockRows;
+        for (size_t r = 0; r < rows; ++r) out[first + r] = centered_squares(sx[r], sxx[r], w) / (w - 1.0);
+    });
+    return n - window + 1;
+}
+
+template <class T>
+size_t RollingStatistics::stddev(const T* x, size_t n, size_t window, double* out) {
+    const size_t count = variance(x, n, window, out);
+    for (size_t i = 0; i < count; ++i) out[i] = std::sqrt(out[i]);
+    return count;
+}
+
+template <class T>
+size_t RollingStatistics::covariance(const T* x, const T* y, size_t n, size_t window, double* out) {
+    if (window < 2 || n < window) return 0;
+    const double w = static_cast<double>(window);
+    window_moments(x, y, n, window, (1u << kX) | (1u << kY) | (1u << kXY),
+                   [&](size_t first, size_t rows, const double* sums, double, double) {
+        const double* sx = sums + kX * kBlockRows;
+        const double* sy = sums + kY * kBlockRows;
+        const double* sxy = sums + kXY * kBlockRows;
+        for (size_t r = 0; r < rows; ++r) out[first + r] = (sxy[r] - sx[r] * sy[r] / w) / (w - 1.0);
+    });
+    return n - window + 1;
+}
+
+template <class T>
+size_t RollingStatistics::correlation(const T* x, const T* y, size_t n, size_t window, double* out) {
+    if (window < 2 || n < window) return 0;
+    const double w = static_cast<double>(window);
+    window_moments(x, y, n, window, (1u << kMoments) - 1,
+                   [&](size_t first, size_t rows, const double* sums, double, double) {
+        const double* sx = sums + kX * kBlockRows;
+        const double* sy = sums + kY * kBlockRows;
+        const double* sxx = sums + kXX * kBlockRows;
+        const double* syy = sums + kYY * kBlockRows;
+        const double* sxy = sums + kXY * kBlockRows;
+        for (size_t r = 0; r < rows; ++r) {
+            const double vx = centered_squares(sx[r], sxx[r], w);
+            const double vy = centered_squares(sy[r], syy[r], w);
+            out[first + r] = vx > 0.0 && vy > 0.0 ? (sxy[r] - sx[r] * sy[r] / w) / std::sqrt(vx * vy) : 0.0;
+        }
+    });
+    return n - window + 1;
+}
+
+#define ROLLING_STATISTICS_INSTANTIATE(T) \
+    template size_t RollingStatistics::sum<T>(const T*, size_t, size_t, double*); \
+    template size_t RollingStatistics::mean<T>(const T*, size_t, size_t, double*); \
+    template size_t RollingStatistics::variance<T>(const T*, size_t, size_t, double*); \
+    template size_t RollingStatistics::stddev<T>(const T*, size_t, size_t, double*); \
+    template size_t RollingStatistics::covariance<T>(const T*, const T*, size_t, size_t, double*); \
+    template size_t RollingStatistics::correlation<T>(const T*, const T*, size_t, size_t, double*);
+
+ROLLING_STATISTICS_INSTANTIATE(double)
+ROLLING_STATISTICS_INSTANTIATE(float)
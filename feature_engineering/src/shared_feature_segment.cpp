@@ -0,0 +1,259 @@
+#include "shared_feature_segment.h"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <stdexcept>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __APPLE__
+#include <filesystem>
+#endif
+
+namespace {
+size_t round_up(size_t value, size_t granule) {
+    return (value + granule - 1) / granule * granule;
+}
+
+std::runtime_error segment_error(const std::string& what, const std::string& name) {
+    return std::runtime_error(what + ": " + name);
+}
+
+#ifndef _WIN32
+// macOS cannot resize a POSIX shared-memory object once it is sized, so
+// segments there are files in the temp directory, mapped the same way
+int open_segment(const std::string& name, int flags, mode_t mode) {
+#ifdef __APPLE__
+    const auto path = std::filesystem::temp_directory_path() / name.substr(name.find_first_not_of('/'));
+    return open(path.c_str(), flags, mode);
+#else
+    return shm_open(name.c_str(), flags, mode);
+#endif
+}
+
+void unlink_segment(const std::string& name) {
+#ifdef __APPLE__
+    unlink((std::filesystem::temp_directory_path() / name.substr(name.find_first_not_of('/'))).c_str());
+#else
+    shm_unlink(name.c_str());
+#endif
+}
+
+size_t segment_size(int fd) {
+    struct stat sb;
+    return fstat(fd, &sb) == 0 ? static_cast<size_t>(sb.st_size) : 0;
+}
+#endif
+}
+
+std::string shared_segment_name(const std::string& prefix, const std::string& symbol) {
+    std::string name = "/" + prefix + "." + symbol;
+    std::replace(name.begin() + 1, name.end(), '/', '_');
+    return name;
+}
+
+#ifdef _WIN32
+
+SharedFeaturePublisher::SharedFeaturePublisher(const std::string& name) : name_(name) {
+    throw segment_error("Shared feature segments need POSIX shared memory", name);
+}
+SharedFeaturePublisher::~SharedFeaturePublisher() = default;
+void SharedFeaturePublisher::publish(const OHLCVData&, const FeatureSet&, const std::string&, const FeatureMask&) {}
+void SharedFeaturePublisher::publish(const OHLCVData&, const FeatureBlock&, const std::string&, const FeatureMask&) {}
+uint64_t SharedFeaturePublisher::publishes() const { return 0; }
+void SharedFeaturePublisher::remove(const std::string&) {}
+
+SharedFeatureReader::SharedFeatureReader(const std::string& name) : name_(name) {
+    throw segment_error("Shared feature segments need POSIX shared memory", name);
+}
+SharedFeatureReader::~SharedFeatureReader() = default;
+uint64_t SharedFeatureReader::publishes() const { return 0; }
+uint64_t SharedFeatureReader::read(const std::function<void(const ColumnarFile&)>&, int) { return 0; }
+
+#else
+
+SharedFeaturePublisher::SharedFeaturePublisher(const std::string& name) : name_(name) {
+    fd_ = open_segment(name, O_CREAT | O_RDWR, 0644);
+    if (fd_ == -1) throw segment_error("Cannot create shared segment", name);
+
+    // Take over a segment of this version, otherwise start a fresh one
+    const size_t existing = segment_size(fd_);
+    if (existing >= kSharedSegmentHeaderBytes) {
+        map(existing);
+        if (std::memcmp(header()->magic, kSharedSegmentMagic, sizeof(kSharedSegmentMagic)) == 0 &&
+            header()->version == kSharedSegmentVersion) {
+            return;
+        }
+    }
+    if (ftruncate(fd_, kSharedSegmentHeaderBytes) == -1) {
+        close(fd_);
+        throw segment_error("Cannot size shared segment", name);
+    }
+    map(kSharedSegmentHeaderBytes);
+    std::memset(base_, 0, kSharedSegmentHeaderBytes);
+    auto* fresh = new (base_) SharedSegmentHeader{};
+    fresh->version = kSharedSegmentVersion;
+    // Magic last: a reader attaching meanwhile rejects the segment
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(fresh->magic, kSharedSegmentMagic, sizeof(kSharedSegmentMagic));
+}
+
+SharedFeaturePublisher::~SharedFeaturePublisher() {
+    if (base_) munmap(base_, size_);
+    if (fd_ != -1) close(fd_);
+}
+
+void SharedFeaturePublisher::publish(const OHLCVData& ohlcv_data, const FeatureSet& features,
+                                     const std::string& data_frequency, const FeatureMask& columns) {
+    publish_image([&](const ColumnarWriter::Allocator& allocate) {
+        ColumnarWriter::build_image(ohlcv_data, features, data_frequency, columns, allocate);
+    });
+}
+
+void SharedFeaturePublisher::publish(const OHLCVData& ohlcv_data, const FeatureBlock& block,
+                                     const std::string& data_frequency, const FeatureMask& columns) {
+    publish_image([&](const ColumnarWriter::Allocator& allocate) {
+        ColumnarWriter::build_image(ohlcv_data, block, data_frequency, columns, allocate);
+    });
+}
+
+uint64_t SharedFeaturePublisher::publishes() const {
+    return header()->sequence.load(std::memory_order_acquire) >> 1;
+}
+
+void SharedFeaturePublisher::remove(const std::string& name) {
+    unlink_segment(name);
+}
+
+void SharedFeaturePublisher::publish_image(const std::function<void(const ColumnarWriter::Allocator&)>& build) {
+    // An odd sequence left by a publisher that died mid-publish is finished
+    // here: its slot is simply written again
+    const uint64_t done = header()->sequence.load(std::memory_order_relaxed) >> 1;
+    const int slot = static_cast<int>((done + 1) & 1);
+    header()->sequence.store(2 * done + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    try {
+        build([&](size_t bytes) { return reserve(slot, bytes); });
+    } catch (...) {
+        // The slot is garbage but not current; readers keep the previous image
+        header()->sequence.store(2 * done, std::memory_order_release);
+        throw;
+    }
+    header()->sequence.store(2 * done + 2, std::memory_order_release);
+}
+
+uint8_t* SharedFeaturePublisher::reserve(int slot, size_t bytes) {
+    SharedSegmentHeader* h = header();
+    if (h->slot_capacity[slot] < bytes) {
+        // Grow in place when the slot is last in the segment, otherwise move
+        // it to the end and release the pages it leaves behind
+        const size_t old_offset = h->slot_offset[slot];
+        const size_t old_capacity = h->slot_capacity[slot];
+        const bool last = old_capacity != 0 && old_offset + old_capacity == size_;
+        const size_t offset = last ? old_offset : size_;
+        const size_t capacity = round_up(bytes + bytes / 2, kSharedSegmentHeaderBytes);
+        if (ftruncate(fd_, static_cast<off_t>(offset + capacity)) == -1) {
+            throw segment_error("Cannot grow shared segment", name_);
+        }
+        map(offset + capacity);
+        h = header();
+#ifdef MADV_REMOVE
+        if (!last && old_capacity != 0) madvise(base_ + old_offset, old_capacity, MADV_REMOVE);
+#endif
+        h->slot_offset[slot] = offset;
+        h->slot_capacity[slot] = capacity;
+    }
+    h->slot_size[slot] = bytes;
+    uint8_t* image = base_ + h->slot_offset[slot];
+    std::memset(image, 0, bytes);
+    return image;
+}
+
+void SharedFeaturePublisher::map(size_t size) {
+    if (base_) munmap(base_, size_);
+    void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapped == MAP_FAILED) {
+        base_ = nullptr;
+        size_ = 0;
+        throw segment_error("Cannot map shared segment", name_);
+    }
+    base_ = static_cast<uint8_t*>(mapped);
+    size_ = size;
+}
+
+SharedFeatureReader::SharedFeatureReader(const std::string& name) : name_(name) {
+    fd_ = open_segment(name, O_RDONLY, 0);
+    if (fd_ == -1) throw segment_error("Cannot open shared segment", name);
+    size_ = segment_size(fd_);
+    void* mapped = size_ >= kSharedSegmentHeaderBytes ? mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0)
+                                                      : MAP_FAILED;
+    if (mapped == MAP_FAILED) {
+        close(fd_);
+        throw segment_error("Cannot map shared segment", name);
+    }
+    base_ = static_cast<const uint8_t*>(mapped);
+    if (std::memcmp(header()->magic, kSharedSegmentMagic, sizeof(kSharedSegmentMagic)) != 0 ||
+        header()->version != kSharedSegmentVersion) {
+        munmap(const_cast<uint8_t*>(base_), size_);
+        close(fd_);
+        throw segment_error("Not a feature segment of this version", name);
+    }
+}
+
+SharedFeatureReader::~SharedFeatureReader() {
+    munmap(const_cast<uint8_t*>(base_), size_);
+    close(fd_);
+}
+
+uint64_t SharedFeatureReader::publishes() const {
+    return header()->sequence.load(std::memory_order_acquire) >> 1;
+}
+
+uint64_t SharedFeatureReader::read(const std::function<void(const ColumnarFile&)>& visit, int attempts) {
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+        const uint64_t publish = header()->sequence.load(std::memory_order_acquire) >> 1;
+        if (publish == 0) return 0;
+        const int slot = static_cast<int>(publish & 1);
+        const uint64_t offset = header()->slot_offset[slot];
+        const uint64_t bytes = header()->slot_size[slot];
+
+        // A torn image can fail to parse, and `visit` can fail on torn
+        // values; either only counts once the image proves consistent
+        std::exception_ptr failure;
+        const bool mapped = covers(offset, bytes);
+        if (mapped) {
+            try {
+                visit(ColumnarFile(base_ + offset, static_cast<size_t>(bytes), name_));
+            } catch (...) {
+                failure = std::current_exception();
+            }
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header()->sequence.load(std::memory_order_relaxed) > 2 * publish + 2) continue;
+        if (failure) std::rethrow_exception(failure);
+        if (!mapped) throw segment_error("Shared segment slot outside the segment", name_);
+        return publish;
+    }
+    return 0;
+}
+
+bool SharedFeatureReader::covers(uint64_t offset, uint64_t bytes) {
+    if (offset <= size_ && bytes <= size_ - offset) return true;
+    // The publisher grew the segment since it was mapped
+    const size_t size = segment_size(fd_);
+    if (size <= size_) return false;
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd_, 0);
+    if (mapped == MAP_FAILED) return false;
+    munmap(const_cast<uint8_t*>(base_), size_);
+    base_ = static_cast<const uint8_t*>(mapped);
+    size_ = size;
+    return offset <= size_ && bytes <= size_ - offset;
+}
+
+#endif
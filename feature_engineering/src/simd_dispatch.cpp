@@ -0,0 +1,219 @@
+#include "simd_dispatch.h"
+#include "simd_kernel_bodies.h"
+#include <atomic>
+#include <stdexcept>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#define SIMD_DISPATCH_X86_MSVC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#define SIMD_DISPATCH_X86_GNU 1
+#endif
+
+namespace {
+// Scalar kernels: the reference every other tier is checked against
+void subtract_scalar(const double* a, const double* b, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = a[i] - b[i];
+}
+
+void divide_scalar(const double* a, const double* b, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = (b[i] != 0.0) ? a[i] / b[i] : 0.0;
+}
+
+void scale_scalar(const double* in, double factor, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = in[i] * factor;
+}
+
+double sum_scalar(const double* p, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) sum += p[i];
+    return sum;
+}
+
+double squared_deviation_sum_scalar(const double* p, size_t n, double mean) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const double diff = p[i] - mean;
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+double index_weighted_sum_scalar(const double* p, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) sum += static_cast<double>(i) * p[i];
+    return sum;
+}
+
+void centered_products_scalar(const double* x, const double* y, size_t n,
+                              double mean_x, double mean_y, double out[3]) {
+    double xy = 0.0, xx = 0.0, yy = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const double dx = x[i] - mean_x;
+        const double dy = y[i] - mean_y;
+        xy += dx * dy;
+        xx += dx * dx;
+        yy += dy * dy;
+    }
+    out[0] = xy;
+    out[1] = xx;
+    out[2] = yy;
+}
+
+void subtract_f32_scalar(const float* a, const float* b, float* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = a[i] - b[i];
+}
+
+void divide_f32_scalar(const float* a, const float* b, float* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = (b[i] != 0.0f) ? a[i] / b[i] : 0.0f;
+}
+
+void scale_f32_scalar(const float* in, float factor, float* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = in[i] * factor;
+}
+
+double sum_f32_scalar(const float* p, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) sum += p[i];
+    return sum;
+}
+
+double squared_deviation_sum_f32_scalar(const float* p, size_t n, double mean) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const double diff = p[i] - mean;
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+double index_weighted_sum_f32_scalar(const float* p, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) sum += static_cast<double>(i) * p[i];
+    return sum;
+}
+
+const SimdKernels kScalarKernels = make_kernel_table<ScalarOps>(
+    SimdTier::Scalar,
+    subtract_scalar,
+    divide_scalar,
+    scale_scalar,
+    sum_scalar,
+    squared_deviation_sum_scalar,
+    index_weighted_sum_scalar,
+    centered_products_scalar,
+    subtract_f32_scalar,
+    divide_f32_scalar,
+    scale_f32_scalar,
+    sum_f32_scalar,
+    squared_deviation_sum_f32_scalar,
+    index_weighted_sum_f32_scalar);
+
+bool cpu_has_avx2() {
+#if defined(SIMD_DISPATCH_X86_GNU)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#elif defined(SIMD_DISPATCH_X86_MSVC)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!fma || !osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+bool cpu_has_avx512() {
+#if defined(SIMD_DISPATCH_X86_GNU)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+#elif defined(SIMD_DISPATCH_X86_MSVC)
+    int info[4];
+    __cpuid(info, 1);
+    // OS must save opmask and upper ZMM state as well as YMM
+    if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 0xE6) != 0xE6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 16)) != 0;
+#else
+    return false;
+#endif
+}
+
+const SimdKernels* kernels_for(SimdTier tier) {
+    switch (tier) {
+    case SimdTier::AVX512: return avx512_kernels();
+    case SimdTier::AVX2: return avx2_kernels();
+    case SimdTier::NEON: return neon_kernels();
+    case SimdTier::Scalar: break;
+    }
+    return scalar_kernels();
+}
+
+std::atomic<const SimdKernels*> g_active{nullptr};
+}
+
+const SimdKernels* scalar_kernels() {
+    return &kScalarKernels;
+}
+
+SimdTier detect_simd_tier() {
+    if (avx512_kernels() && cpu_has_avx512() && cpu_has_avx2()) return SimdTier::AVX512;
+    if (avx2_kernels() && cpu_has_avx2()) return SimdTier::AVX2;
+    // NEON is part of the AArch64 baseline, so a built table is always usable
+    if (neon_kernels()) return SimdTier::NEON;
+    return SimdTier::Scalar;
+}
+
+const SimdKernels& simd_kernels() {
+    const SimdKernels* active = g_active.load(std::memory_order_acquire);
+    if (!active) {
+        const SimdKernels* detected = kernels_for(detect_simd_tier());
+        // A concurrent limit_simd_tier() wins over detection
+        if (!g_active.compare_exchange_strong(active, detected, std::memory_order_acq_rel)) return *active;
+        active = detected;
+    }
+    return *active;
+}
+
+SimdTier active_simd_tier() {
+    return simd_kernels().tier;
+}
+
+SimdTier limit_simd_tier(SimdTier max_tier) {
+    SimdTier tier = detect_simd_tier();
+    // Tiers only order within one architecture; NEON caps to itself or scalar
+    if (max_tier == SimdTier::Scalar) {
+        tier = SimdTier::Scalar;
+    } else if (tier == SimdTier::AVX512 && max_tier == SimdTier::AVX2) {
+        tier = SimdTier::AVX2;
+    } else if ((tier == SimdTier::NEON) != (max_tier == SimdTier::NEON)) {
+        tier = SimdTier::Scalar;
+    }
+    const SimdKernels* kernels = kernels_for(tier);
+    g_active.store(kernels, std::memory_order_release);
+    return kernels->tier;
+}
+
+const char* simd_tier_name(SimdTier tier) {
+    switch (tier) {
+    case SimdTier::Scalar: return "Scalar";
+    case SimdTier::NEON: return "NEON";
+    case SimdTier::AVX2: return "AVX2";
+    case SimdTier::AVX512: return "AVX-512";
+    }
+    return "Unknown";
+}
+
+SimdTier parse_simd_tier(const std::string& name) {
+    if (name == "scalar") return SimdTier::Scalar;
+    if (name == "neon") return SimdTier::NEON;
+    if (name == "avx2") return SimdTier::AVX2;
+    if (name == "avx512") return SimdTier::AVX512;
+    throw std::runtime_error("Unknown SIMD tier: " + name);
+}
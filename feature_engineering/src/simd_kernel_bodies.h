@@ -0,0 +1,527 @@
+#pragma once
+// Indicator kernels written once against a small lane-ops interface and
+// instantiated by every tier's translation unit (scalar, AVX2, AVX-512, NEON).
+// Include only from those files and define the tier's ops struct in an
+// anonymous namespace: the instantiations then have internal linkage, so code
+// built with one tier's flags is never shared with another.
+//
+// Each output lane runs the scalar reference's own operation order, so the
+// vector results track TechnicalIndicators instead of merely approximating it.
+#include "simd_dispatch.h"
+
+namespace {
+
+struct ScalarOps {
+    using reg = double;
+    using mask = bool;
+    static constexpr size_t lanes = 1;
+    static reg load(const double* p) { return *p; }
+    static void store(double* p, reg v) { *p = v; }
+    static reg set1(double x) { return x; }
+    static reg add(reg a, reg b) { return a + b; }
+    static reg sub(reg a, reg b) { return a - b; }
+    static reg mul(reg a, reg b) { return a * b; }
+    static reg div(reg a, reg b) { return a / b; }
+    // std::max semantics, spelled out so no library inline is instantiated here
+    static reg max(reg a, reg b) { return (a < b) ? b : a; }
+    static reg abs(reg a) { return a < 0.0 ? -a : a; }
+    static mask gt(reg a, reg b) { return a > b; }
+    static mask lt(reg a, reg b) { return a < b; }
+    static reg select(mask m, reg t, reg f) { return m ? t : f; }
+};
+
+// Runs step(V{}, i) over full vectors, then step(ScalarOps{}, i) over the tail
+template <class V, class Step>
+inline void for_lanes(size_t n, Step&& step) {
+    size_t i = 0;
+    for (; i + V::lanes <= n; i += V::lanes) step(V{}, i);
+    for (; i < n; ++i) step(ScalarOps{}, i);
+}
+
+template <class V>
+struct KernelBodies {
+    // out[k] = terms[k + w - 1] + terms[k + w - 2] + ... + terms[k], newest first
+    static void window_sums(const double* terms, size_t n, size_t window, double* out) {
+        if (window == 0 || n < window) return;
+        for_lanes<V>(n - window + 1, [&](auto ops, size_t k) {
+            using O = decltype(ops);
+            typename O::reg sum = O::set1(0.0);
+            for (size_t j = 0; j < window; ++j) sum = O::add(sum, O::load(terms + k + window - 1 - j));
+            O::store(out + k, sum);
+        });
+    }
+
+    static void abs_diff(const double* a, const double* b, double* out, size_t n) {
+        for_lanes<V>(n, [&](auto ops, size_t i) {
+            using O = decltype(ops);
+            O::store(out + i, O::abs(O::sub(O::load(a + i), O::load(b + i))));
+        });
+    }
+
+    static void true_range(const double* high, const double* low, const double* prev_close, double* out, size_t n) {
+        for_lanes<V>(n, [&](auto ops, size_t i) {
+            using O = decltype(ops);
+            auto h = O::load(high + i), l = O::load(low + i), pc = O::load(prev_close + i);
+            auto tr = O::max(O::max(O::sub(h, l), O::abs(O::sub(h, pc))), O::abs(O::sub(l, pc)));
+            O::store(out + i, tr);
+        });
+    }
+
+    static void directional_movement(const double* high, const double* prev_high,
+                                     const double* low, const double* prev_low,
+                                     double* plus, double* minus, size_t n) {
+        for_lanes<V>(n, [&](auto ops, size_t i) {
+            using O = decltype(ops);
+            const auto zero = O::set1(0.0);
+            auto up = O::sub(O::load(high + i), O::load(prev_high + i));
+            auto down = O::sub(O::load(prev_low + i), O::load(low + i));
+            O::store(plus + i, O::select(O::gt(up, down), O::max(zero, up), zero));
+            O::store(minus + i, O::select(O::gt(down, up), O::max(zero, down), zero));
+        });
+    }
+
+    static void typical_price(const double* high, const double* low, const double* close, double* out, size_t n) {
+        for_lanes<V>(n, [&](auto ops, size_t i) {
+            using O = decltype(ops);
+            auto sum = O::add(O::add(O::load(high + i), O::load(low + i)), O::load(close + i));
+            O::store(out + i, O::div(sum, O::set1(3.0)));
+        });
+    }
+
+    static void money_flows(const double* typical, const double* prev_typical, const double* volume,
+                            double* positive, double* negative, size_t n) {
+        for_lanes<V>(n, [&](auto ops, size_t i) {
+            using O = decltype(ops);
+            const auto zero = O::set1(0.0);
+            auto tp = O::load(typical + i), prev = O::load(prev_typical + i);
+            auto flow = O::mul(tp, O::load(volume + i));
+            O::store(positive + i, O::select(O::gt(tp, prev), flow, zero));
+            O::store(negative + i, O::select(O::lt(tp, prev), flow, zero));
+        });
+    }
+
+    static void gains_losses(const double* current, const double* previous, double* gains, double* losses, size_t n) {
+        for_lanes<V>(n, [&](auto ops, size_t i) {
+            using O = decltype(ops);
+            const auto zero = O::set1(0.0);
+            auto change = O::sub(O::load(current + i), O::load(previous + i));
+            O::store(gains + i, O::select(O::gt(change, zero), change, zero));
+            O::store(losses + i, O::select(O::lt(change, zero), O::sub(zero, change), zero));
+        });
+    }
+
+    static void bar_strength(const double* high, const double* low, const double* close, double* out, size_t n) {
+        for_lanes<V>(n, [&](auto ops, size_t i) {
+            using O = decltype(ops);
+            auto l = O::load(low + i);
+            auto range = O::sub(O::load(high + i), l);
+            auto ibs = O::div(O::sub(O::load(close + i), l), range);
+            O::store(out + i, O::select(O::gt(range, O::set1(0.0)), ibs, O::set1(0.5)));
+        });
+    }
+
+    static void direction_volume(const double* current, const double* previous, const double* volume,
+                                 double tie_sign, double* out, size_t n) {
+        for_lanes<V>(n, [&](auto ops, size_t i) {
+            using O = decltype(ops);
+            auto cur = O::load(current + i), prev = O::load(previous + i);
+            auto sign = O::select(O::gt(cur, prev), O::set1(1.0),
+                                  O::select(O::lt(cur, prev), O::set1(-1.0), O::set1(tie_sign)));
+            O::store(out + i, O::mul(O::load(volume + i), sign));
+        });
+    }
+
+    static void ulcer_sums(const double* prices, size_t n, size_t period, double* out) {
+        if (period == 0 || n < period) return;
+        for_lanes<V>(n - period + 1, [&](auto ops, size_t k) {
+            using O = decltype(ops);
+            const auto zero = O::set1(0.0);
+            const auto hundred = O::set1(100.0);
+            auto peak = O::load(prices + k);
+            for (size_t j = 1; j < period; ++j) peak = O::max(peak, O::load(prices + k + j));
+            const auto has_peak = O::gt(peak, zero);
+            typename O::reg sum = zero;
+            for (size_t j = 0; j < period; ++j) {
+                auto drawdown = O::div(O::mul(hundred, O::sub(O::load(prices + k + period - 1 - j), peak)), peak);
+                drawdown = O::select(has_peak, drawdown, zero);
+                sum = O::add(sum, O::mul(drawdown, drawdown));
+            }
+            O::store(out + k, sum);
+        });
+    }
+
+    static void prefix_window_stats(const double* sum, const double* sum_sq, const double* sum_tx,
+                                    size_t first, size_t rows, size_t window,
+                                    double* mean, double* var, double* slope) {
+        if (window == 0) return;
+        // Slope as TechnicalIndicators::linear_slope: (w sum_xy - sum_x sum_y) / den
+        // with x = 0 .. w - 1
+        const double w = static_cast<double>(window);
+        const double sum_x = w * (w - 1.0) / 2.0;
+        const double den = w * (w * (w - 1.0) * (2.0 * w - 1.0) / 6.0) - sum_x * sum_x;
+        for_lanes<V>(rows, [&](auto ops, size_t r) {
+            using O = decltype(ops);
+            const size_t k = first + r;
+            const auto s = O::sub(O::load(sum + k + window), O::load(sum + k));
+            const auto m = O::div(s, O::set1(w));
+            if (mean) O::store(mean + r, m);
+            if (var && window > 1) {
+                const auto q = O::sub(O::load(sum_sq + k + window), O::load(sum_sq + k));
+                O::store(var + r, O::div(O::sub(q, O::mul(m, s)), O::set1(w - 1.0)));
+            }
+            if (slope && den != 0.0) {
+                // sum of (j - k) x_j over the window, k per lane
+                double start[O::lanes];
+                for (size_t l = 0; l < O::lanes; ++l) start[l] = static_cast<double>(k + l);
+                const auto t = O::sub(O::load(sum_tx + k + window), O::load(sum_tx + k));
+                const auto sum_xy = O::sub(t, O::mul(O::load(start), s));
+                O::store(slope + r, O::div(O::sub(O::mul(O::set1(w), sum_xy), O::mul(O::set1(sum_x), s)),
+                                           O::set1(den)));
+            }
+        });
+    }
+
+    static void compensated_window_sums(const double* hi, const double* lo, size_t rows, size_t window, double* out) {
+        for_lanes<V>(rows, [&](auto ops, size_t r) {
+            using O = decltype(ops);
+            const auto head = O::sub(O::load(hi + r + window), O::load(hi + r));
+            const auto tail = O::sub(O::load(lo + r + window), O::load(lo + r));
+            O::store(out + r, O::add(head, tail));
+        });
+    }
+
+    // Lane-interleaved recurrences: one register holds row t of every series
+    static void ema_lanes(const double* in, size_t rows, double alpha, double* out) {
+        if (rows == 0) return;
+        const auto a = V::set1(alpha), keep = V::set1(1.0 - alpha);
+        auto ema = V::load(in);
+        V::store(out, ema);
+        for (size_t t = 1; t < rows; ++t) {
+            ema = V::add(V::mul(a, V::load(in + t * V::lanes)), V::mul(keep, ema));
+            V::store(out + t * V::lanes, ema);
+        }
+    }
+
+    static void kama_lanes(const double* prices, size_t rows, size_t period, double fast_sc, double slow_sc, double* out) {
+        if (rows == 0) return;
+        const size_t L = V::lanes;
+        const auto zero = V::set1(0.0);
+        const auto sc_span = V::set1(fast_sc - slow_sc), sc_slow = V::set1(slow_sc);
+        auto kama = V::load(prices);
+        V::store(out, kama);
+        for (size_t t = 1; t < rows; ++t) {
+            const size_t lookback = t < period ? t : period;
+            const auto price = V::load(prices + t * L);
+            const auto change = V::abs(V::sub(price, V::load(prices + (t - lookback) * L)));
+            auto volatility = zero;
+            for (size_t j = 1; j <= lookback; ++j) {
+                volatility = V::add(volatility, V::abs(V::sub(V::load(prices + (t - j + 1) * L), V::load(prices + (t - j) * L))));
+            }
+            const auto er = V::select(V::gt(volatility, zero), V::div(change, volatility), zero);
+            const auto base = V::add(V::mul(er, sc_span), sc_slow);
+            const auto sc = V::mul(base, base);
+            kama = V::add(kama, V::mul(sc, V::sub(price, kama)));
+            V::store(out + t * L, kama);
+        }
+    }
+
+    // Same sliding closed form as TechnicalIndicators::garch_volatility_21
+    static void garch_variance_lanes(const double* returns, size_t rows, size_t window,
+                                     double omega, double alpha, double beta, double* out) {
+        if (window == 0 || rows < window) return;
+        const size_t L = V::lanes;
+        double beta_window = 1.0, omega_sum = 0.0;
+        for (size_t j = 0; j < window; ++j) {
+            omega_sum += beta_window;
+            beta_window *= beta;
+        }
+        const auto base = V::set1(omega * omega_sum), a = V::set1(alpha), b = V::set1(beta);
+        const auto evict = V::set1(beta_window), zero = V::set1(0.0);
+        auto weighted = zero;
+        for (size_t t = 0; t < rows; ++t) {
+            const auto r = V::load(returns + t * L);
+            weighted = V::add(V::mul(b, weighted), V::mul(r, r));
+            if (t >= window) {
+                const auto old = V::load(returns + (t - window) * L);
+                weighted = V::sub(weighted, V::mul(V::mul(evict, old), old));
+            }
+            if (t + 1 >= window) V::store(out + (t + 1 - window) * L, V::max(zero, V::add(base, V::mul(a, weighted))));
+        }
+    }
+
+    // Gaussian GARCH(1,1) likelihood terms for `lanes` (alpha, beta) candidates
+    // on one series of squared standardized returns; see SimdKernels
+    static void garch_likelihood_lanes(const double* z2, size_t n, const double* alpha, const double* beta,
+                                       double* weighted, double* products) {
+        if (n == 0) return;
+        const size_t L = V::lanes, block = SimdKernels::garch_likelihood_block;
+        const auto one = V::set1(1.0);
+        const auto a = V::load(alpha), b = V::load(beta);
+        const auto w = V::sub(V::sub(one, a), b);
+        auto h = one, sum = V::set1(0.0), product = one;
+        for (size_t t = 0; t < n; ++t) {
+            if (t > 0) h = V::add(V::add(w, V::mul(a, V::set1(z2[t - 1]))), V::mul(b, h));
+            sum = V::add(sum, V::div(V::set1(z2[t]), h));
+            product = V::mul(product, h);
+            if ((t + 1) % block == 0 || t + 1 == n) {
+                V::store(products + (t / block) * L, product);
+                product = one;
+            }
+        }
+        V::store(weighted, sum);
+    }
+
+    // Gram tile of two packed panels, one gram_panel-row accumulator set per
+    // `lanes` columns; see SimdKernels
+    static void gram_panel_product(const double* a, const double* b, size_t depth, double* out) {
+        constexpr size_t P = SimdKernels::gram_panel;
+        static_assert(P % V::lanes == 0, "gram panel must hold whole vectors");
+        for (size_t c = 0; c < P; c += V::lanes) {
+            typename V::reg acc[P];
+            for (size_t r = 0; r < P; ++r) acc[r] = V::load(out + r * P + c);
+            for (size_t t = 0; t < depth; ++t) {
+                const auto column = V::load(b + t * P + c);
+                for (size_t r = 0; r < P; ++r) acc[r] = V::add(acc[r], V::mul(V::set1(a[t * P + r]), column));
+            }
+            for (size_t r = 0; r < P; ++r) V::store(out + r * P + c, acc[r]);
+        }
+    }
+
+    // ADF regressions for `lanes` series, all lag orders from one
+    // factorization; see SimdKernels
+    static void adf_lanes(const double* y, size_t rows, size_t max_lag, double* coef, double* var, double* rss) {
+        constexpr size_t M = SimdKernels::adf_max_lag + 3;
+        const size_t L = V::lanes, k = max_lag + 2, first = max_lag + 1;
+        if (max_lag > SimdKernels::adf_max_lag || rows <= first) return;
+        using R = typename V::reg;
+        const R zero = V::set1(0.0);
+
+        // Upper triangle of [X dy]'[X dy]; index k is the target dy_t. The
+        // lagged differences shift down one slot per row, so each row loads
+        // only y_t and y_{t-1}.
+        R g[M][M], x[M];
+        for (size_t i = 0; i <= k; ++i)
+            for (size_t j = i; j <= k; ++j) g[i][j] = zero;
+        x[0] = V::set1(1.0);
+        for (size_t q = 0; q < max_lag; ++q) {
+            x[2 + q] = V::sub(V::load(y + (first - 1 - q) * L), V::load(y + (first - 2 - q) * L));
+        }
+        for (size_t t = first; t < rows; ++t) {
+            if (t > first) {
+                for (size_t q = max_lag; q-- > 1;) x[2 + q] = x[1 + q];
+                if (max_lag > 0) x[2] = x[k];
+            }
+            x[1] = V::load(y + (t - 1) * L);
+            x[k] = V::sub(V::load(y + t * L), x[1]);
+            for (size_t i = 0; i <= k; ++i)
+                for (size_t j = i; j <= k; ++j) g[i][j] = V::add(g[i][j], V::mul(x[i], x[j]));
+        }
+
+        // LDL^T with unit lower l and diagonal d; a vanishing pivot (collinear
+        // regressors) is floored so the lane stays finite
+        const R floor = V::set1(1e-300);
+        R l[M][M], d[M];
+        for (size_t j = 0; j <= k; ++j) {
+            R pivot = g[j][j];
+            for (size_t s = 0; s < j; ++s) pivot = V::sub(pivot, V::mul(V::mul(l[j][s], l[j][s]), d[s]));
+            d[j] = V::max(pivot, floor);
+            for (size_t i = j + 1; i <= k; ++i) {
+                R sum = g[j][i];
+                for (size_t s = 0; s < j; ++s) sum = V::sub(sum, V::mul(V::mul(l[i][s], l[j][s]), d[s]));
+                l[i][j] = V::div(sum, d[j]);
+            }
+        }
+
+        // Column 1 of l^-1 (m), then each lag order adds one regressor:
+        // coef += m_i * l[k][i], var += m_i^2 / d_i, rss -= l[k][i]^2 * d_i
+        R m[M];
+        R residual = g[k][k];
+        residual = V::sub(residual, V::mul(V::mul(l[k][0], l[k][0]), d[0]));
+        R b = zero, v = zero;
+        for (size_t i = 1; i < k; ++i) {
+            R mi = i == 1 ? V::set1(1.0) : zero;
+            for (size_t s = 1; s < i; ++s) mi = V::sub(mi, V::mul(l[i][s], m[s]));
+            m[i] = mi;
+            b = V::add(b, V::mul(mi, l[k][i]));
+            v = V::add(v, V::div(V::mul(mi, mi), d[i]));
+            residual = V::sub(residual, V::mul(V::mul(l[k][i], l[k][i]), d[i]));
+            V::store(coef + (i - 1) * L, b);
+            V::store(var + (i - 1) * L, v);
+            V::store(rss + (i - 1) * L, residual);
+        }
+    }
+
+    // Hedge filter and rolling Dickey-Fuller regression for `lanes` pairs;
+    // see SimdKernels
+    static void hedge_filter_lanes(const double* x, const double* y, size_t rows, size_t warmup,
+                                   double state_forgetting, double state_noise, double moment_forgetting,
+                                   double* beta, double* alpha, double* error, double* error_var,
+                                   double* ar_coef, double* ar_var) {
+        if (rows == 0) return;
+        const size_t L = V::lanes;
+        using R = typename V::reg;
+        const R zero = V::set1(0.0), one = V::set1(1.0), two = V::set1(2.0), tiny = V::set1(1e-300);
+        const R decay = V::set1(1.0 / state_forgetting), noise = V::set1(state_noise);
+        const R forget = V::set1(moment_forgetting);
+        const R x0 = V::load(x);
+
+        R a = zero, b = zero;
+        R p00 = V::set1(SimdKernels::hedge_filter_prior), p01 = zero, p11 = p00;
+        R noise_sum = zero, noise_weight = zero;
+        // Weighted means and co-moment sums of (x_{t-1}, y_{t-1}, dx_t, dy_t);
+        // the spread's moments at any beta are quadratic forms in them
+        R weight = zero, mean[4], c[4][4];
+        for (size_t i = 0; i < 4; ++i) {
+            mean[i] = zero;
+            for (size_t j = i; j < 4; ++j) c[i][j] = zero;
+        }
+
+        R previous_x = zero, previous_y = zero;
+        for (size_t t = 0; t < rows; ++t) {
+            const R xt = V::sub(V::load(x + t * L), x0), yt = V::load(y + t * L);
+
+            // Predict, then update with the gain P phi / (phi' P phi + 1)
+            p00 = V::add(V::mul(p00, decay), noise);
+            p01 = V::mul(p01, decay);
+            p11 = V::add(V::mul(p11, decay), noise);
+            const R h0 = V::add(p00, V::mul(p01, xt)), h1 = V::add(p01, V::mul(p11, xt));
+            const R s = V::add(V::add(h0, V::mul(h1, xt)), one);
+            const R e = V::sub(V::sub(yt, a), V::mul(b, xt));
+            const R k0 = V::div(h0, s), k1 = V::div(h1, s);
+            a = V::add(a, V::mul(k0, e));
+            b = V::add(b, V::mul(k1, e));
+            p00 = V::sub(p00, V::mul(k0, h0));
+            p01 = V::sub(p01, V::mul(k0, h1));
+            p11 = V::sub(p11, V::mul(k1, h1));
+            V::store(beta + t * L, b);
+            V::store(alpha + t * L, a);
+            V::store(error + t * L, e);
+            const R level = V::select(V::gt(noise_weight, zero), V::div(noise_sum, V::max(noise_weight, tiny)), zero);
+            V::store(error_var + t * L, V::mul(level, s));
+            if (t >= warmup) {
+                noise_sum = V::add(V::mul(forget, noise_sum), V::div(V::mul(e, e), s));
+                noise_weight = V::add(V::mul(forget, noise_weight), one);
+            }
+
+            R coef = zero, coef_var = zero;
+            if (t > warmup) {
+                const R z[4] = {previous_x, previous_y, V::sub(xt, previous_x), V::sub(yt, previous_y)};
+                weight = V::add(V::mul(forget, weight), one);
+                R d[4];
+                for (size_t i = 0; i < 4; ++i) {
+                    d[i] = V::sub(z[i], mean[i]);
+                    mean[i] = V::add(mean[i], V::div(d[i], weight));
+                }
+                for (size_t i = 0; i < 4; ++i)
+                    for (size_t j = i; j < 4; ++j)
+                        c[i][j] = V::add(V::mul(forget, c[i][j]), V::mul(d[i], V::sub(z[j], mean[j])));
+
+                // s_{t-1} = y_{t-1} - b x_{t-1}, ds_t = dy_t - b dx_t
+                const R bb = V::mul(b, b);
+                const R level_var = V::add(V::sub(V::mul(bb, c[0][0]), V::mul(V::mul(two, b), c[0][1])), c[1][1]);
+                const R cross = V::add(V::sub(V::sub(V::mul(bb, c[0][2]), V::mul(b, c[0][3])), V::mul(b, c[1][2])), c[1][3]);
+                const R change_var = V::add(V::sub(V::mul(bb, c[2][2]), V::mul(V::mul(two, b), c[2][3])), c[3][3]);
+                const R safe_level = V::max(level_var, tiny);
+                const R r = V::div(cross, safe_level);
+                const R residual = V::max(V::sub(change_var, V::mul(r, cross)), zero);
+                const R dof = V::sub(weight, two);
+                const auto defined = V::gt(V::select(V::gt(level_var, tiny), dof, zero), zero);
+                coef = V::select(defined, r, zero);
+                coef_var = V::select(defined, V::div(V::div(residual, V::max(dof, tiny)), safe_level), zero);
+            }
+            V::store(ar_coef + t * L, coef);
+            V::store(ar_var + t * L, coef_var);
+            previous_x = xt;
+            previous_y = yt;
+        }
+    }
+
+    // Threshold rules for `lanes` grid points over one z-score series; see
+    // SimdKernels. Position is -1, 0 or 1 per lane and every branch of the
+    // scalar rule is a select, so lanes in different states share the pass.
+    static void threshold_backtest_lanes(const double* z, size_t n, const double* entry, const double* exit,
+                                         const double* stop, const double* max_hold, double* stats) {
+        const size_t L = V::lanes;
+        using R = typename V::reg;
+        const R zero = V::set1(0.0), one = V::set1(1.0), half = V::set1(0.5), unit = V::set1(0.01);
+        const R short_above = V::load(entry), long_below = V::sub(zero, short_above);
+        const R revert = V::sub(zero, V::load(exit)), stop_above = V::load(stop);
+        const R held_limit = V::sub(V::load(max_hold), half);
+
+        R position = zero, entry_z = zero, held = zero;
+        R trades = zero, wins = zero, sum = zero, sum_sq = zero, entries = zero;
+        for (size_t t = 0; t < n; ++t) {
+            const R zt = V::set1(z[t]);
+            const auto open = V::gt(V::abs(position), half);
+            held = V::select(open, V::add(held, one), zero);
+
+            // position * z > -exit is the reversion test for either side
+            R leave = V::select(V::gt(V::mul(position, zt), revert), one, zero);
+            leave = V::select(V::gt(V::abs(zt), stop_above), one, leave);
+            leave = V::select(V::gt(held, held_limit), one, leave);
+            const auto closing = V::gt(V::select(open, leave, zero), half);
+            const R pnl = V::mul(unit, V::mul(position, V::sub(zt, entry_z)));
+            trades = V::add(trades, V::select(closing, one, zero));
+            wins = V::add(wins, V::select(closing, V::select(V::gt(pnl, zero), one, zero), zero));
+            sum = V::add(sum, V::select(closing, pnl, zero));
+            sum_sq = V::add(sum_sq, V::select(closing, V::mul(pnl, pnl), zero));
+            position = V::select(closing, zero, position);
+
+            // Lanes flat before this bar may open
+            const R side = V::select(V::gt(zt, short_above), V::set1(-1.0), V::select(V::lt(zt, long_below), one, zero));
+            entries = V::add(entries, V::select(open, zero, V::abs(side)));
+            position = V::select(open, position, side);
+            entry_z = V::select(open, entry_z, zt);
+        }
+        V::store(stats, trades);
+        V::store(stats + L, wins);
+        V::store(stats + 2 * L, sum);
+        V::store(stats + 3 * L, sum_sq);
+        V::store(stats + 4 * L, entries);
+    }
+};
+
+// A tier's full kernel table: its own core kernels plus the shared indicator bodies
+template <class V>
+constexpr SimdKernels make_kernel_table(SimdTier tier,
+                                        decltype(SimdKernels::subtract) subtract,
+                                        decltype(SimdKernels::divide) divide,
+                                        decltype(SimdKernels::scale) scale,
+                                        decltype(SimdKernels::sum) sum,
+                                        decltype(SimdKernels::squared_deviation_sum) squared_deviation_sum,
+                                        decltype(SimdKernels::index_weighted_sum) index_weighted_sum,
+                                        decltype(SimdKernels::centered_products) centered_products,
+                                        decltype(SimdKernels::subtract_f32) subtract_f32,
+                                        decltype(SimdKernels::divide_f32) divide_f32,
+                                        decltype(SimdKernels::scale_f32) scale_f32,
+                                        decltype(SimdKernels::sum_f32) sum_f32,
+                                        decltype(SimdKernels::squared_deviation_sum_f32) squared_deviation_sum_f32,
+                                        decltype(SimdKernels::index_weighted_sum_f32) index_weighted_sum_f32) {
+    return SimdKernels{
+        tier, subtract, divide, scale, sum, squared_deviation_sum, index_weighted_sum, centered_products,
+        subtract_f32, divide_f32, scale_f32, sum_f32, squared_deviation_sum_f32, index_weighted_sum_f32,
+        KernelBodies<V>::window_sums,
+        KernelBodies<V>::abs_diff,
+        KernelBodies<V>::true_range,
+        KernelBodies<V>::directional_movement,
+        KernelBodies<V>::typical_price,
+        KernelBodies<V>::money_flows,
+        KernelBodies<V>::gains_losses,
+        KernelBodies<V>::bar_strength,
+        KernelBodies<V>::direction_volume,
+        KernelBodies<V>::ulcer_sums,
+        KernelBodies<V>::prefix_window_stats,
+        KernelBodies<V>::compensated_window_sums,
+        V::lanes,
+        KernelBodies<V>::ema_lanes,
+        KernelBodies<V>::kama_lanes,
+        KernelBodies<V>::garch_variance_lanes,
+        KernelBodies<V>::garch_likelihood_lanes,
+        KernelBodies<V>::gram_panel_product,
+        KernelBodies<V>::adf_lanes,
+        KernelBodies<V>::hedge_filter_lanes,
+        KernelBodies<V>::threshold_backtest_lanes,
+    };
+}
+
+}
@@ -0,0 +1,239 @@
+// Built with -mavx2 -mfma (see CMakeLists.txt). Only intrinsics and raw loops
+// here: an inline library function instantiated in this file could be picked
+// by the linker for baseline callers and fault on CPUs without AVX2.
+#include "simd_dispatch.h"
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#include <immintrin.h>
+#include "simd_kernel_bodies.h"
+
+namespace {
+constexpr size_t kLanes = 4;
+
+inline double lane_sum(__m256d v) {
+    double temp[4];
+    _mm256_storeu_pd(temp, v);
+    return temp[0] + temp[1] + temp[2] + temp[3];
+}
+
+void subtract_avx2(const double* a, const double* b, double* out, size_t n) {
+    const size_t simd_size = (n / kLanes) * kLanes;
+    for (size_t i = 0; i < simd_size; i += kLanes) {
+        _mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+    for (size_t i = simd_size; i < n; ++i) out[i] = a[i] - b[i];
+}
+
+void divide_avx2(const double* a, const double* b, double* out, size_t n) {
+    const size_t simd_size = (n / kLanes) * kLanes;
+    const __m256d vzero = _mm256_setzero_pd();
+    for (size_t i = 0; i < simd_size; i += kLanes) {
+        __m256d vb = _mm256_loadu_pd(b + i);
+        // Zero out lanes where the divisor was zero
+        __m256d mask = _mm256_cmp_pd(vb, vzero, _CMP_NEQ_OQ);
+        _mm256_storeu_pd(out + i, _mm256_and_pd(_mm256_div_pd(_mm256_loadu_pd(a + i), vb), mask));
+    }
+    for (size_t i = simd_size; i < n; ++i) out[i] = (b[i] != 0.0) ? a[i] / b[i] : 0.0;
+}
+
+void scale_avx2(const double* in, double factor, double* out, size_t n) {
+    const size_t simd_size = (n / kLanes) * kLanes;
+    const __m256d vfactor = _mm256_set1_pd(factor);
+    for (size_t i = 0; i < simd_size; i += kLanes) {
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(in + i), vfactor));
+    }
+    for (size_t i = simd_size; i < n; ++i) out[i] = in[i] * factor;
+}
+
+double sum_avx2(const double* p, size_t n) {
+    const size_t simd_size = (n / kLanes) * kLanes;
+    __m256d vsum = _mm256_setzero_pd();
+    for (size_t i = 0; i < simd_size; i += kLanes) vsum = _mm256_add_pd(vsum, _mm256_loadu_pd(p + i));
+
+    // Horizontal sum
+    __m128d vlow = _mm256_castpd256_pd128(vsum);
+    __m128d vhigh = _mm256_extractf128_pd(vsum, 1);
+    vlow = _mm_add_pd(vlow, vhigh);
+    __m128d high64 = _mm_unpackhi_pd(vlow, vlow);
+    double sum = _mm_cvtsd_f64(_mm_add_sd(vlow, high64));
+
+    for (size_t i = simd_size; i < n; ++i) sum += p[i];
+    return sum;
+}
+
+double squared_deviation_sum_avx2(const double* p, size_t n, double mean) {
+    const size_t simd_size = (n / kLanes) * kLanes;
+    const __m256d vmean = _mm256_set1_pd(mean);
+    __m256d vvar = _mm256_setzero_pd();
+    for (size_t i = 0; i < simd_size; i += kLanes) {
+        __m256d vdiff = _mm256_sub_pd(_mm256_loadu_pd(p + i), vmean);
+        vvar = _mm256_fmadd_pd(vdiff, vdiff, vvar);
+    }
+    double sum = lane_sum(vvar);
+    for (size_t i = simd_size; i < n; ++i) {
+        const double diff = p[i] - mean;
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+double index_weighted_sum_avx2(const double* p, size_t n) {
+    const size_t simd_size = (n / kLanes) * kLanes;
+    __m256d vsum = _mm256_setzero_pd();
+    for (size_t j = 0; j < simd_size; j += kLanes) {
+        __m256d vx = _mm256_set_pd(double(j + 3), double(j + 2), double(j + 1), double(j));
+        vsum = _mm256_fmadd_pd(vx, _mm256_loadu_pd(p + j), vsum);
+    }
+    double sum = lane_sum(vsum);
+    for (size_t j = simd_size; j < n; ++j) sum += static_cast<double>(j) * p[j];
+    return sum;
+}
+
+void centered_products_avx2(const double* x, const double* y, size_t n,
+                            double mean_x, double mean_y, double out[3]) {
+    const size_t simd_size = (n / kLanes) * kLanes;
+    const __m256d vmx = _mm256_set1_pd(mean_x);
+    const __m256d vmy = _mm256_set1_pd(mean_y);
+    __m256d vxy = _mm256_setzero_pd(), vxx = _mm256_setzero_pd(), vyy = _mm256_setzero_pd();
+    for (size_t i = 0; i < simd_size; i += kLanes) {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + i), vmx);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + i), vmy);
+        vxy = _mm256_fmadd_pd(dx, dy, vxy);
+        vxx = _mm256_fmadd_pd(dx, dx, vxx);
+        vyy = _mm256_fmadd_pd(dy, dy, vyy);
+    }
+    double xy = lane_sum(vxy), xx = lane_sum(vxx), yy = lane_sum(vyy);
+    for (size_t i = simd_size; i < n; ++i) {
+        const double dx = x[i] - mean_x;
+        const double dy = y[i] - mean_y;
+        xy += dx * dy;
+        xx += dx * dx;
+        yy += dy * dy;
+    }
+    out[0] = xy;
+    out[1] = xx;
+    out[2] = yy;
+}
+
+// float32: 8 lanes for elementwise kernels; reductions widen each half to double
+constexpr size_t kFloatLanes = 8;
+
+void subtract_f32_avx2(const float* a, const float* b, float* out, size_t n) {
+    size_t i = 0;
+    for (; i + kFloatLanes <= n; i += kFloatLanes) {
+        _mm256_storeu_ps(out + i, _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    }
+    for (; i < n; ++i) out[i] = a[i] - b[i];
+}
+
+void divide_f32_avx2(const float* a, const float* b, float* out, size_t n) {
+    const __m256 vzero = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + kFloatLanes <= n; i += kFloatLanes) {
+        __m256 vb = _mm256_loadu_ps(b + i);
+        __m256 mask = _mm256_cmp_ps(vb, vzero, _CMP_NEQ_OQ);
+        _mm256_storeu_ps(out + i, _mm256_and_ps(_mm256_div_ps(_mm256_loadu_ps(a + i), vb), mask));
+    }
+    for (; i < n; ++i) out[i] = (b[i] != 0.0f) ? a[i] / b[i] : 0.0f;
+}
+
+void scale_f32_avx2(const float* in, float factor, float* out, size_t n) {
+    const __m256 vfactor = _mm256_set1_ps(factor);
+    size_t i = 0;
+    for (; i + kFloatLanes <= n; i += kFloatLanes) _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(in + i), vfactor));
+    for (; i < n; ++i) out[i] = in[i] * factor;
+}
+
+double sum_f32_avx2(const float* p, size_t n) {
+    __m256d lo = _mm256_setzero_pd(), hi = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + kFloatLanes <= n; i += kFloatLanes) {
+        lo = _mm256_add_pd(lo, _mm256_cvtps_pd(_mm_loadu_ps(p + i)));
+        hi = _mm256_add_pd(hi, _mm256_cvtps_pd(_mm_loadu_ps(p + i + 4)));
+    }
+    double sum = lane_sum(_mm256_add_pd(lo, hi));
+    for (; i < n; ++i) sum += p[i];
+    return sum;
+}
+
+double squared_deviation_sum_f32_avx2(const float* p, size_t n, double mean) {
+    const __m256d vmean = _mm256_set1_pd(mean);
+    __m256d lo = _mm256_setzero_pd(), hi = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + kFloatLanes <= n; i += kFloatLanes) {
+        __m256d dlo = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(p + i)), vmean);
+        __m256d dhi = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(p + i + 4)), vmean);
+        lo = _mm256_fmadd_pd(dlo, dlo, lo);
+        hi = _mm256_fmadd_pd(dhi, dhi, hi);
+    }
+    double sum = lane_sum(_mm256_add_pd(lo, hi));
+    for (; i < n; ++i) {
+        const double diff = p[i] - mean;
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+double index_weighted_sum_f32_avx2(const float* p, size_t n) {
+    const __m256d step = _mm256_set1_pd(static_cast<double>(kFloatLanes));
+    __m256d xlo = _mm256_set_pd(3.0, 2.0, 1.0, 0.0), xhi = _mm256_set_pd(7.0, 6.0, 5.0, 4.0);
+    __m256d lo = _mm256_setzero_pd(), hi = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + kFloatLanes <= n; i += kFloatLanes) {
+        lo = _mm256_fmadd_pd(xlo, _mm256_cvtps_pd(_mm_loadu_ps(p + i)), lo);
+        hi = _mm256_fmadd_pd(xhi, _mm256_cvtps_pd(_mm_loadu_ps(p + i + 4)), hi);
+        xlo = _mm256_add_pd(xlo, step);
+        xhi = _mm256_add_pd(xhi, step);
+    }
+    double sum = lane_sum(_mm256_add_pd(lo, hi));
+    for (; i < n; ++i) sum += static_cast<double>(i) * p[i];
+    return sum;
+}
+
+struct Avx2Ops {
+    using reg = __m256d;
+    using mask = __m256d;
+    static constexpr size_t lanes = kLanes;
+    static reg load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, reg v) { _mm256_storeu_pd(p, v); }
+    static reg set1(double x) { return _mm256_set1_pd(x); }
+    static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+    static reg div(reg a, reg b) { return _mm256_div_pd(a, b); }
+    // (a < b) ? b : a, as std::max
+    static reg max(reg a, reg b) { return _mm256_blendv_pd(a, b, _mm256_cmp_pd(a, b, _CMP_LT_OQ)); }
+    static reg abs(reg a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+    static mask gt(reg a, reg b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static mask lt(reg a, reg b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static reg select(mask m, reg t, reg f) { return _mm256_blendv_pd(f, t, m); }
+};
+
+const SimdKernels kAvx2Kernels = make_kernel_table<Avx2Ops>(
+    SimdTier::AVX2,
+    subtract_avx2,
+    divide_avx2,
+    scale_avx2,
+    sum_avx2,
+    squared_deviation_sum_avx2,
+    index_weighted_sum_avx2,
+    centered_products_avx2,
+    subtract_f32_avx2,
+    divide_f32_avx2,
+    scale_f32_avx2,
+    sum_f32_avx2,
+    squared_deviation_sum_f32_avx2,
+    index_weighted_sum_f32_avx2);
+}
+
+const SimdKernels* avx2_kernels() {
+    return &kAvx2Kernels;
+}
+
+#else
+
+const SimdKernels* avx2_kernels() {
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,262 @@
+// Built with -mavx512f (see CMakeLists.txt). Same rule as the AVX2 file: only
+// intrinsics and raw loops, nothing the linker could share with baseline code.
+#include "simd_dispatch.h"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#include "simd_kernel_bodies.h"
+
+namespace {
+constexpr size_t kLanes = 8;
+
+// Masked loads handle the tail, so no scalar remainder loops
+inline __mmask8 tail_mask(size_t remaining) {
+    return static_cast<__mmask8>((1u << remaining) - 1u);
+}
+
+void subtract_avx512(const double* a, const double* b, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        _mm512_storeu_pd(out + i, _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    }
+    if (i < n) {
+        const __mmask8 m = tail_mask(n - i);
+        _mm512_mask_storeu_pd(out + i, m, _mm512_sub_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i)));
+    }
+}
+
+// Spill and add pairwise; _mm512_reduce_add_pd trips -Wuninitialized in GCC 12 headers
+inline double lane_sum(__m512d v) {
+    double t[8];
+    _mm512_storeu_pd(t, v);
+    return ((t[0] + t[4]) + (t[2] + t[6])) + ((t[1] + t[5]) + (t[3] + t[7]));
+}
+
+inline __m512d divide_nonzero(__m512d va, __m512d vb) {
+    // Lanes with a zero divisor produce 0
+    const __mmask8 nonzero = _mm512_cmp_pd_mask(vb, _mm512_setzero_pd(), _CMP_NEQ_OQ);
+    return _mm512_maskz_div_pd(nonzero, va, vb);
+}
+
+void divide_avx512(const double* a, const double* b, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        _mm512_storeu_pd(out + i, divide_nonzero(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    }
+    if (i < n) {
+        const __mmask8 m = tail_mask(n - i);
+        _mm512_mask_storeu_pd(out + i, m, divide_nonzero(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i)));
+    }
+}
+
+void scale_avx512(const double* in, double factor, double* out, size_t n) {
+    const __m512d vfactor = _mm512_set1_pd(factor);
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) _mm512_storeu_pd(out + i, _mm512_mul_pd(_mm512_loadu_pd(in + i), vfactor));
+    if (i < n) {
+        const __mmask8 m = tail_mask(n - i);
+        _mm512_mask_storeu_pd(out + i, m, _mm512_mul_pd(_mm512_maskz_loadu_pd(m, in + i), vfactor));
+    }
+}
+
+double sum_avx512(const double* p, size_t n) {
+    __m512d vsum = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) vsum = _mm512_add_pd(vsum, _mm512_loadu_pd(p + i));
+    if (i < n) vsum = _mm512_add_pd(vsum, _mm512_maskz_loadu_pd(tail_mask(n - i), p + i));
+    return lane_sum(vsum);
+}
+
+double squared_deviation_sum_avx512(const double* p, size_t n, double mean) {
+    const __m512d vmean = _mm512_set1_pd(mean);
+    __m512d vvar = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        __m512d vdiff = _mm512_sub_pd(_mm512_loadu_pd(p + i), vmean);
+        vvar = _mm512_fmadd_pd(vdiff, vdiff, vvar);
+    }
+    if (i < n) {
+        const __mmask8 m = tail_mask(n - i);
+        __m512d vdiff = _mm512_maskz_sub_pd(m, _mm512_maskz_loadu_pd(m, p + i), vmean);
+        vvar = _mm512_fmadd_pd(vdiff, vdiff, vvar);
+    }
+    return lane_sum(vvar);
+}
+
+double index_weighted_sum_avx512(const double* p, size_t n) {
+    const __m512d step = _mm512_set1_pd(static_cast<double>(kLanes));
+    __m512d vx = _mm512_set_pd(7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0, 0.0);
+    __m512d vsum = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        vsum = _mm512_fmadd_pd(vx, _mm512_loadu_pd(p + i), vsum);
+        vx = _mm512_add_pd(vx, step);
+    }
+    if (i < n) vsum = _mm512_fmadd_pd(vx, _mm512_maskz_loadu_pd(tail_mask(n - i), p + i), vsum);
+    return lane_sum(vsum);
+}
+
+void centered_products_avx512(const double* x, const double* y, size_t n,
+                              double mean_x, double mean_y, double out[3]) {
+    const __m512d vmx = _mm512_set1_pd(mean_x);
+    const __m512d vmy = _mm512_set1_pd(mean_y);
+    __m512d vxy = _mm512_setzero_pd(), vxx = _mm512_setzero_pd(), vyy = _mm512_setzero_pd();
+    auto accumulate = [&](__m512d dx, __m512d dy) {
+        vxy = _mm512_fmadd_pd(dx, dy, vxy);
+        vxx = _mm512_fmadd_pd(dx, dx, vxx);
+        vyy = _mm512_fmadd_pd(dy, dy, vyy);
+    };
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        accumulate(_mm512_sub_pd(_mm512_loadu_pd(x + i), vmx), _mm512_sub_pd(_mm512_loadu_pd(y + i), vmy));
+    }
+    if (i < n) {
+        const __mmask8 m = tail_mask(n - i);
+        accumulate(_mm512_maskz_sub_pd(m, _mm512_maskz_loadu_pd(m, x + i), vmx),
+                   _mm512_maskz_sub_pd(m, _mm512_maskz_loadu_pd(m, y + i), vmy));
+    }
+    out[0] = lane_sum(vxy);
+    out[1] = lane_sum(vxx);
+    out[2] = lane_sum(vyy);
+}
+
+// float32: 16 lanes for elementwise kernels, masked tails as above
+constexpr size_t kFloatLanes = 16;
+
+inline __mmask16 tail_mask16(size_t remaining) {
+    return static_cast<__mmask16>((1u << remaining) - 1u);
+}
+
+inline __m512 divide_nonzero_ps(__m512 va, __m512 vb) {
+    const __mmask16 nonzero = _mm512_cmp_ps_mask(vb, _mm512_setzero_ps(), _CMP_NEQ_OQ);
+    return _mm512_maskz_div_ps(nonzero, va, vb);
+}
+
+void subtract_f32_avx512(const float* a, const float* b, float* out, size_t n) {
+    size_t i = 0;
+    for (; i + kFloatLanes <= n; i += kFloatLanes) {
+        _mm512_storeu_ps(out + i, _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+    }
+    if (i < n) {
+        const __mmask16 m = tail_mask16(n - i);
+        _mm512_mask_storeu_ps(out + i, m, _mm512_sub_ps(_mm512_maskz_loadu_ps(m, a + i), _mm512_maskz_loadu_ps(m, b + i)));
+    }
+}
+
+void divide_f32_avx512(const float* a, const float* b, float* out, size_t n) {
+    size_t i = 0;
+    for (; i + kFloatLanes <= n; i += kFloatLanes) {
+        _mm512_storeu_ps(out + i, divide_nonzero_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+    }
+    if (i < n) {
+        const __mmask16 m = tail_mask16(n - i);
+        _mm512_mask_storeu_ps(out + i, m, divide_nonzero_ps(_mm512_maskz_loadu_ps(m, a + i), _mm512_maskz_loadu_ps(m, b + i)));
+    }
+}
+
+void scale_f32_avx512(const float* in, float factor, float* out, size_t n) {
+    const __m512 vfactor = _mm512_set1_ps(factor);
+    size_t i = 0;
+    for (; i + kFloatLanes <= n; i += kFloatLanes) _mm512_storeu_ps(out + i, _mm512_mul_ps(_mm512_loadu_ps(in + i), vfactor));
+    if (i < n) {
+        const __mmask16 m = tail_mask16(n - i);
+        _mm512_mask_storeu_ps(out + i, m, _mm512_mul_ps(_mm512_maskz_loadu_ps(m, in + i), vfactor));
+    }
+}
+
+// Reductions step 8 floats at a time, widened to one double register
+constexpr size_t kWidenLanes = 8;
+
+inline __m512d load_widened(const float* p) {
+    return _mm512_cvtps_pd(_mm256_loadu_ps(p));
+}
+
+// Tail of fewer than 8 floats; masked-off lanes load as 0
+inline __m512d load_widened(const float* p, size_t remaining) {
+    return _mm512_cvtps_pd(_mm512_castps512_ps256(_mm512_maskz_loadu_ps(tail_mask16(remaining), p)));
+}
+
+double sum_f32_avx512(const float* p, size_t n) {
+    __m512d vsum = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + kWidenLanes <= n; i += kWidenLanes) vsum = _mm512_add_pd(vsum, load_widened(p + i));
+    if (i < n) vsum = _mm512_add_pd(vsum, load_widened(p + i, n - i));
+    return lane_sum(vsum);
+}
+
+double squared_deviation_sum_f32_avx512(const float* p, size_t n, double mean) {
+    const __m512d vmean = _mm512_set1_pd(mean);
+    __m512d vvar = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + kWidenLanes <= n; i += kWidenLanes) {
+        __m512d vdiff = _mm512_sub_pd(load_widened(p + i), vmean);
+        vvar = _mm512_fmadd_pd(vdiff, vdiff, vvar);
+    }
+    if (i < n) {
+        const __mmask8 m = tail_mask(n - i);
+        __m512d vdiff = _mm512_maskz_sub_pd(m, load_widened(p + i, n - i), vmean);
+        vvar = _mm512_fmadd_pd(vdiff, vdiff, vvar);
+    }
+    return lane_sum(vvar);
+}
+
+double index_weighted_sum_f32_avx512(const float* p, size_t n) {
+    const __m512d step = _mm512_set1_pd(static_cast<double>(kWidenLanes));
+    __m512d vx = _mm512_set_pd(7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0, 0.0);
+    __m512d vsum = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + kWidenLanes <= n; i += kWidenLanes) {
+        vsum = _mm512_fmadd_pd(vx, load_widened(p + i), vsum);
+        vx = _mm512_add_pd(vx, step);
+    }
+    if (i < n) vsum = _mm512_fmadd_pd(vx, load_widened(p + i, n - i), vsum);
+    return lane_sum(vsum);
+}
+
+struct Avx512Ops {
+    using reg = __m512d;
+    using mask = __mmask8;
+    static constexpr size_t lanes = kLanes;
+    static reg load(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, reg v) { _mm512_storeu_pd(p, v); }
+    static reg set1(double x) { return _mm512_set1_pd(x); }
+    static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+    static reg div(reg a, reg b) { return _mm512_div_pd(a, b); }
+    // (a < b) ? b : a, as std::max
+    static reg max(reg a, reg b) { return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(a, b, _CMP_LT_OQ), a, b); }
+    static reg abs(reg a) { return _mm512_abs_pd(a); }
+    static mask gt(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    static mask lt(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static reg select(mask m, reg t, reg f) { return _mm512_mask_blend_pd(m, f, t); }
+};
+
+const SimdKernels kAvx512Kernels = make_kernel_table<Avx512Ops>(
+    SimdTier::AVX512,
+    subtract_avx512,
+    divide_avx512,
+    scale_avx512,
+    sum_avx512,
+    squared_deviation_sum_avx512,
+    index_weighted_sum_avx512,
+    centered_products_avx512,
+    subtract_f32_avx512,
+    divide_f32_avx512,
+    scale_f32_avx512,
+    sum_f32_avx512,
+    squared_deviation_sum_f32_avx512,
+    index_weighted_sum_f32_avx512);
+}
+
+const SimdKernels* avx512_kernels() {
+    return &kAvx512Kernels;
+}
+
+#else
+
+const SimdKernels* avx512_kernels() {
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,225 @@
+// AArch64 NEON kernels (float64x2). NEON is part of the AArch64 baseline, so
+// this file needs no extra flags; on other targets the table is absent.
+#include "simd_dispatch.h"
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#include "simd_kernel_bodies.h"
+
+namespace {
+constexpr size_t kLanes = 2;
+
+void subtract_neon(const double* a, const double* b, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) vst1q_f64(out + i, vsubq_f64(vld1q_f64(a + i), vld1q_f64(b + i)));
+    for (; i < n; ++i) out[i] = a[i] - b[i];
+}
+
+void divide_neon(const double* a, const double* b, double* out, size_t n) {
+    const float64x2_t vzero = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        float64x2_t vb = vld1q_f64(b + i);
+        // Zero out lanes where the divisor was zero
+        uint64x2_t zero = vceqq_f64(vb, vzero);
+        float64x2_t q = vdivq_f64(vld1q_f64(a + i), vb);
+        vst1q_f64(out + i, vbslq_f64(zero, vzero, q));
+    }
+    for (; i < n; ++i) out[i] = (b[i] != 0.0) ? a[i] / b[i] : 0.0;
+}
+
+void scale_neon(const double* in, double factor, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) vst1q_f64(out + i, vmulq_n_f64(vld1q_f64(in + i), factor));
+    for (; i < n; ++i) out[i] = in[i] * factor;
+}
+
+double sum_neon(const double* p, size_t n) {
+    float64x2_t vsum = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) vsum = vaddq_f64(vsum, vld1q_f64(p + i));
+    double sum = vaddvq_f64(vsum);
+    for (; i < n; ++i) sum += p[i];
+    return sum;
+}
+
+double squared_deviation_sum_neon(const double* p, size_t n, double mean) {
+    const float64x2_t vmean = vdupq_n_f64(mean);
+    float64x2_t vvar = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        float64x2_t vdiff = vsubq_f64(vld1q_f64(p + i), vmean);
+        vvar = vfmaq_f64(vvar, vdiff, vdiff);
+    }
+    double sum = vaddvq_f64(vvar);
+    for (; i < n; ++i) {
+        const double diff = p[i] - mean;
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+double index_weighted_sum_neon(const double* p, size_t n) {
+    const float64x2_t step = vdupq_n_f64(static_cast<double>(kLanes));
+    const double first[2] = {0.0, 1.0};
+    float64x2_t vx = vld1q_f64(first);
+    float64x2_t vsum = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        vsum = vfmaq_f64(vsum, vx, vld1q_f64(p + i));
+        vx = vaddq_f64(vx, step);
+    }
+    double sum = vaddvq_f64(vsum);
+    for (; i < n; ++i) sum += static_cast<double>(i) * p[i];
+    return sum;
+}
+
+void centered_products_neon(const double* x, const double* y, size_t n,
+                            double mean_x, double mean_y, double out[3]) {
+    const float64x2_t vmx = vdupq_n_f64(mean_x);
+    const float64x2_t vmy = vdupq_n_f64(mean_y);
+    float64x2_t vxy = vdupq_n_f64(0.0), vxx = vdupq_n_f64(0.0), vyy = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        float64x2_t dx = vsubq_f64(vld1q_f64(x + i), vmx);
+        float64x2_t dy = vsubq_f64(vld1q_f64(y + i), vmy);
+        vxy = vfmaq_f64(vxy, dx, dy);
+        vxx = vfmaq_f64(vxx, dx, dx);
+        vyy = vfmaq_f64(vyy, dy, dy);
+    }
+    double xy = vaddvq_f64(vxy), xx = vaddvq_f64(vxx), yy = vaddvq_f64(vyy);
+    for (; i < n; ++i) {
+        const double dx = x[i] - mean_x;
+        const double dy = y[i] - mean_y;
+        xy += dx * dy;
+        xx += dx * dx;
+        yy += dy * dy;
+    }
+    out[0] = xy;
+    out[1] = xx;
+    out[2] = yy;
+}
+
+// float32: 4 lanes for elementwise kernels; reductions widen each half to double
+constexpr size_t kFloatLanes = 4;
+
+void subtract_f32_neon(const float* a, const float* b, float* out, size_t n) {
+    size_t i = 0;
+    for (; i + kFloatLanes <= n; i += kFloatLanes) vst1q_f32(out + i, vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+    for (; i < n; ++i) out[i] = a[i] - b[i];
+}
+
+void divide_f32_neon(const float* a, const float* b, float* out, size_t n) {
+    const float32x4_t vzero = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + kFloatLanes <= n; i += kFloatLanes) {
+        float32x4_t vb = vld1q_f32(b + i);
+        uint32x4_t zero = vceqq_f32(vb, vzero);
+        vst1q_f32(out + i, vbslq_f32(zero, vzero, vdivq_f32(vld1q_f32(a + i), vb)));
+    }
+    for (; i < n; ++i) out[i] = (b[i] != 0.0f) ? a[i] / b[i] : 0.0f;
+}
+
+void scale_f32_neon(const float* in, float factor, float* out, size_t n) {
+    size_t i = 0;
+    for (; i + kFloatLanes <= n; i += kFloatLanes) vst1q_f32(out + i, vmulq_n_f32(vld1q_f32(in + i), factor));
+    for (; i < n; ++i) out[i] = in[i] * factor;
+}
+
+double sum_f32_neon(const float* p, size_t n) {
+    float64x2_t lo = vdupq_n_f64(0.0), hi = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + kFloatLanes <= n; i += kFloatLanes) {
+        float32x4_t v = vld1q_f32(p + i);
+        lo = vaddq_f64(lo, vcvt_f64_f32(vget_low_f32(v)));
+        hi = vaddq_f64(hi, vcvt_high_f64_f32(v));
+    }
+    double sum = vaddvq_f64(vaddq_f64(lo, hi));
+    for (; i < n; ++i) sum += p[i];
+    return sum;
+}
+
+double squared_deviation_sum_f32_neon(const float* p, size_t n, double mean) {
+    const float64x2_t vmean = vdupq_n_f64(mean);
+    float64x2_t lo = vdupq_n_f64(0.0), hi = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + kFloatLanes <= n; i += kFloatLanes) {
+        float32x4_t v = vld1q_f32(p + i);
+        float64x2_t dlo = vsubq_f64(vcvt_f64_f32(vget_low_f32(v)), vmean);
+        float64x2_t dhi = vsubq_f64(vcvt_high_f64_f32(v), vmean);
+        lo = vfmaq_f64(lo, dlo, dlo);
+        hi = vfmaq_f64(hi, dhi, dhi);
+    }
+    double sum = vaddvq_f64(vaddq_f64(lo, hi));
+    for (; i < n; ++i) {
+        const double diff = p[i] - mean;
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+double index_weighted_sum_f32_neon(const float* p, size_t n) {
+    const float64x2_t step = vdupq_n_f64(static_cast<double>(kFloatLanes));
+    const double first[4] = {0.0, 1.0, 2.0, 3.0};
+    float64x2_t xlo = vld1q_f64(first), xhi = vld1q_f64(first + 2);
+    float64x2_t lo = vdupq_n_f64(0.0), hi = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + kFloatLanes <= n; i += kFloatLanes) {
+        float32x4_t v = vld1q_f32(p + i);
+        lo = vfmaq_f64(lo, xlo, vcvt_f64_f32(vget_low_f32(v)));
+        hi = vfmaq_f64(hi, xhi, vcvt_high_f64_f32(v));
+        xlo = vaddq_f64(xlo, step);
+        xhi = vaddq_f64(xhi, step);
+    }
+    double sum = vaddvq_f64(vaddq_f64(lo, hi));
+    for (; i < n; ++i) sum += static_cast<double>(i) * p[i];
+    return sum;
+}
+
+struct NeonOps {
+    using reg = float64x2_t;
+    using mask = uint64x2_t;
+    static constexpr size_t lanes = kLanes;
+    static reg load(const double* p) { return vld1q_f64(p); }
+    static void store(double* p, reg v) { vst1q_f64(p, v); }
+    static reg set1(double x) { return vdupq_n_f64(x); }
+    static reg add(reg a, reg b) { return vaddq_f64(a, b); }
+    static reg sub(reg a, reg b) { return vsubq_f64(a, b); }
+    static reg mul(reg a, reg b) { return vmulq_f64(a, b); }
+    static reg div(reg a, reg b) { return vdivq_f64(a, b); }
+    // (a < b) ? b : a, as std::max
+    static reg max(reg a, reg b) { return vbslq_f64(vcltq_f64(a, b), b, a); }
+    static reg abs(reg a) { return vabsq_f64(a); }
+    static mask gt(reg a, reg b) { return vcgtq_f64(a, b); }
+    static mask lt(reg a, reg b) { return vcltq_f64(a, b); }
+    static reg select(mask m, reg t, reg f) { return vbslq_f64(m, t, f); }
+};
+
+const SimdKernels kNeonKernels = make_kernel_table<NeonOps>(
+    SimdTier::NEON,
+    subtract_neon,
+    divide_neon,
+    scale_neon,
+    sum_neon,
+    squared_deviation_sum_neon,
+    index_weighted_sum_neon,
+    centered_products_neon,
+    subtract_f32_neon,
+    divide_f32_neon,
+    scale_f32_neon,
+    sum_f32_neon,
+    squared_deviation_sum_f32_neon,
+    index_weighted_sum_f32_neon);
+}
+
+const SimdKernels* neon_kernels() {
+    return &kNeonKernels;
+}
+
+#else
+
+const SimdKernels* neon_kernels() {
+    return nullptr;
+}
+
+#endif
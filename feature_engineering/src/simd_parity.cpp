@@ -0,0 +1,122 @@
+#include "../include/simd_parity.h"
+#include "../include/simd_technical_indicators.h"
+#include "../include/technical_indicators.h"
+#include "../include/simd_dispatch.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+struct ParityCase {
+    const char* name;
+    std::function<std::vector<double>()> vector;
+    std::function<std::vector<double>()> scalar;
+    double tolerance = 1e-9;
+};
+
+// Worst mismatch relative to max(1, |scalar|); a length mismatch counts as infinite
+double parity_error(const std::vector<double>& got, const std::vector<double>& want) {
+    if (got.size() != want.size()) return INFINITY;
+    double worst = 0.0;
+    for (size_t i = 0; i < got.size(); ++i) {
+        worst = std::max(worst, std::abs(got[i] - want[i]) / std::max(1.0, std::abs(want[i])));
+    }
+    return worst;
+}
+}
+
+bool run_simd_parity_check() {
+    // float32 kernels are held to float precision against the double reference
+    const double float_tolerance = 1e-5;
+    const SimdTier original = active_simd_tier();
+    bool passed = true;
+
+    // Lengths around the lane widths and windows exercise every tail path
+    const std::vector<size_t> sizes = {1, 2, 14, 15, 16, 21, 37, 64, 1000};
+    std::mt19937 gen(42);
+    std::normal_distribution<double> move(0.0, 0.01);
+    std::uniform_real_distribution<double> wick(0.0, 0.01);
+    std::uniform_int_distribution<int> lots(0, 2000);
+
+    std::vector<SimdTier> tiers;
+    for (SimdTier tier : {SimdTier::AVX512, SimdTier::AVX2, SimdTier::NEON}) {
+        if (limit_simd_tier(tier) == tier) tiers.push_back(tier);
+    }
+    if (tiers.empty()) std::cout << "No vector SIMD tier on this CPU; nothing to compare" << std::endl;
+
+    for (size_t n : sizes) {
+        std::vector<double> high(n), low(n), close(n), volume(n);
+        double price = 100.0;
+        for (size_t i = 0; i < n; ++i) {
+            // Cent rounding leaves unchanged bars, the tie case of every direction test
+            price = std::round(price * (1.0 + move(gen)) * 100.0) / 100.0;
+            close[i] = price;
+            high[i] = (i % 11 == 0) ? price : price * (1.0 + wick(gen));
+            low[i] = (i % 11 == 0) ? price : price * (1.0 - wick(gen));
+            volume[i] = static_cast<double>(lots(gen));
+        }
+        const auto sma = TechnicalIndicators::simple_moving_average(close, 20);
+        const std::vector<float> close32(close.begin(), close.end());
+        auto widened = [n](auto&& kernel) {
+            std::vector<float> out(n);
+            const size_t count = kernel(out.data());
+            return std::vector<double>(out.begin(), out.begin() + count);
+        };
+
+        const std::vector<ParityCase> cases = {
+            {"rsi_14", [&] { return SIMDTechnicalIndicators::calculate_rsi_simd(close, 14); },
+                       [&] { return TechnicalIndicators::calculate_rsi(close, 14); }},
+            {"internal_bar_strength", [&] {
+                 std::vector<double> out(n);
+                 SIMDTechnicalIndicators::internal_bar_strength_simd(high.data(), low.data(), close.data(), n, out.data());
+                 return out;
+             }, [&] { return TechnicalIndicators::internal_bar_strength(close, high, low, close); }},
+            {"detrended_price_oscillator_20", [&] { return SIMDTechnicalIndicators::detrended_price_oscillator_simd(close, sma, 20); },
+                                              [&] { return TechnicalIndicators::detrended_price_oscillator(close, sma, 20); }},
+            {"chande_momentum_oscillator_14", [&] { return SIMDTechnicalIndicators::chande_momentum_oscillator_14_simd(close); },
+                                              [&] { return TechnicalIndicators::chande_momentum_oscillator_14(close); }},
+            {"vortex_indicator_14", [&] { return SIMDTechnicalIndicators::vortex_indicator_14_simd(high, low, close); },
+                                    [&] { return TechnicalIndicators::vortex_indicator_14(high, low, close); }},
+            {"adx_rating_14", [&] { return SIMDTechnicalIndicators::adx_rating_14_simd(high, low, close); },
+                              [&] { return TechnicalIndicators::adx_rating_14(high, low, close); }},
+            {"money_flow_index_14", [&] { return SIMDTechnicalIndicators::money_flow_index_14_simd(high, low, close, volume); },
+                                    [&] { return TechnicalIndicators::money_flow_index_14(high, low, close, volume); }},
+            {"on_balance_volume_sma_20", [&] { return SIMDTechnicalIndicators::on_balance_volume_sma_20_simd(close, volume); },
+                                         [&] { return TechnicalIndicators::on_balance_volume_sma_20(close, volume); }},
+            {"klinger_oscillator_34_55", [&] { return SIMDTechnicalIndicators::klinger_oscillator_34_55_simd(high, low, close, volume); },
+                                         [&] { return TechnicalIndicators::klinger_oscillator_34_55(high, low, close, volume); }},
+            {"ulcer_index_14", [&] { return SIMDTechnicalIndicators::ulcer_index_14_simd(close); },
+                               [&] { return TechnicalIndicators::ulcer_index_14(close); }},
+            {"momentum_f32", [&] { return widened([&](float* out) { return SIMDTechnicalIndicators::calculate_momentum_f32(close32.data(), n, 10, out); }); },
+                             [&] {
+                                 std::vector<double> out(n);
+                                 out.resize(TechnicalIndicators::momentum(close.data(), n, 10, out.data()));
+                                 return out;
+                             }, float_tolerance},
+            {"log_pct_change_f32", [&] { return widened([&](float* out) { return SIMDTechnicalIndicators::log_pct_change_f32(close32.data(), n, 5, out); }); },
+                                   [&] { return TechnicalIndicators::log_pct_change(close, 5); }, float_tolerance},
+            {"linear_slope_f32", [&] { return widened([&](float* out) { return SIMDTechnicalIndicators::linear_slope_f32(close32.data(), n, 20, out); }); },
+                                 [&] { return TechnicalIndicators::linear_slope(close, 20); }, float_tolerance},
+        };
+
+        for (const ParityCase& c : cases) {
+            const auto want = c.scalar();
+            for (SimdTier tier : tiers) {
+                limit_simd_tier(tier);
+                const double error = parity_error(c.vector(), want);
+                if (!(error <= c.tolerance)) {
+                    passed = false;
+                    std::cout << "MISMATCH " << c.name << " n=" << n << " tier=" << simd_tier_name(tier)
+                              << " error=" << std::scientific << error << std::defaultfloat << std::endl;
+                }
+            }
+        }
+    }
+
+    limit_simd_tier(original);
+    std::cout << "SIMD parity (" << tiers.size() << " tier(s) vs scalar): " << (passed ? "PASS" : "FAIL") << std::endl;
+    return passed;
+}
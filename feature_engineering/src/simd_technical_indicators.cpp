@@ -1,94 +1,69 @@
 #include "../include/simd_technical_indicators.h"
 #include "../include/technical_indicators.h"
+#include "../include/simd_dispatch.h"
+#include "../include/rolling_statistics.h"
+#include "../include/fixed_window.h"
 #include <stdexcept>
 #include <numeric>
 #include <cmath>
 
-#if SIMD_ENABLED
+namespace {
+// Kernels of the active tier, nullptr when it is scalar
+const SimdKernels* vector_kernels() {
+    const SimdKernels& kernels = simd_kernels();
+    return kernels.tier == SimdTier::Scalar ? nullptr : &kernels;
+}
+
+// Per-thread intermediates of the span kernels, grown to the longest series
+// seen; slots are distinct arrays live within one call
+double* scratch(size_t slot, size_t n) {
+    thread_local std::vector<double> buffers[6];
+    std::vector<double>& buffer = buffers[slot];
+    if (buffer.size() < n) buffer.resize(n);
+    return buffer.data();
+}
+
+template <typename Kernel>
+std::vector<double> collect(size_t max_size, Kernel&& kernel) {
+    std::vector<double> out(max_size);
+    out.resize(kernel(out.data()));
+    return out;
+}
+}
+
 // SIMD helper function implementations
 std::vector<double> SIMDTechnicalIndicators::simd_subtract_arrays(
     const std::vector<double>& a, const std::vector<double>& b) {
     if (a.size() != b.size()) return {};
-    
     std::vector<double> result(a.size());
-    const size_t size = a.size();
-    const size_t simd_size = (size / AVX2_DOUBLE_COUNT) * AVX2_DOUBLE_COUNT;
-
-    for (size_t i = 0; i < simd_size; i += AVX2_DOUBLE_COUNT) {
-        // Prefetch can be added here if arrays are very large
-        __m256d va = _mm256_loadu_pd(&a[i]);
-        __m256d vb = _mm256_loadu_pd(&b[i]);
-        __m256d vresult = _mm256_sub_pd(va, vb);
-        _mm256_storeu_pd(&result[i], vresult);
-    }
-    for (size_t i = simd_size; i < size; ++i) result[i] = a[i] - b[i];
+    simd_kernels().subtract(a.data(), b.data(), result.data(), a.size());
     return result;
 }
 
 std::vector<double> SIMDTechnicalIndicators::simd_divide_arrays(
     const std::vector<double>& a, const std::vector<double>& b) {
     if (a.size() != b.size()) return {};
-
     std::vector<double> result(a.size());
-    const size_t size = a.size();
-    const size_t simd_size = (size / AVX2_DOUBLE_COUNT) * AVX2_DOUBLE_COUNT;
-    const __m256d vzero = _mm256_setzero_pd();
-
-    for (size_t i = 0; i < simd_size; i += AVX2_DOUBLE_COUNT) {
-        __m256d va = _mm256_loadu_pd(&a[i]);
-        __m256d vb = _mm256_loadu_pd(&b[i]);
-        // Avoid division by zero by creating a mask
-        __m256d mask = _mm256_cmp_pd(vb, vzero, _CMP_NEQ_OQ);
-        __m256d vresult = _mm256_div_pd(va, vb);
-        // Use mask to zero out results where divisor was zero
-        vresult = _mm256_and_pd(vresult, mask);
-        _mm256_storeu_pd(&result[i], vresult);
-    }
-    for (size_t i = simd_size; i < size; ++i) result[i] = (b[i] != 0.0) ? a[i] / b[i] : 0.0;
+    simd_kernels().divide(a.data(), b.data(), result.data(), a.size());
     return result;
 }
 
 double SIMDTechnicalIndicators::simd_sum_array(const std::vector<double>& data, size_t start, size_t count) {
     if (start + count > data.size()) return 0.0;
-
-    double sum = 0.0;
-    const size_t simd_end = start + (count / AVX2_DOUBLE_COUNT) * AVX2_DOUBLE_COUNT;
-    __m256d vsum = _mm256_setzero_pd();
-
-    for (size_t i = start; i < simd_end; i += AVX2_DOUBLE_COUNT) {
-        __m256d vdata = _mm256_loadu_pd(&data[i]);
-        vsum = _mm256_add_pd(vsum, vdata);
-    }
-    
-    // Horizontal sum
-    __m128d vlow = _mm256_castpd256_pd128(vsum);
-    __m128d vhigh = _mm256_extractf128_pd(vsum, 1);
-    vlow = _mm_add_pd(vlow, vhigh);
-    __m128d high64 = _mm_unpackhi_pd(vlow, vlow);
-    sum = _mm_cvtsd_f64(_mm_add_sd(vlow, high64));
-    
-    for (size_t i = simd_end - start; i < count; ++i) sum += data[start + i];
-    return sum;
+    return simd_kernels().sum(data.data() + start, count);
 }
 
 std::vector<double> SIMDTechnicalIndicators::simd_rolling_sum(const std::vector<double>& data, size_t window) {
-    if (data.size() < window) return {};
-
-    std::vector<double> result;
-    result.reserve(data.size() - window + 1);
-    
-    double sum = simd_sum_array(data, 0, window);
-    result.push_back(sum);
-    
-    for (size_t i = 1; i <= data.size() - window; ++i) {
-        sum = sum - data[i - 1] + data[i + window - 1];
-        result.push_back(sum);
-    }
+    // Shared with the NEON tier and SIMDStatistics (rolling_statistics.h)
+    if (window == 0 || data.size() < window) return {};
+    std::vector<double> result(data.size() - window + 1);
+    RollingStatistics::sum(data.data(), data.size(), window, result.data());
     return result;
 }
 
 // High-level indicator implementations
 std::vector<double> SIMDTechnicalIndicators::calculate_returns_simd(const std::vector<double>& prices) {
+    if (!vector_kernels()) return TechnicalIndicators::calculate_returns(prices);
     if (prices.size() < 2) return {};
     std::vector<double> current(prices.begin() + 1, prices.end());
     std::vector<double> previous(prices.begin(), prices.end() - 1);
@@ -97,152 +72,387 @@ std::vector<double> SIMDTechnicalIndicators::calculate_returns_simd(const std::v
 }
 
 std::vector<double> SIMDTechnicalIndicators::simple_moving_average_simd(const std::vector<double>& data, size_t window) {
-    auto sums = simd_rolling_sum(data, window);
-    if (sums.empty()) return {};
-
-    std::vector<double> result(sums.size());
-    const double inv_window = 1.0 / window;
-    const __m256d vinv = _mm256_set1_pd(inv_window);
-    const size_t size = sums.size();
-    const size_t simd_size = (size / AVX2_DOUBLE_COUNT) * AVX2_DOUBLE_COUNT;
-
-    for (size_t i = 0; i < simd_size; i += AVX2_DOUBLE_COUNT) {
-        __m256d vsum = _mm256_loadu_pd(&sums[i]);
-        __m256d vresult = _mm256_mul_pd(vsum, vinv);
-        _mm256_storeu_pd(&result[i], vresult);
-    }
-    for (size_t i = simd_size; i < size; ++i) result[i] = sums[i] * inv_window;
+    if (!vector_kernels()) return TechnicalIndicators::simple_moving_average(data, window);
+    if (window == 0 || data.size() < window) return {};
+    std::vector<double> result(data.size() - window + 1);
+    RollingStatistics::mean(data.data(), data.size(), window, result.data());
     return result;
 }
 
 std::vector<double> SIMDTechnicalIndicators::calculate_rolling_volatility_simd(const std::vector<double>& returns, int window) {
-    if (returns.size() < static_cast<size_t>(window) || window <=1) return {};
-
-    std::vector<double> volatility;
-    volatility.reserve(returns.size() - window + 1);
-
-    for (size_t i = 0; i <= returns.size() - window; ++i) {
-        double mean = simd_sum_array(returns, i, window) / window;
-        
-        double variance = 0.0;
-        const size_t simd_end = i + (window / AVX2_DOUBLE_COUNT) * AVX2_DOUBLE_COUNT;
-        const __m256d vmean = _mm256_set1_pd(mean);
-        __m256d vvar = _mm256_setzero_pd();
-        
-        for (size_t j = i; j < simd_end; j += AVX2_DOUBLE_COUNT) {
-            __m256d vdata = _mm256_loadu_pd(&returns[j]);
-            __m256d vdiff = _mm256_sub_pd(vdata, vmean);
-            vvar = _mm256_fmadd_pd(vdiff, vdiff, vvar); // Fused multiply-add
-        }
-
-        double temp[4];
-        _mm256_storeu_pd(temp, vvar);
-        variance = temp[0] + temp[1] + temp[2] + temp[3];
-
-        for (size_t j = simd_end - i; j < static_cast<size_t>(window); ++j) {
-            double diff = returns[i + j] - mean;
-            variance += diff * diff;
-        }
-        volatility.push_back(std::sqrt(variance / (window - 1)));
-    }
+    if (!vector_kernels()) return TechnicalIndicators::calculate_rolling_volatility(returns, window);
+    if (returns.size() < static_cast<size_t>(window) || window <= 1) return {};
+    std::vector<double> volatility(returns.size() - window + 1);
+    RollingStatistics::stddev(returns.data(), returns.size(), static_cast<size_t>(window), volatility.data());
     return volatility;
 }
 
 std::vector<double> SIMDTechnicalIndicators::compute_spread_simd(const std::vector<double>& high, const std::vector<double>& low) {
-    return simd_subtract_arrays(high, low);
+    if (!vector_kernels()) return TechnicalIndicators::compute_spread(high, low);
+    if (high.size() != low.size()) return {};
+    return collect(high.size(), [&](double* out) { return compute_spread_simd(high.data(), low.data(), high.size(), out); });
+}
+
+size_t SIMDTechnicalIndicators::compute_spread_simd(const double* high, const double* low, size_t n, double* out) {
+    if (!vector_kernels()) return TechnicalIndicators::compute_spread(high, low, n, out);
+    simd_kernels().subtract(high, low, out, n);
+    return n;
 }
 
 
 std::vector<double> SIMDTechnicalIndicators::linear_slope_simd(const std::vector<double>& prices, int window_size) {
-     if (prices.size() < static_cast<size_t>(window_size)) return {};
+    if (!vector_kernels()) return TechnicalIndicators::linear_slope(prices, window_size);
+    if (prices.size() < static_cast<size_t>(window_size)) return {};
+    return collect(prices.size() - window_size + 1, [&](double* out) { return linear_slope_simd(prices.data(), prices.size(), window_size, out); });
+}
+
+size_t SIMDTechnicalIndicators::linear_slope_simd(const double* prices, size_t n, int window_size, double* out) {
+    const SimdKernels* kernels = vector_kernels();
+    if (!kernels) return TechnicalIndicators::linear_slope(prices, n, window_size, out);
+    if (n < static_cast<size_t>(window_size)) return 0;
 
-    std::vector<double> result;
-    result.reserve(prices.size() - window_size + 1);
-    
     const double sum_x = static_cast<double>(window_size * (window_size - 1)) / 2.0;
     const double sum_x2 = static_cast<double>(window_size * (window_size - 1) * (2 * window_size - 1)) / 6.0;
     const double den = window_size * sum_x2 - sum_x * sum_x;
-    if (den == 0) return {};
-
-    for (size_t i = 0; i <= prices.size() - window_size; ++i) {
-        double sum_y = simd_sum_array(prices, i, window_size);
-        double sum_xy = 0.0;
-        
-        const size_t simd_end = i + (window_size / AVX2_DOUBLE_COUNT) * AVX2_DOUBLE_COUNT;
-        __m256d vsum_xy = _mm256_setzero_pd();
-        for (size_t j = 0; j < (simd_end-i); j += AVX2_DOUBLE_COUNT) {
-            __m256d vy = _mm256_loadu_pd(&prices[i + j]);
-            __m256d vx = _mm256_set_pd(j + 3, j + 2, j + 1, j);
-            vsum_xy = _mm256_fmadd_pd(vx, vy, vsum_xy);
-        }
-        
-        double temp[4];
-        _mm256_storeu_pd(temp, vsum_xy);
-        sum_xy = temp[0] + temp[1] + temp[2] + temp[3];
-        
-        for (size_t j = simd_end-i; j < static_cast<size_t>(window_size); ++j) {
-            sum_xy += j * prices[i + j];
-        }
-        
-        result.push_back((window_size * sum_xy - sum_x * sum_y) / den);
+    if (den == 0) return 0;
+
+    const size_t count = n - window_size + 1;
+    for (size_t i = 0; i < count; ++i) {
+        const double* w = prices + i;
+        double sum_y = kernels->sum(w, window_size);
+        double sum_xy = kernels->index_weighted_sum(w, window_size);
+        out[i] = (window_size * sum_xy - sum_x * sum_y) / den;
     }
-    return result;
+    return count;
 }
 
 std::vector<double> SIMDTechnicalIndicators::log_pct_change_simd(const std::vector<double>& prices, int window_size) {
+    if (!vector_kernels()) return TechnicalIndicators::log_pct_change(prices, window_size);
     if (prices.size() <= static_cast<size_t>(window_size)) return {};
-    std::vector<double> current(prices.begin() + window_size, prices.end());
-    std::vector<double> past(prices.begin(), prices.end() - window_size);
-    auto ratios = simd_divide_arrays(current, past);
+    return collect(prices.size() - window_size, [&](double* out) { return log_pct_change_simd(prices.data(), prices.size(), window_size, out); });
+}
+
+size_t SIMDTechnicalIndicators::log_pct_change_simd(const double* prices, size_t n, int window_size, double* out) {
+    const SimdKernels* kernels = vector_kernels();
+    if (!kernels) return TechnicalIndicators::log_pct_change(prices, n, window_size, out);
+    if (n <= static_cast<size_t>(window_size)) return 0;
+    const size_t count = n - window_size;
+    kernels->divide(prices + window_size, prices, out, count);
 
     // Note: Log operation itself is not trivially vectorized in AVX2.
     // For extreme performance, a library like Intel's SVML would be needed.
     // Here, we vectorize the division which is often the bottleneck.
-    for(double& r : ratios) {
-        r = (r > 0) ? std::log(r) : 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = (out[i] > 0) ? std::log(out[i]) : 0.0;
     }
-    return ratios;
+    return count;
 }
 
 std::vector<double> SIMDTechnicalIndicators::calculate_momentum_simd(const std::vector<double>& prices, int period) {
     if (prices.size() <= static_cast<size_t>(period)) return {};
-    std::vector<double> current(prices.begin() + period, prices.end());
-    std::vector<double> past(prices.begin(), prices.end() - period);
-    return simd_divide_arrays(current, past);
+    return collect(prices.size() - period, [&](double* out) { return calculate_momentum_simd(prices.data(), prices.size(), period, out); });
 }
 
-#else 
-// Fallback implementations if SIMD is not enabled - delegate to scalar implementations
-std::vector<double> SIMDTechnicalIndicators::calculate_returns_simd(const std::vector<double>& prices) { 
-    return TechnicalIndicators::calculate_returns(prices); 
+size_t SIMDTechnicalIndicators::calculate_momentum_simd(const double* prices, size_t n, int period, double* out) {
+    if (n <= static_cast<size_t>(period)) return 0;
+    simd_kernels().divide(prices + period, prices, out, n - period);
+    return n - period;
 }
-std::vector<double> SIMDTechnicalIndicators::simple_moving_average_simd(const std::vector<double>& data, size_t window) { 
-    return TechnicalIndicators::simple_moving_average(data, window); 
+
+std::vector<double> SIMDTechnicalIndicators::calculate_rsi_simd(const std::vector<double>& prices, int period) {
+    const SimdKernels* kernels = vector_kernels();
+    if (!kernels) return TechnicalIndicators::calculate_rsi(prices, period);
+    if (period <= 0 || prices.size() <= static_cast<size_t>(period)) return {};
+
+    const size_t changes = prices.size() - 1;
+    std::vector<double> gains(changes), losses(changes);
+    kernels->gains_losses(prices.data() + 1, prices.data(), gains.data(), losses.data(), changes);
+    if (gains.size() < static_cast<size_t>(period)) return {};
+
+    // Wilder smoothing is a recurrence, so it runs in the scalar reference's order
+    std::vector<double> rsi;
+    rsi.reserve(prices.size() - period);
+    double avg_gain = 0.0, avg_loss = 0.0;
+    for (int i = 0; i < period; ++i) {
+        avg_gain += gains[i];
+        avg_loss += losses[i];
+    }
+    avg_gain /= period;
+    avg_loss /= period;
+    for (size_t i = period; i < gains.size(); ++i) {
+        rsi.push_back(avg_loss == 0 ? 100.0 : 100.0 - (100.0 / (1.0 + avg_gain / avg_loss)));
+        avg_gain = (avg_gain * (period - 1) + gains[i]) / period;
+        avg_loss = (avg_loss * (period - 1) + losses[i]) / period;
+    }
+    rsi.push_back(avg_loss == 0 ? 100.0 : 100.0 - (100.0 / (1.0 + avg_gain / avg_loss)));
+    return rsi;
 }
-std::vector<double> SIMDTechnicalIndicators::calculate_rolling_volatility_simd(const std::vector<double>& returns, int window) { 
-    return TechnicalIndicators::calculate_rolling_volatility(returns, window); 
+
+size_t SIMDTechnicalIndicators::internal_bar_strength_simd(const double* high, const double* low, const double* close, size_t n, double* out) {
+    const SimdKernels* kernels = vector_kernels();
+    if (!kernels) return TechnicalIndicators::internal_bar_strength(high, low, close, n, out);
+    kernels->bar_strength(high, low, close, out, n);
+    return n;
 }
-std::vector<double> SIMDTechnicalIndicators::compute_spread_simd(const std::vector<double>& high, const std::vector<double>& low) { 
-    return TechnicalIndicators::compute_spread(high, low); 
+
+std::vector<double> SIMDTechnicalIndicators::detrended_price_oscillator_simd(const std::vector<double>& prices, const std::vector<double>& sma, int window) {
+    if (!vector_kernels()) return TechnicalIndicators::detrended_price_oscillator(prices, sma, window);
+    return collect(sma.size(), [&](double* out) { return detrended_price_oscillator_simd(prices.data(), prices.size(), sma.data(), sma.size(), window, out); });
 }
-std::vector<double> SIMDTechnicalIndicators::linear_slope_simd(const std::vector<double>& prices, int window_size) { 
-    return TechnicalIndicators::linear_slope(prices, window_size); 
+
+size_t SIMDTechnicalIndicators::detrended_price_oscillator_simd(const double* prices, size_t n, const double* sma, size_t sma_n, int window, double* out) {
+    const SimdKernels* kernels = vector_kernels();
+    if (!kernels) return TechnicalIndicators::detrended_price_oscillator(prices, n, sma, sma_n, window, out);
+    if (sma_n == 0 || window <= 0 || n < static_cast<size_t>(window)) return 0;
+    if (sma_n > n - window + 1) return 0;
+    kernels->subtract(prices + window - 1, sma, out, sma_n);
+    return sma_n;
 }
-std::vector<double> SIMDTechnicalIndicators::log_pct_change_simd(const std::vector<double>& prices, int window_size) { 
-    return TechnicalIndicators::log_pct_change(prices, window_size); 
+
+std::vector<double> SIMDTechnicalIndicators::chande_momentum_oscillator_14_simd(const std::vector<double>& prices) {
+    if (prices.size() <= 14) return {};
+    return collect(prices.size() - 14, [&](double* out) { return chande_momentum_oscillator_14_simd(prices.data(), prices.size(), out); });
 }
-std::vector<double> SIMDTechnicalIndicators::calculate_momentum_simd(const std::vector<double>& prices, int period) {
-    if (prices.size() <= static_cast<size_t>(period)) return {};
-    std::vector<double> result;
-    result.reserve(prices.size() - period);
-    for (size_t i = period; i < prices.size(); ++i) {
-        result.push_back(prices[i-period] != 0.0 ? prices[i] / prices[i-period] : 0.0);
+
+size_t SIMDTechnicalIndicators::chande_momentum_oscillator_14_simd(const double* prices, size_t n, double* out) {
+    const SimdKernels* kernels = vector_kernels();
+    if (!kernels) return TechnicalIndicators::chande_momentum_oscillator_14(prices, n, out);
+    const size_t period = 14;
+    if (n <= period) return 0;
+
+    const size_t changes = n - 1;
+    double* up = scratch(0, changes);
+    double* down = scratch(1, changes);
+    kernels->gains_losses(prices + 1, prices, up, down, changes);
+
+    const size_t count = changes - period + 1;
+    double* sum_up = scratch(2, count);
+    double* sum_down = scratch(3, count);
+    kernels->window_sums(up, changes, period, sum_up);
+    kernels->window_sums(down, changes, period, sum_down);
+
+    for (size_t k = 0; k < count; ++k) {
+        const double total = sum_up[k] + sum_down[k];
+        out[k] = total > 0 ? 100.0 * (sum_up[k] - sum_down[k]) / total : 0.0;
     }
-    return result;
+    return count;
+}
+
+std::vector<double> SIMDTechnicalIndicators::vortex_indicator_14_simd(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close) {
+    if (high.size() != low.size() || high.size() != close.size() || high.size() < 15) return {};
+    return collect(high.size() - 14, [&](double* out) { return vortex_indicator_14_simd(high.data(), low.data(), close.data(), high.size(), out); });
+}
+
+size_t SIMDTechnicalIndicators::vortex_indicator_14_simd(const double* high, const double* low, const double* close, size_t n, double* out) {
+    const SimdKernels* kernels = vector_kernels();
+    const size_t period = 14;
+    if (n < period + 1) return 0;
+    if (!kernels) return FixedWindow<14>::vortex_indicator(high, low, close, n, out);
+
+    // Bar m pairs the move into bar m + 1 with bar m
+    const size_t bars = n - 1;
+    double* vm_plus = scratch(0, bars);
+    double* tr = scratch(1, bars);
+    kernels->abs_diff(high + 1, low, vm_plus, bars);
+    kernels->true_range(high + 1, low + 1, close, tr, bars);
+
+    const size_t count = bars - period + 1;
+    double* vm_sum = scratch(2, count);
+    double* tr_sum = scratch(3, count);
+    kernels->window_sums(vm_plus, bars, period, vm_sum);
+    kernels->window_sums(tr, bars, period, tr_sum);
+
+    for (size_t k = 0; k < count; ++k) out[k] = tr_sum[k] > 0 ? vm_sum[k] / tr_sum[k] : 0.0;
+    return count;
+}
+
+std::vector<double> SIMDTechnicalIndicators::adx_rating_14_simd(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close) {
+    if (!vector_kernels()) return TechnicalIndicators::adx_rating_14(high, low, close);
+    if (high.size() != low.size() || high.size() != close.size() || high.size() < 15) return {};
+    return collect(high.size() - 14, [&](double* out) { return adx_rating_14_simd(high.data(), low.data(), close.data(), high.size(), out); });
+}
+
+size_t SIMDTechnicalIndicators::adx_rating_14_simd(const double* high, const double* low, const double* close, size_t n, double* out) {
+    const SimdKernels* kernels = vector_kernels();
+    if (!kernels) return TechnicalIndicators::adx_rating_14(high, low, close, n, out);
+    const size_t period = 14;
+    if (n < period + 1) return 0;
+
+    const size_t bars = n - 1;
+    double* dm_plus = scratch(0, bars);
+    double* dm_minus = scratch(1, bars);
+    double* tr = scratch(2, bars);
+    kernels->directional_movement(high + 1, high, low + 1, low, dm_plus, dm_minus, bars);
+    kernels->true_range(high + 1, low + 1, close, tr, bars);
+
+    const size_t count = bars - period + 1;
+    double* plus_sum = scratch(3, count);
+    double* minus_sum = scratch(4, count);
+    double* tr_sum = scratch(5, count);
+    kernels->window_sums(dm_plus, bars, period, plus_sum);
+    kernels->window_sums(dm_minus, bars, period, minus_sum);
+    kernels->window_sums(tr, bars, period, tr_sum);
+
+    for (size_t k = 0; k < count; ++k) {
+        const double di_plus = tr_sum[k] > 0 ? 100.0 * plus_sum[k] / tr_sum[k] : 0.0;
+        const double di_minus = tr_sum[k] > 0 ? 100.0 * minus_sum[k] / tr_sum[k] : 0.0;
+        out[k] = (di_plus + di_minus) > 0 ? 100.0 * std::abs(di_plus - di_minus) / (di_plus + di_minus) : 0.0;
+    }
+    return count;
+}
+
+std::vector<double> SIMDTechnicalIndicators::money_flow_index_14_simd(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, const std::vector<double>& volume) {
+    if (high.size() != low.size() || high.size() != close.size() || high.size() != volume.size() || high.size() < 15) return {};
+    return collect(high.size() - 14, [&](double* out) { return money_flow_index_14_simd(high.data(), low.data(), close.data(), volume.data(), high.size(), out); });
+}
+
+size_t SIMDTechnicalIndicators::money_flow_index_14_simd(const double* high, const double* low, const double* close, const double* volume, size_t n, double* out) {
+    const SimdKernels* kernels = vector_kernels();
+    const size_t period = 14;
+    if (n < period + 1) return 0;
+    if (!kernels) return FixedWindow<14>::money_flow_index(high, low, close, volume, n, out);
+
+    double* typical = scratch(0, n);
+    kernels->typical_price(high, low, close, typical, n);
+
+    const size_t bars = n - 1;
+    double* positive = scratch(1, bars);
+    double* negative = scratch(2, bars);
+    kernels->money_flows(typical + 1, typical, volume + 1, positive, negative, bars);
+
+    const size_t count = bars - period + 1;
+    double* positive_sum = scratch(3, count);
+    double* negative_sum = scratch(4, count);
+    kernels->window_sums(positive, bars, period, positive_sum);
+    kernels->window_sums(negative, bars, period, negative_sum);
+
+    for (size_t k = 0; k < count; ++k) {
+        const double pos = positive_sum[k], neg = negative_sum[k];
+        out[k] = (pos + neg) > 0 ? 100.0 - (100.0 / (1.0 + pos / neg)) : 50.0;
+    }
+    return count;
+}
+
+std::vector<double> SIMDTechnicalIndicators::on_balance_volume_sma_20_simd(const std::vector<double>& prices, const std::vector<double>& volume) {
+    if (prices.size() != volume.size() || prices.size() < 20) return {};
+    return collect(prices.size() - 19, [&](double* out) { return on_balance_volume_sma_20_simd(prices.data(), volume.data(), prices.size(), out); });
+}
+
+size_t SIMDTechnicalIndicators::on_balance_volume_sma_20_simd(const double* prices, const double* volume, size_t n, double* out) {
+    const SimdKernels* kernels = vector_kernels();
+    if (!kernels) return TechnicalIndicators::on_balance_volume_sma_20(prices, volume, n, out);
+    if (n < 20) return 0;
+
+    double* obv = scratch(0, n);
+    kernels->direction_volume(prices + 1, prices, volume + 1, 0.0, obv + 1, n - 1);
+    // Running total is a prefix sum; obv[0] starts at zero
+    obv[0] = 0.0;
+    for (size_t i = 1; i < n; ++i) obv[i] += obv[i - 1];
+    return TechnicalIndicators::simple_moving_average(obv, n, 20, out);
+}
+
+std::vector<double> SIMDTechnicalIndicators::klinger_signed_volume_simd(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, const std::vector<double>& volume) {
+    if (high.size() != low.size() || high.size() != close.size() || high.size() != volume.size() || high.size() < 2) return {};
+    const SimdKernels& kernels = simd_kernels();
+    const size_t n = high.size();
+    std::vector<double> typical(n);
+    kernels.typical_price(high.data(), low.data(), close.data(), typical.data(), n);
+
+    // Unchanged typical price counts as a down bar, as in the scalar version
+    std::vector<double> signed_volume(n - 1);
+    kernels.direction_volume(typical.data() + 1, typical.data(), volume.data() + 1, -1.0, signed_volume.data(), n - 1);
+    return signed_volume;
+}
+
+std::vector<double> SIMDTechnicalIndicators::klinger_oscillator_34_55_simd(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, const std::vector<double>& volume) {
+    const SimdKernels* kernels = vector_kernels();
+    if (!kernels) return TechnicalIndicators::klinger_oscillator_34_55(high, low, close, volume);
+    const auto signed_volume = klinger_signed_volume_simd(high, low, close, volume);
+    if (signed_volume.empty()) return {};
+
+    auto ema34 = TechnicalIndicators::exponential_moving_average(signed_volume, 34);
+    auto ema55 = TechnicalIndicators::exponential_moving_average(signed_volume, 55);
+    if (ema34.size() != ema55.size()) return {};
+
+    std::vector<double> klinger(ema34.size());
+    kernels->subtract(ema34.data(), ema55.data(), klinger.data(), klinger.size());
+    return klinger;
+}
+
+std::vector<double> SIMDTechnicalIndicators::ulcer_index_14_simd(const std::vector<double>& prices) {
+    if (prices.size() < 14) return {};
+    return collect(prices.size() - 13, [&](double* out) { return ulcer_index_14_simd(prices.data(), prices.size(), out); });
+}
+
+size_t SIMDTechnicalIndicators::ulcer_index_14_simd(const double* prices, size_t n, double* out) {
+    const SimdKernels* kernels = vector_kernels();
+    const size_t period = 14;
+    if (n < period) return 0;
+    if (!kernels) return FixedWindow<14>::ulcer_index(prices, n, out);
+
+    const size_t count = n - period + 1;
+    kernels->ulcer_sums(prices, n, period, out);
+    for (size_t k = 0; k < count; ++k) out[k] = std::sqrt(out[k] / period);
+    return count;
+}
+
+size_t SIMDTechnicalIndicators::series_lanes() {
+    return simd_kernels().lanes;
+}
+
+void SIMDTechnicalIndicators::ema_lanes(const double* data, size_t rows, int period, double* out) {
+    if (period <= 0) return;
+    simd_kernels().ema_lanes(data, rows, 2.0 / (period + 1.0), out);
+}
+
+void SIMDTechnicalIndicators::kama_lanes(const double* prices, size_t rows, int l1, int l2, int l3, double* out) {
+    if (l1 <= 0) return;
+    simd_kernels().kama_lanes(prices, rows, static_cast<size_t>(l1), 2.0 / (l2 + 1.0), 2.0 / (l3 + 1.0), out);
+}
+
+void SIMDTechnicalIndicators::garch_volatility_21_lanes(const double* returns, size_t rows, double* out) {
+    const size_t window = 21;
+    if (rows < window) return;
+    const SimdKernels& kernels = simd_kernels();
+    // Same simplified GARCH(1,1) constants as TechnicalIndicators::garch_volatility_21
+    kernels.garch_variance_lanes(returns, rows, window, 0.05, 0.1, 0.85, out);
+    const size_t count = (rows - window + 1) * kernels.lanes;
+    for (size_t i = 0; i < count; ++i) out[i] = std::sqrt(out[i]);
+}
+
+size_t SIMDTechnicalIndicators::log_pct_change_f32(const float* prices, size_t n, int window_size, float* out) {
+    if (window_size < 0 || n <= static_cast<size_t>(window_size)) return 0;
+    const size_t count = n - window_size;
+    simd_kernels().divide_f32(prices + window_size, prices, out, count);
+    for (size_t i = 0; i < count; ++i) out[i] = (out[i] > 0.0f) ? std::log(out[i]) : 0.0f;
+    return count;
+}
+
+size_t SIMDTechnicalIndicators::calculate_momentum_f32(const float* prices, size_t n, int period, float* out) {
+    if (period < 0 || n <= static_cast<size_t>(period)) return 0;
+    simd_kernels().divide_f32(prices + period, prices, out, n - period);
+    return n - period;
+}
+
+size_t SIMDTechnicalIndicators::linear_slope_f32(const float* prices, size_t n, int window_size, float* out) {
+    if (window_size <= 0 || n < static_cast<size_t>(window_size)) return 0;
+    const SimdKernels& kernels = simd_kernels();
+    const double sum_x = static_cast<double>(window_size * (window_size - 1)) / 2.0;
+    const double sum_x2 = static_cast<double>(window_size * (window_size - 1) * (2 * window_size - 1)) / 6.0;
+    const double den = window_size * sum_x2 - sum_x * sum_x;
+    if (den == 0) return 0;
+    const size_t count = n - window_size + 1;
+    for (size_t i = 0; i < count; ++i) {
+        const float* w = prices + i;
+        const double sum_y = kernels.sum_f32(w, window_size);
+        const double sum_xy = kernels.index_weighted_sum_f32(w, window_size);
+        out[i] = static_cast<float>((window_size * sum_xy - sum_x * sum_y) / den);
+    }
+    return count;
 }
-#endif
 
 // Utility function
 bool SIMDTechnicalIndicators::is_simd_available() {
-    return SIMD_ENABLED;
+    const SimdTier tier = active_simd_tier();
+    return tier == SimdTier::AVX2 || tier == SimdTier::AVX512;
 }
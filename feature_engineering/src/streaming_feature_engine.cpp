@@ -0,0 +1,684 @@
+#include "streaming_feature_engine.h"
+#include "garch_model.h"
+#include "feature_selection.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+// Largest lookback into the raw bar history (Hurst window)
+constexpr size_t kHistoryCapacity = 128;
+
+constexpr double kGarchAlpha = 0.1, kGarchBeta = 0.85, kGarchOmega = 0.05;
+constexpr int kGarchWindow = 21;
+constexpr double kHighVolatilityThreshold = 0.02;
+constexpr int kRsiPeriod = 14;
+constexpr double kCvarTailFraction = 0.05;
+
+double true_range(double high, double low, double prev_close) {
+    return std::max({high - low, std::abs(high - prev_close), std::abs(low - prev_close)});
+}
+}
+
+// History
+
+StreamingFeatureEngine::History::History(size_t capacity) : ring_(capacity, 0.0) {}
+
+void StreamingFeatureEngine::History::push(double x) {
+    ring_[head_] = x;
+    head_ = (head_ + 1) % ring_.size();
+    if (count_ < ring_.size()) ++count_;
+}
+
+double StreamingFeatureEngine::History::ago(size_t k) const {
+    if (k >= count_) return 0.0;
+    return ring_[(head_ + ring_.size() - 1 - k) % ring_.size()];
+}
+
+// RollingSum
+
+StreamingFeatureEngine::RollingSum::RollingSum(size_t window) : ring_(std::max<size_t>(window, 1), 0.0) {}
+
+void StreamingFeatureEngine::RollingSum::push(double x) {
+    const size_t window = ring_.size();
+    if (count_ < window) {
+        ring_[(head_ + count_) % window] = x;
+        ++count_;
+        sum_ += x;
+    } else {
+        sum_ += x - ring_[head_];
+        ring_[head_] = x;
+        head_ = (head_ + 1) % window;
+    }
+
+    // Rebuild in window order so add/subtract round-off cannot drift
+    if (++since_resync_ >= window && full()) {
+        since_resync_ = 0;
+        sum_ = 0.0;
+        for (size_t j = 0; j < window; ++j) sum_ += ring_[(head_ + j) % window];
+    }
+}
+
+// RollingLinearFit
+
+StreamingFeatureEngine::RollingLinearFit::RollingLinearFit(size_t window) : ring_(std::max<size_t>(window, 1), 0.0) {}
+
+void StreamingFeatureEngine::RollingLinearFit::push(double y) {
+    const size_t window = ring_.size();
+    if (count_ < window) {
+        ring_[(head_ + count_) % window] = y;
+        sum_xy_ += static_cast<double>(count_) * y;
+        sum_y_ += y;
+        ++count_;
+    } else {
+        // Shifting every x down by one drops (sum_y - oldest) from sum_xy
+        double oldest = ring_[head_];
+        sum_xy_ -= sum_y_ - oldest;
+        sum_xy_ += static_cast<double>(window - 1) * y;
+        sum_y_ += y - oldest;
+        ring_[head_] = y;
+        head_ = (head_ + 1) % window;
+    }
+
+    if (++since_resync_ >= window && full()) {
+        since_resync_ = 0;
+        sum_y_ = sum_xy_ = 0.0;
+        for (size_t j = 0; j < window; ++j) {
+            double v = ring_[(head_ + j) % window];
+            sum_y_ += v;
+            sum_xy_ += static_cast<double>(j) * v;
+        }
+    }
+}
+
+double StreamingFeatureEngine::RollingLinearFit::slope() const {
+    const double w = static_cast<double>(ring_.size());
+    const double sum_x = w * (w - 1) / 2.0;
+    const double sum_x2 = w * (w - 1) * (2 * w - 1) / 6.0;
+    const double den = w * sum_x2 - sum_x * sum_x;
+    return den != 0 ? (w * sum_xy_ - sum_x * sum_y_) / den : 0.0;
+}
+
+// RollingExtreme
+
+StreamingFeatureEngine::RollingExtreme::RollingExtreme(size_t window, bool track_max)
+    : window_(std::max<size_t>(window, 1)), track_max_(track_max) {}
+
+void StreamingFeatureEngine::RollingExtreme::push(double x) {
+    const size_t index = pushed_++;
+    // Pop ties too so the front is the most recent occurrence
+    while (!deque_.empty() && (track_max_ ? x >= deque_.back().second : x <= deque_.back().second)) {
+        deque_.pop_back();
+    }
+    deque_.emplace_back(index, x);
+    if (deque_.front().first + window_ <= index) deque_.pop_front();
+}
+
+// SortedWindow
+
+StreamingFeatureEngine::SortedWindow::SortedWindow(size_t window) : nodes_(std::max<size_t>(window, 1)) {}
+
+void StreamingFeatureEngine::SortedWindow::update(uint32_t t) {
+    Node& node = nodes_[t];
+    node.size = size(node.left) + 1 + size(node.right);
+    node.sum = sum(node.left) + node.value + sum(node.right);
+}
+
+void StreamingFeatureEngine::SortedWindow::split(uint32_t t, double value, uint64_t order, uint32_t& a, uint32_t& b) {
+    if (t == kNil) {
+        a = b = kNil;
+        return;
+    }
+    Node& node = nodes_[t];
+    if (node.value < value || (node.value == value && node.order < order)) {
+        split(node.right, value, order, node.right, b);
+        a = t;
+    } else {
+        split(node.left, value, order, a, node.left);
+        b = t;
+    }
+    update(t);
+}
+
+uint32_t StreamingFeatureEngine::SortedWindow::merge(uint32_t a, uint32_t b) {
+    if (a == kNil) return b;
+    if (b == kNil) return a;
+    if (nodes_[a].priority > nodes_[b].priority) {
+        nodes_[a].right = merge(nodes_[a].right, b);
+        update(a);
+        return a;
+    }
+    nodes_[b].left = merge(a, nodes_[b].left);
+    update(b);
+    return b;
+}
+
+void StreamingFeatureEngine::SortedWindow::push(double x) {
+    const size_t window = nodes_.size();
+    size_t slot;
+    if (count_ < window) {
+        slot = (head_ + count_) % window;
+        ++count_;
+    } else {
+        // Cut the evicted node out between its own key and the next one
+        slot = head_;
+        const Node& evicted = nodes_[slot];
+        if (evicted.linked) {
+            uint32_t below, rest, above;
+            split(root_, evicted.value, evicted.order, below, rest);
+            split(rest, evicted.value, evicted.order + 1, rest, above);
+            root_ = merge(below, above);
+        }
+        head_ = (head_ + 1) % window;
+    }
+
+    seed_ ^= seed_ << 13;
+    seed_ ^= seed_ >> 17;
+    seed_ ^= seed_ << 5;
+    Node& node = nodes_[slot];
+    node = Node{};
+    node.value = x;
+    node.order = pushed_++;
+    node.priority = seed_;
+    node.sum = x;
+    // A NaN key would break the ordering split relies on
+    if (!is_finite(x)) return;
+    node.linked = true;
+    // The newest key sorts after equal values, as upper_bound insertion did
+    uint32_t below, above;
+    split(root_, x, node.order, below, above);
+    root_ = merge(merge(below, static_cast<uint32_t>(slot)), above);
+}
+
+size_t StreamingFeatureEngine::SortedWindow::count_less(double x) const {
+    size_t count = 0;
+    for (uint32_t t = root_; t != kNil;) {
+        const Node& node = nodes_[t];
+        if (node.value < x) {
+            count += size(node.left) + 1;
+            t = node.right;
+        } else {
+            t = node.left;
+        }
+    }
+    return count;
+}
+
+double StreamingFeatureEngine::SortedWindow::sum_smallest(size_t k) const {
+    double total = 0.0;
+    for (uint32_t t = root_; t != kNil && k > 0;) {
+        const Node& node = nodes_[t];
+        const size_t left = size(node.left);
+        if (k <= left) {
+            t = node.left;
+            continue;
+        }
+        total += sum(node.left) + node.value;
+        k -= left + 1;
+        t = node.right;
+    }
+    return total;
+}
+
+// KamaState
+
+StreamingFeatureEngine::KamaState::KamaState(int l1_, int l2, int l3)
+    : l1(l1_), fast_sc(2.0 / (l2 + 1.0)), slow_sc(2.0 / (l3 + 1.0)), abs_changes(l1_) {}
+
+// StreamingFeatureEngine
+
+StreamingFeatureEngine::StreamingFeatureEngine()
+    : close_(kHistoryCapacity), high_(kHistoryCapacity), low_(kHistoryCapacity),
+      typical_(kHistoryCapacity), return_history_(kHistoryCapacity),
+      close_sum_20_(20), volume_sum_20_(20), obv_sum_20_(20), parkinson_sum_20_(20),
+      ac_x_(50), ac_y_(50), ac_xy_(50), ac_x2_(50), ac_y2_(50),
+      cmo_up_(14), cmo_down_(14),
+      vortex_vm_plus_(14), vortex_tr_(14), supertrend_tr_(10),
+      mfi_positive_(14), mfi_negative_(14),
+      adx_dm_plus_(14), adx_dm_minus_(14), adx_tr_(14),
+      volume_sum_10_(10), volume_log_sum_10_(10),
+      close_moments_30_(30),
+      slope_20_(20), slope_60_(60),
+      percentile_window_(50),
+      aroon_high_(25, true), aroon_low_(25, false),
+      tenkan_high_(9, true), tenkan_low_(9, false), kijun_high_(26, true), kijun_low_(26, false),
+      span_b_high_(52, true), span_b_low_(52, false), fisher_high_(10, true), fisher_low_(10, false),
+      drawdown_peak_(50, true),
+      kama_10_(10, 2, 30), kama_20_(20, 10, 30),
+      vwap_deviation_30_(30),
+      return_moments_20_(20), return_moments_30_(30),
+      chow_prior_(50), chow_recent_(50),
+      sortino_sum_(30), sortino_downside_(30), sortino_count_(30),
+      cvar_window_(20) {
+    hurst_log_prices_.reserve(100);
+    hurst_cumsum_.reserve(100);
+}
+
+void StreamingFeatureEngine::reset() {
+    *this = StreamingFeatureEngine();
+}
+
+void StreamingFeatureEngine::take_features(FeatureSet& out) {
+    std::swap(out, features_);
+#define STREAMING_CLEAR_COLUMN(name, offset) features_.name.clear();
+    FEATURE_COLUMNS(STREAMING_CLEAR_COLUMN)
+#undef STREAMING_CLEAR_COLUMN
+}
+
+double StreamingFeatureEngine::update_kama(KamaState& state, double close) {
+    const size_t i = bars_ - 1;
+    if (i == 0) {
+        state.value = close;
+        return state.value;
+    }
+    state.abs_changes.push(std::abs(close - close_.ago(1)));
+    size_t lookback = std::min(static_cast<size_t>(state.l1), i);
+    double change = std::abs(close - close_.ago(lookback));
+    double vol = state.abs_changes.sum();
+    double er = vol > 0 ? change / vol : 0.0;
+    double sc = std::pow(er * (state.fast_sc - state.slow_sc) + state.slow_sc, 2);
+    state.value += sc * (close - state.value);
+    return state.value;
+}
+
+double StreamingFeatureEngine::hurst_from_history() {
+    const size_t window = 100;
+    hurst_log_prices_.clear();
+    for (size_t j = window; j-- > 0;) {
+        double p = close_.ago(j);
+        if (p > 0) hurst_log_prices_.push_back(std::log(p));
+    }
+    const size_t n = hurst_log_prices_.size();
+    if (n < 10) return 0.5;
+
+    // Same simplified R/S analysis as TechnicalIndicators::hurst_exponent_100
+    hurst_cumsum_.resize(n);
+    hurst_cumsum_[0] = hurst_log_prices_[0];
+    for (size_t k = 1; k < n; ++k) hurst_cumsum_[k] = hurst_cumsum_[k-1] + hurst_log_prices_[k];
+
+    double mean_log = hurst_cumsum_.back() / n;
+    double range = 0.0, std_dev = 0.0;
+    for (size_t k = 0; k < n; ++k) {
+        double dev = hurst_cumsum_[k] - (k + 1) * mean_log;
+        range = std::max(range, std::abs(dev));
+        std_dev += (hurst_log_prices_[k] - mean_log) * (hurst_log_prices_[k] - mean_log);
+    }
+    std_dev = std::sqrt(std_dev / (n - 1));
+    double rs = std_dev > 0 ? range / std_dev : 1.0;
+    double hurst = rs > 0 ? std::log(rs) / std::log(n) : 0.5;
+    return std::max(0.0, std::min(1.0, hurst));
+}
+
+void StreamingFeatureEngine::on_bar(double open, double high, double low, double close, double volume) {
+    const size_t i = bars_++;
+    const double typical = (high + low + close) / 3.0;
+    const double prev_close = close_.ago(0), prev_high = high_.ago(0), prev_low = low_.ago(0);
+    const double prev_typical = typical_.ago(0);
+    close_.push(close);
+    high_.push(high);
+    low_.push(low);
+    typical_.push(typical);
+
+    // Per-bar candle features
+    const double range = high - low;
+    features_.spread.push_back(range);
+    features_.internal_bar_strength.push_back(range > 0 ? (close - low) / range : 0.5);
+    features_.candle_way.push_back(close > open ? 1 : (close < open ? -1 : 0));
+    features_.candle_amplitude.push_back(range);
+    features_.candle_filling.push_back(range > 0 ? std::abs(close - open) / range : 0.0);
+
+    if (i >= 1) {
+        features_.returns.push_back(prev_close != 0.0 ? (close - prev_close) / prev_close : 0.0);
+        double velocity = close - prev_close;
+        if (i >= 2) features_.acceleration.push_back(velocity - last_velocity_);
+        features_.velocity.push_back(velocity);
+        last_velocity_ = velocity;
+        on_return(features_.returns.back());
+    }
+
+    // Moving averages and lagged ratios
+    close_sum_20_.push(close);
+    volume_sum_20_.push(volume);
+    if (close_sum_20_.full()) {
+        double sma = close_sum_20_.sum() / 20;
+        features_.sma.push_back(sma);
+        features_.detrended_price_oscillator_20.push_back(close - sma);
+    }
+    if (volume_sum_20_.full()) features_.volume_sma_20.push_back(volume_sum_20_.sum() / 20);
+    if (i >= 5) {
+        double p5 = close_.ago(5);
+        features_.log_pct_change_5.push_back((p5 > 0 && close > 0) ? std::log(close / p5) : 0.0);
+    }
+    if (i >= 10) {
+        double p10 = close_.ago(10);
+        features_.momentum.push_back(p10 != 0.0 ? close / p10 : 0.0);
+    }
+
+    slope_20_.push(close);
+    slope_60_.push(close);
+    if (slope_20_.full()) {
+        features_.linear_slope_20.push_back(slope_20_.slope());
+        features_.polynomial_regression_price_degree_2_slope.push_back(slope_20_.slope());
+    }
+    if (slope_60_.full()) features_.linear_slope_60.push_back(slope_60_.slope());
+
+    // Wilder RSI: simple average over the first period, then smoothed
+    if (i >= 1) {
+        double change = close - prev_close;
+        double gain = change > 0 ? change : 0.0, loss = change < 0 ? -change : 0.0;
+        if (i <= static_cast<size_t>(kRsiPeriod)) {
+            rsi_avg_gain_ += gain;
+            rsi_avg_loss_ += loss;
+            if (i == static_cast<size_t>(kRsiPeriod)) {
+                rsi_avg_gain_ /= kRsiPeriod;
+                rsi_avg_loss_ /= kRsiPeriod;
+            }
+        } else {
+            rsi_avg_gain_ = (rsi_avg_gain_ * (kRsiPeriod - 1) + gain) / kRsiPeriod;
+            rsi_avg_loss_ = (rsi_avg_loss_ * (kRsiPeriod - 1) + loss) / kRsiPeriod;
+        }
+        if (i >= static_cast<size_t>(kRsiPeriod)) {
+            features_.rsi.push_back(rsi_avg_loss_ == 0 ? 100.0 : 100.0 - (100.0 / (1.0 + rsi_avg_gain_ / rsi_avg_loss_)));
+        }
+    }
+
+    close_moments_30_.push(close);
+    if (close_moments_30_.full()) {
+        features_.skewness_30.push_back(close_moments_30_.skewness());
+        features_.kurtosis_30.push_back(close_moments_30_.excess_kurtosis());
+    }
+
+    // Lag-10 autocorrelation over pairs (close[k], close[k+10])
+    if (i >= 10) {
+        double x = close_.ago(10), y = close;
+        ac_x_.push(x); ac_y_.push(y); ac_xy_.push(x * y); ac_x2_.push(x * x); ac_y2_.push(y * y);
+        if (ac_x_.full()) {
+            const double w = 50;
+            double num = w * ac_xy_.sum() - ac_x_.sum() * ac_y_.sum();
+            double den = std::sqrt((w * ac_x2_.sum() - ac_x_.sum() * ac_x_.sum()) * (w * ac_y2_.sum() - ac_y_.sum() * ac_y_.sum()));
+            features_.auto_correlation_50_10.push_back(den != 0 ? num / den : 0.0);
+        }
+    }
+
+    // KAMA columns are full length once the batch minimum is met
+    double kama10 = update_kama(kama_10_, close);
+    double kama20 = update_kama(kama_20_, close);
+    double kama_ratio = kama20 > 0 ? close / kama20 : 1.0;
+    if (bars_ < static_cast<size_t>(kama_10_.l1 + 1)) kama_10_.warmup.push_back(kama10);
+    else {
+        features_.kama_10_2_30.insert(features_.kama_10_2_30.end(), kama_10_.warmup.begin(), kama_10_.warmup.end());
+        kama_10_.warmup.clear();
+        features_.kama_10_2_30.push_back(kama10);
+    }
+    if (bars_ < static_cast<size_t>(kama_20_.l1 + 1)) kama_20_.warmup.push_back(kama_ratio);
+    else {
+        auto& ratio = features_.price_to_kama_ratio_20_10_30;
+        ratio.insert(ratio.end(), kama_20_.warmup.begin(), kama_20_.warmup.end());
+        kama_20_.warmup.clear();
+        ratio.push_back(kama_ratio);
+    }
+
+    double log_hl = low > 0 ? std::log(high / low) : 0.0;
+    parkinson_sum_20_.push(log_hl * log_hl);
+    if (parkinson_sum_20_.full()) {
+        features_.parkinson_volatility_20.push_back(std::sqrt(parkinson_sum_20_.sum() / 20) * (1.0 / (4.0 * std::log(2.0))));
+    }
+
+    percentile_window_.push(close);
+    if (percentile_window_.full()) {
+        features_.percentile_rank_50.push_back(static_cast<double>(percentile_window_.count_less(close)) / 50 * 100.0);
+    }
+
+    if (bars_ >= 100) features_.hurst_exponent_100.push_back(hurst_from_history());
+
+    // Entropy of the volume shares: log(T) - sum(v log v) / T
+    volume_sum_10_.push(volume);
+    volume_log_sum_10_.push(volume > 0 ? volume * std::log(volume) : 0.0);
+    if (volume_sum_10_.full()) {
+        double total = volume_sum_10_.sum();
+        features_.shannon_entropy_volume_10.push_back(total > 0 ? std::log(total) - volume_log_sum_10_.sum() / total : 0.0);
+    }
+
+    if (i >= 1) {
+        double change = close - prev_close;
+        cmo_up_.push(change > 0 ? change : 0.0);
+        cmo_down_.push(change > 0 ? 0.0 : std::abs(change));
+        if (cmo_up_.full()) {
+            double up = cmo_up_.sum(), down = cmo_down_.sum();
+            features_.chande_momentum_oscillator_14.push_back((up + down) > 0 ? 100.0 * (up - down) / (up + down) : 0.0);
+        }
+    }
+
+    aroon_high_.push(high);
+    aroon_low_.push(low);
+    if (aroon_high_.full()) {
+        const int period = 25;
+        // Ties with the oldest bar count as the current bar, as in the batch version
+        int since_high = aroon_high_.value() == high_.ago(period - 1) ? 0 : static_cast<int>(i - aroon_high_.index());
+        int since_low = aroon_low_.value() == low_.ago(period - 1) ? 0 : static_cast<int>(i - aroon_low_.index());
+        features_.aroon_oscillator_25.push_back(100.0 * (period - since_high) / period - 100.0 * (period - since_low) / period);
+    }
+
+    // TRIX on a triple EMA seeded at the first close
+    const double trix_alpha = 2.0 / (15 + 1.0);
+    double prev_ema3 = ema3_;
+    if (i == 0) {
+        ema1_ = ema2_ = ema3_ = close;
+    } else {
+        ema1_ = trix_alpha * close + (1.0 - trix_alpha) * ema1_;
+        ema2_ = trix_alpha * ema1_ + (1.0 - trix_alpha) * ema2_;
+        ema3_ = trix_alpha * ema2_ + (1.0 - trix_alpha) * ema3_;
+        features_.trix_15.push_back(prev_ema3 > 0 ? 10000.0 * (ema3_ - prev_ema3) / prev_ema3 : 0.0);
+    }
+
+    if (i >= 1) {
+        double tr = true_range(high, low, prev_close);
+        vortex_vm_plus_.push(std::abs(high - prev_low));
+        vortex_tr_.push(tr);
+        if (vortex_tr_.full()) {
+            features_.vortex_indicator_14.push_back(vortex_tr_.sum() > 0 ? vortex_vm_plus_.sum() / vortex_tr_.sum() : 0.0);
+        }
+
+        double up_move = high - prev_high, down_move = prev_low - low;
+        adx_dm_plus_.push(up_move > down_move ? std::max(0.0, up_move) : 0.0);
+        adx_dm_minus_.push(down_move > up_move ? std::max(0.0, down_move) : 0.0);
+        adx_tr_.push(tr);
+        if (adx_tr_.full()) {
+            double tr_sum = adx_tr_.sum();
+            double di_plus = tr_sum > 0 ? 100.0 * adx_dm_plus_.sum() / tr_sum : 0.0;
+            double di_minus = tr_sum > 0 ? 100.0 * adx_dm_minus_.sum() / tr_sum : 0.0;
+            features_.adx_rating_14.push_back((di_plus + di_minus) > 0 ? 100.0 * std::abs(di_plus - di_minus) / (di_plus + di_minus) : 0.0);
+        }
+    }
+
+    // Supertrend ATR is 0 on the first full bar, as calculate_atr() needs a previous close
+    supertrend_tr_.push(i == 0 ? range : true_range(high, low, prev_close));
+    if (supertrend_tr_.full()) {
+        double atr = i < 10 ? 0.0 : supertrend_tr_.sum() / 10;
+        double hl2 = (high + low) / 2.0;
+        double upper_band = hl2 + 3.0 * atr, lower_band = hl2 - 3.0 * atr;
+        features_.supertrend_10_3.push_back(close > upper_band ? lower_band : upper_band);
+    }
+
+    tenkan_high_.push(high); tenkan_low_.push(low);
+    kijun_high_.push(high); kijun_low_.push(low);
+    span_b_high_.push(high); span_b_low_.push(low);
+    fisher_high_.push(high); fisher_low_.push(low);
+    if (kijun_high_.full()) {
+        double tenkan_sen = (tenkan_high_.value() + tenkan_low_.value()) / 2.0;
+        double kijun_sen = (kijun_high_.value() + kijun_low_.value()) / 2.0;
+        features_.ichimoku_senkou_span_A_9_26.push_back((tenkan_sen + kijun_sen) / 2.0);
+    }
+    if (span_b_high_.full()) {
+        features_.ichimoku_senkou_span_B_26_52.push_back((span_b_high_.value() + span_b_low_.value()) / 2.0);
+    }
+    if (fisher_high_.full()) {
+        double max_high = fisher_high_.value(), min_low = fisher_low_.value();
+        double fisher_range = max_high - min_low;
+        if (fisher_range <= 0) {
+            features_.fisher_transform_10.push_back(0.0);
+        } else {
+            double normalized = 2.0 * ((high + low) / 2.0 - min_low) / fisher_range - 1.0;
+            normalized = std::max(-0.999, std::min(0.999, normalized));
+            features_.fisher_transform_10.push_back(0.5 * std::log((1.0 + normalized) / (1.0 - normalized)));
+        }
+    }
+
+    // Volume features
+    cumulative_pv_ += typical * volume;
+    cumulative_volume_ += volume;
+    double vwap = cumulative_volume_ > 0 ? cumulative_pv_ / cumulative_volume_ : typical;
+    features_.volume_weighted_average_price_intraday.push_back(vwap);
+
+    vwap_deviation_30_.push(typical - vwap);
+    if (vwap_deviation_30_.full()) features_.vwap_deviation_stddev_30.push_back(std::sqrt(vwap_deviation_30_.sample_variance()));
+
+    if (volume > max_volume_) {
+        max_volume_ = volume;
+        hvn_price_ = close;
+        hvn_found_ = true;
+    }
+    if (i == 0 || volume < min_volume_) {
+        min_volume_ = volume;
+        lvn_price_ = close;
+    }
+    features_.volume_profile_high_volume_node_intraday.push_back(hvn_found_ ? hvn_price_ : close);
+    features_.volume_profile_low_volume_node_intraday.push_back(lvn_price_);
+
+    if (i >= 1) {
+        if (close > prev_close) obv_ += volume;
+        else if (close < prev_close) obv_ -= volume;
+    }
+    obv_sum_20_.push(obv_);
+    if (obv_sum_20_.full()) features_.on_balance_volume_sma_20.push_back(obv_sum_20_.sum() / 20);
+
+    if (i >= 1) {
+        double sv = volume * (typical > prev_typical ? 1.0 : -1.0);
+        if (i == 1) {
+            klinger_ema34_ = klinger_ema55_ = sv;
+        } else {
+            const double alpha34 = 2.0 / (34 + 1.0), alpha55 = 2.0 / (55 + 1.0);
+            klinger_ema34_ = alpha34 * sv + (1.0 - alpha34) * klinger_ema34_;
+            klinger_ema55_ = alpha55 * sv + (1.0 - alpha55) * klinger_ema55_;
+        }
+        features_.klinger_oscillator_34_55.push_back(klinger_ema34_ - klinger_ema55_);
+
+        double money_flow = typical * volume;
+        mfi_positive_.push(typical > prev_typical ? money_flow : 0.0);
+        mfi_negative_.push(typical < prev_typical ? money_flow : 0.0);
+        if (mfi_positive_.full()) {
+            double positive = mfi_positive_.sum(), negative = mfi_negative_.sum();
+            features_.money_flow_index_14.push_back((positive + negative) > 0 ? 100.0 - (100.0 / (1.0 + positive / negative)) : 50.0);
+        }
+    }
+
+    // Drawdown and ulcer
+    drawdown_peak_.push(close);
+    if (drawdown_peak_.full()) features_.drawdown_duration_from_peak_50.push_back(static_cast<double>(i - drawdown_peak_.index()));
+    if (bars_ >= 14) {
+        const int period = 14;
+        double max_price = close_.ago(0);
+        for (int j = 1; j < period; ++j) max_price = std::max(max_price, close_.ago(j));
+        double sum_squared_drawdowns = 0.0;
+        for (int j = 0; j < period; ++j) {
+            double drawdown = max_price > 0 ? 100.0 * (close_.ago(j) - max_price) / max_price : 0.0;
+            sum_squared_drawdowns += drawdown * drawdown;
+        }
+        features_.ulcer_index_14.push_back(std::sqrt(sum_squared_drawdowns / period));
+    }
+}
+
+void StreamingFeatureEngine::on_return(double ret) {
+    ++returns_;
+    return_history_.push(ret);
+
+    return_moments_20_.push(ret);
+    if (return_moments_20_.full()) {
+        double std_dev = std::sqrt(return_moments_20_.sample_variance());
+        features_.volatility.push_back(std_dev);
+        features_.z_score_20.push_back(std_dev > 0 ? (ret - return_moments_20_.mean()) / std_dev : 0.0);
+    }
+
+    // Recursive GARCH(1,1) with GarchModel's default parameters: the variance
+    // is seeded with the mean squared return of the warm-up returns
+    if (returns_ < GarchModel::kWarmup) {
+        garch_variance_ += ret * ret;
+    } else if (returns_ == GarchModel::kWarmup) {
+        garch_variance_ = (garch_variance_ + ret * ret) / GarchModel::kWarmup;
+        garch_omega_ = (1.0 - GarchModel::kDefaultAlpha - GarchModel::kDefaultBeta) * garch_variance_;
+    } else {
+        garch_variance_ = garch_omega_ + GarchModel::kDefaultAlpha * ret * ret + GarchModel::kDefaultBeta * garch_variance_;
+    }
+    if (returns_ >= GarchModel::kWarmup) {
+        const double filtered = std::sqrt(std::max(0.0, garch_variance_));
+        features_.high_volatility_indicator_garch_threshold.push_back(filtered > kHighVolatilityThreshold ? 1.0 : 0.0);
+    }
+
+    // Regime HMMs: the warm-up returns set the default parameters, then run
+    // through the filters at once
+    if (regime_2_) {
+        update_regimes(ret);
+    } else {
+        regime_warmup_.push_back(ret);
+        if (regime_warmup_.size() == RegimeModel::kWarmup) {
+            regime_2_.emplace(RegimeModel::default_params(regime_warmup_.data(), regime_warmup_.size(), 2));
+            regime_3_.emplace(RegimeModel::default_params(regime_warmup_.data(), regime_warmup_.size(), 3));
+            for (double r : regime_warmup_) update_regimes(r);
+            regime_warmup_.clear();
+        }
+    }
+
+    return_moments_30_.push(ret);
+    if (return_moments_30_.full()) {
+        double mean = return_moments_30_.mean();
+        features_.coefficient_of_variation_30.push_back(std::abs(mean) < 1e-10 ? 0.0 : std::sqrt(return_moments_30_.sample_variance()) / std::abs(mean));
+    }
+
+    // GARCH(1,1) filter restarted at each window start, in closed form:
+    // var = omega * sum(beta^k) + alpha * sum(beta^(20-j) * r_j^2)
+    garch_weighted_sq_ = kGarchBeta * garch_weighted_sq_ + ret * ret;
+    if (returns_ > static_cast<size_t>(kGarchWindow)) {
+        double evicted = return_history_.ago(kGarchWindow);
+        garch_weighted_sq_ -= std::pow(kGarchBeta, kGarchWindow) * evicted * evicted;
+    }
+    if (returns_ >= static_cast<size_t>(kGarchWindow)) {
+        double omega_sum = kGarchOmega * (1.0 - std::pow(kGarchBeta, kGarchWindow)) / (1.0 - kGarchBeta);
+        double garch = std::sqrt(std::max(0.0, omega_sum + kGarchAlpha * garch_weighted_sq_));
+        features_.garch_volatility_21.push_back(garch);
+    }
+
+    // Variance ratio of the older and newer 50-return halves
+    chow_recent_.push(ret);
+    if (returns_ > 50) chow_prior_.push(return_history_.ago(50));
+    if (chow_prior_.full()) {
+        double var2 = chow_recent_.sample_variance();
+        features_.chow_test_statistic_breakpoint_detection_50.push_back(var2 > 0 ? chow_prior_.sample_variance() / var2 : 1.0);
+    }
+
+    cvar_window_.push(ret);
+    if (cvar_window_.full()) {
+        const size_t tail = std::max(1, static_cast<int>(20 * kCvarTailFraction));
+        features_.conditional_value_at_risk_cvar_95_20.push_back(cvar_window_.sum_smallest(tail) / tail);
+    }
+
+    sortino_sum_.push(ret);
+    sortino_downside_.push(ret < 0 ? ret * ret : 0.0);
+    sortino_count_.push(ret < 0 ? 1.0 : 0.0);
+    if (sortino_sum_.full()) {
+        double mean_return = sortino_sum_.sum() / 30;
+        double count = std::round(sortino_count_.sum());
+        double downside_deviation = count > 0 ? std::sqrt(std::max(0.0, sortino_downside_.sum()) / count) : 0.0;
+        features_.sortino_ratio_30.push_back(downside_deviation > 0 ? mean_return / downside_deviation : 0.0);
+    }
+}
+
+void StreamingFeatureEngine::update_regimes(double ret) {
+    regime_2_->update(ret);
+    regime_3_->update(ret);
+    const double* two = regime_2_->probabilities();
+    const double* three = regime_3_->probabilities();
+    features_.markov_regime_switching_garch_2_state.push_back(two[1]);
+    features_.market_regime_hmm_3_states_price_vol.push_back(static_cast<double>(regime_3_->most_likely()));
+    features_.hmm_regime_probability_low_vol.push_back(three[0]);
+    features_.hmm_regime_probability_mid_vol.push_back(three[1]);
+    features_.hmm_regime_probability_high_vol.push_back(three[2]);
+}
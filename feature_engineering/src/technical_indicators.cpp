@@ -1,30 +1,51 @@
 #include "technical_indicators.h"
+#include "fixed_window.h"
+#include "rolling_moments.h"
+#include "order_statistics_window.h"
+#include "rolling_hurst.h"
+#include "regime_model.h"
 #include <cmath>
 #include <numeric>
 #include <stdexcept>
 #include <algorithm>
 
+namespace {
+// Runs a span kernel into a vector sized for its largest possible output
+template <typename Kernel>
+std::vector<double> collect(size_t max_size, Kernel&& kernel) {
+    std::vector<double> out(max_size);
+    out.resize(kernel(out.data()));
+    return out;
+}
+}
+
 std::vector<double> TechnicalIndicators::calculate_returns(const std::vector<double>& prices) {
     if (prices.size() < 2) return {};
-    std::vector<double> returns;
-    returns.reserve(prices.size() - 1);
-    for (size_t i = 1; i < prices.size(); ++i) {
-        returns.push_back(prices[i-1] != 0.0 ? (prices[i] - prices[i-1]) / prices[i-1] : 0.0);
+    return collect(prices.size() - 1, [&](double* out) { return calculate_returns(prices.data(), prices.size(), out); });
+}
+
+size_t TechnicalIndicators::calculate_returns(const double* prices, size_t n, double* out) {
+    if (n < 2) return 0;
+    for (size_t i = 1; i < n; ++i) {
+        out[i-1] = prices[i-1] != 0.0 ? (prices[i] - prices[i-1]) / prices[i-1] : 0.0;
     }
-    return returns;
+    return n - 1;
 }
 
 std::vector<double> TechnicalIndicators::simple_moving_average(const std::vector<double>& data, size_t window) {
     if (data.empty() || window == 0 || data.size() < window) return {};
-    std::vector<double> result;
-    result.reserve(data.size() - window + 1);
-    double sum = std::accumulate(data.begin(), data.begin() + window, 0.0);
-    result.push_back(sum / window);
-    for (size_t i = window; i < data.size(); ++i) {
+    return collect(data.size() - window + 1, [&](double* out) { return simple_moving_average(data.data(), data.size(), window, out); });
+}
+
+size_t TechnicalIndicators::simple_moving_average(const double* data, size_t n, size_t window, double* out) {
+    if (n == 0 || window == 0 || n < window) return 0;
+    double sum = std::accumulate(data, data + window, 0.0);
+    out[0] = sum / window;
+    for (size_t i = window; i < n; ++i) {
         sum += data[i] - data[i - window];
-        result.push_back(sum / window);
+        out[i - window + 1] = sum / window;
     }
-    return result;
+    return n - window + 1;
 }
 
 std::vector<double> TechnicalIndicators::calculate_rsi(const std::vector<double>& prices, int period) {
@@ -58,79 +79,114 @@ std::vector<double> TechnicalIndicators::calculate_rsi(const std::vector<double>
 
 std::vector<double> TechnicalIndicators::calculate_rolling_volatility(const std::vector<double>& returns, int window) {
     if (returns.size() < static_cast<size_t>(window) || window <= 1) return {};
-    std::vector<double> volatility;
-    volatility.reserve(returns.size() - window + 1);
-    for (size_t i = 0; i <= returns.size() - window; ++i) {
-        double sum = 0.0;
-        for (int j = 0; j < window; ++j) sum += returns[i + j];
-        double mean = sum / window;
-        double var_sum = 0.0;
-        for (int j = 0; j < window; ++j) var_sum += (returns[i + j] - mean) * (returns[i + j] - mean);
-        volatility.push_back(std::sqrt(var_sum / (window - 1)));
-    }
-    return volatility;
+    return collect(returns.size() - window + 1, [&](double* out) { return calculate_rolling_volatility(returns.data(), returns.size(), window, out); });
+}
+
+size_t TechnicalIndicators::calculate_rolling_volatility(const double* returns, size_t n, int window, double* out) {
+    if (n < static_cast<size_t>(window) || window <= 1) return 0;
+    RollingMoments moments(window);
+    return moments.push_stddev(returns, n, out);
 }
 
 std::vector<double> TechnicalIndicators::compute_spread(const std::vector<double>& high, const std::vector<double>& low) {
     if (high.size() != low.size()) return {};
-    std::vector<double> spread;
-    spread.reserve(high.size());
-    for (size_t i = 0; i < high.size(); ++i) spread.push_back(high[i] - low[i]);
-    return spread;
+    return collect(high.size(), [&](double* out) { return compute_spread(high.data(), low.data(), high.size(), out); });
+}
+
+size_t TechnicalIndicators::compute_spread(const double* high, const double* low, size_t n, double* out) {
+    for (size_t i = 0; i < n; ++i) out[i] = high[i] - low[i];
+    return n;
 }
 
 std::vector<double> TechnicalIndicators::internal_bar_strength(const std::vector<double>& open, const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close) {
     if (open.size()!=close.size()||high.size()!=close.size()||low.size()!=close.size()) return {};
-    std::vector<double> ibs;
-    ibs.reserve(close.size());
-    for (size_t i = 0; i < close.size(); ++i) {
+    return collect(close.size(), [&](double* out) { return internal_bar_strength(high.data(), low.data(), close.data(), close.size(), out); });
+}
+
+size_t TechnicalIndicators::internal_bar_strength(const double* high, const double* low, const double* close, size_t n, double* out) {
+    for (size_t i = 0; i < n; ++i) {
         double range = high[i] - low[i];
-        ibs.push_back(range > 0 ? (close[i] - low[i]) / range : 0.5);
+        out[i] = range > 0 ? (close[i] - low[i]) / range : 0.5;
     }
-    return ibs;
+    return n;
 }
 
 std::pair<std::vector<int>,std::pair<std::vector<double>,std::vector<double>>> TechnicalIndicators::candle_information(const std::vector<double>& open, const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close) {
     if (open.size()!=close.size()||high.size()!=close.size()||low.size()!=close.size()) return {{},{{},{}}};
-    std::vector<int> way;
-    std::vector<double> filling, amplitude;
-    way.reserve(open.size()); filling.reserve(open.size()); amplitude.reserve(open.size());
-    for (size_t i = 0; i < open.size(); ++i) {
-        way.push_back(close[i]>open[i]?1:(close[i]<open[i]?-1:0));
+    const size_t n = close.size();
+    const std::vector<double> way_values = collect(n, [&](double* out) { return candle_way(open.data(), close.data(), n, out); });
+    std::vector<int> way(way_values.begin(), way_values.end());
+    auto filling = collect(n, [&](double* out) { return candle_filling(open.data(), high.data(), low.data(), close.data(), n, out); });
+    auto amplitude = collect(n, [&](double* out) { return candle_amplitude(high.data(), low.data(), n, out); });
+    return {way, {filling, amplitude}};
+}
+
+size_t TechnicalIndicators::candle_way(const double* open, const double* close, size_t n, double* out) {
+    for (size_t i = 0; i < n; ++i) out[i] = close[i]>open[i]?1.0:(close[i]<open[i]?-1.0:0.0);
+    return n;
+}
+
+size_t TechnicalIndicators::candle_filling(const double* open, const double* high, const double* low, const double* close, size_t n, double* out) {
+    for (size_t i = 0; i < n; ++i) {
         double range = high[i]-low[i];
-        amplitude.push_back(range);
-        filling.push_back(range>0?std::abs(close[i]-open[i])/range:0.0);
+        out[i] = range>0?std::abs(close[i]-open[i])/range:0.0;
     }
-    return {way, {filling, amplitude}};
+    return n;
+}
+
+size_t TechnicalIndicators::candle_amplitude(const double* high, const double* low, size_t n, double* out) {
+    for (size_t i = 0; i < n; ++i) out[i] = high[i]-low[i];
+    return n;
 }
 
 std::pair<std::vector<double>,std::vector<double>> TechnicalIndicators::derivatives(const std::vector<double>& prices) {
     if (prices.size()<2) return {{},{}};
-    std::vector<double> velocity;
-    velocity.reserve(prices.size()-1);
-    for (size_t i=1; i<prices.size(); ++i) velocity.push_back(prices[i]-prices[i-1]);
-    if (velocity.size()<2) return {velocity,{}};
-    std::vector<double> acceleration;
-    acceleration.reserve(velocity.size()-1);
-    for (size_t i=1; i<velocity.size(); ++i) acceleration.push_back(velocity[i]-velocity[i-1]);
-    return {velocity, acceleration};
+    auto velocity_values = collect(prices.size()-1, [&](double* out) { return velocity(prices.data(), prices.size(), out); });
+    if (prices.size()<3) return {velocity_values,{}};
+    return {velocity_values, collect(prices.size()-2, [&](double* out) { return acceleration(prices.data(), prices.size(), out); })};
+}
+
+size_t TechnicalIndicators::velocity(const double* prices, size_t n, double* out) {
+    if (n<2) return 0;
+    for (size_t i=1; i<n; ++i) out[i-1] = prices[i]-prices[i-1];
+    return n-1;
+}
+
+size_t TechnicalIndicators::acceleration(const double* prices, size_t n, double* out) {
+    if (n<3) return 0;
+    for (size_t i=2; i<n; ++i) out[i-2] = (prices[i]-prices[i-1])-(prices[i-1]-prices[i-2]);
+    return n-2;
 }
 
 std::vector<double> TechnicalIndicators::log_pct_change(const std::vector<double>& prices, int window_size) {
     if (prices.size()<=static_cast<size_t>(window_size)) return {};
-    std::vector<double> result;
-    result.reserve(prices.size()-window_size);
-    for (size_t i=window_size; i<prices.size(); ++i) {
-        result.push_back((prices[i-window_size]>0&&prices[i]>0)?std::log(prices[i]/prices[i-window_size]):0.0);
+    return collect(prices.size()-window_size, [&](double* out) { return log_pct_change(prices.data(), prices.size(), window_size, out); });
+}
+
+size_t TechnicalIndicators::log_pct_change(const double* prices, size_t n, int window_size, double* out) {
+    if (window_size<0 || n<=static_cast<size_t>(window_size)) return 0;
+    for (size_t i=window_size; i<n; ++i) {
+        out[i-window_size] = (prices[i-window_size]>0&&prices[i]>0)?std::log(prices[i]/prices[i-window_size]):0.0;
     }
-    return result;
+    return n-window_size;
+}
+
+size_t TechnicalIndicators::momentum(const double* prices, size_t n, int period, double* out) {
+    if (period<0 || n<=static_cast<size_t>(period)) return 0;
+    for (size_t i=period; i<n; ++i) {
+        out[i-period] = prices[i-period]!=0.0 ? prices[i]/prices[i-period] : 0.0;
+    }
+    return n-period;
 }
 
 std::vector<double> TechnicalIndicators::auto_correlation(const std::vector<double>& prices, int window_size, int lag) {
     if (prices.size()<static_cast<size_t>(window_size+lag)) return {};
-    std::vector<double> result;
-    result.reserve(prices.size()-window_size-lag+1);
-    for (size_t i=0; i<=prices.size()-window_size-lag; ++i) {
+    return collect(prices.size()-window_size-lag+1, [&](double* out) { return auto_correlation(prices.data(), prices.size(), window_size, lag, out); });
+}
+
+size_t TechnicalIndicators::auto_correlation(const double* prices, size_t n, int window_size, int lag, double* out) {
+    if (n<static_cast<size_t>(window_size+lag)) return 0;
+    for (size_t i=0; i<=n-window_size-lag; ++i) {
         double sum_x=0, sum_y=0, sum_xy=0, sum_x2=0, sum_y2=0;
         for (int j=0; j<window_size; ++j) {
             double x=prices[i+j], y=prices[i+j+lag];
@@ -138,42 +194,41 @@ std::vector<double> TechnicalIndicators::auto_correlation(const std::vector<doub
         }
         double num=window_size*sum_xy-sum_x*sum_y;
         double den=std::sqrt((window_size*sum_x2-sum_x*sum_x)*(window_size*sum_y2-sum_y*sum_y));
-        result.push_back(den!=0?num/den:0.0);
+        out[i]=den!=0?num/den:0.0;
     }
-    return result;
+    return n-window_size-lag+1;
 }
 
 std::vector<double> TechnicalIndicators::skewness(const std::vector<double>& prices, int window_size) {
-    if (prices.size()<static_cast<size_t>(window_size)) return {};
-    std::vector<double> result;
-    result.reserve(prices.size()-window_size+1);
-    for (size_t i=0; i<=prices.size()-window_size; ++i) {
-        double sum=0; for(int j=0; j<window_size; ++j) sum+=prices[i+j];
-        double mean=sum/window_size, m3=0, m2=0;
-        for (int j=0; j<window_size; ++j) {
-            double diff=prices[i+j]-mean; m2+=diff*diff; m3+=diff*diff*diff;
-        }
-        m2/=window_size; m3/=window_size;
-        double std_dev=std::sqrt(m2);
-        result.push_back(std_dev>0?m3/(std_dev*std_dev*std_dev):0.0);
+    if (window_size<=0 || prices.size()<static_cast<size_t>(window_size)) return {};
+    return collect(prices.size()-window_size+1, [&](double* out) { return skewness(prices.data(), prices.size(), window_size, out); });
+}
+
+size_t TechnicalIndicators::skewness(const double* prices, size_t n, int window_size, double* out) {
+    if (window_size<=0 || n<static_cast<size_t>(window_size)) return 0;
+    RollingMoments moments(window_size);
+    size_t count = 0;
+    for (size_t i=0; i<n; ++i) {
+        moments.push(prices[i]);
+        if (moments.full()) out[count++] = moments.skewness();
     }
-    return result;
+    return count;
 }
 
 std::vector<double> TechnicalIndicators::kurtosis(const std::vector<double>& prices, int window_size) {
-    if (prices.size()<static_cast<size_t>(window_size)) return {};
-    std::vector<double> result;
-    result.reserve(prices.size()-window_size+1);
-    for (size_t i=0; i<=prices.size()-window_size; ++i) {
-        double sum=0; for(int j=0; j<window_size; ++j) sum+=prices[i+j];
-        double mean=sum/window_size, m4=0, m2=0;
-        for (int j=0; j<window_size; ++j) {
-            double diff=prices[i+j]-mean; m2+=diff*diff; m4+=diff*diff*diff*diff;
-        }
-        m2/=window_size; m4/=window_size;
-        result.push_back(m2>0?(m4/(m2*m2))-3.0:0.0);
+    if (window_size<=0 || prices.size()<static_cast<size_t>(window_size)) return {};
+    return collect(prices.size()-window_size+1, [&](double* out) { return kurtosis(prices.data(), prices.size(), window_size, out); });
+}
+
+size_t TechnicalIndicators::kurtosis(const double* prices, size_t n, int window_size, double* out) {
+    if (window_size<=0 || n<static_cast<size_t>(window_size)) return 0;
+    RollingMoments moments(window_size);
+    size_t count = 0;
+    for (size_t i=0; i<n; ++i) {
+        moments.push(prices[i]);
+        if (moments.full()) out[count++] = moments.excess_kurtosis();
     }
-    return result;
+    return count;
 }
 
 std::vector<double> TechnicalIndicators::kama(const std::vector<double>& prices, int l1, int l2, int l3) {
@@ -195,29 +250,35 @@ std::vector<double> TechnicalIndicators::kama(const std::vector<double>& prices,
 }
 
 std::vector<double> TechnicalIndicators::linear_slope(const std::vector<double>& prices, int window_size) {
-    if (prices.size()<static_cast<size_t>(window_size)) return {};
-    std::vector<double> result;
-    result.reserve(prices.size()-window_size+1);
+    if (window_size<=0 || prices.size()<static_cast<size_t>(window_size)) return {};
+    return collect(prices.size()-window_size+1, [&](double* out) { return linear_slope(prices.data(), prices.size(), window_size, out); });
+}
+
+size_t TechnicalIndicators::linear_slope(const double* prices, size_t n, int window_size, double* out) {
+    if (window_size<=0 || n<static_cast<size_t>(window_size)) return 0;
     const double sum_x=static_cast<double>(window_size*(window_size-1))/2.0;
     const double sum_x2=static_cast<double>(window_size*(window_size-1)*(2*window_size-1))/6.0;
     const double den=window_size*sum_x2-sum_x*sum_x;
-    if(den==0) return {};
-    for (size_t i=0; i<=prices.size()-window_size; ++i) {
+    if(den==0) return 0;
+    for (size_t i=0; i<=n-window_size; ++i) {
         double sum_y=0, sum_xy=0;
         for (int j=0; j<window_size; ++j) {
             sum_y+=prices[i+j]; sum_xy+=j*prices[i+j];
         }
-        result.push_back((window_size*sum_xy-sum_x*sum_y)/den);
+        out[i]=(window_size*sum_xy-sum_x*sum_y)/den;
     }
-    return result;
+    return n-window_size+1;
 }
 
 std::vector<double> TechnicalIndicators::parkinson_volatility(const std::vector<double>& high, const std::vector<double>& low, int window_size) {
     if (high.size()!=low.size()||high.size()<static_cast<size_t>(window_size)) return {};
-    std::vector<double> result;
-    result.reserve(high.size()-window_size+1);
+    return collect(high.size()-window_size+1, [&](double* out) { return parkinson_volatility(high.data(), low.data(), high.size(), window_size, out); });
+}
+
+size_t TechnicalIndicators::parkinson_volatility(const double* high, const double* low, size_t n, int window_size, double* out) {
+    if (n<static_cast<size_t>(window_size)) return 0;
     const double factor=1.0/(4.0*std::log(2.0));
-    for (size_t i=0; i<=high.size()-window_size; ++i) {
+    for (size_t i=0; i<=n-window_size; ++i) {
         double sum=0.0;
         for (int j=0; j<window_size; ++j) {
             if (low[i+j]>0) {
@@ -225,167 +286,154 @@ std::vector<double> TechnicalIndicators::parkinson_volatility(const std::vector<
                 sum+=log_hl*log_hl;
             }
         }
-        result.push_back(std::sqrt(sum/window_size)*factor);
+        out[i]=std::sqrt(sum/window_size)*factor;
     }
-    return result;
+    return n-window_size+1;
 }
 
 // Statistical/Mathematical Features
 std::vector<double> TechnicalIndicators::z_score_20(const std::vector<double>& returns) {
-    const int window = 20;
-    if (returns.size() < static_cast<size_t>(window)) return {};
+    if (returns.size() < 20) return {};
+    return collect(returns.size() - 19, [&](double* out) { return FixedWindow<20>::z_score(returns.data(), returns.size(), out); });
+}
+
+std::vector<double> TechnicalIndicators::z_score(const std::vector<double>& returns, int window) {
+    if (window < 2 || returns.size() < static_cast<size_t>(window)) return {};
     std::vector<double> result;
     result.reserve(returns.size() - window + 1);
     
-    for (size_t i = 0; i <= returns.size() - window; ++i) {
-        double sum = 0.0;
-        for (int j = 0; j < window; ++j) sum += returns[i + j];
-        double mean = sum / window;
-        
-        double var_sum = 0.0;
-        for (int j = 0; j < window; ++j) {
-            double diff = returns[i + j] - mean;
-            var_sum += diff * diff;
-        }
-        double std_dev = std::sqrt(var_sum / (window - 1));
-        
-        double z_score = std_dev > 0 ? (returns[i + window - 1] - mean) / std_dev : 0.0;
+    RollingMoments moments(window);
+    for (double r : returns) {
+        moments.push(r);
+        if (!moments.full()) continue;
+        double std_dev = std::sqrt(moments.sample_variance());
+        double z_score = std_dev > 0 ? (r - moments.mean()) / std_dev : 0.0;
         result.push_back(z_score);
     }
     return result;
 }
 
 std::vector<double> TechnicalIndicators::percentile_rank_50(const std::vector<double>& prices) {
-    const int window = 50;
-    if (prices.size() < static_cast<size_t>(window)) return {};
-    std::vector<double> result;
-    result.reserve(prices.size() - window + 1);
-    
-    for (size_t i = 0; i <= prices.size() - window; ++i) {
-        double current_price = prices[i + window - 1];
-        int count_below = 0;
-        for (int j = 0; j < window; ++j) {
-            if (prices[i + j] < current_price) count_below++;
-        }
-        result.push_back(static_cast<double>(count_below) / window * 100.0);
+    return percentile_rank(prices, 50);
+}
+
+std::vector<double> TechnicalIndicators::percentile_rank(const std::vector<double>& prices, int window) {
+    if (window <= 0 || prices.size() < static_cast<size_t>(window)) return {};
+    return collect(prices.size() - window + 1, [&](double* out) { return percentile_rank(prices.data(), prices.size(), window, out); });
+}
+
+size_t TechnicalIndicators::percentile_rank(const double* prices, size_t n, int window, double* out) {
+    if (window <= 0 || n < static_cast<size_t>(window)) return 0;
+    size_t count = 0;
+    OrderStatisticWindow order_stats(prices, n);
+    for (size_t i = 0; i < n; ++i) {
+        order_stats.insert(prices[i]);
+        if (i >= static_cast<size_t>(window)) order_stats.erase(prices[i - window]);
+        if (i + 1 < static_cast<size_t>(window)) continue;
+        size_t count_below = order_stats.count_less(prices[i]);
+        out[count++] = static_cast<double>(count_below) / window * 100.0;
     }
-    return result;
+    return count;
 }
 
 std::vector<double> TechnicalIndicators::coefficient_of_variation_30(const std::vector<double>& returns) {
+    if (returns.size() < 30) return {};
+    return collect(returns.size() - 29, [&](double* out) { return coefficient_of_variation_30(returns.data(), returns.size(), out); });
+}
+
+size_t TechnicalIndicators::coefficient_of_variation_30(const double* returns, size_t n, double* out) {
     const int window = 30;
-    if (returns.size() < static_cast<size_t>(window)) return {};
-    std::vector<double> result;
-    result.reserve(returns.size() - window + 1);
-    
-    for (size_t i = 0; i <= returns.size() - window; ++i) {
-        double sum = 0.0;
-        for (int j = 0; j < window; ++j) sum += returns[i + j];
-        double mean = sum / window;
-        
+    if (n < static_cast<size_t>(window)) return 0;
+    size_t count = 0;
+    RollingMoments moments(window);
+    for (size_t i = 0; i < n; ++i) {
+        moments.push(returns[i]);
+        if (!moments.full()) continue;
+        double mean = moments.mean();
         if (std::abs(mean) < 1e-10) {
-            result.push_back(0.0);
+            out[count++] = 0.0;
             continue;
         }
-        
-        double var_sum = 0.0;
-        for (int j = 0; j < window; ++j) {
-            double diff = returns[i + j] - mean;
-            var_sum += diff * diff;
-        }
-        double std_dev = std::sqrt(var_sum / (window - 1));
-        result.push_back(std_dev / std::abs(mean));
+        double std_dev = std::sqrt(moments.sample_variance());
+        out[count++] = std_dev / std::abs(mean);
     }
-    return result;
+    return count;
 }
 
 std::vector<double> TechnicalIndicators::detrended_price_oscillator_20(const std::vector<double>& prices) {
     const int window = 20;
-    auto sma = simple_moving_average(prices, window);
-    if (sma.empty() || prices.size() < static_cast<size_t>(window)) return {};
-    
-    std::vector<double> result;
-    result.reserve(sma.size());
-    
-    for (size_t i = 0; i < sma.size(); ++i) {
-        result.push_back(prices[i + window - 1] - sma[i]);
+    return detrended_price_oscillator(prices, simple_moving_average(prices, window), window);
+}
+
+std::vector<double> TechnicalIndicators::detrended_price_oscillator(const std::vector<double>& prices, const std::vector<double>& sma, int window) {
+    if (sma.empty() || window <= 0 || prices.size() < static_cast<size_t>(window)) return {};
+    return collect(sma.size(), [&](double* out) { return detrended_price_oscillator(prices.data(), prices.size(), sma.data(), sma.size(), window, out); });
+}
+
+size_t TechnicalIndicators::detrended_price_oscillator(const double* prices, size_t n, const double* sma, size_t sma_n, int window, double* out) {
+    if (sma_n == 0 || window <= 0 || n < static_cast<size_t>(window)) return 0;
+    for (size_t i = 0; i < sma_n; ++i) {
+        out[i] = prices[i + window - 1] - sma[i];
     }
-    return result;
+    return sma_n;
 }
 
 std::vector<double> TechnicalIndicators::hurst_exponent_100(const std::vector<double>& prices) {
-    const int window = 100;
-    if (prices.size() < static_cast<size_t>(window)) return {};
-    std::vector<double> result;
-    result.reserve(prices.size() - window + 1);
-    
-    for (size_t i = 0; i <= prices.size() - window; ++i) {
-        std::vector<double> log_prices;
-        for (int j = 0; j < window; ++j) {
-            if (prices[i + j] > 0) log_prices.push_back(std::log(prices[i + j]));
-        }
-        
-        if (log_prices.size() < 10) {
-            result.push_back(0.5);
-            continue;
-        }
-        
-        // Simplified R/S analysis
-        std::vector<double> cumsum(log_prices.size());
-        cumsum[0] = log_prices[0];
-        for (size_t k = 1; k < log_prices.size(); ++k) {
-            cumsum[k] = cumsum[k-1] + log_prices[k];
-        }
-        
-        double mean_log = cumsum.back() / log_prices.size();
-        double range = 0.0, std_dev = 0.0;
-        
-        for (size_t k = 0; k < log_prices.size(); ++k) {
-            double dev = cumsum[k] - (k + 1) * mean_log;
-            range = std::max(range, std::abs(dev));
-            std_dev += (log_prices[k] - mean_log) * (log_prices[k] - mean_log);
-        }
-        
-        std_dev = std::sqrt(std_dev / (log_prices.size() - 1));
-        double rs = std_dev > 0 ? range / std_dev : 1.0;
-        double hurst = rs > 0 ? std::log(rs) / std::log(log_prices.size()) : 0.5;
-        result.push_back(std::max(0.0, std::min(1.0, hurst)));
-    }
-    return result;
+    return hurst_exponent(prices, 100);
+}
+
+std::vector<double> TechnicalIndicators::hurst_exponent(const std::vector<double>& prices, size_t window, const std::vector<size_t>& lags) {
+    if (window == 0 || prices.size() < window) return {};
+    RollingHurst hurst(window, lags);
+    return collect(prices.size() - window + 1, [&](double* out) { return hurst.compute(prices.data(), prices.size(), out); });
+}
+
+size_t TechnicalIndicators::hurst_exponent_100(const double* prices, size_t n, double* out) {
+    // One estimator per thread, so its scratch is reused across series
+    thread_local RollingHurst hurst(100);
+    return hurst.compute(prices, n, out);
 }
 
 std::vector<double> TechnicalIndicators::garch_volatility_21(const std::vector<double>& returns) {
-    const int window = 21;
-    if (returns.size() < static_cast<size_t>(window)) return {};
+    const size_t window = 21;
+    if (returns.size() < window) return {};
     std::vector<double> result;
     result.reserve(returns.size() - window + 1);
-    
-    // Simplified GARCH(1,1) estimation
+
+    // Simplified GARCH(1,1) restarted from zero at each window start. Unrolled,
+    // a window's variance is omega * sum(beta^j) + alpha * sum(beta^j * r^2)
+    // over its returns newest first, so the weighted sum slides in O(1).
     const double alpha = 0.1, beta = 0.85, omega = 0.05;
-    
-    for (size_t i = 0; i <= returns.size() - window; ++i) {
-        double variance = 0.0;
-        for (int j = 0; j < window; ++j) {
-            double ret = returns[i + j];
-            variance = omega + alpha * ret * ret + beta * variance;
-        }
-        result.push_back(std::sqrt(variance));
+    double beta_window = 1.0, omega_sum = 0.0;
+    for (size_t j = 0; j < window; ++j) {
+        omega_sum += beta_window;
+        beta_window *= beta;
+    }
+    omega_sum *= omega;
+
+    double weighted = 0.0;
+    for (size_t t = 0; t < returns.size(); ++t) {
+        weighted = beta * weighted + returns[t] * returns[t];
+        if (t >= window) weighted -= beta_window * returns[t - window] * returns[t - window];
+        if (t + 1 >= window) result.push_back(std::sqrt(std::max(0.0, omega_sum + alpha * weighted)));
     }
     return result;
 }
 
 std::vector<double> TechnicalIndicators::shannon_entropy_volume_10(const std::vector<double>& volume) {
+    if (volume.size() < 10) return {};
+    return collect(volume.size() - 9, [&](double* out) { return shannon_entropy_volume_10(volume.data(), volume.size(), out); });
+}
+
+size_t TechnicalIndicators::shannon_entropy_volume_10(const double* volume, size_t n, double* out) {
     const int window = 10;
-    if (volume.size() < static_cast<size_t>(window)) return {};
-    std::vector<double> result;
-    result.reserve(volume.size() - window + 1);
-    
-    for (size_t i = 0; i <= volume.size() - window; ++i) {
+    if (n < static_cast<size_t>(window)) return 0;
+    for (size_t i = 0; i <= n - window; ++i) {
         double total_volume = 0.0;
         for (int j = 0; j < window; ++j) total_volume += volume[i + j];
         
         if (total_volume <= 0) {
-            result.push_back(0.0);
+            out[i] = 0.0;
             continue;
         }
         
@@ -394,20 +442,21 @@ std::vector<double> TechnicalIndicators::shannon_entropy_volume_10(const std::ve
             double prob = volume[i + j] / total_volume;
             if (prob > 0) entropy -= prob * std::log(prob);
         }
-        result.push_back(entropy);
+        out[i] = entropy;
     }
-    return result;
+    return n - window + 1;
 }
 
 // Technical Analysis Extended
 std::vector<double> TechnicalIndicators::chande_momentum_oscillator_14(const std::vector<double>& prices) {
+    if (prices.size() <= 14) return {};
+    return collect(prices.size() - 14, [&](double* out) { return chande_momentum_oscillator_14(prices.data(), prices.size(), out); });
+}
+
+size_t TechnicalIndicators::chande_momentum_oscillator_14(const double* prices, size_t n, double* out) {
     const int period = 14;
-    if (prices.size() <= static_cast<size_t>(period)) return {};
-    
-    std::vector<double> result;
-    result.reserve(prices.size() - period);
-    
-    for (size_t i = period; i < prices.size(); ++i) {
+    if (n <= static_cast<size_t>(period)) return 0;
+    for (size_t i = period; i < n; ++i) {
         double sum_up = 0.0, sum_down = 0.0;
         for (int j = 1; j <= period; ++j) {
             double change = prices[i - j + 1] - prices[i - j];
@@ -415,39 +464,33 @@ std::vector<double> TechnicalIndicators::chande_momentum_oscillator_14(const std
             else sum_down += std::abs(change);
         }
         
-        double cmo = (sum_up + sum_down) > 0 ? 100.0 * (sum_up - sum_down) / (sum_up + sum_down) : 0.0;
-        result.push_back(cmo);
+        out[i - period] = (sum_up + sum_down) > 0 ? 100.0 * (sum_up - sum_down) / (sum_up + sum_down) : 0.0;
     }
-    return result;
+    return n - period;
 }
 
 std::vector<double> TechnicalIndicators::aroon_oscillator_25(const std::vector<double>& high, const std::vector<double>& low) {
+    if (high.size() != low.size() || high.size() < 25) return {};
+    return collect(high.size() - 24, [&](double* out) { return aroon_oscillator_25(high.data(), low.data(), high.size(), out); });
+}
+
+size_t TechnicalIndicators::aroon_oscillator_25(const double* high, const double* low, size_t n, double* out) {
     const int period = 25;
-    if (high.size() != low.size() || high.size() < static_cast<size_t>(period)) return {};
-    
-    std::vector<double> result;
-    result.reserve(high.size() - period + 1);
-    
-    for (size_t i = period - 1; i < high.size(); ++i) {
-        int high_idx = 0, low_idx = 0;
-        double max_high = high[i - period + 1], min_low = low[i - period + 1];
-        
-        for (int j = 0; j < period; ++j) {
-            if (high[i - j] > max_high) {
-                max_high = high[i - j];
-                high_idx = j;
-            }
-            if (low[i - j] < min_low) {
-                min_low = low[i - j];
-                low_idx = j;
-            }
-        }
+    if (n < static_cast<size_t>(period)) return 0;
+    auto high_idx = rolling_argmax(high, n, period);
+    auto low_idx = rolling_argmin(low, n, period);
+    for (size_t k = 0; k < high_idx.size(); ++k) {
+        size_t i = k + period - 1;
+        // Bars since the most recent extreme; an extreme tied with the oldest
+        // bar in the window counts as the current bar (original scan semantics)
+        int bars_since_high = high[high_idx[k]] == high[k] ? 0 : static_cast<int>(i - high_idx[k]);
+        int bars_since_low = low[low_idx[k]] == low[k] ? 0 : static_cast<int>(i - low_idx[k]);
         
-        double aroon_up = 100.0 * (period - high_idx) / period;
-        double aroon_down = 100.0 * (period - low_idx) / period;
-        result.push_back(aroon_up - aroon_down);
+        double aroon_up = 100.0 * (period - bars_since_high) / period;
+        double aroon_down = 100.0 * (period - bars_since_low) / period;
+        out[k] = aroon_up - aroon_down;
     }
-    return result;
+    return high_idx.size();
 }
 
 std::vector<double> TechnicalIndicators::trix_15(const std::vector<double>& prices) {
@@ -458,22 +501,29 @@ std::vector<double> TechnicalIndicators::trix_15(const std::vector<double>& pric
     auto ema2 = exponential_moving_average(ema1, period);
     if (ema2.empty()) return {};
     
-    auto ema3 = exponential_moving_average(ema2, period);
+    return trix_from_triple_ema(exponential_moving_average(ema2, period));
+}
+
+std::vector<double> TechnicalIndicators::trix_from_triple_ema(const std::vector<double>& ema3) {
     if (ema3.size() < 2) return {};
-    
-    std::vector<double> result;
-    result.reserve(ema3.size() - 1);
-    
-    for (size_t i = 1; i < ema3.size(); ++i) {
-        double trix = ema3[i-1] > 0 ? 10000.0 * (ema3[i] - ema3[i-1]) / ema3[i-1] : 0.0;
-        result.push_back(trix);
+    return collect(ema3.size() - 1, [&](double* out) { return trix_from_triple_ema(ema3.data(), ema3.size(), out); });
+}
+
+size_t TechnicalIndicators::trix_from_triple_ema(const double* ema3, size_t n, double* out) {
+    if (n < 2) return 0;
+    for (size_t i = 1; i < n; ++i) {
+        out[i - 1] = ema3[i-1] > 0 ? 10000.0 * (ema3[i] - ema3[i-1]) / ema3[i-1] : 0.0;
     }
-    return result;
+    return n - 1;
 }
 
 std::vector<double> TechnicalIndicators::vortex_indicator_14(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close) {
-    const int period = 14;
-    if (high.size() != low.size() || high.size() != close.size() || high.size() < static_cast<size_t>(period + 1)) return {};
+    if (high.size() != low.size() || high.size() != close.size() || high.size() < 15) return {};
+    return collect(high.size() - 14, [&](double* out) { return FixedWindow<14>::vortex_indicator(high.data(), low.data(), close.data(), high.size(), out); });
+}
+
+std::vector<double> TechnicalIndicators::vortex_indicator(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, int period) {
+    if (period <= 0 || high.size() != low.size() || high.size() != close.size() || high.size() < static_cast<size_t>(period + 1)) return {};
     
     std::vector<double> result;
     result.reserve(high.size() - period);
@@ -498,89 +548,111 @@ std::vector<double> TechnicalIndicators::vortex_indicator_14(const std::vector<d
 }
 
 std::vector<double> TechnicalIndicators::supertrend_10_3(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close) {
+    if (high.size() != low.size() || high.size() != close.size() || high.size() < 10) return {};
+    return collect(high.size() - 9, [&](double* out) { return supertrend_10_3(high.data(), low.data(), close.data(), high.size(), out); });
+}
+
+size_t TechnicalIndicators::supertrend_10_3(const double* high, const double* low, const double* close, size_t n, double* out) {
     const int period = 10;
     const double multiplier = 3.0;
-    if (high.size() != low.size() || high.size() != close.size() || high.size() < static_cast<size_t>(period)) return {};
+    if (n < static_cast<size_t>(period)) return 0;
     
-    std::vector<double> result;
-    result.reserve(high.size() - period + 1);
-    
-    for (size_t i = period - 1; i < high.size(); ++i) {
-        double atr = calculate_atr(high, low, close, period, i);
+    auto true_range = [&](size_t idx) {
+        double tr = high[idx] - low[idx];
+        if (idx > 0) tr = std::max({tr, std::abs(high[idx] - close[idx-1]), std::abs(low[idx] - close[idx-1])});
+        return tr;
+    };
+    
+    for (size_t i = period - 1; i < n; ++i) {
+        // calculate_atr()'s sum, newest bar first, re-taken each bar: a
+        // running sum drifts and can flip the close vs band comparisons.
+        // It reports 0 until a full lookback with a previous bar exists
+        double tr_sum = 0.0;
+        if (i >= static_cast<size_t>(period)) {
+            for (int j = 0; j < period; ++j) tr_sum += true_range(i - j);
+        }
+        double atr = tr_sum / period;
         double hl2 = (high[i] + low[i]) / 2.0;
         double upper_band = hl2 + multiplier * atr;
         double lower_band = hl2 - multiplier * atr;
         
         // Simplified supertrend calculation
-        double supertrend = close[i] > upper_band ? lower_band : upper_band;
-        result.push_back(supertrend);
+        out[i - period + 1] = close[i] > upper_band ? lower_band : upper_band;
     }
-    return result;
+    return n - period + 1;
 }
 
 std::vector<double> TechnicalIndicators::ichimoku_senkou_span_A_9_26(const std::vector<double>& high, const std::vector<double>& low) {
+    if (high.size() != low.size() || high.size() < 26) return {};
+    return collect(high.size() - 25, [&](double* out) { return ichimoku_senkou_span_A_9_26(high.data(), low.data(), high.size(), out); });
+}
+
+size_t TechnicalIndicators::ichimoku_senkou_span_A_9_26(const double* high, const double* low, size_t n, double* out) {
     const int tenkan_period = 9, kijun_period = 26;
-    if (high.size() != low.size() || high.size() < static_cast<size_t>(kijun_period)) return {};
+    if (n < static_cast<size_t>(kijun_period)) return 0;
     
-    std::vector<double> result;
-    result.reserve(high.size() - kijun_period + 1);
+    auto tenkan_high = rolling_argmax(high, n, tenkan_period);
+    auto tenkan_low = rolling_argmin(low, n, tenkan_period);
+    auto kijun_high = rolling_argmax(high, n, kijun_period);
+    auto kijun_low = rolling_argmin(low, n, kijun_period);
+    const size_t tenkan_offset = kijun_period - tenkan_period;
     
-    for (size_t i = kijun_period - 1; i < high.size(); ++i) {
+    for (size_t k = 0; k < kijun_high.size(); ++k) {
         // Tenkan-sen
-        double tenkan_high = *std::max_element(high.begin() + i - tenkan_period + 1, high.begin() + i + 1);
-        double tenkan_low = *std::min_element(low.begin() + i - tenkan_period + 1, low.begin() + i + 1);
-        double tenkan_sen = (tenkan_high + tenkan_low) / 2.0;
+        double tenkan_sen = (high[tenkan_high[k + tenkan_offset]] + low[tenkan_low[k + tenkan_offset]]) / 2.0;
         
         // Kijun-sen
-        double kijun_high = *std::max_element(high.begin() + i - kijun_period + 1, high.begin() + i + 1);
-        double kijun_low = *std::min_element(low.begin() + i - kijun_period + 1, low.begin() + i + 1);
-        double kijun_sen = (kijun_high + kijun_low) / 2.0;
+        double kijun_sen = (high[kijun_high[k]] + low[kijun_low[k]]) / 2.0;
         
         // Senkou Span A
-        result.push_back((tenkan_sen + kijun_sen) / 2.0);
+        out[k] = (tenkan_sen + kijun_sen) / 2.0;
     }
-    return result;
+    return kijun_high.size();
 }
 
 std::vector<double> TechnicalIndicators::ichimoku_senkou_span_B_26_52(const std::vector<double>& high, const std::vector<double>& low) {
+    if (high.size() != low.size() || high.size() < 52) return {};
+    return collect(high.size() - 51, [&](double* out) { return ichimoku_senkou_span_B_26_52(high.data(), low.data(), high.size(), out); });
+}
+
+size_t TechnicalIndicators::ichimoku_senkou_span_B_26_52(const double* high, const double* low, size_t n, double* out) {
     const int period = 52;
-    if (high.size() != low.size() || high.size() < static_cast<size_t>(period)) return {};
-    
-    std::vector<double> result;
-    result.reserve(high.size() - period + 1);
-    
-    for (size_t i = period - 1; i < high.size(); ++i) {
-        double max_high = *std::max_element(high.begin() + i - period + 1, high.begin() + i + 1);
-        double min_low = *std::min_element(low.begin() + i - period + 1, low.begin() + i + 1);
-        result.push_back((max_high + min_low) / 2.0);
+    if (n < static_cast<size_t>(period)) return 0;
+    auto max_high = rolling_argmax(high, n, period);
+    auto min_low = rolling_argmin(low, n, period);
+    for (size_t k = 0; k < max_high.size(); ++k) {
+        out[k] = (high[max_high[k]] + low[min_low[k]]) / 2.0;
     }
-    return result;
+    return max_high.size();
 }
 
 std::vector<double> TechnicalIndicators::fisher_transform_10(const std::vector<double>& high, const std::vector<double>& low) {
+    if (high.size() != low.size() || high.size() < 10) return {};
+    return collect(high.size() - 9, [&](double* out) { return fisher_transform_10(high.data(), low.data(), high.size(), out); });
+}
+
+size_t TechnicalIndicators::fisher_transform_10(const double* high, const double* low, size_t n, double* out) {
     const int period = 10;
-    if (high.size() != low.size() || high.size() < static_cast<size_t>(period)) return {};
-    
-    std::vector<double> result;
-    result.reserve(high.size() - period + 1);
-    
-    for (size_t i = period - 1; i < high.size(); ++i) {
-        double max_high = *std::max_element(high.begin() + i - period + 1, high.begin() + i + 1);
-        double min_low = *std::min_element(low.begin() + i - period + 1, low.begin() + i + 1);
+    if (n < static_cast<size_t>(period)) return 0;
+    auto max_highs = rolling_argmax(high, n, period);
+    auto min_lows = rolling_argmin(low, n, period);
+    for (size_t k = 0; k < max_highs.size(); ++k) {
+        size_t i = k + period - 1;
+        double max_high = high[max_highs[k]];
+        double min_low = low[min_lows[k]];
         
         double range = max_high - min_low;
         if (range <= 0) {
-            result.push_back(0.0);
+            out[k] = 0.0;
             continue;
         }
         
         double normalized = 2.0 * ((high[i] + low[i]) / 2.0 - min_low) / range - 1.0;
         normalized = std::max(-0.999, std::min(0.999, normalized));
         
-        double fisher = 0.5 * std::log((1.0 + normalized) / (1.0 - normalized));
-        result.push_back(fisher);
+        out[k] = 0.5 * std::log((1.0 + normalized) / (1.0 - normalized));
     }
-    return result;
+    return max_highs.size();
 }
 
 // Volume/Liquidity Advanced
@@ -605,61 +677,62 @@ std::vector<double> TechnicalIndicators::volume_weighted_average_price_intraday(
 
 std::vector<double> TechnicalIndicators::volume_profile_high_volume_node_intraday(const std::vector<double>& prices, const std::vector<double>& volume) {
     if (prices.size() != volume.size() || prices.empty()) return {};
-    
-    std::vector<double> result;
-    result.reserve(prices.size());
-    
-    // Simplified volume profile - find price level with highest volume
-    for (size_t i = 0; i < prices.size(); ++i) {
-        double max_volume = 0.0;
-        double hvn_price = prices[i];
-        
-        for (size_t j = 0; j <= i; ++j) {
-            if (volume[j] > max_volume) {
-                max_volume = volume[j];
-                hvn_price = prices[j];
-            }
+    return collect(prices.size(), [&](double* out) { return volume_profile_high_volume_node_intraday(prices.data(), volume.data(), prices.size(), out); });
+}
+
+size_t TechnicalIndicators::volume_profile_high_volume_node_intraday(const double* prices, const double* volume, size_t n, double* out) {
+    // Simplified volume profile - price level with the highest volume so far,
+    // tracked as a running maximum over the prefix
+    double max_volume = 0.0;
+    size_t hvn_index = 0;
+    bool found = false;
+    for (size_t i = 0; i < n; ++i) {
+        if (volume[i] > max_volume) {
+            max_volume = volume[i];
+            hvn_index = i;
+            found = true;
         }
-        result.push_back(hvn_price);
+        out[i] = found ? prices[hvn_index] : prices[i];
     }
-    return result;
+    return n;
 }
 
 std::vector<double> TechnicalIndicators::volume_profile_low_volume_node_intraday(const std::vector<double>& prices, const std::vector<double>& volume) {
     if (prices.size() != volume.size() || prices.empty()) return {};
-    
-    std::vector<double> result;
-    result.reserve(prices.size());
-    
-    for (size_t i = 0; i < prices.size(); ++i) {
-        double min_volume = volume[0];
-        double lvn_price = prices[0];
-        
-        for (size_t j = 0; j <= i; ++j) {
-            if (volume[j] < min_volume) {
-                min_volume = volume[j];
-                lvn_price = prices[j];
-            }
+    return collect(prices.size(), [&](double* out) { return volume_profile_low_volume_node_intraday(prices.data(), volume.data(), prices.size(), out); });
+}
+
+size_t TechnicalIndicators::volume_profile_low_volume_node_intraday(const double* prices, const double* volume, size_t n, double* out) {
+    if (n == 0) return 0;
+    // Running minimum over the prefix, first occurrence wins
+    double min_volume = volume[0];
+    size_t lvn_index = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (volume[i] < min_volume) {
+            min_volume = volume[i];
+            lvn_index = i;
         }
-        result.push_back(lvn_price);
+        out[i] = prices[lvn_index];
     }
-    return result;
+    return n;
 }
 
 std::vector<double> TechnicalIndicators::on_balance_volume_sma_20(const std::vector<double>& prices, const std::vector<double>& volume) {
-    if (prices.size() != volume.size() || prices.size() < 2) return {};
-    
-    std::vector<double> obv;
-    obv.reserve(prices.size());
-    obv.push_back(0.0);
-    
-    for (size_t i = 1; i < prices.size(); ++i) {
-        if (prices[i] > prices[i-1]) obv.push_back(obv.back() + volume[i]);
-        else if (prices[i] < prices[i-1]) obv.push_back(obv.back() - volume[i]);
-        else obv.push_back(obv.back());
+    if (prices.size() != volume.size() || prices.size() < 20) return {};
+    return collect(prices.size() - 19, [&](double* out) { return on_balance_volume_sma_20(prices.data(), volume.data(), prices.size(), out); });
+}
+
+size_t TechnicalIndicators::on_balance_volume_sma_20(const double* prices, const double* volume, size_t n, double* out) {
+    if (n < 20) return 0;
+    thread_local std::vector<double> obv;
+    obv.resize(n);
+    obv[0] = 0.0;
+    for (size_t i = 1; i < n; ++i) {
+        if (prices[i] > prices[i-1]) obv[i] = obv[i-1] + volume[i];
+        else if (prices[i] < prices[i-1]) obv[i] = obv[i-1] - volume[i];
+        else obv[i] = obv[i-1];
     }
-    
-    return simple_moving_average(obv, 20);
+    return simple_moving_average(obv.data(), n, 20, out);
 }
 
 std::vector<double> TechnicalIndicators::klinger_oscillator_34_55(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, const std::vector<double>& volume) {
@@ -693,8 +766,12 @@ std::vector<double> TechnicalIndicators::klinger_oscillator_34_55(const std::vec
 }
 
 std::vector<double> TechnicalIndicators::money_flow_index_14(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, const std::vector<double>& volume) {
-    const int period = 14;
-    if (high.size() != low.size() || high.size() != close.size() || high.size() != volume.size() || high.size() < static_cast<size_t>(period + 1)) return {};
+    if (high.size() != low.size() || high.size() != close.size() || high.size() != volume.size() || high.size() < 15) return {};
+    return collect(high.size() - 14, [&](double* out) { return FixedWindow<14>::money_flow_index(high.data(), low.data(), close.data(), volume.data(), high.size(), out); });
+}
+
+std::vector<double> TechnicalIndicators::money_flow_index(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, const std::vector<double>& volume, int period) {
+    if (period <= 0 || high.size() != low.size() || high.size() != close.size() || high.size() != volume.size() || high.size() < static_cast<size_t>(period + 1)) return {};
     
     std::vector<double> result;
     result.reserve(high.size() - period);
@@ -718,18 +795,23 @@ std::vector<double> TechnicalIndicators::money_flow_index_14(const std::vector<d
 }
 
 std::vector<double> TechnicalIndicators::vwap_deviation_stddev_30(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, const std::vector<double>& volume) {
-    auto vwap = volume_weighted_average_price_intraday(high, low, close, volume);
-    if (vwap.empty() || vwap.size() < 30) return {};
-    
-    std::vector<double> deviations;
-    deviations.reserve(vwap.size());
-    
-    for (size_t i = 0; i < vwap.size(); ++i) {
+    return vwap_deviation_stddev(high, low, close, volume_weighted_average_price_intraday(high, low, close, volume), 30);
+}
+
+std::vector<double> TechnicalIndicators::vwap_deviation_stddev(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, const std::vector<double>& vwap, int window) {
+    if (vwap.empty() || window <= 1 || vwap.size() < static_cast<size_t>(window) || vwap.size() > close.size()) return {};
+    return collect(vwap.size() - window + 1, [&](double* out) { return vwap_deviation_stddev(high.data(), low.data(), close.data(), vwap.data(), vwap.size(), window, out); });
+}
+
+size_t TechnicalIndicators::vwap_deviation_stddev(const double* high, const double* low, const double* close, const double* vwap, size_t n, int window, double* out) {
+    if (window <= 1 || n < static_cast<size_t>(window)) return 0;
+    thread_local std::vector<double> deviations;
+    deviations.resize(n);
+    for (size_t i = 0; i < n; ++i) {
         double typical_price = (high[i] + low[i] + close[i]) / 3.0;
-        deviations.push_back(typical_price - vwap[i]);
+        deviations[i] = typical_price - vwap[i];
     }
-    
-    return calculate_rolling_volatility(deviations, 30);
+    return calculate_rolling_volatility(deviations.data(), n, window, out);
 }
 
 // Cross-Sectional/Relative
@@ -814,39 +896,23 @@ std::vector<double> TechnicalIndicators::pair_spread_vs_competitor_A_30(const st
 
 // Regime Detection
 std::vector<double> TechnicalIndicators::markov_regime_switching_garch_2_state(const std::vector<double>& returns) {
-    if (returns.size() < 50) return {};
-    
-    std::vector<double> result;
-    result.reserve(returns.size());
-    
-    // Simplified regime detection based on volatility
-    auto volatility = calculate_rolling_volatility(returns, 20);
-    if (volatility.empty()) return {};
-    
-    double vol_threshold = 0.0;
-    for (double vol : volatility) vol_threshold += vol;
-    vol_threshold /= volatility.size();
-    
-    for (size_t i = 0; i < volatility.size(); ++i) {
-        result.push_back(volatility[i] > vol_threshold ? 1.0 : 0.0);
-    }
-    
-    // Fill beginning with zeros
-    while (result.size() < returns.size()) {
-        result.insert(result.begin(), 0.0);
-    }
-    
-    return result;
+    if (returns.size() < RegimeModel::kWarmup) return {};
+    const size_t n = returns.size();
+    std::vector<double> probabilities(2 * n);
+    RegimeModel::filter(returns.data(), n, RegimeModel::default_params(returns.data(), n, 2), probabilities.data());
+    return std::vector<double>(probabilities.begin() + n, probabilities.end());
 }
 
 std::vector<double> TechnicalIndicators::adx_rating_14(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close) {
+    if (high.size() != low.size() || high.size() != close.size() || high.size() < 15) return {};
+    return collect(high.size() - 14, [&](double* out) { return adx_rating_14(high.data(), low.data(), close.data(), high.size(), out); });
+}
+
+size_t TechnicalIndicators::adx_rating_14(const double* high, const double* low, const double* close, size_t n, double* out) {
     const int period = 14;
-    if (high.size() != low.size() || high.size() != close.size() || high.size() < static_cast<size_t>(period + 1)) return {};
-    
-    std::vector<double> result;
-    result.reserve(high.size() - period);
+    if (n < static_cast<size_t>(period + 1)) return 0;
     
-    for (size_t i = period; i < high.size(); ++i) {
+    for (size_t i = period; i < n; ++i) {
         double dm_plus_sum = 0.0, dm_minus_sum = 0.0, tr_sum = 0.0;
         
         for (int j = 1; j <= period; ++j) {
@@ -866,21 +932,20 @@ std::vector<double> TechnicalIndicators::adx_rating_14(const std::vector<double>
         
         double di_plus = tr_sum > 0 ? 100.0 * dm_plus_sum / tr_sum : 0.0;
         double di_minus = tr_sum > 0 ? 100.0 * dm_minus_sum / tr_sum : 0.0;
-        double dx = (di_plus + di_minus) > 0 ? 100.0 * std::abs(di_plus - di_minus) / (di_plus + di_minus) : 0.0;
-        
-        result.push_back(dx);
+        out[i - period] = (di_plus + di_minus) > 0 ? 100.0 * std::abs(di_plus - di_minus) / (di_plus + di_minus) : 0.0;
     }
-    return result;
+    return n - period;
 }
 
 std::vector<double> TechnicalIndicators::chow_test_statistic_breakpoint_detection_50(const std::vector<double>& returns) {
+    if (returns.size() < 100) return {};
+    return collect(returns.size() - 99, [&](double* out) { return chow_test_statistic_breakpoint_detection_50(returns.data(), returns.size(), out); });
+}
+
+size_t TechnicalIndicators::chow_test_statistic_breakpoint_detection_50(const double* returns, size_t n, double* out) {
     const int window = 50;
-    if (returns.size() < static_cast<size_t>(window * 2)) return {};
-    
-    std::vector<double> result;
-    result.reserve(returns.size() - window * 2 + 1);
-    
-    for (size_t i = 0; i <= returns.size() - window * 2; ++i) {
+    if (n < static_cast<size_t>(window * 2)) return 0;
+    for (size_t i = 0; i <= n - window * 2; ++i) {
         // Simplified Chow test - compare variance of two halves
         double var1 = 0.0, var2 = 0.0;
         double mean1 = 0.0, mean2 = 0.0;
@@ -899,47 +964,30 @@ std::vector<double> TechnicalIndicators::chow_test_statistic_breakpoint_detectio
         var1 /= (window - 1);
         var2 /= (window - 1);
         
-        double chow_stat = var2 > 0 ? var1 / var2 : 1.0;
-        result.push_back(chow_stat);
+        out[i] = var2 > 0 ? var1 / var2 : 1.0;
     }
-    return result;
+    return n - window * 2 + 1;
 }
 
-std::vector<double> TechnicalIndicators::market_regime_hmm_3_states_price_vol(const std::vector<double>& prices, const std::vector<double>& volatility) {
-    if (prices.size() != volatility.size() || prices.empty()) return {};
-    
-    std::vector<double> result;
-    result.reserve(prices.size());
-    
-    // Simplified 3-state regime detection
-    for (size_t i = 0; i < prices.size(); ++i) {
-        if (i == 0) {
-            result.push_back(1.0); // Default to state 1
-            continue;
-        }
-        
-        double price_change = prices[i] - prices[i-1];
-        double vol = volatility[i];
-        
-        // State classification based on price change and volatility
-        if (price_change > 0 && vol < 0.02) result.push_back(0.0); // Trending up, low vol
-        else if (price_change < 0 && vol < 0.02) result.push_back(1.0); // Trending down, low vol  
-        else result.push_back(2.0); // High volatility state
-    }
-    return result;
+std::vector<double> TechnicalIndicators::market_regime_hmm_3_states_price_vol(const std::vector<double>& returns) {
+    if (returns.size() < RegimeModel::kWarmup) return {};
+    const size_t n = returns.size();
+    std::vector<double> probabilities(3 * n);
+    RegimeModel::filter(returns.data(), n, RegimeModel::default_params(returns.data(), n, 3), probabilities.data());
+    return RegimeModel::most_likely_states(probabilities, 3);
 }
 
 std::vector<double> TechnicalIndicators::high_volatility_indicator_garch_threshold(const std::vector<double>& returns, double threshold) {
-    auto garch_vol = garch_volatility_21(returns);
-    if (garch_vol.empty()) return {};
-    
-    std::vector<double> result;
-    result.reserve(garch_vol.size());
-    
-    for (double vol : garch_vol) {
-        result.push_back(vol > threshold ? 1.0 : 0.0);
-    }
-    return result;
+    return volatility_threshold_indicator(garch_volatility_21(returns), threshold);
+}
+
+std::vector<double> TechnicalIndicators::volatility_threshold_indicator(const std::vector<double>& volatility, double threshold) {
+    return collect(volatility.size(), [&](double* out) { return volatility_threshold_indicator(volatility.data(), volatility.size(), threshold, out); });
+}
+
+size_t TechnicalIndicators::volatility_threshold_indicator(const double* volatility, size_t n, double threshold, double* out) {
+    for (size_t i = 0; i < n; ++i) out[i] = volatility[i] > threshold ? 1.0 : 0.0;
+    return n;
 }
 
 // Market Microstructure
@@ -1067,51 +1115,52 @@ std::vector<double> TechnicalIndicators::quality_factor_beta_120(const std::vect
 
 // Non-Linear/Interaction
 std::vector<double> TechnicalIndicators::return_x_volume_interaction_10(const std::vector<double>& returns, const std::vector<double>& volume) {
-    if (returns.size() != volume.size()) return {};
-    
-    std::vector<double> interaction;
-    interaction.reserve(returns.size());
-    
-    for (size_t i = 0; i < returns.size(); ++i) {
-        interaction.push_back(returns[i] * volume[i]);
-    }
-    
-    return simple_moving_average(interaction, 10);
+    if (returns.size() != volume.size() || returns.size() < 10) return {};
+    return collect(returns.size() - 9, [&](double* out) { return return_x_volume_interaction_10(returns.data(), volume.data(), returns.size(), out); });
+}
+
+size_t TechnicalIndicators::return_x_volume_interaction_10(const double* returns, const double* volume, size_t n, double* out) {
+    if (n < 10) return 0;
+    thread_local std::vector<double> interaction;
+    interaction.resize(n);
+    for (size_t i = 0; i < n; ++i) interaction[i] = returns[i] * volume[i];
+    return simple_moving_average(interaction.data(), n, 10, out);
 }
 
 std::vector<double> TechnicalIndicators::volatility_x_rsi_interaction_14(const std::vector<double>& volatility, const std::vector<double>& rsi) {
     if (volatility.size() != rsi.size()) return {};
-    
-    std::vector<double> result;
-    result.reserve(volatility.size());
-    
-    for (size_t i = 0; i < volatility.size(); ++i) {
-        result.push_back(volatility[i] * rsi[i]);
-    }
-    return result;
+    return collect(volatility.size(), [&](double* out) { return volatility_x_rsi_interaction_14(volatility.data(), rsi.data(), volatility.size(), out); });
+}
+
+size_t TechnicalIndicators::volatility_x_rsi_interaction_14(const double* volatility, const double* rsi, size_t n, double* out) {
+    for (size_t i = 0; i < n; ++i) out[i] = volatility[i] * rsi[i];
+    return n;
 }
 
 std::vector<double> TechnicalIndicators::price_to_kama_ratio_20_10_30(const std::vector<double>& prices) {
-    auto kama_values = kama(prices, 20, 10, 30);
+    return price_to_kama_ratio(prices, kama(prices, 20, 10, 30));
+}
+
+std::vector<double> TechnicalIndicators::price_to_kama_ratio(const std::vector<double>& prices, const std::vector<double>& kama_values) {
     if (kama_values.empty() || kama_values.size() != prices.size()) return {};
-    
-    std::vector<double> result;
-    result.reserve(prices.size());
-    
-    for (size_t i = 0; i < prices.size(); ++i) {
-        double ratio = kama_values[i] > 0 ? prices[i] / kama_values[i] : 1.0;
-        result.push_back(ratio);
+    return collect(prices.size(), [&](double* out) { return price_to_kama_ratio(prices.data(), kama_values.data(), prices.size(), out); });
+}
+
+size_t TechnicalIndicators::price_to_kama_ratio(const double* prices, const double* kama_values, size_t n, double* out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = kama_values[i] > 0 ? prices[i] / kama_values[i] : 1.0;
     }
-    return result;
+    return n;
 }
 
 std::vector<double> TechnicalIndicators::polynomial_regression_price_degree_2_slope(const std::vector<double>& prices, int window) {
     if (prices.size() < static_cast<size_t>(window) || window < 3) return {};
-    
-    std::vector<double> result;
-    result.reserve(prices.size() - window + 1);
-    
-    for (size_t i = 0; i <= prices.size() - window; ++i) {
+    return collect(prices.size() - window + 1, [&](double* out) { return polynomial_regression_price_degree_2_slope(prices.data(), prices.size(), window, out); });
+}
+
+size_t TechnicalIndicators::polynomial_regression_price_degree_2_slope(const double* prices, size_t n, int window, double* out) {
+    if (window < 3 || n < static_cast<size_t>(window)) return 0;
+    for (size_t i = 0; i <= n - window; ++i) {
         // Simplified polynomial regression - use linear slope as approximation
         double sum_x = 0.0, sum_y = 0.0, sum_xy = 0.0, sum_x2 = 0.0;
         
@@ -1126,59 +1175,60 @@ std::vector<double> TechnicalIndicators::polynomial_regression_price_degree_2_sl
         
         double num = window * sum_xy - sum_x * sum_y;
         double den = window * sum_x2 - sum_x * sum_x;
-        double slope = den != 0 ? num / den : 0.0;
-        result.push_back(slope);
+        out[i] = den != 0 ? num / den : 0.0;
     }
-    return result;
+    return n - window + 1;
 }
 
 // Alternative Risk Measures
 std::vector<double> TechnicalIndicators::conditional_value_at_risk_cvar_95_20(const std::vector<double>& returns) {
-    const int window = 20;
-    if (returns.size() < static_cast<size_t>(window)) return {};
-    
-    std::vector<double> result;
-    result.reserve(returns.size() - window + 1);
-    
-    for (size_t i = 0; i <= returns.size() - window; ++i) {
-        std::vector<double> window_returns(returns.begin() + i, returns.begin() + i + window);
-        std::sort(window_returns.begin(), window_returns.end());
-        
-        // 95% CVaR - average of worst 5% returns
-        int tail_size = std::max(1, static_cast<int>(window * 0.05));
-        double cvar = 0.0;
-        for (int j = 0; j < tail_size; ++j) {
-            cvar += window_returns[j];
-        }
-        cvar /= tail_size;
-        result.push_back(cvar);
+    return conditional_value_at_risk(returns, 20, 0.05);
+}
+
+std::vector<double> TechnicalIndicators::conditional_value_at_risk(const std::vector<double>& returns, int window, double tail_fraction) {
+    if (window <= 0 || returns.size() < static_cast<size_t>(window)) return {};
+    return collect(returns.size() - window + 1, [&](double* out) { return conditional_value_at_risk(returns.data(), returns.size(), window, tail_fraction, out); });
+}
+
+size_t TechnicalIndicators::conditional_value_at_risk(const double* returns, size_t n, int window, double tail_fraction, double* out) {
+    if (window <= 0 || n < static_cast<size_t>(window)) return 0;
+    // CVaR - average of the worst tail_fraction of returns in the window
+    const int tail_size = std::max(1, static_cast<int>(window * tail_fraction));
+    size_t count = 0;
+    OrderStatisticWindow order_stats(returns, n);
+    for (size_t i = 0; i < n; ++i) {
+        order_stats.insert(returns[i]);
+        if (i >= static_cast<size_t>(window)) order_stats.erase(returns[i - window]);
+        if (i + 1 < static_cast<size_t>(window)) continue;
+        out[count++] = order_stats.sum_smallest(tail_size) / tail_size;
     }
-    return result;
+    return count;
 }
 
 std::vector<double> TechnicalIndicators::drawdown_duration_from_peak_50(const std::vector<double>& prices) {
+    if (prices.size() < 50) return {};
+    return collect(prices.size() - 49, [&](double* out) { return drawdown_duration_from_peak_50(prices.data(), prices.size(), out); });
+}
+
+size_t TechnicalIndicators::drawdown_duration_from_peak_50(const double* prices, size_t n, double* out) {
     const int window = 50;
-    if (prices.size() < static_cast<size_t>(window)) return {};
-    
-    std::vector<double> result;
-    result.reserve(prices.size() - window + 1);
-    
-    for (size_t i = window - 1; i < prices.size(); ++i) {
-        double peak = *std::max_element(prices.begin() + i - window + 1, prices.begin() + i + 1);
-        int duration = 0;
-        
-        for (int j = 0; j < window; ++j) {
-            if (prices[i - j] >= peak) break;
-            duration++;
-        }
-        result.push_back(static_cast<double>(duration));
+    if (n < static_cast<size_t>(window)) return 0;
+    // Bars since the most recent occurrence of the window peak
+    auto peak_idx = rolling_argmax(prices, n, window);
+    for (size_t k = 0; k < peak_idx.size(); ++k) {
+        size_t i = k + window - 1;
+        out[k] = static_cast<double>(i - peak_idx[k]);
     }
-    return result;
+    return peak_idx.size();
 }
 
 std::vector<double> TechnicalIndicators::ulcer_index_14(const std::vector<double>& prices) {
-    const int period = 14;
-    if (prices.size() < static_cast<size_t>(period)) return {};
+    if (prices.size() < 14) return {};
+    return collect(prices.size() - 13, [&](double* out) { return FixedWindow<14>::ulcer_index(prices.data(), prices.size(), out); });
+}
+
+std::vector<double> TechnicalIndicators::ulcer_index(const std::vector<double>& prices, int period) {
+    if (period <= 0 || prices.size() < static_cast<size_t>(period)) return {};
     
     std::vector<double> result;
     result.reserve(prices.size() - period + 1);
@@ -1199,33 +1249,95 @@ std::vector<double> TechnicalIndicators::ulcer_index_14(const std::vector<double
 }
 
 std::vector<double> TechnicalIndicators::sortino_ratio_30(const std::vector<double>& returns) {
-    const int window = 30;
-    if (returns.size() < static_cast<size_t>(window)) return {};
+    if (returns.size() < 30) return {};
+    return collect(returns.size() - 29, [&](double* out) { return FixedWindow<30>::sortino_ratio(returns.data(), returns.size(), out); });
+}
+
+std::vector<double> TechnicalIndicators::sortino_ratio(const std::vector<double>& returns, int window) {
+    if (window <= 0 || returns.size() < static_cast<size_t>(window)) return {};
     
     std::vector<double> result;
     result.reserve(returns.size() - window + 1);
     
-    for (size_t i = 0; i <= returns.size() - window; ++i) {
-        double sum = 0.0;
-        for (int j = 0; j < window; ++j) sum += returns[i + j];
-        double mean_return = sum / window;
-        
-        double downside_variance = 0.0;
-        int downside_count = 0;
-        for (int j = 0; j < window; ++j) {
-            if (returns[i + j] < 0) {
-                downside_variance += returns[i + j] * returns[i + j];
-                downside_count++;
+    // Running window sum plus downside sum of squares / count, all O(1) per bar
+    CompensatedSum sum, downside_variance;
+    int downside_count = 0;
+    for (size_t i = 0; i < returns.size(); ++i) {
+        sum.add(returns[i]);
+        if (returns[i] < 0) {
+            downside_variance.add(returns[i] * returns[i]);
+            downside_count++;
+        }
+        if (i >= static_cast<size_t>(window)) {
+            double evicted = returns[i - window];
+            sum.add(-evicted);
+            if (evicted < 0) {
+                downside_variance.add(-evicted * evicted);
+                downside_count--;
             }
         }
+        if (i + 1 < static_cast<size_t>(window)) continue;
         
-        double downside_deviation = downside_count > 0 ? std::sqrt(downside_variance / downside_count) : 0.0;
+        double mean_return = sum.value() / window;
+        double downside_deviation = downside_count > 0 ? std::sqrt(std::max(0.0, downside_variance.value()) / downside_count) : 0.0;
         double sortino = downside_deviation > 0 ? mean_return / downside_deviation : 0.0;
         result.push_back(sortino);
     }
     return result;
 }
 
+// Rolling extremum primitives (monotonic deque, amortized O(1) per bar)
+namespace {
+template <typename Compare>
+std::vector<size_t> rolling_arg_extreme(const double* data, size_t n, int window, Compare better_or_equal) {
+    if (window <= 0 || n < static_cast<size_t>(window)) return {};
+    std::vector<size_t> result;
+    result.reserve(n - window + 1);
+    
+    // Indices with strictly worsening values; the front is the window extreme.
+    // Popping on ties keeps the most recent occurrence of the extreme.
+    std::vector<size_t> deque(n);
+    size_t head = 0, tail = 0;
+    for (size_t i = 0; i < n; ++i) {
+        while (tail > head && better_or_equal(data[i], data[deque[tail - 1]])) --tail;
+        deque[tail++] = i;
+        if (deque[head] + window <= i) ++head;
+        if (i + 1 >= static_cast<size_t>(window)) result.push_back(deque[head]);
+    }
+    return result;
+}
+}
+
+std::vector<size_t> TechnicalIndicators::rolling_argmax(const std::vector<double>& data, int window) {
+    return rolling_argmax(data.data(), data.size(), window);
+}
+
+std::vector<size_t> TechnicalIndicators::rolling_argmin(const std::vector<double>& data, int window) {
+    return rolling_argmin(data.data(), data.size(), window);
+}
+
+std::vector<size_t> TechnicalIndicators::rolling_argmax(const double* data, size_t n, int window) {
+    return rolling_arg_extreme(data, n, window, [](double a, double b) { return a >= b; });
+}
+
+std::vector<size_t> TechnicalIndicators::rolling_argmin(const double* data, size_t n, int window) {
+    return rolling_arg_extreme(data, n, window, [](double a, double b) { return a <= b; });
+}
+
+std::vector<double> TechnicalIndicators::rolling_max(const std::vector<double>& data, int window) {
+    auto idx = rolling_argmax(data, window);
+    std::vector<double> result(idx.size());
+    for (size_t k = 0; k < idx.size(); ++k) result[k] = data[idx[k]];
+    return result;
+}
+
+std::vector<double> TechnicalIndicators::rolling_min(const std::vector<double>& data, int window) {
+    auto idx = rolling_argmin(data, window);
+    std::vector<double> result(idx.size());
+    for (size_t k = 0; k < idx.size(); ++k) result[k] = data[idx[k]];
+    return result;
+}
+
 // Private helper functions
 double TechnicalIndicators::calculate_atr(const std::vector<double>& high, const std::vector<double>& low, const std::vector<double>& close, int period, size_t index) {
     if (index < static_cast<size_t>(period)) return 0.0;
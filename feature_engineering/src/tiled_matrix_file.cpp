@@ -0,0 +1,74 @@
+#include "tiled_matrix_format.h"
+#include <cstring>
+#include <stdexcept>
+
+TiledMatrixFile::TiledMatrixFile(const std::string& filepath)
+    : file_(filepath),
+      data_(reinterpret_cast<const uint8_t*>(file_.data())) {
+    auto fail = [&](const char* what) {
+        throw std::runtime_error(std::string("Invalid matrix file (") + what + "): " + filepath);
+    };
+
+    const size_t file_size = file_.size();
+    if (file_size < sizeof(TiledMatrixHeader)) fail("truncated header");
+    const auto* header = reinterpret_cast<const TiledMatrixHeader*>(data_);
+    if (std::memcmp(header->magic, kTiledMatrixMagic, sizeof(kTiledMatrixMagic)) != 0) fail("bad magic");
+    if (header->version != kTiledMatrixVersion) fail("unsupported version");
+    if (header->tile == 0 || header->tile % 16 != 0 || header->size == 0 ||
+        header->level_count != tiled_matrix_levels(header->size, header->tile)) {
+        fail("bad geometry");
+    }
+
+    size_ = header->size;
+    tile_ = header->tile;
+    levels_ = header->level_count;
+    if (header->names_offset > file_size || header->names_bytes > file_size - header->names_offset ||
+        header->layers_offset > file_size ||
+        header->layer_count > (file_size - header->layers_offset) / sizeof(TiledMatrixLayer) ||
+        header->layers_offset % alignof(TiledMatrixLayer) != 0) {
+        fail("bad offsets");
+    }
+
+    // Symbols point into the name block, which must end in a NUL
+    const char* names = reinterpret_cast<const char*>(data_ + header->names_offset);
+    const char* names_end = names + header->names_bytes;
+    if (header->names_bytes == 0 || names_end[-1] != '\0') fail("bad names");
+    symbols_.reserve(size_);
+    for (const char* name = names; symbols_.size() < size_; name += std::strlen(name) + 1) {
+        if (name >= names_end) fail("too few names");
+        symbols_.push_back(name);
+    }
+
+    level_offsets_.resize(levels_);
+    size_t offset = 0;
+    for (uint32_t level = 0; level < levels_; ++level) {
+        level_offsets_[level] = offset;
+        offset += tiles(level) * tiles(level) * tile_ * tile_ * sizeof(float);
+    }
+    const auto* layers = reinterpret_cast<const TiledMatrixLayer*>(data_ + header->layers_offset);
+    for (uint32_t i = 0; i < header->layer_count; ++i) {
+        const TiledMatrixLayer& layer = layers[i];
+        if (layer.data_offset % sizeof(float) != 0 || layer.data_offset > file_size ||
+            offset > file_size - layer.data_offset ||
+            std::memchr(layer.name, '\0', sizeof(layer.name)) == nullptr) {
+            fail("bad layer");
+        }
+        layers_.push_back(&layer);
+    }
+}
+
+const float* TiledMatrixFile::tile_data(size_t layer, uint32_t level, size_t row, size_t col) const {
+    const size_t index = row * tiles(level) + col;
+    return reinterpret_cast<const float*>(data_ + layers_[layer]->data_offset + level_offsets_[level]) +
+           index * tile_ * tile_;
+}
+
+float TiledMatrixFile::value(size_t layer, uint32_t level, size_t row, size_t col) const {
+    const float* cells = tile_data(layer, level, row / tile_, col / tile_);
+    return cells[(row % tile_) * tile_ + col % tile_];
+}
+
+bool TiledMatrixFile::is_matrix_path(const std::string& filepath) {
+    const size_t n = std::strlen(kTiledMatrixExtension);
+    return filepath.size() >= n && filepath.compare(filepath.size() - n, n, kTiledMatrixExtension) == 0;
+}
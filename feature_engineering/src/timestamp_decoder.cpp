@@ -0,0 +1,111 @@
+#include "timestamp_decoder.h"
+#include "civil_time.h"
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline int two_digits(const char* p) {
+    return (p[0] - '0') * 10 + (p[1] - '0');
+}
+
+// "YYYY-MM-DD" with every digit in place
+inline bool is_date_layout(const char* p) {
+    return is_digit(p[0]) && is_digit(p[1]) && is_digit(p[2]) && is_digit(p[3]) && p[4] == '-' &&
+           is_digit(p[5]) && is_digit(p[6]) && p[7] == '-' && is_digit(p[8]) && is_digit(p[9]);
+}
+
+// " HH:MM:SS" following the date
+inline bool is_time_layout(const char* p) {
+    return p[0] == ' ' && is_digit(p[1]) && is_digit(p[2]) && p[3] == ':' && is_digit(p[4]) &&
+           is_digit(p[5]) && p[6] == ':' && is_digit(p[7]) && is_digit(p[8]);
+}
+
+int64_t local_to_time_t(int year, int month, int day, int hour, int minute, int second) {
+    std::tm tm = {};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
+    tm.tm_hour = hour;
+    tm.tm_min = minute;
+    tm.tm_sec = second;
+    return static_cast<int64_t>(std::mktime(&tm));
+}
+}
+
+bool TimestampDecoder::set_date(const char* text) {
+    if (has_date_ && std::memcmp(cached_date_, text, sizeof(cached_date_)) == 0) return true;
+
+    const int year = two_digits(text) * 100 + two_digits(text + 2);
+    const int month = two_digits(text + 5);
+    const int day = two_digits(text + 8);
+    // Ranges std::get_time accepts; anything else takes the slow path
+    if (month < 1 || month > 12 || day < 1 || day > 31) return false;
+
+    std::memcpy(cached_date_, text, sizeof(cached_date_));
+    has_date_ = true;
+    year_ = year;
+    month_ = month;
+    day_ = day;
+    days_ = days_from_civil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+
+    // Offset of the month the date falls in once normalized (mktime rolls Feb 31 into March)
+    const CivilDate normalized = civil_from_days(days_);
+    const int64_t month_key = normalized.year * 12 + normalized.month;
+    if (month_key != offset_month_) {
+        offset_month_ = month_key;
+        const int64_t first = days_from_civil(normalized.year, normalized.month, 1);
+        const int64_t next = normalized.month == 12 ? days_from_civil(normalized.year + 1, 1, 1)
+                                                   : days_from_civil(normalized.year, normalized.month + 1, 1);
+        const CivilDate last = civil_from_days(next - 1);
+        const int64_t start = local_to_time_t(static_cast<int>(normalized.year), normalized.month, 1, 0, 0, 0);
+        const int64_t end = local_to_time_t(static_cast<int>(last.year), last.month, last.day, 23, 59, 59);
+        offset_ = first * 86400 - start;
+        linear_month_ = (next * 86400 - 1) - end == offset_;
+    }
+    return true;
+}
+
+int64_t TimestampDecoder::to_time_t(int hour, int minute, int second) const {
+    if (linear_month_) return days_ * 86400 + hour * 3600 + minute * 60 + second - offset_;
+    return local_to_time_t(year_, month_, day_, hour, minute, second);
+}
+
+TimestampDecoder::time_point TimestampDecoder::decode(const char* text, size_t length) {
+    const bool date_only = length == 10;
+    if ((date_only || length >= 19) && is_date_layout(text) &&
+        (date_only || is_time_layout(text + 10)) && set_date(text)) {
+        if (date_only) return std::chrono::system_clock::from_time_t(static_cast<time_t>(to_time_t(0, 0, 0)));
+
+        const int hour = two_digits(text + 11);
+        const int minute = two_digits(text + 14);
+        const int second = two_digits(text + 17);
+        if (hour <= 23 && minute <= 59 && second <= 60) {
+            return std::chrono::system_clock::from_time_t(static_cast<time_t>(to_time_t(hour, minute, second)));
+        }
+    }
+    return decode_slow(std::string(text, length));
+}
+
+void TimestampDecoder::decode_column(const std::vector<std::string_view>& fields, std::vector<time_point>& out) {
+    out.reserve(out.size() + fields.size());
+    for (const auto& field : fields) out.push_back(decode(field.data(), field.size()));
+}
+
+TimestampDecoder::time_point TimestampDecoder::decode_slow(const std::string& text) {
+    std::tm tm = {};
+    std::istringstream ss(text);
+    ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+    if (ss.fail()) {
+        ss.clear();
+        ss.str(text);
+        ss >> std::get_time(&tm, "%Y-%m-%d");
+        if (ss.fail()) return (std::chrono::system_clock::time_point::min)();
+    }
+    return std::chrono::system_clock::from_time_t(std::mktime(&tm));
+}
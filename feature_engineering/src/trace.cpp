@@ -0,0 +1,257 @@
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    int64_t arg;
+};
+
+// Up to kMaxChunks * kChunkEvents spans per thread; later ones are counted
+// as dropped. The chunk table never moves, so the exporter can read the
+// published prefix while the owner keeps appending.
+constexpr size_t kChunkEvents = 16384;
+constexpr size_t kMaxChunks = 256;
+
+struct ThreadBuffer {
+    uint32_t tid = 0;
+    std::string name;
+    std::unique_ptr<TraceEvent[]> chunks[kMaxChunks];
+    std::atomic<size_t> count{0};
+    size_t dropped = 0;
+
+    void append(const TraceEvent& event) {
+        const size_t n = count.load(std::memory_order_relaxed);
+        const size_t chunk = n / kChunkEvents;
+        if (chunk >= kMaxChunks) {
+            ++dropped;
+            return;
+        }
+        if (!chunks[chunk]) chunks[chunk].reset(new TraceEvent[kChunkEvents]);
+        chunks[chunk][n % kChunkEvents] = event;
+        count.store(n + 1, std::memory_order_release);
+    }
+
+    template <class Visit>
+    void for_each(Visit visit) const {
+        const size_t n = count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < n; ++i) visit(chunks[i / kChunkEvents][i % kChunkEvents]);
+    }
+};
+
+std::atomic<bool> tracing{false};
+
+// Counter samples are few (a handful per stage), so they share one list
+struct CounterSample {
+    const char* name;
+    uint64_t ts_ns;
+    std::vector<std::pair<const char*, double>> values;
+};
+
+struct Registry {
+    std::mutex mutex;                                   // registration, counters and export only
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::vector<CounterSample> counters;
+    std::atomic<uint64_t> generation{1};
+    std::atomic<uint64_t> origin_ns{0};
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+uint64_t steady_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// The calling thread's buffer, registered on first use after each reset
+ThreadBuffer& local_buffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    thread_local uint64_t generation = 0;
+    Registry& r = registry();
+    const uint64_t current = r.generation.load(std::memory_order_acquire);
+    if (!buffer || generation != current) {
+        auto fresh = std::make_shared<ThreadBuffer>();
+        if (buffer) fresh->name = buffer->name;
+        std::lock_guard<std::mutex> lock(r.mutex);
+        fresh->tid = static_cast<uint32_t>(r.buffers.size() + 1);
+        r.buffers.push_back(fresh);
+        buffer = std::move(fresh);
+        generation = current;
+    }
+    return *buffer;
+}
+
+std::vector<std::shared_ptr<ThreadBuffer>> snapshot_buffers() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return r.buffers;
+}
+
+std::string json_escape(const char* text) {
+    std::string out;
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') out += '\\';
+        if (static_cast<unsigned char>(*c) < 0x20) continue;
+        out += *c;
+    }
+    return out;
+}
+
+}
+
+void set_tracing(bool enabled) {
+    if (enabled && registry().origin_ns.load() == 0) registry().origin_ns = steady_ns();
+    tracing.store(enabled, std::memory_order_relaxed);
+}
+
+bool tracing_enabled() {
+    return tracing.load(std::memory_order_relaxed);
+}
+
+uint64_t trace_now_ns() {
+    return steady_ns();
+}
+
+void trace_record(const char* name, const char* category, uint64_t start_ns, uint64_t end_ns, int64_t arg) {
+    if (!tracing_enabled()) return;
+    local_buffer().append({name, category, start_ns, end_ns, arg});
+}
+
+void trace_counter(const char* name, const std::vector<std::pair<const char*, double>>& values) {
+    if (!tracing_enabled()) return;
+    Registry& r = registry();
+    const uint64_t now = steady_ns();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.counters.push_back({name, now, values});
+}
+
+void set_trace_thread_name(const std::string& name) {
+    if (!tracing_enabled()) return;
+    // Written before the thread's first exported span; read at export
+    local_buffer().name = name;
+}
+
+std::vector<TraceLatency> trace_latencies() {
+    std::map<std::pair<std::string, std::string>, std::vector<uint64_t>> durations;
+    for (const auto& buffer : snapshot_buffers()) {
+        buffer->for_each([&](const TraceEvent& e) {
+            durations[{e.category, e.name}].push_back(e.end_ns > e.start_ns ? e.end_ns - e.start_ns : 0);
+        });
+    }
+
+    std::vector<TraceLatency> latencies;
+    for (auto& [key, values] : durations) {
+        TraceLatency l;
+        l.category = key.first;
+        l.name = key.second;
+        l.count = values.size();
+        std::sort(values.begin(), values.end());
+        uint64_t total = 0;
+        for (uint64_t ns : values) {
+            total += ns;
+            size_t bucket = 0;
+            for (uint64_t us = ns / 1000; us > 1; us >>= 1) ++bucket;
+            if (l.buckets.size() <= bucket) l.buckets.resize(bucket + 1, 0);
+            ++l.buckets[bucket];
+        }
+        auto percentile = [&values](double q) {
+            const size_t index = std::min(values.size() - 1, static_cast<size_t>(q * values.size()));
+            return values[index] / 1000.0;
+        };
+        l.total_ms = total / 1e6;
+        l.p50_us = percentile(0.50);
+        l.p90_us = percentile(0.90);
+        l.p99_us = percentile(0.99);
+        l.max_us = values.back() / 1000.0;
+        latencies.push_back(std::move(l));
+    }
+    std::sort(latencies.begin(), latencies.end(),
+              [](const TraceLatency& a, const TraceLatency& b) { return a.total_ms > b.total_ms; });
+    return latencies;
+}
+
+void print_trace_latencies(const char* title) {
+    std::cout << title << " Trace Latencies:" << std::endl;
+    const auto latencies = trace_latencies();
+    if (latencies.empty()) {
+        std::cout << "  - none recorded" << std::endl;
+        return;
+    }
+    for (const auto& l : latencies) {
+        std::cout << "  - " << l.category << "/" << l.name << ": " << l.count << "x, " << std::fixed
+                  << std::setprecision(1) << l.total_ms << " ms total, p50 " << l.p50_us << " us, p90 "
+                  << l.p90_us << " us, p99 " << l.p99_us << " us, max " << l.max_us << " us" << std::endl;
+    }
+    size_t dropped = 0;
+    for (const auto& buffer : snapshot_buffers()) dropped += buffer->dropped;
+    if (dropped > 0) std::cout << "  - " << dropped << " spans dropped (per-thread buffers full)" << std::endl;
+}
+
+void write_chrome_trace(const std::string& path) {
+    std::ofstream file(path);
+    if (!file.is_open()) throw std::runtime_error("Cannot create file: " + path);
+    const uint64_t origin = registry().origin_ns.load();
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    auto separator = [&]() -> const char* {
+        const char* s = first ? "\n" : ",\n";
+        first = false;
+        return s;
+    };
+    for (const auto& buffer : snapshot_buffers()) {
+        const std::string name = buffer->name.empty() ? "thread " + std::to_string(buffer->tid) : buffer->name;
+        file << separator() << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->tid
+             << ", \"args\": {\"name\": \"" << json_escape(name.c_str()) << "\"}}";
+        buffer->for_each([&](const TraceEvent& e) {
+            const uint64_t start = e.start_ns > origin ? e.start_ns - origin : 0;
+            const uint64_t duration = e.end_ns > e.start_ns ? e.end_ns - e.start_ns : 0;
+            file << separator() << "{\"name\": \"" << json_escape(e.name) << "\", \"cat\": \""
+                 << json_escape(e.category) << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->tid
+                 << ", \"ts\": " << start / 1000.0 << ", \"dur\": " << duration / 1000.0;
+            if (e.arg >= 0) file << ", \"args\": {\"n\": " << e.arg << "}";
+            file << "}";
+        });
+    }
+    std::vector<CounterSample> counters;
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        counters = registry().counters;
+    }
+    for (const auto& sample : counters) {
+        const uint64_t start = sample.ts_ns > origin ? sample.ts_ns - origin : 0;
+        file << separator() << "{\"name\": \"" << json_escape(sample.name) << "\", \"ph\": \"C\", \"pid\": 1, \"ts\": "
+             << start / 1000.0 << ", \"args\": {";
+        for (size_t k = 0; k < sample.values.size(); ++k) {
+            file << (k ? ", " : "") << "\"" << json_escape(sample.values[k].first) << "\": " << sample.values[k].second;
+        }
+        file << "}}";
+    }
+    file << "\n]}\n";
+    if (!file) throw std::runtime_error("Error writing trace: " + path);
+}
+
+void reset_trace() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.buffers.clear();
+    r.counters.clear();
+    r.generation.fetch_add(1, std::memory_order_acq_rel);
+    r.origin_ns = steady_ns();
+}
@@ -0,0 +1,170 @@
+#include "window_sweep.h"
+#include "simd_dispatch.h"
+#include "technical_indicators.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Output rows per block: with the lookback of windows up to a few hundred
+// bars, the three prefix arrays and the row scratch stay within L2
+constexpr size_t kBlockRows = 1024;
+
+// Where one window's statistics of a series go; null when not selected
+struct WindowTargets {
+    size_t window = 0;
+    double* mean = nullptr;
+    double* stddev = nullptr;
+    double* zscore = nullptr;
+    double* slope = nullptr;
+};
+
+struct SweepScratch {
+    std::vector<double> returns;
+    std::vector<double> sum, sum_sq, sum_tx;
+    std::vector<size_t> run;            // equal values ending at each position of the span
+    std::vector<double> mean, var;
+};
+
+// Fills every target over x[0, n); windows ascend
+void sweep_series(const double* x, size_t n, const std::vector<WindowTargets>& targets, SweepScratch& scratch) {
+    size_t longest = 0;
+    bool need_var = false, need_slope = false;
+    for (const auto& target : targets) {
+        if (target.window > n) continue;
+        longest = std::max(longest, target.window);
+        need_var = need_var || target.stddev || target.zscore;
+        need_slope = need_slope || target.slope;
+    }
+    if (longest == 0) return;
+
+    const SimdKernels& kernels = simd_kernels();
+    const size_t capacity = kBlockRows + longest;
+    scratch.sum.resize(capacity + 1);
+    if (need_var) {
+        scratch.sum_sq.resize(capacity + 1);
+        scratch.run.resize(capacity);
+    }
+    if (need_slope) scratch.sum_tx.resize(capacity + 1);
+    scratch.mean.resize(kBlockRows);
+    scratch.var.resize(kBlockRows);
+
+    // Blocks of window end positions [begin, end), spanning x[base, end)
+    for (size_t begin = targets.front().window - 1; begin < n; begin += kBlockRows) {
+        const size_t end = std::min(n, begin + kBlockRows);
+        const size_t base = begin + 1 >= longest ? begin + 1 - longest : 0;
+        const size_t span = end - base;
+        const double shift = x[base];
+
+        double s = 0.0, q = 0.0, t = 0.0;
+        scratch.sum[0] = 0.0;
+        if (need_var) scratch.sum_sq[0] = 0.0;
+        if (need_slope) scratch.sum_tx[0] = 0.0;
+        for (size_t j = 0; j < span; ++j) {
+            const double v = x[base + j] - shift;
+            s += v;
+            scratch.sum[j + 1] = s;
+            if (need_var) {
+                q += v * v;
+                scratch.sum_sq[j + 1] = q;
+                scratch.run[j] = j > 0 && x[base + j] == x[base + j - 1] ? scratch.run[j - 1] + 1 : 1;
+            }
+            if (need_slope) {
+                t += static_cast<double>(j) * v;
+                scratch.sum_tx[j + 1] = t;
+            }
+        }
+
+        for (const auto& target : targets) {
+            const size_t w = target.window;
+            if (w > n) break;
+            const size_t first_end = std::max(begin, w - 1);
+            if (first_end >= end) continue;
+            const size_t rows = end - first_end;
+            const size_t out = first_end + 1 - w;       // output row of the first window
+            const bool stats = target.stddev || target.zscore;
+            kernels.prefix_window_stats(scratch.sum.data(), need_var ? scratch.sum_sq.data() : nullptr,
+                                        need_slope ? scratch.sum_tx.data() : nullptr, out - base, rows, w,
+                                        scratch.mean.data(), stats ? scratch.var.data() : nullptr,
+                                        target.slope ? target.slope + out : nullptr);
+            if (target.mean) {
+                for (size_t r = 0; r < rows; ++r) target.mean[out + r] = scratch.mean[r] + shift;
+            }
+            if (!stats) continue;
+            for (size_t r = 0; r < rows; ++r) {
+                const size_t last = first_end + r;
+                const double sd = scratch.run[last - base] >= w ? 0.0 : std::sqrt(std::max(0.0, scratch.var[r]));
+                if (target.stddev) target.stddev[out + r] = sd;
+                if (target.zscore) {
+                    target.zscore[out + r] = sd > 0 ? (x[last] - shift - scratch.mean[r]) / sd : 0.0;
+                }
+            }
+        }
+    }
+}
+
+}
+
+std::string WindowSweep::Column::name() const {
+    return std::string(sweep_indicator_name(indicator)) + "_" + std::to_string(window);
+}
+
+void WindowSweep::compute(const std::vector<double>& close, const WindowSweepSelection& selection,
+                          std::vector<Column>& columns) {
+    const std::vector<size_t>& windows = selection.windows;
+    const size_t n = close.size();
+    size_t count = 0;
+    for (size_t i = 0; i < kSweepIndicatorCount; ++i) {
+        if (selection.indicators.test(i)) count += windows.size();
+    }
+    columns.resize(count);
+
+    thread_local SweepScratch scratch;
+    scratch.returns.resize(n > 0 ? n - 1 : 0);
+    TechnicalIndicators::calculate_returns(close.data(), n, scratch.returns.data());
+
+    std::vector<WindowTargets> on_close(windows.size()), on_returns(windows.size());
+    size_t c = 0;
+    for (size_t i = 0; i < kSweepIndicatorCount; ++i) {
+        if (!selection.indicators.test(i)) continue;
+        const auto indicator = static_cast<SweepIndicator>(i);
+        const bool returns = sweep_on_returns(indicator);
+        const size_t length = returns ? scratch.returns.size() : n;
+        for (size_t k = 0; k < windows.size(); ++k, ++c) {
+            Column& column = columns[c];
+            column.indicator = indicator;
+            column.window = windows[k];
+            // Returns start on the second row
+            column.offset = windows[k] - 1 + (returns ? 1 : 0);
+            column.values.assign(length >= windows[k] ? length - windows[k] + 1 : 0, 0.0);
+
+            WindowTargets& target = returns ? on_returns[k] : on_close[k];
+            target.window = windows[k];
+            double* values = column.values.empty() ? nullptr : column.values.data();
+            switch (indicator) {
+                case SweepIndicator::sma: target.mean = values; break;
+                case SweepIndicator::volatility: target.stddev = values; break;
+                case SweepIndicator::z_score: target.zscore = values; break;
+                case SweepIndicator::linear_slope: target.slope = values; break;
+                case SweepIndicator::Count: break;
+            }
+        }
+    }
+
+    if (windows.empty()) return;
+    auto selected = [](const std::vector<WindowTargets>& targets) {
+        for (const auto& target : targets) {
+            if (target.mean || target.stddev || target.zscore || target.slope) return true;
+        }
+        return false;
+    };
+    if (selected(on_close)) sweep_series(close.data(), n, on_close, scratch);
+    if (selected(on_returns)) sweep_series(scratch.returns.data(), scratch.returns.size(), on_returns, scratch);
+}
+
+std::vector<WindowSweep::Column> WindowSweep::compute(const std::vector<double>& close,
+                                                      const WindowSweepSelection& selection) {
+    std::vector<Column> columns;
+    compute(close, selection, columns);
+    return columns;
+}
@@ -0,0 +1,147 @@
+#include "work_stealing_pool.h"
+#include "numa_topology.h"
+#include "trace.h"
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <iostream>
+#include <iomanip>
+
+size_t PoolStats::total_tasks() const {
+    size_t total = 0;
+    for (const auto& w : workers) total += w.tasks;
+    return total;
+}
+
+size_t PoolStats::total_steals() const {
+    size_t total = 0;
+    for (const auto& w : workers) total += w.steals;
+    return total;
+}
+
+double PoolStats::utilization() const {
+    if (workers.empty() || wall_ms <= 0.0) return 0.0;
+    double busy = 0.0;
+    for (const auto& w : workers) busy += w.busy_ms;
+    return std::min(1.0, busy / (wall_ms * workers.size()));
+}
+
+double PoolStats::imbalance() const {
+    if (workers.empty()) return 1.0;
+    double busy = 0.0, max_busy = 0.0;
+    for (const auto& w : workers) {
+        busy += w.busy_ms;
+        max_busy = std::max(max_busy, w.busy_ms);
+    }
+    double mean = busy / workers.size();
+    return mean > 0.0 ? max_busy / mean : 1.0;
+}
+
+WorkStealingPool::WorkStealingPool(unsigned num_threads)
+    : num_threads_(std::max(1u, num_threads)), queues_(num_threads_) {}
+
+bool WorkStealingPool::pop_local(WorkerQueue& queue, size_t& task) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = queue.tasks.front();
+    queue.tasks.pop_front();
+    return true;
+}
+
+unsigned WorkStealingPool::node_of(unsigned worker) const {
+    return numa_placement_active() ? numa_node_of_worker(worker, num_threads_) : 0;
+}
+
+bool WorkStealingPool::steal(unsigned thief, size_t& task) {
+    // Same-node victims first, so stolen work stays near its data
+    const unsigned home = node_of(thief);
+    for (int pass = 0; pass < 2; ++pass) {
+        for (unsigned k = 1; k < num_threads_; ++k) {
+            const unsigned candidate = (thief + k) % num_threads_;
+            if ((node_of(candidate) == home) != (pass == 0)) continue;
+            WorkerQueue& victim = queues_[candidate];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.tasks.empty()) continue;
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+PoolStats WorkStealingPool::run(const std::vector<size_t>& costs, const Task& task) {
+    // Largest tasks first so the long ones start early and the tail is short
+    std::vector<size_t> order(costs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return costs[a] > costs[b]; });
+
+    for (auto& queue : queues_) queue.tasks.clear();
+    for (size_t i = 0; i < order.size(); ++i) {
+        queues_[i % num_threads_].tasks.push_back(order[i]);
+    }
+
+    PoolStats stats;
+    stats.workers.resize(num_threads_);
+    std::atomic<size_t> remaining{order.size()};
+
+    auto start = std::chrono::high_resolution_clock::now();
+    const bool pinned = numa_placement_active();
+    auto worker_loop = [&](unsigned worker) {
+        if (pinned) pin_thread_to_node(node_of(worker));
+        WorkerStats& ws = stats.workers[worker];
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            size_t index;
+            bool stolen = false;
+            if (!pop_local(queues_[worker], index)) {
+                if (!steal(worker, index)) break;  // every queue is empty
+                stolen = true;
+            }
+            auto t0 = std::chrono::high_resolution_clock::now();
+            {
+                TraceSpan span(trace_label_, "task", static_cast<int64_t>(index));
+                task(index, worker);
+            }
+            auto t1 = std::chrono::high_resolution_clock::now();
+
+            ws.busy_ms += std::chrono::duration<double, std::milli>(t1 - t0).count();
+            ++ws.tasks;
+            if (stolen) ++ws.steals;
+            remaining.fetch_sub(1, std::memory_order_release);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads_ - 1);
+    for (unsigned t = 1; t < num_threads_; ++t) {
+        threads.emplace_back([&worker_loop](unsigned worker) {
+            set_trace_thread_name("pool worker " + std::to_string(worker));
+            worker_loop(worker);
+        }, t);
+    }
+    {
+        // The caller runs as worker 0 and gets its own affinity back
+        std::optional<ThreadAffinityGuard> caller_affinity;
+        if (pinned) caller_affinity.emplace();
+        worker_loop(0);
+    }
+    for (auto& thread : threads) thread.join();
+
+    stats.wall_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    return stats;
+}
+
+void print_pool_stats(const char* phase, const PoolStats& stats) {
+    std::cout << phase << " Scheduling:" << std::endl;
+    std::cout << "  - Tasks: " << stats.total_tasks() << " on " << stats.workers.size()
+              << " workers (" << stats.total_steals() << " stolen)" << std::endl;
+    std::cout << "  - Utilization: " << std::fixed << std::setprecision(1)
+              << stats.utilization() * 100.0 << "%" << std::endl;
+    std::cout << "  - Load Imbalance (max/mean busy): " << std::fixed << std::setprecision(2)
+              << stats.imbalance() << std::endl;
+}
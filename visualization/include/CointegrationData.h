@@ -1,4 +1,5 @@
 #pragma once
+#include <cmath>
 #include <string>
 
 struct CointegrationData {
@@ -36,7 +37,7 @@ struct CointegrationData {
     }
     
     bool isOutlier() const {
-        return abs(z_score) > 2.5 || sharpe_ratio > 2.0 || win_rate > 0.8;
+        return std::abs(z_score) > 2.5 || sharpe_ratio > 2.0 || win_rate > 0.8;
     }
     
     std::string getPairName() const {
@@ -1,26 +1,39 @@
 #pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
-#include <map>
+#include <thread>
 #include "CointegrationData.h"
+#include "MatrixHeatmap.h"
+#include "PairTable.h"
 
 class CointegrationVisualizer {
 private:
-    std::vector<CointegrationData> pairsData;
+    PairTable pairs;
     bool dataLoaded = false;
-    bool isLoading = false;
+    std::atomic<bool> isLoading{false};
     std::string loadingStatus = "";
-    
+
+    // Background loader; renderUI() takes its table once it is done
+    std::thread loader;
+    std::mutex loaderMutex;                 // guards the two members below
+    std::unique_ptr<PairTable> loadedPairs;
+    std::string loaderStatus;
+
     // UI state
-    int selectedPair = 0;
-    bool showOnlyCointegrated = false;
-    bool showOnlyHighQuality = false;
-    bool showOnlyOutliers = false;
-    std::string gradeFilter = "All";
-    float minSharpeRatio = 0.0f;
-    float maxHalfLife = 1000.0f;
-    
-    // Chart data vectors for ImPlot
+    int selectedPair = -1;                  // row of pairs, -1 for none
+    PairFilter filters;
+    PairTable::SortKey sortKey = PairTable::SortSharpe;
+    bool sortDescending = true;
+
+    // Rows passing the filters in sort order, rebuilt by applyFilters()
+    // only when the filters or the sort change
+    std::vector<uint32_t> visibleRows;
+    PairFilter appliedFilters;
+
+    // Chart data vectors for ImPlot, gathered from visibleRows
     std::vector<float> adf_stats;
     std::vector<float> p_values;
     std::vector<float> half_lives;
@@ -28,8 +41,7 @@ private:
     std::vector<float> sharpe_ratios;
     std::vector<float> z_scores;
     std::vector<float> win_rates;
-    std::vector<std::string> pair_names;
-    
+
     // Analysis results
     struct AnalysisResults {
         int totalPairs = 0;
@@ -40,25 +52,41 @@ private:
         float avgWinRate = 0.0f;
         float avgHalfLife = 0.0f;
     } analysisResults;
-    
+
+    // Symbol x symbol matrix of the analyzer's --matrix output, in its own
+    // window once loaded
+    MatrixHeatmap matrixHeatmap;
+
+    void collectLoaded();
+    void renderPairSelector(float height);
+
 public:
+    CointegrationVisualizer() = default;
+    ~CointegrationVisualizer();
+    CointegrationVisualizer(const CointegrationVisualizer&) = delete;
+    CointegrationVisualizer& operator=(const CointegrationVisualizer&) = delete;
+
+    // Loads in the background; the previous data stays on screen until done
     void loadCSVFile(const std::string& filename);
+    void loadMatrixFile(const std::string& filename);
     void renderUI();
     void renderDashboard();
     void renderScatterPlots();
     void renderDistributions();
-    void renderTopOpportunities();
+    void renderPairsTable();
     void renderPairDetails();
     void renderFilters();
-    
+
     // Analysis functions
     void updateAnalysis();
     void applyFilters();
     std::vector<CointegrationData> getFilteredData() const;
     void exportFilteredData(const std::string& filename) const;
-    
+
     // Utility functions
-    int getTotalPairs() const { return pairsData.size(); }
+    int getTotalPairs() const { return static_cast<int>(pairs.size()); }
     bool isDataLoaded() const { return dataLoaded; }
     void clearData();
+    // Frees GPU resources; call before the GL context is destroyed
+    void releaseGraphics() { matrixHeatmap.releaseTextures(); }
 };
@@ -0,0 +1,52 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Field parsing shared by the CSV loaders, which find the fields with the
+// SIMD scanner (csv_scanner.h) over a mapped file
+
+// Decimal as written by the feature CSV writer (fixed, optionally with an
+// exponent); an empty cell, which is how it writes NaN and inf, reads as 0
+inline float parseFloat(const char* p, const char* end) {
+    static const double kPow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+    
+    // Up to 17 significant digits; the rest only move the exponent
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    for (; p < end && static_cast<unsigned>(*p - '0') < 10; ++p) {
+        if (mantissa < 10000000000000000ULL) mantissa = mantissa * 10 + (*p - '0');
+        else ++exponent;
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && static_cast<unsigned>(*p - '0') < 10; ++p) {
+            if (mantissa < 10000000000000000ULL) {
+                mantissa = mantissa * 10 + (*p - '0');
+                --exponent;
+            }
+        }
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+')) negativeExponent = *p++ == '-';
+        int e = 0;
+        for (; p < end && static_cast<unsigned>(*p - '0') < 10; ++p) e = std::min(e * 10 + (*p - '0'), 1000);
+        exponent += negativeExponent ? -e : e;
+    }
+    
+    double value = static_cast<double>(mantissa);
+    if (exponent < 0) value = exponent >= -22 ? value / kPow10[-exponent] : value * std::pow(10.0, exponent);
+    else if (exponent > 0) value = exponent <= 22 ? value * kPow10[exponent] : value * std::pow(10.0, exponent);
+    return static_cast<float>(negative ? -value : value);
+}
+
+// Start of the line after the one ending at `p`
+inline const char* nextLine(const char* p, const char* end) {
+    if (p < end && *p == '\r') ++p;
+    if (p < end && *p == '\n') ++p;
+    return p;
+}
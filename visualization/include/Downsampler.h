@@ -0,0 +1,117 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Min and max of every bucket of a series, at bucket sizes kBaseBucket,
+// 2 * kBaseBucket, 4 * kBaseBucket, ... up to the whole series. Built once
+// per column (about a quarter of the column's size) so a zoomed-out chart
+// reads one bucket per pixel instead of every bar. NaN values are ignored;
+// a bucket holding only NaN stores NaN.
+class MinMaxPyramid {
+public:
+    static constexpr size_t kBaseBucket = 8;
+
+    MinMaxPyramid() = default;
+    explicit MinMaxPyramid(const std::vector<float>& values) { build(values.data(), values.size()); }
+    void build(const float* values, size_t count);
+    // Brings the pyramid up to date with `values`, the column it was built
+    // from after rows were appended: only the last old bucket and the new
+    // ones, and the buckets above them, are recomputed. A shorter column is
+    // rebuilt.
+    void extend(const float* values, size_t count);
+
+    bool empty() const { return mins_.empty(); }
+    size_t levels() const { return mins_.size(); }
+    size_t bucketSize(size_t level) const { return kBaseBucket << level; }
+    const std::vector<float>& mins(size_t level) const { return mins_[level]; }
+    const std::vector<float>& maxs(size_t level) const { return maxs_[level]; }
+
+    // Finest level whose buckets hold at least `bucket` values, or levels()
+    // when even the coarsest is smaller
+    size_t levelFor(size_t bucket) const;
+
+private:
+    std::vector<std::vector<float>> mins_;
+    std::vector<std::vector<float>> maxs_;
+    size_t count_ = 0;      // values described
+};
+
+// Points of one series ready for ImPlot; `width` is the bar width in x
+// units (the bucket size once aggregated)
+struct DecimatedSeries {
+    std::vector<float> x;
+    std::vector<float> y;
+    double width = 1.0;
+};
+
+// One bar per bucket: first open, highest high, lowest low, last close
+struct OHLCBuckets {
+    std::vector<float> x;
+    std::vector<float> open;
+    std::vector<float> high;
+    std::vector<float> low;
+    std::vector<float> close;
+    double width = 1.0;
+};
+
+// The part of a time-indexed (x = bar index) series a chart can see
+struct PlotWindow {
+    size_t first = 0;       // visible bars are [first, last)
+    size_t last = 0;
+    size_t budget = 0;      // most points worth drawing at this pixel width
+
+    bool operator==(const PlotWindow& other) const {
+        return first == other.first && last == other.last && budget == other.budget;
+    }
+    bool operator!=(const PlotWindow& other) const { return !(*this == other); }
+};
+
+// Level-of-detail reduction for chart rendering, so every series draws at
+// most kMaxPoints points whatever its length or the zoom. A visible range
+// that already fits is drawn as is; one within kBaseBucket values per point
+// goes through LTTB; anything longer uses the pyramid level whose buckets
+// match the pixel width and draws each bucket's min and max, so spikes
+// survive at every zoom.
+class Downsampler {
+public:
+    static constexpr size_t kMaxPoints = 4096;
+    static constexpr size_t kMinPoints = 256;
+
+    // Points for a plot `pixelWidth` wide: two per pixel column, clamped
+    static size_t pointBudget(float pixelWidth);
+
+    // Window of a `count`-bar series in the current ImPlot plot. Call
+    // between BeginPlot and EndPlot, after the Setup* calls. While ImPlot
+    // is fitting the axes the window is the whole series.
+    static PlotWindow currentWindow(size_t count);
+
+    // values[first, last) as at most `budget` points; `pyramid` may be null
+    // (the buckets are then scanned)
+    static void decimate(const std::vector<float>& values, const MinMaxPyramid* pyramid,
+                         const PlotWindow& window, DecimatedSeries& out);
+
+    // Largest bucket max per point, for bar charts (a bucket's tallest bar
+    // stands for the bucket)
+    static void decimateBars(const std::vector<float>& values, const MinMaxPyramid* pyramid,
+                             const PlotWindow& window, DecimatedSeries& out);
+
+    // OHLC bars aggregated to at most `budget` buckets; the pyramids of the
+    // high and low columns may be null
+    static void aggregateOHLC(const std::vector<float>& open, const std::vector<float>& high,
+                              const std::vector<float>& low, const std::vector<float>& close,
+                              const MinMaxPyramid* highPyramid, const MinMaxPyramid* lowPyramid,
+                              const PlotWindow& window, OHLCBuckets& out);
+
+    // Largest-Triangle-Three-Buckets: keeps the first and last point and,
+    // from each of budget - 2 buckets between them, the point spanning the
+    // largest triangle with its neighbours. NaN points are dropped first.
+    static void lttb(const float* x, const float* y, size_t count, size_t budget,
+                     std::vector<float>& outX, std::vector<float>& outY);
+
+private:
+    // Bucket size for `count` bars in `budget` points (pairs when
+    // `pairs`), rounded up to a pyramid level when one fits; `pyramid` is
+    // cleared when the buckets must be scanned instead
+    static size_t bucketFor(size_t count, size_t budget, bool pairs, const MinMaxPyramid*& pyramid,
+                            size_t& level);
+};
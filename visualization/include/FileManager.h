@@ -1,18 +1,109 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
-#include <map>
 #include "StockData.h"
 
+// One stable copy of each distinct string, shared by every StockData that
+// names it (thread-safe)
+class StringPool {
+public:
+    const std::string* intern(std::string_view text);
+
+private:
+    std::mutex mutex_;
+    std::unordered_set<std::string> strings_;
+};
+
+// How far a feature file has been parsed and how its fields map onto
+// StockData, so rows appended to it later are parsed on their own
+struct CSVTail {
+    std::string path;
+    std::vector<int> columns;       // per CSV field: index into StockData::columns(), or -1
+    int datetimeColumn = -1;
+    int frequencyColumn = -1;
+    uint64_t offset = 0;            // first byte not parsed yet, past a line break or at the end
+    uint64_t identity = 0;          // device and inode; a replaced file is reloaded
+};
+
+// Loads every *_features.csv of the data directory on background threads.
+// Each file is memory-mapped and split with the SIMD CSV scanner straight
+// into a columnar StockData; finished symbols are published as they
+// complete and the UI thread takes them with collectLoaded() every frame.
+//
+// Once loaded, the directory can be followed while the feature pipeline
+// writes to it: only the bytes appended to a file are read and parsed, and
+// the new rows are appended to the symbol's columns with its pyramids
+// extended, as StreamingFeatureEngine grows its columns bar by bar. Linux
+// is notified through inotify; elsewhere the files are polled.
 class FileManager {
 public:
+    FileManager() = default;
+    ~FileManager();
+    FileManager(const FileManager&) = delete;
+    FileManager& operator=(const FileManager&) = delete;
+
     static std::vector<std::string> getCSVFiles(const std::string& directory);
-    static bool loadCSVData(const std::string& filename, 
-                           std::map<std::string, std::vector<StockData>>& stockDataMap);
-    static void loadAllCSVFiles(std::map<std::string, std::vector<StockData>>& stockDataMap,
-                               std::vector<std::string>& symbols,
-                               bool& isLoading,
-                               int& totalFilesFound,
-                               int& filesLoaded,
-                               std::string& loadingStatus);
-};
\ No newline at end of file
+    // Parses one file's header-named columns; returns false when it holds no
+    // complete row or cannot be read. `tail` records where to resume. A last
+    // line without its line break is a row, unless `following`: then it is
+    // still being written and is left unread.
+    static bool loadCSVData(const std::string& filename, StringPool& strings, StockData& data,
+                            CSVTail* tail = nullptr, bool following = false);
+    // Parses the complete lines appended since `tail` into `rows` and moves
+    // `tail` past them; false when the file cannot be read
+    static bool loadAppendedRows(CSVTail& tail, StringPool& strings, StockData& rows);
+
+    // Scans for the data directory and loads it in the background,
+    // cancelling any load in progress; threads = 0 uses every core
+    void startLoading(unsigned threads = 0);
+    // Stops following and the workers after the files they are parsing,
+    // and joins them
+    void cancel();
+
+    // Follows the loaded directory (starting once loading is done) until
+    // stopFollowing() or cancel()
+    void startFollowing();
+    void stopFollowing();
+    bool isFollowing() const { return following_.load(); }
+
+    // Moves the symbols finished since the last call into `stockDataMap`,
+    // appends the rows that arrived for loaded ones and keeps `symbols`
+    // sorted; returns how many symbols arrived or grew
+    size_t collectLoaded(StockDataMap& stockDataMap, std::vector<std::string>& symbols);
+
+    bool isLoading() const { return loading_.load(); }
+    int totalFilesFound() const { return totalFilesFound_.load(); }
+    int filesLoaded() const { return filesLoaded_.load(); }
+    std::string loadingStatus() const;
+
+private:
+    static void parseRows(const CSVTail& layout, const char* p, const char* end, StringPool& strings,
+                          StockData& data);
+    void run(unsigned threads);
+    void follow();
+    void followFile(const std::string& path);
+    void setStatus(std::string status);
+
+    StringPool strings_;
+    std::thread loader_;
+    std::thread follower_;
+    std::atomic<bool> loading_{false};
+    std::atomic<bool> cancelled_{false};
+    std::atomic<bool> following_{false};
+    std::atomic<int> totalFilesFound_{0};
+    std::atomic<int> filesLoaded_{0};
+
+    mutable std::mutex mutex_;          // guards the members below
+    std::string loadingStatus_;
+    std::string directory_;             // where the files were found
+    std::vector<StockData> finished_;
+    std::vector<StockData> appended_;   // rows for symbols already finished
+    std::unordered_map<std::string, CSVTail> tails_;    // by path
+};
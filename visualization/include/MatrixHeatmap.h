@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "tiled_matrix_format.h"
+
+// Symbol x symbol heatmap of a .mftm pair matrix (tiled_matrix_format.h)
+// as the arbitrage analyzer writes it with --matrix on. The file stays
+// mapped; each frame picks the pyramid level whose cells are about a pixel,
+// draws the visible tiles already on the GPU over the coarsest level, and
+// uploads a few more. Tile textures live in an LRU cache of fixed size, so
+// neither the CPU nor the GPU ever holds the whole matrix.
+class MatrixHeatmap {
+public:
+    MatrixHeatmap() = default;
+    MatrixHeatmap(const MatrixHeatmap&) = delete;
+    MatrixHeatmap& operator=(const MatrixHeatmap&) = delete;
+
+    // Maps `filename` in place of the current matrix; on failure the
+    // current one stays and status() says why
+    void load(const std::string& filename);
+    bool isLoaded() const { return file != nullptr; }
+    const std::string& status() const { return statusText; }
+
+    void render();
+
+    // Deletes the tile textures; call while the GL context is current
+    void releaseTextures();
+
+private:
+    struct Resident {
+        uint64_t key;
+        unsigned int texture;
+    };
+
+    // Draws the tiles of `level` in view: resident ones always, missing
+    // ones uploaded while `uploads` lasts
+    void drawLevel(uint32_t level, double xMin, double xMax, double yMin, double yMax, int& uploads);
+    // The texture of a tile, uploaded at the cost of one of `uploads` if it
+    // is not resident; 0 if none are left
+    unsigned int tileTexture(uint32_t level, size_t row, size_t col, int& uploads);
+    void buildColormap();
+
+    std::unique_ptr<TiledMatrixFile> file;
+    std::string statusText;
+    int layer = 0;
+    bool fitPending = false;
+
+    // Most recently drawn first
+    std::list<Resident> residents;
+    std::unordered_map<uint64_t, std::list<Resident>::iterator> residentIndex;
+
+    uint32_t colormap[256] = {};            // RGBA8, for the current layer
+    std::vector<uint32_t> pixels;           // one tile, reused per upload
+};
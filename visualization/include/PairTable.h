@@ -0,0 +1,104 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "CointegrationData.h"
+
+// What the pairs browser shows; grade -1 is every grade, otherwise an index
+// into PairTable::grades()
+struct PairFilter {
+    bool onlyCointegrated = false;
+    bool onlyHighQuality = false;
+    bool onlyOutliers = false;
+    int grade = -1;
+    float minSharpeRatio = 0.0f;
+    float maxHalfLife = 1000.0f;
+
+    bool operator==(const PairFilter& other) const {
+        return onlyCointegrated == other.onlyCointegrated && onlyHighQuality == other.onlyHighQuality &&
+               onlyOutliers == other.onlyOutliers && grade == other.grade &&
+               minSharpeRatio == other.minSharpeRatio && maxHalfLife == other.maxHalfLife;
+    }
+    bool operator!=(const PairFilter& other) const { return !(*this == other); }
+};
+
+// Every result of a cointegration CSV, column by column, with the indexes
+// the pairs browser filters and sorts on: each sortable column's order is
+// computed once after loading, and every grade and flag is a bitmap. A
+// filter or sort change is then a pass over bitmap words and one walk of a
+// permutation instead of a rescan and sort of row structs.
+class PairTable {
+public:
+    // Numeric columns, in the order the arbitrage exporter writes them
+    enum Metric {
+        AdfStatistic, PValue, Critical1Pct, Critical5Pct, Critical10Pct, HalfLifeDays, HedgeRatio,
+        SpreadMean, SpreadStdDev, MaxSpread, MinSpread, CurrentSpread, ZScore,
+        EntryThreshold, ExitThreshold, ExpectedReturn, SharpeRatio, WinRate,
+        MetricCount
+    };
+
+    // Orders the browser sorts by
+    enum SortKey {
+        SortPair, SortGrade, SortSharpe, SortWinRate, SortZScore, SortHalfLife, SortExpectedReturn,
+        SortKeyCount
+    };
+
+    // Parses a cointegration_results.csv as the arbitrage exporter writes it
+    // (header line, then one pair per line) and builds the indexes; lines
+    // with too few fields are skipped. Throws std::runtime_error if the file
+    // cannot be read.
+    static PairTable loadCSV(const std::string& filename);
+
+    size_t size() const { return stock1_.size(); }
+    bool empty() const { return stock1_.empty(); }
+
+    const std::vector<float>& metric(Metric m) const { return metrics_[m]; }
+    const std::string& stock1(uint32_t row) const { return names_[stock1_[row]]; }
+    const std::string& stock2(uint32_t row) const { return names_[stock2_[row]]; }
+    const std::string& grade(uint32_t row) const { return grades_[grade_[row]]; }
+    std::string pairName(uint32_t row) const { return stock1(row) + "/" + stock2(row); }
+    bool isCointegrated(uint32_t row) const { return test(cointegrated_, row); }
+    bool isHighQuality(uint32_t row) const { return test(highQuality_, row); }
+    bool isOutlier(uint32_t row) const { return test(outlier_, row); }
+    // The row as the struct the rest of the visualizer uses
+    CointegrationData row(uint32_t row) const;
+
+    // Distinct grades, sorted
+    const std::vector<std::string>& grades() const { return grades_; }
+    size_t cointegratedCount() const { return count(cointegrated_); }
+    size_t highQualityCount() const { return count(highQuality_); }
+    size_t outlierCount() const { return count(outlier_); }
+
+    // Rows passing `filter`, in `key` order (rows without a value last in
+    // either direction)
+    void select(const PairFilter& filter, SortKey key, bool descending, std::vector<uint32_t>& rows) const;
+
+private:
+    using Bitmap = std::vector<uint64_t>;
+
+    // A column's rows ordered ascending, rows without a value from `ordered` on
+    struct Order {
+        std::vector<uint32_t> rows;
+        size_t ordered = 0;
+    };
+
+    void buildIndexes();
+    Order sortedBy(SortKey key) const;
+    static bool test(const Bitmap& bits, uint32_t row) { return (bits[row >> 6] >> (row & 63)) & 1; }
+    static size_t count(const Bitmap& bits);
+
+    std::vector<std::string> names_;                // stock symbols
+    std::vector<uint32_t> stock1_;                  // into names_
+    std::vector<uint32_t> stock2_;
+    std::vector<std::string> grades_;
+    std::vector<uint8_t> grade_;                    // into grades_
+    std::array<std::vector<float>, MetricCount> metrics_;
+    std::vector<int32_t> historicalTrades_;
+
+    Bitmap cointegrated_;
+    Bitmap highQuality_;
+    Bitmap outlier_;
+    std::vector<Bitmap> gradeRows_;                 // one per grade
+    std::array<Order, SortKeyCount> orders_;
+};
@@ -1,33 +1,95 @@
 #pragma once
+#include "Downsampler.h"
+#include "feature_selection.h"
+#include <cstdint>
+#include <iterator>
+#include <map>
 #include <string>
+#include <string_view>
+#include <vector>
 
+// One symbol's bars stored column by column: every field is a contiguous
+// float array the charts hand straight to ImPlot. The symbol and frequency
+// point into the loader's string pool, shared by every series that uses
+// them, and the dates live back to back in one buffer.
 struct StockData {
-    float datetime_index;
-    float open, high, low, close, volume;
-    std::string symbol;
-    std::string data_frequency;
-    float returns, sma, rsi, volatility, momentum;
-    float spread, internal_bar_strength, skewness_30, kurtosis_30;
-    float log_pct_change_5, auto_correlation_50_10, kama_10_2_30;
-    float linear_slope_20, linear_slope_60, parkinson_volatility_20;
-    float volume_sma_20, velocity, acceleration;
-    float candle_way, candle_filling, candle_amplitude;
-    
-    // New advanced features from CSV
-    float z_score_20, percentile_rank_50, coefficient_of_variation_30;
-    float detrended_price_oscillator_20, hurst_exponent_100, garch_volatility_21;
-    float shannon_entropy_volume_10, chande_momentum_oscillator_14, aroon_oscillator_25;
-    float trix_15, vortex_indicator_14, supertrend_10_3;
-    float ichimoku_senkou_span_A_9_26, ichimoku_senkou_span_B_26_52, fisher_transform_10;
-    float volume_weighted_average_price_intraday, volume_profile_high_volume_node_intraday;
-    float volume_profile_low_volume_node_intraday, on_balance_volume_sma_20;
-    float klinger_oscillator_34_55, money_flow_index_14, vwap_deviation_stddev_30;
-    float markov_regime_switching_garch_2_state, adx_rating_14;
-    float chow_test_statistic_breakpoint_detection_50, market_regime_hmm_3_states_price_vol;
-    float high_volatility_indicator_garch_threshold, return_x_volume_interaction_10;
-    float volatility_x_rsi_interaction_14, price_to_kama_ratio_20_10_30;
-    float polynomial_regression_price_degree_2_slope, conditional_value_at_risk_cvar_95_20;
-    float drawdown_duration_from_peak_50, ulcer_index_14, sortino_ratio_30;
-    
-    std::string date_string;
+    const std::string* symbol = nullptr;
+    const std::string* data_frequency = nullptr;
+
+    std::vector<float> open, high, low, close, volume;
+#define STOCK_DATA_FEATURE_COLUMN(name, offset) std::vector<float> name;
+    FEATURE_COLUMNS(STOCK_DATA_FEATURE_COLUMN)
+#undef STOCK_DATA_FEATURE_COLUMN
+
+    std::string date_text;
+    std::vector<uint32_t> date_ends;    // date i is [date_ends[i - 1], date_ends[i]) of date_text
+
+    std::vector<MinMaxPyramid> lod;     // one per column, in columns() order
+
+    size_t size() const { return date_ends.size(); }
+    bool empty() const { return date_ends.empty(); }
+
+    std::string_view date(size_t i) const {
+        const uint32_t begin = i ? date_ends[i - 1] : 0;
+        return std::string_view(date_text).substr(begin, date_ends[i] - begin);
+    }
+
+    // Column named like the feature CSV header ("open", "rsi", ...), or
+    // nullptr for datetime, symbol, data_frequency and unknown names
+    std::vector<float>* column(std::string_view name) {
+        if (name == "open") return &open;
+        if (name == "high") return &high;
+        if (name == "low") return &low;
+        if (name == "close") return &close;
+        if (name == "volume") return &volume;
+#define STOCK_DATA_FEATURE_LOOKUP(field, offset) if (name == #field) return &field;
+        FEATURE_COLUMNS(STOCK_DATA_FEATURE_LOOKUP)
+#undef STOCK_DATA_FEATURE_LOOKUP
+        return nullptr;
+    }
+
+    // Every float column, in CSV order
+    std::vector<std::vector<float>*> columns() {
+        return {&open, &high, &low, &close, &volume
+#define STOCK_DATA_FEATURE_POINTER(field, offset) , &field
+                FEATURE_COLUMNS(STOCK_DATA_FEATURE_POINTER)
+#undef STOCK_DATA_FEATURE_POINTER
+        };
+    }
+
+    void buildLevelsOfDetail() {
+        const auto all = columns();
+        lod.resize(all.size());
+        for (size_t c = 0; c < all.size(); ++c) lod[c].build(all[c]->data(), all[c]->size());
+    }
+
+    // Appends the bars of `rows` (parsed from the same file) and extends
+    // the pyramids over them instead of rebuilding
+    void append(StockData&& rows) {
+        const auto all = columns();
+        const auto added = rows.columns();
+        for (size_t c = 0; c < all.size(); ++c) {
+            all[c]->insert(all[c]->end(), added[c]->begin(), added[c]->end());
+        }
+        const uint32_t offset = static_cast<uint32_t>(date_text.size());
+        date_text += rows.date_text;
+        for (uint32_t end : rows.date_ends) date_ends.push_back(offset + end);
+        lod.resize(all.size());
+        for (size_t c = 0; c < all.size(); ++c) lod[c].extend(all[c]->data(), all[c]->size());
+    }
+
+    // Pyramid of one of this series' columns, or nullptr before
+    // buildLevelsOfDetail()
+    const MinMaxPyramid* pyramid(const std::vector<float>& column) const {
+        const std::vector<float>* all[] = {&open, &high, &low, &close, &volume
+#define STOCK_DATA_FEATURE_CONST_POINTER(field, offset) , &field
+                FEATURE_COLUMNS(STOCK_DATA_FEATURE_CONST_POINTER)
+#undef STOCK_DATA_FEATURE_CONST_POINTER
+        };
+        size_t index = 0;
+        while (index < std::size(all) && all[index] != &column) ++index;
+        return index < lod.size() ? &lod[index] : nullptr;
+    }
 };
+
+using StockDataMap = std::map<std::string, StockData>;
@@ -2,23 +2,25 @@
 #include <map>
 #include <vector>
 #include <string>
+#include "FileManager.h"
 #include "StockData.h"
 
 class StockVisualizer {
 private:
-    std::map<std::string, std::vector<StockData>> stockDataMap;
+    FileManager fileManager;    // declared first: outlives the data it interned strings for
+    StockDataMap stockDataMap;
     std::vector<std::string> symbols;
     int selectedSymbol = 0;
     bool dataLoaded = false;
-    bool isLoading = false;
-    int totalFilesFound = 0;
-    int filesLoaded = 0;
-    std::string loadingStatus = "";
+    bool followLive = false;    // keep appending the rows the pipeline writes
+    
+    // Adds the symbols the background loader finished since the last frame
+    void collectLoadedSymbols();
     
 public:
     void loadAllCSVFiles();
     void renderUI();
-    void renderCharts(const std::string& symbol, const std::vector<StockData>& data);
+    void renderCharts(const std::string& symbol, const StockData& data);
     int getTotalDataPoints();
     void clearData();
     bool isDataLoaded() const { return dataLoaded; }
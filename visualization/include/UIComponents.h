@@ -1,10 +1,7 @@
 #pragma once
 #include <vector>
 #include <string>
-#include <map>
-
-// Forward declaration
-struct StockData;
+#include "StockData.h"
 
 class UIComponents {
 public:
@@ -13,11 +10,11 @@ public:
     
     static void renderSymbolSelector(const std::vector<std::string>& symbols, 
                                     int& selectedSymbol,
-                                    const std::map<std::string, std::vector<StockData>>& stockDataMap);
+                                    const StockDataMap& stockDataMap);
     
     static void renderDataSummary(const std::vector<std::string>& symbols, 
                                  int totalDataPoints);
     
     static void renderSymbolInfo(const std::string& symbol, 
-                                const std::vector<StockData>& data);
+                                const StockData& data);
 };
\ No newline at end of file
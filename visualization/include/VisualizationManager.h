@@ -3,8 +3,11 @@
 #include "core/FeatureRegistry.h"
 #include "core/FeatureExtractor.h"
 #include "core/ChartFactory.h"
+#include "core/SymbolCache.h"
 #include "rendering/ModularChartRenderer.h"
 #include "../../feature_engineering/include/ohlcv_data.h"
+#include "../../feature_engineering/include/columnar_format.h"
+#include "../../feature_engineering/include/shared_feature_segment.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -15,24 +18,36 @@ namespace Visualization {
 // Data loading and management
 class DataManager {
 public:
-    // Load data from CSV files (existing format)
-    static std::vector<FlexibleStockData> loadFromCSV(const std::string& csv_path);
+    // Load data from CSV files (existing format); .mftc paths go to loadFromColumnar
+    static FeatureFrame loadFromCSV(const std::string& csv_path);
     
-    // Convert from FeatureSet to FlexibleStockData
-    static std::vector<FlexibleStockData> convertFromFeatureSet(
+    // Load data from a binary columnar (.mftc) feature file
+    static FeatureFrame loadFromColumnar(const std::string& path);
+    
+    // Latest image a running feature pipeline published to shared memory;
+    // empty if nothing was published yet
+    static FeatureFrame loadFromSharedSegment(SharedFeatureReader& segment);
+    
+    // Columns of a .mftc file or segment image, as float columns
+    static FeatureFrame convertFromColumnar(const ColumnarFile& file, const std::string& fallback_symbol);
+    
+    // Convert from FeatureSet to a FeatureFrame
+    static FeatureFrame convertFromFeatureSet(
         const std::string& symbol,
         const OHLCVData& ohlcv_data,
         const FeatureSet& feature_set);
     
     // Batch load multiple symbols
-    static std::unordered_map<std::string, std::vector<FlexibleStockData>> loadMultipleSymbols(
+    static std::unordered_map<std::string, FeatureFrame> loadMultipleSymbols(
         const std::vector<std::string>& csv_paths);
     
+    // Symbol and file size of each existing path, without reading the files
+    static std::vector<SymbolIndexEntry> indexSymbols(const std::vector<std::string>& csv_paths);
+    
     // Data validation and cleaning
-    static void validateData(std::vector<FlexibleStockData>& data);
-    static void cleanData(std::vector<FlexibleStockData>& data, bool remove_outliers = false);
+    static void validateData(FeatureFrame& data);
+    static void cleanData(FeatureFrame& data, bool remove_outliers = false);
     
-private:
     static std::string extractSymbolFromPath(const std::string& csv_path);
 };
 
@@ -49,8 +64,14 @@ public:
     // Data management
     bool loadData(const std::string& csv_path);
     bool loadData(const std::string& symbol, const OHLCVData& ohlcv_data, const FeatureSet& feature_set);
+    // Indexes the files only; each symbol is read when first shown
     bool loadMultipleDataSources(const std::vector<std::string>& csv_paths);
+    // Shows the stock a running pipeline publishes to shared memory segment
+    // `name` (see shared_segment_name) and re-reads it after every publish
+    bool attachSharedSegment(const std::string& name);
     
+    // Selects a known symbol, loading it if needed and prefetching its
+    // neighbours in the symbol list
     void setCurrentSymbol(const std::string& symbol);
     std::string getCurrentSymbol() const { return current_symbol_; }
     
@@ -72,12 +93,16 @@ public:
     // Configuration
     void setDashboardLayout(const DashboardLayout& layout);
     void setChartFilter(const ChartFilter& filter);
+    // Bytes of loaded symbol data kept before the least recently used
+    // symbols are dropped
+    void setMemoryBudget(size_t bytes) { symbols_.setMemoryBudget(bytes); }
     
     DashboardLayout& getDashboardLayout() { return renderer_.getDashboardLayout(); }
     ChartFilter& getChartFilter() { return renderer_.getChartFilter(); }
     
     // Utility methods
     bool hasDataForSymbol(const std::string& symbol) const;
+    // 0 for a symbol that is not loaded
     size_t getDataPointCount(const std::string& symbol = "") const;
     
     // Export functionality
@@ -92,9 +117,17 @@ private:
     // Core components
     ModularChartRenderer renderer_;
     
-    // Data storage
-    std::unordered_map<std::string, std::vector<FlexibleStockData>> symbol_data_;
+    // Data storage: every known symbol, loaded on demand
+    SymbolCache symbols_;
     std::string current_symbol_;
+    std::shared_ptr<FeatureFrame> current_data_;
+    
+    // Attached shared segments and the publish each last showed
+    struct LiveSegment {
+        std::unique_ptr<SharedFeatureReader> reader;
+        uint64_t shown = 0;
+    };
+    std::vector<LiveSegment> live_segments_;
     
     // UI state
     bool show_symbol_selector_;
@@ -104,8 +137,8 @@ private:
     std::vector<std::string> selected_symbols_for_comparison_;
     
     // Helper methods
-    const std::vector<FlexibleStockData>& getCurrentData() const;
-    std::vector<FlexibleStockData>& getCurrentData();
+    const FeatureFrame& getCurrentData() const;
+    FeatureFrame& getCurrentData();
     
     void renderMainMenuBar();
     void renderStatusBar();
@@ -113,6 +146,8 @@ private:
     
     // UI helpers
     void renderSymbolCombo();
+    void prefetchNeighbours(const std::string& symbol);
+    void refreshLiveSegments();
     void renderFeatureSelectionUI();
     void renderLayoutSelectionUI();
     
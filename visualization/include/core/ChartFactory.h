@@ -2,6 +2,7 @@
 
 #include "FeatureRegistry.h"
 #include "FeatureExtractor.h"
+#include "Downsampler.h"
 #include <vector>
 #include <string>
 #include <memory>
@@ -43,6 +44,13 @@ struct ChartData {
     std::string series_name;
     float color[3];
     ChartType chart_type;
+    std::shared_ptr<const MinMaxPyramid> lod;   // of the source column, when it has one
+
+    // Points last drawn and the window they were decimated for; kept while
+    // the view does not move so an idle chart does no work per frame
+    mutable DecimatedSeries lod_points;
+    mutable PlotWindow lod_window;
+    mutable bool lod_valid = false;
     
     ChartData(const std::string& name, ChartType type = ChartType::LINE)
         : series_name(name), chart_type(type) {
@@ -58,6 +66,12 @@ struct ChartData {
 struct MultiSeriesChart {
     ChartConfig config;
     std::vector<ChartData> series;
+    bool ohlc = false;  // series are open, high, low, close
+
+    // Aggregated OHLC bars last drawn, reused like ChartData::lod_points
+    mutable OHLCBuckets ohlc_bars;
+    mutable PlotWindow ohlc_window;
+    mutable bool ohlc_valid = false;
     
     MultiSeriesChart(const ChartConfig& cfg) : config(cfg) {}
     
@@ -75,41 +89,41 @@ public:
     // Create a single feature chart
     static MultiSeriesChart createFeatureChart(
         const std::string& feature_name,
-        const std::vector<FlexibleStockData>& data,
+        const FeatureFrame& data,
         const std::string& symbol = "");
     
     // Create a category-based chart with multiple features
     static MultiSeriesChart createCategoryChart(
         FeatureCategory category,
-        const std::vector<FlexibleStockData>& data,
+        const FeatureFrame& data,
         const std::string& symbol = "");
     
     // Create a comparison chart for multiple features
     static MultiSeriesChart createComparisonChart(
         const std::vector<std::string>& feature_names,
-        const std::vector<FlexibleStockData>& data,
+        const FeatureFrame& data,
         const std::string& title = "Feature Comparison",
         const std::string& symbol = "");
     
     // Create OHLC candlestick chart
     static MultiSeriesChart createOHLCChart(
-        const std::vector<FlexibleStockData>& data,
+        const FeatureFrame& data,
         const std::string& symbol = "");
     
     // Create volume chart with bars
     static MultiSeriesChart createVolumeChart(
-        const std::vector<FlexibleStockData>& data,
+        const FeatureFrame& data,
         const std::string& symbol = "");
     
     // Create price chart with multiple price series
     static MultiSeriesChart createPriceChart(
-        const std::vector<FlexibleStockData>& data,
+        const FeatureFrame& data,
         const std::string& symbol = "");
     
     // Create statistical distribution chart
     static MultiSeriesChart createDistributionChart(
         const std::string& feature_name,
-        const std::vector<FlexibleStockData>& data,
+        const FeatureFrame& data,
         const std::string& symbol = "");
     
     // Render a multi-series chart using ImPlot
@@ -117,11 +131,11 @@ public:
     
     // Utility functions
     static std::vector<float> extractFeatureValues(
-        const std::vector<FlexibleStockData>& data,
+        const FeatureFrame& data,
         const std::string& feature_name);
     
     static std::vector<float> extractTimeIndices(
-        const std::vector<FlexibleStockData>& data);
+        const FeatureFrame& data);
     
     static ChartConfig createConfigForFeature(
         const std::string& feature_name,
@@ -132,6 +146,11 @@ public:
         const std::string& symbol = "");
 
 private:
+    // Visible part of a long time series at the plot's level of detail;
+    // null when the series is short enough to draw as is
+    static const DecimatedSeries* decimateSeries(const ChartData& data, const std::vector<float>& x_values,
+                                                 bool bars);
+    
     // Helper functions for specific chart types
     static void renderLineChart(const ChartData& data, const std::vector<float>& x_values);
     static void renderBarChart(const ChartData& data, const std::vector<float>& x_values);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "FeatureFrame.h"
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -13,25 +14,6 @@ struct OHLCVData;
 
 namespace Visualization {
 
-// Flexible data container for visualization
-struct FlexibleStockData {
-    std::string symbol;
-    std::chrono::system_clock::time_point timestamp;
-    std::string date_string;
-    float datetime_index;
-    
-    // Dynamic feature storage
-    std::unordered_map<std::string, double> features;
-    
-    // Convenience accessors for common features
-    double getFeature(const std::string& name, double default_value = 0.0) const;
-    void setFeature(const std::string& name, double value);
-    bool hasFeature(const std::string& name) const;
-    
-    // Get all feature names
-    std::vector<std::string> getFeatureNames() const;
-};
-
 // Type trait to check if a type has a specific member
 template<typename T, typename = void>
 struct has_member : std::false_type {};
@@ -41,8 +23,8 @@ struct has_member<T, std::void_t<decltype(std::declval<T>().size())>> : std::tru
 
 class FeatureExtractor {
 public:
-    // Extract features from FeatureSet to FlexibleStockData
-    static std::vector<FlexibleStockData> extractFromFeatureSet(
+    // Extract OHLCV and every available feature into one column each
+    static FeatureFrame extractFromFeatureSet(
         const std::string& symbol,
         const OHLCVData& ohlcv_data,
         const FeatureSet& feature_set);
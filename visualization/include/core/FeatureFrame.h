@@ -0,0 +1,82 @@
+#pragma once
+
+#include "FeatureRegistry.h"
+#include "Downsampler.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Visualization {
+
+// Read-only view of one feature column
+struct FeatureSpan {
+    const float* data = nullptr;
+    size_t size = 0;
+
+    bool empty() const { return size == 0; }
+    const float* begin() const { return data; }
+    const float* end() const { return data + size; }
+    float operator[](size_t i) const { return data[i]; }
+};
+
+// One symbol's bars stored column by column: a contiguous float array per
+// feature, indexed by the FeatureRegistry id so a lookup is an array index
+// rather than a string hash per bar. Cells never set are NaN.
+class FeatureFrame {
+public:
+    std::string symbol;
+
+    FeatureFrame() = default;
+    explicit FeatureFrame(std::string symbol, size_t rows = 0);
+
+    size_t size() const { return rows_; }
+    bool empty() const { return rows_ == 0; }
+    // Grows or shrinks every column; new cells are NaN
+    void resize(size_t rows);
+    // Keeps the rows whose flag is set, in order
+    void keepRows(const std::vector<char>& keep);
+
+    // Column of `id`, created full of NaN on first use
+    std::vector<float>& column(FeatureId id);
+    void set(FeatureId id, size_t row, float value) { column(id)[row] = value; }
+
+    // Empty span when the frame has no such column
+    FeatureSpan column(FeatureId id) const;
+    FeatureSpan column(const std::string& name) const;
+    bool hasFeature(FeatureId id) const { return id < columns_.size() && !columns_[id].empty(); }
+    bool hasFeature(const std::string& name) const;
+
+    // Columns present, in the order they were added
+    const std::vector<FeatureId>& featureIds() const { return present_; }
+    std::vector<std::string> getFeatureNames() const;
+
+    // Min/max pyramid of a column for the charts' level of detail, built on
+    // first use and dropped when the column changes; null when absent
+    std::shared_ptr<const MinMaxPyramid> pyramid(FeatureId id) const;
+    std::shared_ptr<const MinMaxPyramid> pyramid(const std::string& name) const;
+
+    // Changes whenever the frame may have changed (a mutable column handed
+    // out, a resize, rows dropped) and differs between frames, so caches
+    // built from the frame can tell when they are stale
+    uint64_t version() const;
+
+    // Bytes held by the columns and dates (pyramids excluded)
+    size_t memoryBytes() const;
+
+    // Date labels, one per row once fully appended; packed into one buffer
+    void appendDate(std::string_view date);
+    std::string_view date(size_t row) const;
+
+private:
+    size_t rows_ = 0;
+    std::vector<std::vector<float>> columns_;     // by FeatureId; empty when absent
+    std::vector<FeatureId> present_;
+    mutable std::vector<std::shared_ptr<const MinMaxPyramid>> pyramids_;   // by FeatureId
+    mutable uint64_t version_ = 0;      // 0 until asked for after a change
+    std::string date_text_;
+    std::vector<uint32_t> date_ends_;
+};
+
+} // namespace Visualization
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstdint>
+#include <deque>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -8,6 +11,10 @@
 
 namespace Visualization {
 
+// Dense index of a feature name, stable for the life of the process
+using FeatureId = uint32_t;
+constexpr FeatureId kInvalidFeatureId = UINT32_MAX;
+
 enum class FeatureCategory {
     PRICE,
     TECHNICAL,
@@ -90,6 +97,14 @@ public:
     bool isFeatureRegistered(const std::string& name) const;
     size_t getFeatureCount() const;
     
+    // Feature ids: resolve a name once, then index columns by the id.
+    // getFeatureId assigns the next id to a name seen for the first time
+    // (registered or not); findFeatureId returns kInvalidFeatureId instead.
+    // Safe to call from loader threads.
+    FeatureId getFeatureId(const std::string& name);
+    FeatureId findFeatureId(const std::string& name) const;
+    const std::string& getFeatureName(FeatureId id) const;
+    
     // Initialize with default features from FeatureSet
     void initializeDefaultFeatures();
     
@@ -97,6 +112,9 @@ private:
     FeatureRegistry() = default;
     std::unordered_map<std::string, FeatureMetadata> features_;
     std::unordered_map<FeatureCategory, std::vector<std::string>> category_map_;
+    mutable std::mutex ids_mutex_;      // guards ids_ and id_names_
+    std::unordered_map<std::string, FeatureId> ids_;
+    std::deque<std::string> id_names_;  // deque: names handed out stay put
     
     void updateCategoryMap(const std::string& name, FeatureCategory category);
 };
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "FeatureFrame.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Visualization {
+
+// Summary of one feature's finite values
+struct FeatureSummary {
+    double mean = 0.0;
+    double std_dev = 0.0;
+    double min_val = 0.0;
+    double max_val = 0.0;
+    double median = 0.0;
+    size_t count = 0;           // rows
+    size_t valid_count = 0;     // finite rows
+};
+
+// Statistics of one feature list over one version of a frame
+struct FeatureStatistics {
+    uint64_t data_version = 0;
+    std::vector<std::string> features;
+    std::vector<FeatureSummary> summaries;      // one per feature
+    std::vector<float> correlation;             // features^2 Pearson, row by row; empty unless asked for
+
+    bool describes(const FeatureFrame& data, const std::vector<std::string>& wanted) const {
+        return data_version == data.version() && features == wanted;
+    }
+};
+
+// Feature summaries and correlation matrices computed on a background
+// thread, so the UI draws the last finished result (possibly of an older
+// version) instead of stalling. Per (name, symbol) the worker keeps each
+// feature's prepared column, summary and pairwise correlations for the
+// current frame version: adding a feature computes only its new pairs,
+// removing one drops them. Reductions run on the SIMD kernels SIMDStatistics
+// uses (simd_dispatch.h). Call from the UI thread only.
+class StatisticsWorker {
+public:
+    StatisticsWorker() = default;
+    ~StatisticsWorker();
+    StatisticsWorker(const StatisticsWorker&) = delete;
+    StatisticsWorker& operator=(const StatisticsWorker&) = delete;
+
+    // Newest finished statistics of `features` for (name, symbol), null
+    // before the first; queues fresh ones when `data` changed version or
+    // the list differs from the last request. Only the columns the worker
+    // does not hold yet are copied over.
+    std::shared_ptr<const FeatureStatistics> request(const std::string& name, const std::string& symbol,
+                                                     const FeatureFrame& data,
+                                                     const std::vector<std::string>& features,
+                                                     bool correlation);
+
+    // Forgets every result and prepared column of `symbol`
+    void releaseSymbol(const std::string& symbol);
+
+private:
+    // A feature column as doubles with its finite span; `dense` when every
+    // value of [first, last) is finite
+    struct Column {
+        std::vector<double> values;
+        size_t first = 0;
+        size_t last = 0;
+        bool dense = true;
+        FeatureSummary summary;
+    };
+
+    struct Job {
+        std::string key;
+        uint64_t version = 0;
+        bool reset = false;             // drop what the worker holds for the key
+        bool correlation = false;
+        std::vector<std::string> features;
+        std::unordered_map<std::string, std::vector<float>> columns;    // new to the worker
+    };
+
+    // What the UI last asked for under a key
+    struct Posted {
+        std::string symbol;
+        uint64_t version = 0;
+        bool correlation = false;
+        std::vector<std::string> features;
+        std::unordered_set<std::string> sent;     // columns the worker holds
+    };
+
+    // Worker-side cache of one key
+    struct State {
+        uint64_t version = 0;
+        std::unordered_map<std::string, Column> columns;
+        std::unordered_map<std::string, std::unordered_map<std::string, double>> pairs;    // [a][b], a < b
+    };
+
+    void run();
+    void compute(Job& job);
+    static Column prepare(const std::vector<float>& values);
+    double correlate(const Column& a, const Column& b);
+
+    std::unordered_map<std::string, Posted> posted_;    // UI thread only
+
+    // Worker thread only
+    std::unordered_map<std::string, State> states_;
+    std::vector<double> scratch_x_;
+    std::vector<double> scratch_y_;
+
+    std::thread worker_;
+    std::mutex mutex_;                  // guards the members below
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::deque<Job> jobs_;
+    std::vector<std::string> released_;
+    std::unordered_map<std::string, std::shared_ptr<const FeatureStatistics>> results_;
+};
+
+} // namespace Visualization
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "FeatureFrame.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Visualization {
+
+// A symbol the cache can load without having read it yet: its feature file
+// and the file's size on disk
+struct SymbolIndexEntry {
+    std::string symbol;
+    std::string path;
+    uintmax_t file_bytes = 0;
+};
+
+// Symbols known by index only, each loaded the first time it is asked for
+// and kept while the loaded frames fit the memory budget; past it the least
+// recently used are dropped (and reloaded from their file when needed
+// again). Neighbours of the selection can be prefetched on a background
+// thread. Frames handed in without a file are never evicted.
+// Everything but the loader runs on the UI thread.
+class SymbolCache {
+public:
+    // Reads one feature file; may run on the prefetch thread
+    using Loader = std::function<FeatureFrame(const std::string& path)>;
+    static constexpr size_t kDefaultBudgetBytes = size_t(1) << 30;
+
+    explicit SymbolCache(Loader loader, size_t budget_bytes = kDefaultBudgetBytes);
+    ~SymbolCache();
+    SymbolCache(const SymbolCache&) = delete;
+    SymbolCache& operator=(const SymbolCache&) = delete;
+
+    // Makes the symbols known without loading them; an entry replaces one
+    // with the same symbol (dropping its loaded frame)
+    void addToIndex(const std::vector<SymbolIndexEntry>& entries);
+    // Keeps `frame` loaded as `symbol`; with an empty path it cannot be
+    // reloaded, so it is never evicted
+    void put(const std::string& symbol, FeatureFrame frame, const std::string& path = "");
+
+    bool contains(const std::string& symbol) const { return index_.count(symbol) != 0; }
+    bool isLoaded(const std::string& symbol) const { return loaded_.count(symbol) != 0; }
+    // Every known symbol, sorted
+    const std::vector<std::string>& symbols() const { return symbols_; }
+
+    // Frame of `symbol`, loaded on this thread unless already loaded or
+    // prefetched, and marked most recently used; null when the symbol is
+    // unknown or its file holds no rows. The pointer stays valid after an
+    // eviction.
+    std::shared_ptr<FeatureFrame> get(const std::string& symbol);
+    // Loaded frame of `symbol` without loading it or touching the LRU order
+    std::shared_ptr<const FeatureFrame> peek(const std::string& symbol) const;
+
+    // Loads these symbols in the background, replacing any queued earlier;
+    // loaded or unknown symbols are skipped
+    void prefetch(const std::vector<std::string>& symbols);
+
+    // Called with each evicted symbol, e.g. to drop charts built from it
+    void setEvictionCallback(std::function<void(const std::string&)> callback) {
+        on_evict_ = std::move(callback);
+    }
+
+    void setMemoryBudget(size_t bytes);
+    size_t memoryBudget() const { return budget_bytes_; }
+    size_t loadedBytes() const { return loaded_bytes_; }
+    size_t loadedCount() const { return loaded_.size(); }
+
+private:
+    struct Loaded {
+        std::shared_ptr<FeatureFrame> frame;
+        size_t bytes;
+        std::list<std::string>::iterator lru;   // position in lru_
+    };
+
+    void adoptPrefetched();
+    void insertLoaded(const std::string& symbol, std::shared_ptr<FeatureFrame> frame, bool most_recent);
+    void erase(const std::string& symbol);
+    void evict();
+    void runPrefetch();
+
+    Loader loader_;
+    size_t budget_bytes_;
+
+    std::unordered_map<std::string, SymbolIndexEntry> index_;
+    std::vector<std::string> symbols_;
+    std::unordered_map<std::string, Loaded> loaded_;
+    std::list<std::string> lru_;        // most recently used first
+    size_t loaded_bytes_ = 0;
+    std::function<void(const std::string&)> on_evict_;
+
+    // Prefetch thread, started on the first prefetch()
+    std::thread worker_;
+    std::mutex mutex_;                  // guards the members below
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::deque<SymbolIndexEntry> queue_;
+    std::vector<std::pair<std::string, std::shared_ptr<FeatureFrame>>> prefetched_;
+};
+
+} // namespace Visualization
@@ -3,6 +3,8 @@
 #include "core/FeatureRegistry.h"
 #include "core/FeatureExtractor.h"
 #include "core/ChartFactory.h"
+#include "core/StatisticsWorker.h"
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -45,6 +47,9 @@ struct ChartFilter {
     
     bool isFeatureEnabled(const std::string& feature_name) const;
     bool isCategoryEnabled(FeatureCategory category) const;
+    
+    bool operator==(const ChartFilter& other) const;
+    bool operator!=(const ChartFilter& other) const { return !(*this == other); }
 };
 
 class ModularChartRenderer {
@@ -53,62 +58,64 @@ public:
     ~ModularChartRenderer() = default;
     
     // Main rendering methods
-    void renderDashboard(const std::vector<FlexibleStockData>& data, 
+    void renderDashboard(const FeatureFrame& data, 
                         const std::string& symbol = "");
     
-    void renderCategoryDashboard(const std::vector<FlexibleStockData>& data,
+    void renderCategoryDashboard(const FeatureFrame& data,
                                const std::string& symbol = "");
     
-    void renderCustomDashboard(const std::vector<FlexibleStockData>& data,
+    void renderCustomDashboard(const FeatureFrame& data,
                              const std::vector<std::string>& selected_features,
                              const std::string& symbol = "");
     
     // Individual chart rendering
     void renderFeatureChart(const std::string& feature_name,
-                          const std::vector<FlexibleStockData>& data,
+                          const FeatureFrame& data,
                           const std::string& symbol = "");
     
     void renderCategoryChart(FeatureCategory category,
-                           const std::vector<FlexibleStockData>& data,
+                           const FeatureFrame& data,
                            const std::string& symbol = "");
     
     void renderComparisonChart(const std::vector<std::string>& feature_names,
-                             const std::vector<FlexibleStockData>& data,
+                             const FeatureFrame& data,
                              const std::string& title = "",
                              const std::string& symbol = "");
     
     // Special chart types
-    void renderPriceVolumeOverview(const std::vector<FlexibleStockData>& data,
+    void renderPriceVolumeOverview(const FeatureFrame& data,
                                  const std::string& symbol = "");
     
-    void renderStatisticalSummary(const std::vector<FlexibleStockData>& data,
+    void renderStatisticalSummary(const FeatureFrame& data,
                                 const std::string& symbol = "");
     
-    void renderFeatureCorrelationMatrix(const std::vector<FlexibleStockData>& data,
+    void renderFeatureCorrelationMatrix(const FeatureFrame& data,
                                       const std::vector<std::string>& features,
                                       const std::string& symbol = "");
     
     // Configuration and layout
     void setDashboardLayout(const DashboardLayout& layout);
     void setChartFilter(const ChartFilter& filter);
+    // Drops the cached charts of a symbol whose data was unloaded
+    void releaseSymbol(const std::string& symbol);
     
     DashboardLayout& getDashboardLayout() { return layout_; }
     ChartFilter& getChartFilter() { return filter_; }
     
     // Feature management
-    std::vector<std::string> getAvailableFeatures(const std::vector<FlexibleStockData>& data) const;
-    std::vector<FeatureCategory> getAvailableCategories(const std::vector<FlexibleStockData>& data) const;
+    std::vector<std::string> getAvailableFeatures(const FeatureFrame& data) const;
+    std::vector<FeatureCategory> getAvailableCategories(const FeatureFrame& data) const;
     
     // UI Controls
-    void renderFeatureSelector(const std::vector<FlexibleStockData>& data);
+    void renderFeatureSelector(const FeatureFrame& data);
     void renderCategorySelector();
     void renderLayoutControls();
     void renderChartControls();
     
     // Statistics and info
-    void renderDataStatistics(const std::vector<FlexibleStockData>& data);
+    void renderDataStatistics(const FeatureFrame& data);
     void renderFeatureStatistics(const std::string& feature_name,
-                                const std::vector<FlexibleStockData>& data);
+                                const FeatureFrame& data);
 
 private:
     DashboardLayout layout_;
@@ -121,24 +128,34 @@ private:
     bool show_category_selector_;
     bool show_layout_controls_;
     
-    // Chart caching for performance
-    std::unordered_map<std::string, MultiSeriesChart> chart_cache_;
+    // Chart caching for performance: charts are built once per (chart,
+    // symbol) and kept, with their plot buffers, until the frame's version
+    // or the filter changes
+    struct CachedChart {
+        uint64_t data_version;
+        MultiSeriesChart chart;
+    };
+    std::unordered_map<std::string, CachedChart> chart_cache_;
+    ChartFilter cached_filter_;         // filter the cached charts were built under
     bool use_chart_cache_;
     
+    // Summaries and correlation matrices, computed off the UI thread
+    StatisticsWorker statistics_;
+    
     // Helper methods for rendering
-    void renderGridLayout(const std::vector<MultiSeriesChart>& charts);
-    void renderTabLayout(const std::vector<MultiSeriesChart>& charts,
+    void renderGridLayout(const std::vector<const MultiSeriesChart*>& charts);
+    void renderTabLayout(const std::vector<const MultiSeriesChart*>& charts,
                         const std::vector<std::string>& tab_names);
-    void renderAccordionLayout(const std::vector<MultiSeriesChart>& charts,
+    void renderAccordionLayout(const std::vector<const MultiSeriesChart*>& charts,
                              const std::vector<std::string>& section_names);
     
-    // Chart generation helpers
-    std::vector<MultiSeriesChart> generateCategoryCharts(
-        const std::vector<FlexibleStockData>& data,
+    // Chart generation helpers; the charts live in chart_cache_
+    std::vector<const MultiSeriesChart*> generateCategoryCharts(
+        const FeatureFrame& data,
         const std::string& symbol);
     
-    std::vector<MultiSeriesChart> generateFeatureCharts(
-        const std::vector<FlexibleStockData>& data,
+    std::vector<const MultiSeriesChart*> generateFeatureCharts(
+        const FeatureFrame& data,
         const std::vector<std::string>& features,
         const std::string& symbol);
     
@@ -146,37 +163,29 @@ private:
     void renderImGuiFeatureCheckbox(const std::string& feature_name, bool& selected);
     void renderImGuiCategoryCheckbox(FeatureCategory category, bool& selected);
     
-    // Statistics calculations
-    struct FeatureStats {
-        double mean;
-        double std_dev;
-        double min_val;
-        double max_val;
-        double median;
-        size_t count;
-        size_t valid_count;
-    };
-    
-    FeatureStats calculateFeatureStatistics(const std::string& feature_name,
-                                          const std::vector<FlexibleStockData>& data) const;
-    
-    // Correlation calculations
-    double calculateCorrelation(const std::string& feature1,
-                              const std::string& feature2,
-                              const std::vector<FlexibleStockData>& data) const;
-    
-    std::vector<std::vector<double>> calculateCorrelationMatrix(
-        const std::vector<std::string>& features,
-        const std::vector<FlexibleStockData>& data) const;
-    
     // Cache management
     std::string generateCacheKey(const std::string& chart_type,
                                const std::string& identifier,
                                const std::string& symbol) const;
     
     void clearChartCache();
-    bool getCachedChart(const std::string& key, MultiSeriesChart& chart) const;
-    void setCachedChart(const std::string& key, const MultiSeriesChart& chart);
+    // Drops the cached charts when the filter was edited since they were built
+    void syncChartFilter();
+    
+    // Chart under `key`, rebuilt with build() when missing or built from an
+    // older version of `data`
+    template <typename Build>
+    const MultiSeriesChart& cachedChart(const std::string& key, const FeatureFrame& data, Build&& build) {
+        auto it = chart_cache_.find(key);
+        if (it == chart_cache_.end()) {
+            return chart_cache_.emplace(key, CachedChart{data.version(), build()}).first->second.chart;
+        }
+        if (!use_chart_cache_ || it->second.data_version != data.version()) {
+            it->second.chart = build();
+            it->second.data_version = data.version();
+        }
+        return it->second.chart;
+    }
 };
 
 } // namespace Visualization
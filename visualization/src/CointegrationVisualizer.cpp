@@ -2,86 +2,97 @@
 #include "imgui.h"
 #include "implot.h"
 #include <fstream>
-#include <sstream>
 #include <iostream>
 #include <algorithm>
 #include <cmath>
+#include <stdexcept>
+
+namespace {
+// Scatter plots draw at most this many points, evenly spaced over the
+// filtered pairs; histograms bin all of them
+constexpr size_t kMaxScatterPoints = 100000;
+
+void plotScatter(const char* label, const std::vector<float>& xs, const std::vector<float>& ys) {
+    const size_t step = xs.size() / kMaxScatterPoints + 1;
+    const size_t count = (xs.size() + step - 1) / step;
+    ImPlot::PlotScatter(label, xs.data(), ys.data(), static_cast<int>(count), 0, 0,
+                        static_cast<int>(step * sizeof(float)));
+}
+}
+
+CointegrationVisualizer::~CointegrationVisualizer() {
+    if (loader.joinable()) {
+        loader.join();
+    }
+}
 
 void CointegrationVisualizer::loadCSVFile(const std::string& filename) {
+    // A load in progress cannot be cancelled; wait for it and drop its table
+    if (loader.joinable()) {
+        loader.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(loaderMutex);
+        loadedPairs.reset();
+    }
     isLoading = true;
     loadingStatus = "Loading " + filename + "...";
-    pairsData.clear();
-    
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        loadingStatus = "Error: Could not open file " + filename;
-        isLoading = false;
-        return;
-    }
-    
-    std::string line;
-    bool isFirstLine = true;
-    
-    while (std::getline(file, line)) {
-        if (isFirstLine) {
-            isFirstLine = false;
-            continue; // Skip header
-        }
-        
-        std::stringstream ss(line);
-        std::string cell;
-        CointegrationData data;
-        
+
+    loader = std::thread([this, filename] {
+        std::unique_ptr<PairTable> table;
+        std::string status;
         try {
-            // Parse CSV line
-            std::getline(ss, data.stock1, ',');
-            std::getline(ss, data.stock2, ',');
-            
-            std::getline(ss, cell, ','); data.adf_statistic = std::stof(cell);
-            std::getline(ss, cell, ','); data.p_value = std::stof(cell);
-            std::getline(ss, cell, ','); data.critical_1pct = std::stof(cell);
-            std::getline(ss, cell, ','); data.critical_5pct = std::stof(cell);
-            std::getline(ss, cell, ','); data.critical_10pct = std::stof(cell);
-            std::getline(ss, cell, ','); data.half_life_days = std::stof(cell);
-            std::getline(ss, cell, ','); data.hedge_ratio = std::stof(cell);
-            std::getline(ss, cell, ','); data.spread_mean = std::stof(cell);
-            std::getline(ss, cell, ','); data.spread_stddev = std::stof(cell);
-            std::getline(ss, cell, ','); data.max_spread = std::stof(cell);
-            std::getline(ss, cell, ','); data.min_spread = std::stof(cell);
-            std::getline(ss, cell, ','); data.current_spread = std::stof(cell);
-            std::getline(ss, cell, ','); data.z_score = std::stof(cell);
-            std::getline(ss, data.grade, ',');
-            
-            std::getline(ss, cell, ','); 
-            data.is_cointegrated = (cell == "TRUE" || cell == "true" || cell == "1");
-            
-            std::getline(ss, cell, ','); data.entry_threshold = std::stof(cell);
-            std::getline(ss, cell, ','); data.exit_threshold = std::stof(cell);
-            std::getline(ss, cell, ','); data.expected_return = std::stof(cell);
-            std::getline(ss, cell, ','); data.sharpe_ratio = std::stof(cell);
-            std::getline(ss, cell, ','); data.historical_trades = std::stoi(cell);
-            std::getline(ss, cell, ','); data.win_rate = std::stof(cell);
-            
-            pairsData.push_back(data);
-            
+            table = std::make_unique<PairTable>(PairTable::loadCSV(filename));
+            status = "Loaded " + std::to_string(table->size()) + " pairs";
         } catch (const std::exception& e) {
-            std::cerr << "Error parsing line: " << line << " - " << e.what() << std::endl;
-            continue;
+            status = "Error: Could not open file " + filename;
+            std::cerr << status << " - " << e.what() << std::endl;
         }
+        std::lock_guard<std::mutex> lock(loaderMutex);
+        loadedPairs = std::move(table);
+        loaderStatus = std::move(status);
+        isLoading = false;
+    });
+}
+
+void CointegrationVisualizer::loadMatrixFile(const std::string& filename) {
+    // Only the header and symbols are read here; tiles load as they show
+    matrixHeatmap.load(filename);
+    loadingStatus = matrixHeatmap.status();
+}
+
+void CointegrationVisualizer::collectLoaded() {
+    if (isLoading || !loader.joinable()) return;
+    loader.join();
+
+    std::unique_ptr<PairTable> table;
+    {
+        std::lock_guard<std::mutex> lock(loaderMutex);
+        table = std::move(loadedPairs);
+        loadingStatus = loaderStatus;
     }
-    
-    file.close();
+    if (!table) return;
+
+    pairs = std::move(*table);
     dataLoaded = true;
-    isLoading = false;
-    loadingStatus = "Loaded " + std::to_string(pairsData.size()) + " pairs";
-    
+    selectedPair = -1;
+    // Grade indexes belong to the previous table
+    filters.grade = -1;
     updateAnalysis();
     applyFilters();
 }
 
 void CointegrationVisualizer::renderUI() {
+    collectLoaded();
+
+    if (matrixHeatmap.isLoaded()) {
+        ImGui::Begin("Pair Correlation Matrix");
+        matrixHeatmap.render();
+        ImGui::End();
+    }
+
     ImGui::Begin("Cointegration Pairs Analysis", nullptr, ImGuiWindowFlags_MenuBar);
-    
+
     if (ImGui::BeginMenuBar()) {
         if (ImGui::BeginMenu("File")) {
             if (ImGui::MenuItem("Load CSV...")) {
@@ -92,6 +103,10 @@ void CointegrationVisualizer::renderUI() {
                 // Load the sample file for testing
                 loadCSVFile("cointegration_sample.csv");
             }
+            if (ImGui::MenuItem("Load Pair Matrix...")) {
+                // Written by the arbitrage analyzer with --matrix on
+                loadMatrixFile("pair_matrix.mftm");
+            }
             if (ImGui::MenuItem("Export Filtered Data...")) {
                 exportFilteredData("filtered_pairs.csv");
             }
@@ -99,62 +114,64 @@ void CointegrationVisualizer::renderUI() {
         }
         ImGui::EndMenuBar();
     }
-    
+
     if (isLoading) {
         ImGui::Text("%s", loadingStatus.c_str());
-        ImGui::End();
-        return;
+        if (!dataLoaded) {
+            ImGui::End();
+            return;
+        }
     }
-    
+
     if (!dataLoaded) {
         ImGui::Text("No data loaded. Use File -> Load CSV to load cointegration data.");
         ImGui::End();
         return;
     }
-    
+
     // Create tabs for different views
     if (ImGui::BeginTabBar("AnalysisTabs")) {
         if (ImGui::BeginTabItem("Dashboard")) {
             renderDashboard();
             ImGui::EndTabItem();
         }
-        
+
         if (ImGui::BeginTabItem("Scatter Plots")) {
             renderScatterPlots();
             ImGui::EndTabItem();
         }
-        
+
         if (ImGui::BeginTabItem("Distributions")) {
             renderDistributions();
             ImGui::EndTabItem();
         }
-        
-        if (ImGui::BeginTabItem("Top Opportunities")) {
-            renderTopOpportunities();
+
+        if (ImGui::BeginTabItem("Pairs")) {
+            renderPairsTable();
             ImGui::EndTabItem();
         }
-        
+
         if (ImGui::BeginTabItem("Pair Details")) {
             renderPairDetails();
             ImGui::EndTabItem();
         }
-        
+
         ImGui::EndTabBar();
     }
-    
+
     ImGui::End();
 }
 
 void CointegrationVisualizer::renderDashboard() {
     // Filters section
     renderFilters();
-    
+
     ImGui::Separator();
-    
+
     // Summary statistics
     ImGui::Text("Analysis Summary");
     ImGui::Columns(4, "SummaryColumns");
-    
+
     ImGui::Text("Total Pairs: %d", analysisResults.totalPairs);
     ImGui::NextColumn();
     ImGui::Text("Cointegrated: %d", analysisResults.cointegrated);
@@ -163,7 +180,7 @@ void CointegrationVisualizer::renderDashboard() {
     ImGui::NextColumn();
     ImGui::Text("Outliers: %d", analysisResults.outliers);
     ImGui::NextColumn();
-    
+
     ImGui::Text("Avg Sharpe: %.3f", analysisResults.avgSharpeRatio);
     ImGui::NextColumn();
     ImGui::Text("Avg Win Rate: %.1f%%", analysisResults.avgWinRate * 100);
@@ -171,217 +188,216 @@ void CointegrationVisualizer::renderDashboard() {
     ImGui::Text("Avg Half-Life: %.1f days", analysisResults.avgHalfLife);
     ImGui::NextColumn();
     ImGui::Text("Status: %s", loadingStatus.c_str());
-    
+
     ImGui::Columns(1);
     ImGui::Separator();
-    
+
     // Quick overview charts
     if (ImPlot::BeginPlot("Risk vs Return Overview", ImVec2(-1, 300))) {
         ImPlot::SetupAxes("Sharpe Ratio", "Expected Return");
-        
-        auto filtered = getFilteredData();
-        std::vector<float> x_data, y_data;
-        for (const auto& pair : filtered) {
-            x_data.push_back(pair.sharpe_ratio);
-            y_data.push_back(pair.expected_return);
-        }
-        
-        if (!x_data.empty()) {
-            ImPlot::PlotScatter("Pairs", x_data.data(), y_data.data(), x_data.size());
+
+        if (!sharpe_ratios.empty()) {
+            plotScatter("Pairs", sharpe_ratios, expected_returns);
         }
-        
+
         ImPlot::EndPlot();
     }
 }
 
 void CointegrationVisualizer::renderScatterPlots() {
-    auto filtered = getFilteredData();
-    
-    if (filtered.empty()) {
+    if (visibleRows.empty()) {
         ImGui::Text("No data matches current filters.");
         return;
     }
-    
-    // Prepare data vectors
-    std::vector<float> adf_data, p_data, half_life_data, sharpe_data, return_data, z_data;
-    
-    for (const auto& pair : filtered) {
-        adf_data.push_back(pair.adf_statistic);
-        p_data.push_back(pair.p_value);
-        half_life_data.push_back(pair.half_life_days);
-        sharpe_data.push_back(pair.sharpe_ratio);
-        return_data.push_back(pair.expected_return);
-        z_data.push_back(pair.z_score);
+    if (visibleRows.size() > kMaxScatterPoints) {
+        ImGui::Text("Plotting an even sample of %zu of %zu pairs", kMaxScatterPoints, visibleRows.size());
     }
-    
+
     // ADF vs P-Value plot
     if (ImPlot::BeginPlot("Statistical Significance", ImVec2(-1, 250))) {
         ImPlot::SetupAxes("ADF Statistic", "P-Value");
-        ImPlot::PlotScatter("Pairs", adf_data.data(), p_data.data(), adf_data.size());
-        
+        plotScatter("Pairs", adf_stats, p_values);
+
         // Add significance threshold line
         float sig_line_x[] = {-6, 0};
         float sig_line_y[] = {0.05f, 0.05f};
         ImPlot::PlotLine("5% Significance", sig_line_x, sig_line_y, 2);
-        
+
         ImPlot::EndPlot();
     }
-    
+
     // Risk vs Return plot
     if (ImPlot::BeginPlot("Risk vs Return", ImVec2(-1, 250))) {
         ImPlot::SetupAxes("Sharpe Ratio", "Expected Return");
-        ImPlot::PlotScatter("Pairs", sharpe_data.data(), return_data.data(), sharpe_data.size());
+        plotScatter("Pairs", sharpe_ratios, expected_returns);
         ImPlot::EndPlot();
     }
-    
+
     // Half-Life vs Z-Score plot
     if (ImPlot::BeginPlot("Mean Reversion Analysis", ImVec2(-1, 250))) {
         ImPlot::SetupAxes("Half-Life (Days)", "Current Z-Score");
-        ImPlot::PlotScatter("Pairs", half_life_data.data(), z_data.data(), half_life_data.size());
-        
+        plotScatter("Pairs", half_lives, z_scores);
+
         // Add entry/exit threshold lines
         float entry_line_x[] = {0, 200};
         float entry_pos[] = {2.0f, 2.0f};
         float entry_neg[] = {-2.0f, -2.0f};
         ImPlot::PlotLine("Entry Threshold +", entry_line_x, entry_pos, 2);
         ImPlot::PlotLine("Entry Threshold -", entry_line_x, entry_neg, 2);
-        
+
         ImPlot::EndPlot();
     }
 }
 
 void CointegrationVisualizer::renderDistributions() {
-    auto filtered = getFilteredData();
-    
-    if (filtered.empty()) {
+    if (visibleRows.empty()) {
         ImGui::Text("No data matches current filters.");
         return;
     }
-    
-    // Prepare histogram data
-    std::vector<float> sharpe_data, win_rate_data, half_life_data;
-    
-    for (const auto& pair : filtered) {
-        sharpe_data.push_back(pair.sharpe_ratio);
-        win_rate_data.push_back(pair.win_rate);
-        half_life_data.push_back(pair.half_life_days);
-    }
-    
+
     // Sharpe Ratio Distribution
     if (ImPlot::BeginPlot("Sharpe Ratio Distribution", ImVec2(-1, 200))) {
         ImPlot::SetupAxes("Sharpe Ratio", "Frequency");
-        ImPlot::PlotHistogram("Distribution", sharpe_data.data(), sharpe_data.size(), 20);
+        ImPlot::PlotHistogram("Distribution", sharpe_ratios.data(), sharpe_ratios.size(), 20);
         ImPlot::EndPlot();
     }
-    
+
     // Win Rate Distribution
     if (ImPlot::BeginPlot("Win Rate Distribution", ImVec2(-1, 200))) {
         ImPlot::SetupAxes("Win Rate", "Frequency");
-        ImPlot::PlotHistogram("Distribution", win_rate_data.data(), win_rate_data.size(), 20);
+        ImPlot::PlotHistogram("Distribution", win_rates.data(), win_rates.size(), 20);
         ImPlot::EndPlot();
     }
-    
+
     // Half-Life Distribution
     if (ImPlot::BeginPlot("Half-Life Distribution", ImVec2(-1, 200))) {
         ImPlot::SetupAxes("Half-Life (Days)", "Frequency");
-        ImPlot::PlotHistogram("Distribution", half_life_data.data(), half_life_data.size(), 20);
+        ImPlot::PlotHistogram("Distribution", half_lives.data(), half_lives.size(), 20);
         ImPlot::EndPlot();
     }
 }
 
-void CointegrationVisualizer::renderTopOpportunities() {
-    auto filtered = getFilteredData();
-    
-    // Sort by Sharpe ratio descending
-    std::sort(filtered.begin(), filtered.end(), 
-              [](const CointegrationData& a, const CointegrationData& b) {
-                  return a.sharpe_ratio > b.sharpe_ratio;
-              });
-    
-    ImGui::Text("Top Trading Opportunities (Sorted by Sharpe Ratio)");
+void CointegrationVisualizer::renderPairsTable() {
+    ImGui::Text("%zu of %zu pairs match the filters; click a header to sort, a row to select",
+                visibleRows.size(), pairs.size());
     ImGui::Separator();
-    
-    if (ImGui::BeginTable("TopPairs", 8, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
-        ImGui::TableSetupColumn("Pair");
-        ImGui::TableSetupColumn("Grade");
-        ImGui::TableSetupColumn("Sharpe");
-        ImGui::TableSetupColumn("Win Rate");
-        ImGui::TableSetupColumn("Z-Score");
-        ImGui::TableSetupColumn("Half-Life");
-        ImGui::TableSetupColumn("Expected Return");
-        ImGui::TableSetupColumn("Status");
+
+    const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY |
+                                  ImGuiTableFlags_Sortable;
+    if (ImGui::BeginTable("Pairs", 8, flags)) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Pair", 0, 0.0f, PairTable::SortPair);
+        ImGui::TableSetupColumn("Grade", 0, 0.0f, PairTable::SortGrade);
+        ImGui::TableSetupColumn("Sharpe", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending,
+                                0.0f, PairTable::SortSharpe);
+        ImGui::TableSetupColumn("Win Rate", ImGuiTableColumnFlags_PreferSortDescending, 0.0f, PairTable::SortWinRate);
+        ImGui::TableSetupColumn("Z-Score", 0, 0.0f, PairTable::SortZScore);
+        ImGui::TableSetupColumn("Half-Life", 0, 0.0f, PairTable::SortHalfLife);
+        ImGui::TableSetupColumn("Expected Return", ImGuiTableColumnFlags_PreferSortDescending, 0.0f,
+                                PairTable::SortExpectedReturn);
+        ImGui::TableSetupColumn("Status", ImGuiTableColumnFlags_NoSort);
         ImGui::TableHeadersRow();
-        
-        for (size_t i = 0; i < std::min(filtered.size(), size_t(20)); ++i) {
-            const auto& pair = filtered[i];
-            ImGui::TableNextRow();
-            
-            ImGui::TableNextColumn();
-            ImGui::Text("%s", pair.getPairName().c_str());
-            
-            ImGui::TableNextColumn();
-            ImGui::Text("%s", pair.grade.c_str());
-            
-            ImGui::TableNextColumn();
-            ImGui::Text("%.3f", pair.sharpe_ratio);
-            
-            ImGui::TableNextColumn();
-            ImGui::Text("%.1f%%", pair.win_rate * 100);
-            
-            ImGui::TableNextColumn();
-            if (abs(pair.z_score) > 2.0f) {
-                ImGui::TextColored(ImVec4(1, 0, 0, 1), "%.2f", pair.z_score);
-            } else {
-                ImGui::Text("%.2f", pair.z_score);
+
+        // Sorting walks a precomputed order, so it is applied right away
+        if (ImGuiTableSortSpecs* specs = ImGui::TableGetSortSpecs()) {
+            if (specs->SpecsDirty && specs->SpecsCount > 0) {
+                sortKey = static_cast<PairTable::SortKey>(specs->Specs[0].ColumnUserID);
+                sortDescending = specs->Specs[0].SortDirection == ImGuiSortDirection_Descending;
+                applyFilters();
             }
-            
-            ImGui::TableNextColumn();
-            ImGui::Text("%.1f", pair.half_life_days);
-            
-            ImGui::TableNextColumn();
-            ImGui::Text("%.4f", pair.expected_return);
-            
-            ImGui::TableNextColumn();
-            if (pair.isOutlier()) {
-                ImGui::TextColored(ImVec4(1, 1, 0, 1), "Outlier");
-            } else if (pair.isHighQuality()) {
-                ImGui::TextColored(ImVec4(0, 1, 0, 1), "High Quality");
-            } else {
-                ImGui::Text("Normal");
+            specs->SpecsDirty = false;
+        }
+
+        // Only the rows in view are submitted
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(visibleRows.size()));
+        while (clipper.Step()) {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                const uint32_t row = visibleRows[i];
+                const float z_score = pairs.metric(PairTable::ZScore)[row];
+                ImGui::TableNextRow();
+                ImGui::PushID(static_cast<int>(row));
+
+                ImGui::TableNextColumn();
+                if (ImGui::Selectable(pairs.pairName(row).c_str(), selectedPair == static_cast<int>(row),
+                                      ImGuiSelectableFlags_SpanAllColumns)) {
+                    selectedPair = static_cast<int>(row);
+                }
+
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", pairs.grade(row).c_str());
+
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", pairs.metric(PairTable::SharpeRatio)[row]);
+
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f%%", pairs.metric(PairTable::WinRate)[row] * 100);
+
+                ImGui::TableNextColumn();
+                if (std::abs(z_score) > 2.0f) {
+                    ImGui::TextColored(ImVec4(1, 0, 0, 1), "%.2f", z_score);
+                } else {
+                    ImGui::Text("%.2f", z_score);
+                }
+
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", pairs.metric(PairTable::HalfLifeDays)[row]);
+
+                ImGui::TableNextColumn();
+                ImGui::Text("%.4f", pairs.metric(PairTable::ExpectedReturn)[row]);
+
+                ImGui::TableNextColumn();
+                if (pairs.isOutlier(row)) {
+                    ImGui::TextColored(ImVec4(1, 1, 0, 1), "Outlier");
+                } else if (pairs.isHighQuality(row)) {
+                    ImGui::TextColored(ImVec4(0, 1, 0, 1), "High Quality");
+                } else {
+                    ImGui::Text("Normal");
+                }
+
+                ImGui::PopID();
             }
         }
-        
+
         ImGui::EndTable();
     }
 }
 
+void CointegrationVisualizer::renderPairSelector(float height) {
+    ImGui::BeginChild("PairSelect", ImVec2(0, height), true);
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(visibleRows.size()));
+    while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+            const uint32_t row = visibleRows[i];
+            ImGui::PushID(static_cast<int>(row));
+            if (ImGui::Selectable(pairs.pairName(row).c_str(), selectedPair == static_cast<int>(row))) {
+                selectedPair = static_cast<int>(row);
+            }
+            ImGui::PopID();
+        }
+    }
+    ImGui::EndChild();
+}
+
 void CointegrationVisualizer::renderPairDetails() {
-    auto filtered = getFilteredData();
-    
-    if (filtered.empty()) {
+    if (visibleRows.empty()) {
         ImGui::Text("No pairs match current filters.");
         return;
     }
-    
-    // Pair selection
-    std::vector<const char*> pair_names;
-    for (const auto& pair : filtered) {
-        pair_names.push_back(pair.getPairName().c_str());
-    }
-    
+
+    // Pair selection, in the order of the Pairs table
     ImGui::Text("Select Pair for Detailed Analysis:");
-    if (ImGui::Combo("##PairSelect", &selectedPair, pair_names.data(), pair_names.size())) {
-        selectedPair = std::min(selectedPair, (int)filtered.size() - 1);
-    }
-    
-    if (selectedPair >= 0 && selectedPair < filtered.size()) {
-        const auto& pair = filtered[selectedPair];
-        
+    renderPairSelector(150.0f);
+
+    if (selectedPair >= 0 && static_cast<size_t>(selectedPair) < pairs.size()) {
+        const CointegrationData pair = pairs.row(static_cast<uint32_t>(selectedPair));
+
         ImGui::Separator();
         ImGui::Text("Detailed Analysis: %s", pair.getPairName().c_str());
-        
+
         ImGui::Columns(2, "DetailColumns");
-        
+
         // Left column - Basic info
         ImGui::Text("Basic Information");
         ImGui::Separator();
@@ -389,7 +405,7 @@ void CointegrationVisualizer::renderPairDetails() {
         ImGui::Text("Stock 2: %s", pair.stock2.c_str());
         ImGui::Text("Grade: %s", pair.grade.c_str());
         ImGui::Text("Cointegrated: %s", pair.is_cointegrated ? "Yes" : "No");
-        
+
         ImGui::Text("\nStatistical Tests");
         ImGui::Separator();
         ImGui::Text("ADF Statistic: %.4f", pair.adf_statistic);
@@ -397,9 +413,9 @@ void CointegrationVisualizer::renderPairDetails() {
         ImGui::Text("Critical 1%%: %.4f", pair.critical_1pct);
         ImGui::Text("Critical 5%%: %.4f", pair.critical_5pct);
         ImGui::Text("Critical 10%%: %.4f", pair.critical_10pct);
-        
+
         ImGui::NextColumn();
-        
+
         // Right column - Trading info
         ImGui::Text("Trading Metrics");
         ImGui::Separator();
@@ -407,7 +423,7 @@ void CointegrationVisualizer::renderPairDetails() {
         ImGui::Text("Sharpe Ratio: %.4f", pair.sharpe_ratio);
         ImGui::Text("Win Rate: %.1f%%", pair.win_rate * 100);
         ImGui::Text("Historical Trades: %d", pair.historical_trades);
-        
+
         ImGui::Text("\nSpread Analysis");
         ImGui::Separator();
         ImGui::Text("Current Z-Score: %.4f", pair.z_score);
@@ -415,7 +431,7 @@ void CointegrationVisualizer::renderPairDetails() {
         ImGui::Text("Hedge Ratio: %.6f", pair.hedge_ratio);
         ImGui::Text("Entry Threshold: %.2f", pair.entry_threshold);
         ImGui::Text("Exit Threshold: %.2f", pair.exit_threshold);
-        
+
         ImGui::Text("\nSpread Statistics");
         ImGui::Separator();
         ImGui::Text("Mean: %.6f", pair.spread_mean);
@@ -423,7 +439,7 @@ void CointegrationVisualizer::renderPairDetails() {
         ImGui::Text("Current: %.6f", pair.current_spread);
         ImGui::Text("Max: %.6f", pair.max_spread);
         ImGui::Text("Min: %.6f", pair.min_spread);
-        
+
         ImGui::Columns(1);
     }
 }
@@ -431,110 +447,112 @@ void CointegrationVisualizer::renderPairDetails() {
 void CointegrationVisualizer::renderFilters() {
     ImGui::Text("Filters");
     ImGui::Separator();
-    
+
     ImGui::Columns(4, "FilterColumns");
-    
-    ImGui::Checkbox("Only Cointegrated", &showOnlyCointegrated);
+
+    ImGui::Checkbox("Only Cointegrated", &filters.onlyCointegrated);
     ImGui::NextColumn();
-    ImGui::Checkbox("Only High Quality", &showOnlyHighQuality);
+    ImGui::Checkbox("Only High Quality", &filters.onlyHighQuality);
     ImGui::NextColumn();
-    ImGui::Checkbox("Only Outliers", &showOnlyOutliers);
+    ImGui::Checkbox("Only Outliers", &filters.onlyOutliers);
     ImGui::NextColumn();
-    
-    // Grade filter
-    const char* grades[] = {"All", "A", "B", "C"};
-    static int grade_idx = 0;
-    if (ImGui::Combo("Grade", &grade_idx, grades, 4)) {
-        gradeFilter = grades[grade_idx];
+
+    // Grade filter, over the grades present in the data
+    const std::vector<std::string>& grades = pairs.grades();
+    const char* current = filters.grade >= 0 ? grades[filters.grade].c_str() : "All";
+    if (ImGui::BeginCombo("Grade", current)) {
+        if (ImGui::Selectable("All", filters.grade < 0)) {
+            filters.grade = -1;
+        }
+        for (size_t g = 0; g < grades.size(); ++g) {
+            if (ImGui::Selectable(grades[g].c_str(), filters.grade == static_cast<int>(g))) {
+                filters.grade = static_cast<int>(g);
+            }
+        }
+        ImGui::EndCombo();
     }
-    
+
     ImGui::NextColumn();
-    ImGui::SliderFloat("Min Sharpe", &minSharpeRatio, -2.0f, 5.0f);
+    ImGui::SliderFloat("Min Sharpe", &filters.minSharpeRatio, -2.0f, 5.0f);
     ImGui::NextColumn();
-    ImGui::SliderFloat("Max Half-Life", &maxHalfLife, 1.0f, 500.0f);
-    
+    ImGui::SliderFloat("Max Half-Life", &filters.maxHalfLife, 1.0f, 500.0f);
+
     ImGui::Columns(1);
-    
-    if (ImGui::Button("Apply Filters")) {
-        applyFilters();
-    }
-    ImGui::SameLine();
+
     if (ImGui::Button("Reset Filters")) {
-        showOnlyCointegrated = false;
-        showOnlyHighQuality = false;
-        showOnlyOutliers = false;
-        gradeFilter = "All";
-        minSharpeRatio = 0.0f;
-        maxHalfLife = 1000.0f;
+        filters = PairFilter{};
+    }
+
+    // Filtering is a pass over the bitmaps, so changes apply as they are made
+    if (filters != appliedFilters) {
         applyFilters();
     }
 }
 
 void CointegrationVisualizer::updateAnalysis() {
-    analysisResults.totalPairs = pairsData.size();
-    analysisResults.cointegrated = 0;
-    analysisResults.highQuality = 0;
-    analysisResults.outliers = 0;
-    
-    float sumSharpe = 0, sumWinRate = 0, sumHalfLife = 0;
-    
-    for (const auto& pair : pairsData) {
-        if (pair.is_cointegrated) analysisResults.cointegrated++;
-        if (pair.isHighQuality()) analysisResults.highQuality++;
-        if (pair.isOutlier()) analysisResults.outliers++;
-        
-        sumSharpe += pair.sharpe_ratio;
-        sumWinRate += pair.win_rate;
-        sumHalfLife += pair.half_life_days;
-    }
-    
-    if (pairsData.size() > 0) {
-        analysisResults.avgSharpeRatio = sumSharpe / pairsData.size();
-        analysisResults.avgWinRate = sumWinRate / pairsData.size();
-        analysisResults.avgHalfLife = sumHalfLife / pairsData.size();
-    }
+    analysisResults = AnalysisResults{};
+    analysisResults.totalPairs = static_cast<int>(pairs.size());
+    analysisResults.cointegrated = static_cast<int>(pairs.cointegratedCount());
+    analysisResults.highQuality = static_cast<int>(pairs.highQualityCount());
+    analysisResults.outliers = static_cast<int>(pairs.outlierCount());
+
+    if (pairs.empty()) return;
+
+    double sumSharpe = 0, sumWinRate = 0, sumHalfLife = 0;
+    for (float value : pairs.metric(PairTable::SharpeRatio)) sumSharpe += value;
+    for (float value : pairs.metric(PairTable::WinRate)) sumWinRate += value;
+    for (float value : pairs.metric(PairTable::HalfLifeDays)) sumHalfLife += value;
+
+    analysisResults.avgSharpeRatio = static_cast<float>(sumSharpe / pairs.size());
+    analysisResults.avgWinRate = static_cast<float>(sumWinRate / pairs.size());
+    analysisResults.avgHalfLife = static_cast<float>(sumHalfLife / pairs.size());
 }
 
 void CointegrationVisualizer::applyFilters() {
-    // This function is called when filters change
-    // The actual filtering is done in getFilteredData()
+    pairs.select(filters, sortKey, sortDescending, visibleRows);
+    appliedFilters = filters;
+
+    auto gather = [&](PairTable::Metric metric, std::vector<float>& out) {
+        const std::vector<float>& values = pairs.metric(metric);
+        out.resize(visibleRows.size());
+        for (size_t i = 0; i < visibleRows.size(); ++i) {
+            out[i] = values[visibleRows[i]];
+        }
+    };
+    gather(PairTable::AdfStatistic, adf_stats);
+    gather(PairTable::PValue, p_values);
+    gather(PairTable::HalfLifeDays, half_lives);
+    gather(PairTable::ExpectedReturn, expected_returns);
+    gather(PairTable::SharpeRatio, sharpe_ratios);
+    gather(PairTable::ZScore, z_scores);
+    gather(PairTable::WinRate, win_rates);
 }
 
 std::vector<CointegrationData> CointegrationVisualizer::getFilteredData() const {
     std::vector<CointegrationData> filtered;
-    
-    for (const auto& pair : pairsData) {
-        // Apply filters
-        if (showOnlyCointegrated && !pair.is_cointegrated) continue;
-        if (showOnlyHighQuality && !pair.isHighQuality()) continue;
-        if (showOnlyOutliers && !pair.isOutlier()) continue;
-        if (gradeFilter != "All" && pair.grade != gradeFilter) continue;
-        if (pair.sharpe_ratio < minSharpeRatio) continue;
-        if (pair.half_life_days > maxHalfLife) continue;
-        
-        filtered.push_back(pair);
+    filtered.reserve(visibleRows.size());
+    for (uint32_t row : visibleRows) {
+        filtered.push_back(pairs.row(row));
     }
-    
     return filtered;
 }
 
 void CointegrationVisualizer::exportFilteredData(const std::string& filename) const {
-    auto filtered = getFilteredData();
-    
     std::ofstream file(filename);
     if (!file.is_open()) {
         std::cerr << "Could not open file for export: " << filename << std::endl;
         return;
     }
-    
+
     // Write header
     file << "Stock1,Stock2,ADF_Statistic,P_Value,Critical_1pct,Critical_5pct,Critical_10pct,";
     file << "Half_Life_Days,Hedge_Ratio,Spread_Mean,Spread_StdDev,Max_Spread,Min_Spread,";
     file << "Current_Spread,Z_Score,Grade,Is_Cointegrated,Entry_Threshold,Exit_Threshold,";
     file << "Expected_Return,Sharpe_Ratio,Historical_Trades,Win_Rate\n";
-    
-    // Write data
-    for (const auto& pair : filtered) {
+
+    // Write data, in the order of the Pairs table
+    for (uint32_t row : visibleRows) {
+        const CointegrationData pair = pairs.row(row);
         file << pair.stock1 << "," << pair.stock2 << "," << pair.adf_statistic << ",";
         file << pair.p_value << "," << pair.critical_1pct << "," << pair.critical_5pct << ",";
         file << pair.critical_10pct << "," << pair.half_life_days << "," << pair.hedge_ratio << ",";
@@ -544,13 +562,15 @@ void CointegrationVisualizer::exportFilteredData(const std::string& filename) co
         file << pair.entry_threshold << "," << pair.exit_threshold << "," << pair.expected_return << ",";
         file << pair.sharpe_ratio << "," << pair.historical_trades << "," << pair.win_rate << "\n";
     }
-    
+
     file.close();
-    std::cout << "Exported " << filtered.size() << " pairs to " << filename << std::endl;
+    std::cout << "Exported " << visibleRows.size() << " pairs to " << filename << std::endl;
 }
 
 void CointegrationVisualizer::clearData() {
-    pairsData.clear();
+    pairs = PairTable{};
     dataLoaded = false;
-    selectedPair = 0;
+    selectedPair = -1;
+    filters.grade = -1;
+    applyFilters();
 }
@@ -0,0 +1,324 @@
+#include "Downsampler.h"
+#include "implot.h"
+#include "implot_internal.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// A pyramid only describes the column it was built from
+bool matches(const MinMaxPyramid* pyramid, size_t count) {
+    if (!pyramid || pyramid->empty()) return false;
+    return pyramid->mins(0).size() == (count + MinMaxPyramid::kBaseBucket - 1) / MinMaxPyramid::kBaseBucket;
+}
+
+void copyRaw(const std::vector<float>& values, size_t first, size_t last, DecimatedSeries& out) {
+    out.x.resize(last - first);
+    for (size_t i = first; i < last; ++i) out.x[i - first] = static_cast<float>(i);
+    out.y.assign(values.begin() + first, values.begin() + last);
+}
+
+// Min and max of values[begin, end), NaN ignored (NaN when all are NaN)
+void scanMinMax(const float* values, size_t begin, size_t end, float& lo, float& hi) {
+    lo = NAN;
+    hi = NAN;
+    for (size_t i = begin; i < end; ++i) {
+        lo = std::fmin(lo, values[i]);
+        hi = std::fmax(hi, values[i]);
+    }
+}
+
+}
+
+void MinMaxPyramid::build(const float* values, size_t count) {
+    mins_.clear();
+    maxs_.clear();
+    count_ = 0;
+    extend(values, count);
+}
+
+void MinMaxPyramid::extend(const float* values, size_t count) {
+    if (count < count_) {
+        build(values, count);
+        return;
+    }
+    if (count == count_) return;
+    if (mins_.empty()) {
+        mins_.emplace_back();
+        maxs_.emplace_back();
+    }
+
+    // The bucket the old tail ended in is rescanned, every later one is new
+    size_t first = count_ / kBaseBucket;
+    const size_t buckets = (count + kBaseBucket - 1) / kBaseBucket;
+    mins_[0].resize(buckets);
+    maxs_[0].resize(buckets);
+    for (size_t b = first; b < buckets; ++b) {
+        scanMinMax(values, b * kBaseBucket, std::min(count, (b + 1) * kBaseBucket), mins_[0][b], maxs_[0][b]);
+    }
+
+    // Each level merges pairs of the one below until one bucket is left;
+    // only the merges above the changed buckets are redone
+    for (size_t level = 1; mins_[level - 1].size() > 1; ++level) {
+        if (level == mins_.size()) {
+            mins_.emplace_back();
+            maxs_.emplace_back();
+        }
+        const std::vector<float>& belowMin = mins_[level - 1];
+        const std::vector<float>& belowMax = maxs_[level - 1];
+        const size_t n = (belowMin.size() + 1) / 2;
+        first /= 2;
+        mins_[level].resize(n);
+        maxs_[level].resize(n);
+        for (size_t b = first; b < n; ++b) {
+            const size_t pair = std::min(2 * b + 1, belowMin.size() - 1);
+            mins_[level][b] = std::fmin(belowMin[2 * b], belowMin[pair]);
+            maxs_[level][b] = std::fmax(belowMax[2 * b], belowMax[pair]);
+        }
+    }
+    count_ = count;
+}
+
+size_t MinMaxPyramid::levelFor(size_t bucket) const {
+    for (size_t level = 0; level < levels(); ++level) {
+        if (bucketSize(level) >= bucket) return level;
+    }
+    return levels();
+}
+
+size_t Downsampler::pointBudget(float pixelWidth) {
+    const size_t points = pixelWidth > 0.0f ? static_cast<size_t>(2.0f * pixelWidth) : kMaxPoints;
+    return std::clamp(points, kMinPoints, kMaxPoints);
+}
+
+PlotWindow Downsampler::currentWindow(size_t count) {
+    PlotWindow window;
+    window.budget = pointBudget(ImPlot::GetPlotSize().x);
+    window.last = count;
+
+    // A fit frame sizes the axes from what gets plotted, so plot everything
+    const ImPlotPlot* plot = ImPlot::GetCurrentPlot();
+    if (plot && plot->Axes[ImAxis_X1].FitThisFrame) return window;
+
+    // One bar beyond each edge so lines run to the border
+    const ImPlotRect limits = ImPlot::GetPlotLimits();
+    const double lo = std::floor(limits.X.Min) - 1.0;
+    const double hi = std::ceil(limits.X.Max) + 2.0;
+    window.first = lo <= 0.0 ? 0 : std::min(count, static_cast<size_t>(lo));
+    window.last = hi <= 0.0 ? 0 : std::min(count, static_cast<size_t>(hi));
+    if (window.first > window.last) window.first = window.last;
+    return window;
+}
+
+size_t Downsampler::bucketFor(size_t count, size_t budget, bool pairs, const MinMaxPyramid*& pyramid,
+                              size_t& level) {
+    const size_t buckets = std::max<size_t>(1, pairs ? budget / 2 : budget);
+    const size_t bucket = (count + buckets - 1) / buckets;
+    if (pyramid && bucket >= MinMaxPyramid::kBaseBucket) {
+        level = pyramid->levelFor(bucket);
+        if (level < pyramid->levels()) return pyramid->bucketSize(level);
+    }
+    pyramid = nullptr;
+    level = 0;
+    return bucket;
+}
+
+void Downsampler::decimate(const std::vector<float>& values, const MinMaxPyramid* pyramid,
+                           const PlotWindow& window, DecimatedSeries& out) {
+    out.x.clear();
+    out.y.clear();
+    out.width = 1.0;
+    const size_t last = std::min(window.last, values.size());
+    const size_t first = std::min(window.first, last);
+    const size_t count = last - first;
+    if (count <= window.budget) {
+        copyRaw(values, first, last, out);
+        return;
+    }
+
+    // Moderately dense: LTTB keeps the shape with few points
+    if (count <= window.budget * MinMaxPyramid::kBaseBucket) {
+        std::vector<float> x(count);
+        for (size_t i = 0; i < count; ++i) x[i] = static_cast<float>(first + i);
+        lttb(x.data(), values.data() + first, count, window.budget, out.x, out.y);
+        return;
+    }
+
+    // Dense: the min and max of each bucket, one vertical stroke per bucket
+    if (!matches(pyramid, values.size())) pyramid = nullptr;
+    size_t level = 0;
+    const size_t bucket = bucketFor(count, window.budget, true, pyramid, level);
+    const size_t endBucket = (last + bucket - 1) / bucket;
+    out.x.reserve(2 * (endBucket - first / bucket));
+    out.y.reserve(2 * (endBucket - first / bucket));
+    for (size_t b = first / bucket; b < endBucket; ++b) {
+        float lo, hi;
+        if (pyramid) {
+            lo = pyramid->mins(level)[b];
+            hi = pyramid->maxs(level)[b];
+        } else {
+            scanMinMax(values.data(), b * bucket, std::min(values.size(), (b + 1) * bucket), lo, hi);
+        }
+        if (std::isnan(lo)) continue;
+        const float x = static_cast<float>(b * bucket) + 0.5f * static_cast<float>(bucket);
+        out.x.push_back(x);
+        out.y.push_back(lo);
+        out.x.push_back(x);
+        out.y.push_back(hi);
+    }
+}
+
+void Downsampler::decimateBars(const std::vector<float>& values, const MinMaxPyramid* pyramid,
+                               const PlotWindow& window, DecimatedSeries& out) {
+    out.x.clear();
+    out.y.clear();
+    out.width = 1.0;
+    const size_t last = std::min(window.last, values.size());
+    const size_t first = std::min(window.first, last);
+    if (last - first <= window.budget) {
+        copyRaw(values, first, last, out);
+        return;
+    }
+
+    if (!matches(pyramid, values.size())) pyramid = nullptr;
+    size_t level = 0;
+    const size_t bucket = bucketFor(last - first, window.budget, false, pyramid, level);
+    out.width = static_cast<double>(bucket);
+    for (size_t b = first / bucket; b < (last + bucket - 1) / bucket; ++b) {
+        float lo, hi;
+        if (pyramid) {
+            hi = pyramid->maxs(level)[b];
+        } else {
+            scanMinMax(values.data(), b * bucket, std::min(values.size(), (b + 1) * bucket), lo, hi);
+        }
+        if (std::isnan(hi)) continue;
+        out.x.push_back(static_cast<float>(b * bucket) + 0.5f * static_cast<float>(bucket));
+        out.y.push_back(hi);
+    }
+}
+
+void Downsampler::aggregateOHLC(const std::vector<float>& open, const std::vector<float>& high,
+                                const std::vector<float>& low, const std::vector<float>& close,
+                                const MinMaxPyramid* highPyramid, const MinMaxPyramid* lowPyramid,
+                                const PlotWindow& window, OHLCBuckets& out) {
+    out.x.clear();
+    out.open.clear();
+    out.high.clear();
+    out.low.clear();
+    out.close.clear();
+    out.width = 1.0;
+    const size_t size = std::min({open.size(), high.size(), low.size(), close.size()});
+    const size_t last = std::min(window.last, size);
+    const size_t first = std::min(window.first, last);
+    if (last - first <= window.budget) {
+        for (size_t i = first; i < last; ++i) {
+            out.x.push_back(static_cast<float>(i));
+            out.open.push_back(open[i]);
+            out.high.push_back(high[i]);
+            out.low.push_back(low[i]);
+            out.close.push_back(close[i]);
+        }
+        return;
+    }
+
+    const bool usePyramids = matches(highPyramid, high.size()) && matches(lowPyramid, low.size()) &&
+                             high.size() == size && low.size() == size;
+    size_t level = 0;
+    const MinMaxPyramid* levels = usePyramids ? highPyramid : nullptr;
+    const size_t bucket = bucketFor(last - first, window.budget, false, levels, level);
+    out.width = static_cast<double>(bucket);
+    for (size_t b = first / bucket; b < (last + bucket - 1) / bucket; ++b) {
+        const size_t begin = b * bucket;
+        const size_t end = std::min(size, begin + bucket);
+
+        // First open and last close of the bucket's bars
+        size_t o = begin;
+        while (o < end && std::isnan(open[o])) ++o;
+        size_t c = end;
+        while (c > begin && std::isnan(close[c - 1])) --c;
+        if (o == end || c == begin) continue;
+
+        float hi, lo, unused;
+        if (levels) {
+            hi = highPyramid->maxs(level)[b];
+            lo = lowPyramid->mins(level)[b];
+        } else {
+            scanMinMax(high.data(), begin, end, unused, hi);
+            scanMinMax(low.data(), begin, end, lo, unused);
+        }
+        out.x.push_back(static_cast<float>(begin) + 0.5f * static_cast<float>(bucket));
+        out.open.push_back(open[o]);
+        out.high.push_back(hi);
+        out.low.push_back(lo);
+        out.close.push_back(close[c - 1]);
+    }
+}
+
+void Downsampler::lttb(const float* x, const float* y, size_t count, size_t budget,
+                       std::vector<float>& outX, std::vector<float>& outY) {
+    outX.clear();
+    outY.clear();
+    std::vector<float> px;
+    std::vector<float> py;
+    px.reserve(count);
+    py.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (std::isnan(y[i])) continue;
+        px.push_back(x[i]);
+        py.push_back(y[i]);
+    }
+    const size_t n = px.size();
+    if (n <= budget || budget < 3) {
+        outX = std::move(px);
+        outY = std::move(py);
+        return;
+    }
+
+    outX.reserve(budget);
+    outY.reserve(budget);
+    outX.push_back(px[0]);
+    outY.push_back(py[0]);
+
+    // Buckets of the points strictly between the first and the last
+    const double every = static_cast<double>(n - 2) / static_cast<double>(budget - 2);
+    size_t selected = 0;
+    for (size_t b = 0; b < budget - 2; ++b) {
+        const size_t begin = static_cast<size_t>(b * every) + 1;
+        const size_t end = std::min(n - 1, static_cast<size_t>((b + 1) * every) + 1);
+
+        // Average of the next bucket (the last point for the final bucket)
+        const size_t nextBegin = end;
+        const size_t nextEnd = std::min(n, static_cast<size_t>((b + 2) * every) + 1);
+        double avgX = 0.0, avgY = 0.0;
+        for (size_t i = nextBegin; i < nextEnd; ++i) {
+            avgX += px[i];
+            avgY += py[i];
+        }
+        const size_t nextCount = nextEnd > nextBegin ? nextEnd - nextBegin : 0;
+        if (nextCount > 0) {
+            avgX /= nextCount;
+            avgY /= nextCount;
+        } else {
+            avgX = px[n - 1];
+            avgY = py[n - 1];
+        }
+
+        // Point of this bucket spanning the largest triangle
+        const double ax = px[selected], ay = py[selected];
+        double bestArea = -1.0;
+        size_t best = begin;
+        for (size_t i = begin; i < end; ++i) {
+            const double area = std::fabs((ax - avgX) * (py[i] - ay) - (ax - px[i]) * (avgY - ay));
+            if (area > bestArea) {
+                bestArea = area;
+                best = i;
+            }
+        }
+        outX.push_back(px[best]);
+        outY.push_back(py[best]);
+        selected = best;
+    }
+
+    outX.push_back(px[n - 1]);
+    outY.push_back(py[n - 1]);
+}
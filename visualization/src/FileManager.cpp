@@ -1,10 +1,64 @@
 #include "FileManager.h"
-#include <fstream>
-#include <sstream>
+#include "CsvParsing.h"
+#include "csv_scanner.h"
+#include "mapped_file.h"
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
+#include <thread>
 #include <dirent.h>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+namespace {
+std::string symbolFromFilename(const std::string& filename) {
+    std::string symbol = filename;
+    size_t lastSlash = symbol.find_last_of("/\\");
+    if (lastSlash != std::string::npos) {
+        symbol = symbol.substr(lastSlash + 1);
+    }
+    size_t featuresPos = symbol.find("_features.csv");
+    if (featuresPos != std::string::npos) {
+        symbol = symbol.substr(0, featuresPos);
+    }
+    return symbol;
+}
+
+off_t fileSize(const std::string& path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 ? info.st_size : 0;
+}
+
+// Device and inode, which change when a file is replaced rather than written
+uint64_t fileIdentity(const std::string& path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) return 0;
+    return static_cast<uint64_t>(info.st_dev) << 40 ^ static_cast<uint64_t>(info.st_ino);
+}
+
+bool isFeatureFile(std::string_view filename) {
+    return filename.size() > 13 && filename.substr(filename.size() - 13) == "_features.csv";
+}
+
+// How often the follower looks for a stop request, and polls without inotify
+constexpr auto kFollowInterval = std::chrono::milliseconds(250);
+}
+
+const std::string* StringPool::intern(std::string_view text) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return &*strings_.emplace(text).first;
+}
+
+FileManager::~FileManager() {
+    cancel();
+}
 
 std::vector<std::string> FileManager::getCSVFiles(const std::string& directory) {
     std::vector<std::string> csvFiles;
@@ -36,8 +90,7 @@ std::vector<std::string> FileManager::getCSVFiles(const std::string& directory)
         }
         
         // Check if file ends with _features.csv
-        if (filename.length() > 13 && 
-            filename.substr(filename.length() - 13) == "_features.csv") {
+        if (isFeatureFile(filename)) {
             csvFiles.push_back(directory + "/" + filename);
         }
         
@@ -58,150 +111,208 @@ std::vector<std::string> FileManager::getCSVFiles(const std::string& directory)
     return csvFiles;
 }
 
-bool FileManager::loadCSVData(const std::string& filename, 
-                             std::map<std::string, std::vector<StockData>>& stockDataMap) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+bool FileManager::loadCSVData(const std::string& filename, StringPool& strings, StockData& data, CSVTail* tail,
+                              bool following) {
+    try {
+        MappedFile file(filename);
+        const char* p = file.data();
+        const char* end = p + file.size();
+        if (file.empty()) return false;
+        
+        // Columns are matched by header name, so files written with a
+        // feature selection load too; missing features read as 0
+        CSVTail layout;
+        layout.path = filename;
+        const auto all = data.columns();
+        const char* headerEnd = CSVScanner::find_line_end(p, end);
+        for (const char* field = p; field <= headerEnd;) {
+            const char* fieldEnd = headerEnd;
+            CSVScanner::find_delimiters(field, headerEnd, ',', &fieldEnd, 1);
+            const std::string_view name(field, static_cast<size_t>(fieldEnd - field));
+            const int index = static_cast<int>(layout.columns.size());
+            if (name == "datetime") layout.datetimeColumn = index;
+            if (name == "data_frequency") layout.frequencyColumn = index;
+            const auto column = std::find(all.begin(), all.end(), data.column(name));
+            layout.columns.push_back(column != all.end() ? static_cast<int>(column - all.begin()) : -1);
+            field = fieldEnd + 1;
+        }
+        
+        // A file being followed may end in a line still being written;
+        // it is read once its line break arrives
+        const char* rowsEnd = end;
+        if (following) {
+            while (rowsEnd > headerEnd && rowsEnd[-1] != '\n') --rowsEnd;
+        }
+        
+        const size_t lines = CSVScanner::count_lines(p, rowsEnd);
+        for (auto* column : all) column->reserve(lines);
+        data.date_ends.reserve(lines);
+        data.symbol = strings.intern(symbolFromFilename(filename));
+        parseRows(layout, nextLine(headerEnd, rowsEnd), rowsEnd, strings, data);
+        
+        for (auto* column : all) column->shrink_to_fit();
+        data.date_ends.shrink_to_fit();
+        data.buildLevelsOfDetail();
+        if (tail) {
+            layout.offset = static_cast<uint64_t>(rowsEnd - p);
+            layout.identity = fileIdentity(filename);
+            *tail = std::move(layout);
+        }
+        return !data.empty();
+    } catch (const std::exception& e) {
+        std::cerr << "Error loading " << filename << ": " << e.what() << std::endl;
         return false;
     }
-    
-    // Extract symbol from filename (remove path and _features.csv)
-    std::string symbolFromFile = filename;
-    size_t lastSlash = symbolFromFile.find_last_of("/\\");
-    if (lastSlash != std::string::npos) {
-        symbolFromFile = symbolFromFile.substr(lastSlash + 1);
-    }
-    size_t featuresPos = symbolFromFile.find("_features.csv");
-    if (featuresPos != std::string::npos) {
-        symbolFromFile = symbolFromFile.substr(0, featuresPos);
+}
+
+bool FileManager::loadAppendedRows(CSVTail& tail, StringPool& strings, StockData& rows) {
+    const int fd = open(tail.path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
     }
     
-    std::string line;
-    std::getline(file, line); // Skip header
+    // Only the bytes past what was parsed are read
+    std::vector<char> buffer;
+    if (static_cast<uint64_t>(info.st_size) > tail.offset) {
+        buffer.resize(static_cast<size_t>(info.st_size - tail.offset));
+        size_t filled = 0;
+        while (filled < buffer.size()) {
+            const ssize_t n = pread(fd, buffer.data() + filled, buffer.size() - filled,
+                                    static_cast<off_t>(tail.offset + filled));
+            if (n <= 0) break;
+            filled += static_cast<size_t>(n);
+        }
+        buffer.resize(filled);
+    }
+    close(fd);
     
-    int rowCount = 0;
-    float dateIndex = 0;
+    const char* p = buffer.data();
+    const char* end = p + buffer.size();
+    while (end > p && end[-1] != '\n') --end;
+    rows.symbol = strings.intern(symbolFromFilename(tail.path));
+    parseRows(tail, p, end, strings, rows);
+    tail.offset += static_cast<uint64_t>(end - p);
+    return true;
+}
+
+void FileManager::parseRows(const CSVTail& layout, const char* p, const char* end, StringPool& strings,
+                            StockData& data) {
+    const auto all = data.columns();
+    std::vector<std::vector<float>*> targets(layout.columns.size());
+    for (size_t c = 0; c < targets.size(); ++c) {
+        targets[c] = layout.columns[c] >= 0 ? all[layout.columns[c]] : nullptr;
+    }
+    const size_t delimiters = targets.size() - 1;
+    const int datetimeColumn = layout.datetimeColumn;
+    const int frequencyColumn = layout.frequencyColumn;
     
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        
-        std::stringstream ss(line);
-        std::string cell;
-        std::vector<std::string> row;
-        
-        // Parse CSV with comma separation
-        while (std::getline(ss, cell, ',')) {
-            row.push_back(cell);
-        }
-        
-        if (row.size() >= 64) { // All columns present (updated for new features)
-            try {
-                StockData data;
-                
-                data.datetime_index = dateIndex++;
-                data.date_string = row[0];
-                data.open = std::stof(row[1]);
-                data.high = std::stof(row[2]);
-                data.low = std::stof(row[3]);
-                data.close = std::stof(row[4]);
-                data.volume = std::stof(row[5]);
-                
-                // Use symbol from filename, not from CSV (more reliable)
-                data.symbol = symbolFromFile;
-                data.data_frequency = row[7]; // data_frequency column
-                
-                // Helper function to safely parse float values
-                auto safeStof = [](const std::string& str) -> float {
-                    if (str.empty()) return 0.0f;
-                    try {
-                        return std::stof(str);
-                    } catch (const std::exception&) {
-                        return 0.0f;
-                    }
-                };
-                
-                // Parse all the technical indicators (columns 8-28) with safe conversion
-                data.returns = safeStof(row[8]);
-                data.sma = safeStof(row[9]);
-                data.rsi = safeStof(row[10]);
-                data.volatility = safeStof(row[11]);
-                data.momentum = safeStof(row[12]);
-                data.spread = safeStof(row[13]);
-                data.internal_bar_strength = safeStof(row[14]);
-                data.skewness_30 = safeStof(row[15]);
-                data.kurtosis_30 = safeStof(row[16]);
-                data.log_pct_change_5 = safeStof(row[17]);
-                data.auto_correlation_50_10 = safeStof(row[18]);
-                data.kama_10_2_30 = safeStof(row[19]);
-                data.linear_slope_20 = safeStof(row[20]);
-                data.linear_slope_60 = safeStof(row[21]);
-                data.parkinson_volatility_20 = safeStof(row[22]);
-                data.volume_sma_20 = safeStof(row[23]);
-                data.velocity = safeStof(row[24]);
-                data.acceleration = safeStof(row[25]);
-                data.candle_way = safeStof(row[26]);
-                data.candle_filling = safeStof(row[27]);
-                data.candle_amplitude = safeStof(row[28]);
-                
-                // Parse new advanced features (columns 29-63) with safe conversion
-                data.z_score_20 = safeStof(row[29]);
-                data.percentile_rank_50 = safeStof(row[30]);
-                data.coefficient_of_variation_30 = safeStof(row[31]);
-                data.detrended_price_oscillator_20 = safeStof(row[32]);
-                data.hurst_exponent_100 = safeStof(row[33]);
-                data.garch_volatility_21 = safeStof(row[34]);
-                data.shannon_entropy_volume_10 = safeStof(row[35]);
-                data.chande_momentum_oscillator_14 = safeStof(row[36]);
-                data.aroon_oscillator_25 = safeStof(row[37]);
-                data.trix_15 = safeStof(row[38]);
-                data.vortex_indicator_14 = safeStof(row[39]);
-                data.supertrend_10_3 = safeStof(row[40]);
-                data.ichimoku_senkou_span_A_9_26 = safeStof(row[41]);
-                data.ichimoku_senkou_span_B_26_52 = safeStof(row[42]);
-                data.fisher_transform_10 = safeStof(row[43]);
-                data.volume_weighted_average_price_intraday = safeStof(row[44]);
-                data.volume_profile_high_volume_node_intraday = safeStof(row[45]);
-                data.volume_profile_low_volume_node_intraday = safeStof(row[46]);
-                data.on_balance_volume_sma_20 = safeStof(row[47]);
-                data.klinger_oscillator_34_55 = safeStof(row[48]);
-                data.money_flow_index_14 = safeStof(row[49]);
-                data.vwap_deviation_stddev_30 = safeStof(row[50]);
-                data.markov_regime_switching_garch_2_state = safeStof(row[51]);
-                data.adx_rating_14 = safeStof(row[52]);
-                data.chow_test_statistic_breakpoint_detection_50 = safeStof(row[53]);
-                data.market_regime_hmm_3_states_price_vol = safeStof(row[54]);
-                data.high_volatility_indicator_garch_threshold = safeStof(row[55]);
-                data.return_x_volume_interaction_10 = safeStof(row[56]);
-                data.volatility_x_rsi_interaction_14 = safeStof(row[57]);
-                data.price_to_kama_ratio_20_10_30 = safeStof(row[58]);
-                data.polynomial_regression_price_degree_2_slope = safeStof(row[59]);
-                data.conditional_value_at_risk_cvar_95_20 = safeStof(row[60]);
-                data.drawdown_duration_from_peak_50 = safeStof(row[61]);
-                data.ulcer_index_14 = safeStof(row[62]);
-                data.sortino_ratio_30 = safeStof(row[63]);
-                
-                stockDataMap[data.symbol].push_back(data);
-                rowCount++;
-            } catch (const std::exception& e) {
-                continue; // Skip invalid rows
+    // fields[c] is where column c starts
+    std::vector<const char*> commas(targets.size());
+    std::vector<const char*> fields(targets.size() + 1);
+    for (const char* line = p; line < end;) {
+        const char* lineEnd = CSVScanner::find_line_end(line, end);
+        const size_t found = CSVScanner::find_delimiters(line, lineEnd, ',', commas.data(), targets.size());
+        if (found >= delimiters && lineEnd > line) { // Skip incomplete rows
+            fields[0] = line;
+            for (size_t c = 0; c < delimiters; ++c) fields[c + 1] = commas[c] + 1;
+            fields[targets.size()] = (found > delimiters ? commas[delimiters] : lineEnd) + 1;
+            auto fieldEnd = [&](size_t c) { return fields[c + 1] - 1; };
+            
+            for (size_t c = 0; c < targets.size(); ++c) {
+                if (targets[c]) targets[c]->push_back(parseFloat(fields[c], fieldEnd(c)));
+            }
+            if (datetimeColumn >= 0) {
+                data.date_text.append(fields[datetimeColumn], fieldEnd(datetimeColumn));
+            }
+            data.date_ends.push_back(static_cast<uint32_t>(data.date_text.size()));
+            if (!data.data_frequency && frequencyColumn >= 0) {
+                data.data_frequency = strings.intern(std::string_view(
+                    fields[frequencyColumn], static_cast<size_t>(fieldEnd(frequencyColumn) - fields[frequencyColumn])));
             }
         }
+        line = nextLine(lineEnd, end);
     }
     
-    return rowCount > 0;
+    if (!data.data_frequency) data.data_frequency = strings.intern("");
+    for (auto* column : all) column->resize(data.size(), 0.0f);
 }
 
-void FileManager::loadAllCSVFiles(std::map<std::string, std::vector<StockData>>& stockDataMap,
-                                 std::vector<std::string>& symbols,
-                                 bool& isLoading,
-                                 int& totalFilesFound,
-                                 int& filesLoaded,
-                                 std::string& loadingStatus) {
-    isLoading = true;
-    loadingStatus = "Scanning for CSV files...";
-    stockDataMap.clear();
-    symbols.clear();
-    filesLoaded = 0;
+void FileManager::startLoading(unsigned threads) {
+    cancel();
+    setStatus("Scanning for CSV files...");
+    totalFilesFound_ = 0;
+    filesLoaded_ = 0;
+    loading_ = true;
+    loader_ = std::thread(&FileManager::run, this, threads ? threads : std::max(1u, std::thread::hardware_concurrency()));
+}
+
+void FileManager::cancel() {
+    stopFollowing();
+    cancelled_ = true;
+    if (loader_.joinable()) loader_.join();
+    cancelled_ = false;
+    loading_ = false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_.clear();
+    appended_.clear();
+    tails_.clear();
+    directory_.clear();
+    loadingStatus_.clear();
+}
+
+void FileManager::startFollowing() {
+    if (following_.exchange(true)) return;
+    if (follower_.joinable()) follower_.join();
+    follower_ = std::thread(&FileManager::follow, this);
+}
+
+void FileManager::stopFollowing() {
+    following_ = false;
+    if (follower_.joinable()) follower_.join();
+}
+
+size_t FileManager::collectLoaded(StockDataMap& stockDataMap, std::vector<std::string>& symbols) {
+    // Together, so rows never arrive ahead of the load they extend
+    std::vector<StockData> arrived;
+    std::vector<StockData> appended;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        arrived.swap(finished_);
+        appended.swap(appended_);
+    }
+    if (arrived.empty() && appended.empty()) return 0;
+    
+    const size_t sorted = symbols.size();
+    for (auto& data : arrived) {
+        const std::string& symbol = *data.symbol;
+        if (stockDataMap.find(symbol) == stockDataMap.end()) symbols.push_back(symbol);
+        stockDataMap.insert_or_assign(symbol, std::move(data));
+    }
+    std::sort(symbols.begin() + sorted, symbols.end());
+    std::inplace_merge(symbols.begin(), symbols.begin() + sorted, symbols.end());
+    
+    for (auto& rows : appended) {
+        auto it = stockDataMap.find(*rows.symbol);
+        if (it != stockDataMap.end()) it->second.append(std::move(rows));
+    }
+    return arrived.size() + appended.size();
+}
+
+std::string FileManager::loadingStatus() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return loadingStatus_;
+}
+
+void FileManager::setStatus(std::string status) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    loadingStatus_ = std::move(status);
+}
+
+void FileManager::run(unsigned threads) {
+    auto start = std::chrono::steady_clock::now();
     
     // Try multiple possible data directory locations
     std::vector<std::string> possiblePaths = {
@@ -234,12 +345,16 @@ void FileManager::loadAllCSVFiles(std::map<std::string, std::vector<StockData>>&
     if (csvFiles.size() > 15000) {
         std::cout << "WARNING: Found " << csvFiles.size() << " files - this seems too many!" << std::endl;
         std::cout << "This might indicate scanning the wrong directory. Aborting to prevent infinite loop." << std::endl;
-        loadingStatus = "Error: Too many files found - check data directory path";
-        isLoading = false;
+        setStatus("Error: Too many files found - check data directory path");
+        loading_ = false;
         return;
     }
     
-    totalFilesFound = csvFiles.size();
+    totalFilesFound_ = static_cast<int>(csvFiles.size());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        directory_ = foundPath;
+    }
     
     if (csvFiles.empty()) {
         std::cout << "No *_features.csv files found in any of the expected locations!" << std::endl;
@@ -247,43 +362,151 @@ void FileManager::loadAllCSVFiles(std::map<std::string, std::vector<StockData>>&
         for (const auto& path : possiblePaths) {
             std::cout << "  - " << path << std::endl;
         }
-        loadingStatus = "No *_features.csv files found in expected locations!";
-        isLoading = false;
+        setStatus("No *_features.csv files found in expected locations!");
+        loading_ = false;
         return;
     }
     
-    std::cout << "Found " << totalFilesFound << " CSV files to load from: " << foundPath << std::endl;
+    // Largest files first so the long histories do not end up as the tail
+    std::vector<std::pair<off_t, std::string>> bySize;
+    for (auto& file : csvFiles) bySize.emplace_back(fileSize(file), std::move(file));
+    std::stable_sort(bySize.begin(), bySize.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
     
-    // Load files with progress tracking
-    for (const auto& file : csvFiles) {
-        loadingStatus = "Loading: " + file.substr(file.find_last_of("/\\") + 1);
-        
-        if (loadCSVData(file, stockDataMap)) {
-            filesLoaded++;
-        }
-        
-        // Update progress every 100 files for performance
-        if (filesLoaded % 100 == 0) {
-            std::cout << "Loaded " << filesLoaded << "/" << totalFilesFound << " files..." << std::endl;
-        }
-    }
+    const unsigned workers = std::min<unsigned>(threads, static_cast<unsigned>(bySize.size()));
+    std::cout << "Found " << totalFilesFound_ << " CSV files to load from: " << foundPath
+              << " (" << workers << " threads)" << std::endl;
+    setStatus("Loading " + std::to_string(totalFilesFound_.load()) + " files on " +
+              std::to_string(workers) + " threads...");
     
-    // Extract unique symbols and sort
-    symbols.clear();
-    for (const auto& pair : stockDataMap) {
-        symbols.push_back(pair.first);
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> symbolsLoaded{0};
+    std::atomic<size_t> totalDataPoints{0};
+    std::vector<std::thread> pool;
+    for (unsigned w = 0; w < workers; ++w) {
+        pool.emplace_back([&]() {
+            for (size_t k; !cancelled_ && (k = next.fetch_add(1)) < bySize.size();) {
+                StockData data;
+                CSVTail tail;
+                if (loadCSVData(bySize[k].second, strings_, data, &tail, following_)) {
+                    ++symbolsLoaded;
+                    totalDataPoints += data.size();
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    finished_.push_back(std::move(data));
+                    tails_.insert_or_assign(bySize[k].second, std::move(tail));
+                }
+                
+                // Update progress every 100 files for performance
+                const int loaded = ++filesLoaded_;
+                if (loaded % 100 == 0) {
+                    std::cout << "Loaded " << loaded << "/" << totalFilesFound_ << " files..." << std::endl;
+                }
+            }
+        });
     }
-    std::sort(symbols.begin(), symbols.end());
+    for (auto& worker : pool) worker.join();
     
-    int totalDataPoints = 0;
-    for (const auto& pair : stockDataMap) {
-        totalDataPoints += pair.second.size();
+    if (cancelled_) {
+        loading_ = false;
+        return;
     }
     
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
     std::cout << "Loading complete!" << std::endl;
-    std::cout << "Total symbols: " << symbols.size() << std::endl;
+    std::cout << "Total symbols: " << symbolsLoaded << std::endl;
     std::cout << "Total data points: " << totalDataPoints << std::endl;
     
-    loadingStatus = "Complete! Loaded " + std::to_string(symbols.size()) + " symbols";
-    isLoading = false;
+    char elapsed[32];
+    std::snprintf(elapsed, sizeof(elapsed), "%.1f", seconds);
+    setStatus("Complete! Loaded " + std::to_string(symbolsLoaded.load()) + " symbols in " + elapsed + " s");
+    loading_ = false;
+}
+
+void FileManager::follow() {
+    // The directory and the files' tails come from the load
+    while (following_ && loading_) std::this_thread::sleep_for(kFollowInterval);
+    std::string directory;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        directory = directory_;
+    }
+    if (directory.empty()) {
+        following_ = false;
+        return;
+    }
+    
+#ifdef __linux__
+    const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd >= 0 && inotify_add_watch(fd, directory.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO) >= 0) {
+        // Catch up on what was written between the load and the watch
+        for (const auto& path : getCSVFiles(directory)) followFile(path);
+        alignas(inotify_event) char buffer[16 * 1024];
+        while (following_) {
+            pollfd ready = {fd, POLLIN, 0};
+            if (poll(&ready, 1, static_cast<int>(kFollowInterval.count())) <= 0) continue;
+            
+            // A burst of writes to one file is one read of its new bytes
+            std::vector<std::string> changed;
+            for (ssize_t n; (n = read(fd, buffer, sizeof(buffer))) > 0;) {
+                for (char* p = buffer; p < buffer + n;) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(p);
+                    if (event->len && isFeatureFile(event->name)) changed.push_back(directory + "/" + event->name);
+                    p += sizeof(inotify_event) + event->len;
+                }
+            }
+            std::sort(changed.begin(), changed.end());
+            changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+            for (const auto& path : changed) followFile(path);
+        }
+        close(fd);
+        return;
+    }
+    if (fd >= 0) close(fd);
+#endif
+    
+    // No change notification: look at every file each interval
+    while (following_) {
+        for (const auto& path : getCSVFiles(directory)) {
+            if (!following_) break;
+            followFile(path);
+        }
+        std::this_thread::sleep_for(kFollowInterval);
+    }
+}
+
+void FileManager::followFile(const std::string& path) {
+    CSVTail tail;
+    bool known = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = tails_.find(path);
+        if (it != tails_.end()) {
+            tail = it->second;
+            known = true;
+        }
+    }
+    const uint64_t size = static_cast<uint64_t>(fileSize(path));
+    if (known && size == tail.offset) return;
+    
+    // New, shrunk or replaced (the pipeline rewrote it): load it whole
+    if (!known || size < tail.offset || fileIdentity(path) != tail.identity) {
+        StockData data;
+        CSVTail fresh;
+        if (loadCSVData(path, strings_, data, &fresh, true)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            // Rows still queued belong to the old content
+            appended_.erase(std::remove_if(appended_.begin(), appended_.end(),
+                                           [&](const StockData& rows) { return rows.symbol == data.symbol; }),
+                            appended_.end());
+            finished_.push_back(std::move(data));
+            tails_.insert_or_assign(path, std::move(fresh));
+        }
+        return;
+    }
+    
+    StockData rows;
+    if (!loadAppendedRows(tail, strings_, rows)) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    tails_.insert_or_assign(path, std::move(tail));
+    if (!rows.empty()) appended_.push_back(std::move(rows));
 }
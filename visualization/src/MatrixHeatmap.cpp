@@ -0,0 +1,193 @@
+#include "MatrixHeatmap.h"
+#include <GL/gl3w.h>
+#include "imgui.h"
+#include "implot.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+// At 256 x 256 RGBA8 a tile is 256 KB: at most 64 MB of textures, and a
+// few uploads per frame so panning never stalls on a burst of them
+constexpr size_t kMaxResidentTiles = 256;
+constexpr int kUploadsPerFrame = 4;
+
+uint64_t tileKey(int layer, uint32_t level, size_t row, size_t col) {
+    return (uint64_t(layer) << 56) | (uint64_t(level) << 48) | (uint64_t(row) << 24) | uint64_t(col);
+}
+
+uint32_t lerpColor(const ImVec4& a, const ImVec4& b, float t) {
+    return ImGui::ColorConvertFloat4ToU32(ImVec4(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t,
+                                                 a.z + (b.z - a.z) * t, 1.0f));
+}
+}
+
+void MatrixHeatmap::load(const std::string& filename) {
+    try {
+        auto loaded = std::make_unique<TiledMatrixFile>(filename);
+        if (loaded->layer_count() == 0) throw std::runtime_error("no layers");
+        releaseTextures();
+        file = std::move(loaded);
+        layer = 0;
+        fitPending = true;
+        pixels.assign(file->tile() * file->tile(), 0);
+        buildColormap();
+        statusText = "Loaded " + std::to_string(file->size()) + " x " + std::to_string(file->size()) + " matrix";
+    } catch (const std::exception& e) {
+        statusText = "Error: Could not open matrix " + filename;
+        std::cerr << statusText << " - " << e.what() << std::endl;
+    }
+}
+
+void MatrixHeatmap::releaseTextures() {
+    for (const Resident& resident : residents) {
+        glDeleteTextures(1, &resident.texture);
+    }
+    residents.clear();
+    residentIndex.clear();
+}
+
+void MatrixHeatmap::buildColormap() {
+    const float lo = file->display_min(layer);
+    const float hi = file->display_max(layer);
+    if (lo < 0.0f && hi > 0.0f) {
+        // Diverging around zero: blue for negative, red for positive
+        const ImVec4 blue(0.13f, 0.35f, 0.75f, 1.0f), white(0.95f, 0.95f, 0.95f, 1.0f), red(0.75f, 0.15f, 0.15f, 1.0f);
+        for (int i = 0; i < 256; ++i) {
+            const float t = i / 255.0f;
+            colormap[i] = t < 0.5f ? lerpColor(blue, white, t * 2.0f) : lerpColor(white, red, t * 2.0f - 1.0f);
+        }
+    } else {
+        // Sequential, strongest at the low end (p-values)
+        const ImVec4 strong(0.95f, 0.85f, 0.2f, 1.0f), weak(0.1f, 0.1f, 0.3f, 1.0f);
+        for (int i = 0; i < 256; ++i) {
+            colormap[i] = lerpColor(strong, weak, i / 255.0f);
+        }
+    }
+}
+
+unsigned int MatrixHeatmap::tileTexture(uint32_t level, size_t row, size_t col, int& uploads) {
+    const uint64_t key = tileKey(layer, level, row, col);
+    auto found = residentIndex.find(key);
+    if (found != residentIndex.end()) {
+        residents.splice(residents.begin(), residents, found->second);
+        return found->second->texture;
+    }
+    if (uploads <= 0) return 0;
+    --uploads;
+
+    // Colormap the tile straight from the mapping into the scratch pixels;
+    // NaN cells stay transparent
+    const size_t tile = file->tile();
+    const float* cells = file->tile_data(layer, level, row, col);
+    const float lo = file->display_min(layer);
+    const float scale = 255.0f / std::max(file->display_max(layer) - lo, 1e-12f);
+    for (size_t i = 0; i < tile * tile; ++i) {
+        const float v = cells[i];
+        pixels[i] = std::isnan(v) ? 0u : colormap[static_cast<int>(std::clamp((v - lo) * scale, 0.0f, 255.0f))];
+    }
+
+    const GLsizei side = static_cast<GLsizei>(tile);
+    unsigned int texture = 0;
+    if (residents.size() >= kMaxResidentTiles) {
+        // Reuse the least recently drawn tile's texture
+        Resident evicted = residents.back();
+        residents.pop_back();
+        residentIndex.erase(evicted.key);
+        texture = evicted.texture;
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, side, side, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    } else {
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, side, side, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    residents.push_front({key, texture});
+    residentIndex[key] = residents.begin();
+    return texture;
+}
+
+void MatrixHeatmap::drawLevel(uint32_t level, double xMin, double xMax, double yMin, double yMax, int& uploads) {
+    // A tile of `level` spans tile << level matrix cells on each axis
+    const double span = static_cast<double>(file->tile() << level);
+    const size_t tiles = file->tiles(level);
+    auto first = [&](double v) { return static_cast<size_t>(std::clamp(std::floor(v / span), 0.0, double(tiles))); };
+    auto last = [&](double v) { return static_cast<size_t>(std::clamp(std::ceil(v / span), 0.0, double(tiles))); };
+
+    for (size_t row = first(yMin); row < last(yMax); ++row) {
+        for (size_t col = first(xMin); col < last(xMax); ++col) {
+            const unsigned int texture = tileTexture(level, row, col, uploads);
+            if (texture == 0) continue;
+            // Rows grow downwards on the inverted y axis: the tile's last
+            // row, at the bottom, is the texture's v = 1
+            ImPlot::PlotImage("##tile", (ImTextureID)(intptr_t)texture,
+                              ImPlotPoint(col * span, row * span), ImPlotPoint((col + 1) * span, (row + 1) * span),
+                              ImVec2(0, 1), ImVec2(1, 0));
+        }
+    }
+}
+
+void MatrixHeatmap::render() {
+    if (!file) {
+        ImGui::Text("No matrix loaded. Run the arbitrage analyzer with --matrix on, then File -> Load Pair Matrix.");
+        return;
+    }
+
+    ImGui::SetNextItemWidth(220);
+    if (ImGui::BeginCombo("Layer", file->layer_name(layer))) {
+        for (int i = 0; i < static_cast<int>(file->layer_count()); ++i) {
+            if (ImGui::Selectable(file->layer_name(i), i == layer) && i != layer) {
+                layer = i;
+                buildColormap();
+            }
+        }
+        ImGui::EndCombo();
+    }
+    ImGui::SameLine();
+    ImGui::Text("%zu symbols, range %.3g to %.3g", file->size(), file->display_min(layer), file->display_max(layer));
+
+    const double n = static_cast<double>(file->size());
+    if (!ImPlot::BeginPlot("##PairMatrix", ImVec2(-1, -1), ImPlotFlags_Equal | ImPlotFlags_NoLegend)) return;
+    ImPlot::SetupAxes("Symbol", "Symbol", 0, ImPlotAxisFlags_Invert);
+    ImPlot::SetupAxesLimits(0, n, 0, n, fitPending ? ImPlotCond_Always : ImPlotCond_Once);
+    fitPending = false;
+
+    const ImPlotRect view = ImPlot::GetPlotLimits();
+    const ImVec2 plotSize = ImPlot::GetPlotSize();
+    const double cellsPerPixel = (view.X.Max - view.X.Min) / std::max(1.0f, plotSize.x);
+    const uint32_t coarsest = file->levels() - 1;
+    const uint32_t wanted = static_cast<uint32_t>(
+        std::clamp(std::floor(std::log2(std::max(cellsPerPixel, 1.0))), 0.0, double(coarsest)));
+
+    // Coarse to fine, each level over the one before: the coarsest is one
+    // tile and always present, between levels only what is resident shows,
+    // and the wanted level fills in a few tiles per frame
+    int uploads = kUploadsPerFrame;
+    for (uint32_t level = coarsest + 1; level-- > wanted;) {
+        int none = 0;
+        drawLevel(level, view.X.Min, view.X.Max, view.Y.Min, view.Y.Max,
+                  level == wanted || level == coarsest ? uploads : none);
+    }
+
+    if (ImPlot::IsPlotHovered()) {
+        const ImPlotPoint mouse = ImPlot::GetPlotMousePos();
+        if (mouse.x >= 0 && mouse.y >= 0 && mouse.x < n && mouse.y < n) {
+            const size_t row = static_cast<size_t>(mouse.y), col = static_cast<size_t>(mouse.x);
+            const float value = file->value(layer, 0, row, col);
+            if (std::isnan(value)) {
+                ImGui::SetTooltip("%s / %s: not computed", file->symbol(row), file->symbol(col));
+            } else {
+                ImGui::SetTooltip("%s / %s\n%s: %.4f", file->symbol(row), file->symbol(col),
+                                  file->layer_name(layer), value);
+            }
+        }
+    }
+    ImPlot::EndPlot();
+}
@@ -0,0 +1,301 @@
+#include "PairTable.h"
+#include "CsvParsing.h"
+#include "csv_scanner.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+constexpr size_t kFields = 23;
+
+// CSV field of each metric (0 and 1 are the stocks, 15 the grade, 16 the
+// cointegration flag, 21 the trade count)
+constexpr size_t kMetricField[PairTable::MetricCount] = {2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+                                                         17, 18, 19, 20, 22};
+
+// The exporter streams non-finite metrics as nan/inf
+float parseMetric(const char* p, const char* end) {
+    const char* digits = p < end && (*p == '-' || *p == '+') ? p + 1 : p;
+    if (digits < end && (*digits == 'n' || *digits == 'N')) return std::numeric_limits<float>::quiet_NaN();
+    if (digits < end && (*digits == 'i' || *digits == 'I')) {
+        return *p == '-' ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+    }
+    return parseFloat(p, end);
+}
+
+// Text fields may be quoted by the exporter's escaping
+std::string_view unquote(const char* p, const char* end) {
+    if (end - p >= 2 && *p == '"' && end[-1] == '"') {
+        ++p;
+        --end;
+    }
+    return std::string_view(p, static_cast<size_t>(end - p));
+}
+}
+
+PairTable PairTable::loadCSV(const std::string& filename) {
+    PairTable table;
+    MappedFile file(filename);
+    if (file.empty()) return table;
+    const char* p = file.data();
+    const char* end = p + file.size();
+
+    const size_t lines = CSVScanner::count_lines(p, end);
+    table.stock1_.reserve(lines);
+    table.stock2_.reserve(lines);
+    table.grade_.reserve(lines);
+    table.historicalTrades_.reserve(lines);
+    for (auto& column : table.metrics_) column.reserve(lines);
+    table.cointegrated_.reserve(lines / 64 + 1);
+
+    // Keyed by views into the file, which outlives the parse
+    std::unordered_map<std::string_view, uint32_t> names;
+    auto intern = [&](std::string_view text) {
+        auto it = names.emplace(text, static_cast<uint32_t>(table.names_.size())).first;
+        if (it->second == table.names_.size()) table.names_.emplace_back(text);
+        return it->second;
+    };
+
+    // fields[c] is where field c starts
+    std::array<const char*, kFields - 1> commas;
+    std::array<const char*, kFields + 1> fields;
+    for (const char* line = nextLine(CSVScanner::find_line_end(p, end), end); line < end;) {
+        const char* lineEnd = CSVScanner::find_line_end(line, end);
+        if (CSVScanner::find_delimiters(line, lineEnd, ',', commas.data(), commas.size()) == commas.size()) {
+            fields[0] = line;
+            for (size_t c = 0; c + 1 < kFields; ++c) fields[c + 1] = commas[c] + 1;
+            fields[kFields] = lineEnd + 1;
+            auto fieldEnd = [&](size_t c) { return fields[c + 1] - 1; };
+
+            const size_t row = table.stock1_.size();
+            table.stock1_.push_back(intern(unquote(fields[0], fieldEnd(0))));
+            table.stock2_.push_back(intern(unquote(fields[1], fieldEnd(1))));
+            for (size_t m = 0; m < MetricCount; ++m) {
+                table.metrics_[m].push_back(parseMetric(fields[kMetricField[m]], fieldEnd(kMetricField[m])));
+            }
+
+            // A handful of grades, so a scan beats hashing; more than fit a
+            // byte share the last one
+            const std::string_view grade = unquote(fields[15], fieldEnd(15));
+            auto known = std::find(table.grades_.begin(), table.grades_.end(), grade);
+            if (known == table.grades_.end() && table.grades_.size() < 256) {
+                known = table.grades_.emplace(table.grades_.end(), grade);
+            }
+            table.grade_.push_back(static_cast<uint8_t>(std::min<ptrdiff_t>(known - table.grades_.begin(), 255)));
+
+            const std::string_view flag(fields[16], static_cast<size_t>(fieldEnd(16) - fields[16]));
+            if (row % 64 == 0) table.cointegrated_.push_back(0);
+            if (flag == "TRUE" || flag == "true" || flag == "1") {
+                table.cointegrated_.back() |= uint64_t(1) << (row % 64);
+            }
+
+            int32_t trades = 0;
+            std::from_chars(fields[21], fieldEnd(21), trades);
+            table.historicalTrades_.push_back(trades);
+        }
+        line = nextLine(lineEnd, end);
+    }
+
+    table.buildIndexes();
+    return table;
+}
+
+CointegrationData PairTable::row(uint32_t row) const {
+    CointegrationData data;
+    data.stock1 = stock1(row);
+    data.stock2 = stock2(row);
+    data.adf_statistic = metrics_[AdfStatistic][row];
+    data.p_value = metrics_[PValue][row];
+    data.critical_1pct = metrics_[Critical1Pct][row];
+    data.critical_5pct = metrics_[Critical5Pct][row];
+    data.critical_10pct = metrics_[Critical10Pct][row];
+    data.half_life_days = metrics_[HalfLifeDays][row];
+    data.hedge_ratio = metrics_[HedgeRatio][row];
+    data.spread_mean = metrics_[SpreadMean][row];
+    data.spread_stddev = metrics_[SpreadStdDev][row];
+    data.max_spread = metrics_[MaxSpread][row];
+    data.min_spread = metrics_[MinSpread][row];
+    data.current_spread = metrics_[CurrentSpread][row];
+    data.z_score = metrics_[ZScore][row];
+    data.grade = grade(row);
+    data.is_cointegrated = isCointegrated(row);
+    data.entry_threshold = metrics_[EntryThreshold][row];
+    data.exit_threshold = metrics_[ExitThreshold][row];
+    data.expected_return = metrics_[ExpectedReturn][row];
+    data.sharpe_ratio = metrics_[SharpeRatio][row];
+    data.historical_trades = historicalTrades_[row];
+    data.win_rate = metrics_[WinRate][row];
+    return data;
+}
+
+void PairTable::buildIndexes() {
+    const size_t n = size();
+    const size_t words = (n + 63) / 64;
+
+    // Grades renumbered in sorted order, so the grade order is the index order
+    std::vector<uint8_t> rank(grades_.size());
+    {
+        std::vector<uint8_t> byName(grades_.size());
+        std::iota(byName.begin(), byName.end(), uint8_t(0));
+        std::sort(byName.begin(), byName.end(), [&](uint8_t a, uint8_t b) { return grades_[a] < grades_[b]; });
+        std::vector<std::string> sorted;
+        for (size_t i = 0; i < byName.size(); ++i) {
+            rank[byName[i]] = static_cast<uint8_t>(i);
+            sorted.push_back(grades_[byName[i]]);
+        }
+        grades_ = std::move(sorted);
+    }
+    for (auto& grade : grade_) grade = rank[grade];
+
+    // Same rules as CointegrationData::isHighQuality and isOutlier
+    const auto gradeA = std::find(grades_.begin(), grades_.end(), "A");
+    const int gradeAIndex = gradeA != grades_.end() ? static_cast<int>(gradeA - grades_.begin()) : -1;
+    const std::vector<float>& sharpe = metrics_[SharpeRatio];
+    const std::vector<float>& winRate = metrics_[WinRate];
+    const std::vector<float>& zScore = metrics_[ZScore];
+    highQuality_.assign(words, 0);
+    outlier_.assign(words, 0);
+    gradeRows_.assign(grades_.size(), Bitmap(words, 0));
+    cointegrated_.resize(words, 0);
+    for (size_t row = 0; row < n; ++row) {
+        const uint64_t bit = uint64_t(1) << (row % 64);
+        if (grade_[row] == gradeAIndex && sharpe[row] > 1.0 && winRate[row] > 0.6) highQuality_[row / 64] |= bit;
+        if (std::abs(zScore[row]) > 2.5 || sharpe[row] > 2.0 || winRate[row] > 0.8) outlier_[row / 64] |= bit;
+        gradeRows_[grade_[row]][row / 64] |= bit;
+    }
+
+    // One sort per key, each on its own thread
+    std::vector<std::thread> sorts;
+    for (size_t key = 0; key < SortKeyCount; ++key) {
+        sorts.emplace_back([this, key] { orders_[key] = sortedBy(static_cast<SortKey>(key)); });
+    }
+    for (auto& sort : sorts) sort.join();
+}
+
+PairTable::Order PairTable::sortedBy(SortKey key) const {
+    const size_t n = size();
+    Order order;
+    std::vector<uint32_t> missing;
+    std::vector<uint64_t> keys;
+    keys.reserve(n);
+    order.rows.reserve(n);
+    unsigned bits = 0;
+
+    if (key == SortPair) {
+        // Symbols ranked by name, the key packing both ranks
+        std::vector<uint32_t> byName(names_.size());
+        std::iota(byName.begin(), byName.end(), uint32_t(0));
+        std::sort(byName.begin(), byName.end(), [&](uint32_t a, uint32_t b) { return names_[a] < names_[b]; });
+        std::vector<uint64_t> rank(names_.size());
+        for (size_t i = 0; i < byName.size(); ++i) rank[byName[i]] = i;
+        while ((size_t(1) << bits) < names_.size()) ++bits;
+        for (uint32_t row = 0; row < n; ++row) {
+            order.rows.push_back(row);
+            keys.push_back(rank[stock1_[row]] << bits | rank[stock2_[row]]);
+        }
+        bits *= 2;
+    } else if (key == SortGrade) {
+        for (uint32_t row = 0; row < n; ++row) {
+            order.rows.push_back(row);
+            keys.push_back(grade_[row]);
+        }
+        bits = 8;
+    } else {
+        static const Metric kKeyMetric[SortKeyCount] = {SharpeRatio, SharpeRatio, SharpeRatio, WinRate,
+                                                        ZScore, HalfLifeDays, ExpectedReturn};
+        const std::vector<float>& values = metrics_[kKeyMetric[key]];
+        // Float bits flipped so they compare as unsigned; NaN has no place
+        // in the order, so those rows go last unsorted
+        for (uint32_t row = 0; row < n; ++row) {
+            if (std::isnan(values[row])) {
+                missing.push_back(row);
+                continue;
+            }
+            uint32_t u;
+            std::memcpy(&u, &values[row], sizeof(u));
+            order.rows.push_back(row);
+            keys.push_back(u & 0x80000000u ? ~u : u | 0x80000000u);
+        }
+        bits = 32;
+    }
+    order.ordered = keys.size();
+
+    // Stable LSD radix sort, 11 bits a pass; ties keep row order
+    constexpr unsigned kDigitBits = 11;
+    constexpr size_t kBuckets = size_t(1) << kDigitBits;
+    std::vector<uint64_t> keyBuffer(order.ordered);
+    std::vector<uint32_t> rowBuffer(order.ordered);
+    std::vector<size_t> offsets(kBuckets);
+    for (unsigned shift = 0; shift < bits; shift += kDigitBits) {
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for (uint64_t k : keys) ++offsets[(k >> shift) & (kBuckets - 1)];
+        size_t total = 0;
+        for (size_t& offset : offsets) {
+            const size_t count = offset;
+            offset = total;
+            total += count;
+        }
+        for (size_t i = 0; i < order.ordered; ++i) {
+            const size_t to = offsets[(keys[i] >> shift) & (kBuckets - 1)]++;
+            keyBuffer[to] = keys[i];
+            rowBuffer[to] = order.rows[i];
+        }
+        keys.swap(keyBuffer);
+        order.rows.swap(rowBuffer);
+    }
+    order.rows.insert(order.rows.end(), missing.begin(), missing.end());
+    return order;
+}
+
+void PairTable::select(const PairFilter& filter, SortKey key, bool descending, std::vector<uint32_t>& rows) const {
+    rows.clear();
+    const size_t n = size();
+    if (n == 0) return;
+
+    // Flags and grade a word at a time, then the range limits on the rows left
+    const std::vector<float>& sharpe = metrics_[SharpeRatio];
+    const std::vector<float>& halfLife = metrics_[HalfLifeDays];
+    const bool knownGrade = filter.grade >= 0 && static_cast<size_t>(filter.grade) < gradeRows_.size();
+    Bitmap mask((n + 63) / 64, ~uint64_t(0));
+    if (n % 64) mask.back() = (uint64_t(1) << (n % 64)) - 1;
+    for (size_t w = 0; w < mask.size(); ++w) {
+        uint64_t bits = mask[w];
+        if (filter.onlyCointegrated) bits &= cointegrated_[w];
+        if (filter.onlyHighQuality) bits &= highQuality_[w];
+        if (filter.onlyOutliers) bits &= outlier_[w];
+        if (filter.grade >= 0) bits = knownGrade ? bits & gradeRows_[filter.grade][w] : 0;
+        for (uint64_t left = bits; left; left &= left - 1) {
+            const size_t row = w * 64 + __builtin_ctzll(left);
+            if (sharpe[row] < filter.minSharpeRatio || halfLife[row] > filter.maxHalfLife) {
+                bits &= ~(uint64_t(1) << (row % 64));
+            }
+        }
+        mask[w] = bits;
+    }
+
+    rows.reserve(count(mask));
+    const Order& order = orders_[key];
+    auto take = [&](size_t i) {
+        const uint32_t row = order.rows[i];
+        if (test(mask, row)) rows.push_back(row);
+    };
+    if (descending) {
+        for (size_t i = order.ordered; i-- > 0;) take(i);
+    } else {
+        for (size_t i = 0; i < order.ordered; ++i) take(i);
+    }
+    for (size_t i = order.ordered; i < order.rows.size(); ++i) take(i);
+}
+
+size_t PairTable::count(const Bitmap& bits) {
+    size_t total = 0;
+    for (uint64_t word : bits) total += __builtin_popcountll(word);
+    return total;
+}
@@ -7,18 +7,27 @@
 #include <algorithm>
 
 void StockVisualizer::loadAllCSVFiles() {
-    FileManager::loadAllCSVFiles(stockDataMap, symbols, isLoading, 
-                                totalFilesFound, filesLoaded, loadingStatus);
-    dataLoaded = !stockDataMap.empty();
+    clearData();
+    fileManager.startLoading();
+    if (followLive) fileManager.startFollowing();
+}
+
+void StockVisualizer::collectLoadedSymbols() {
+    // Symbols arrive in any order; keep the selection on the same symbol
+    const std::string selected = selectedSymbol < (int)symbols.size() ? symbols[selectedSymbol] : "";
+    if (fileManager.collectLoaded(stockDataMap, symbols) == 0) return;
+    dataLoaded = true;
+    if (!selected.empty()) {
+        selectedSymbol = (int)(std::lower_bound(symbols.begin(), symbols.end(), selected) - symbols.begin());
+    }
 }
 
 void StockVisualizer::clearData() {
+    fileManager.cancel();
     stockDataMap.clear();
     symbols.clear();
     selectedSymbol = 0;
     dataLoaded = false;
-    isLoading = false;
-    loadingStatus = "";
 }
 
 int StockVisualizer::getTotalDataPoints() {
@@ -30,8 +39,11 @@ int StockVisualizer::getTotalDataPoints() {
 }
 
 void StockVisualizer::renderUI() {
+    collectLoadedSymbols();
+    
     ImGui::Begin("Stock Data Visualizer", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
     
+    const bool isLoading = fileManager.isLoading();
     if (ImGui::Button("Load All Stock Data") && !isLoading) {
         loadAllCSVFiles();
     }
@@ -41,8 +53,16 @@ void StockVisualizer::renderUI() {
         clearData();
     }
     
+    // Rows the feature pipeline appends show up without a reload
+    ImGui::SameLine();
+    if (ImGui::Checkbox("Follow Live Updates", &followLive)) {
+        if (!followLive) fileManager.stopFollowing();
+        else if (dataLoaded || isLoading) fileManager.startFollowing();
+    }
+    
     // Show loading status
-    UIComponents::renderLoadingProgress(isLoading, filesLoaded, totalFilesFound, loadingStatus);
+    UIComponents::renderLoadingProgress(isLoading, fileManager.filesLoaded(), fileManager.totalFilesFound(),
+                                        fileManager.loadingStatus());
     
     if (dataLoaded && !symbols.empty()) {
         ImGui::Separator();
@@ -67,7 +87,7 @@ void StockVisualizer::renderUI() {
     ImGui::End();
 }
 
-void StockVisualizer::renderCharts(const std::string& symbol, const std::vector<StockData>& data) {
+void StockVisualizer::renderCharts(const std::string& symbol, const StockData& data) {
     if (data.empty()) return;
     
     // Create tabs for different chart categories
@@ -25,7 +25,7 @@ void UIComponents::renderDataSummary(const std::vector<std::string>& symbols, in
 
 void UIComponents::renderSymbolSelector(const std::vector<std::string>& symbols, 
                                        int& selectedSymbol,
-                                       const std::map<std::string, std::vector<StockData>>& stockDataMap) {
+                                       const StockDataMap& stockDataMap) {
     // Symbol search/filter
     static char symbolFilter[64] = "";
     ImGui::InputText("Filter symbols", symbolFilter, sizeof(symbolFilter));
@@ -64,15 +64,16 @@ void UIComponents::renderSymbolSelector(const std::vector<std::string>& symbols,
     }
 }
 
-void UIComponents::renderSymbolInfo(const std::string& symbol, const std::vector<StockData>& data) {
+void UIComponents::renderSymbolInfo(const std::string& symbol, const StockData& data) {
     ImGui::Text("Symbol: %s", symbol.c_str());
     ImGui::Text("Data points: %d", (int)data.size());
     
     if (!data.empty()) {
-        ImGui::Text("Date range: %s to %s", data.front().date_string.c_str(), data.back().date_string.c_str());
-        ImGui::Text("Latest Close: $%.2f", data.back().close);
-        ImGui::Text("Latest Volume: %.0f", data.back().volume);
-        ImGui::Text("Latest RSI: %.2f", data.back().rsi);
-        ImGui::Text("Latest Returns: %.4f", data.back().returns);
+        const std::string_view first = data.date(0), last = data.date(data.size() - 1);
+        ImGui::Text("Date range: %.*s to %.*s", (int)first.size(), first.data(), (int)last.size(), last.data());
+        ImGui::Text("Latest Close: $%.2f", data.close.back());
+        ImGui::Text("Latest Volume: %.0f", data.volume.back());
+        ImGui::Text("Latest RSI: %.2f", data.rsi.back());
+        ImGui::Text("Latest Returns: %.4f", data.returns.back());
     }
 }
\ No newline at end of file
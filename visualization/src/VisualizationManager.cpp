@@ -4,16 +4,22 @@
 #include <sstream>
 #include <filesystem>
 #include <algorithm>
+#include <cmath>
 
 namespace Visualization {
 
 // DataManager implementation
-std::vector<FlexibleStockData> DataManager::loadFromCSV(const std::string& csv_path) {
-    std::vector<FlexibleStockData> data;
+FeatureFrame DataManager::loadFromCSV(const std::string& csv_path) {
+    if (ColumnarFile::is_columnar_path(csv_path)) {
+        return loadFromColumnar(csv_path);
+    }
+    
+    // Extract symbol from filename
+    FeatureFrame frame(extractSymbolFromPath(csv_path));
     std::ifstream file(csv_path);
     
     if (!file.is_open()) {
-        return data; // Return empty vector on error
+        return frame; // Return empty frame on error
     }
     
     std::string line;
@@ -32,14 +38,24 @@ std::vector<FlexibleStockData> DataManager::loadFromCSV(const std::string& csv_p
         }
     }
     
-    // Extract symbol from filename
-    std::string symbol = extractSymbolFromPath(csv_path);
+    // Resolve each header to its feature id once
+    auto& registry = FeatureRegistry::getInstance();
+    int date_column = -1;
+    std::vector<FeatureId> column_ids(headers.size(), kInvalidFeatureId);
+    for (size_t i = 0; i < headers.size(); ++i) {
+        if (headers[i] == "date" || headers[i] == "Date") {
+            date_column = static_cast<int>(i);
+        } else if (headers[i] != "datetime_index") {
+            column_ids[i] = registry.getFeatureId(headers[i]);
+        }
+    }
     
     // Read data lines
+    std::vector<std::string> row;
     while (std::getline(file, line)) {
         std::stringstream ss(line);
         std::string cell;
-        std::vector<std::string> row;
+        row.clear();
         
         while (std::getline(ss, cell, ',')) {
             // Remove quotes
@@ -51,37 +67,83 @@ std::vector<FlexibleStockData> DataManager::loadFromCSV(const std::string& csv_p
             continue; // Skip malformed rows
         }
         
-        FlexibleStockData data_point;
-        data_point.symbol = symbol;
+        const size_t index = frame.size();
+        frame.resize(index + 1);
+        frame.appendDate(date_column >= 0 ? row[date_column] : std::string());
         
-        // Parse each column
-        for (size_t i = 0; i < headers.size() && i < row.size(); ++i) {
-            const std::string& header = headers[i];
-            const std::string& value_str = row[i];
-            
+        // Parse each numeric column; invalid cells stay missing (NaN)
+        for (size_t i = 0; i < row.size(); ++i) {
+            if (column_ids[i] == kInvalidFeatureId) continue;
             try {
-                if (header == "date" || header == "Date") {
-                    data_point.date_string = value_str;
-                } else if (header == "datetime_index") {
-                    data_point.datetime_index = std::stof(value_str);
-                } else {
-                    // Try to parse as numeric feature
-                    double value = std::stod(value_str);
-                    data_point.setFeature(header, value);
-                }
+                frame.set(column_ids[i], index, std::stof(row[i]));
             } catch (const std::exception&) {
                 // Skip invalid values
                 continue;
             }
         }
-        
-        data.push_back(std::move(data_point));
     }
     
-    return data;
+    return frame;
 }
 
-std::vector<FlexibleStockData> DataManager::convertFromFeatureSet(
+FeatureFrame DataManager::loadFromColumnar(const std::string& path) {
+    std::unique_ptr<ColumnarFile> file;
+    try {
+        file = std::make_unique<ColumnarFile>(path);
+        file->decompress(); // compressed columns expanded side by side, up front
+    } catch (const std::exception&) {
+        return FeatureFrame(extractSymbolFromPath(path)); // Return empty frame on error
+    }
+    
+    return convertFromColumnar(*file, extractSymbolFromPath(path));
+}
+
+FeatureFrame DataManager::loadFromSharedSegment(SharedFeatureReader& segment) {
+    FeatureFrame frame;
+    // Converted straight out of the segment; repeated if the publisher
+    // overwrote the image meanwhile
+    const uint64_t publish = segment.read([&](const ColumnarFile& image) {
+        frame = convertFromColumnar(image, segment.name().substr(segment.name().rfind('.') + 1));
+    });
+    return publish ? std::move(frame) : FeatureFrame();
+}
+
+FeatureFrame DataManager::convertFromColumnar(const ColumnarFile& file, const std::string& fallback_symbol) {
+    const size_t rows = file.rows();
+    FeatureFrame frame(file.symbol().empty() ? fallback_symbol : file.symbol(), rows);
+    
+    std::vector<std::chrono::system_clock::time_point> timestamps;
+    if (const int64_t* seconds = file.timestamps()) {
+        timestamps.reserve(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            timestamps.emplace_back(std::chrono::seconds(seconds[i]));
+        }
+    }
+    auto date_strings = FeatureExtractor::convertTimestampsToStrings(timestamps);
+    for (size_t i = 0; i < rows; ++i) {
+        frame.appendDate(i < date_strings.size() ? date_strings[i] : std::string());
+    }
+    
+    // One column copy per feature; NaN marks rows where the CSV cell would be blank
+    auto& registry = FeatureRegistry::getInstance();
+    for (size_t c = 0; c < file.column_count(); ++c) {
+        if (const float* values = file.values_f32(c)) {
+            std::vector<float>& column = frame.column(registry.getFeatureId(file.column_name(c)));
+            std::copy(values, values + rows, column.begin());
+            continue;
+        }
+        const double* values = file.values(c);
+        if (!values) continue;
+        std::vector<float>& column = frame.column(registry.getFeatureId(file.column_name(c)));
+        for (size_t i = 0; i < rows; ++i) {
+            column[i] = static_cast<float>(values[i]);
+        }
+    }
+    
+    return frame;
+}
+
+FeatureFrame DataManager::convertFromFeatureSet(
     const std::string& symbol,
     const OHLCVData& ohlcv_data,
     const FeatureSet& feature_set) {
@@ -89,10 +151,10 @@ std::vector<FlexibleStockData> DataManager::convertFromFeatureSet(
     return FeatureExtractor::extractFromFeatureSet(symbol, ohlcv_data, feature_set);
 }
 
-std::unordered_map<std::string, std::vector<FlexibleStockData>> DataManager::loadMultipleSymbols(
+std::unordered_map<std::string, FeatureFrame> DataManager::loadMultipleSymbols(
     const std::vector<std::string>& csv_paths) {
     
-    std::unordered_map<std::string, std::vector<FlexibleStockData>> result;
+    std::unordered_map<std::string, FeatureFrame> result;
     
     for (const auto& path : csv_paths) {
         auto data = loadFromCSV(path);
@@ -105,33 +167,45 @@ std::unordered_map<std::string, std::vector<FlexibleStockData>> DataManager::loa
     return result;
 }
 
-void DataManager::validateData(std::vector<FlexibleStockData>& data) {
-    // Remove data points with no features
-    data.erase(
-        std::remove_if(data.begin(), data.end(),
-            [](const FlexibleStockData& point) {
-                return point.getFeatureNames().empty();
-            }),
-        data.end()
-    );
+std::vector<SymbolIndexEntry> DataManager::indexSymbols(const std::vector<std::string>& csv_paths) {
+    std::vector<SymbolIndexEntry> entries;
+    entries.reserve(csv_paths.size());
+    
+    for (const auto& path : csv_paths) {
+        std::error_code error;
+        const uintmax_t bytes = std::filesystem::file_size(path, error);
+        if (error) continue;
+        entries.push_back({extractSymbolFromPath(path), path, bytes});
+    }
+    
+    return entries;
+}
+
+void DataManager::validateData(FeatureFrame& data) {
+    // Remove rows with no feature values
+    const FeatureFrame& frame = data;
+    std::vector<char> keep(frame.size(), 0);
+    for (FeatureId id : frame.featureIds()) {
+        FeatureSpan column = frame.column(id);
+        for (size_t i = 0; i < column.size; ++i) {
+            if (!std::isnan(column[i])) keep[i] = 1;
+        }
+    }
+    data.keepRows(keep);
 }
 
-void DataManager::cleanData(std::vector<FlexibleStockData>& data, bool remove_outliers) {
+void DataManager::cleanData(FeatureFrame& data, bool remove_outliers) {
     if (data.empty()) return;
     
-    // Get all feature names
-    auto feature_names = data[0].getFeatureNames();
-    
-    for (const auto& feature_name : feature_names) {
-        std::vector<double> values;
+    for (FeatureId id : data.featureIds()) {
+        std::vector<float>& column = data.column(id);
+        std::vector<float> values;
+        values.reserve(column.size());
         
         // Collect all valid values for this feature
-        for (const auto& data_point : data) {
-            if (data_point.hasFeature(feature_name)) {
-                double value = data_point.getFeature(feature_name);
-                if (!std::isnan(value) && !std::isinf(value)) {
-                    values.push_back(value);
-                }
+        for (float value : column) {
+            if (std::isfinite(value)) {
+                values.push_back(value);
             }
         }
         
@@ -152,13 +226,10 @@ void DataManager::cleanData(std::vector<FlexibleStockData>& data, bool remove_ou
             double upper_bound = q3 + 1.5 * iqr;
             
             // Remove outliers
-            for (auto& data_point : data) {
-                if (data_point.hasFeature(feature_name)) {
-                    double value = data_point.getFeature(feature_name);
-                    if (value < lower_bound || value > upper_bound) {
-                        // Set to NaN to mark as invalid
-                        data_point.setFeature(feature_name, std::numeric_limits<double>::quiet_NaN());
-                    }
+            for (float& value : column) {
+                if (value < lower_bound || value > upper_bound) {
+                    // Set to NaN to mark as invalid
+                    value = std::numeric_limits<float>::quiet_NaN();
                 }
             }
         }
@@ -178,9 +249,22 @@ std::string DataManager::extractSymbolFromPath(const std::string& csv_path) {
     return filename;
 }
 
+namespace {
+// Symbols either side of the selection read ahead in the background
+constexpr size_t kPrefetchNeighbours = 2;
+
+FeatureFrame loadCleanFrame(const std::string& path) {
+    auto data = DataManager::loadFromCSV(path);
+    DataManager::validateData(data);
+    DataManager::cleanData(data, false); // Don't remove outliers by default
+    return data;
+}
+}
+
 // VisualizationManager implementation
 VisualizationManager::VisualizationManager()
     : renderer_(),
+      symbols_(loadCleanFrame),
       current_symbol_(""),
       show_symbol_selector_(false),
       show_feature_dashboard_(false),
@@ -188,6 +272,8 @@ VisualizationManager::VisualizationManager()
       show_statistics_dashboard_(false),
       show_error_popup_(false),
       show_info_popup_(false) {
+    // Charts of a dropped symbol hold copies of its columns
+    symbols_.setEvictionCallback([this](const std::string& symbol) { renderer_.releaseSymbol(symbol); });
 }
 
 void VisualizationManager::initialize() {
@@ -201,23 +287,21 @@ void VisualizationManager::initializeFeatureRegistry() {
 
 bool VisualizationManager::loadData(const std::string& csv_path) {
     try {
-        auto data = DataManager::loadFromCSV(csv_path);
+        auto data = loadCleanFrame(csv_path);
         if (data.empty()) {
             showErrorMessage("Failed to load data from: " + csv_path);
             return false;
         }
         
-        DataManager::validateData(data);
-        DataManager::cleanData(data, false); // Don't remove outliers by default
-        
         std::string symbol = DataManager::extractSymbolFromPath(csv_path);
-        symbol_data_[symbol] = std::move(data);
+        const size_t points = data.size();
+        symbols_.put(symbol, std::move(data), csv_path);
         
-        if (current_symbol_.empty()) {
-            current_symbol_ = symbol;
+        if (current_symbol_.empty() || current_symbol_ == symbol) {
+            setCurrentSymbol(symbol);
         }
         
-        showInfoMessage("Successfully loaded " + std::to_string(symbol_data_[symbol].size()) + 
+        showInfoMessage("Successfully loaded " + std::to_string(points) + 
                        " data points for " + symbol);
         return true;
         
@@ -238,13 +322,14 @@ bool VisualizationManager::loadData(const std::string& symbol,
         }
         
         DataManager::validateData(data);
-        symbol_data_[symbol] = std::move(data);
+        const size_t points = data.size();
+        symbols_.put(symbol, std::move(data));
         
-        if (current_symbol_.empty()) {
-            current_symbol_ = symbol;
+        if (current_symbol_.empty() || current_symbol_ == symbol) {
+            setCurrentSymbol(symbol);
         }
         
-        showInfoMessage("Successfully loaded " + std::to_string(symbol_data_[symbol].size()) + 
+        showInfoMessage("Successfully loaded " + std::to_string(points) + 
                        " data points for " + symbol);
         return true;
         
@@ -254,43 +339,107 @@ bool VisualizationManager::loadData(const std::string& symbol,
     }
 }
 
-bool VisualizationManager::loadMultipleDataSources(const std::vector<std::string>& csv_paths) {
-    auto loaded_data = DataManager::loadMultipleSymbols(csv_paths);
-    
-    if (loaded_data.empty()) {
-        showErrorMessage("Failed to load any data from provided paths");
+bool VisualizationManager::attachSharedSegment(const std::string& name) {
+    try {
+        live_segments_.push_back({std::make_unique<SharedFeatureReader>(name), 0});
+    } catch (const std::exception& e) {
+        showErrorMessage("Error attaching shared segment: " + std::string(e.what()));
         return false;
     }
-    
-    // Clean and validate all loaded data
-    for (auto& [symbol, data] : loaded_data) {
+    refreshLiveSegments();
+    return true;
+}
+
+void VisualizationManager::refreshLiveSegments() {
+    for (auto& segment : live_segments_) {
+        const uint64_t publishes = segment.reader->publishes();
+        if (publishes == segment.shown) continue;
+        segment.shown = publishes;
+        
+        FeatureFrame data;
+        try {
+            data = DataManager::loadFromSharedSegment(*segment.reader);
+        } catch (const std::exception& e) {
+            showErrorMessage("Error reading shared segment: " + std::string(e.what()));
+            continue;
+        }
+        // Nothing published yet, or republished faster than it could be
+        // read; a newer publish is then already waiting for the next frame
+        if (data.empty()) continue;
+        
         DataManager::validateData(data);
-        DataManager::cleanData(data, false);
+        const std::string symbol = data.symbol;
+        // Without a path the frame is never evicted; the shown symbol picks
+        // the new frame up in renderMainDashboard()
+        symbols_.put(symbol, std::move(data));
+        if (current_symbol_.empty()) {
+            setCurrentSymbol(symbol);
+        }
     }
+}
+
+bool VisualizationManager::loadMultipleDataSources(const std::vector<std::string>& csv_paths) {
+    // Startup only records which symbols exist; thousands of files would
+    // otherwise take minutes and more memory than the machine has
+    auto entries = DataManager::indexSymbols(csv_paths);
     
-    // Merge with existing data
-    for (auto& [symbol, data] : loaded_data) {
-        symbol_data_[symbol] = std::move(data);
+    if (entries.empty()) {
+        showErrorMessage("Failed to load any data from provided paths");
+        return false;
     }
     
-    if (current_symbol_.empty() && !symbol_data_.empty()) {
-        current_symbol_ = symbol_data_.begin()->first;
+    symbols_.addToIndex(entries);
+    
+    if (current_symbol_.empty()) {
+        setCurrentSymbol(symbols_.symbols().front());
     }
     
-    showInfoMessage("Successfully loaded data for " + std::to_string(loaded_data.size()) + " symbols");
+    showInfoMessage("Indexed " + std::to_string(entries.size()) + " symbols");
     return true;
 }
 
 void VisualizationManager::setCurrentSymbol(const std::string& symbol) {
-    if (hasDataForSymbol(symbol)) {
-        current_symbol_ = symbol;
+    if (!hasDataForSymbol(symbol)) {
+        return;
     }
+    
+    auto data = symbols_.get(symbol);
+    if (!data) {
+        showErrorMessage("Failed to load data for: " + symbol);
+        return;
+    }
+    current_symbol_ = symbol;
+    current_data_ = std::move(data);
+    prefetchNeighbours(symbol);
+}
+
+void VisualizationManager::prefetchNeighbours(const std::string& symbol) {
+    const auto& all = symbols_.symbols();
+    const auto it = std::lower_bound(all.begin(), all.end(), symbol);
+    if (it == all.end() || *it != symbol) return;
+    
+    // Nearest first, alternating after and before
+    const size_t position = static_cast<size_t>(it - all.begin());
+    std::vector<std::string> neighbours;
+    for (size_t distance = 1; distance <= kPrefetchNeighbours; ++distance) {
+        if (position + distance < all.size()) neighbours.push_back(all[position + distance]);
+        if (position >= distance) neighbours.push_back(all[position - distance]);
+    }
+    symbols_.prefetch(neighbours);
 }
 
 void VisualizationManager::renderMainDashboard() {
     renderMainMenuBar();
+    refreshLiveSegments();
+    
+    // Keeps the shown symbol most recently used and takes in prefetched ones
+    if (!current_symbol_.empty()) {
+        if (auto data = symbols_.get(current_symbol_)) {
+            current_data_ = std::move(data);
+        }
+    }
     
-    if (symbol_data_.empty()) {
+    if (symbols_.symbols().empty()) {
         ImGui::Begin("No Data");
         ImGui::Text("No data loaded. Please load data files first.");
         if (ImGui::Button("Load Demo Data")) {
@@ -301,7 +450,7 @@ void VisualizationManager::renderMainDashboard() {
     }
     
     // Render symbol selector if multiple symbols available
-    if (symbol_data_.size() > 1) {
+    if (symbols_.symbols().size() > 1) {
         renderSymbolCombo();
     }
     
@@ -365,14 +514,18 @@ void VisualizationManager::renderSymbolSelector() {
     ImGui::Text("Available Symbols:");
     ImGui::Separator();
     
-    for (const auto& [symbol, data] : symbol_data_) {
+    for (const auto& symbol : symbols_.symbols()) {
         bool is_current = (symbol == current_symbol_);
         if (ImGui::Selectable(symbol.c_str(), is_current)) {
-            current_symbol_ = symbol;
+            setCurrentSymbol(symbol);
         }
         
         if (ImGui::IsItemHovered()) {
-            ImGui::SetTooltip("Data points: %zu", data.size());
+            if (auto data = symbols_.peek(symbol)) {
+                ImGui::SetTooltip("Data points: %zu", data->size());
+            } else {
+                ImGui::SetTooltip("Not loaded");
+            }
         }
     }
     
@@ -398,7 +551,7 @@ void VisualizationManager::renderComparisonDashboard() {
     // Symbol selection for comparison
     ImGui::Text("Select symbols to compare:");
     
-    for (const auto& [symbol, data] : symbol_data_) {
+    for (const auto& symbol : symbols_.symbols()) {
         bool selected = std::find(selected_symbols_for_comparison_.begin(), 
                                 selected_symbols_for_comparison_.end(), symbol) 
                        != selected_symbols_for_comparison_.end();
@@ -421,11 +574,14 @@ void VisualizationManager::renderComparisonDashboard() {
         
         // Create comparison charts for selected symbols
         // This is a simplified version - you could expand this significantly
+        // Loaded on first use; held here so a later load cannot evict them
+        // mid-frame
+        std::vector<std::shared_ptr<FeatureFrame>> compared;
         for (const auto& symbol : selected_symbols_for_comparison_) {
-            if (hasDataForSymbol(symbol)) {
-                const auto& data = symbol_data_.at(symbol);
-                auto price_chart = ChartFactory::createPriceChart(data, symbol);
+            if (auto data = symbols_.get(symbol)) {
+                auto price_chart = ChartFactory::createPriceChart(*data, symbol);
                 ChartFactory::renderChart(price_chart);
+                compared.push_back(std::move(data));
             }
         }
     }
@@ -455,11 +611,7 @@ void VisualizationManager::addFeature(const std::string& name,
 }
 
 std::vector<std::string> VisualizationManager::getAvailableSymbols() const {
-    std::vector<std::string> symbols;
-    for (const auto& [symbol, data] : symbol_data_) {
-        symbols.push_back(symbol);
-    }
-    return symbols;
+    return symbols_.symbols();
 }
 
 std::vector<std::string> VisualizationManager::getAvailableFeatures() const {
@@ -485,16 +637,17 @@ void VisualizationManager::setChartFilter(const ChartFilter& filter) {
 }
 
 bool VisualizationManager::hasDataForSymbol(const std::string& symbol) const {
-    return symbol_data_.find(symbol) != symbol_data_.end();
+    return symbols_.contains(symbol);
 }
 
 size_t VisualizationManager::getDataPointCount(const std::string& symbol) const {
     std::string target_symbol = symbol.empty() ? current_symbol_ : symbol;
     
-    if (hasDataForSymbol(target_symbol)) {
-        return symbol_data_.at(target_symbol).size();
+    if (target_symbol == current_symbol_ && current_data_) {
+        return current_data_->size();
     }
-    return 0;
+    auto data = symbols_.peek(target_symbol);
+    return data ? data->size() : 0;
 }
 
 void VisualizationManager::exportChartAsImage(const std::string& feature_name, 
@@ -511,29 +664,34 @@ void VisualizationManager::exportDashboardAsImages(const std::string& output_dir
 
 void VisualizationManager::loadDemoData() {
     // Create some demo data for testing
-    std::vector<FlexibleStockData> demo_data;
+    const int rows = 100;
+    FeatureFrame demo_data("DEMO", rows);
     
-    for (int i = 0; i < 100; ++i) {
-        FlexibleStockData point;
-        point.symbol = "DEMO";
-        point.datetime_index = static_cast<float>(i);
-        point.date_string = "2024-01-" + std::to_string(i % 30 + 1);
+    auto& registry = FeatureRegistry::getInstance();
+    auto& close = demo_data.column(registry.getFeatureId("close"));
+    auto& open = demo_data.column(registry.getFeatureId("open"));
+    auto& high = demo_data.column(registry.getFeatureId("high"));
+    auto& low = demo_data.column(registry.getFeatureId("low"));
+    auto& volume = demo_data.column(registry.getFeatureId("volume"));
+    auto& rsi = demo_data.column(registry.getFeatureId("rsi"));
+    auto& sma = demo_data.column(registry.getFeatureId("sma"));
+    
+    for (int i = 0; i < rows; ++i) {
+        demo_data.appendDate("2024-01-" + std::to_string(i % 30 + 1));
         
         // Generate some demo features
         double base_price = 100.0 + 10.0 * std::sin(i * 0.1);
-        point.setFeature("close", base_price);
-        point.setFeature("open", base_price + (rand() % 200 - 100) / 100.0);
-        point.setFeature("high", base_price + (rand() % 300) / 100.0);
-        point.setFeature("low", base_price - (rand() % 300) / 100.0);
-        point.setFeature("volume", 1000000 + rand() % 500000);
-        point.setFeature("rsi", 30 + (rand() % 40));
-        point.setFeature("sma", base_price + (rand() % 200 - 100) / 200.0);
-        
-        demo_data.push_back(point);
+        close[i] = base_price;
+        open[i] = base_price + (rand() % 200 - 100) / 100.0;
+        high[i] = base_price + (rand() % 300) / 100.0;
+        low[i] = base_price - (rand() % 300) / 100.0;
+        volume[i] = 1000000 + rand() % 500000;
+        rsi[i] = 30 + (rand() % 40);
+        sma[i] = base_price + (rand() % 200 - 100) / 200.0;
     }
     
-    symbol_data_["DEMO"] = std::move(demo_data);
-    current_symbol_ = "DEMO";
+    symbols_.put("DEMO", std::move(demo_data));
+    setCurrentSymbol("DEMO");
     
     showInfoMessage("Demo data loaded successfully!");
 }
@@ -551,24 +709,24 @@ void VisualizationManager::createExampleDashboard() {
 }
 
 // Private helper methods
-const std::vector<FlexibleStockData>& VisualizationManager::getCurrentData() const {
-    static std::vector<FlexibleStockData> empty_data;
+const FeatureFrame& VisualizationManager::getCurrentData() const {
+    static FeatureFrame empty_data;
     
-    if (current_symbol_.empty() || !hasDataForSymbol(current_symbol_)) {
+    if (current_symbol_.empty() || !current_data_) {
         return empty_data;
     }
     
-    return symbol_data_.at(current_symbol_);
+    return *current_data_;
 }
 
-std::vector<FlexibleStockData>& VisualizationManager::getCurrentData() {
-    static std::vector<FlexibleStockData> empty_data;
+FeatureFrame& VisualizationManager::getCurrentData() {
+    static FeatureFrame empty_data;
     
-    if (current_symbol_.empty() || !hasDataForSymbol(current_symbol_)) {
+    if (current_symbol_.empty() || !current_data_) {
         return empty_data;
     }
     
-    return symbol_data_[current_symbol_];
+    return *current_data_;
 }
 
 void VisualizationManager::renderMainMenuBar() {
@@ -612,10 +770,13 @@ void VisualizationManager::renderStatusBar() {
                 ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | 
                 ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoScrollbar);
     
-    ImGui::Text("Current Symbol: %s | Data Points: %zu | Features: %zu", 
+    ImGui::Text("Current Symbol: %s | Data Points: %zu | Features: %zu | Loaded: %zu/%zu symbols (%.0f MB)", 
                current_symbol_.c_str(),
                getDataPointCount(),
-               getAvailableFeatures().size());
+               getAvailableFeatures().size(),
+               symbols_.loadedCount(),
+               symbols_.symbols().size(),
+               symbols_.loadedBytes() / (1024.0 * 1024.0));
     
     ImGui::End();
 }
@@ -631,10 +792,10 @@ void VisualizationManager::renderSymbolCombo() {
     ImGui::SameLine();
     
     if (ImGui::BeginCombo("##symbol", current_symbol_.c_str())) {
-        for (const auto& [symbol, data] : symbol_data_) {
+        for (const auto& symbol : symbols_.symbols()) {
             bool is_selected = (symbol == current_symbol_);
             if (ImGui::Selectable(symbol.c_str(), is_selected)) {
-                current_symbol_ = symbol;
+                setCurrentSymbol(symbol);
             }
             if (is_selected) {
                 ImGui::SetItemDefaultFocus();
@@ -8,7 +8,7 @@ namespace Visualization {
 
 MultiSeriesChart ChartFactory::createFeatureChart(
     const std::string& feature_name,
-    const std::vector<FlexibleStockData>& data,
+    const FeatureFrame& data,
     const std::string& symbol) {
     
     auto config = createConfigForFeature(feature_name, symbol);
@@ -21,6 +21,7 @@ MultiSeriesChart ChartFactory::createFeatureChart(
         ChartData chart_data(feature_name);
         chart_data.x_values = time_indices;
         chart_data.y_values = feature_values;
+        chart_data.lod = data.pyramid(feature_name);
         
         // Get chart type from registry
         auto& registry = FeatureRegistry::getInstance();
@@ -38,7 +39,7 @@ MultiSeriesChart ChartFactory::createFeatureChart(
 
 MultiSeriesChart ChartFactory::createCategoryChart(
     FeatureCategory category,
-    const std::vector<FlexibleStockData>& data,
+    const FeatureFrame& data,
     const std::string& symbol) {
     
     auto config = createConfigForCategory(category, symbol);
@@ -57,6 +58,7 @@ MultiSeriesChart ChartFactory::createCategoryChart(
             ChartData chart_data(feature_name);
             chart_data.x_values = time_indices;
             chart_data.y_values = feature_values;
+            chart_data.lod = data.pyramid(feature_name);
             
             auto feature_meta = registry.getFeature(feature_name);
             if (feature_meta) {
@@ -79,7 +81,7 @@ MultiSeriesChart ChartFactory::createCategoryChart(
 
 MultiSeriesChart ChartFactory::createComparisonChart(
     const std::vector<std::string>& feature_names,
-    const std::vector<FlexibleStockData>& data,
+    const FeatureFrame& data,
     const std::string& title,
     const std::string& symbol) {
     
@@ -99,6 +101,7 @@ MultiSeriesChart ChartFactory::createComparisonChart(
             ChartData chart_data(feature_name);
             chart_data.x_values = time_indices;
             chart_data.y_values = feature_values;
+            chart_data.lod = data.pyramid(feature_name);
             
             applyFeatureColor(chart_data, feature_name);
             chart.addSeries(std::move(chart_data));
@@ -109,7 +112,7 @@ MultiSeriesChart ChartFactory::createComparisonChart(
 }
 
 MultiSeriesChart ChartFactory::createOHLCChart(
-    const std::vector<FlexibleStockData>& data,
+    const FeatureFrame& data,
     const std::string& symbol) {
     
     ChartConfig config("OHLC Price Chart");
@@ -120,6 +123,7 @@ MultiSeriesChart ChartFactory::createOHLCChart(
     config.height = 300.0f;
     
     MultiSeriesChart chart(config);
+    chart.ohlc = true;
     auto time_indices = extractTimeIndices(data);
     
     // Add OHLC series
@@ -138,6 +142,7 @@ MultiSeriesChart ChartFactory::createOHLCChart(
             ChartData chart_data(display_names[i]);
             chart_data.x_values = time_indices;
             chart_data.y_values = values;
+            chart_data.lod = data.pyramid(price_features[i]);
             chart_data.setColor(colors[i][0], colors[i][1], colors[i][2]);
             chart.addSeries(std::move(chart_data));
         }
@@ -147,7 +152,7 @@ MultiSeriesChart ChartFactory::createOHLCChart(
 }
 
 MultiSeriesChart ChartFactory::createVolumeChart(
-    const std::vector<FlexibleStockData>& data,
+    const FeatureFrame& data,
     const std::string& symbol) {
     
     ChartConfig config("Volume Analysis");
@@ -166,6 +171,7 @@ MultiSeriesChart ChartFactory::createVolumeChart(
         ChartData volume_data("Volume", ChartType::BAR);
         volume_data.x_values = time_indices;
         volume_data.y_values = volume_values;
+        volume_data.lod = data.pyramid("volume");
         volume_data.setColor(0.0f, 0.8f, 0.4f); // Green
         chart.addSeries(std::move(volume_data));
     }
@@ -176,6 +182,7 @@ MultiSeriesChart ChartFactory::createVolumeChart(
         ChartData sma_data("Volume SMA 20");
         sma_data.x_values = time_indices;
         sma_data.y_values = volume_sma_values;
+        sma_data.lod = data.pyramid("volume_sma_20");
         sma_data.setColor(1.0f, 0.5f, 0.0f); // Orange
         chart.addSeries(std::move(sma_data));
     }
@@ -184,7 +191,7 @@ MultiSeriesChart ChartFactory::createVolumeChart(
 }
 
 MultiSeriesChart ChartFactory::createPriceChart(
-    const std::vector<FlexibleStockData>& data,
+    const FeatureFrame& data,
     const std::string& symbol) {
     
     ChartConfig config("Price Chart");
@@ -203,6 +210,7 @@ MultiSeriesChart ChartFactory::createPriceChart(
         ChartData close_data("Close Price");
         close_data.x_values = time_indices;
         close_data.y_values = close_values;
+        close_data.lod = data.pyramid("close");
         close_data.setColor(0.2f, 0.6f, 1.0f); // Blue
         chart.addSeries(std::move(close_data));
     }
@@ -213,6 +221,7 @@ MultiSeriesChart ChartFactory::createPriceChart(
         ChartData sma_data("SMA");
         sma_data.x_values = time_indices;
         sma_data.y_values = sma_values;
+        sma_data.lod = data.pyramid("sma");
         sma_data.setColor(1.0f, 0.5f, 0.0f); // Orange
         chart.addSeries(std::move(sma_data));
     }
@@ -222,7 +231,7 @@ MultiSeriesChart ChartFactory::createPriceChart(
 
 MultiSeriesChart ChartFactory::createDistributionChart(
     const std::string& feature_name,
-    const std::vector<FlexibleStockData>& data,
+    const FeatureFrame& data,
     const std::string& symbol) {
     
     ChartConfig config("Distribution: " + feature_name);
@@ -289,6 +298,29 @@ void ChartFactory::renderChart(const MultiSeriesChart& chart) {
         // Use the first series' x_values as the common x-axis
         const auto& x_values = chart.series[0].x_values;
         
+        // Zoomed out, OHLC lines aggregate each bucket of bars instead of
+        // decimating the four series independently
+        if (chart.ohlc && chart.series.size() == 4) {
+            const auto& s = chart.series;
+            const PlotWindow window = Downsampler::currentWindow(x_values.size());
+            OHLCBuckets& bars = chart.ohlc_bars;
+            if (!chart.ohlc_valid || chart.ohlc_window != window) {
+                Downsampler::aggregateOHLC(s[0].y_values, s[1].y_values, s[2].y_values, s[3].y_values,
+                                           s[1].lod.get(), s[2].lod.get(), window, bars);
+                chart.ohlc_window = window;
+                chart.ohlc_valid = true;
+            }
+            const std::vector<float>* columns[4] = {&bars.open, &bars.high, &bars.low, &bars.close};
+            for (size_t i = 0; i < 4; ++i) {
+                ImPlot::PushStyleColor(ImPlotCol_Line, ImVec4(s[i].color[0], s[i].color[1], s[i].color[2], 1.0f));
+                ImPlot::PlotLine(s[i].series_name.c_str(), bars.x.data(), columns[i]->data(),
+                                 static_cast<int>(bars.x.size()));
+                ImPlot::PopStyleColor();
+            }
+            ImPlot::EndPlot();
+            return;
+        }
+        
         for (const auto& series : chart.series) {
             if (series.y_values.size() != x_values.size()) {
                 continue; // Skip mismatched series
@@ -324,22 +356,16 @@ void ChartFactory::renderChart(const MultiSeriesChart& chart) {
 }
 
 std::vector<float> ChartFactory::extractFeatureValues(
-    const std::vector<FlexibleStockData>& data,
+    const FeatureFrame& data,
     const std::string& feature_name) {
     
-    std::vector<float> values;
-    values.reserve(data.size());
+    // Empty when the frame has no such column
+    FeatureSpan column = data.column(feature_name);
+    std::vector<float> values(column.begin(), column.end());
     
-    for (const auto& data_point : data) {
-        if (data_point.hasFeature(feature_name)) {
-            double value = data_point.getFeature(feature_name);
-            if (!std::isnan(value) && !std::isinf(value)) {
-                values.push_back(static_cast<float>(value));
-            } else {
-                values.push_back(0.0f); // Replace invalid values with 0
-            }
-        } else {
-            values.push_back(0.0f); // Missing feature
+    for (float& value : values) {
+        if (!std::isfinite(value)) {
+            value = 0.0f; // Replace missing and invalid values with 0
         }
     }
     
@@ -347,7 +373,7 @@ std::vector<float> ChartFactory::extractFeatureValues(
 }
 
 std::vector<float> ChartFactory::extractTimeIndices(
-    const std::vector<FlexibleStockData>& data) {
+    const FeatureFrame& data) {
     
     std::vector<float> indices;
     indices.reserve(data.size());
@@ -410,19 +436,57 @@ ChartConfig ChartFactory::createConfigForCategory(
     return config;
 }
 
+const DecimatedSeries* ChartFactory::decimateSeries(const ChartData& data, const std::vector<float>& x_values,
+                                                    bool bars) {
+    // Short series (and histograms) keep their own x values
+    if (x_values.size() <= Downsampler::kMinPoints) {
+        return nullptr;
+    }
+    // Redone only when the view pans, zooms or resizes
+    const PlotWindow window = Downsampler::currentWindow(x_values.size());
+    if (data.lod_valid && data.lod_window == window) {
+        return &data.lod_points;
+    }
+    if (bars) {
+        Downsampler::decimateBars(data.y_values, data.lod.get(), window, data.lod_points);
+    } else {
+        Downsampler::decimate(data.y_values, data.lod.get(), window, data.lod_points);
+    }
+    data.lod_window = window;
+    data.lod_valid = true;
+    return &data.lod_points;
+}
+
 void ChartFactory::renderLineChart(const ChartData& data, const std::vector<float>& x_values) {
+    if (const DecimatedSeries* lod = decimateSeries(data, x_values, false)) {
+        ImPlot::PlotLine(data.series_name.c_str(), lod->x.data(), lod->y.data(), static_cast<int>(lod->x.size()));
+        return;
+    }
     ImPlot::PlotLine(data.series_name.c_str(), x_values.data(), data.y_values.data(), x_values.size());
 }
 
 void ChartFactory::renderBarChart(const ChartData& data, const std::vector<float>& x_values) {
+    if (const DecimatedSeries* lod = decimateSeries(data, x_values, true)) {
+        ImPlot::PlotBars(data.series_name.c_str(), lod->x.data(), lod->y.data(), static_cast<int>(lod->x.size()),
+                         0.8 * lod->width);
+        return;
+    }
     ImPlot::PlotBars(data.series_name.c_str(), x_values.data(), data.y_values.data(), x_values.size(), 0.8);
 }
 
 void ChartFactory::renderAreaChart(const ChartData& data, const std::vector<float>& x_values) {
+    if (const DecimatedSeries* lod = decimateSeries(data, x_values, false)) {
+        ImPlot::PlotShaded(data.series_name.c_str(), lod->x.data(), lod->y.data(), static_cast<int>(lod->x.size()));
+        return;
+    }
     ImPlot::PlotShaded(data.series_name.c_str(), x_values.data(), data.y_values.data(), x_values.size());
 }
 
 void ChartFactory::renderScatterChart(const ChartData& data, const std::vector<float>& x_values) {
+    if (const DecimatedSeries* lod = decimateSeries(data, x_values, false)) {
+        ImPlot::PlotScatter(data.series_name.c_str(), lod->x.data(), lod->y.data(), static_cast<int>(lod->x.size()));
+        return;
+    }
     ImPlot::PlotScatter(data.series_name.c_str(), x_values.data(), data.y_values.data(), x_values.size());
 }
 
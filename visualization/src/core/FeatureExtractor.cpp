@@ -2,33 +2,11 @@
 #include "../../feature_engineering/include/ohlcv_data.h"
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
 #include <cmath>
 
 namespace Visualization {
 
-// FlexibleStockData implementation
-double FlexibleStockData::getFeature(const std::string& name, double default_value) const {
-    auto it = features.find(name);
-    return (it != features.end()) ? it->second : default_value;
-}
-
-void FlexibleStockData::setFeature(const std::string& name, double value) {
-    features[name] = value;
-}
-
-bool FlexibleStockData::hasFeature(const std::string& name) const {
-    return features.find(name) != features.end();
-}
-
-std::vector<std::string> FlexibleStockData::getFeatureNames() const {
-    std::vector<std::string> names;
-    names.reserve(features.size());
-    for (const auto& pair : features) {
-        names.push_back(pair.first);
-    }
-    return names;
-}
-
 // FeatureExtractor static members
 std::unordered_map<std::string, FeatureExtractor::FeatureExtractorFunc> FeatureExtractor::feature_extractors_;
 bool FeatureExtractor::extractors_initialized_ = false;
@@ -102,6 +80,9 @@ void FeatureExtractor::initializeExtractors() {
     feature_extractors_["chow_test_statistic_breakpoint_detection_50"] = [](const FeatureSet& fs) { return extractVectorFromMember(fs.chow_test_statistic_breakpoint_detection_50); };
     feature_extractors_["market_regime_hmm_3_states_price_vol"] = [](const FeatureSet& fs) { return extractVectorFromMember(fs.market_regime_hmm_3_states_price_vol); };
     feature_extractors_["high_volatility_indicator_garch_threshold"] = [](const FeatureSet& fs) { return extractVectorFromMember(fs.high_volatility_indicator_garch_threshold); };
+    feature_extractors_["hmm_regime_probability_low_vol"] = [](const FeatureSet& fs) { return extractVectorFromMember(fs.hmm_regime_probability_low_vol); };
+    feature_extractors_["hmm_regime_probability_mid_vol"] = [](const FeatureSet& fs) { return extractVectorFromMember(fs.hmm_regime_probability_mid_vol); };
+    feature_extractors_["hmm_regime_probability_high_vol"] = [](const FeatureSet& fs) { return extractVectorFromMember(fs.hmm_regime_probability_high_vol); };
     
     // Non-linear/Interaction
     feature_extractors_["return_x_volume_interaction_10"] = [](const FeatureSet& fs) { return extractVectorFromMember(fs.return_x_volume_interaction_10); };
@@ -116,70 +97,60 @@ void FeatureExtractor::initializeExtractors() {
     feature_extractors_["sortino_ratio_30"] = [](const FeatureSet& fs) { return extractVectorFromMember(fs.sortino_ratio_30); };
 }
 
-std::vector<FlexibleStockData> FeatureExtractor::extractFromFeatureSet(
+FeatureFrame FeatureExtractor::extractFromFeatureSet(
     const std::string& symbol,
     const OHLCVData& ohlcv_data,
     const FeatureSet& feature_set) {
     
     ensureExtractorsInitialized();
     
-    std::vector<FlexibleStockData> result;
-    
     // Determine the size based on the largest available data
     size_t data_size = 0;
     if (!ohlcv_data.close.empty()) {
         data_size = ohlcv_data.close.size();
     } else if (!feature_set.returns.empty()) {
         data_size = feature_set.returns.size();
-    } else {
-        return result; // No data available
     }
     
-    result.reserve(data_size);
+    FeatureFrame frame(symbol, data_size);
+    if (data_size == 0) {
+        return frame; // No data available
+    }
     
-    // Convert timestamps to indices and strings
-    auto datetime_indices = convertTimestampsToIndices(ohlcv_data.timestamps);
+    // Date labels
     auto date_strings = convertTimestampsToStrings(ohlcv_data.timestamps);
-    
-    // Create FlexibleStockData for each time point
     for (size_t i = 0; i < data_size; ++i) {
-        FlexibleStockData data_point;
-        data_point.symbol = symbol;
-        
-        // Set timestamp information
-        if (i < ohlcv_data.timestamps.size()) {
-            data_point.timestamp = ohlcv_data.timestamps[i];
-            data_point.date_string = date_strings[i];
-            data_point.datetime_index = datetime_indices[i];
+        frame.appendDate(i < date_strings.size() ? date_strings[i] : std::string());
+    }
+    
+    auto& registry = FeatureRegistry::getInstance();
+    auto copy_column = [&](const std::string& name, const auto& values) {
+        if (values.empty()) return;
+        std::vector<float>& column = frame.column(registry.getFeatureId(name));
+        const size_t n = std::min(values.size(), data_size);
+        for (size_t i = 0; i < n; ++i) {
+            column[i] = static_cast<float>(values[i]);
         }
-        
-        // Add OHLCV data
-        if (i < ohlcv_data.open.size()) data_point.setFeature("open", ohlcv_data.open[i]);
-        if (i < ohlcv_data.high.size()) data_point.setFeature("high", ohlcv_data.high[i]);
-        if (i < ohlcv_data.low.size()) data_point.setFeature("low", ohlcv_data.low[i]);
-        if (i < ohlcv_data.close.size()) data_point.setFeature("close", ohlcv_data.close[i]);
-        if (i < ohlcv_data.volume.size()) data_point.setFeature("volume", ohlcv_data.volume[i]);
-        
-        // Extract all available features
-        for (const auto& extractor_pair : feature_extractors_) {
-            const std::string& feature_name = extractor_pair.first;
-            const auto& extractor_func = extractor_pair.second;
-            
-            try {
-                auto feature_vector = extractor_func(feature_set);
-                if (i < feature_vector.size() && !std::isnan(feature_vector[i])) {
-                    data_point.setFeature(feature_name, feature_vector[i]);
-                }
-            } catch (...) {
-                // Skip features that can't be extracted
-                continue;
-            }
+    };
+    
+    // Add OHLCV data
+    copy_column("open", ohlcv_data.open);
+    copy_column("high", ohlcv_data.high);
+    copy_column("low", ohlcv_data.low);
+    copy_column("close", ohlcv_data.close);
+    copy_column("volume", ohlcv_data.volume);
+    
+    // Extract each available feature once; NaN stays NaN (missing)
+    for (const auto& extractor_pair : feature_extractors_) {
+        try {
+            copy_column(extractor_pair.first, extractor_pair.second(feature_set));
+        } catch (...) {
+            // Skip features that can't be extracted
+            continue;
         }
-        
-        result.push_back(std::move(data_point));
     }
     
-    return result;
+    return frame;
 }
 
 std::vector<double> FeatureExtractor::extractFeatureVector(
@@ -0,0 +1,150 @@
+#include "core/FeatureFrame.h"
+#include <atomic>
+#include <limits>
+#include <utility>
+
+namespace Visualization {
+
+namespace {
+constexpr float kMissing = std::numeric_limits<float>::quiet_NaN();
+
+std::atomic<uint64_t> next_version{1};
+}
+
+FeatureFrame::FeatureFrame(std::string symbol, size_t rows)
+    : symbol(std::move(symbol)), rows_(rows) {}
+
+void FeatureFrame::resize(size_t rows) {
+    rows_ = rows;
+    pyramids_.clear();
+    version_ = 0;
+    for (FeatureId id : present_) {
+        columns_[id].resize(rows, kMissing);
+    }
+    if (date_ends_.size() > rows) {
+        date_ends_.resize(rows);
+        date_text_.resize(rows ? date_ends_.back() : 0);
+    }
+}
+
+void FeatureFrame::keepRows(const std::vector<char>& keep) {
+    size_t kept = 0;
+    for (size_t row = 0; row < rows_ && row < keep.size(); ++row) {
+        kept += keep[row] ? 1 : 0;
+    }
+
+    for (FeatureId id : present_) {
+        std::vector<float>& values = columns_[id];
+        size_t out = 0;
+        for (size_t row = 0; row < rows_; ++row) {
+            if (row < keep.size() && keep[row]) values[out++] = values[row];
+        }
+        values.resize(kept);
+    }
+
+    if (!date_ends_.empty()) {
+        std::string text;
+        std::vector<uint32_t> ends;
+        ends.reserve(kept);
+        for (size_t row = 0; row < date_ends_.size(); ++row) {
+            if (row < keep.size() && keep[row]) {
+                text += date(row);
+                ends.push_back(static_cast<uint32_t>(text.size()));
+            }
+        }
+        date_text_ = std::move(text);
+        date_ends_ = std::move(ends);
+    }
+    rows_ = kept;
+    pyramids_.clear();
+    version_ = 0;
+}
+
+std::vector<float>& FeatureFrame::column(FeatureId id) {
+    if (id >= columns_.size()) {
+        columns_.resize(id + 1);
+    }
+    if (id < pyramids_.size()) {
+        pyramids_[id].reset();
+    }
+    version_ = 0;
+    std::vector<float>& values = columns_[id];
+    if (values.empty() && rows_ > 0) {
+        values.assign(rows_, kMissing);
+        present_.push_back(id);
+    }
+    return values;
+}
+
+FeatureSpan FeatureFrame::column(FeatureId id) const {
+    if (!hasFeature(id)) {
+        return {};
+    }
+    return {columns_[id].data(), columns_[id].size()};
+}
+
+FeatureSpan FeatureFrame::column(const std::string& name) const {
+    return column(FeatureRegistry::getInstance().findFeatureId(name));
+}
+
+bool FeatureFrame::hasFeature(const std::string& name) const {
+    return hasFeature(FeatureRegistry::getInstance().findFeatureId(name));
+}
+
+std::shared_ptr<const MinMaxPyramid> FeatureFrame::pyramid(FeatureId id) const {
+    if (!hasFeature(id)) {
+        return nullptr;
+    }
+    if (id >= pyramids_.size()) {
+        pyramids_.resize(id + 1);
+    }
+    if (!pyramids_[id]) {
+        pyramids_[id] = std::make_shared<const MinMaxPyramid>(columns_[id]);
+    }
+    return pyramids_[id];
+}
+
+uint64_t FeatureFrame::version() const {
+    // Numbered lazily, so filling a column cell by cell costs nothing here
+    if (version_ == 0) {
+        version_ = next_version.fetch_add(1, std::memory_order_relaxed);
+    }
+    return version_;
+}
+
+std::shared_ptr<const MinMaxPyramid> FeatureFrame::pyramid(const std::string& name) const {
+    return pyramid(FeatureRegistry::getInstance().findFeatureId(name));
+}
+
+std::vector<std::string> FeatureFrame::getFeatureNames() const {
+    const auto& registry = FeatureRegistry::getInstance();
+    std::vector<std::string> names;
+    names.reserve(present_.size());
+    for (FeatureId id : present_) {
+        names.push_back(registry.getFeatureName(id));
+    }
+    return names;
+}
+
+size_t FeatureFrame::memoryBytes() const {
+    size_t bytes = date_text_.capacity() + date_ends_.capacity() * sizeof(uint32_t);
+    for (FeatureId id : present_) {
+        bytes += columns_[id].capacity() * sizeof(float);
+    }
+    return bytes;
+}
+
+void FeatureFrame::appendDate(std::string_view date) {
+    date_text_.append(date.data(), date.size());
+    date_ends_.push_back(static_cast<uint32_t>(date_text_.size()));
+}
+
+std::string_view FeatureFrame::date(size_t row) const {
+    if (row >= date_ends_.size()) {
+        return {};
+    }
+    const uint32_t begin = row ? date_ends_[row - 1] : 0;
+    return std::string_view(date_text_).substr(begin, date_ends_[row] - begin);
+}
+
+} // namespace Visualization
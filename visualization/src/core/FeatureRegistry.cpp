@@ -47,7 +47,8 @@ FeatureRegistry& FeatureRegistry::getInstance() {
 }
 
 void FeatureRegistry::registerFeature(const FeatureMetadata& metadata) {
-    features_[metadata.name] = metadata;
+    getFeatureId(metadata.name);
+    features_.insert_or_assign(metadata.name, metadata);
     updateCategoryMap(metadata.name, metadata.category);
 }
 
@@ -114,6 +115,30 @@ size_t FeatureRegistry::getFeatureCount() const {
     return features_.size();
 }
 
+FeatureId FeatureRegistry::getFeatureId(const std::string& name) {
+    std::lock_guard<std::mutex> lock(ids_mutex_);
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    const FeatureId id = static_cast<FeatureId>(id_names_.size());
+    id_names_.push_back(name);
+    ids_.emplace(name, id);
+    return id;
+}
+
+FeatureId FeatureRegistry::findFeatureId(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(ids_mutex_);
+    auto it = ids_.find(name);
+    return (it != ids_.end()) ? it->second : kInvalidFeatureId;
+}
+
+const std::string& FeatureRegistry::getFeatureName(FeatureId id) const {
+    static const std::string empty;
+    std::lock_guard<std::mutex> lock(ids_mutex_);
+    return (id < id_names_.size()) ? id_names_[id] : empty;
+}
+
 void FeatureRegistry::updateCategoryMap(const std::string& name, FeatureCategory category) {
     category_map_[category].push_back(name);
 }
@@ -182,6 +207,9 @@ void FeatureRegistry::initializeDefaultFeatures() {
     registerFeature("chow_test_statistic_breakpoint_detection_50", "Chow Test Breakpoint (50)", FeatureCategory::REGIME, ChartType::LINE);
     registerFeature("market_regime_hmm_3_states_price_vol", "Market Regime HMM (3-states)", FeatureCategory::REGIME, ChartType::LINE);
     registerFeature("high_volatility_indicator_garch_threshold", "High Volatility GARCH Threshold", FeatureCategory::REGIME, ChartType::LINE);
+    registerFeature("hmm_regime_probability_low_vol", "HMM Regime Probability (low vol)", FeatureCategory::REGIME, ChartType::LINE);
+    registerFeature("hmm_regime_probability_mid_vol", "HMM Regime Probability (mid vol)", FeatureCategory::REGIME, ChartType::LINE);
+    registerFeature("hmm_regime_probability_high_vol", "HMM Regime Probability (high vol)", FeatureCategory::REGIME, ChartType::LINE);
     
     // Non-linear/Interaction
     registerFeature("return_x_volume_interaction_10", "Return x Volume Interaction (10)", FeatureCategory::INTERACTION, ChartType::LINE);
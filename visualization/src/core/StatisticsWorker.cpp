@@ -0,0 +1,259 @@
+#include "core/StatisticsWorker.h"
+#include "simd_dispatch.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Visualization {
+
+StatisticsWorker::~StatisticsWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        jobs_.clear();
+    }
+    wake_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+std::shared_ptr<const FeatureStatistics> StatisticsWorker::request(const std::string& name,
+                                                                   const std::string& symbol,
+                                                                   const FeatureFrame& data,
+                                                                   const std::vector<std::string>& features,
+                                                                   bool correlation) {
+    const std::string key = name + "_" + symbol;
+    Posted& posted = posted_[key];
+    // Versions start at 1, so a fresh entry always resets
+    const bool reset = posted.version != data.version();
+    const bool changed = reset || posted.features != features || posted.correlation != correlation;
+
+    if (changed) {
+        Job job;
+        job.key = key;
+        job.version = data.version();
+        job.reset = reset;
+        job.correlation = correlation;
+        job.features = features;
+        if (reset) {
+            posted.sent.clear();
+        }
+        for (const auto& feature : features) {
+            if (posted.sent.count(feature) || job.columns.count(feature)) continue;
+            FeatureSpan column = data.column(feature);
+            job.columns.emplace(feature, std::vector<float>(column.begin(), column.end()));
+        }
+
+        posted.symbol = symbol;
+        posted.version = data.version();
+        posted.correlation = correlation;
+        posted.features = features;
+        posted.sent = std::unordered_set<std::string>(features.begin(), features.end());
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            // A queued job for the key is superseded, but columns it carries
+            // for the same version are still needed
+            auto queued = std::find_if(jobs_.begin(), jobs_.end(),
+                                       [&](const Job& other) { return other.key == key; });
+            if (queued != jobs_.end()) {
+                if (!job.reset) {
+                    job.reset = queued->reset;
+                    job.columns.merge(queued->columns);
+                }
+                *queued = std::move(job);
+            } else {
+                jobs_.push_back(std::move(job));
+            }
+        }
+        if (!worker_.joinable()) {
+            worker_ = std::thread(&StatisticsWorker::run, this);
+        }
+        wake_.notify_one();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = results_.find(key);
+    return it != results_.end() ? it->second : nullptr;
+}
+
+void StatisticsWorker::releaseSymbol(const std::string& symbol) {
+    std::vector<std::string> keys;
+    for (auto it = posted_.begin(); it != posted_.end();) {
+        if (it->second.symbol == symbol) {
+            keys.push_back(it->first);
+            it = posted_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (keys.empty()) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& key : keys) {
+        results_.erase(key);
+        jobs_.erase(std::remove_if(jobs_.begin(), jobs_.end(), [&](const Job& job) { return job.key == key; }),
+                    jobs_.end());
+        released_.push_back(key);
+    }
+    // The worker drops the states once it next runs
+    wake_.notify_one();
+}
+
+void StatisticsWorker::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [this] { return stopping_ || !jobs_.empty() || !released_.empty(); });
+        if (stopping_) return;
+        for (const auto& key : released_) {
+            states_.erase(key);
+        }
+        released_.clear();
+        if (jobs_.empty()) continue;
+
+        Job job = std::move(jobs_.front());
+        jobs_.pop_front();
+        lock.unlock();
+        compute(job);
+        lock.lock();
+    }
+}
+
+void StatisticsWorker::compute(Job& job) {
+    State& state = states_[job.key];
+    if (job.reset || state.version != job.version) {
+        state = State{};
+        state.version = job.version;
+    }
+    for (auto& [feature, values] : job.columns) {
+        state.columns[feature] = prepare(values);
+        // A new column invalidates its pairs
+        state.pairs.erase(feature);
+        for (auto& [other, row] : state.pairs) {
+            row.erase(feature);
+        }
+    }
+
+    // Features no longer asked for take their pairs with them
+    const std::unordered_set<std::string> wanted(job.features.begin(), job.features.end());
+    for (auto it = state.columns.begin(); it != state.columns.end();) {
+        if (wanted.count(it->first)) {
+            ++it;
+            continue;
+        }
+        state.pairs.erase(it->first);
+        for (auto& [other, row] : state.pairs) {
+            row.erase(it->first);
+        }
+        it = state.columns.erase(it);
+    }
+
+    auto result = std::make_shared<FeatureStatistics>();
+    result->data_version = job.version;
+    result->features = job.features;
+    const size_t n = job.features.size();
+    static const Column kMissing;
+    std::vector<const Column*> columns(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto it = state.columns.find(job.features[i]);
+        columns[i] = it != state.columns.end() ? &it->second : &kMissing;
+        result->summaries.push_back(columns[i]->summary);
+    }
+
+    if (job.correlation) {
+        result->correlation.assign(n * n, 0.0f);
+        for (size_t i = 0; i < n; ++i) {
+            result->correlation[i * n + i] = 1.0f; // Perfect correlation with self
+            for (size_t j = i + 1; j < n; ++j) {
+                const std::string& a = std::min(job.features[i], job.features[j]);
+                const std::string& b = std::max(job.features[i], job.features[j]);
+                auto& row = state.pairs[a];
+                auto cached = row.find(b);
+                if (cached == row.end()) {
+                    cached = row.emplace(b, correlate(*columns[i], *columns[j])).first;
+                }
+                result->correlation[i * n + j] = static_cast<float>(cached->second);
+                result->correlation[j * n + i] = static_cast<float>(cached->second);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Not if the symbol was released while this ran
+    if (std::find(released_.begin(), released_.end(), job.key) == released_.end()) {
+        results_[job.key] = std::move(result);
+    }
+}
+
+StatisticsWorker::Column StatisticsWorker::prepare(const std::vector<float>& values) {
+    const SimdKernels& kernels = simd_kernels();
+    Column column;
+    column.values.assign(values.begin(), values.end());
+    column.summary.count = values.size();
+
+    std::vector<double> finite;
+    finite.reserve(values.size());
+    column.first = values.size();
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (!std::isfinite(column.values[i])) continue;
+        if (finite.empty()) column.first = i;
+        column.last = i + 1;
+        finite.push_back(column.values[i]);
+    }
+    column.dense = finite.size() == column.last - std::min(column.first, column.last);
+
+    FeatureSummary& summary = column.summary;
+    summary.valid_count = finite.size();
+    if (finite.empty()) return column;
+
+    const double count = static_cast<double>(finite.size());
+    summary.mean = kernels.sum(finite.data(), finite.size()) / count;
+    summary.std_dev = std::sqrt(kernels.squared_deviation_sum(finite.data(), finite.size(), summary.mean) / count);
+    auto minmax = std::minmax_element(finite.begin(), finite.end());
+    summary.min_val = *minmax.first;
+    summary.max_val = *minmax.second;
+
+    const size_t middle = finite.size() / 2;
+    std::nth_element(finite.begin(), finite.begin() + middle, finite.end());
+    summary.median = finite[middle];
+    if (finite.size() % 2 == 0) {
+        summary.median = (*std::max_element(finite.begin(), finite.begin() + middle) + summary.median) / 2.0;
+    }
+    return column;
+}
+
+double StatisticsWorker::correlate(const Column& a, const Column& b) {
+    const size_t first = std::max(a.first, b.first);
+    const size_t last = std::min(a.last, b.last);
+    if (last <= first) return 0.0;
+
+    // Complete cases: contiguous when neither column has gaps, else gathered
+    const double* x = a.values.data() + first;
+    const double* y = b.values.data() + first;
+    size_t count = last - first;
+    if (!a.dense || !b.dense) {
+        scratch_x_.clear();
+        scratch_y_.clear();
+        for (size_t i = first; i < last; ++i) {
+            if (std::isfinite(a.values[i]) && std::isfinite(b.values[i])) {
+                scratch_x_.push_back(a.values[i]);
+                scratch_y_.push_back(b.values[i]);
+            }
+        }
+        x = scratch_x_.data();
+        y = scratch_y_.data();
+        count = scratch_x_.size();
+    }
+    if (count < 2) return 0.0;
+
+    // Pearson on the shared kernels, as SIMDStatistics::calculateCorrelation_SIMD
+    const SimdKernels& kernels = simd_kernels();
+    const double mean_x = kernels.sum(x, count) / count;
+    const double mean_y = kernels.sum(y, count) / count;
+    double products[3];
+    kernels.centered_products(x, y, count, mean_x, mean_y, products);
+    const double denominator = std::sqrt(products[1] * products[2]);
+    return denominator > 0.0 ? products[0] / denominator : 0.0;
+}
+
+} // namespace Visualization
@@ -0,0 +1,177 @@
+#include "core/SymbolCache.h"
+#include <algorithm>
+
+namespace Visualization {
+
+SymbolCache::SymbolCache(Loader loader, size_t budget_bytes)
+    : loader_(std::move(loader)), budget_bytes_(budget_bytes) {}
+
+SymbolCache::~SymbolCache() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        queue_.clear();
+    }
+    wake_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void SymbolCache::addToIndex(const std::vector<SymbolIndexEntry>& entries) {
+    const size_t sorted = symbols_.size();
+    for (const auto& entry : entries) {
+        auto it = index_.find(entry.symbol);
+        if (it == index_.end()) {
+            symbols_.push_back(entry.symbol);
+            index_.emplace(entry.symbol, entry);
+        } else {
+            it->second = entry;
+            erase(entry.symbol);
+        }
+    }
+    std::sort(symbols_.begin() + sorted, symbols_.end());
+    std::inplace_merge(symbols_.begin(), symbols_.begin() + sorted, symbols_.end());
+}
+
+void SymbolCache::put(const std::string& symbol, FeatureFrame frame, const std::string& path) {
+    SymbolIndexEntry entry;
+    entry.symbol = symbol;
+    entry.path = path;
+    addToIndex({entry});
+    insertLoaded(symbol, std::make_shared<FeatureFrame>(std::move(frame)), true);
+    evict();
+}
+
+std::shared_ptr<FeatureFrame> SymbolCache::get(const std::string& symbol) {
+    adoptPrefetched();
+
+    auto it = loaded_.find(symbol);
+    if (it != loaded_.end()) {
+        // Callers may have edited the frame since it was last counted
+        Loaded& entry = it->second;
+        loaded_bytes_ -= entry.bytes;
+        entry.bytes = entry.frame->memoryBytes();
+        loaded_bytes_ += entry.bytes;
+        lru_.splice(lru_.begin(), lru_, entry.lru);
+        std::shared_ptr<FeatureFrame> frame = entry.frame;
+        evict();
+        return frame;
+    }
+
+    auto indexed = index_.find(symbol);
+    if (indexed == index_.end() || indexed->second.path.empty()) {
+        return nullptr;
+    }
+
+    // Needed now: load here rather than wait behind the prefetch queue
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.erase(std::remove_if(queue_.begin(), queue_.end(),
+                                    [&](const SymbolIndexEntry& queued) { return queued.symbol == symbol; }),
+                     queue_.end());
+    }
+    auto frame = std::make_shared<FeatureFrame>(loader_(indexed->second.path));
+    if (frame->empty()) {
+        return nullptr;
+    }
+    insertLoaded(symbol, frame, true);
+    evict();
+    return frame;
+}
+
+std::shared_ptr<const FeatureFrame> SymbolCache::peek(const std::string& symbol) const {
+    auto it = loaded_.find(symbol);
+    return it != loaded_.end() ? it->second.frame : nullptr;
+}
+
+void SymbolCache::prefetch(const std::vector<std::string>& symbols) {
+    std::deque<SymbolIndexEntry> wanted;
+    for (const auto& symbol : symbols) {
+        auto it = index_.find(symbol);
+        if (it != index_.end() && !it->second.path.empty() && !isLoaded(symbol)) {
+            wanted.push_back(it->second);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_ = std::move(wanted);
+        if (queue_.empty()) return;
+    }
+    if (!worker_.joinable()) {
+        worker_ = std::thread(&SymbolCache::runPrefetch, this);
+    }
+    wake_.notify_one();
+}
+
+void SymbolCache::setMemoryBudget(size_t bytes) {
+    budget_bytes_ = bytes;
+    evict();
+}
+
+void SymbolCache::adoptPrefetched() {
+    std::vector<std::pair<std::string, std::shared_ptr<FeatureFrame>>> arrived;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (prefetched_.empty()) return;
+        arrived.swap(prefetched_);
+    }
+    for (auto& [symbol, frame] : arrived) {
+        // Skip symbols loaded on demand meanwhile or dropped from the index
+        if (frame->empty() || isLoaded(symbol) || !contains(symbol)) continue;
+        // Not used yet, so first in line for eviction
+        insertLoaded(symbol, std::move(frame), false);
+    }
+    evict();
+}
+
+void SymbolCache::insertLoaded(const std::string& symbol, std::shared_ptr<FeatureFrame> frame, bool most_recent) {
+    erase(symbol);
+    const size_t bytes = frame->memoryBytes();
+    auto position = most_recent ? lru_.insert(lru_.begin(), symbol) : lru_.insert(lru_.end(), symbol);
+    loaded_.emplace(symbol, Loaded{std::move(frame), bytes, position});
+    loaded_bytes_ += bytes;
+}
+
+void SymbolCache::erase(const std::string& symbol) {
+    auto it = loaded_.find(symbol);
+    if (it == loaded_.end()) return;
+    loaded_bytes_ -= it->second.bytes;
+    lru_.erase(it->second.lru);
+    loaded_.erase(it);
+}
+
+void SymbolCache::evict() {
+    // The most recently used frame stays even when it alone is over budget
+    auto candidate = lru_.end();
+    while (loaded_bytes_ > budget_bytes_ && candidate != lru_.begin()) {
+        --candidate;
+        if (candidate == lru_.begin()) break;
+        const std::string symbol = *candidate;
+        auto indexed = index_.find(symbol);
+        if (indexed != index_.end() && indexed->second.path.empty()) continue;   // cannot be reloaded
+        candidate = std::next(candidate);
+        erase(symbol);
+        if (on_evict_) {
+            on_evict_(symbol);
+        }
+    }
+}
+
+void SymbolCache::runPrefetch() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (stopping_) return;
+        SymbolIndexEntry entry = std::move(queue_.front());
+        queue_.pop_front();
+
+        lock.unlock();
+        auto frame = std::make_shared<FeatureFrame>(loader_(entry.path));
+        lock.lock();
+        prefetched_.emplace_back(std::move(entry.symbol), std::move(frame));
+    }
+}
+
+} // namespace Visualization
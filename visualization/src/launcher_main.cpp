@@ -209,6 +209,7 @@ int main() {
         glfwSwapBuffers(window);
     }
     
+    pairsVisualizer.releaseGraphics();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImPlot::DestroyContext();
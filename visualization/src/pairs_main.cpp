@@ -107,6 +107,7 @@ int main() {
         glfwSwapBuffers(window);
     }
     
+    visualizer.releaseGraphics();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImPlot::DestroyContext();
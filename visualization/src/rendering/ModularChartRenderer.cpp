@@ -2,7 +2,6 @@
 #include "imgui.h"
 #include "implot.h"
 #include <algorithm>
-#include <numeric>
 #include <cmath>
 #include <sstream>
 
@@ -56,6 +55,16 @@ bool ChartFilter::isCategoryEnabled(FeatureCategory category) const {
     }
 }
 
+bool ChartFilter::operator==(const ChartFilter& other) const {
+    return enabled_categories == other.enabled_categories &&
+           enabled_features == other.enabled_features &&
+           disabled_features == other.disabled_features &&
+           show_price_charts == other.show_price_charts &&
+           show_volume_charts == other.show_volume_charts &&
+           show_technical_indicators == other.show_technical_indicators &&
+           show_statistical_features == other.show_statistical_features;
+}
+
 // ModularChartRenderer implementation
 ModularChartRenderer::ModularChartRenderer()
     : layout_(DashboardLayout::LayoutType::GRID, 2, 3),
@@ -70,7 +79,7 @@ ModularChartRenderer::ModularChartRenderer()
     selected_categories_ = registry.getAllCategories();
 }
 
-void ModularChartRenderer::renderDashboard(const std::vector<FlexibleStockData>& data, 
+void ModularChartRenderer::renderDashboard(const FeatureFrame& data, 
                                          const std::string& symbol) {
     if (data.empty()) {
         ImGui::Text("No data available for visualization");
@@ -102,20 +111,23 @@ void ModularChartRenderer::renderDashboard(const std::vector<FlexibleStockData>&
         }
     }
     
+    // The controls above may have edited the filter
+    syncChartFilter();
+    
     // Generate charts based on current selection
-    std::vector<MultiSeriesChart> charts;
+    std::vector<const MultiSeriesChart*> charts;
     std::vector<std::string> chart_names;
     
     // Always include price and volume overview
     if (filter_.show_price_charts) {
-        auto price_chart = ChartFactory::createPriceChart(data, symbol);
-        charts.push_back(std::move(price_chart));
+        charts.push_back(&cachedChart(generateCacheKey("price", "", symbol.empty() ? data.symbol : symbol), data,
+                                      [&] { return ChartFactory::createPriceChart(data, symbol); }));
         chart_names.push_back("Price Overview");
     }
     
     if (filter_.show_volume_charts) {
-        auto volume_chart = ChartFactory::createVolumeChart(data, symbol);
-        charts.push_back(std::move(volume_chart));
+        charts.push_back(&cachedChart(generateCacheKey("volume", "", symbol.empty() ? data.symbol : symbol), data,
+                                      [&] { return ChartFactory::createVolumeChart(data, symbol); }));
         chart_names.push_back("Volume Analysis");
     }
     
@@ -147,8 +159,9 @@ void ModularChartRenderer::renderDashboard(const std::vector<FlexibleStockData>&
     }
 }
 
-void ModularChartRenderer::renderCategoryDashboard(const std::vector<FlexibleStockData>& data,
+void ModularChartRenderer::renderCategoryDashboard(const FeatureFrame& data,
                                                  const std::string& symbol) {
+    syncChartFilter();
     auto charts = generateCategoryCharts(data, symbol);
     std::vector<std::string> chart_names;
     
@@ -162,47 +175,63 @@ void ModularChartRenderer::renderCategoryDashboard(const std::vector<FlexibleSto
     renderTabLayout(charts, chart_names);
 }
 
-void ModularChartRenderer::renderCustomDashboard(const std::vector<FlexibleStockData>& data,
+void ModularChartRenderer::renderCustomDashboard(const FeatureFrame& data,
                                                 const std::vector<std::string>& selected_features,
                                                 const std::string& symbol) {
+    syncChartFilter();
     auto charts = generateFeatureCharts(data, selected_features, symbol);
     renderGridLayout(charts);
 }
 
 void ModularChartRenderer::renderFeatureChart(const std::string& feature_name,
-                                            const std::vector<FlexibleStockData>& data,
+                                            const FeatureFrame& data,
                                             const std::string& symbol) {
-    auto chart = ChartFactory::createFeatureChart(feature_name, data, symbol);
+    syncChartFilter();
+    const auto& chart = cachedChart(generateCacheKey("feature", feature_name, symbol.empty() ? data.symbol : symbol),
+                                    data, [&] { return ChartFactory::createFeatureChart(feature_name, data, symbol); });
     ChartFactory::renderChart(chart);
 }
 
 void ModularChartRenderer::renderCategoryChart(FeatureCategory category,
-                                             const std::vector<FlexibleStockData>& data,
+                                             const FeatureFrame& data,
                                              const std::string& symbol) {
-    auto chart = ChartFactory::createCategoryChart(category, data, symbol);
+    syncChartFilter();
+    const auto& chart = cachedChart(
+        generateCacheKey("category", std::to_string(static_cast<int>(category)), symbol.empty() ? data.symbol : symbol),
+        data, [&] { return ChartFactory::createCategoryChart(category, data, symbol); });
     ChartFactory::renderChart(chart);
 }
 
 void ModularChartRenderer::renderComparisonChart(const std::vector<std::string>& feature_names,
-                                               const std::vector<FlexibleStockData>& data,
+                                               const FeatureFrame& data,
                                                const std::string& title,
                                                const std::string& symbol) {
-    auto chart = ChartFactory::createComparisonChart(feature_names, data, title, symbol);
+    syncChartFilter();
+    std::string identifier = title;
+    for (const auto& feature : feature_names) {
+        identifier += "|" + feature;
+    }
+    const auto& chart = cachedChart(generateCacheKey("comparison", identifier, symbol.empty() ? data.symbol : symbol),
+                                    data, [&] {
+        return ChartFactory::createComparisonChart(feature_names, data, title, symbol);
+    });
     ChartFactory::renderChart(chart);
 }
 
-void ModularChartRenderer::renderPriceVolumeOverview(const std::vector<FlexibleStockData>& data,
+void ModularChartRenderer::renderPriceVolumeOverview(const FeatureFrame& data,
                                                    const std::string& symbol) {
+    const std::string& key_symbol = symbol.empty() ? data.symbol : symbol;
+    
     // Price chart
-    auto price_chart = ChartFactory::createPriceChart(data, symbol);
-    ChartFactory::renderChart(price_chart);
+    ChartFactory::renderChart(cachedChart(generateCacheKey("price", "", key_symbol), data,
+                                          [&] { return ChartFactory::createPriceChart(data, symbol); }));
     
     // Volume chart
-    auto volume_chart = ChartFactory::createVolumeChart(data, symbol);
-    ChartFactory::renderChart(volume_chart);
+    ChartFactory::renderChart(cachedChart(generateCacheKey("volume", "", key_symbol), data,
+                                          [&] { return ChartFactory::createVolumeChart(data, symbol); }));
 }
 
-void ModularChartRenderer::renderStatisticalSummary(const std::vector<FlexibleStockData>& data,
+void ModularChartRenderer::renderStatisticalSummary(const FeatureFrame& data,
                                                   const std::string& symbol) {
     if (data.empty()) return;
     
@@ -212,6 +241,18 @@ void ModularChartRenderer::renderStatisticalSummary(const std::vector<FlexibleSt
     // Get available features
     auto available_features = getAvailableFeatures(data);
     
+    // Summaries come from the worker; an older result is shown until the
+    // fresh one arrives
+    auto statistics = statistics_.request("summary", symbol.empty() ? data.symbol : symbol, data,
+                                          available_features, false);
+    if (!statistics) {
+        ImGui::Text("Computing statistics...");
+        return;
+    }
+    if (!statistics->describes(data, available_features)) {
+        ImGui::TextDisabled("Updating...");
+    }
+    
     // Display statistics in columns
     ImGui::Columns(4, "StatsColumns");
     ImGui::Text("Feature");
@@ -224,10 +265,11 @@ void ModularChartRenderer::renderStatisticalSummary(const std::vector<FlexibleSt
     ImGui::NextColumn();
     ImGui::Separator();
     
-    for (const auto& feature : available_features) {
+    for (size_t i = 0; i < statistics->features.size(); ++i) {
+        const std::string& feature = statistics->features[i];
         if (!filter_.isFeatureEnabled(feature)) continue;
         
-        auto stats = calculateFeatureStatistics(feature, data);
+        const FeatureSummary& stats = statistics->summaries[i];
         if (stats.valid_count == 0) continue;
         
         ImGui::Text("%s", feature.c_str());
@@ -243,7 +285,7 @@ void ModularChartRenderer::renderStatisticalSummary(const std::vector<FlexibleSt
     ImGui::Columns(1);
 }
 
-void ModularChartRenderer::renderFeatureCorrelationMatrix(const std::vector<FlexibleStockData>& data,
+void ModularChartRenderer::renderFeatureCorrelationMatrix(const FeatureFrame& data,
                                                         const std::vector<std::string>& features,
                                                         const std::string& symbol) {
     if (features.size() < 2) {
@@ -251,7 +293,18 @@ void ModularChartRenderer::renderFeatureCorrelationMatrix(const std::vector<Flex
         return;
     }
     
-    auto correlation_matrix = calculateCorrelationMatrix(features, data);
+    // The matrix is O(features^2 * rows), so it is computed off the UI
+    // thread; the last one finished is drawn meanwhile
+    auto statistics = statistics_.request("correlation", symbol.empty() ? data.symbol : symbol, data,
+                                          features, true);
+    if (!statistics) {
+        ImGui::Text("Computing correlation matrix...");
+        return;
+    }
+    if (!statistics->describes(data, features)) {
+        ImGui::TextDisabled("Updating...");
+    }
+    const int size = static_cast<int>(statistics->features.size());
     
     std::string title = "Feature Correlation Matrix";
     if (!symbol.empty()) {
@@ -261,16 +314,8 @@ void ModularChartRenderer::renderFeatureCorrelationMatrix(const std::vector<Flex
     if (ImPlot::BeginPlot(title.c_str(), ImVec2(-1, 400))) {
         ImPlot::SetupAxes("Features", "Features");
         
-        // Create heatmap data
-        std::vector<float> heatmap_data;
-        for (const auto& row : correlation_matrix) {
-            for (double val : row) {
-                heatmap_data.push_back(static_cast<float>(val));
-            }
-        }
-        
-        ImPlot::PlotHeatmap("Correlation", heatmap_data.data(), 
-                           features.size(), features.size(),
+        ImPlot::PlotHeatmap("Correlation", statistics->correlation.data(), 
+                           size, size,
                            -1.0, 1.0, nullptr);
         
         ImPlot::EndPlot();
@@ -283,14 +328,27 @@ void ModularChartRenderer::setDashboardLayout(const DashboardLayout& layout) {
 
 void ModularChartRenderer::setChartFilter(const ChartFilter& filter) {
     filter_ = filter;
-    clearChartCache(); // Clear cache when filter changes
+    syncChartFilter();
 }
 
-std::vector<std::string> ModularChartRenderer::getAvailableFeatures(const std::vector<FlexibleStockData>& data) const {
+void ModularChartRenderer::releaseSymbol(const std::string& symbol) {
+    // Keys end in "_<symbol>" (see generateCacheKey); a symbol that merely
+    // ends the same way only costs a rebuild
+    const std::string suffix = "_" + symbol;
+    for (auto it = chart_cache_.begin(); it != chart_cache_.end();) {
+        const std::string& key = it->first;
+        const bool match = key.size() >= suffix.size() &&
+                           key.compare(key.size() - suffix.size(), suffix.size(), suffix) == 0;
+        it = match ? chart_cache_.erase(it) : std::next(it);
+    }
+    statistics_.releaseSymbol(symbol);
+}
+
+std::vector<std::string> ModularChartRenderer::getAvailableFeatures(const FeatureFrame& data) const {
     if (data.empty()) return {};
     
-    // Get features from the first data point
-    auto feature_names = data[0].getFeatureNames();
+    // Columns present in the frame
+    auto feature_names = data.getFeatureNames();
     
     // Filter based on current filter settings
     std::vector<std::string> filtered_features;
@@ -303,7 +361,7 @@ std::vector<std::string> ModularChartRenderer::getAvailableFeatures(const std::v
     return filtered_features;
 }
 
-std::vector<FeatureCategory> ModularChartRenderer::getAvailableCategories(const std::vector<FlexibleStockData>& data) const {
+std::vector<FeatureCategory> ModularChartRenderer::getAvailableCategories(const FeatureFrame& data) const {
     auto& registry = FeatureRegistry::getInstance();
     auto all_categories = registry.getAllCategories();
     
@@ -317,7 +375,7 @@ std::vector<FeatureCategory> ModularChartRenderer::getAvailableCategories(const
     return available_categories;
 }
 
-void ModularChartRenderer::renderFeatureSelector(const std::vector<FlexibleStockData>& data) {
+void ModularChartRenderer::renderFeatureSelector(const FeatureFrame& data) {
     ImGui::Begin("Feature Selector", &show_feature_selector_);
     
     auto available_features = getAvailableFeatures(data);
@@ -403,25 +461,29 @@ void ModularChartRenderer::renderChartControls() {
     ImGui::Text("Chart Controls - Coming Soon");
 }
 
-void ModularChartRenderer::renderDataStatistics(const std::vector<FlexibleStockData>& data) {
+void ModularChartRenderer::renderDataStatistics(const FeatureFrame& data) {
     if (data.empty()) return;
     
     ImGui::Text("Data Statistics:");
     ImGui::Text("Total Data Points: %zu", data.size());
-    ImGui::Text("Available Features: %zu", data[0].getFeatureNames().size());
+    ImGui::Text("Available Features: %zu", data.featureIds().size());
     
-    if (!data.empty()) {
-        ImGui::Text("Date Range: %s to %s", 
-                   data.front().date_string.c_str(),
-                   data.back().date_string.c_str());
-    }
+    const std::string first_date(data.date(0));
+    const std::string last_date(data.date(data.size() - 1));
+    ImGui::Text("Date Range: %s to %s", first_date.c_str(), last_date.c_str());
 }
 
 void ModularChartRenderer::renderFeatureStatistics(const std::string& feature_name,
-                                                  const std::vector<FlexibleStockData>& data) {
-    auto stats = calculateFeatureStatistics(feature_name, data);
+                                                  const FeatureFrame& data) {
+    const std::vector<std::string> features = {feature_name};
+    auto statistics = statistics_.request("statistics_" + feature_name, data.symbol, data, features, false);
     
     ImGui::Text("Feature: %s", feature_name.c_str());
+    if (!statistics) {
+        ImGui::Text("Computing statistics...");
+        return;
+    }
+    const FeatureSummary& stats = statistics->summaries.front();
     ImGui::Text("Valid Points: %zu / %zu", stats.valid_count, stats.count);
     ImGui::Text("Mean: %.6f", stats.mean);
     ImGui::Text("Std Dev: %.6f", stats.std_dev);
@@ -432,7 +494,7 @@ void ModularChartRenderer::renderFeatureStatistics(const std::string& feature_na
 
 // Private helper methods implementation
 
-void ModularChartRenderer::renderGridLayout(const std::vector<MultiSeriesChart>& charts) {
+void ModularChartRenderer::renderGridLayout(const std::vector<const MultiSeriesChart*>& charts) {
     if (charts.empty()) return;
     
     int cols = layout_.columns;
@@ -443,19 +505,19 @@ void ModularChartRenderer::renderGridLayout(const std::vector<MultiSeriesChart>&
             if (col > 0) ImGui::SameLine();
             
             int chart_index = row * cols + col;
-            ChartFactory::renderChart(charts[chart_index]);
+            ChartFactory::renderChart(*charts[chart_index]);
         }
     }
 }
 
-void ModularChartRenderer::renderTabLayout(const std::vector<MultiSeriesChart>& charts,
+void ModularChartRenderer::renderTabLayout(const std::vector<const MultiSeriesChart*>& charts,
                                          const std::vector<std::string>& tab_names) {
     if (charts.empty()) return;
     
     if (ImGui::BeginTabBar("ChartTabs")) {
         for (size_t i = 0; i < charts.size() && i < tab_names.size(); ++i) {
             if (ImGui::BeginTabItem(tab_names[i].c_str())) {
-                ChartFactory::renderChart(charts[i]);
+                ChartFactory::renderChart(*charts[i]);
                 ImGui::EndTabItem();
             }
         }
@@ -463,26 +525,29 @@ void ModularChartRenderer::renderTabLayout(const std::vector<MultiSeriesChart>&
     }
 }
 
-void ModularChartRenderer::renderAccordionLayout(const std::vector<MultiSeriesChart>& charts,
+void ModularChartRenderer::renderAccordionLayout(const std::vector<const MultiSeriesChart*>& charts,
                                                 const std::vector<std::string>& section_names) {
     for (size_t i = 0; i < charts.size() && i < section_names.size(); ++i) {
         if (ImGui::CollapsingHeader(section_names[i].c_str())) {
-            ChartFactory::renderChart(charts[i]);
+            ChartFactory::renderChart(*charts[i]);
         }
     }
 }
 
-std::vector<MultiSeriesChart> ModularChartRenderer::generateCategoryCharts(
-    const std::vector<FlexibleStockData>& data,
+std::vector<const MultiSeriesChart*> ModularChartRenderer::generateCategoryCharts(
+    const FeatureFrame& data,
     const std::string& symbol) {
     
-    std::vector<MultiSeriesChart> charts;
+    std::vector<const MultiSeriesChart*> charts;
+    const std::string& key_symbol = symbol.empty() ? data.symbol : symbol;
     
     for (const auto& category : selected_categories_) {
         if (filter_.isCategoryEnabled(category)) {
-            auto chart = ChartFactory::createCategoryChart(category, data, symbol);
+            const auto& chart = cachedChart(
+                generateCacheKey("category", std::to_string(static_cast<int>(category)), key_symbol), data,
+                [&] { return ChartFactory::createCategoryChart(category, data, symbol); });
             if (!chart.series.empty()) {
-                charts.push_back(std::move(chart));
+                charts.push_back(&chart);
             }
         }
     }
@@ -490,18 +555,20 @@ std::vector<MultiSeriesChart> ModularChartRenderer::generateCategoryCharts(
     return charts;
 }
 
-std::vector<MultiSeriesChart> ModularChartRenderer::generateFeatureCharts(
-    const std::vector<FlexibleStockData>& data,
+std::vector<const MultiSeriesChart*> ModularChartRenderer::generateFeatureCharts(
+    const FeatureFrame& data,
     const std::vector<std::string>& features,
     const std::string& symbol) {
     
-    std::vector<MultiSeriesChart> charts;
+    std::vector<const MultiSeriesChart*> charts;
+    const std::string& key_symbol = symbol.empty() ? data.symbol : symbol;
     
     for (const auto& feature : features) {
         if (filter_.isFeatureEnabled(feature)) {
-            auto chart = ChartFactory::createFeatureChart(feature, data, symbol);
+            const auto& chart = cachedChart(generateCacheKey("feature", feature, key_symbol), data,
+                                            [&] { return ChartFactory::createFeatureChart(feature, data, symbol); });
             if (!chart.series.empty()) {
-                charts.push_back(std::move(chart));
+                charts.push_back(&chart);
             }
         }
     }
@@ -509,110 +576,6 @@ std::vector<MultiSeriesChart> ModularChartRenderer::generateFeatureCharts(
     return charts;
 }
 
-ModularChartRenderer::FeatureStats ModularChartRenderer::calculateFeatureStatistics(
-    const std::string& feature_name,
-    const std::vector<FlexibleStockData>& data) const {
-    
-    FeatureStats stats = {};
-    stats.count = data.size();
-    
-    std::vector<double> valid_values;
-    for (const auto& data_point : data) {
-        if (data_point.hasFeature(feature_name)) {
-            double value = data_point.getFeature(feature_name);
-            if (!std::isnan(value) && !std::isinf(value)) {
-                valid_values.push_back(value);
-            }
-        }
-    }
-    
-    stats.valid_count = valid_values.size();
-    if (valid_values.empty()) return stats;
-    
-    // Calculate mean
-    stats.mean = std::accumulate(valid_values.begin(), valid_values.end(), 0.0) / valid_values.size();
-    
-    // Calculate standard deviation
-    double variance = 0.0;
-    for (double value : valid_values) {
-        variance += (value - stats.mean) * (value - stats.mean);
-    }
-    stats.std_dev = std::sqrt(variance / valid_values.size());
-    
-    // Calculate min/max
-    auto minmax = std::minmax_element(valid_values.begin(), valid_values.end());
-    stats.min_val = *minmax.first;
-    stats.max_val = *minmax.second;
-    
-    // Calculate median
-    std::sort(valid_values.begin(), valid_values.end());
-    size_t n = valid_values.size();
-    if (n % 2 == 0) {
-        stats.median = (valid_values[n/2 - 1] + valid_values[n/2]) / 2.0;
-    } else {
-        stats.median = valid_values[n/2];
-    }
-    
-    return stats;
-}
-
-double ModularChartRenderer::calculateCorrelation(const std::string& feature1,
-                                                const std::string& feature2,
-                                                const std::vector<FlexibleStockData>& data) const {
-    std::vector<double> values1, values2;
-    
-    for (const auto& data_point : data) {
-        if (data_point.hasFeature(feature1) && data_point.hasFeature(feature2)) {
-            double val1 = data_point.getFeature(feature1);
-            double val2 = data_point.getFeature(feature2);
-            
-            if (!std::isnan(val1) && !std::isinf(val1) && !std::isnan(val2) && !std::isinf(val2)) {
-                values1.push_back(val1);
-                values2.push_back(val2);
-            }
-        }
-    }
-    
-    if (values1.size() < 2) return 0.0;
-    
-    // Calculate Pearson correlation coefficient
-    double mean1 = std::accumulate(values1.begin(), values1.end(), 0.0) / values1.size();
-    double mean2 = std::accumulate(values2.begin(), values2.end(), 0.0) / values2.size();
-    
-    double numerator = 0.0, sum_sq1 = 0.0, sum_sq2 = 0.0;
-    
-    for (size_t i = 0; i < values1.size(); ++i) {
-        double diff1 = values1[i] - mean1;
-        double diff2 = values2[i] - mean2;
-        numerator += diff1 * diff2;
-        sum_sq1 += diff1 * diff1;
-        sum_sq2 += diff2 * diff2;
-    }
-    
-    double denominator = std::sqrt(sum_sq1 * sum_sq2);
-    return (denominator > 0.0) ? numerator / denominator : 0.0;
-}
-
-std::vector<std::vector<double>> ModularChartRenderer::calculateCorrelationMatrix(
-    const std::vector<std::string>& features,
-    const std::vector<FlexibleStockData>& data) const {
-    
-    size_t n = features.size();
-    std::vector<std::vector<double>> matrix(n, std::vector<double>(n, 0.0));
-    
-    for (size_t i = 0; i < n; ++i) {
-        for (size_t j = 0; j < n; ++j) {
-            if (i == j) {
-                matrix[i][j] = 1.0; // Perfect correlation with self
-            } else {
-                matrix[i][j] = calculateCorrelation(features[i], features[j], data);
-            }
-        }
-    }
-    
-    return matrix;
-}
-
 std::string ModularChartRenderer::generateCacheKey(const std::string& chart_type,
                                                  const std::string& identifier,
                                                  const std::string& symbol) const {
@@ -623,20 +586,12 @@ void ModularChartRenderer::clearChartCache() {
     chart_cache_.clear();
 }
 
-bool ModularChartRenderer::getCachedChart(const std::string& key, MultiSeriesChart& chart) const {
-    if (!use_chart_cache_) return false;
-    
-    auto it = chart_cache_.find(key);
-    if (it != chart_cache_.end()) {
-        chart = it->second;
-        return true;
-    }
-    return false;
-}
-
-void ModularChartRenderer::setCachedChart(const std::string& key, const MultiSeriesChart& chart) {
-    if (use_chart_cache_) {
-        chart_cache_[key] = chart;
+void ModularChartRenderer::syncChartFilter() {
+    // getChartFilter() and the layout controls edit filter_ in place, so
+    // compare rather than rely on setChartFilter()
+    if (filter_ != cached_filter_) {
+        chart_cache_.clear();
+        cached_filter_ = filter_;
     }
 }
 